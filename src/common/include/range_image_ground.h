@@ -0,0 +1,390 @@
+#pragma once
+#ifndef COMMON_RANGE_IMAGE_GROUND_H
+#define COMMON_RANGE_IMAGE_GROUND_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <future>
+#include <vector>
+
+#include "work_steal_pool.h"
+
+namespace superg_agv
+{
+namespace common
+{
+
+enum RangeImageLabel
+{
+  RANGE_IMAGE_NONE     = 0, //该格没有点
+  RANGE_IMAGE_OBSTACLE = 1, //非地面点
+  RANGE_IMAGE_GROUND   = 2  //地面点
+};
+
+// atan2 近似, 误差约 1e-5 rad, 远小于列宽(0.2度约 3.5e-3 rad)
+inline float rangeImageAtan2(float y, float x)
+{
+  float ax = fabsf(x);
+  float ay = fabsf(y);
+  if (ax == 0.0f && ay == 0.0f)
+  {
+    return 0.0f;
+  }
+  float a  = (ax > ay) ? ay / ax : ax / ay;
+  float s  = a * a;
+  float r  = ((((-0.01172120f * s + 0.05265332f) * s - 0.11643287f) * s + 0.19354346f) * s - 0.33262347f) * s + 0.99997726f;
+  float at = a * r;
+  if (ay > ax)
+  {
+    at = 1.57079637f - at;
+  }
+  if (x < 0.0f)
+  {
+    at = 3.14159274f - at;
+  }
+  return (y < 0.0f) ? -at : at;
+}
+
+//按 线号 x 列号 组织的距离图像与地面分割
+//行为线号(0 为最下面一线), 列为水平方向的发射序号; 数据按行连续存放(SoA), 同一行相邻列在内存中相邻
+//地面判断只比较同一列上下相邻两线, 列之间互不相关, 可以按列分块并行
+//
+//填充方式:
+//  setPoint(ring, column, ...)  解码时已知线号和列号(包内发射顺序或方位角)
+//  addPoint(x, y, z)            只有坐标的点云, 用预先计算的垂直角分界求线号, 近似 atan2 求列号
+class RangeImageGround
+{
+public:
+  RangeImageGround()
+      : rings_(0), columns_(0), ground_rings_param_(0), ground_rings_(0), tan2_slope_(0.0f), skip_min_deg_(0.0f),
+        skip_max_deg_(0.0f)
+  {
+    setGroundParam(0, 15.0f);
+  }
+
+  //尺寸不变时不重新分配
+  void setup(int rings, int columns)
+  {
+    if (rings == rings_ && columns == columns_)
+    {
+      return;
+    }
+    rings_   = rings;
+    columns_ = columns;
+    size_t cells = ( size_t )rings_ * columns_;
+    x_.assign(cells, 0.0f);
+    y_.assign(cells, 0.0f);
+    z_.assign(cells, 0.0f);
+    valid_.assign(cells, 0);
+    label_.assign(cells, RANGE_IMAGE_NONE);
+    updateGroundRings();
+    if (vertical_tan_.size() != ( size_t )rings_ + 1)
+    {
+      // 默认垂直角: 均匀分布在 ±15 度, 与 16 线雷达一致
+      std::vector< float > angles(rings_);
+      for (int i = 0; i < rings_; i++)
+      {
+        angles[i] = (rings_ > 1) ? -15.0f + 30.0f * i / (rings_ - 1) : 0.0f;
+      }
+      setVerticalAngles(angles);
+    }
+  }
+
+  // ground_rings: 下面 ground_rings 对相邻线参与地面判断, <=0 时取线数一半(只有下半部分能扫到地面)
+  // max_slope_deg: 上下相邻两点连线与水平面夹角不超过该值时为地面
+  void setGroundParam(int ground_rings, float max_slope_deg)
+  {
+    ground_rings_param_ = ground_rings;
+    updateGroundRings();
+    float t     = tanDeg(max_slope_deg);
+    tan2_slope_ = t * t;
+  }
+
+  //每线的垂直角(度, 按线号从下到上), 只用于 addPoint; 预先算出相邻线中间的分界, 求线号时不用 atan2
+  void setVerticalAngles(const std::vector< float > &angles_deg)
+  {
+    if (angles_deg.empty())
+    {
+      return;
+    }
+    std::vector< float > sorted(angles_deg);
+    std::sort(sorted.begin(), sorted.end());
+    int n = ( int )sorted.size();
+    float step = (n > 1) ? (sorted[n - 1] - sorted[0]) / (n - 1) : 2.0f;
+    vertical_tan_.resize(n + 1);
+    vertical_tan_[0] = tanDeg(sorted[0] - step / 2);
+    for (int i = 1; i < n; i++)
+    {
+      vertical_tan_[i] = tanDeg((sorted[i - 1] + sorted[i]) / 2);
+    }
+    vertical_tan_[n] = tanDeg(sorted[n - 1] + step / 2);
+  }
+
+  // addPoint 时水平角+180 度(归到 -180~180)在 (min_deg, max_deg) 内的点不加入(车体遮挡); 两者相等时不过滤
+  void setSkipAngle(float min_deg, float max_deg)
+  {
+    skip_min_deg_ = min_deg;
+    skip_max_deg_ = max_deg;
+  }
+
+  void clear()
+  {
+    if (!valid_.empty())
+    {
+      memset(&valid_[0], 0, valid_.size());
+    }
+  }
+
+  int rings() const
+  {
+    return rings_;
+  }
+
+  int columns() const
+  {
+    return columns_;
+  }
+
+  //方位角(0.01 度, 0~35999) 对应的列号
+  int column(int azimuth) const
+  {
+    int col = ( int )(( int64_t )azimuth * columns_ / 36000);
+    return (col >= columns_) ? columns_ - 1 : (col < 0 ? 0 : col);
+  }
+
+  void setPoint(int ring, int col, float x, float y, float z)
+  {
+    if (ring < 0 || ring >= rings_ || col < 0 || col >= columns_)
+    {
+      return;
+    }
+    size_t index  = ( size_t )ring * columns_ + col;
+    x_[index]     = x;
+    y_[index]     = y;
+    z_[index]     = z;
+    valid_[index] = 1;
+  }
+
+  //只有坐标的点: 线号由垂直角分界求出, 列号由水平角求出(90 度方向在中间列)
+  bool addPoint(float x, float y, float z)
+  {
+    float xy2 = x * x + y * y;
+    if (!(xy2 > 0.0f))
+    {
+      return false;
+    }
+    float t = z / sqrtf(xy2);
+    if (!(t >= vertical_tan_.front() && t < vertical_tan_.back()))
+    {
+      return false;
+    }
+    int ring = ( int )(std::upper_bound(vertical_tan_.begin() + 1, vertical_tan_.end(), t) - vertical_tan_.begin()) - 1;
+
+    float horizon_deg = rangeImageAtan2(y, x) * (180.0f / ( float )M_PI);
+    if (skip_min_deg_ != skip_max_deg_)
+    {
+      float angle = horizon_deg + 180.0f;
+      if (angle > 180.0f)
+      {
+        angle -= 360.0f;
+      }
+      if (angle > skip_min_deg_ && angle < skip_max_deg_)
+      {
+        return false;
+      }
+    }
+    int col = -( int )lroundf((horizon_deg - 90.0f) * columns_ / 360.0f) + columns_ / 2;
+    if (col >= columns_)
+    {
+      col -= columns_;
+    }
+    if (col < 0 || col >= columns_)
+    {
+      return false;
+    }
+    setPoint(ring, col, x, y, z);
+    return true;
+  }
+
+  //对已填充的点做坐标变换, m 为 4x4 矩阵, 按 m(row, col) 访问(如 Eigen::Matrix4f)
+  template < class MatrixT > void transform(const MatrixT &m)
+  {
+    const float m00 = m(0, 0), m01 = m(0, 1), m02 = m(0, 2), m03 = m(0, 3);
+    const float m10 = m(1, 0), m11 = m(1, 1), m12 = m(1, 2), m13 = m(1, 3);
+    const float m20 = m(2, 0), m21 = m(2, 1), m22 = m(2, 2), m23 = m(2, 3);
+    float *px = x_.empty() ? NULL : &x_[0];
+    float *py = y_.empty() ? NULL : &y_[0];
+    float *pz = z_.empty() ? NULL : &z_[0];
+    //无效格也一起计算, 循环内无分支
+    for (size_t i = 0; i < x_.size(); i++)
+    {
+      float x = px[i], y = py[i], z = pz[i];
+      px[i]   = m00 * x + m01 * y + m02 * z + m03;
+      py[i]   = m10 * x + m11 * y + m12 * z + m13;
+      pz[i]   = m20 * x + m21 * y + m22 * z + m23;
+    }
+  }
+
+  //单个点平移(运动补偿)
+  void translate(int ring, int col, float dx, float dy, float dz)
+  {
+    if (ring < 0 || ring >= rings_ || col < 0 || col >= columns_)
+    {
+      return;
+    }
+    size_t index = ( size_t )ring * columns_ + col;
+    x_[index] += dx;
+    y_[index] += dy;
+    z_[index] += dz;
+  }
+
+  //地面标记; pool 非空时按列分成 blocks 块(blocks<=0 时为线程数+1), 调用线程执行第一块, 其余放入线程池
+  //调用线程等待其余块完成, 不能在 pool 自己的线程中调用
+  void label(WorkStealPool *pool = NULL, int blocks = 0)
+  {
+    if (rings_ == 0 || columns_ == 0)
+    {
+      return;
+    }
+    if (pool == NULL)
+    {
+      labelColumns(0, columns_);
+      return;
+    }
+    if (blocks <= 0)
+    {
+      blocks = ( int )pool->threadNum() + 1;
+    }
+    blocks = std::min(blocks, columns_);
+    std::vector< std::future< void > > futures;
+    for (int b = 1; b < blocks; b++)
+    {
+      int begin = ( int )(( int64_t )columns_ * b / blocks);
+      int end   = ( int )(( int64_t )columns_ * (b + 1) / blocks);
+      futures.push_back(pool->submit([this, begin, end]() { labelColumns(begin, end); }));
+    }
+    labelColumns(0, ( int )(columns_ / blocks));
+    for (size_t i = 0; i < futures.size(); i++)
+    {
+      futures[i].get();
+    }
+  }
+
+  uint8_t labelAt(int ring, int col) const
+  {
+    return label_[( size_t )ring * columns_ + col];
+  }
+
+  //输出地面点与非地面点, intensity 为线号; 不需要的输出传 NULL
+  template < class CloudT > void extract(CloudT *ground, CloudT *obstacle) const
+  {
+    typedef typename CloudT::PointType PointT;
+    if (ground != NULL)
+    {
+      ground->clear();
+      ground->reserve(label_.size() / 2);
+    }
+    if (obstacle != NULL)
+    {
+      obstacle->clear();
+      obstacle->reserve(label_.size() / 2);
+    }
+    for (int ring = 0; ring < rings_; ring++)
+    {
+      size_t row = ( size_t )ring * columns_;
+      for (int col = 0; col < columns_; col++)
+      {
+        uint8_t l = label_[row + col];
+        CloudT *out = (l == RANGE_IMAGE_GROUND) ? ground : ((l == RANGE_IMAGE_OBSTACLE) ? obstacle : NULL);
+        if (out == NULL)
+        {
+          continue;
+        }
+        PointT point;
+        point.x         = x_[row + col];
+        point.y         = y_[row + col];
+        point.z         = z_[row + col];
+        point.intensity = ring;
+        out->push_back(point);
+      }
+    }
+  }
+
+private:
+  static float tanDeg(float deg)
+  {
+    return tanf(deg * ( float )M_PI / 180.0f);
+  }
+
+  void updateGroundRings()
+  {
+    ground_rings_ = (ground_rings_param_ > 0 && ground_rings_param_ < rings_) ? ground_rings_param_ : rings_ / 2;
+  }
+
+  // [begin, end) 列: 下面 ground_rings_ 对相邻线中, 连线坡度不超过阈值的两点都标为地面, 其余有效点为非地面
+  //按行遍历, 同一行内按列连续访问, 循环内无分支
+  void labelColumns(int begin, int end)
+  {
+    const float k2 = tan2_slope_;
+    for (int ring = 0; ring < rings_; ring++)
+    {
+      uint8_t *l = &label_[( size_t )ring * columns_];
+      for (int j = begin; j < end; j++)
+      {
+        l[j] = 0;
+      }
+    }
+    for (int ring = 0; ring < ground_rings_; ring++)
+    {
+      size_t lo = ( size_t )ring * columns_;
+      size_t up = lo + columns_;
+      const float *x0 = &x_[lo], *y0 = &y_[lo], *z0 = &z_[lo];
+      const float *x1 = &x_[up], *y1 = &y_[up], *z1 = &z_[up];
+      const uint8_t *v0 = &valid_[lo], *v1 = &valid_[up];
+      uint8_t *l0 = &label_[lo], *l1 = &label_[up];
+      for (int j = begin; j < end; j++)
+      {
+        float dx      = x1[j] - x0[j];
+        float dy      = y1[j] - y0[j];
+        float dz      = z1[j] - z0[j];
+        uint8_t flat  = (dz * dz <= k2 * (dx * dx + dy * dy)) & v0[j] & v1[j];
+        l0[j] |= flat;
+        l1[j] |= flat;
+      }
+    }
+    for (int ring = 0; ring < rings_; ring++)
+    {
+      size_t row       = ( size_t )ring * columns_;
+      const uint8_t *v = &valid_[row];
+      uint8_t *l       = &label_[row];
+      for (int j = begin; j < end; j++)
+      {
+        // flat=1 -> GROUND(2), 否则有效点为 OBSTACLE(1)
+        l[j] = v[j] * (uint8_t)(1 + l[j]);
+      }
+    }
+  }
+
+  int rings_;
+  int columns_;
+  int ground_rings_param_;
+  int ground_rings_;
+  float tan2_slope_;
+  float skip_min_deg_;
+  float skip_max_deg_;
+
+  std::vector< float > vertical_tan_; //相邻线垂直角分界的正切, 共 rings_+1 个
+  std::vector< float > x_;
+  std::vector< float > y_;
+  std::vector< float > z_;
+  std::vector< uint8_t > valid_;
+  std::vector< uint8_t > label_;
+};
+
+} // namespace common
+} // namespace superg_agv
+
+#endif // COMMON_RANGE_IMAGE_GROUND_H
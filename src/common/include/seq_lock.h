@@ -0,0 +1,91 @@
+#pragma once
+#ifndef COMMON_SEQ_LOCK_H
+#define COMMON_SEQ_LOCK_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <type_traits>
+
+namespace superg_agv
+{
+namespace common
+{
+
+//单写多读的最新值槽：写端不等待, 读端读到写了一半的数据时重读, 保证读到的总是某一次完整写入的值
+//多个线程写同一个槽时需要调用方自己互斥; T 必须可以按字节拷贝
+template < typename T > class SeqLock
+{
+  static_assert(std::is_trivially_copyable< T >::value, "SeqLock value must be trivially copyable");
+
+public:
+  SeqLock() : seq_(0)
+  {
+    for (int i = 0; i < WORDS; i++)
+    {
+      words_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void store(const T &value)
+  {
+    uint64_t buf[WORDS] = {0};
+    memcpy(buf, &value, sizeof(T));
+
+    uint32_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed); //奇数表示正在写
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < WORDS; i++)
+    {
+      words_[i].store(buf[i], std::memory_order_relaxed);
+    }
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  //返回读到的版本号, 0 表示还没有写入过
+  uint32_t load(T *value) const
+  {
+    uint64_t buf[WORDS];
+    uint32_t seq0, seq1;
+    do
+    {
+      seq0 = seq_.load(std::memory_order_acquire);
+      for (int i = 0; i < WORDS; i++)
+      {
+        buf[i] = words_[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      seq1 = seq_.load(std::memory_order_relaxed);
+    } while ((seq0 & 1) || seq0 != seq1);
+
+    memcpy(value, buf, sizeof(T));
+    return seq0 >> 1;
+  }
+
+  T load() const
+  {
+    T value;
+    load(&value);
+    return value;
+  }
+
+  uint32_t version() const
+  {
+    return seq_.load(std::memory_order_acquire) >> 1;
+  }
+
+private:
+  enum
+  {
+    WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t)
+  };
+
+  std::atomic< uint32_t > seq_;
+  std::atomic< uint64_t > words_[WORDS];
+};
+
+} // namespace common
+} // namespace superg_agv
+
+#endif // COMMON_SEQ_LOCK_H
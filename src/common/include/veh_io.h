@@ -0,0 +1,879 @@
+#pragma once
+#ifndef COMMON_VEH_IO_H
+#define COMMON_VEH_IO_H
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+
+namespace superg_agv
+{
+namespace common
+{
+
+#define VEH_CANET_FRAME_LEN 13                           // CANET 一帧: 帧信息 1 字节 + ID 4 字节 + 数据 8 字节
+#define VEH_SERIAL_HEAD1 0xAA                            //串口帧头
+#define VEH_SERIAL_HEAD2 0x55                            //
+#define VEH_SERIAL_FRAME_LEN (2 + VEH_CANET_FRAME_LEN + 2) //帧头 + CANET 帧 + CRC16
+#define VEH_IO_READ_BUFFER 2048                          //单次 read 缓冲区
+
+struct VehCanFrame
+{
+  uint32_t id;
+  uint8_t ext; // 1: 扩展帧
+  uint8_t rtr; // 1: 远程帧
+  uint8_t dlc;
+  uint8_t data[8];
+};
+
+inline uint64_t vehIoNowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ( uint64_t )ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// CANET 帧: byte0 bit7 扩展帧, bit6 远程帧, 低 4 位 dlc; byte1~4 ID 大端; byte5~12 数据(不足 8 字节补 0)
+inline void vehCanetEncode(const VehCanFrame &frame, uint8_t *out)
+{
+  uint8_t dlc = frame.dlc > 8 ? 8 : frame.dlc;
+  out[0]      = (frame.ext ? 0x80 : 0) | (frame.rtr ? 0x40 : 0) | dlc;
+  out[1]      = (frame.id >> 24) & 0xff;
+  out[2]      = (frame.id >> 16) & 0xff;
+  out[3]      = (frame.id >> 8) & 0xff;
+  out[4]      = frame.id & 0xff;
+  memset(out + 5, 0, 8);
+  memcpy(out + 5, frame.data, dlc);
+}
+
+inline bool vehCanetDecode(const uint8_t *in, VehCanFrame *frame)
+{
+  frame->dlc = in[0] & 0x0f;
+  if (frame->dlc > 8 || (in[0] & 0x30) != 0)
+  {
+    return false;
+  }
+  frame->ext = (in[0] >> 7) & 0x01;
+  frame->rtr = (in[0] >> 6) & 0x01;
+  frame->id  = (( uint32_t )in[1] << 24) | (( uint32_t )in[2] << 16) | (( uint32_t )in[3] << 8) | in[4];
+  memcpy(frame->data, in + 5, 8);
+  return true;
+}
+
+// CRC-16/CCITT-FALSE: 多项式 0x1021, 初值 0xFFFF, 不反转
+inline uint16_t vehCrc16(const uint8_t *data, int len)
+{
+  static const struct Crc16Table
+  {
+    uint16_t value[256];
+    Crc16Table()
+    {
+      for (int i = 0; i < 256; i++)
+      {
+        uint16_t crc = ( uint16_t )(i << 8);
+        for (int bit = 0; bit < 8; bit++)
+        {
+          crc = (crc & 0x8000) ? ( uint16_t )((crc << 1) ^ 0x1021) : ( uint16_t )(crc << 1);
+        }
+        value[i] = crc;
+      }
+    }
+  } table;
+
+  uint16_t crc = 0xFFFF;
+  for (int i = 0; i < len; i++)
+  {
+    crc = ( uint16_t )((crc << 8) ^ table.value[((crc >> 8) ^ data[i]) & 0xff]);
+  }
+  return crc;
+}
+
+//串口字节流分帧: AA 55 + CANET 帧 + CRC16(大端, 只覆盖 CANET 帧)
+// CRC 或格式错误时从坏帧帧头的下一个字节重新找帧头, 紧跟在坏字节后面的好帧不会丢
+class VehFramer
+{
+public:
+  struct Stats
+  {
+    uint64_t frames;
+    uint64_t crc_errors;
+    uint64_t format_errors;
+    uint64_t skipped_bytes; //找帧头时丢弃的字节
+  };
+
+  VehFramer() : state_(HUNT_HEAD1), pos_(0)
+  {
+    memset(&stats_, 0, sizeof(stats_));
+  }
+
+  void reset()
+  {
+    state_ = HUNT_HEAD1;
+    pos_   = 0;
+  }
+
+  // handler(const VehCanFrame &)
+  template < typename Handler > void push(const uint8_t *data, int len, Handler &handler)
+  {
+    for (int i = 0; i < len; i++)
+    {
+      feed(data[i], handler);
+    }
+  }
+
+  static int encode(const VehCanFrame &frame, uint8_t *out)
+  {
+    out[0] = VEH_SERIAL_HEAD1;
+    out[1] = VEH_SERIAL_HEAD2;
+    vehCanetEncode(frame, out + 2);
+    uint16_t crc                 = vehCrc16(out + 2, VEH_CANET_FRAME_LEN);
+    out[VEH_SERIAL_FRAME_LEN - 2] = crc >> 8;
+    out[VEH_SERIAL_FRAME_LEN - 1] = crc & 0xff;
+    return VEH_SERIAL_FRAME_LEN;
+  }
+
+  const Stats &stats() const
+  {
+    return stats_;
+  }
+
+private:
+  enum State
+  {
+    HUNT_HEAD1,
+    HUNT_HEAD2,
+    BODY
+  };
+
+  template < typename Handler > void feed(uint8_t byte, Handler &handler)
+  {
+    switch (state_)
+    {
+      case HUNT_HEAD1:
+        if (byte == VEH_SERIAL_HEAD1)
+        {
+          buf_[0] = byte;
+          state_  = HUNT_HEAD2;
+        }
+        else
+        {
+          stats_.skipped_bytes++;
+        }
+        break;
+      case HUNT_HEAD2:
+        if (byte == VEH_SERIAL_HEAD2)
+        {
+          buf_[1] = byte;
+          pos_    = 2;
+          state_  = BODY;
+        }
+        else if (byte == VEH_SERIAL_HEAD1)
+        {
+          stats_.skipped_bytes++; //连续的 AA, 以后一个为帧头
+        }
+        else
+        {
+          stats_.skipped_bytes += 2;
+          state_ = HUNT_HEAD1;
+        }
+        break;
+      case BODY:
+        buf_[pos_++] = byte;
+        if (pos_ == VEH_SERIAL_FRAME_LEN)
+        {
+          finishFrame(handler);
+        }
+        break;
+    }
+  }
+
+  template < typename Handler > void finishFrame(Handler &handler)
+  {
+    state_ = HUNT_HEAD1;
+    pos_   = 0;
+
+    uint16_t crc = (( uint16_t )buf_[VEH_SERIAL_FRAME_LEN - 2] << 8) | buf_[VEH_SERIAL_FRAME_LEN - 1];
+    VehCanFrame frame;
+    if (crc == vehCrc16(buf_ + 2, VEH_CANET_FRAME_LEN))
+    {
+      if (vehCanetDecode(buf_ + 2, &frame))
+      {
+        stats_.frames++;
+        handler(frame);
+        return;
+      }
+      stats_.format_errors++;
+    }
+    else
+    {
+      stats_.crc_errors++;
+    }
+
+    //坏帧: 丢弃帧头第一个字节, 其余字节重新找帧头; 剩下的字节不够一帧, 不会再次进入这里
+    uint8_t rest[VEH_SERIAL_FRAME_LEN - 1];
+    memcpy(rest, buf_ + 1, sizeof(rest));
+    stats_.skipped_bytes++;
+    for (size_t i = 0; i < sizeof(rest); i++)
+    {
+      feed(rest[i], handler);
+    }
+  }
+
+  State state_;
+  int pos_;
+  uint8_t buf_[VEH_SERIAL_FRAME_LEN];
+  Stats stats_;
+};
+
+struct VehIoStats
+{
+  uint64_t rx_frames;
+  uint64_t rx_bytes;
+  uint64_t crc_errors;
+  uint64_t format_errors;
+  uint64_t skipped_bytes;
+  uint64_t tx_frames;
+  uint64_t tx_errors;
+  uint64_t tx_dropped;  //上一帧还没写完, 本周期不发
+  uint64_t tx_overruns; //定时器到期未及时处理而错过的周期
+  uint64_t tx_late;     //到期到写完超过半个周期
+  uint64_t wake_ns_avg; //定时器到期 -> I/O 线程开始处理
+  uint64_t wake_ns_max;
+  uint64_t send_ns_avg; //开始处理 -> 写完成
+  uint64_t send_ns_max;
+};
+
+//车辆接口 I/O: 一个线程用 epoll 等待 非阻塞设备读、定时发送 timerfd 和退出 eventfd
+// - 串口(tty): 字节流按 VehFramer 分帧, CRC 校验
+// - UDP(CANET 网关): 每个数据报为若干个 13 字节 CANET 帧
+// - 没有 fd 的设备(ADCU SDK): 只由定时器调用 writer 发送, 接收由调用方自己的线程读到后交给 dispatchRx
+//接收回调和发送回调都在 I/O 线程(或 dispatchRx 的调用线程)中执行, 与 ROS 回调线程交换数据时用 SeqLock
+class VehIo
+{
+public:
+  typedef std::function< void(const VehCanFrame &, uint64_t) > RxHandler; //帧, 接收时间(CLOCK_MONOTONIC ns)
+  typedef std::function< bool(VehCanFrame *) > TxBuilder;                 //返回 false 时本周期不发送
+  typedef std::function< bool(const VehCanFrame &) > ExternalWriter;      //返回 false 表示设备写失败
+
+  enum Mode
+  {
+    MODE_NONE,
+    MODE_SERIAL,
+    MODE_UDP,
+    MODE_EXTERNAL
+  };
+
+  VehIo()
+      : mode_(MODE_NONE), fd_(-1), epoll_fd_(-1), timer_fd_(-1), wake_fd_(-1), thread_started_(false),
+        period_ns_(0), next_expiry_ns_(0), tx_pending_len_(0), tx_pending_pos_(0), want_write_(false),
+        failed_(false)
+  {
+    resetStats();
+  }
+
+  ~VehIo()
+  {
+    stop();
+    closeFd(&fd_);
+  }
+
+  bool openSerial(const std::string &dev, int baud)
+  {
+    speed_t speed = baudToSpeed(baud);
+    if (speed == 0)
+    {
+      errno = EINVAL;
+      return false;
+    }
+    int fd = open(dev.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+    {
+      return false;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0)
+    {
+      ::close(fd);
+      return false;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+    tio.c_cc[VMIN]  = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    if (tcsetattr(fd, TCSANOW, &tio) != 0)
+    {
+      ::close(fd);
+      return false;
+    }
+    tcflush(fd, TCIOFLUSH);
+    return attach(MODE_SERIAL, fd);
+  }
+
+  //只接收 remote_ip:remote_port 发来的数据报
+  bool openUdp(const std::string &remote_ip, int remote_port, int local_port)
+  {
+    struct sockaddr_in local, remote;
+    memset(&local, 0, sizeof(local));
+    memset(&remote, 0, sizeof(remote));
+    local.sin_family       = AF_INET;
+    local.sin_addr.s_addr  = htonl(INADDR_ANY);
+    local.sin_port         = htons(local_port);
+    remote.sin_family      = AF_INET;
+    remote.sin_port        = htons(remote_port);
+    if (inet_pton(AF_INET, remote_ip.c_str(), &remote.sin_addr) != 1)
+    {
+      errno = EINVAL;
+      return false;
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+      return false;
+    }
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (bind(fd, ( struct sockaddr * )&local, sizeof(local)) != 0 ||
+        connect(fd, ( struct sockaddr * )&remote, sizeof(remote)) != 0)
+    {
+      int err = errno;
+      ::close(fd);
+      errno = err;
+      return false;
+    }
+    return attach(MODE_UDP, fd);
+  }
+
+  bool openExternal(ExternalWriter writer)
+  {
+    writer_ = writer;
+    mode_   = MODE_EXTERNAL;
+    return true;
+  }
+
+  void setRxHandler(RxHandler handler)
+  {
+    rx_handler_ = handler;
+  }
+
+  // hz <= 0 时不发送
+  void setTxTimer(double hz, TxBuilder builder)
+  {
+    period_ns_  = hz > 0.0 ? ( uint64_t )(1e9 / hz) : 0;
+    tx_builder_ = builder;
+  }
+
+  bool start()
+  {
+    if (thread_started_ || mode_ == MODE_NONE)
+    {
+      return false;
+    }
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wake_fd_ < 0 || !watch(wake_fd_, EPOLLIN))
+    {
+      closeAll();
+      return false;
+    }
+    if (fd_ >= 0 && !watch(fd_, EPOLLIN))
+    {
+      closeAll();
+      return false;
+    }
+    if (period_ns_ > 0)
+    {
+      timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+      if (timer_fd_ < 0 || !watch(timer_fd_, EPOLLIN))
+      {
+        closeAll();
+        return false;
+      }
+      //绝对时间定时, 每个周期的计划到期时间已知, 可以算出唤醒延迟
+      next_expiry_ns_ = vehIoNowNs() + period_ns_;
+      struct itimerspec its;
+      its.it_value.tv_sec     = next_expiry_ns_ / 1000000000ull;
+      its.it_value.tv_nsec    = next_expiry_ns_ % 1000000000ull;
+      its.it_interval.tv_sec  = period_ns_ / 1000000000ull;
+      its.it_interval.tv_nsec = period_ns_ % 1000000000ull;
+      if (timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &its, NULL) != 0)
+      {
+        closeAll();
+        return false;
+      }
+    }
+    if (pthread_create(&thread_, NULL, threadEntry, this) != 0)
+    {
+      closeAll();
+      return false;
+    }
+    thread_started_ = true;
+    return true;
+  }
+
+  void stop()
+  {
+    if (thread_started_)
+    {
+      uint64_t one = 1;
+      ssize_t ret  = write(wake_fd_, &one, sizeof(one));
+      ( void )ret;
+      pthread_join(thread_, NULL);
+      thread_started_ = false;
+    }
+    closeAll();
+  }
+
+  //没有 fd 的设备由调用方的读线程交给这里, 统计后调用接收回调
+  void dispatchRx(const VehCanFrame &frame)
+  {
+    deliver(frame, vehIoNowNs());
+  }
+
+  //设备写失败或断开, I/O 线程已退出
+  bool failed() const
+  {
+    return failed_.load(std::memory_order_acquire);
+  }
+
+  Mode mode() const
+  {
+    return mode_;
+  }
+
+  //计数为累计值, 延迟为上次调用以来的平均/最大值
+  VehIoStats takeStats()
+  {
+    VehIoStats s;
+    s.rx_frames     = rx_frames_.load(std::memory_order_relaxed);
+    s.rx_bytes      = rx_bytes_.load(std::memory_order_relaxed);
+    s.crc_errors    = crc_errors_.load(std::memory_order_relaxed);
+    s.format_errors = format_errors_.load(std::memory_order_relaxed);
+    s.skipped_bytes = skipped_bytes_.load(std::memory_order_relaxed);
+    s.tx_frames     = tx_frames_.load(std::memory_order_relaxed);
+    s.tx_errors     = tx_errors_.load(std::memory_order_relaxed);
+    s.tx_dropped    = tx_dropped_.load(std::memory_order_relaxed);
+    s.tx_overruns   = tx_overruns_.load(std::memory_order_relaxed);
+    s.tx_late       = tx_late_.load(std::memory_order_relaxed);
+
+    uint64_t count = tick_count_.exchange(0);
+    uint64_t wake  = wake_ns_sum_.exchange(0);
+    uint64_t send  = send_ns_sum_.exchange(0);
+    s.wake_ns_avg  = count ? wake / count : 0;
+    s.send_ns_avg  = count ? send / count : 0;
+    s.wake_ns_max  = wake_ns_max_.exchange(0);
+    s.send_ns_max  = send_ns_max_.exchange(0);
+    return s;
+  }
+
+private:
+  static void *threadEntry(void *arg)
+  {
+    static_cast< VehIo * >(arg)->ioLoop();
+    return NULL;
+  }
+
+  void ioLoop()
+  {
+    struct epoll_event events[4];
+    while (true)
+    {
+      int n = epoll_wait(epoll_fd_, events, 4, -1);
+      if (n < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        fail();
+        return;
+      }
+      for (int i = 0; i < n; i++)
+      {
+        int fd = events[i].data.fd;
+        if (fd == wake_fd_)
+        {
+          return;
+        }
+        else if (fd == timer_fd_)
+        {
+          onTimer();
+        }
+        else if (fd == fd_)
+        {
+          if (events[i].events & EPOLLIN)
+          {
+            readAll();
+          }
+          if (events[i].events & EPOLLOUT)
+          {
+            flushPending();
+          }
+          if (mode_ == MODE_SERIAL && (events[i].events & (EPOLLERR | EPOLLHUP)))
+          {
+            fail(); //串口拔出
+          }
+        }
+        if (failed())
+        {
+          return;
+        }
+      }
+    }
+  }
+
+  void readAll()
+  {
+    uint8_t buf[VEH_IO_READ_BUFFER];
+    while (true)
+    {
+      ssize_t len = (mode_ == MODE_UDP) ? recv(fd_, buf, sizeof(buf), 0) : read(fd_, buf, sizeof(buf));
+      if (len < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNREFUSED)
+        {
+          fail();
+        }
+        break;
+      }
+      if (len == 0)
+      {
+        break;
+      }
+      rx_bytes_.fetch_add(len, std::memory_order_relaxed);
+      uint64_t now_ns = vehIoNowNs();
+      if (mode_ == MODE_SERIAL)
+      {
+        SerialSink sink(this, now_ns);
+        framer_.push(buf, ( int )len, sink);
+        const VehFramer::Stats &fs = framer_.stats();
+        crc_errors_.store(fs.crc_errors, std::memory_order_relaxed);
+        format_errors_.store(fs.format_errors, std::memory_order_relaxed);
+        skipped_bytes_.store(fs.skipped_bytes, std::memory_order_relaxed);
+      }
+      else
+      {
+        if (len % VEH_CANET_FRAME_LEN != 0)
+        {
+          format_errors_.fetch_add(1, std::memory_order_relaxed);
+          continue;
+        }
+        for (ssize_t off = 0; off < len; off += VEH_CANET_FRAME_LEN)
+        {
+          VehCanFrame frame;
+          if (vehCanetDecode(buf + off, &frame))
+          {
+            deliver(frame, now_ns);
+          }
+          else
+          {
+            format_errors_.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+      }
+    }
+  }
+
+  struct SerialSink
+  {
+    SerialSink(VehIo *io, uint64_t now_ns) : io_(io), now_ns_(now_ns)
+    {
+    }
+    void operator()(const VehCanFrame &frame)
+    {
+      io_->deliver(frame, now_ns_);
+    }
+    VehIo *io_;
+    uint64_t now_ns_;
+  };
+
+  void deliver(const VehCanFrame &frame, uint64_t now_ns)
+  {
+    rx_frames_.fetch_add(1, std::memory_order_relaxed);
+    if (rx_handler_)
+    {
+      rx_handler_(frame, now_ns);
+    }
+  }
+
+  void onTimer()
+  {
+    uint64_t expirations = 0;
+    if (read(timer_fd_, &expirations, sizeof(expirations)) != sizeof(expirations) || expirations == 0)
+    {
+      return;
+    }
+    uint64_t wake_ns      = vehIoNowNs();
+    uint64_t scheduled_ns = next_expiry_ns_ + (expirations - 1) * period_ns_;
+    next_expiry_ns_       = scheduled_ns + period_ns_;
+    if (expirations > 1)
+    {
+      tx_overruns_.fetch_add(expirations - 1, std::memory_order_relaxed);
+    }
+
+    VehCanFrame frame;
+    if (!tx_builder_ || !tx_builder_(&frame))
+    {
+      return;
+    }
+    sendFrame(frame);
+
+    uint64_t done_ns = vehIoNowNs();
+    uint64_t wake    = wake_ns > scheduled_ns ? wake_ns - scheduled_ns : 0;
+    uint64_t send    = done_ns - wake_ns;
+    tick_count_.fetch_add(1, std::memory_order_relaxed);
+    wake_ns_sum_.fetch_add(wake, std::memory_order_relaxed);
+    send_ns_sum_.fetch_add(send, std::memory_order_relaxed);
+    updateMax(&wake_ns_max_, wake);
+    updateMax(&send_ns_max_, send);
+    if (wake + send > period_ns_ / 2)
+    {
+      tx_late_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void sendFrame(const VehCanFrame &frame)
+  {
+    if (mode_ == MODE_EXTERNAL)
+    {
+      if (writer_ && writer_(frame))
+      {
+        tx_frames_.fetch_add(1, std::memory_order_relaxed);
+      }
+      else
+      {
+        tx_errors_.fetch_add(1, std::memory_order_relaxed);
+        fail();
+      }
+      return;
+    }
+
+    if (tx_pending_pos_ < tx_pending_len_)
+    {
+      //上一帧还没写完, 下个周期发送最新的指令
+      tx_dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    if (mode_ == MODE_UDP)
+    {
+      uint8_t buf[VEH_CANET_FRAME_LEN];
+      vehCanetEncode(frame, buf);
+      ssize_t ret = send(fd_, buf, sizeof(buf), 0);
+      if (ret == ( ssize_t )sizeof(buf))
+      {
+        tx_frames_.fetch_add(1, std::memory_order_relaxed);
+      }
+      else if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      {
+        tx_dropped_.fetch_add(1, std::memory_order_relaxed);
+      }
+      else
+      {
+        tx_errors_.fetch_add(1, std::memory_order_relaxed); //网关未上线时为 ECONNREFUSED, 不退出
+      }
+      return;
+    }
+
+    tx_pending_len_ = VehFramer::encode(frame, tx_pending_);
+    tx_pending_pos_ = 0;
+    flushPending();
+  }
+
+  void flushPending()
+  {
+    while (tx_pending_pos_ < tx_pending_len_)
+    {
+      ssize_t ret = write(fd_, tx_pending_ + tx_pending_pos_, tx_pending_len_ - tx_pending_pos_);
+      if (ret < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+          setWantWrite(true);
+          return;
+        }
+        tx_errors_.fetch_add(1, std::memory_order_relaxed);
+        fail();
+        return;
+      }
+      tx_pending_pos_ += ( int )ret;
+    }
+    tx_pending_len_ = tx_pending_pos_ = 0;
+    tx_frames_.fetch_add(1, std::memory_order_relaxed);
+    setWantWrite(false);
+  }
+
+  void setWantWrite(bool want)
+  {
+    if (want == want_write_)
+    {
+      return;
+    }
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events  = EPOLLIN | (want ? ( uint32_t )EPOLLOUT : 0u);
+    ev.data.fd = fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd_, &ev);
+    want_write_ = want;
+  }
+
+  bool attach(Mode mode, int fd)
+  {
+    closeFd(&fd_);
+    mode_ = mode;
+    fd_   = fd;
+    framer_.reset();
+    return true;
+  }
+
+  bool watch(int fd, uint32_t events)
+  {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events  = events;
+    ev.data.fd = fd;
+    return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == 0;
+  }
+
+  void fail()
+  {
+    failed_.store(true, std::memory_order_release);
+  }
+
+  void closeAll()
+  {
+    closeFd(&timer_fd_);
+    closeFd(&wake_fd_);
+    closeFd(&epoll_fd_);
+    want_write_ = false;
+  }
+
+  static void closeFd(int *fd)
+  {
+    if (*fd >= 0)
+    {
+      ::close(*fd);
+      *fd = -1;
+    }
+  }
+
+  static void updateMax(std::atomic< uint64_t > *max, uint64_t value)
+  {
+    uint64_t cur = max->load(std::memory_order_relaxed);
+    while (value > cur && !max->compare_exchange_weak(cur, value, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  static speed_t baudToSpeed(int baud)
+  {
+    switch (baud)
+    {
+      case 9600:
+        return B9600;
+      case 19200:
+        return B19200;
+      case 38400:
+        return B38400;
+      case 57600:
+        return B57600;
+      case 115200:
+        return B115200;
+      case 230400:
+        return B230400;
+      case 460800:
+        return B460800;
+      case 921600:
+        return B921600;
+      default:
+        return 0;
+    }
+  }
+
+  void resetStats()
+  {
+    rx_frames_     = 0;
+    rx_bytes_      = 0;
+    crc_errors_    = 0;
+    format_errors_ = 0;
+    skipped_bytes_ = 0;
+    tx_frames_     = 0;
+    tx_errors_     = 0;
+    tx_dropped_    = 0;
+    tx_overruns_   = 0;
+    tx_late_       = 0;
+    tick_count_    = 0;
+    wake_ns_sum_   = 0;
+    wake_ns_max_   = 0;
+    send_ns_sum_   = 0;
+    send_ns_max_   = 0;
+  }
+
+  Mode mode_;
+  int fd_;
+  int epoll_fd_;
+  int timer_fd_;
+  int wake_fd_;
+  pthread_t thread_;
+  bool thread_started_;
+
+  RxHandler rx_handler_;
+  TxBuilder tx_builder_;
+  ExternalWriter writer_;
+  VehFramer framer_;
+
+  uint64_t period_ns_;
+  uint64_t next_expiry_ns_;
+  uint8_t tx_pending_[VEH_SERIAL_FRAME_LEN];
+  int tx_pending_len_;
+  int tx_pending_pos_;
+  bool want_write_;
+
+  std::atomic< bool > failed_;
+  std::atomic< uint64_t > rx_frames_;
+  std::atomic< uint64_t > rx_bytes_;
+  std::atomic< uint64_t > crc_errors_;
+  std::atomic< uint64_t > format_errors_;
+  std::atomic< uint64_t > skipped_bytes_;
+  std::atomic< uint64_t > tx_frames_;
+  std::atomic< uint64_t > tx_errors_;
+  std::atomic< uint64_t > tx_dropped_;
+  std::atomic< uint64_t > tx_overruns_;
+  std::atomic< uint64_t > tx_late_;
+  std::atomic< uint64_t > tick_count_;
+  std::atomic< uint64_t > wake_ns_sum_;
+  std::atomic< uint64_t > wake_ns_max_;
+  std::atomic< uint64_t > send_ns_sum_;
+  std::atomic< uint64_t > send_ns_max_;
+};
+
+} // namespace common
+} // namespace superg_agv
+
+#endif // COMMON_VEH_IO_H
@@ -0,0 +1,591 @@
+#pragma once
+#ifndef COMMON_WORK_STEAL_POOL_H
+#define COMMON_WORK_STEAL_POOL_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace superg_agv
+{
+namespace common
+{
+
+#define WORK_STEAL_TASK_BUFFER 48 //不超过该字节数的可调用对象直接存放在任务内部
+#define WORK_STEAL_SPIN_COUNT 16  //找不到任务时, 休眠前重试窃取的轮数
+
+inline uint64_t workStealNowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ( uint64_t )ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+//只可移动的 void() 任务, 小对象放在内部缓冲区, 避免 std::function 每次提交的堆分配
+//可以直接保存 std::packaged_task 等只可移动的对象
+class SboTask
+{
+public:
+  SboTask() : ops_(NULL), enqueue_ns_(0)
+  {
+  }
+
+  template < typename F, typename = typename std::enable_if<
+                             !std::is_same< typename std::decay< F >::type, SboTask >::value >::type >
+  SboTask(F &&f) : ops_(NULL), enqueue_ns_(0)
+  {
+    typedef typename std::decay< F >::type FuncType;
+    init< FuncType >(std::forward< F >(f),
+                     std::integral_constant< bool, sizeof(FuncType) <= WORK_STEAL_TASK_BUFFER &&
+                                                       alignof(FuncType) <= alignof(Storage) &&
+                                                       std::is_nothrow_move_constructible< FuncType >::value >());
+  }
+
+  SboTask(SboTask &&other) : ops_(other.ops_), enqueue_ns_(other.enqueue_ns_)
+  {
+    if (ops_ != NULL)
+    {
+      ops_->move(&storage_, &other.storage_);
+      other.ops_ = NULL;
+    }
+  }
+
+  SboTask &operator=(SboTask &&other)
+  {
+    if (this != &other)
+    {
+      reset();
+      ops_        = other.ops_;
+      enqueue_ns_ = other.enqueue_ns_;
+      if (ops_ != NULL)
+      {
+        ops_->move(&storage_, &other.storage_);
+        other.ops_ = NULL;
+      }
+    }
+    return *this;
+  }
+
+  SboTask(const SboTask &) = delete;
+  SboTask &operator=(const SboTask &) = delete;
+
+  ~SboTask()
+  {
+    reset();
+  }
+
+  void operator()()
+  {
+    ops_->invoke(&storage_);
+  }
+
+  explicit operator bool() const
+  {
+    return ops_ != NULL;
+  }
+
+  void reset()
+  {
+    if (ops_ != NULL)
+    {
+      ops_->destroy(&storage_);
+      ops_ = NULL;
+    }
+  }
+
+  void setEnqueueTime(uint64_t stamp_ns)
+  {
+    enqueue_ns_ = stamp_ns;
+  }
+
+  uint64_t enqueueTime() const
+  {
+    return enqueue_ns_;
+  }
+
+private:
+  typedef std::aligned_storage< WORK_STEAL_TASK_BUFFER, alignof(std::max_align_t) >::type Storage;
+
+  struct Ops
+  {
+    void (*invoke)(void *storage);
+    void (*move)(void *dst, void *src); //移动到 dst 并析构 src
+    void (*destroy)(void *storage);
+  };
+
+  template < typename FuncType > struct InlineOps
+  {
+    static void invoke(void *storage)
+    {
+      (*static_cast< FuncType * >(storage))();
+    }
+    static void move(void *dst, void *src)
+    {
+      new (dst) FuncType(std::move(*static_cast< FuncType * >(src)));
+      static_cast< FuncType * >(src)->~FuncType();
+    }
+    static void destroy(void *storage)
+    {
+      static_cast< FuncType * >(storage)->~FuncType();
+    }
+  };
+
+  template < typename FuncType > struct HeapOps
+  {
+    static void invoke(void *storage)
+    {
+      (**static_cast< FuncType ** >(storage))();
+    }
+    static void move(void *dst, void *src)
+    {
+      *static_cast< FuncType ** >(dst) = *static_cast< FuncType ** >(src);
+    }
+    static void destroy(void *storage)
+    {
+      delete *static_cast< FuncType ** >(storage);
+    }
+  };
+
+  template < typename FuncType, typename F > void init(F &&f, std::true_type)
+  {
+    new (&storage_) FuncType(std::forward< F >(f));
+    ops_ = opsOf< InlineOps< FuncType > >();
+  }
+
+  template < typename FuncType, typename F > void init(F &&f, std::false_type)
+  {
+    *reinterpret_cast< FuncType ** >(&storage_) = new FuncType(std::forward< F >(f));
+    ops_                                         = opsOf< HeapOps< FuncType > >();
+  }
+
+  template < typename Impl > static const Ops *opsOf()
+  {
+    static const Ops ops = {Impl::invoke, Impl::move, Impl::destroy};
+    return &ops;
+  }
+
+  Storage storage_;
+  const Ops *ops_;
+  uint64_t enqueue_ns_; //入队时间, 开启排队延迟统计时才记录
+};
+
+//按任务所在队列统计
+struct WorkStealStats
+{
+  uint64_t executed;      //已执行的任务数
+  uint64_t stolen;        //被其他线程窃取执行的任务数
+  uint64_t failed;        //抛出异常的任务数, 异常在线程内捕获后丢弃
+  uint64_t wait_ns_total; //入队到开始执行的累计时间, 未开启统计时为0
+  uint64_t wait_ns_max;   //入队到开始执行的最大时间, 未开启统计时为0
+  size_t queue_size;      //当前排队的任务数
+};
+
+//工作窃取线程池
+//每个线程一个任务队列, 线程内提交的任务进入本线程队列, 外部提交的任务轮流分配到各队列
+//线程先取本队列的任务, 本队列为空时从其他队列窃取, 提交不再争用同一把锁
+class WorkStealPool
+{
+  // submitThen 后续任务的返回值类型
+  template < typename FirstType, typename C > struct ThenResult
+  {
+    typedef typename std::result_of< C(FirstType) >::type type;
+  };
+
+  template < typename C > struct ThenResult< void, C >
+  {
+    typedef typename std::result_of< C() >::type type;
+  };
+
+public:
+  // cpu_list 非空时, 第 i 个线程绑定到 cpu_list[i % cpu_list.size()]
+  // record_wait 为 true 时每个任务入队和执行前各读一次时钟, 统计排队延迟; 默认不统计
+  explicit WorkStealPool(size_t thread_num = std::thread::hardware_concurrency(),
+                         const std::vector< int > &cpu_list = std::vector< int >(), bool record_wait = false)
+      : record_wait_(record_wait), accepting_(true), running_(true), queued_(0), unfinished_(0), sleeping_(0),
+        next_queue_(0)
+  {
+    if (thread_num == 0)
+    {
+      thread_num = 1;
+    }
+    for (size_t i = 0; i < thread_num; i++)
+    {
+      queues_.push_back(std::unique_ptr< WorkQueue >(new WorkQueue()));
+    }
+    for (size_t i = 0; i < thread_num; i++)
+    {
+      threads_.push_back(std::thread(&WorkStealPool::workerLoop, this, i));
+      if (!cpu_list.empty())
+      {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu_list[i % cpu_list.size()], &cpu_set);
+        //绑定失败(如CPU不存在)时线程仍可在任意CPU上运行
+        pthread_setaffinity_np(threads_[i].native_handle(), sizeof(cpu_set), &cpu_set);
+      }
+    }
+  }
+
+  ~WorkStealPool()
+  {
+    shutdown();
+  }
+
+  WorkStealPool(const WorkStealPool &) = delete;
+  WorkStealPool &operator=(const WorkStealPool &) = delete;
+
+  //提交不需要返回值的任务, 任务抛出的异常被丢弃并计入 stats().failed; 需要异常时用 submit
+  template < class F > void execute(F &&task)
+  {
+    if (!accepting_.load(std::memory_order_acquire))
+    {
+      throw std::runtime_error("execute on WorkStealPool is stopped.");
+    }
+    push(SboTask(std::forward< F >(task)));
+  }
+
+  //提交任务, 通过 future 获取返回值或异常
+  template < class F, class... Args >
+  auto submit(F &&f, Args &&... args) -> std::future< decltype(f(args...)) >
+  {
+    typedef decltype(f(args...)) RetType;
+    std::packaged_task< RetType() > task(std::bind(std::forward< F >(f), std::forward< Args >(args)...));
+    std::future< RetType > result = task.get_future();
+    execute(PackagedRunner< RetType >(std::move(task)));
+    return result;
+  }
+
+  // f 完成后把 cont 作为新任务放入同一线程的队列, 参数为 f 的返回值(f 返回 void 时无参数)
+  // f 抛出异常时不执行 cont, 异常由返回的 future 抛出
+  template < class F, class C >
+  auto submitThen(F &&f, C &&cont) -> std::future< typename ThenResult< decltype(f()), C >::type >
+  {
+    typedef decltype(f()) FirstType;
+    typedef typename ThenResult< FirstType, C >::type ThenType;
+    std::packaged_task< FirstType() > first(std::forward< F >(f));
+    ThenCall< FirstType, ThenType, typename std::decay< C >::type > then_call(first.get_future().share(),
+                                                                              std::forward< C >(cont));
+    std::packaged_task< ThenType() > then(std::move(then_call));
+    std::future< ThenType > result = then.get_future();
+    execute(ChainRunner< FirstType, ThenType >(this, std::move(first), std::move(then)));
+    return result;
+  }
+
+  //等待已提交的任务(包括其后续任务)全部完成
+  void waitIdle()
+  {
+    std::unique_lock< std::mutex > lock(idle_mutex_);
+    idle_cond_.wait(lock, [this] { return unfinished_.load() == 0; });
+  }
+
+  //不再接收新任务, 执行完已提交的任务后回收线程, 不能在池内线程中调用
+  void shutdown()
+  {
+    accepting_.store(false);
+    waitIdle();
+    {
+      std::lock_guard< std::mutex > lock(sleep_mutex_);
+      running_.store(false);
+    }
+    sleep_cond_.notify_all();
+    for (size_t i = 0; i < threads_.size(); i++)
+    {
+      if (threads_[i].joinable())
+      {
+        threads_[i].join();
+      }
+    }
+  }
+
+  size_t threadNum() const
+  {
+    return queues_.size();
+  }
+
+  WorkStealStats stats(size_t queue_index) const
+  {
+    const WorkQueue &queue = *queues_[queue_index];
+    WorkStealStats stats;
+    stats.executed      = queue.executed.load(std::memory_order_relaxed);
+    stats.stolen        = queue.stolen.load(std::memory_order_relaxed);
+    stats.failed        = queue.failed.load(std::memory_order_relaxed);
+    stats.wait_ns_total = queue.wait_ns_total.load(std::memory_order_relaxed);
+    stats.wait_ns_max   = queue.wait_ns_max.load(std::memory_order_relaxed);
+    {
+      std::lock_guard< std::mutex > lock(queue.mtx);
+      stats.queue_size = queue.tasks.size();
+    }
+    return stats;
+  }
+
+private:
+  struct WorkQueue
+  {
+    WorkQueue() : executed(0), stolen(0), failed(0), wait_ns_total(0), wait_ns_max(0)
+    {
+    }
+
+    mutable std::mutex mtx;
+    std::deque< SboTask > tasks;
+
+    //由执行任务的线程更新
+    std::atomic< uint64_t > executed;
+    std::atomic< uint64_t > stolen;
+    std::atomic< uint64_t > failed;
+    std::atomic< uint64_t > wait_ns_total;
+    std::atomic< uint64_t > wait_ns_max;
+  };
+
+  //当前线程所属的线程池和队列序号
+  struct WorkerContext
+  {
+    WorkStealPool *pool;
+    size_t index;
+  };
+
+  static WorkerContext &context()
+  {
+    static thread_local WorkerContext worker_context = {NULL, 0};
+    return worker_context;
+  }
+
+  template < typename FirstType, typename ThenType, typename C > struct ThenCall
+  {
+    ThenCall(std::shared_future< FirstType > first_future, C &&then_cont)
+        : first(first_future), cont(std::move(then_cont))
+    {
+    }
+    ThenCall(std::shared_future< FirstType > first_future, const C &then_cont) : first(first_future), cont(then_cont)
+    {
+    }
+    ThenType operator()()
+    {
+      return cont(first.get());
+    }
+    std::shared_future< FirstType > first;
+    C cont;
+  };
+
+  template < typename ThenType, typename C > struct ThenCall< void, ThenType, C >
+  {
+    ThenCall(std::shared_future< void > first_future, C &&then_cont) : first(first_future), cont(std::move(then_cont))
+    {
+    }
+    ThenCall(std::shared_future< void > first_future, const C &then_cont) : first(first_future), cont(then_cont)
+    {
+    }
+    ThenType operator()()
+    {
+      first.get();
+      return cont();
+    }
+    std::shared_future< void > first;
+    C cont;
+  };
+
+  template < typename RetType > struct PackagedRunner
+  {
+    explicit PackagedRunner(std::packaged_task< RetType() > &&packaged) : task(std::move(packaged))
+    {
+    }
+    void operator()()
+    {
+      task();
+    }
+    std::packaged_task< RetType() > task;
+  };
+
+  template < typename FirstType, typename ThenType > struct ChainRunner
+  {
+    ChainRunner(WorkStealPool *owner, std::packaged_task< FirstType() > &&first_task,
+                std::packaged_task< ThenType() > &&then_task)
+        : pool(owner), first(std::move(first_task)), then(std::move(then_task))
+    {
+    }
+    void operator()()
+    {
+      first();
+      //后续任务在本任务结束前入队, waitIdle 不会提前返回; 关闭过程中也要执行
+      pool->push(SboTask(PackagedRunner< ThenType >(std::move(then))));
+    }
+    WorkStealPool *pool;
+    std::packaged_task< FirstType() > first;
+    std::packaged_task< ThenType() > then;
+  };
+
+  void push(SboTask &&task)
+  {
+    WorkerContext &worker = context();
+    size_t index          = worker.pool == this ? worker.index
+                                       : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    if (record_wait_)
+    {
+      task.setEnqueueTime(workStealNowNs());
+    }
+    unfinished_.fetch_add(1);
+    //先计数再入队, 线程看到计数后最多短暂空转, 不会漏掉任务
+    queued_.fetch_add(1);
+    {
+      std::lock_guard< std::mutex > lock(queues_[index]->mtx);
+      queues_[index]->tasks.push_back(std::move(task));
+    }
+    //只有线程休眠时才需要加锁唤醒
+    if (sleeping_.load() > 0)
+    {
+      {
+        std::lock_guard< std::mutex > lock(sleep_mutex_);
+      }
+      sleep_cond_.notify_one();
+    }
+  }
+
+  bool popLocal(size_t index, SboTask &task)
+  {
+    WorkQueue &queue = *queues_[index];
+    std::lock_guard< std::mutex > lock(queue.mtx);
+    if (queue.tasks.empty())
+    {
+      return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+  }
+
+  //从其他队列的尾部窃取, 正被占用的队列跳过
+  bool steal(size_t index, SboTask &task, size_t &victim)
+  {
+    for (size_t k = 1; k < queues_.size(); k++)
+    {
+      victim           = (index + k) % queues_.size();
+      WorkQueue &queue = *queues_[victim];
+      std::unique_lock< std::mutex > lock(queue.mtx, std::try_to_lock);
+      if (lock.owns_lock() && !queue.tasks.empty())
+      {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void runTask(SboTask &task, size_t source, bool stolen)
+  {
+    queued_.fetch_sub(1);
+    WorkQueue &queue = *queues_[source];
+    uint64_t wait_ns = record_wait_ ? workStealNowNs() - task.enqueueTime() : 0;
+
+    //异常不能逃出线程(会 std::terminate), 也不能跳过下面的计数, 否则 waitIdle 永远等不到
+    try
+    {
+      task();
+    }
+    catch (...)
+    {
+      queue.failed.fetch_add(1, std::memory_order_relaxed);
+    }
+    task.reset();
+
+    queue.executed.fetch_add(1, std::memory_order_relaxed);
+    if (stolen)
+    {
+      queue.stolen.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (record_wait_)
+    {
+      queue.wait_ns_total.fetch_add(wait_ns, std::memory_order_relaxed);
+      uint64_t wait_max = queue.wait_ns_max.load(std::memory_order_relaxed);
+      while (wait_ns > wait_max && !queue.wait_ns_max.compare_exchange_weak(wait_max, wait_ns))
+      {
+      }
+    }
+
+    if (unfinished_.fetch_sub(1) == 1)
+    {
+      {
+        std::lock_guard< std::mutex > lock(idle_mutex_);
+      }
+      idle_cond_.notify_all();
+    }
+  }
+
+  void workerLoop(size_t index)
+  {
+    context().pool  = this;
+    context().index = index;
+
+    int idle_round = 0;
+    while (true)
+    {
+      SboTask task;
+      size_t victim = index;
+      if (popLocal(index, task))
+      {
+        runTask(task, index, false);
+        idle_round = 0;
+        continue;
+      }
+      if (steal(index, task, victim))
+      {
+        runTask(task, victim, true);
+        idle_round = 0;
+        continue;
+      }
+      if (++idle_round < WORK_STEAL_SPIN_COUNT)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      idle_round = 0;
+
+      std::unique_lock< std::mutex > lock(sleep_mutex_);
+      sleeping_.fetch_add(1);
+      sleep_cond_.wait(lock, [this] { return queued_.load() > 0 || !running_.load(); });
+      sleeping_.fetch_sub(1);
+      if (!running_.load() && queued_.load() == 0)
+      {
+        break;
+      }
+    }
+
+    context().pool = NULL;
+  }
+
+  std::vector< std::unique_ptr< WorkQueue > > queues_;
+  std::vector< std::thread > threads_;
+
+  const bool record_wait_;
+  std::atomic< bool > accepting_;
+  std::atomic< bool > running_;
+  std::atomic< int64_t > queued_;     //已入队未取出的任务数
+  std::atomic< int64_t > unfinished_; //已提交未执行完的任务数
+  std::atomic< int > sleeping_;       //休眠的线程数
+  std::atomic< size_t > next_queue_;  //外部提交时轮流选择队列
+
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cond_;
+  std::mutex idle_mutex_;
+  std::condition_variable idle_cond_;
+};
+
+} // namespace common
+} // namespace superg_agv
+
+#endif
@@ -0,0 +1,108 @@
+// RangeImageGround 与原 ImageSegment 的每帧地面分割耗时
+// 场景: 合成的 VLP-16 一帧(地面、坡道、箱体、围墙), 与 test_range_image_ground 使用同一帧
+// 用法: rosrun common range_image_ground_bench [帧数, 默认200] [线程池线程数, 默认3]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <vector>
+
+#include "range_image_ground.h"
+#include "../test/synthetic_vlp16.h"
+
+using namespace superg_agv::common;
+using namespace superg_agv::common::synthetic;
+
+namespace
+{
+double nowUs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+  int frames  = argc > 1 ? atoi(argv[1]) : 200;
+  int threads = argc > 2 ? atoi(argv[2]) : 3;
+  if (frames <= 0 || threads <= 0)
+  {
+    printf("usage: %s [frames] [pool threads]\n", argv[0]);
+    return 1;
+  }
+
+  const int packets           = 76;
+  const int columns           = 24 * packets;
+  std::vector< Sample > frame = makeFrame(columns);
+  std::vector< PointXYZI > cloud(frame.size());
+  for (size_t i = 0; i < frame.size(); i++)
+  {
+    PointXYZI point = {frame[i].x, frame[i].y, frame[i].z, 0};
+    cloud[i]        = point;
+  }
+  printf("%zu points, %d x %d range image, %d frames\n", frame.size(), SYNTHETIC_RINGS, columns, frames);
+
+  LegacyImageSegment legacy(columns);
+  double t0 = nowUs();
+  for (int k = 0; k < frames; k++)
+  {
+    legacy.setCloud(cloud);
+    legacy.detect();
+  }
+  double legacy_us = (nowUs() - t0) / frames;
+
+  RangeImageGround image;
+  image.setup(SYNTHETIC_RINGS, columns);
+  Cloud ground, obstacle;
+  t0 = nowUs();
+  for (int k = 0; k < frames; k++)
+  {
+    image.clear();
+    for (size_t i = 0; i < cloud.size(); i++)
+    {
+      image.addPoint(cloud[i].x, cloud[i].y, cloud[i].z);
+    }
+    image.label();
+    image.extract(&ground, &obstacle);
+  }
+  double xyz_us = (nowUs() - t0) / frames;
+
+  t0 = nowUs();
+  for (int k = 0; k < frames; k++)
+  {
+    image.clear();
+    for (size_t i = 0; i < frame.size(); i++)
+    {
+      image.setPoint(frame[i].ring, image.column(frame[i].azimuth), frame[i].x, frame[i].y, frame[i].z);
+    }
+    image.label();
+    image.extract(&ground, &obstacle);
+  }
+  double layout_us = (nowUs() - t0) / frames;
+
+  t0 = nowUs();
+  for (int k = 0; k < frames; k++)
+  {
+    image.label();
+  }
+  double label_us = (nowUs() - t0) / frames;
+
+  WorkStealPool pool(threads);
+  t0 = nowUs();
+  for (int k = 0; k < frames; k++)
+  {
+    image.label(&pool);
+  }
+  double label_pool_us = (nowUs() - t0) / frames;
+
+  printf("us per frame\n");
+  printf("  legacy ImageSegment (xyz, atan2)      %8.1f\n", legacy_us);
+  printf("  RangeImageGround addPoint (xyz)       %8.1f\n", xyz_us);
+  printf("  RangeImageGround setPoint (ring/col)  %8.1f\n", layout_us);
+  printf("  label only                            %8.1f\n", label_us);
+  printf("  label, pool %d threads                 %8.1f\n", threads, label_pool_us);
+  printf("ground %zu obstacle %zu\n", ground.size(), obstacle.size());
+  return 0;
+}
@@ -0,0 +1,188 @@
+// WorkStealPool 与原 can_wr fixed_thread_pool(单队列 + 互斥锁 + 条件变量)的任务吞吐对比
+// 场景: 多个外部线程同时提交空任务; 池内任务再提交子任务(递归拆分)
+// 用法: rosrun common work_steal_pool_bench [任务数] [提交线程数]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "work_steal_pool.h"
+
+using superg_agv::common::WorkStealPool;
+
+namespace
+{
+double nowMs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+//原 can_wr/include/thread_pool.h 的实现, 所有线程争用同一个队列
+class MutexQueuePool
+{
+public:
+  explicit MutexQueuePool(size_t thread_count) : data_(std::make_shared< Data >())
+  {
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+      std::thread(&MutexQueuePool::workerLoop, data_).detach();
+    }
+  }
+
+  ~MutexQueuePool()
+  {
+    {
+      std::lock_guard< std::mutex > lk(data_->mtx_);
+      data_->is_shutdown_ = true;
+    }
+    data_->cond_.notify_all();
+  }
+
+  template < class F > void execute(F &&task)
+  {
+    {
+      std::lock_guard< std::mutex > lk(data_->mtx_);
+      data_->tasks_.emplace(std::forward< F >(task));
+    }
+    data_->cond_.notify_one();
+  }
+
+private:
+  struct Data
+  {
+    Data() : is_shutdown_(false)
+    {
+    }
+    std::mutex mtx_;
+    std::condition_variable cond_;
+    bool is_shutdown_;
+    std::queue< std::function< void() > > tasks_;
+  };
+
+  static void workerLoop(std::shared_ptr< Data > data)
+  {
+    std::unique_lock< std::mutex > lk(data->mtx_);
+    for (;;)
+    {
+      if (!data->tasks_.empty())
+      {
+        auto current = std::move(data->tasks_.front());
+        data->tasks_.pop();
+        lk.unlock();
+        current();
+        lk.lock();
+      }
+      else if (data->is_shutdown_)
+      {
+        break;
+      }
+      else
+      {
+        data->cond_.wait(lk);
+      }
+    }
+  }
+
+  std::shared_ptr< Data > data_;
+};
+
+//等待计数到达 total, 原线程池没有 waitIdle
+void waitDone(const std::atomic< int > &done, int total)
+{
+  while (done.load() < total)
+  {
+    std::this_thread::yield();
+  }
+}
+
+//外部线程并发提交空任务, 返回每个任务的平均耗时(ns)
+template < class Pool > double externalSubmit(Pool &pool, int tasks, int producers)
+{
+  std::atomic< int > done(0);
+  double t0 = nowMs();
+  std::vector< std::thread > threads;
+  for (int p = 0; p < producers; p++)
+  {
+    threads.push_back(std::thread([&pool, &done, tasks, producers] {
+      for (int i = 0; i < tasks / producers; i++)
+      {
+        pool.execute([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+      }
+    }));
+  }
+  for (size_t p = 0; p < threads.size(); p++)
+  {
+    threads[p].join();
+  }
+  waitDone(done, tasks / producers * producers);
+  return (nowMs() - t0) * 1e6 / tasks;
+}
+
+//池内任务各提交 fanout 个子任务, 返回每个任务的平均耗时(ns)
+template < class Pool > double nestedSubmit(Pool &pool, int tasks, int fanout)
+{
+  std::atomic< int > done(0);
+  int parents = tasks / (fanout + 1);
+  double t0   = nowMs();
+  for (int i = 0; i < parents; i++)
+  {
+    pool.execute([&pool, &done, fanout] {
+      for (int k = 0; k < fanout; k++)
+      {
+        pool.execute([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+      }
+      done.fetch_add(1, std::memory_order_relaxed);
+    });
+  }
+  waitDone(done, parents * (fanout + 1));
+  return (nowMs() - t0) * 1e6 / (parents * (fanout + 1));
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+  int tasks     = argc > 1 ? atoi(argv[1]) : 1000000;
+  int producers = argc > 2 ? atoi(argv[2]) : 4;
+  if (tasks <= 0 || producers <= 0)
+  {
+    printf("usage: %s [tasks] [producers]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%d tasks, %d producers, ns per task\n", tasks, producers);
+  printf("threads  case      mutex_queue  work_steal  work_steal(record_wait)\n");
+  const int thread_nums[] = {1, 2, 4, 8};
+  for (int t = 0; t < 4; t++)
+  {
+    int threads = thread_nums[t];
+    double mutex_ext, steal_ext, record_ext, mutex_nest, steal_nest, record_nest;
+    {
+      MutexQueuePool pool(threads);
+      mutex_ext  = externalSubmit(pool, tasks, producers);
+      mutex_nest = nestedSubmit(pool, tasks, 10);
+    }
+    {
+      WorkStealPool pool(threads);
+      steal_ext  = externalSubmit(pool, tasks, producers);
+      steal_nest = nestedSubmit(pool, tasks, 10);
+    }
+    {
+      WorkStealPool pool(threads, std::vector< int >(), true);
+      record_ext  = externalSubmit(pool, tasks, producers);
+      record_nest = nestedSubmit(pool, tasks, 10);
+    }
+    printf("%7d  external  %11.1f  %10.1f  %10.1f\n", threads, mutex_ext, steal_ext, record_ext);
+    printf("%7d  nested    %11.1f  %10.1f  %10.1f\n", threads, mutex_nest, steal_nest, record_nest);
+  }
+  return 0;
+}
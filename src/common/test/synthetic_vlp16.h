@@ -0,0 +1,193 @@
+#pragma once
+#ifndef COMMON_TEST_SYNTHETIC_VLP16_H
+#define COMMON_TEST_SYNTHETIC_VLP16_H
+
+// range_image_ground 测试与耗时对比共用: 合成的 VLP-16 一帧点云, 以及改用 RangeImageGround 之前的 ImageSegment 实现
+#include <math.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace superg_agv
+{
+namespace common
+{
+namespace synthetic
+{
+
+#define SYNTHETIC_RINGS 16
+
+struct PointXYZI
+{
+  float x, y, z, intensity;
+};
+
+//满足 RangeImageGround::extract 的最小点云类型
+struct Cloud
+{
+  typedef PointXYZI PointType;
+  std::vector< PointXYZI > points;
+  void clear()
+  {
+    points.clear();
+  }
+  void reserve(size_t n)
+  {
+    points.reserve(n);
+  }
+  void push_back(const PointXYZI &p)
+  {
+    points.push_back(p);
+  }
+  size_t size() const
+  {
+    return points.size();
+  }
+};
+
+//带真值的点, ring/azimuth 与驱动解码得到的一致
+struct Sample
+{
+  int ring;
+  int col;
+  int azimuth; // 0.01 度
+  float x, y, z;
+  bool ground;
+};
+
+//地面高度: 传感器高 1.8m, x < -3m 为坡道, 每米升高 5cm
+inline float floorHeight(float x)
+{
+  return -1.8f + (x < -3.0f ? (-3.0f - x) * 0.05f : 0.0f);
+}
+
+//沿射线步进求交: 前方箱体 x∈[4,6] |y|<2 高 2.5m, 半径 25m 的围墙高 4m, 其余打在地面/坡道上
+inline bool traceRay(float vertical, float horizon, Sample &sample)
+{
+  float dx = cosf(vertical) * cosf(horizon);
+  float dy = cosf(vertical) * sinf(horizon);
+  float dz = sinf(vertical);
+  for (float t = 0.3f; t < 60.0f; t += 0.02f)
+  {
+    float px  = dx * t, py = dy * t, pz = dz * t;
+    bool box  = px > 4 && px < 6 && fabsf(py) < 2 && pz < -1.8f + 2.5f;
+    bool wall = px * px + py * py > 25 * 25 && pz < -1.8f + 4;
+    if (box || wall || pz <= floorHeight(px))
+    {
+      sample.x      = px;
+      sample.y      = py;
+      sample.z      = pz;
+      sample.ground = !(box || wall);
+      return true;
+    }
+  }
+  return false;
+}
+
+// VLP-16 一帧, 垂直角 -15~15 度间隔 2 度, columns 列均匀分布一圈, z 加 ±1cm 噪声
+inline std::vector< Sample > makeFrame(int columns)
+{
+  std::vector< Sample > frame;
+  unsigned seed = 1;
+  for (int col = 0; col < columns; col++)
+  {
+    int azimuth   = ( int )((( int64_t )col * 36000 + columns - 1) / columns);
+    float horizon = -azimuth / 18000.0f * ( float )M_PI; //方位角顺时针
+    for (int ring = 0; ring < SYNTHETIC_RINGS; ring++)
+    {
+      Sample sample;
+      sample.ring    = ring;
+      sample.col     = col;
+      sample.azimuth = azimuth;
+      if (!traceRay((-15 + 2 * ring) * ( float )M_PI / 180, horizon, sample))
+      {
+        continue;
+      }
+      seed = seed * 1103515245 + 12345;
+      sample.z += (((seed >> 8) % 1000) / 1000.0f - 0.5f) * 0.02f;
+      frame.push_back(sample);
+    }
+  }
+  return frame;
+}
+
+//原 vl_lidar_driver/lidar_fusion 中 ImageSegment 的分割逻辑, 输出中地面点成对加入, 有重复
+class LegacyImageSegment
+{
+public:
+  explicit LegacyImageSegment(int columns) : columns_(columns)
+  {
+  }
+
+  void setCloud(const std::vector< PointXYZI > &laser)
+  {
+    PointXYZI nan_point = {NAN, NAN, NAN, -1};
+    full_.assign(SYNTHETIC_RINGS * columns_, nan_point);
+    ground.clear();
+    filtered.clear();
+    for (size_t i = 0; i < laser.size(); i++)
+    {
+      PointXYZI point      = laser[i];
+      float vertical_angle = round(atan2(point.z, sqrt(pow(point.x, 2) + pow(point.y, 2))) * 180 / M_PI);
+      int row_ind          = (vertical_angle + SYNTHETIC_RINGS - 1) / 2;
+      if (row_ind < 0 || row_ind >= SYNTHETIC_RINGS)
+      {
+        continue;
+      }
+      float horizon_angle = atan2(point.y, point.x) * 180 / M_PI;
+      int column_ind      = -round((horizon_angle - 90.0) / (360.0 / columns_)) + columns_ / 2;
+      if (column_ind >= columns_)
+      {
+        column_ind -= columns_;
+      }
+      if (column_ind < 0 || column_ind >= columns_)
+      {
+        continue;
+      }
+      point.intensity                         = row_ind;
+      full_[column_ind + row_ind * columns_] = point;
+    }
+  }
+
+  void detect()
+  {
+    for (int j = 0; j < columns_; j++)
+    {
+      for (int i = 0; i < SYNTHETIC_RINGS / 2; i++)
+      {
+        const PointXYZI &lo = full_[j + i * columns_];
+        const PointXYZI &up = full_[j + (i + 1) * columns_];
+        if (lo.intensity == -1 || up.intensity == -1)
+        {
+          continue;
+        }
+        float dx    = up.x - lo.x, dy = up.y - lo.y, dz = up.z - lo.z;
+        float angle = atan2(dz, sqrt(pow(dx, 2) + pow(dy, 2))) * 180 / M_PI;
+        std::vector< PointXYZI > &out = fabs(angle) <= 15.0 ? ground : filtered;
+        out.push_back(lo);
+        out.push_back(up);
+      }
+      for (int i = SYNTHETIC_RINGS / 2; i < SYNTHETIC_RINGS; i++)
+      {
+        const PointXYZI &point = full_[j + i * columns_];
+        if (point.intensity != -1)
+        {
+          filtered.push_back(point);
+        }
+      }
+    }
+  }
+
+  std::vector< PointXYZI > ground;
+  std::vector< PointXYZI > filtered;
+
+private:
+  int columns_;
+  std::vector< PointXYZI > full_;
+};
+
+} // namespace synthetic
+} // namespace common
+} // namespace superg_agv
+
+#endif // COMMON_TEST_SYNTHETIC_VLP16_H
@@ -0,0 +1,218 @@
+#include "range_image_ground.h"
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "synthetic_vlp16.h"
+
+using namespace superg_agv::common;
+using namespace superg_agv::common::synthetic;
+
+namespace
+{
+const int packets = 76;
+const int columns = 24 * packets;
+
+struct Matrix4
+{
+  float m[4][4];
+  float operator()(int row, int col) const
+  {
+    return m[row][col];
+  }
+};
+
+std::vector< PointXYZI > toCloud(const std::vector< Sample > &frame)
+{
+  std::vector< PointXYZI > cloud(frame.size());
+  for (size_t i = 0; i < frame.size(); i++)
+  {
+    PointXYZI point = {frame[i].x, frame[i].y, frame[i].z, 0};
+    cloud[i]        = point;
+  }
+  return cloud;
+}
+
+//按坐标(毫米)去重, 原实现的输出有重复点
+std::vector< int64_t > uniqueKeys(const std::vector< PointXYZI > &points)
+{
+  std::vector< int64_t > keys(points.size());
+  for (size_t i = 0; i < points.size(); i++)
+  {
+    keys[i] = ((( int64_t )lroundf(points[i].x * 1000) * 1000003 + lroundf(points[i].y * 1000)) * 1000003) +
+              lroundf(points[i].z * 1000);
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  return keys;
+}
+
+void fillByLayout(RangeImageGround &image, const std::vector< Sample > &frame)
+{
+  image.clear();
+  for (size_t i = 0; i < frame.size(); i++)
+  {
+    image.setPoint(frame[i].ring, image.column(frame[i].azimuth), frame[i].x, frame[i].y, frame[i].z);
+  }
+}
+} // namespace
+
+//驱动解码路径: 线号、列号已知, 每个点都落在自己的格子里; 下半部分的地面点都标为地面
+//只比较上下相邻两线, 围墙/箱体根部与地面点相邻时也会标为地面, 与原实现相同, 这里只输出数量
+TEST(RangeImageGround, LayoutPathLabelsEveryPoint)
+{
+  std::vector< Sample > frame = makeFrame(columns);
+  RangeImageGround image;
+  image.setup(SYNTHETIC_RINGS, columns);
+  fillByLayout(image, frame);
+  image.label();
+
+  int ground_num = 0, wrong_ground = 0, wrong_obstacle = 0;
+  for (size_t i = 0; i < frame.size(); i++)
+  {
+    uint8_t label = image.labelAt(frame[i].ring, image.column(frame[i].azimuth));
+    ASSERT_NE(RANGE_IMAGE_NONE, label) << "point " << i;
+    bool ground = label == RANGE_IMAGE_GROUND;
+    ground_num += frame[i].ground;
+    wrong_ground += ground && !frame[i].ground;
+    wrong_obstacle += !ground && frame[i].ground;
+  }
+  printf("%zu points, %d ground: obstacle labelled ground %d, ground labelled obstacle %d\n", frame.size(),
+         ground_num, wrong_ground, wrong_obstacle);
+  EXPECT_EQ(0, wrong_obstacle);
+
+  Cloud ground, obstacle;
+  image.extract(&ground, &obstacle);
+  EXPECT_EQ(frame.size(), ground.size() + obstacle.size());
+}
+
+//坐标路径与原 ImageSegment 的地面/非地面划分逐点一致(去重后)
+TEST(RangeImageGround, XyzPathMatchesLegacy)
+{
+  std::vector< Sample > frame     = makeFrame(columns);
+  std::vector< PointXYZI > cloud  = toCloud(frame);
+  LegacyImageSegment legacy(columns);
+  legacy.setCloud(cloud);
+  legacy.detect();
+
+  RangeImageGround image;
+  image.setup(SYNTHETIC_RINGS, columns);
+  image.clear();
+  int added = 0;
+  for (size_t i = 0; i < cloud.size(); i++)
+  {
+    added += image.addPoint(cloud[i].x, cloud[i].y, cloud[i].z);
+  }
+  image.label();
+  Cloud ground, obstacle;
+  image.extract(&ground, &obstacle);
+  EXPECT_GT(added, ( int )(cloud.size() * 0.95));
+
+  std::vector< int64_t > legacy_ground   = uniqueKeys(legacy.ground);
+  std::vector< int64_t > legacy_filtered = uniqueKeys(legacy.filtered);
+  std::vector< int64_t > new_ground      = uniqueKeys(ground.points);
+  std::vector< int64_t > new_obstacle    = uniqueKeys(obstacle.points);
+  //原实现同一点可能同时在两个输出中, 出现在地面输出中即按地面
+  std::vector< int64_t > legacy_obstacle;
+  std::set_difference(legacy_filtered.begin(), legacy_filtered.end(), legacy_ground.begin(), legacy_ground.end(),
+                      std::back_inserter(legacy_obstacle));
+  std::vector< int64_t > same_ground, same_obstacle;
+  std::set_intersection(legacy_ground.begin(), legacy_ground.end(), new_ground.begin(), new_ground.end(),
+                        std::back_inserter(same_ground));
+  std::set_intersection(legacy_obstacle.begin(), legacy_obstacle.end(), new_obstacle.begin(), new_obstacle.end(),
+                        std::back_inserter(same_obstacle));
+  EXPECT_EQ(legacy_ground.size(), same_ground.size());
+  EXPECT_EQ(legacy_obstacle.size(), same_obstacle.size());
+  //原实现相邻线缺点时丢掉下半部分的点, 合成帧每格都有点, 两者点数相同
+  EXPECT_EQ(legacy_ground.size() + legacy_obstacle.size(), new_ground.size() + new_obstacle.size());
+}
+
+//坐标变换与线程池分块不改变结果
+TEST(RangeImageGround, TransformAndPoolKeepLabels)
+{
+  std::vector< Sample > frame = makeFrame(columns);
+  RangeImageGround image;
+  image.setup(SYNTHETIC_RINGS, columns);
+  fillByLayout(image, frame);
+  image.label();
+  Cloud ground, obstacle;
+  image.extract(&ground, &obstacle);
+
+  Matrix4 lift = {{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 1.8f}, {0, 0, 0, 1}}};
+  image.transform(lift);
+  image.label();
+  Cloud lifted_ground, lifted_obstacle;
+  image.extract(&lifted_ground, &lifted_obstacle);
+  ASSERT_EQ(ground.size(), lifted_ground.size());
+  ASSERT_EQ(obstacle.size(), lifted_obstacle.size());
+  EXPECT_NEAR(ground.points[0].z + 1.8f, lifted_ground.points[0].z, 1e-4);
+
+  std::vector< uint8_t > serial_labels;
+  for (int ring = 0; ring < SYNTHETIC_RINGS; ring++)
+  {
+    for (int col = 0; col < columns; col++)
+    {
+      serial_labels.push_back(image.labelAt(ring, col));
+    }
+  }
+  WorkStealPool pool(3);
+  const int blocks[] = {0, 2, 7, columns + 5};
+  for (int b = 0; b < 4; b++)
+  {
+    image.label(&pool, blocks[b]);
+    for (int ring = 0; ring < SYNTHETIC_RINGS; ring++)
+    {
+      for (int col = 0; col < columns; col++)
+      {
+        ASSERT_EQ(serial_labels[ring * columns + col], image.labelAt(ring, col))
+            << "blocks " << blocks[b] << " ring " << ring << " col " << col;
+      }
+    }
+  }
+}
+
+TEST(RangeImageGround, Atan2Approximation)
+{
+  double max_error = 0;
+  for (int i = 0; i < 100000; i++)
+  {
+    float angle = i * 2 * M_PI / 100000 - M_PI;
+    float y = sinf(angle) * 7, x = cosf(angle) * 7;
+    max_error   = std::max(max_error, fabs(( double )rangeImageAtan2(y, x) - atan2(( double )y, ( double )x)));
+  }
+  printf("atan2 max error %.2e rad\n", max_error);
+  EXPECT_LT(max_error, 5e-5);
+  EXPECT_EQ(0.0f, rangeImageAtan2(0, 0));
+}
+
+//垂直角分界: 每线中心角的点落在自己的线上, 超出最上/最下分界的点不加入
+TEST(RangeImageGround, AddPointRing)
+{
+  RangeImageGround image;
+  image.setup(SYNTHETIC_RINGS, 360);
+  for (int ring = 0; ring < SYNTHETIC_RINGS; ring++)
+  {
+    image.clear();
+    float vertical = (-15 + 2 * ring) * M_PI / 180;
+    ASSERT_TRUE(image.addPoint(10 * cosf(vertical), 0, 10 * sinf(vertical)));
+    image.label();
+    // x 轴正方向(水平角 0 度)在 3/4 列处
+    for (int r = 0; r < SYNTHETIC_RINGS; r++)
+    {
+      EXPECT_EQ(r == ring, image.labelAt(r, 270) != RANGE_IMAGE_NONE) << "ring " << ring << " row " << r;
+    }
+  }
+  EXPECT_FALSE(image.addPoint(10, 0, 10 * tanf(17 * M_PI / 180)));
+  EXPECT_FALSE(image.addPoint(0, 0, 1));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,312 @@
+#include "veh_io.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <pty.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "seq_lock.h"
+
+using namespace superg_agv::common;
+
+namespace
+{
+struct Wide
+{
+  uint64_t v[8];
+};
+
+VehCanFrame makeFrame(uint32_t id, uint8_t fill)
+{
+  VehCanFrame frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.id  = id;
+  frame.dlc = 8;
+  memset(frame.data, fill, sizeof(frame.data));
+  return frame;
+}
+
+//数据区 8 字节相同即为完整的一帧
+bool uniform(const VehCanFrame &frame)
+{
+  for (int i = 1; i < 8; i++)
+  {
+    if (frame.data[i] != frame.data[0])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void setRaw(int fd)
+{
+  struct termios tio;
+  tcgetattr(fd, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(fd, TCSANOW, &tio);
+}
+} // namespace
+
+//一个写线程高频写、两个读线程读, 读到的 8 个字必须来自同一次写入
+TEST(SeqLock, ReadersNeverSeeTornValue)
+{
+  SeqLock< Wide > slot;
+  std::atomic< bool > stop(false);
+  std::atomic< uint64_t > reads(0), torn(0);
+  std::vector< std::thread > readers;
+  for (int r = 0; r < 2; r++)
+  {
+    readers.push_back(std::thread([&] {
+      Wide value;
+      while (!stop)
+      {
+        slot.load(&value);
+        for (int i = 1; i < 8; i++)
+        {
+          torn += value.v[i] != value.v[0];
+        }
+        reads++;
+      }
+    }));
+  }
+  const uint32_t writes = 2000000;
+  Wide value;
+  for (uint64_t n = 1; n <= writes; n++)
+  {
+    for (int i = 0; i < 8; i++)
+    {
+      value.v[i] = n;
+    }
+    slot.store(value);
+  }
+  stop = true;
+  for (size_t r = 0; r < readers.size(); r++)
+  {
+    readers[r].join();
+  }
+  printf("seqlock: %lu reads, %lu torn\n", ( unsigned long )reads.load(), ( unsigned long )torn.load());
+  EXPECT_EQ(0u, torn.load());
+  EXPECT_EQ(writes, slot.version());
+}
+
+//带随机损坏帧和噪声字节的串口流, 按随机长度分段送入: 完好的帧都收到, 收到的帧都没有被改动
+TEST(VehFramer, CorruptedStreamFuzz)
+{
+  srand(1);
+  std::vector< uint8_t > stream;
+  int good = 0;
+  for (int n = 0; n < 20000; n++)
+  {
+    VehCanFrame frame = makeFrame(0x112, 0);
+    for (int i = 0; i < 8; i++)
+    {
+      frame.data[i] = ( uint8_t )(n * 7 + i);
+    }
+    uint8_t buf[VEH_SERIAL_FRAME_LEN];
+    VehFramer::encode(frame, buf);
+    if (rand() % 10 == 0)
+    {
+      buf[2 + rand() % 15] ^= ( uint8_t )(1 + rand() % 255);
+    }
+    else
+    {
+      good++;
+    }
+    if (rand() % 5 == 0)
+    {
+      stream.push_back(0xAA);
+      stream.push_back(( uint8_t )rand());
+    }
+    stream.insert(stream.end(), buf, buf + sizeof(buf));
+  }
+
+  VehFramer framer;
+  int got = 0, changed = 0;
+  auto handler = [&](const VehCanFrame &frame) {
+    got++;
+    for (int i = 1; i < 8; i++)
+    {
+      changed += ( uint8_t )(frame.data[i] - frame.data[0]) != i;
+    }
+  };
+  size_t pos = 0;
+  while (pos < stream.size())
+  {
+    size_t n = std::min< size_t >(1 + rand() % 40, stream.size() - pos);
+    framer.push(&stream[pos], n, handler);
+    pos += n;
+  }
+  printf("framer: good %d got %d crc_err %lu skipped %lu\n", good, got, ( unsigned long )framer.stats().crc_errors,
+         ( unsigned long )framer.stats().skipped_bytes);
+  EXPECT_EQ(0, changed);
+  EXPECT_GE(got, good);
+  //损坏恰好落在数据区且 CRC 碰撞才会多收, 极少
+  EXPECT_LT(got - good, 5);
+  EXPECT_GT(framer.stats().crc_errors, 0u);
+}
+
+// pty 上的假车辆: 100Hz 分两段写状态帧, 每 10 帧损坏一帧; 同时另一线程高频改发送指令
+TEST(VehIo, SerialFakeVehicle)
+{
+  int master, slave;
+  char name[64];
+  ASSERT_EQ(0, openpty(&master, &slave, name, NULL, NULL));
+  setRaw(slave);
+  setRaw(master);
+
+  VehIo io;
+  SeqLock< VehCanFrame > cmd;
+  std::atomic< int > rx(0), rx_bad(0);
+  io.setRxHandler([&](const VehCanFrame &frame, uint64_t) {
+    rx_bad += frame.id != 0x112 || !uniform(frame);
+    rx++;
+  });
+  io.setTxTimer(200, [&](VehCanFrame *frame) { return cmd.load(frame) != 0; });
+  ASSERT_TRUE(io.openSerial(name, 115200));
+  ASSERT_TRUE(io.start());
+  fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+  std::atomic< bool > stop(false);
+  std::atomic< int > veh_rx(0), veh_torn(0), veh_sent(0), write_err(0);
+  std::thread vehicle([&] {
+    VehFramer framer;
+    auto handler = [&](const VehCanFrame &frame) {
+      veh_rx++;
+      veh_torn += !uniform(frame);
+    };
+    int n             = 0;
+    uint64_t next_ns  = vehIoNowNs();
+    while (!stop)
+    {
+      uint8_t buf[512];
+      ssize_t len = read(master, buf, sizeof(buf));
+      if (len > 0)
+      {
+        framer.push(buf, len, handler);
+      }
+      if (vehIoNowNs() < next_ns)
+      {
+        usleep(100);
+        continue;
+      }
+      next_ns += 10000000;
+      uint8_t out[VEH_SERIAL_FRAME_LEN];
+      VehFramer::encode(makeFrame(0x112, ( uint8_t )n), out);
+      if (n % 10 == 9)
+      {
+        out[6] ^= 0x10;
+      }
+      else
+      {
+        veh_sent++;
+      }
+      write_err += write(master, out, 5) != 5;
+      usleep(200);
+      write_err += write(master, out + 5, sizeof(out) - 5) != ( ssize_t )(sizeof(out) - 5);
+      n++;
+    }
+  });
+  std::thread writer([&] {
+    for (uint32_t k = 0; !stop; k++)
+    {
+      cmd.store(makeFrame(0x111, ( uint8_t )k));
+    }
+  });
+
+  sleep(2);
+  stop = true;
+  writer.join();
+  vehicle.join();
+  usleep(50000);
+  VehIoStats st = io.takeStats();
+  io.stop();
+  close(master);
+  close(slave);
+
+  printf("pty: rx %d (sent %d) crc_err %lu | vehicle got %d | tx %lu drop %lu overrun %lu late %lu | "
+         "wake avg %.1fus max %.1fus send avg %.1fus max %.1fus\n",
+         rx.load(), veh_sent.load(), ( unsigned long )st.crc_errors, veh_rx.load(), ( unsigned long )st.tx_frames,
+         ( unsigned long )st.tx_dropped, ( unsigned long )st.tx_overruns, ( unsigned long )st.tx_late,
+         st.wake_ns_avg / 1e3, st.wake_ns_max / 1e3, st.send_ns_avg / 1e3, st.send_ns_max / 1e3);
+  EXPECT_EQ(0, write_err.load());
+  EXPECT_EQ(0, rx_bad.load());
+  EXPECT_EQ(0, veh_torn.load());
+  EXPECT_GE(rx.load(), veh_sent.load() - 2);
+  EXPECT_GT(st.crc_errors, 0u);
+  // 200Hz 发送 2s
+  EXPECT_GT(veh_rx.load(), 300);
+}
+
+// CANET 网关: 一个 UDP 包多帧, 长度不是 13 的整数倍的包计格式错误
+TEST(VehIo, UdpGateway)
+{
+  VehIo io;
+  std::atomic< int > rx(0);
+  io.setRxHandler([&](const VehCanFrame &frame, uint64_t) { rx += frame.id == 0x18f120f0 && frame.ext; });
+  io.setTxTimer(100, [](VehCanFrame *frame) {
+    *frame = makeFrame(0x111, 0);
+    return true;
+  });
+  ASSERT_TRUE(io.openUdp("127.0.0.1", 24001, 24002));
+  ASSERT_TRUE(io.start());
+
+  int gateway = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = htons(24001);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(0, bind(gateway, ( struct sockaddr * )&addr, sizeof(addr)));
+  addr.sin_port = htons(24002);
+
+  uint8_t packet[3 * 13];
+  VehCanFrame frame = makeFrame(0x18f120f0, 0);
+  frame.ext         = 1;
+  for (int i = 0; i < 3; i++)
+  {
+    vehCanetEncode(frame, packet + 13 * i);
+  }
+  for (int i = 0; i < 10; i++)
+  {
+    sendto(gateway, packet, sizeof(packet), 0, ( struct sockaddr * )&addr, sizeof(addr));
+  }
+  sendto(gateway, packet, 20, 0, ( struct sockaddr * )&addr, sizeof(addr));
+  usleep(300000);
+  VehIoStats st = io.takeStats();
+  io.stop();
+
+  int got = 0;
+  uint8_t buf[64];
+  while (recv(gateway, buf, sizeof(buf), MSG_DONTWAIT) == 13)
+  {
+    VehCanFrame sent;
+    ASSERT_TRUE(vehCanetDecode(buf, &sent));
+    EXPECT_EQ(0x111u, sent.id);
+    got++;
+  }
+  close(gateway);
+  printf("udp: rx %d fmt_err %lu, gateway got %d tx %lu\n", rx.load(), ( unsigned long )st.format_errors, got,
+         ( unsigned long )st.tx_frames);
+  EXPECT_EQ(30, rx.load());
+  EXPECT_EQ(1u, st.format_errors);
+  EXPECT_GE(got, 25);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
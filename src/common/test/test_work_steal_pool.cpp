@@ -0,0 +1,163 @@
+#include "work_steal_pool.h"
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using superg_agv::common::WorkStealPool;
+using superg_agv::common::WorkStealStats;
+
+TEST(WorkStealPool, SubmitReturnsValue)
+{
+  WorkStealPool pool(4);
+  std::future< int > f = pool.submit([](int a, int b) { return a + b; }, 2, 3);
+  EXPECT_EQ(5, f.get());
+}
+
+TEST(WorkStealPool, SubmitThenChainsResult)
+{
+  WorkStealPool pool(4);
+  std::future< size_t > g =
+      pool.submitThen([] { return std::string("abc"); }, [](std::string s) { return s.size(); });
+  EXPECT_EQ(3u, g.get());
+  std::future< int > h = pool.submitThen([] {}, [] { return 7; });
+  EXPECT_EQ(7, h.get());
+}
+
+//前一个任务抛出异常时不执行后续任务, 异常由 future 抛出
+TEST(WorkStealPool, SubmitThenPropagatesException)
+{
+  WorkStealPool pool(2);
+  std::atomic< int > called(0);
+  std::future< int > e = pool.submitThen([]() -> int { throw std::runtime_error("first"); },
+                                         [&called](int v) {
+                                           called++;
+                                           return v;
+                                         });
+  EXPECT_THROW(e.get(), std::runtime_error);
+  pool.waitIdle();
+  EXPECT_EQ(0, called.load());
+}
+
+// execute 提交的任务抛出异常时线程继续运行, waitIdle 照常返回, 异常计入 failed
+TEST(WorkStealPool, ExecuteSwallowsException)
+{
+  WorkStealPool pool(2);
+  std::atomic< int > count(0);
+  for (int i = 0; i < 100; i++)
+  {
+    pool.execute([&count, i] {
+      if (i % 2 == 0)
+      {
+        throw std::runtime_error("task");
+      }
+      count++;
+    });
+  }
+  pool.waitIdle();
+  EXPECT_EQ(50, count.load());
+  uint64_t failed = 0;
+  for (size_t i = 0; i < pool.threadNum(); i++)
+  {
+    failed += pool.stats(i).failed;
+  }
+  EXPECT_EQ(50u, failed);
+}
+
+//池内提交的子任务也计入 waitIdle
+TEST(WorkStealPool, NestedTasksFinishBeforeWaitIdle)
+{
+  WorkStealPool pool(4);
+  std::atomic< int > count(0);
+  for (int i = 0; i < 1000; i++)
+  {
+    pool.execute([&count, &pool] {
+      for (int k = 0; k < 10; k++)
+      {
+        pool.execute([&count] { count++; });
+      }
+      count++;
+    });
+  }
+  pool.waitIdle();
+  EXPECT_EQ(11000, count.load());
+
+  uint64_t executed = 0;
+  for (size_t i = 0; i < pool.threadNum(); i++)
+  {
+    executed += pool.stats(i).executed;
+  }
+  EXPECT_EQ(11000u, executed);
+}
+
+//超过内部缓冲区的任务放在堆上
+TEST(WorkStealPool, LargeTask)
+{
+  WorkStealPool pool(2);
+  std::atomic< int > count(0);
+  char big[200] = {0};
+  big[199]      = 3;
+  pool.execute([big, &count] { count += big[199]; });
+  pool.waitIdle();
+  EXPECT_EQ(3, count.load());
+}
+
+TEST(WorkStealPool, ShutdownRunsQueuedTasks)
+{
+  std::atomic< int > count(0);
+  {
+    WorkStealPool pool(2);
+    for (int i = 0; i < 10000; i++)
+    {
+      pool.execute([&count] { count++; });
+    }
+  }
+  EXPECT_EQ(10000, count.load());
+}
+
+//默认不读时钟, 排队延迟为0; 开启后有统计
+TEST(WorkStealPool, WaitStatsOptional)
+{
+  {
+    WorkStealPool pool(2);
+    for (int i = 0; i < 1000; i++)
+    {
+      pool.execute([] {});
+    }
+    pool.waitIdle();
+    for (size_t i = 0; i < pool.threadNum(); i++)
+    {
+      WorkStealStats stats = pool.stats(i);
+      EXPECT_EQ(0u, stats.wait_ns_total);
+      EXPECT_EQ(0u, stats.wait_ns_max);
+    }
+  }
+  {
+    WorkStealPool pool(2, std::vector< int >(), true);
+    for (int i = 0; i < 1000; i++)
+    {
+      pool.execute([] {});
+    }
+    pool.waitIdle();
+    uint64_t wait_total = 0, wait_max = 0;
+    for (size_t i = 0; i < pool.threadNum(); i++)
+    {
+      WorkStealStats stats = pool.stats(i);
+      wait_total += stats.wait_ns_total;
+      wait_max = std::max(wait_max, stats.wait_ns_max);
+      EXPECT_LE(stats.wait_ns_max, stats.wait_ns_total);
+    }
+    printf("record_wait: total %lu ns, max %lu ns\n", ( unsigned long )wait_total, ( unsigned long )wait_max);
+    EXPECT_GT(wait_total, 0u);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
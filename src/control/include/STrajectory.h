@@ -3,6 +3,7 @@
 
 #include "ros/ros.h"
 #include "show_trajectory.h"
+#include "route_file.h"
 
 #include "iostream"
 
@@ -11,25 +12,8 @@ using namespace std;
 namespace display
 {
 
-  struct positionConf
-  {
-    u_int32_t n_gps_sequence_num;
-    double x;
-    double y;
-    double z;
-    double lon;
-    double lat;
-    double height;
-    double velocity_x;//velocity north
-    double velocity_y;//velocity east
-    double velocity_z;//velocity up	
-    double heading;
-    double pitch;
-    double roll;
-    double gps_seconds;
-    double velocity;
-    double dist;//里程，供saveroutepoint模式使用
-  };
+  //与控制节点共用路径点结构, 路径文件由 loadRouteFile 读取
+  typedef control::positionConf positionConf;
 
   class STrajectory
   {
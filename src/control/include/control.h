@@ -9,6 +9,7 @@
 #include "gp_control.h"
 #include "tp_control.h"
 #include "dg_control.h"
+#include "mpc_control.h"
 #include "save_route_point.h"
 
 #include <iostream>
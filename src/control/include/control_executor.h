@@ -0,0 +1,66 @@
+#ifndef CONTROL_EXECUTOR_H_
+#define CONTROL_EXECUTOR_H_
+
+#include "ros/ros.h"
+#include <control_msgs/ControlLoopStats.h>
+
+#include <atomic>
+#include <functional>
+#include <pthread.h>
+#include <stdint.h>
+
+namespace control
+{
+struct ExecutorConf
+{
+  bool enable;      // 是否使用独立控制线程
+  int frequency;    // 控制频率,单位Hz
+  int priority;     // SCHED_FIFO优先级,0代表不设置实时调度
+  int cpu;          // 绑定的CPU核,-1代表不绑定
+  double stats_rate; // 统计信息发布频率,单位Hz
+};
+
+// 独立控制线程: 按clock_nanosleep绝对截止时间周期执行控制步,
+// 统计超时次数与唤醒抖动, 回调在调用spin()的线程中处理
+class ControlExecutor
+{
+public:
+  ControlExecutor();
+  ~ControlExecutor();
+
+  void loadConf(ros::NodeHandle &nh);
+  bool enabled() const;
+
+  bool start(const std::function< void() > &step);
+  void stop();
+
+  // 启动控制线程, 在当前线程处理ROS回调并发布统计信息, 直到节点退出
+  void spin(ros::NodeHandle &nh, const std::function< void() > &step);
+
+  void fillStats(control_msgs::ControlLoopStats &msg) const;
+
+private:
+  static void *threadEntry(void *arg);
+  void run();
+  void statsTimerCallback(const ros::TimerEvent &event);
+
+  ExecutorConf conf_;
+  std::function< void() > step_;
+  pthread_t thread_;
+  bool thread_started_;
+  std::atomic< bool > running_;
+  std::atomic< bool > realtime_;
+
+  std::atomic< uint64_t > cycles_;
+  std::atomic< uint64_t > overruns_;
+  std::atomic< int64_t > jitter_sum_ns_;
+  std::atomic< int64_t > jitter_max_ns_;
+  std::atomic< int64_t > exec_sum_ns_;
+  std::atomic< int64_t > exec_max_ns_;
+
+  ros::Publisher stats_pub_;
+  ros::Timer stats_timer_;
+};
+
+} // end namespace control
+#endif
@@ -0,0 +1,28 @@
+#ifndef CONTROL_PARAM_FILE_H_
+#define CONTROL_PARAM_FILE_H_
+
+#include <map>
+#include <string>
+
+namespace control
+{
+// 不依赖参数服务器读取config下的扁平yaml参数文件("/control/xxx: value  # 注释"),
+// 供离线仿真等无roscore的场合使用, 接口与ros::NodeHandle::getParam保持一致
+class ControlParamFile
+{
+public:
+  ControlParamFile();
+
+  bool load(const std::string &path);
+  void set(const std::string &key, const std::string &value);
+
+  bool getParam(const std::string &key, int &value) const;
+  bool getParam(const std::string &key, double &value) const;
+  bool getParam(const std::string &key, std::string &value) const;
+
+private:
+  std::map< std::string, std::string > values_;
+};
+
+} // end namespace control
+#endif
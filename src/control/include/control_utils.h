@@ -37,6 +37,17 @@ struct positionConf
   double dist; //里程，供saveroutepoint模式使用
 };
 
+//单个控制周期输出的控制命令,供离线仿真读取
+struct ControlCommand
+{
+  uint32_t seq;         // 每输出一次命令加1
+  double angle_f;       // 前轮转角,单位度
+  double angle_r;       // 后轮转角,单位度
+  double velocity;      // 期望速度,单位m/s,后退为负
+  double lateral_error; // 横向控制模型输出
+  double vehicle_err;   // 距最近点的横向偏差,单位米
+};
+
 struct PIDTemp
 {
   double station_error;
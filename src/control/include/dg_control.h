@@ -2,8 +2,11 @@
 #define DG_CONTROL_H_
 
 #include "control.h"
+#include "control_executor.h"
 #include "control_utils.h"
 #include "pid_control.h"
+#include "route_file.h"
+#include "triple_buffer.h"
 #include "ros/ros.h"
 
 #include <iostream>
@@ -106,11 +109,15 @@ public:
   double computespeed(const double &R, const double &straightline_speed);
   ////主循环函数
   void dgControl();
+  //单个控制周期
+  void dgControlStep();
+  //取回调线程传来的最新数据
+  void updateFromCallbacks();
 
 protected:
   ////flags
   int start_tip_;
-  int32_t num_;
+  std::atomic< int32_t > num_; //回调线程累加, 控制线程读取清零
   int16_t math_tip_;
 
   ////structs
@@ -167,6 +174,12 @@ protected:
 
   double equal_length;
 
+  ////data from callback thread
+  positionConf recv_position_;
+  bool recv_position_valid_; //收到过定位位置后才把 recv_position_ 交给控制线程
+  TripleBuffer< positionConf > position_buf_;
+  ControlExecutor executor_;
+
   ////paramaters for gps2xy
   double L0;
   double lamda0;
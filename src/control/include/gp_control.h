@@ -2,8 +2,10 @@
 #define GP_CONTROL_H_
 
 #include "control.h"
+#include "control_executor.h"
 #include "control_utils.h"
 #include "pid_control.h"
+#include "triple_buffer.h"
 #include "ros/ros.h"
 
 #include <iostream>
@@ -99,6 +101,10 @@ public:
   double computespeed(const double &R, const double &straightline_speed);
   ////主循环函数
   void gpControl();
+  //单个控制周期
+  void gpControlStep();
+  //取回调线程传来的最新数据
+  void updateFromCallbacks();
   // 3元素平方和
   double sumSquares3D(const double &in_x, const double &in_y, const double &in_z);
 
@@ -108,7 +114,7 @@ protected:
   int16_t math_tip_;
   int plan_flag;
   int read_path_flag;
-  int num_;
+  std::atomic< int > num_; //回调线程累加, 控制线程读取清零
 
   ////structs
   vector< positionConf > global_route_data_;
@@ -170,6 +176,12 @@ protected:
 
   double equal_length;
 
+  ////data from callback thread
+  positionConf recv_position_;
+  TripleBuffer< positionConf > position_buf_;
+  TripleBuffer< vector< positionConf > > path_buf_;
+  ControlExecutor executor_;
+
   ////paramaters for gps2xy
   double L0;
   double lamda0;
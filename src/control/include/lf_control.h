@@ -2,8 +2,12 @@
 #define LF_CONTROL_H_
 
 #include "control.h"
+#include "control_executor.h"
+#include "control_param_file.h"
 #include "control_utils.h"
+#include "path_conditioner.h"
 #include "pid_control.h"
+#include "triple_buffer.h"
 #include "ros/ros.h"
 
 #include <iostream>
@@ -34,12 +38,27 @@ using namespace std;
 
 namespace control
 {
+//回调线程向控制线程传递的局部路径
+struct LocalPathConf
+{
+  vector< positionConf > route;
+  vector< int > cusps; //换向点索引
+  int plan_flag;
+  int path_mode;
+  int math_tip;
+};
+
 class LFControl
 {
 public:
   LFControl(ros::NodeHandle &nh);
+  //离线构造,从参数文件读取参数,不连接ROS
+  explicit LFControl(const ControlParamFile &params);
   ~LFControl();
 
+  //最近一次控制周期输出的命令
+  const ControlCommand &lastCommand() const;
+
   ////回调函数
   //仿真回调函数
   void recvPrescanRealtimePosCallback(const nav_msgs::Odometry &msg);
@@ -51,6 +70,8 @@ public:
   void recvFusionPosCallback(const location_msgs::FusionDataInfo &msg);
 
   void recvReflineStopCallback(const control_msgs::ADControlAGV &msg);
+  //发布预处理后的路径,供rviz显示
+  void publishConditionedPath(const vector< positionConf > &route);
 
   ////数学运算函数
   double pointDistanceSquare(const positionConf &xy_p, const positionConf &route_point);
@@ -76,9 +97,6 @@ public:
   double StanleyPreviewLatteralModel(const positionConf &xy_p, const positionConf &vnxy_p,
                                      const positionConf &vnxy_p_fc, const positionConf &vpxy_p);
 
-  //查找奇点函数
-  void findStrangePoints();
-
   //路段截取函数
   void route_cut(const positionConf &rpt);
 
@@ -114,6 +132,15 @@ public:
   double computedheading(const double &_heading1_,const double &_heading2_);
   ////主循环函数
   void lfControl();
+  //单个控制周期
+  void lfControlStep();
+  //取回调线程传来的最新数据
+  void updateFromCallbacks();
+  //初始化临时变量
+  void initVariables();
+  //读取yaml参数,参数源为ros::NodeHandle或ControlParamFile
+  template < typename ParamSource >
+  void loadParams(const ParamSource &nh);
   // 3元素平方和
   double sumSquares3D(const double &in_x, const double &in_y, const double &in_z);
 
@@ -134,7 +161,6 @@ protected:
 
   vector<int> route_section_index_;
 
-  vector< positionConf > lattice_route_data_;
   vector< positionConf > route_data_;
   vector< positionConf > previous_route_data_;
   vector< positionConf > route_section_data_;
@@ -156,6 +182,7 @@ protected:
 
   double control_angle_f;
   double control_angle_r;
+  ControlCommand last_command_;
 
   int section_decide_num;
   int previous_section_decide_num;
@@ -199,6 +226,18 @@ protected:
   double tp_speed;
 
   double equal_length;
+  // paramaters for path conditioning
+  PathConditionConf path_conf_;
+  int publish_conditioned_path;
+  PathConditioner path_conditioner_;
+  nav_msgs::Path conditioned_path_;
+
+  ////data from callback thread
+  positionConf recv_position_;
+  TripleBuffer< positionConf > position_buf_;
+  TripleBuffer< LocalPathConf > path_buf_;
+  TripleBuffer< control_msgs::ADControlAGV > refline_stop_buf_;
+  ControlExecutor executor_;
 
   ////paramaters for gps2xy
   double L0;
@@ -220,6 +259,7 @@ protected:
   ros::Publisher pre_point_pub_;
   ros::Publisher veh_point_pub_;
   ros::Publisher veh_path_pub_;
+  ros::Publisher conditioned_path_pub_;
   ros::Publisher control_vcu_pub_;
 };
 }
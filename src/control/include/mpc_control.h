@@ -0,0 +1,165 @@
+#ifndef MPC_CONTROL_H_
+#define MPC_CONTROL_H_
+
+#include "control_executor.h"
+#include "control_param_file.h"
+#include "control_utils.h"
+#include "qp_solver.h"
+#include "triple_buffer.h"
+#include "ros/ros.h"
+
+#include "control_msgs/ADControlAGV.h"
+#include "location_msgs/FusionDataInfo.h"
+#include <geometry_msgs/PoseStamped.h>
+#include <nav_msgs/Odometry.h>
+#include <plan_msgs/DecisionInfo.h>
+
+#include <vector>
+
+namespace control
+{
+struct MPCConf
+{
+  int horizon;             // 预测步数
+  double dt;               // 预测步长,单位秒
+  double q_lateral;        // 横向偏差权重
+  double q_heading;        // 航向偏差权重
+  double r_curvature;      // 曲率命令权重
+  double r_curvature_rate; // 曲率变化量权重
+  double q_speed;          // 速度跟踪权重
+  double r_accel;          // 加速度权重
+  double r_jerk;           // 加速度变化量权重
+  double max_accel;        // 最大加速度,单位m/s^2
+  double max_decel;        // 最大减速度,单位m/s^2
+  double max_lat_accel;    // 弯道最大侧向加速度,单位m/s^2
+  double rear_ratio;       // 后轮反向转角与前轮转角正切之比,0为前轮转向,1为对称四轮转向
+  double steer_rate;       // 车轮转角速度限制,单位deg/s
+  double delay;            // 执行机构延迟,单位秒
+  double min_speed;        // 横向模型线性化的最小速度,单位m/s
+  double speed_bin;        // 横向模型按速度分档缓存,单位m/s
+  double kappa_window;     // 参考曲率的差分半窗长,单位米
+  double stop_tolerance;   // 到达路径终点或换向点的距离,单位米
+  int max_iter;            // QP最大迭代次数
+};
+
+// 按行驶方向分段后的局部路径, heading为行驶方向的罗盘航向(弧度,段内连续), kappa左转为正
+struct MPCPath
+{
+  std::vector< double > x;
+  std::vector< double > y;
+  std::vector< double > s;
+  std::vector< double > heading;
+  std::vector< double > kappa;
+  std::vector< double > v;
+  std::vector< int > dir; // 1前进,-1后退
+  int plan_flag;
+  int valid;
+
+  void swap(MPCPath &other);
+};
+
+// 线性时变模型预测控制: 横向以横向偏差/航向偏差为状态、曲率为输入,
+// 纵向以加速度为输入跟踪参考速度, 均化为稠密QP由QPSolver热启动求解
+class MPCControl
+{
+public:
+  MPCControl(ros::NodeHandle &nh);
+  //离线构造,从参数文件读取参数,不连接ROS
+  explicit MPCControl(const ControlParamFile &params);
+  ~MPCControl();
+
+  ////回调函数
+  //仿真回调函数
+  void recvPrescanRealtimePosCallback(const nav_msgs::Odometry &msg);
+  // AGV1.0 融合定位信息
+  void recvFusionPosCallback(const location_msgs::FusionDataInfo &msg);
+  //局部路径回调函数
+  void recvLocalPathCallback(const plan_msgs::DecisionInfo &msg);
+  void recvReflineStopCallback(const control_msgs::ADControlAGV &msg);
+
+  ////主循环函数
+  void mpcControl();
+  //单个控制周期
+  void mpcControlStep();
+  //取回调线程传来的最新数据
+  void updateFromCallbacks();
+
+  //最近一次控制周期输出的命令
+  const ControlCommand &lastCommand() const;
+
+protected:
+  void initVariables();
+  template < typename ParamSource >
+  void loadParams(const ParamSource &nh);
+
+  //局部路径预处理: 分方向段, 计算里程/航向/曲率
+  void buildPath(const plan_msgs::DecisionInfo &msg, MPCPath &path) const;
+  //在[begin,end)点范围内投影, 返回所在段起点索引
+  int projectOnPath(double px, double py, int begin, int end, double &s, double &lateral) const;
+  //按里程线性插值
+  double interpolate(const std::vector< double > &value, double s, int begin, int end) const;
+
+  //横向/纵向QP矩阵构建
+  void setupLateral(double v);
+  void setupLongitudinal();
+  double solveLateral(double v, double lateral, double heading_err, double s0, double s_end, int begin, int end);
+  double solveLongitudinal(double v0, double s0, double s_end, int begin, int end);
+
+  //曲率转换为前后轮转角
+  void curvature2angle(double kappa, int dir, double &angle_f, double &angle_r) const;
+  void publishCommand(const ControlCommand &cmd, int index);
+
+  ////flags
+  int start_tip_;
+
+  ////paramaters from yaml
+  int mode;
+  int refline_stop;
+  double turn_ratio;
+  double max_turn_angle;
+  double center2frontaxis;
+  double center2rearaxis;
+  int turnleft_ispositive;
+  MPCConf conf_;
+
+  ////states
+  positionConf real_position_;
+  MPCPath path_;
+  control_msgs::ADControlAGV refline_stop_msg;
+  ControlCommand last_command_;
+  double kappa_prev_;
+  double accel_prev_;
+  double kappa_max_;
+  double dkappa_max_;
+
+  ////QP
+  QPSolver lat_solver_;
+  QPSolver lon_solver_;
+  int lat_speed_bin_;
+  std::vector< double > lat_gtqphi_; // N*2
+  std::vector< double > lat_gtqg_;   // N*N
+  std::vector< double > lat_q_;
+  std::vector< double > lat_l_;
+  std::vector< double > lat_u_;
+  std::vector< double > lat_w_;
+  std::vector< double > lon_q_;
+  std::vector< double > lon_l_;
+  std::vector< double > lon_u_;
+  std::vector< double > lon_vref_;
+
+  ////data from callback thread
+  positionConf recv_position_;
+  TripleBuffer< positionConf > position_buf_;
+  TripleBuffer< MPCPath > path_buf_;
+  TripleBuffer< control_msgs::ADControlAGV > refline_stop_buf_;
+  ControlExecutor executor_;
+
+  ////Subscriber and Publisher
+  ros::NodeHandle nh_;
+  ros::Subscriber pos_sub_;
+  ros::Subscriber local_path_sub_;
+  ros::Subscriber refline_stop_msg_sub_;
+  ros::Publisher control_vcu_pub_;
+};
+} // end namespace control
+#endif
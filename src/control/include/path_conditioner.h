@@ -0,0 +1,50 @@
+#ifndef PATH_CONDITIONER_H_
+#define PATH_CONDITIONER_H_
+
+#include "control_utils.h"
+
+#include <common_msgs/PathPoint.h>
+#include <vector>
+
+namespace control
+{
+struct PathConditionConf
+{
+  double equal_length;  // 插值间距,单位米
+  double tp_speed;      // 插值点最小速度(速度大于0时),单位m/s
+  double outlier_angle; // 相邻两段方向夹角大于该值且航向未换向时视为离群点,单位度,0代表不剔除
+  int smooth_window;    // Savitzky-Golay平滑窗口点数(奇数),小于5代表不平滑
+};
+
+// 规划路径预处理: 剔除重复点与离群点, 按弧长等间距插值, 可选平滑
+// 输出缓冲区由调用者复用, 只在点数增加时重新分配
+class PathConditioner
+{
+public:
+  PathConditioner();
+
+  void setConf(const PathConditionConf &conf);
+  const PathConditionConf &conf() const;
+
+  // in: 规划路径点; route: 插值后的路径; cusps: 与下一点航向相差90度以上的换向点索引
+  // 返回剔除的点数
+  int condition(const std::vector< common_msgs::PathPoint > &in, std::vector< positionConf > &route,
+                std::vector< int > &cusps);
+
+private:
+  void smooth(std::vector< positionConf > &route, int begin, int end);
+
+  PathConditionConf conf_;
+  double outlier_cos_;
+  std::vector< int > keep_;          // 保留的输入点索引
+  std::vector< int > counts_;        // 每段插值点数
+  std::vector< double > sg_weights_; // 二次Savitzky-Golay中心点权重
+  std::vector< double > sx_;
+  std::vector< double > sy_;
+};
+
+// 航向差heading1-heading2, 范围(-180,180], 单位度
+double headingDifference(double heading1, double heading2);
+
+} // end namespace control
+#endif
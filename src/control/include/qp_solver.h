@@ -0,0 +1,65 @@
+#ifndef QP_SOLVER_H_
+#define QP_SOLVER_H_
+
+#include <vector>
+
+namespace control
+{
+struct QPSettings
+{
+  double rho;     // ADMM罚参数
+  double sigma;   // 保证KKT矩阵正定的正则项
+  double alpha;   // 松弛系数,取值(0,2)
+  int max_iter;   // 最大迭代次数
+  double eps_abs; // 绝对收敛阈值
+  double eps_rel; // 相对收敛阈值
+};
+
+// 小规模稠密凸二次规划ADMM求解器
+//   min 0.5*x'Px + q'x   s.t.  l <= Ax <= u
+// setup()时分解(P + sigma*I + rho*A'A), 之后只有q/l/u变化时直接复用分解;
+// 每次solve()以上一次的x/z/y及rho为初值(热启动), 控制周期间问题变化小, 迭代次数少
+class QPSolver
+{
+public:
+  QPSolver();
+
+  // P为n*n对称矩阵, A为m*n矩阵, 均按行存储
+  bool setup(int n, int m, const std::vector< double > &P, const std::vector< double > &A,
+             const QPSettings &settings);
+  // 更新P并重新分解, 保留热启动解
+  bool updateP(const std::vector< double > &P);
+  // 返回迭代次数, 未收敛时返回的解为最后一次迭代结果
+  int solve(const std::vector< double > &q, const std::vector< double > &l, const std::vector< double > &u);
+  // 丢弃热启动解
+  void reset();
+
+  const std::vector< double > &solution() const;
+  bool converged() const;
+  int size() const;
+
+private:
+  bool factor();
+  void cholSolve(std::vector< double > &b) const;
+  bool checkConvergence(const std::vector< double > &q, double &rho_scale) const;
+
+  int n_;
+  int m_;
+  QPSettings settings_;
+  std::vector< double > P_;
+  std::vector< double > A_;
+  std::vector< double > L_;       // KKT矩阵的Cholesky分解,下三角
+  std::vector< double > rho_vec_; // 每行约束的rho
+  std::vector< char > equality_;  // 上下界相等的行
+
+  std::vector< double > x_;
+  std::vector< double > z_;
+  std::vector< double > y_;
+  std::vector< double > rhs_;
+  std::vector< double > xt_;
+  std::vector< double > zt_;
+  bool converged_;
+};
+
+} // end namespace control
+#endif
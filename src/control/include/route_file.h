@@ -0,0 +1,94 @@
+#ifndef ROUTE_FILE_H_
+#define ROUTE_FILE_H_
+
+#include "control_utils.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace control
+{
+// 二进制路径文件格式
+// | RouteFileHeader (64字节) | RouteRecord * count (每条32字节) |
+// 所有字段为小端序, header_crc覆盖header_crc之前的字节, data_crc覆盖全部记录
+#define ROUTE_FILE_MAGIC 0x52564741 // "AGVR"
+#define ROUTE_FILE_VERSION 1
+
+// RouteFileHeader.path_flags
+#define ROUTE_PATH_RING 0x0001 //闭合路径
+
+// RouteRecord.flags
+#define ROUTE_POINT_REVERSE 0x0001 //与下一点航向相差90度以上的换向点
+
+#pragma pack(push, 1)
+struct RouteFileHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t header_size;
+  uint16_t record_size;
+  uint16_t reserved0;
+  uint32_t count;
+  uint32_t path_flags;
+  uint32_t data_crc;
+  double origin_lat; // gps2xy原点纬度
+  double origin_lon; // gps2xy原点经度
+  double length;     // 路径总里程,单位米
+  uint8_t reserved1[12];
+  uint32_t header_crc;
+};
+
+struct RouteRecord
+{
+  double x;
+  double y;
+  float heading;  // 单位度
+  float velocity; // 单位m/s
+  float dist;     // 里程,单位米
+  uint32_t flags;
+};
+#pragma pack(pop)
+
+// 只读映射的二进制路径文件, 析构时解除映射
+class RouteFileMapping
+{
+public:
+  RouteFileMapping();
+  ~RouteFileMapping();
+
+  bool open(const char *path);
+  void close();
+
+  const RouteFileHeader &header() const;
+  const RouteRecord *records() const;
+  size_t size() const;
+
+private:
+  RouteFileMapping(const RouteFileMapping &);
+  RouteFileMapping &operator=(const RouteFileMapping &);
+
+  void *addr_;
+  size_t length_;
+};
+
+uint32_t routeCrc32(const void *data, size_t len, uint32_t crc = 0);
+
+// 判断文件是否为二进制路径格式(仅检查magic)
+bool isBinaryRouteFile(const char *path);
+
+// 写二进制路径文件, 先写临时文件再rename, 避免中断时留下半个文件
+bool saveBinaryRoute(const char *path, const std::vector< positionConf > &route, uint32_t path_flags,
+                     double origin_lat, double origin_lon);
+
+// 读取旧的文本路径文件(每行15列)
+bool loadTextRoute(const char *path, std::vector< positionConf > &route);
+
+// 映射二进制路径文件并校验CRC后转换为positionConf
+bool loadBinaryRoute(const char *path, std::vector< positionConf > &route, uint32_t *path_flags = NULL);
+
+// 根据magic自动选择二进制或文本格式
+bool loadRouteFile(const char *path, std::vector< positionConf > &route);
+
+} // end namespace control
+#endif
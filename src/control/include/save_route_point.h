@@ -5,6 +5,7 @@
 #include <math.h>
 #include "control_utils.h"
 #include "control.h"
+#include "route_file.h"
 //#include "novatel_gps/NovatelPosition.h"
 #include "novatel_gps_msgs/Inspva.h"
 #include "novatel_gps_msgs/NovatelPosition.h"
@@ -61,6 +62,8 @@ namespace control
 	  double insgps_y;
 	  
 	  double equal_length;
+	  // 1代表保存为二进制路径文件,0代表旧的文本格式
+	  int route_binary;
 	  
 	  double L0;
 	  double lamda0;
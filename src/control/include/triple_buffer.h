@@ -0,0 +1,81 @@
+#ifndef TRIPLE_BUFFER_H_
+#define TRIPLE_BUFFER_H_
+
+#include <atomic>
+#include <stdint.h>
+
+namespace control
+{
+// 单生产者/单消费者的三缓冲区, 用于回调线程向控制线程无锁传递"最新值"
+// 写端: writeBuffer()填充后publish(), 或直接write(value)
+// 读端: update()返回是否有新数据, readBuffer()在下一次update()之前保持不变
+// 三个槽位循环使用, 槽内的vector容量可被复用, 稳态下不再分配内存
+template < typename T >
+class TripleBuffer
+{
+public:
+  TripleBuffer() : write_index_(0), middle_(1), read_index_(2)
+  {
+  }
+
+  T &writeBuffer()
+  {
+    return slots_[write_index_];
+  }
+
+  void publish()
+  {
+    uint8_t prev = middle_.exchange(write_index_ | DIRTY_BIT, std::memory_order_acq_rel);
+    write_index_ = prev & INDEX_MASK;
+  }
+
+  void write(const T &value)
+  {
+    slots_[write_index_] = value;
+    publish();
+  }
+
+  bool update()
+  {
+    if ((middle_.load(std::memory_order_relaxed) & DIRTY_BIT) == 0)
+    {
+      return false;
+    }
+    uint8_t prev = middle_.exchange(read_index_, std::memory_order_acq_rel);
+    read_index_  = prev & INDEX_MASK;
+    return true;
+  }
+
+  T &readBuffer()
+  {
+    return slots_[read_index_];
+  }
+
+  bool read(T &out)
+  {
+    if (!update())
+    {
+      return false;
+    }
+    out = slots_[read_index_];
+    return true;
+  }
+
+private:
+  enum
+  {
+    INDEX_MASK = 0x03,
+    DIRTY_BIT  = 0x04
+  };
+
+  TripleBuffer(const TripleBuffer &);
+  TripleBuffer &operator=(const TripleBuffer &);
+
+  T slots_[3];
+  uint8_t write_index_;
+  std::atomic< uint8_t > middle_;
+  uint8_t read_index_;
+};
+
+} // end namespace control
+#endif
@@ -107,42 +107,13 @@ namespace display
     //sprintf(route_data_path_name,"%s"DATA_PATH""DATA_NAME,home_path);
     printf("route data path name:%s\n",route_data_path_name);
 
-    FILE * route_data_read_fp = NULL;
-    route_data_read_fp = fopen(route_data_path_name,"r");
-    positionConf read_position = {0};
-    if(route_data_read_fp == NULL)
+    //二进制格式与旧的文本格式都由 loadRouteFile 读取
+    if(!control::loadRouteFile(route_data_path_name, route_data_))
     {
        printf("Open route_data.bin error!\n");
        exit(1);
     }
-    else
-    {
-       printf("route_data.bin is opened!\n");
-       while(!feof(route_data_read_fp))
-       {
-         fscanf(route_data_read_fp,"%u %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
-                                  &read_position.n_gps_sequence_num,
-                                  &read_position.x,
-                                  &read_position.y,
-                                  &read_position.z,
-                                  &read_position.lon,
-                                  &read_position.lat,
-                                  &read_position.height,
-                                  &read_position.velocity,
-                                  &read_position.velocity_x,
-                                  &read_position.velocity_y,
-                                  &read_position.velocity_z,
-                                  &read_position.heading,
-                                  &read_position.pitch,
-                                  &read_position.roll,
-                                  &read_position.dist
-                                  );
-         route_data_.push_back(read_position);
-       }
-
-       fclose(route_data_read_fp);
-       printf("read %lu row, route_date is ok!\n",route_data_.size());
-    }
+    printf("read %lu row, route_date is ok!\n",route_data_.size());
   }
 
   void STrajectory::main_loop()
@@ -0,0 +1,243 @@
+#include "control_executor.h"
+#include "control.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+using namespace std;
+using namespace control;
+
+namespace control
+{
+namespace
+{
+const int64_t NSEC_PER_SEC = 1000000000LL;
+
+int64_t toNsec(const struct timespec &ts)
+{
+  return (int64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+struct timespec fromNsec(int64_t ns)
+{
+  struct timespec ts;
+  ts.tv_sec  = ns / NSEC_PER_SEC;
+  ts.tv_nsec = ns % NSEC_PER_SEC;
+  return ts;
+}
+
+int64_t monotonicNow()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return toNsec(ts);
+}
+
+void updateMax(std::atomic< int64_t > &max_value, int64_t value)
+{
+  //只有控制线程写入,无需CAS
+  if (value > max_value.load(std::memory_order_relaxed))
+  {
+    max_value.store(value, std::memory_order_relaxed);
+  }
+}
+} // namespace
+
+ControlExecutor::ControlExecutor()
+    : thread_started_(false), running_(false), realtime_(false), cycles_(0), overruns_(0), jitter_sum_ns_(0),
+      jitter_max_ns_(0), exec_sum_ns_(0), exec_max_ns_(0)
+{
+  conf_.enable     = false;
+  conf_.frequency  = FRE;
+  conf_.priority   = 0;
+  conf_.cpu        = -1;
+  conf_.stats_rate = 1.0;
+}
+
+ControlExecutor::~ControlExecutor()
+{
+  stop();
+}
+
+void ControlExecutor::loadConf(ros::NodeHandle &nh)
+{
+  int enable = 0;
+  nh.param("/control/rt/enable", enable, 0);
+  nh.param("/control/rt/frequency", conf_.frequency, (int)FRE);
+  nh.param("/control/rt/priority", conf_.priority, 0);
+  nh.param("/control/rt/cpu", conf_.cpu, -1);
+  nh.param("/control/rt/stats_rate", conf_.stats_rate, 1.0);
+  conf_.enable = (enable == 1);
+  if (conf_.frequency <= 0)
+  {
+    conf_.frequency = FRE;
+  }
+  ROS_INFO("Control executor enable:%d frequency:%d priority:%d cpu:%d", enable, conf_.frequency, conf_.priority,
+           conf_.cpu);
+}
+
+bool ControlExecutor::enabled() const
+{
+  return conf_.enable;
+}
+
+bool ControlExecutor::start(const std::function< void() > &step)
+{
+  if (thread_started_)
+  {
+    return false;
+  }
+  step_ = step;
+  running_.store(true);
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  if (conf_.priority > 0)
+  {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+      ROS_WARN("mlockall failed: %s", strerror(errno));
+    }
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = conf_.priority;
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+  }
+
+  int ret = pthread_create(&thread_, &attr, &ControlExecutor::threadEntry, this);
+  if (ret == EPERM && conf_.priority > 0)
+  {
+    //没有实时调度权限时退化为普通线程
+    ROS_WARN("No permission for SCHED_FIFO priority %d, fall back to SCHED_OTHER.", conf_.priority);
+    pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+    ret = pthread_create(&thread_, &attr, &ControlExecutor::threadEntry, this);
+  }
+  else if (ret == 0 && conf_.priority > 0)
+  {
+    realtime_.store(true);
+  }
+  pthread_attr_destroy(&attr);
+
+  if (ret != 0)
+  {
+    ROS_ERROR("Create control thread failed: %s", strerror(ret));
+    running_.store(false);
+    return false;
+  }
+  thread_started_ = true;
+
+  if (conf_.cpu >= 0)
+  {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(conf_.cpu, &cpuset);
+    ret = pthread_setaffinity_np(thread_, sizeof(cpu_set_t), &cpuset);
+    if (ret != 0)
+    {
+      ROS_WARN("Set control thread affinity to cpu %d failed: %s", conf_.cpu, strerror(ret));
+    }
+  }
+  return true;
+}
+
+void ControlExecutor::stop()
+{
+  running_.store(false);
+  if (thread_started_)
+  {
+    pthread_join(thread_, NULL);
+    thread_started_ = false;
+  }
+}
+
+void *ControlExecutor::threadEntry(void *arg)
+{
+  static_cast< ControlExecutor * >(arg)->run();
+  return NULL;
+}
+
+void ControlExecutor::run()
+{
+  const int64_t period = NSEC_PER_SEC / conf_.frequency;
+  int64_t deadline     = monotonicNow();
+
+  while (running_.load(std::memory_order_relaxed) && ros::ok())
+  {
+    deadline += period;
+    struct timespec ts = fromNsec(deadline);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+    }
+
+    int64_t wake   = monotonicNow();
+    int64_t jitter = wake - deadline;
+    step_();
+    int64_t done = monotonicNow();
+    int64_t exec = done - wake;
+
+    cycles_.fetch_add(1, std::memory_order_relaxed);
+    jitter_sum_ns_.fetch_add(jitter, std::memory_order_relaxed);
+    exec_sum_ns_.fetch_add(exec, std::memory_order_relaxed);
+    updateMax(jitter_max_ns_, jitter);
+    updateMax(exec_max_ns_, exec);
+
+    //超过下一个截止时间,跳过已错过的周期,避免连续追赶
+    if (done > deadline + period)
+    {
+      overruns_.fetch_add(1, std::memory_order_relaxed);
+      deadline += ((done - deadline) / period) * period;
+    }
+  }
+}
+
+void ControlExecutor::fillStats(control_msgs::ControlLoopStats &msg) const
+{
+  uint64_t cycles = cycles_.load(std::memory_order_relaxed);
+  msg.header.stamp = ros::Time::now();
+  msg.cycles       = cycles;
+  msg.overruns     = overruns_.load(std::memory_order_relaxed);
+  msg.period_us    = 1000000 / conf_.frequency;
+  msg.realtime     = realtime_.load(std::memory_order_relaxed);
+  if (cycles > 0)
+  {
+    msg.jitter_mean_us = jitter_sum_ns_.load(std::memory_order_relaxed) / 1000.0 / cycles;
+    msg.exec_mean_us   = exec_sum_ns_.load(std::memory_order_relaxed) / 1000.0 / cycles;
+  }
+  msg.jitter_max_us = jitter_max_ns_.load(std::memory_order_relaxed) / 1000.0;
+  msg.exec_max_us   = exec_max_ns_.load(std::memory_order_relaxed) / 1000.0;
+}
+
+void ControlExecutor::statsTimerCallback(const ros::TimerEvent &event)
+{
+  control_msgs::ControlLoopStats msg;
+  fillStats(msg);
+  stats_pub_.publish(msg);
+}
+
+void ControlExecutor::spin(ros::NodeHandle &nh, const std::function< void() > &step)
+{
+  stats_pub_ = nh.advertise< control_msgs::ControlLoopStats >("/control/loop_stats", BUF_LEN);
+  if (conf_.stats_rate > 0)
+  {
+    stats_timer_ =
+        nh.createTimer(ros::Duration(1.0 / conf_.stats_rate), &ControlExecutor::statsTimerCallback, this);
+  }
+
+  if (!start(step))
+  {
+    ROS_ERROR("Control executor start failed!");
+    return;
+  }
+  ROS_INFO("Control thread started, callbacks run on the main thread.");
+  ros::spin();
+
+  stop();
+  stats_timer_.stop();
+}
+
+} // namespace control
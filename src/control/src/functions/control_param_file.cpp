@@ -0,0 +1,109 @@
+#include "control_param_file.h"
+
+#include <fstream>
+#include <stdlib.h>
+
+using namespace std;
+using namespace control;
+
+namespace control
+{
+namespace
+{
+string trim(const string &s)
+{
+  size_t b = s.find_first_not_of(" \t\r\n");
+  if (b == string::npos)
+  {
+    return "";
+  }
+  size_t e = s.find_last_not_of(" \t\r\n");
+  return s.substr(b, e - b + 1);
+}
+} // namespace
+
+ControlParamFile::ControlParamFile()
+{
+}
+
+bool ControlParamFile::load(const string &path)
+{
+  ifstream in(path.c_str());
+  if (!in.is_open())
+  {
+    return false;
+  }
+  string line;
+  while (getline(in, line))
+  {
+    size_t comment = line.find('#');
+    if (comment != string::npos)
+    {
+      line = line.substr(0, comment);
+    }
+    size_t colon = line.find(':');
+    if (colon == string::npos)
+    {
+      continue;
+    }
+    string key   = trim(line.substr(0, colon));
+    string value = trim(line.substr(colon + 1));
+    if (!key.empty() && !value.empty())
+    {
+      values_[key] = value;
+    }
+  }
+  return true;
+}
+
+void ControlParamFile::set(const string &key, const string &value)
+{
+  values_[key] = value;
+}
+
+bool ControlParamFile::getParam(const string &key, int &value) const
+{
+  map< string, string >::const_iterator it = values_.find(key);
+  if (it == values_.end())
+  {
+    return false;
+  }
+  char *end = NULL;
+  long v    = strtol(it->second.c_str(), &end, 10);
+  if (end == it->second.c_str() || *end != '\0')
+  {
+    return false;
+  }
+  value = (int)v;
+  return true;
+}
+
+bool ControlParamFile::getParam(const string &key, double &value) const
+{
+  map< string, string >::const_iterator it = values_.find(key);
+  if (it == values_.end())
+  {
+    return false;
+  }
+  char *end = NULL;
+  double v  = strtod(it->second.c_str(), &end);
+  if (end == it->second.c_str() || *end != '\0')
+  {
+    return false;
+  }
+  value = v;
+  return true;
+}
+
+bool ControlParamFile::getParam(const string &key, string &value) const
+{
+  map< string, string >::const_iterator it = values_.find(key);
+  if (it == values_.end())
+  {
+    return false;
+  }
+  value = it->second;
+  return true;
+}
+
+} // namespace control
@@ -16,6 +16,7 @@ DIAGControl::DIAGControl(ros::NodeHandle &nh) : nh_(nh)
   start_tip_ = 1;
   math_tip_  = 1;
   num_       = 0;
+  recv_position_valid_ = false;
 
   latteral_error           = 0.0;
   previous_control_angle_f = 0.0;
@@ -62,6 +63,7 @@ DIAGControl::DIAGControl(ros::NodeHandle &nh) : nh_(nh)
   nh.getParam("/control/L0", L0);
   nh.getParam("/control/lamda0", lamda0);
   nh.getParam("/control/hb", hb);
+  executor_.loadConf(nh);
   ROS_INFO("Paramaters loading finished.");
 
   //发
@@ -157,28 +159,14 @@ void DIAGControl::getRouteFromFile()
   printf("route date path name:%s\n", route_date_path_name);
 
   //读取地图 route_tip = 0 无图 route_tip = 1 有图
-  FILE *route_data_read_fp   = NULL;
-  route_data_read_fp         = fopen(route_date_path_name, "r");
-  positionConf read_position = {0};
-  if (route_data_read_fp == NULL)
+  //二进制格式直接mmap读取,旧的文本格式逐行解析
+  if (!loadRouteFile(route_date_path_name, route_data_))
   {
     ROS_INFO("Open route_data.bin error!");
     exit(1);
   }
   else
   {
-    ROS_INFO("route_date.bin is open!");
-    while (!feof(route_data_read_fp))
-    {
-      fscanf(route_data_read_fp, "%u %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
-             &read_position.n_gps_sequence_num, &read_position.x, &read_position.y, &read_position.z,
-             &read_position.lon, &read_position.lat, &read_position.height, &read_position.velocity,
-             &read_position.velocity_x, &read_position.velocity_y, &read_position.velocity_z, &read_position.heading,
-             &read_position.pitch, &read_position.roll, &read_position.dist);
-      route_data_.push_back(read_position);
-    }
-
-    fclose(route_data_read_fp);
     printf("read %lu row, route_date is ok!\n", route_data_.size());
     // ROS_INFO("route_data_[1]lon:%.8lf, lat:%.8lf",route_data_[1].lon,route_data_[1].lat);
 
@@ -189,7 +177,33 @@ void DIAGControl::getRouteFromFile()
 void DIAGControl::dgControl()
 {
   ROS_INFO("into-2");
+
+  if (executor_.enabled())
+  {
+    //控制在独立线程中按绝对截止时间运行,本线程只处理回调
+    executor_.spin(nh_, std::bind(&DIAGControl::dgControlStep, this));
+    return;
+  }
+
   ros::Rate loop_rate(FRE);
+  while (ros::ok())
+  {
+    dgControlStep();
+    ros::spinOnce();
+    loop_rate.sleep();
+  }
+}
+
+void DIAGControl::updateFromCallbacks()
+{
+  if (position_buf_.read(real_position_))
+  {
+    start_tip_ = 2;
+  }
+}
+
+void DIAGControl::dgControlStep()
+{
   int ss = route_data_.size();
 
   //临时变量
@@ -201,269 +215,264 @@ void DIAGControl::dgControl()
   positionConf vnxy_pos_temp_fc         = {0}; //距车辆前轴中心最近点的xyz车辆坐标系位姿
   positionConf vpxy_pos_temp            = {0}; //预瞄点的xyz车辆坐标系位姿
 
-  while (ros::ok())
+  updateFromCallbacks();
+
+  if (start_tip_ == 2 && math_tip_ == 2)
   {
 
-    if (start_tip_ == 2 && math_tip_ == 2)
+    real_pos_temp.lon                = real_position_.lon;
+    real_pos_temp.lat                = real_position_.lat;
+    real_pos_temp.height             = real_position_.height;
+    real_pos_temp.heading            = real_position_.heading;
+    real_pos_temp.pitch              = real_position_.pitch;
+    real_pos_temp.roll               = real_position_.roll;
+    real_pos_temp.velocity_x         = real_position_.velocity_x;
+    real_pos_temp.velocity_y         = real_position_.velocity_y;
+    real_pos_temp.velocity_z         = real_position_.velocity_z;
+    real_pos_temp.gps_seconds        = real_position_.gps_seconds;
+    real_pos_temp.n_gps_sequence_num = real_position_.n_gps_sequence_num;
+    real_pos_temp.velocity           = real_position_.velocity;
+
+    // ROS_INFO("debug1");
+
+    //经纬度转换成局部坐标
+    if (mode == 0)
     {
+      prescanxy2xy(xy_pos_temp, real_pos_temp);
+      // ROS_INFO("debug2");
+    }
+    else
+    {
+      gps2xy(xy_pos_temp, real_pos_temp);
+    }
 
-      real_pos_temp.lon                = real_position_.lon;
-      real_pos_temp.lat                = real_position_.lat;
-      real_pos_temp.height             = real_position_.height;
-      real_pos_temp.heading            = real_position_.heading;
-      real_pos_temp.pitch              = real_position_.pitch;
-      real_pos_temp.roll               = real_position_.roll;
-      real_pos_temp.velocity_x         = real_position_.velocity_x;
-      real_pos_temp.velocity_y         = real_position_.velocity_y;
-      real_pos_temp.velocity_z         = real_position_.velocity_z;
-      real_pos_temp.gps_seconds        = real_position_.gps_seconds;
-      real_pos_temp.n_gps_sequence_num = real_position_.n_gps_sequence_num;
-      real_pos_temp.velocity           = real_position_.velocity;
-
-      // ROS_INFO("debug1");
-
-      //经纬度转换成局部坐标
-      if (mode == 0)
-      {
-        prescanxy2xy(xy_pos_temp, real_pos_temp);
-        // ROS_INFO("debug2");
-      }
-      else
-      {
-        gps2xy(xy_pos_temp, real_pos_temp);
-      }
-
-      //组合导航坐标转成车辆中心坐标
-      insgps2center(xy_pos_temp);
-      xy_pos_temp_front_center = xy_pos_temp;
-      // ROS_INFO("debug3");
-
-      //车辆中心坐标转成车辆前轴中心坐标
-      center2frontaxis_tf(xy_pos_temp_front_center);
-      // ROS_INFO("debug4");
+    //组合导航坐标转成车辆中心坐标
+    insgps2center(xy_pos_temp);
+    xy_pos_temp_front_center = xy_pos_temp;
+    // ROS_INFO("debug3");
+
+    //车辆中心坐标转成车辆前轴中心坐标
+    center2frontaxis_tf(xy_pos_temp_front_center);
+    // ROS_INFO("debug4");
+
+    //最小索引 规划路径上的距离车辆中心的最接近点/距离车辆前轴中心的最接近点
+    int min_index_theory              = findClosestRefPoint(xy_pos_temp);
+    int min_index_theory_front_center = findClosestRefPoint(xy_pos_temp_front_center);
+    // ROS_INFO("min_index_theory_front_center:%d",min_index_theory_front_center);
+    // ROS_INFO("debug5");
+
+    //考虑系统延迟推算真正的最近点以及计算曲率半径的点
+    int min_index;
+    int min_index_front_center;
+    if (pathtype == 0)
+    {
+      min_index              = findRealMinIndex_ringpath(min_index_theory, xy_pos_temp);
+      min_index_front_center = findRealMinIndex_ringpath(min_index_theory_front_center, xy_pos_temp_front_center);
+      findPoints2ComputeRadius_ringpath(min_index, indexr1, indexf1, indexf2, indexf3);
+    }
+    else
+    {
+      min_index              = findRealMinIndex(min_index_theory, xy_pos_temp);
+      min_index_front_center = findRealMinIndex(min_index_theory_front_center, xy_pos_temp_front_center);
+      findPoints2ComputeRadius(min_index, indexr1, indexf1, indexf2, indexf3);
+    }
 
-      //最小索引 规划路径上的距离车辆中心的最接近点/距离车辆前轴中心的最接近点
-      int min_index_theory              = findClosestRefPoint(xy_pos_temp);
-      int min_index_theory_front_center = findClosestRefPoint(xy_pos_temp_front_center);
-      // ROS_INFO("min_index_theory_front_center:%d",min_index_theory_front_center);
-      // ROS_INFO("debug5");
+    //两个最近点以及计算曲率半径的点
+    positionConf &nearst_pos_temp    = route_data_[min_index];
+    positionConf &nearst_pos_temp_fc = route_data_[min_index_front_center];
+    positionConf &ir1                = route_data_[indexr1];
+    positionConf &ir2                = route_data_[indexr2];
+    positionConf &ir3                = route_data_[indexr3];
+    positionConf &if1                = route_data_[indexf1];
+    positionConf &if2                = route_data_[indexf2];
+    positionConf &if3                = route_data_[indexf3];
+
+    //计算曲率半径
+    double R1    = getR(nearst_pos_temp, ir1, if1);
+    double R4    = getR(nearst_pos_temp, if1, if2);
+    double R5    = getR(if1, if2, if3);
+    double R_tmp = getMinR(R1, R4, R5);
+    ROS_INFO("Rtmp is: %f  R1 is: %f  R4 is: %f  R5 is: %f", R_tmp, R1, R4, R5);
+
+    //计算前后轮转向比
+    double sigma = ComputeSigma(R_tmp);
+    // ROS_INFO("debug8");
+
+    //计算预瞄点
+    if (pathtype == 0)
+    {
+      findPrePoint_ringpath(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
+    }
+    else
+    {
+      findPrePoint(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
+      // ROS_INFO("debug9");
+    }
 
-      //考虑系统延迟推算真正的最近点以及计算曲率半径的点
-      int min_index;
-      int min_index_front_center;
-      if (pathtype == 0)
-      {
-        min_index              = findRealMinIndex_ringpath(min_index_theory, xy_pos_temp);
-        min_index_front_center = findRealMinIndex_ringpath(min_index_theory_front_center, xy_pos_temp_front_center);
-        findPoints2ComputeRadius_ringpath(min_index, indexr1, indexf1, indexf2, indexf3);
-      }
-      else
-      {
-        min_index              = findRealMinIndex(min_index_theory, xy_pos_temp);
-        min_index_front_center = findRealMinIndex(min_index_theory_front_center, xy_pos_temp_front_center);
-        findPoints2ComputeRadius(min_index, indexr1, indexf1, indexf2, indexf3);
-      }
+    //将两个最近点和预瞄点的坐标转换到车辆坐标系下
+    xy2vxy(vnxy_pos_temp, nearst_pos_temp, xy_pos_temp);
+    // ROS_INFO("debug9-1");
+    xy2vxy(vnxy_pos_temp_fc, nearst_pos_temp_fc, xy_pos_temp_front_center);
+    // ROS_INFO("debug9-2");
+    xy2vxy(vpxy_pos_temp, pre_pos_temp, xy_pos_temp);
+    // ROS_INFO("debug10");
+
+    //横向控制模型计算横向误差
+    latteral_error = StanleyPreviewLatteralModel(xy_pos_temp, vnxy_pos_temp, vnxy_pos_temp_fc, vpxy_pos_temp);
+    // ROS_INFO("debug11");
+
+    double control_angle_f = 0;
+    double control_angle_r = 0;
+    control_angle_f        = turn_ratio * pid_control_angle.control(latteral_error, 0.01);
+    control_angle_r        = control_angle_f;
+
+    //横摆角速度限制
+    time_now = ros::Time::now().toSec();
+    yawrate_constrain(time_now, time_previous, control_angle_f, previous_control_angle_f);
+    yawrate_constrain(time_now, time_previous, control_angle_r, previous_control_angle_r);
+
+    previous_control_angle_f = control_angle_f;
+    previous_control_angle_r = control_angle_r;
+    time_previous            = time_now;
+    //最大转角限制
+    angle_constrain(control_angle_f);
+    angle_constrain(control_angle_r);
+    // ROS_INFO("debug12");
+
+    // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
+    // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
+
+    //发布控制命令，包括转向角，期望速度，期望加速度，车辆速度
+    if (mode == 0)
+    {
+      geometry_msgs::PoseStamped prescan_control_command;
+      prescan_control_command.pose.position.x = control_angle_f;
+      prescan_control_command.pose.position.y = control_angle_r;
 
-      //两个最近点以及计算曲率半径的点
-      positionConf &nearst_pos_temp    = route_data_[min_index];
-      positionConf &nearst_pos_temp_fc = route_data_[min_index_front_center];
-      positionConf &ir1                = route_data_[indexr1];
-      positionConf &ir2                = route_data_[indexr2];
-      positionConf &ir3                = route_data_[indexr3];
-      positionConf &if1                = route_data_[indexf1];
-      positionConf &if2                = route_data_[indexf2];
-      positionConf &if3                = route_data_[indexf3];
-
-      //计算曲率半径
-      double R1    = getR(nearst_pos_temp, ir1, if1);
-      double R4    = getR(nearst_pos_temp, if1, if2);
-      double R5    = getR(if1, if2, if3);
-      double R_tmp = getMinR(R1, R4, R5);
-      ROS_INFO("Rtmp is: %f  R1 is: %f  R4 is: %f  R5 is: %f", R_tmp, R1, R4, R5);
-
-      //计算前后轮转向比
-      double sigma = ComputeSigma(R_tmp);
-      // ROS_INFO("debug8");
-
-      //计算预瞄点
       if (pathtype == 0)
       {
-        findPrePoint_ringpath(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
+        prescan_control_command.pose.position.z = computespeed(R_tmp, straight_speed);
+        // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
+        // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
       }
       else
       {
-        findPrePoint(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
-        // ROS_INFO("debug9");
-      }
-
-      //将两个最近点和预瞄点的坐标转换到车辆坐标系下
-      xy2vxy(vnxy_pos_temp, nearst_pos_temp, xy_pos_temp);
-      // ROS_INFO("debug9-1");
-      xy2vxy(vnxy_pos_temp_fc, nearst_pos_temp_fc, xy_pos_temp_front_center);
-      // ROS_INFO("debug9-2");
-      xy2vxy(vpxy_pos_temp, pre_pos_temp, xy_pos_temp);
-      // ROS_INFO("debug10");
-
-      //横向控制模型计算横向误差
-      latteral_error = StanleyPreviewLatteralModel(xy_pos_temp, vnxy_pos_temp, vnxy_pos_temp_fc, vpxy_pos_temp);
-      // ROS_INFO("debug11");
-
-      double control_angle_f = 0;
-      double control_angle_r = 0;
-      control_angle_f        = turn_ratio * pid_control_angle.control(latteral_error, 0.01);
-      control_angle_r        = control_angle_f;
-
-      //横摆角速度限制
-      time_now = ros::Time::now().toSec();
-      yawrate_constrain(time_now, time_previous, control_angle_f, previous_control_angle_f);
-      yawrate_constrain(time_now, time_previous, control_angle_r, previous_control_angle_r);
-
-      previous_control_angle_f = control_angle_f;
-      previous_control_angle_r = control_angle_r;
-      time_previous            = time_now;
-      //最大转角限制
-      angle_constrain(control_angle_f);
-      angle_constrain(control_angle_r);
-      // ROS_INFO("debug12");
-
-      // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
-      // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
-
-      //发布控制命令，包括转向角，期望速度，期望加速度，车辆速度
-      if (mode == 0)
-      {
-        geometry_msgs::PoseStamped prescan_control_command;
-        prescan_control_command.pose.position.x = control_angle_f;
-        prescan_control_command.pose.position.y = control_angle_r;
-
-        if (pathtype == 0)
+        if ((ss - min_index) * equal_length <= start2stop_dist)
         {
-          prescan_control_command.pose.position.z = computespeed(R_tmp, straight_speed);
-          // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
-          // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
+          prescan_control_command.pose.position.z = sqrt((route_data_[ss - 1].x - route_data_[min_index].x) *
+                                                             (route_data_[ss - 1].x - route_data_[min_index].x) +
+                                                         (route_data_[ss - 1].y - route_data_[min_index].y) *
+                                                             (route_data_[ss - 1].y - route_data_[min_index].y)) *
+                                                    (speed_limit / start2stop_dist);
+          prescan_control_command.pose.position.x = 0;
+          prescan_control_command.pose.position.y = 0;
+          // ROS_INFO("In the stop mode----expected speed:%f min_index:%d
+          // min_index_front_center:%d",prescan_control_command.pose.position.z,min_index,min_index_front_center);
         }
         else
         {
-          if ((ss - min_index) * equal_length <= start2stop_dist)
-          {
-            prescan_control_command.pose.position.z = sqrt((route_data_[ss - 1].x - route_data_[min_index].x) *
-                                                               (route_data_[ss - 1].x - route_data_[min_index].x) +
-                                                           (route_data_[ss - 1].y - route_data_[min_index].y) *
-                                                               (route_data_[ss - 1].y - route_data_[min_index].y)) *
-                                                      (speed_limit / start2stop_dist);
-            prescan_control_command.pose.position.x = 0;
-            prescan_control_command.pose.position.y = 0;
-            // ROS_INFO("In the stop mode----expected speed:%f min_index:%d
-            // min_index_front_center:%d",prescan_control_command.pose.position.z,min_index,min_index_front_center);
-          }
-          else
-          {
-            prescan_control_command.pose.position.z = computespeed(R_tmp, straight_speed);
-            // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
-            // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
-          }
+          prescan_control_command.pose.position.z = computespeed(R_tmp, straight_speed);
+          // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
+          // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
         }
+      }
 
-        // speed limitation
-        if (prescan_control_command.pose.position.z > speed_limit)
-        {
-          prescan_control_command.pose.position.z = speed_limit;
-        }
+      // speed limitation
+      if (prescan_control_command.pose.position.z > speed_limit)
+      {
+        prescan_control_command.pose.position.z = speed_limit;
+      }
+
+      prescan_control_command.pose.orientation.x = xy_pos_temp.x;
+      prescan_control_command.pose.orientation.y = xy_pos_temp.y;
+      prescan_control_command.pose.orientation.z = vnxy_pos_temp.x;
+      prescan_control_command.pose.orientation.w = min_index;
+      control_vcu_pub_.publish(prescan_control_command);
+    }
+    else
+    {
+      control_msgs::ADControlAGV control_msg;
+      control_msg.VehAgl_F = control_angle_f;
+      control_msg.VehAgl_R = control_angle_r;
 
-        prescan_control_command.pose.orientation.x = xy_pos_temp.x;
-        prescan_control_command.pose.orientation.y = xy_pos_temp.y;
-        prescan_control_command.pose.orientation.z = vnxy_pos_temp.x;
-        prescan_control_command.pose.orientation.w = min_index;
-        control_vcu_pub_.publish(prescan_control_command);
+      if (pathtype == 0)
+      {
+        control_msg.Vel_Req = nearst_pos_temp.velocity;
+        // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
+        // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
       }
       else
       {
-        control_msgs::ADControlAGV control_msg;
-        control_msg.VehAgl_F = control_angle_f;
-        control_msg.VehAgl_R = control_angle_r;
-
-        if (pathtype == 0)
+        if ((ss - min_index) * equal_length <= start2stop_dist)
         {
-          control_msg.Vel_Req = nearst_pos_temp.velocity;
-          // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
-          // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
+          control_msg.Vel_Req = sqrt((route_data_[ss - 1].x - route_data_[min_index].x) *
+                                         (route_data_[ss - 1].x - route_data_[min_index].x) +
+                                     (route_data_[ss - 1].y - route_data_[min_index].y) *
+                                         (route_data_[ss - 1].y - route_data_[min_index].y)) *
+                                (speed_limit / start2stop_dist);
+          control_msg.VehAgl_F = 0;
+          control_msg.VehAgl_R = 0;
+          // ROS_INFO("In the stop mode----expected speed:%f min_index:%d
+          // min_index_front_center:%d",control_msg.ExpSpeed,min_index,min_index_front_center);
         }
         else
         {
-          if ((ss - min_index) * equal_length <= start2stop_dist)
-          {
-            control_msg.Vel_Req = sqrt((route_data_[ss - 1].x - route_data_[min_index].x) *
-                                           (route_data_[ss - 1].x - route_data_[min_index].x) +
-                                       (route_data_[ss - 1].y - route_data_[min_index].y) *
-                                           (route_data_[ss - 1].y - route_data_[min_index].y)) *
-                                  (speed_limit / start2stop_dist);
-            control_msg.VehAgl_F = 0;
-            control_msg.VehAgl_R = 0;
-            // ROS_INFO("In the stop mode----expected speed:%f min_index:%d
-            // min_index_front_center:%d",control_msg.ExpSpeed,min_index,min_index_front_center);
-          }
-          else
-          {
-            control_msg.Vel_Req = nearst_pos_temp.velocity;
-            // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
-            // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
-          }
+          control_msg.Vel_Req = nearst_pos_temp.velocity;
+          // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
+          // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
         }
-
-        // control_msg.ACCexp = 0;
-        //control_msg.vehicle_x   = xy_pos_temp.x;
-        //control_msg.vehicle_y   = xy_pos_temp.y;
-        //control_msg.vehicle_err = vnxy_pos_temp.x;
-        //control_msg.min_index   = min_index;
-        control_vcu_pub_.publish(control_msg);
       }
 
-      //发布车辆实际运动路径
+      // control_msg.ACCexp = 0;
+      //control_msg.vehicle_x   = xy_pos_temp.x;
+      //control_msg.vehicle_y   = xy_pos_temp.y;
+      //control_msg.vehicle_err = vnxy_pos_temp.x;
+      //control_msg.min_index   = min_index;
+      control_vcu_pub_.publish(control_msg);
+    }
 
-      this_pose_stamped.pose.position.x = xy_pos_temp.x;
-      this_pose_stamped.pose.position.y = xy_pos_temp.y;
-      this_pose_stamped.header.stamp    = ros::Time::now();
-      this_pose_stamped.header.frame_id = "odom";
+    //发布车辆实际运动路径
 
-      path.header.frame_id = "odom";
-      path.poses.push_back(this_pose_stamped);
-      // path.header.stamp = ros::Time::now();
-      if (num_ >= 10)
-      {
-        veh_path_pub_.publish(path);
-        num_ = 0;
-      }
+    this_pose_stamped.pose.position.x = xy_pos_temp.x;
+    this_pose_stamped.pose.position.y = xy_pos_temp.y;
+    this_pose_stamped.header.stamp    = ros::Time::now();
+    this_pose_stamped.header.frame_id = "odom";
 
-      //发布车辆前轴中心点，最近点和预瞄点 用于rviz显示
-      geometry_msgs::PointStamped psmsg_veh;
-      psmsg_veh.header.stamp    = ros::Time::now();
-      psmsg_veh.header.frame_id = "odom";
-      psmsg_veh.point.x         = xy_pos_temp.x;
-      psmsg_veh.point.y         = xy_pos_temp.y;
-      psmsg_veh.point.z         = 0;
-      veh_point_pub_.publish(psmsg_veh);
-
-      geometry_msgs::PointStamped psmsg;
-      psmsg.header.stamp    = ros::Time::now();
-      psmsg.header.frame_id = "odom";
-      psmsg.point.x         = route_data_[min_index].x;
-      psmsg.point.y         = route_data_[min_index].y;
-      psmsg.point.z         = 0;
-      ref_point_pub_.publish(psmsg);
-
-      geometry_msgs::PointStamped psmsg_gps;
-      psmsg_gps.header.stamp    = ros::Time::now();
-      psmsg_gps.header.frame_id = "odom";
-      psmsg_gps.point.x         = pre_pos_temp.x;
-      psmsg_gps.point.y         = pre_pos_temp.y;
-      psmsg_gps.point.z         = 0;
-      pre_point_pub_.publish(psmsg_gps);
-
-      start_tip_ = 1;
+    path.header.frame_id = "odom";
+    path.poses.push_back(this_pose_stamped);
+    // path.header.stamp = ros::Time::now();
+    if (num_ >= 10)
+    {
+      veh_path_pub_.publish(path);
+      num_ = 0;
     }
 
-    ros::spinOnce();
-    loop_rate.sleep();
+    //发布车辆前轴中心点，最近点和预瞄点 用于rviz显示
+    geometry_msgs::PointStamped psmsg_veh;
+    psmsg_veh.header.stamp    = ros::Time::now();
+    psmsg_veh.header.frame_id = "odom";
+    psmsg_veh.point.x         = xy_pos_temp.x;
+    psmsg_veh.point.y         = xy_pos_temp.y;
+    psmsg_veh.point.z         = 0;
+    veh_point_pub_.publish(psmsg_veh);
+
+    geometry_msgs::PointStamped psmsg;
+    psmsg.header.stamp    = ros::Time::now();
+    psmsg.header.frame_id = "odom";
+    psmsg.point.x         = route_data_[min_index].x;
+    psmsg.point.y         = route_data_[min_index].y;
+    psmsg.point.z         = 0;
+    ref_point_pub_.publish(psmsg);
+
+    geometry_msgs::PointStamped psmsg_gps;
+    psmsg_gps.header.stamp    = ros::Time::now();
+    psmsg_gps.header.frame_id = "odom";
+    psmsg_gps.point.x         = pre_pos_temp.x;
+    psmsg_gps.point.y         = pre_pos_temp.y;
+    psmsg_gps.point.z         = 0;
+    pre_point_pub_.publish(psmsg_gps);
+
+    start_tip_ = 1;
   }
 }
 
@@ -1140,59 +1149,71 @@ int DIAGControl::findClosestRefPoint(const positionConf &rpt)
 
 void DIAGControl::recvVehDataCallback(const control_msgs::com2veh::ConstPtr &msg)
 {
-  real_position_.velocity = msg->VelSpeed / 3.6;
+  recv_position_.velocity = msg->VelSpeed / 3.6;
+  //只有速度/航向时不发布, 避免控制线程用未收到的位置计算
+  if (recv_position_valid_)
+  {
+    position_buf_.write(recv_position_);
+  }
 }
 
 void DIAGControl::recvbestposCallback(const novatel_gps_msgs::NovatelPositionConstPtr &msg)
 {
-  real_position_.n_gps_sequence_num = msg->novatel_msg_header.sequence_num;
-  real_position_.lon                = msg->lon;    //经
-  real_position_.lat                = msg->lat;    //纬
-  real_position_.height             = msg->height; //高
+  recv_position_.n_gps_sequence_num = msg->novatel_msg_header.sequence_num;
+  recv_position_.lon                = msg->lon;    //经
+  recv_position_.lat                = msg->lat;    //纬
+  recv_position_.height             = msg->height; //高
 
-  real_position_.gps_seconds = msg->novatel_msg_header.gps_seconds; // gps秒时间
+  recv_position_.gps_seconds = msg->novatel_msg_header.gps_seconds; // gps秒时间
 
+  recv_position_valid_ = true;
   num_++;
 
   // ROS_INFO("receive %d %u %.8lf
-  // %.8lf",num_,msg->novatel_msg_header.sequence_num,real_position_.lon,real_position_.lat);
-  start_tip_ = 2;
+  // %.8lf",num_,msg->novatel_msg_header.sequence_num,recv_position_.lon,recv_position_.lat);
+  position_buf_.write(recv_position_);
 }
 
 void DIAGControl::recvInspvaCallback(const novatel_gps_msgs::InspvaConstPtr &msg)
 {
-  real_position_.velocity_x = msg->north_velocity;
-  real_position_.velocity_y = msg->east_velocity;
-  real_position_.velocity_z = msg->up_velocity;
-  // real_position_.velocity = sqrt(msg->north_velocity*msg->north_velocity + msg->east_velocity*msg->east_velocity +
+  recv_position_.velocity_x = msg->north_velocity;
+  recv_position_.velocity_y = msg->east_velocity;
+  recv_position_.velocity_z = msg->up_velocity;
+  // recv_position_.velocity = sqrt(msg->north_velocity*msg->north_velocity + msg->east_velocity*msg->east_velocity +
   // msg->up_velocity*msg->up_velocity);
 
-  real_position_.heading = msg->azimuth;
-  real_position_.pitch   = msg->pitch;
-  real_position_.heading = msg->azimuth;
+  recv_position_.heading = msg->azimuth;
+  recv_position_.pitch   = msg->pitch;
+  recv_position_.heading = msg->azimuth;
+  //只有速度/航向时不发布, 避免控制线程用未收到的位置计算
+  if (recv_position_valid_)
+  {
+    position_buf_.write(recv_position_);
+  }
 }
 
 void DIAGControl::recvHuacePosCallback(const location_sensor_msgs::IMUAndGNSSInfo &msg)
 {
-  real_position_.velocity_x = msg.velocity.x;
-  real_position_.velocity_y = msg.velocity.y;
-  real_position_.velocity_z = msg.velocity.z;
-  real_position_.velocity =
+  recv_position_.velocity_x = msg.velocity.x;
+  recv_position_.velocity_y = msg.velocity.y;
+  recv_position_.velocity_z = msg.velocity.z;
+  recv_position_.velocity =
       sqrt(msg.velocity.x * msg.velocity.x + msg.velocity.y * msg.velocity.y + msg.velocity.z * msg.velocity.z);
 
-  real_position_.heading = msg.yaw;
-  real_position_.pitch   = msg.pitch;
-  real_position_.roll    = msg.roll;
+  recv_position_.heading = msg.yaw;
+  recv_position_.pitch   = msg.pitch;
+  recv_position_.roll    = msg.roll;
 
-  real_position_.lon    = msg.pose.y;
-  real_position_.lat    = msg.pose.x;
-  real_position_.height = msg.pose.z;
+  recv_position_.lon    = msg.pose.y;
+  recv_position_.lat    = msg.pose.x;
+  recv_position_.height = msg.pose.z;
 
-  real_position_.gps_seconds        = msg.GPS_sec;
-  real_position_.n_gps_sequence_num = msg.GPS_week;
+  recv_position_.gps_seconds        = msg.GPS_sec;
+  recv_position_.n_gps_sequence_num = msg.GPS_week;
 
+  recv_position_valid_ = true;
   num_++;
-  start_tip_ = 2;
+  position_buf_.write(recv_position_);
 }
 
 void DIAGControl::recvFusionPosCallback(const location_msgs::FusionDataInfo &msg)
@@ -1206,24 +1227,25 @@ void DIAGControl::recvPrescanPositionCallback(const visualization_msgs::MarkerCo
 
 void DIAGControl::recvPrescanRealtimePosCallback(const geometry_msgs::PoseStamped &msg)
 {
-  real_position_.velocity_x = 0;
-  real_position_.velocity_y = 0;
-  real_position_.velocity_z = 0;
-  real_position_.velocity   = msg.pose.orientation.x;
+  recv_position_.velocity_x = 0;
+  recv_position_.velocity_y = 0;
+  recv_position_.velocity_z = 0;
+  recv_position_.velocity   = msg.pose.orientation.x;
 
-  real_position_.heading = msg.pose.orientation.y;
-  real_position_.pitch   = 0;
-  real_position_.roll    = 0;
+  recv_position_.heading = msg.pose.orientation.y;
+  recv_position_.pitch   = 0;
+  recv_position_.roll    = 0;
 
-  real_position_.lon    = msg.pose.position.x;
-  real_position_.lat    = msg.pose.position.y;
-  real_position_.height = msg.pose.position.z;
+  recv_position_.lon    = msg.pose.position.x;
+  recv_position_.lat    = msg.pose.position.y;
+  recv_position_.height = msg.pose.position.z;
 
-  real_position_.gps_seconds        = 0;
-  real_position_.n_gps_sequence_num = 0;
+  recv_position_.gps_seconds        = 0;
+  recv_position_.n_gps_sequence_num = 0;
 
+  recv_position_valid_ = true;
   num_++;
-  start_tip_ = 2;
+  position_buf_.write(recv_position_);
 }
 
 void DIAGControl::recvRouteCallback(const visualization_msgs::MarkerConstPtr &msg)
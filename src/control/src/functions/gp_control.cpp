@@ -69,6 +69,7 @@ GPControl::GPControl(ros::NodeHandle &nh) : nh_(nh)
   nh.getParam("/control/L0", L0);
   nh.getParam("/control/lamda0", lamda0);
   nh.getParam("/control/hb", hb);
+  executor_.loadConf(nh);
   ROS_INFO("Paramaters loading finished.");
 
   //发
@@ -131,8 +132,39 @@ void GPControl::setSpeedPID()
 void GPControl::gpControl()
 {
   ROS_INFO("into-2");
+
+  if (executor_.enabled())
+  {
+    //控制在独立线程中按绝对截止时间运行,本线程只处理回调
+    executor_.spin(nh_, std::bind(&GPControl::gpControlStep, this));
+    return;
+  }
+
   ros::Rate loop_rate(FRE);
+  while (ros::ok())
+  {
+    gpControlStep();
+    ros::spinOnce();
+    loop_rate.sleep();
+  }
+}
 
+void GPControl::updateFromCallbacks()
+{
+  if (position_buf_.read(real_position_))
+  {
+    start_tip_ = 2;
+  }
+  if (path_buf_.update())
+  {
+    route_data_.swap(path_buf_.readBuffer());
+    ss        = route_data_.size();
+    math_tip_ = 2;
+  }
+}
+
+void GPControl::gpControlStep()
+{
   //临时变量
   positionConf real_pos_temp            = {0}; //组合导航传来的组合导航经纬度位姿
   positionConf pre_pos_temp             = {0}; //预瞄点的XYZ位姿
@@ -142,232 +174,227 @@ void GPControl::gpControl()
   positionConf vnxy_pos_temp_fc         = {0}; //距车辆前轴中心最近点的xyz车辆坐标系位姿
   positionConf vpxy_pos_temp            = {0}; //预瞄点的xyz车辆坐标系位姿
 
-  while (ros::ok())
+  updateFromCallbacks();
+
+  if (start_tip_ == 2 && math_tip_ == 2)
   {
 
-    if (start_tip_ == 2 && math_tip_ == 2 && size_tmp > 0 && read_path_flag == 2)
+    real_pos_temp.lon                = real_position_.lon;
+    real_pos_temp.lat                = real_position_.lat;
+    real_pos_temp.height             = real_position_.height;
+    real_pos_temp.heading            = real_position_.heading;
+    real_pos_temp.pitch              = real_position_.pitch;
+    real_pos_temp.roll               = real_position_.roll;
+    real_pos_temp.velocity_x         = real_position_.velocity_x;
+    real_pos_temp.velocity_y         = real_position_.velocity_y;
+    real_pos_temp.velocity_z         = real_position_.velocity_z;
+    real_pos_temp.gps_seconds        = real_position_.gps_seconds;
+    real_pos_temp.n_gps_sequence_num = real_position_.n_gps_sequence_num;
+    real_pos_temp.velocity           = real_position_.velocity;
+
+    // ROS_INFO("debug1");
+
+    //经纬度转换成局部坐标
+    if (mode == 0)
+    {
+      prescanxy2xy(xy_pos_temp, real_pos_temp);
+      // ROS_INFO("debug2");
+    }
+    else
     {
+      gps2xy(xy_pos_temp, real_pos_temp);
+    }
 
-      real_pos_temp.lon                = real_position_.lon;
-      real_pos_temp.lat                = real_position_.lat;
-      real_pos_temp.height             = real_position_.height;
-      real_pos_temp.heading            = real_position_.heading;
-      real_pos_temp.pitch              = real_position_.pitch;
-      real_pos_temp.roll               = real_position_.roll;
-      real_pos_temp.velocity_x         = real_position_.velocity_x;
-      real_pos_temp.velocity_y         = real_position_.velocity_y;
-      real_pos_temp.velocity_z         = real_position_.velocity_z;
-      real_pos_temp.gps_seconds        = real_position_.gps_seconds;
-      real_pos_temp.n_gps_sequence_num = real_position_.n_gps_sequence_num;
-      real_pos_temp.velocity           = real_position_.velocity;
-
-      // ROS_INFO("debug1");
-
-      //经纬度转换成局部坐标
-      if (mode == 0)
+    //组合导航坐标转成车辆中心坐标
+    insgps2center(xy_pos_temp);
+    xy_pos_temp_front_center = xy_pos_temp;
+    // ROS_INFO("debug3");
+
+    //车辆中心坐标转成车辆前轴中心坐标
+    center2frontaxis_tf(xy_pos_temp_front_center);
+    // ROS_INFO("debug4");
+
+    //最小索引 规划路径上的距离车辆中心的最接近点/距离车辆前轴中心的最接近点
+    int min_index_theory              = findClosestRefPoint(xy_pos_temp);
+    int min_index_theory_front_center = findClosestRefPoint(xy_pos_temp_front_center);
+    // ROS_INFO("min_index_theory_front_center:%d",min_index_theory_front_center);
+    // ROS_INFO("debug5");
+
+    //考虑系统延迟推算真正的最近点以及计算曲率半径的点
+    int min_index;
+    int min_index_front_center;
+
+    min_index              = findRealMinIndex(min_index_theory, xy_pos_temp);
+    min_index_front_center = findRealMinIndex(min_index_theory_front_center, xy_pos_temp_front_center);
+    findPoints2ComputeRadius(min_index, indexr1, indexf1, indexf2, indexf3);
+
+    //两个最近点以及计算曲率半径的点
+    positionConf &nearst_pos_temp    = route_data_[min_index];
+    positionConf &nearst_pos_temp_fc = route_data_[min_index_front_center];
+    positionConf &ir1                = route_data_[indexr1];
+    positionConf &ir2                = route_data_[indexr2];
+    positionConf &ir3                = route_data_[indexr3];
+    positionConf &if1                = route_data_[indexf1];
+    positionConf &if2                = route_data_[indexf2];
+    positionConf &if3                = route_data_[indexf3];
+
+    //计算曲率半径
+    double R1    = getR(nearst_pos_temp, ir1, if1);
+    double R4    = getR(nearst_pos_temp, if1, if2);
+    double R5    = getR(if1, if2, if3);
+    double R_tmp = getMinR(R1, R4, R5);
+    // ROS_INFO("debug7");
+
+    //计算前后轮转向比
+    double sigma = ComputeSigma(R_tmp);
+    // ROS_INFO("debug8");
+
+    //计算预瞄点
+    findPrePoint(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
+    // ROS_INFO("debug9");
+
+    //将两个最近点和预瞄点的坐标转换到车辆坐标系下
+    xy2vxy(vnxy_pos_temp, nearst_pos_temp, xy_pos_temp);
+    // ROS_INFO("debug9-1");
+    xy2vxy(vnxy_pos_temp_fc, nearst_pos_temp_fc, xy_pos_temp_front_center);
+    // ROS_INFO("debug9-2");
+    xy2vxy(vpxy_pos_temp, pre_pos_temp, xy_pos_temp);
+    // ROS_INFO("debug10");
+
+    //横向控制模型计算横向误差
+    latteral_error = StanleyPreviewLatteralModel(xy_pos_temp, vnxy_pos_temp, vnxy_pos_temp_fc, vpxy_pos_temp);
+    // ROS_INFO("debug11");
+
+    double control_angle_f = 0;
+    double control_angle_r = 0;
+    control_angle_f        = turn_ratio * pid_control_angle.control(latteral_error, 0.01);
+    control_angle_r        = -sigma * control_angle_f;
+
+    //横摆角速度限制
+    time_now = ros::Time::now().toSec();
+    yawrate_constrain(time_now, time_previous, control_angle_f, previous_control_angle_f);
+    yawrate_constrain(time_now, time_previous, control_angle_r, previous_control_angle_r);
+
+    previous_control_angle_f = control_angle_f;
+    previous_control_angle_r = control_angle_r;
+    time_previous            = time_now;
+    //最大转角限制
+    angle_constrain(control_angle_f);
+    angle_constrain(control_angle_r);
+    // ROS_INFO("debug12");
+
+    ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f e:%f", control_angle_f,
+             min_index, min_index_front_center, R_tmp, sigma, vnxy_pos_temp.x);
+
+    //发布控制命令，包括转向角，期望速度，期望加速度，车辆速度
+    if (mode == 0)
+    {
+      geometry_msgs::PoseStamped prescan_control_command;
+      if((ss - 1)<=min_index)
       {
-        prescanxy2xy(xy_pos_temp, real_pos_temp);
-        // ROS_INFO("debug2");
+         prescan_control_command.pose.orientation.x = 0;
+         prescan_control_command.pose.orientation.z = 0;
       }
       else
       {
-        gps2xy(xy_pos_temp, real_pos_temp);
+         prescan_control_command.pose.orientation.x = control_angle_f;
+         prescan_control_command.pose.orientation.z = control_angle_r;
       }
-
-      //组合导航坐标转成车辆中心坐标
-      insgps2center(xy_pos_temp);
-      xy_pos_temp_front_center = xy_pos_temp;
-      // ROS_INFO("debug3");
-
-      //车辆中心坐标转成车辆前轴中心坐标
-      center2frontaxis_tf(xy_pos_temp_front_center);
-      // ROS_INFO("debug4");
-
-      //最小索引 规划路径上的距离车辆中心的最接近点/距离车辆前轴中心的最接近点
-      int min_index_theory              = findClosestRefPoint(xy_pos_temp);
-      int min_index_theory_front_center = findClosestRefPoint(xy_pos_temp_front_center);
-      // ROS_INFO("min_index_theory_front_center:%d",min_index_theory_front_center);
-      // ROS_INFO("debug5");
-
-      //考虑系统延迟推算真正的最近点以及计算曲率半径的点
-      int min_index;
-      int min_index_front_center;
-
-      min_index              = findRealMinIndex(min_index_theory, xy_pos_temp);
-      min_index_front_center = findRealMinIndex(min_index_theory_front_center, xy_pos_temp_front_center);
-      findPoints2ComputeRadius(min_index, indexr1, indexf1, indexf2, indexf3);
-
-      //两个最近点以及计算曲率半径的点
-      positionConf &nearst_pos_temp    = route_data_[min_index];
-      positionConf &nearst_pos_temp_fc = route_data_[min_index_front_center];
-      positionConf &ir1                = route_data_[indexr1];
-      positionConf &ir2                = route_data_[indexr2];
-      positionConf &ir3                = route_data_[indexr3];
-      positionConf &if1                = route_data_[indexf1];
-      positionConf &if2                = route_data_[indexf2];
-      positionConf &if3                = route_data_[indexf3];
-
-      //计算曲率半径
-      double R1    = getR(nearst_pos_temp, ir1, if1);
-      double R4    = getR(nearst_pos_temp, if1, if2);
-      double R5    = getR(if1, if2, if3);
-      double R_tmp = getMinR(R1, R4, R5);
-      // ROS_INFO("debug7");
-
-      //计算前后轮转向比
-      double sigma = ComputeSigma(R_tmp);
-      // ROS_INFO("debug8");
-
-      //计算预瞄点
-      findPrePoint(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
-      // ROS_INFO("debug9");
-
-      //将两个最近点和预瞄点的坐标转换到车辆坐标系下
-      xy2vxy(vnxy_pos_temp, nearst_pos_temp, xy_pos_temp);
-      // ROS_INFO("debug9-1");
-      xy2vxy(vnxy_pos_temp_fc, nearst_pos_temp_fc, xy_pos_temp_front_center);
-      // ROS_INFO("debug9-2");
-      xy2vxy(vpxy_pos_temp, pre_pos_temp, xy_pos_temp);
-      // ROS_INFO("debug10");
-
-      //横向控制模型计算横向误差
-      latteral_error = StanleyPreviewLatteralModel(xy_pos_temp, vnxy_pos_temp, vnxy_pos_temp_fc, vpxy_pos_temp);
-      // ROS_INFO("debug11");
-
-      double control_angle_f = 0;
-      double control_angle_r = 0;
-      control_angle_f        = turn_ratio * pid_control_angle.control(latteral_error, 0.01);
-      control_angle_r        = -sigma * control_angle_f;
-
-      //横摆角速度限制
-      time_now = ros::Time::now().toSec();
-      yawrate_constrain(time_now, time_previous, control_angle_f, previous_control_angle_f);
-      yawrate_constrain(time_now, time_previous, control_angle_r, previous_control_angle_r);
-
-      previous_control_angle_f = control_angle_f;
-      previous_control_angle_r = control_angle_r;
-      time_previous            = time_now;
-      //最大转角限制
-      angle_constrain(control_angle_f);
-      angle_constrain(control_angle_r);
-      // ROS_INFO("debug12");
-
-      ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f e:%f", control_angle_f,
-               min_index, min_index_front_center, R_tmp, sigma, vnxy_pos_temp.x);
-
-      //发布控制命令，包括转向角，期望速度，期望加速度，车辆速度
-      if (mode == 0)
+      
+      if((ss - min_index)*equal_length <= start2stop_dist)
       {
-        geometry_msgs::PoseStamped prescan_control_command;
-        if((ss - 1)<=min_index)
-        {
-           prescan_control_command.pose.orientation.x = 0;
-           prescan_control_command.pose.orientation.z = 0;
-        }
-        else
-        {
-           prescan_control_command.pose.orientation.x = control_angle_f;
-           prescan_control_command.pose.orientation.z = control_angle_r;
-        }
-        
-        if((ss - min_index)*equal_length <= start2stop_dist)
-        {
-           prescan_control_command.pose.position.x = sqrt((route_data_[ss - 1].x - route_data_[min_index].x) *
-                                                               (route_data_[ss - 1].x - route_data_[min_index].x) +
-                                                           (route_data_[ss - 1].y - route_data_[min_index].y) *
-                                                               (route_data_[ss - 1].y - route_data_[min_index].y)) *
-                                                      (speed_limit / start2stop_dist);
-        }
-        else
-        {
-           prescan_control_command.pose.position.x = computespeed(R_tmp, straight_speed);
-        }
-
-        if(prescan_control_command.pose.position.x > speed_limit)
-        {
-          prescan_control_command.pose.position.x = speed_limit;
-        }
-        // prescan_control_command.pose.orientation.x =xy_pos_temp.x;
-        // prescan_control_command.pose.orientation.y =xy_pos_temp.y;
-        // prescan_control_command.pose.orientation.z =vnxy_pos_temp.x;
-        // prescan_control_command.pose.orientation.w = min_index;
-        control_vcu_pub_.publish(prescan_control_command);
+         prescan_control_command.pose.position.x = sqrt((route_data_[ss - 1].x - route_data_[min_index].x) *
+                                                             (route_data_[ss - 1].x - route_data_[min_index].x) +
+                                                         (route_data_[ss - 1].y - route_data_[min_index].y) *
+                                                             (route_data_[ss - 1].y - route_data_[min_index].y)) *
+                                                    (speed_limit / start2stop_dist);
       }
       else
       {
-        control_msgs::ADControlAGV control_msg;
-        control_msg.VehAgl_F = control_angle_f;
-        control_msg.VehAgl_R = control_angle_r;
-
-        if (plan_flag == 0)
-        {
-          control_msg.Vel_Req  = 0;
-          control_msg.VehAgl_F = 0;
-          control_msg.VehAgl_R = 0;
-          // ROS_INFO("In the stop mode----expected speed:%f min_index:%d
-          // min_index_front_center:%d",control_msg.ExpSpeed,min_index,min_index_front_center);
-        }
-        else
-        {
-          control_msg.Vel_Req = nearst_pos_temp.velocity;
-          // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
-          // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
-        }
-
-        // control_msg.ACCexp = 0;
-        // control_msg.vehicle_x =xy_pos_temp.x;
-        // control_msg.vehicle_y =xy_pos_temp.y;
-        // control_msg.vehicle_err =vnxy_pos_temp.x;
-        // control_msg.min_index = min_index;
-        control_vcu_pub_.publish(control_msg);
+         prescan_control_command.pose.position.x = computespeed(R_tmp, straight_speed);
       }
 
-      //发布车辆实际运动路径
-      
-      this_pose_stamped.pose.position.x = xy_pos_temp.x;
-      this_pose_stamped.pose.position.y = xy_pos_temp.y;
-      this_pose_stamped.header.stamp = ros::Time::now();
-      this_pose_stamped.header.frame_id = "odom";
-
-      //path.header.stamp = ros::Time::now();
-      path.header.frame_id = "odom";
-      path.poses.push_back(this_pose_stamped);
-      if(num_ >= 10)
+      if(prescan_control_command.pose.position.x > speed_limit)
       {
-        veh_path_pub_.publish(path);
-        num_ = 0;
+        prescan_control_command.pose.position.x = speed_limit;
       }
+      // prescan_control_command.pose.orientation.x =xy_pos_temp.x;
+      // prescan_control_command.pose.orientation.y =xy_pos_temp.y;
+      // prescan_control_command.pose.orientation.z =vnxy_pos_temp.x;
+      // prescan_control_command.pose.orientation.w = min_index;
+      control_vcu_pub_.publish(prescan_control_command);
+    }
+    else
+    {
+      control_msgs::ADControlAGV control_msg;
+      control_msg.VehAgl_F = control_angle_f;
+      control_msg.VehAgl_R = control_angle_r;
 
-      //发布车辆前轴中心点，最近点和预瞄点 用于rviz显示
-      geometry_msgs::PointStamped psmsg_veh;
-      psmsg_veh.header.stamp    = ros::Time::now();
-      psmsg_veh.header.frame_id = "odom";
-      psmsg_veh.point.x         = xy_pos_temp.x;
-      psmsg_veh.point.y         = xy_pos_temp.y;
-      psmsg_veh.point.z         = 0;
-      veh_point_pub_.publish(psmsg_veh);
-
-      geometry_msgs::PointStamped psmsg;
-      psmsg.header.stamp    = ros::Time::now();
-      psmsg.header.frame_id = "odom";
-      psmsg.point.x         = route_data_[min_index].x;
-      psmsg.point.y         = route_data_[min_index].y;
-      psmsg.point.z         = 0;
-      ref_point_pub_.publish(psmsg);
-
-      geometry_msgs::PointStamped psmsg_gps;
-      psmsg_gps.header.stamp    = ros::Time::now();
-      psmsg_gps.header.frame_id = "odom";
-      psmsg_gps.point.x         = pre_pos_temp.x;
-      psmsg_gps.point.y         = pre_pos_temp.y;
-      psmsg_gps.point.z         = 0;
-      pre_point_pub_.publish(psmsg_gps);
-
-      start_tip_ = 1;
+      if (plan_flag == 0)
+      {
+        control_msg.Vel_Req  = 0;
+        control_msg.VehAgl_F = 0;
+        control_msg.VehAgl_R = 0;
+        // ROS_INFO("In the stop mode----expected speed:%f min_index:%d
+        // min_index_front_center:%d",control_msg.ExpSpeed,min_index,min_index_front_center);
+      }
+      else
+      {
+        control_msg.Vel_Req = nearst_pos_temp.velocity;
+        // ROS_INFO("control_angle_f:%f min_index:%d min_index_front_center:%d R:%f sigma:%f
+        // e:%f",control_angle_f,min_index,min_index_front_center,R_tmp,sigma,vnxy_pos_temp.x);
+      }
+
+      // control_msg.ACCexp = 0;
+      // control_msg.vehicle_x =xy_pos_temp.x;
+      // control_msg.vehicle_y =xy_pos_temp.y;
+      // control_msg.vehicle_err =vnxy_pos_temp.x;
+      // control_msg.min_index = min_index;
+      control_vcu_pub_.publish(control_msg);
     }
 
-    ros::spinOnce();
-    loop_rate.sleep();
+    //发布车辆实际运动路径
+    
+    this_pose_stamped.pose.position.x = xy_pos_temp.x;
+    this_pose_stamped.pose.position.y = xy_pos_temp.y;
+    this_pose_stamped.header.stamp = ros::Time::now();
+    this_pose_stamped.header.frame_id = "odom";
+
+    //path.header.stamp = ros::Time::now();
+    path.header.frame_id = "odom";
+    path.poses.push_back(this_pose_stamped);
+    if(num_ >= 10)
+    {
+      veh_path_pub_.publish(path);
+      num_ = 0;
+    }
+
+    //发布车辆前轴中心点，最近点和预瞄点 用于rviz显示
+    geometry_msgs::PointStamped psmsg_veh;
+    psmsg_veh.header.stamp    = ros::Time::now();
+    psmsg_veh.header.frame_id = "odom";
+    psmsg_veh.point.x         = xy_pos_temp.x;
+    psmsg_veh.point.y         = xy_pos_temp.y;
+    psmsg_veh.point.z         = 0;
+    veh_point_pub_.publish(psmsg_veh);
+
+    geometry_msgs::PointStamped psmsg;
+    psmsg.header.stamp    = ros::Time::now();
+    psmsg.header.frame_id = "odom";
+    psmsg.point.x         = route_data_[min_index].x;
+    psmsg.point.y         = route_data_[min_index].y;
+    psmsg.point.z         = 0;
+    ref_point_pub_.publish(psmsg);
+
+    geometry_msgs::PointStamped psmsg_gps;
+    psmsg_gps.header.stamp    = ros::Time::now();
+    psmsg_gps.header.frame_id = "odom";
+    psmsg_gps.point.x         = pre_pos_temp.x;
+    psmsg_gps.point.y         = pre_pos_temp.y;
+    psmsg_gps.point.z         = 0;
+    pre_point_pub_.publish(psmsg_gps);
+
+    start_tip_ = 1;
   }
 }
 
@@ -1043,24 +1070,24 @@ int GPControl::findClosestRefPoint(const positionConf &rpt)
 
 void GPControl::recvHuacePosCallback(const location_sensor_msgs::IMUAndGNSSInfo &msg)
 {
-  real_position_.velocity_x = msg.velocity.x;
-  real_position_.velocity_y = msg.velocity.y;
-  real_position_.velocity_z = msg.velocity.z;
-  real_position_.velocity =
+  recv_position_.velocity_x = msg.velocity.x;
+  recv_position_.velocity_y = msg.velocity.y;
+  recv_position_.velocity_z = msg.velocity.z;
+  recv_position_.velocity =
       sqrt(msg.velocity.x * msg.velocity.x + msg.velocity.y * msg.velocity.y + msg.velocity.z * msg.velocity.z);
 
-  real_position_.heading = msg.yaw;
-  real_position_.pitch   = msg.pitch;
-  real_position_.roll    = msg.roll;
+  recv_position_.heading = msg.yaw;
+  recv_position_.pitch   = msg.pitch;
+  recv_position_.roll    = msg.roll;
 
-  real_position_.lon    = msg.pose.y;
-  real_position_.lat    = msg.pose.x;
-  real_position_.height = msg.pose.z;
+  recv_position_.lon    = msg.pose.y;
+  recv_position_.lat    = msg.pose.x;
+  recv_position_.height = msg.pose.z;
 
-  real_position_.gps_seconds        = msg.GPS_sec;
-  real_position_.n_gps_sequence_num = msg.GPS_week;
+  recv_position_.gps_seconds        = msg.GPS_sec;
+  recv_position_.n_gps_sequence_num = msg.GPS_week;
 
-  start_tip_ = 2;
+  position_buf_.write(recv_position_);
 }
 
 double GPControl::sumSquares3D(const double &in_x, const double &in_y, const double &in_z)
@@ -1070,45 +1097,45 @@ double GPControl::sumSquares3D(const double &in_x, const double &in_y, const dou
 
 void GPControl::recvFusionPosCallback(const location_msgs::FusionDataInfo &msg)
 {
-  real_position_.velocity_x = msg.velocity.linear.x;
-  real_position_.velocity_y = msg.velocity.linear.y;
-  real_position_.velocity_z = msg.velocity.linear.z;
-  real_position_.velocity =
-      sqrt(sumSquares3D(real_position_.velocity_x, real_position_.velocity_y, real_position_.velocity_z));
+  recv_position_.velocity_x = msg.velocity.linear.x;
+  recv_position_.velocity_y = msg.velocity.linear.y;
+  recv_position_.velocity_z = msg.velocity.linear.z;
+  recv_position_.velocity =
+      sqrt(sumSquares3D(recv_position_.velocity_x, recv_position_.velocity_y, recv_position_.velocity_z));
 
-  real_position_.heading = msg.yaw;
-  real_position_.pitch   = msg.pitch;
-  real_position_.roll    = msg.roll;
+  recv_position_.heading = msg.yaw;
+  recv_position_.pitch   = msg.pitch;
+  recv_position_.roll    = msg.roll;
 
-  real_position_.lon    = msg.pose.x;
-  real_position_.lat    = msg.pose.y;
-  real_position_.height = msg.pose.z;
+  recv_position_.lon    = msg.pose.x;
+  recv_position_.lat    = msg.pose.y;
+  recv_position_.height = msg.pose.z;
 
-  real_position_.gps_seconds        = msg.sec;
-  real_position_.n_gps_sequence_num = msg.day;
+  recv_position_.gps_seconds        = msg.sec;
+  recv_position_.n_gps_sequence_num = msg.day;
 
-  start_tip_ = 2;
+  position_buf_.write(recv_position_);
 }
 
 void GPControl::recvPrescanRealtimePosCallback(const nav_msgs::Odometry &msg)
 {
-  real_position_.velocity_x = 0;
-  real_position_.velocity_y = 0;
-  real_position_.velocity_z = 0;
-  real_position_.velocity   = msg.twist.twist.linear.x;
+  recv_position_.velocity_x = 0;
+  recv_position_.velocity_y = 0;
+  recv_position_.velocity_z = 0;
+  recv_position_.velocity   = msg.twist.twist.linear.x;
 
-  real_position_.heading = msg.twist.twist.angular.x;
-  real_position_.pitch   = 0;
-  real_position_.roll    = 0;
+  recv_position_.heading = msg.twist.twist.angular.x;
+  recv_position_.pitch   = 0;
+  recv_position_.roll    = 0;
 
-  real_position_.lon    = msg.pose.pose.position.x;
-  real_position_.lat    = msg.pose.pose.position.y;
-  real_position_.height = msg.pose.pose.position.z;
+  recv_position_.lon    = msg.pose.pose.position.x;
+  recv_position_.lat    = msg.pose.pose.position.y;
+  recv_position_.height = msg.pose.pose.position.z;
 
-  real_position_.gps_seconds        = 0;
-  real_position_.n_gps_sequence_num = 0;
+  recv_position_.gps_seconds        = 0;
+  recv_position_.n_gps_sequence_num = 0;
 
-  start_tip_ = 2;
+  position_buf_.write(recv_position_);
   num_++;
 }
 
@@ -1130,7 +1157,9 @@ void GPControl::recvGlobalPathCallback(const map_msgs::REFPointArray &msg)
   {
 	positionConf read_position = {0};
 	global_route_data_.clear();
-	route_data_.clear();
+	//在写缓冲区中插值,容量在三个缓冲区之间复用
+	vector< positionConf > &route_data = path_buf_.writeBuffer();
+	route_data.clear();
 
 	for (int i = 0; i < msg.REF_line_INFO.size(); i++)
 	{
@@ -1147,7 +1176,7 @@ void GPControl::recvGlobalPathCallback(const map_msgs::REFPointArray &msg)
 	int s = global_route_data_.size();
 	for (int i = 0; i < (s - 1); i++)
 	{
-		route_data_.push_back(global_route_data_[i]);
+		route_data.push_back(global_route_data_[i]);
                 
 		double l = sqrt((global_route_data_[i].x - global_route_data_[i + 1].x) *
 				(global_route_data_[i].x - global_route_data_[i + 1].x) +
@@ -1165,16 +1194,15 @@ void GPControl::recvGlobalPathCallback(const map_msgs::REFPointArray &msg)
 			read_position.heading  = global_route_data_[i].heading + j * dheading;
 			//read_position.velocity = global_route_data_[i].velocity + j * dvelocity;
 
-			route_data_.push_back(read_position);
+			route_data.push_back(read_position);
 		}
                 
 	}
-	route_data_.push_back(global_route_data_[s - 1]);
+	route_data.push_back(global_route_data_[s - 1]);
 
-        ss = route_data_.size();
         previous_endx = msg.REF_line_INFO[size_tmp-1].rx;
         previous_endy = msg.REF_line_INFO[size_tmp-1].ry;
-	math_tip_ = 2;
+	path_buf_.publish();
         read_path_flag = 2;
   }
 }
@@ -1,6 +1,8 @@
 #include "lf_control.h"
 #include "control.h"
 
+#include <string.h>
+
 using namespace std;
 using namespace control;
 
@@ -12,6 +14,72 @@ LFControl::LFControl(ros::NodeHandle &nh) : nh_(nh)
   ROS_INFO("into");
 
   ROS_INFO("Start initialization...");
+  initVariables();
+
+  // get paramaters from yaml
+  ROS_INFO("Start to load paramaters...");
+  loadParams(nh);
+  executor_.loadConf(nh);
+  ROS_INFO("Paramaters loading finished.");
+
+  //发
+  ref_point_pub_ = nh.advertise< geometry_msgs::PointStamped >("/control/ref_point_msg", BUF_LEN, true);
+  pre_point_pub_ = nh.advertise< geometry_msgs::PointStamped >("/control/pre_point_msg", BUF_LEN, true);
+  veh_point_pub_ = nh.advertise< geometry_msgs::PointStamped >("/control/veh_point_msg", BUF_LEN, true);
+  veh_path_pub_  = nh.advertise< nav_msgs::Path >("/control/veh_path", BUF_LEN, true);
+  conditioned_path_pub_ = nh.advertise< nav_msgs::Path >("/control/conditioned_path", BUF_LEN, true);
+
+  if (mode == 0)
+  {
+    control_vcu_pub_ = nh.advertise< geometry_msgs::PoseStamped >("/control/control_agv", BUF_LEN, true);
+  }
+  else
+  {
+    control_vcu_pub_ = nh.advertise< control_msgs::ADControlAGV >("/control/control_agv", BUF_LEN, true);
+  }
+
+  //收
+  // bestpos_sub_ = nh.subscribe("bestpos",10, &RTKControl::recvbestposCallback,this);
+  // Inspva_sub_ = nh.subscribe("inspva",10, &RTKControl::recvInspvaCallback,this);
+  // velocity_sub_ = nh.subscribe("com2vehmsg",10,&RTKControl::recvVehDataCallback,this);
+
+  if(mode == 0)
+  {
+    pos_sub_ = nh.subscribe("/prescan/location_xyz", 10, &LFControl::recvPrescanRealtimePosCallback, this);
+  }
+  else
+  {
+    pos_sub_ = nh.subscribe("/localization/fusion_msg", 10, &LFControl::recvFusionPosCallback, this);
+  }
+
+  if(refline_stop == 1)
+  {
+    refline_stop_msg_sub_ = nh.subscribe("/map/stop_msg",10, &LFControl::recvReflineStopCallback,this);
+    local_path_sub_ = nh.subscribe("/map/decision_info", 10, &LFControl::recvLocalPathCallback, this);
+  }
+  else
+  {
+    local_path_sub_ = nh.subscribe("/plan/decision_info", 10, &LFControl::recvLocalPathCallback, this);
+  }
+
+  setAnglePID();
+  setSpeedPID();
+  ROS_INFO("Initialization finished.");
+
+  LFControl::lfControl();
+}
+
+LFControl::LFControl(const ControlParamFile &params)
+{
+  //离线仿真: 不注册话题, 不进入主循环, 由调用者喂数据并调用lfControlStep()
+  initVariables();
+  loadParams(params);
+  setAnglePID();
+  setSpeedPID();
+}
+
+void LFControl::initVariables()
+{
   // temp variables initialization
   start_tip_ = 1;
   math_tip_  = 1;
@@ -35,8 +103,20 @@ LFControl::LFControl(ros::NodeHandle &nh) : nh_(nh)
   section_decide_num = 0;
   previous_section_decide_num = 0;
 
-  // get paramaters from yaml
-  ROS_INFO("Start to load paramaters...");
+  forward_backward_flag = 1;
+  refline_stop          = 0;
+  control_angle_f       = 0.0;
+  control_angle_r       = 0.0;
+  memset(&last_command_, 0, sizeof(last_command_));
+
+  path_conf_.outlier_angle = 120;
+  path_conf_.smooth_window = 0;
+  publish_conditioned_path = 1;
+}
+
+template < typename ParamSource >
+void LFControl::loadParams(const ParamSource &nh)
+{
   nh.getParam("/control/mode", mode);
   nh.getParam("/control/pathtype", pathtype);
   nh.getParam("/control/lateral/kp", lateral_kp);
@@ -68,58 +148,26 @@ LFControl::LFControl(ros::NodeHandle &nh) : nh_(nh)
   nh.getParam("/control/lamda0", lamda0);
   nh.getParam("/control/hb", hb);
   nh.getParam("/control/refline_stop", refline_stop);
-  ROS_INFO("Paramaters loading finished.");
-
-  //发
-  ref_point_pub_ = nh.advertise< geometry_msgs::PointStamped >("/control/ref_point_msg", BUF_LEN, true);
-  pre_point_pub_ = nh.advertise< geometry_msgs::PointStamped >("/control/pre_point_msg", BUF_LEN, true);
-  veh_point_pub_ = nh.advertise< geometry_msgs::PointStamped >("/control/veh_point_msg", BUF_LEN, true);
-  veh_path_pub_  = nh.advertise< nav_msgs::Path >("/control/veh_path", BUF_LEN, true);
-
-  if (mode == 0)
-  {
-    control_vcu_pub_ = nh.advertise< geometry_msgs::PoseStamped >("/control/control_agv", BUF_LEN, true);
-  }
-  else
-  {
-    control_vcu_pub_ = nh.advertise< control_msgs::ADControlAGV >("/control/control_agv", BUF_LEN, true);
-  }
-
-  //收
-  // bestpos_sub_ = nh.subscribe("bestpos",10, &RTKControl::recvbestposCallback,this);
-  // Inspva_sub_ = nh.subscribe("inspva",10, &RTKControl::recvInspvaCallback,this);
-  // velocity_sub_ = nh.subscribe("com2vehmsg",10,&RTKControl::recvVehDataCallback,this);
-
-  if(mode == 0)
-  {
-    pos_sub_ = nh.subscribe("/prescan/location_xyz", 10, &LFControl::recvPrescanRealtimePosCallback, this);
-  }
-  else
-  {
-    pos_sub_ = nh.subscribe("/localization/fusion_msg", 10, &LFControl::recvFusionPosCallback, this);
-  }
+  nh.getParam("/control/path/outlier_angle", path_conf_.outlier_angle);
+  nh.getParam("/control/path/smooth_window", path_conf_.smooth_window);
+  nh.getParam("/control/path/publish", publish_conditioned_path);
 
-  if(refline_stop == 1)
-  {
-    refline_stop_msg_sub_ = nh.subscribe("/map/stop_msg",10, &LFControl::recvReflineStopCallback,this);
-    local_path_sub_ = nh.subscribe("/map/decision_info", 10, &LFControl::recvLocalPathCallback, this);
-  }
-  else
-  {
-    local_path_sub_ = nh.subscribe("/plan/decision_info", 10, &LFControl::recvLocalPathCallback, this);
-  }
-
-  setAnglePID();
-  setSpeedPID();
-  ROS_INFO("Initialization finished.");
-
-  LFControl::lfControl();
+  path_conf_.equal_length = equal_length;
+  path_conf_.tp_speed     = tp_speed;
+  path_conditioner_.setConf(path_conf_);
 }
+template void LFControl::loadParams(const ros::NodeHandle &nh);
+template void LFControl::loadParams(const ControlParamFile &nh);
 
 LFControl::~LFControl()
 {
 }
 
+const ControlCommand &LFControl::lastCommand() const
+{
+  return last_command_;
+}
+
 void LFControl::setAnglePID()
 {
   pid_conf_angle.kp  = lateral_kp; // 0.35;
@@ -141,8 +189,46 @@ void LFControl::setSpeedPID()
 void LFControl::lfControl()
 {
   ROS_INFO("into-2");
+
+  if (executor_.enabled())
+  {
+    //控制在独立线程中按绝对截止时间运行,本线程只处理回调
+    executor_.spin(nh_, std::bind(&LFControl::lfControlStep, this));
+    return;
+  }
+
   ros::Rate loop_rate(FRE);
+  while (ros::ok())
+  {
+    lfControlStep();
+    ros::spinOnce();
+    loop_rate.sleep();
+  }
+}
+
+void LFControl::updateFromCallbacks()
+{
+  if (position_buf_.read(real_position_))
+  {
+    start_tip_ = 2;
+  }
+  if (path_buf_.update())
+  {
+    LocalPathConf &local_path = path_buf_.readBuffer();
+    route_data_.swap(local_path.route);
+    strange_points.swap(local_path.cusps);
+    math_tip_ = local_path.math_tip;
+    if (math_tip_ == 2)
+    {
+      plan_flag = local_path.plan_flag;
+      path_mode = local_path.path_mode;
+    }
+  }
+  refline_stop_buf_.read(refline_stop_msg);
+}
 
+void LFControl::lfControlStep()
+{
   //临时变量
   positionConf real_pos_temp            = {0}; //组合导航传来的组合导航经纬度位姿
   positionConf pre_pos_temp             = {0}; //预瞄点的XYZ位姿
@@ -153,142 +239,140 @@ void LFControl::lfControl()
   positionConf vnxy_pos_temp_fc         = {0}; //距车辆前轴中心最近点的xyz车辆坐标系位姿
   positionConf vpxy_pos_temp            = {0}; //预瞄点的xyz车辆坐标系位姿
 
-  while (ros::ok())
+  updateFromCallbacks();
+
+  if (start_tip_ == 2 && math_tip_ == 2 && path_mode == 1)
   {
 
-    if (start_tip_ == 2 && math_tip_ == 2 && path_mode == 1)
+    real_pos_temp.lon                = real_position_.lon;
+    real_pos_temp.lat                = real_position_.lat;
+    real_pos_temp.height             = real_position_.height;
+    real_pos_temp.heading            = real_position_.heading;
+    real_pos_temp.pitch              = real_position_.pitch;
+    real_pos_temp.roll               = real_position_.roll;
+    real_pos_temp.velocity_x         = real_position_.velocity_x;
+    real_pos_temp.velocity_y         = real_position_.velocity_y;
+    real_pos_temp.velocity_z         = real_position_.velocity_z;
+    real_pos_temp.gps_seconds        = real_position_.gps_seconds;
+    real_pos_temp.n_gps_sequence_num = real_position_.n_gps_sequence_num;
+    real_pos_temp.velocity           = real_position_.velocity;
+
+    //经纬度转换成局部坐标
+    if (mode == 0)
     {
+      prescanxy2xy(xy_pos_temp, real_pos_temp);
+    }
+    else
+    {
+      prescanxy2xy(xy_pos_temp, real_pos_temp);
+      //gps2xy(xy_pos_temp, real_pos_temp);
+    }
 
-      real_pos_temp.lon                = real_position_.lon;
-      real_pos_temp.lat                = real_position_.lat;
-      real_pos_temp.height             = real_position_.height;
-      real_pos_temp.heading            = real_position_.heading;
-      real_pos_temp.pitch              = real_position_.pitch;
-      real_pos_temp.roll               = real_position_.roll;
-      real_pos_temp.velocity_x         = real_position_.velocity_x;
-      real_pos_temp.velocity_y         = real_position_.velocity_y;
-      real_pos_temp.velocity_z         = real_position_.velocity_z;
-      real_pos_temp.gps_seconds        = real_position_.gps_seconds;
-      real_pos_temp.n_gps_sequence_num = real_position_.n_gps_sequence_num;
-      real_pos_temp.velocity           = real_position_.velocity;
-
-      //经纬度转换成局部坐标
-      if (mode == 0)
-      {
-        prescanxy2xy(xy_pos_temp, real_pos_temp);
-      }
-      else
-      {
-        prescanxy2xy(xy_pos_temp, real_pos_temp);
-        //gps2xy(xy_pos_temp, real_pos_temp);
-      }
-
-      //组合导航坐标转成车辆中心坐标
-      //insgps2center(xy_pos_temp);
-      xy_pos_temp_front_center = xy_pos_temp;
+    //组合导航坐标转成车辆中心坐标
+    //insgps2center(xy_pos_temp);
+    xy_pos_temp_front_center = xy_pos_temp;
 
-      //查找奇点
-      findStrangePoints();
+    //奇点(换向点)已在路径回调中找出
 
-      //路段截取
-      route_cut(xy_pos_temp);
+    //路段截取
+    route_cut(xy_pos_temp);
 
-      //最小索引 规划路径上的距离车辆中心的最接近点/距离车辆前轴中心的最接近点
-      int min_index_theory              = section_decide_num;
+    //最小索引 规划路径上的距离车辆中心的最接近点/距离车辆前轴中心的最接近点
+    int min_index_theory              = section_decide_num;
 
-      //判断前进还是后退
-      forward_backward_judge();
+    //判断前进还是后退
+    forward_backward_judge();
 
-      ////车辆中心坐标转成车辆前轴中心坐标
-      if(forward_backward_flag == -1)
-      {
-        xy_pos_temp.heading = xy_pos_temp.heading + 180;
-        if(xy_pos_temp.heading > 360)
-        {
-          xy_pos_temp.heading = xy_pos_temp.heading - 360;
-        }
-      } 
-      xy_pos_temp_front_center = xy_pos_temp;
-      center2frontaxis_tf(xy_pos_temp_front_center);
-
-      int min_index_theory_front_center = findClosestFCRefPoint(xy_pos_temp_front_center,min_index_theory);
-
-      //考虑系统延迟推算真正的最近点以及计算曲率半径的点
-      int min_index;
-      int min_index_front_center;
-
-      min_index              = findRealMinIndex(min_index_theory, xy_pos_temp);
-      min_index_front_center = findRealMinIndex(min_index_theory_front_center, xy_pos_temp_front_center);
-      findPoints2ComputeRadius(min_index, indexr1, indexf1, indexf2, indexf3);
-
-      //两个最近点以及计算曲率半径的点
-      positionConf &nearst_pos_temp    = route_data_[min_index];
-      positionConf &nearst_pos_temp_fc = route_data_[min_index_front_center];
-      positionConf &ir1                = route_data_[indexr1];
-      positionConf &ir2                = route_data_[indexr2];
-      positionConf &ir3                = route_data_[indexr3];
-      positionConf &if1                = route_data_[indexf1];
-      positionConf &if2                = route_data_[indexf2];
-      positionConf &if3                = route_data_[indexf3];
-
-      //计算曲率半径
-      double R1    = getR(nearst_pos_temp, ir1, if1);
-      double R4    = getR(nearst_pos_temp, if1, if2);
-      double R5    = getR(if1, if2, if3);
-      double R_tmp = getMinR(R1, R4, R5);
-
-      //计算预瞄点
-      findPrePoint(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
-      findDiagPrePoint(diag_pre_pos_temp,xy_pos_temp,min_index,R_tmp);
-
-      //将两个最近点和预瞄点的坐标转换到车辆坐标系下
-      xy2vxy(vnxy_pos_temp, nearst_pos_temp, xy_pos_temp);
-      xy2vxy(vnxy_pos_temp_fc, nearst_pos_temp_fc, xy_pos_temp_front_center);
-      xy2vxy(vpxy_pos_temp, pre_pos_temp, xy_pos_temp);
-
-      //横向控制模型计算横向误差
-      latteral_error = StanleyPreviewLatteralModel(xy_pos_temp, vnxy_pos_temp, vnxy_pos_temp_fc, vpxy_pos_temp);
-
-      //计算前后轮转向比
-      if(forward_backward_flag == 1)
-      {
-        double sigma = ComputeSigma(R_tmp,nearst_pos_temp,xy_pos_temp,diag_pre_pos_temp,control_angle_f,control_angle_r);
-      }
-      else
+    ////车辆中心坐标转成车辆前轴中心坐标
+    if(forward_backward_flag == -1)
+    {
+      xy_pos_temp.heading = xy_pos_temp.heading + 180;
+      if(xy_pos_temp.heading > 360)
       {
-        double sigma = ComputeSigma(R_tmp,nearst_pos_temp,xy_pos_temp,diag_pre_pos_temp,control_angle_r,control_angle_f);
+        xy_pos_temp.heading = xy_pos_temp.heading - 360;
       }
+    } 
+    xy_pos_temp_front_center = xy_pos_temp;
+    center2frontaxis_tf(xy_pos_temp_front_center);
+
+    int min_index_theory_front_center = findClosestFCRefPoint(xy_pos_temp_front_center,min_index_theory);
+
+    //考虑系统延迟推算真正的最近点以及计算曲率半径的点
+    int min_index;
+    int min_index_front_center;
+
+    min_index              = findRealMinIndex(min_index_theory, xy_pos_temp);
+    min_index_front_center = findRealMinIndex(min_index_theory_front_center, xy_pos_temp_front_center);
+    findPoints2ComputeRadius(min_index, indexr1, indexf1, indexf2, indexf3);
+
+    //两个最近点以及计算曲率半径的点
+    positionConf &nearst_pos_temp    = route_data_[min_index];
+    positionConf &nearst_pos_temp_fc = route_data_[min_index_front_center];
+    positionConf &ir1                = route_data_[indexr1];
+    positionConf &ir2                = route_data_[indexr2];
+    positionConf &ir3                = route_data_[indexr3];
+    positionConf &if1                = route_data_[indexf1];
+    positionConf &if2                = route_data_[indexf2];
+    positionConf &if3                = route_data_[indexf3];
+
+    //计算曲率半径
+    double R1    = getR(nearst_pos_temp, ir1, if1);
+    double R4    = getR(nearst_pos_temp, if1, if2);
+    double R5    = getR(if1, if2, if3);
+    double R_tmp = getMinR(R1, R4, R5);
+
+    //计算预瞄点
+    findPrePoint(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
+    findDiagPrePoint(diag_pre_pos_temp,xy_pos_temp,min_index,R_tmp);
+
+    //将两个最近点和预瞄点的坐标转换到车辆坐标系下
+    xy2vxy(vnxy_pos_temp, nearst_pos_temp, xy_pos_temp);
+    xy2vxy(vnxy_pos_temp_fc, nearst_pos_temp_fc, xy_pos_temp_front_center);
+    xy2vxy(vpxy_pos_temp, pre_pos_temp, xy_pos_temp);
+
+    //横向控制模型计算横向误差
+    latteral_error = StanleyPreviewLatteralModel(xy_pos_temp, vnxy_pos_temp, vnxy_pos_temp_fc, vpxy_pos_temp);
+
+    //计算前后轮转向比
+    if(forward_backward_flag == 1)
+    {
+      double sigma = ComputeSigma(R_tmp,nearst_pos_temp,xy_pos_temp,diag_pre_pos_temp,control_angle_f,control_angle_r);
+    }
+    else
+    {
+      double sigma = ComputeSigma(R_tmp,nearst_pos_temp,xy_pos_temp,diag_pre_pos_temp,control_angle_r,control_angle_f);
+    }
 
-      //横摆角速度限制
-      time_now = ros::Time::now().toSec();
-      yawrate_constrain(time_now, time_previous, control_angle_f, previous_control_angle_f);
-      yawrate_constrain(time_now, time_previous, control_angle_r, previous_control_angle_r);
+    //横摆角速度限制
+    time_now = ros::Time::now().toSec();
+    yawrate_constrain(time_now, time_previous, control_angle_f, previous_control_angle_f);
+    yawrate_constrain(time_now, time_previous, control_angle_r, previous_control_angle_r);
 
-      previous_control_angle_f = control_angle_f;
-      previous_control_angle_r = control_angle_r;
-      time_previous            = time_now;
-      //最大转角限制
-      angle_constrain(control_angle_f);
-      angle_constrain(control_angle_r);
+    previous_control_angle_f = control_angle_f;
+    previous_control_angle_r = control_angle_r;
+    time_previous            = time_now;
+    //最大转角限制
+    angle_constrain(control_angle_f);
+    angle_constrain(control_angle_r);
 
-      //发布控制命令，包括转向角，期望速度，期望加速度，车辆速度
-      if (mode == 0)
+    //发布控制命令，包括转向角，期望速度，期望加速度，车辆速度
+    if (mode == 0)
+    {
+      geometry_msgs::PoseStamped prescan_control_command;
+      prescan_control_command.pose.orientation.x = control_angle_f;
+      prescan_control_command.pose.orientation.z = control_angle_r;
+      prescan_control_command.pose.position.x    = nearst_pos_temp.velocity;
+      
+      if((-min_index_theory + route_section_index_[1]+1) <= 2)
       {
-        geometry_msgs::PoseStamped prescan_control_command;
-        prescan_control_command.pose.orientation.x = control_angle_f;
-        prescan_control_command.pose.orientation.z = control_angle_r;
-        prescan_control_command.pose.position.x    = nearst_pos_temp.velocity;
-        
-        if((-min_index_theory + route_section_index_[1]+1) <= 2)
-        {
-          ROS_INFO("In stop distance!");
-          prescan_control_command.pose.orientation.x = 0;
-          prescan_control_command.pose.orientation.z = 0;
-        }
-        if((-min_index_theory + route_section_index_[1]+1) <= 1)
-        {
-          prescan_control_command.pose.position.x    = 0;
-        }
+        ROS_INFO("In stop distance!");
+        prescan_control_command.pose.orientation.x = 0;
+        prescan_control_command.pose.orientation.z = 0;
+      }
+      if((-min_index_theory + route_section_index_[1]+1) <= 1)
+      {
+        prescan_control_command.pose.position.x    = 0;
+      }
 		/*
 	if(plan_flag == 0)
 	{
@@ -312,68 +396,80 @@ void LFControl::lfControl()
 	}
 	*/
 
-        // velocity orientation
-        prescan_control_command.pose.position.x = forward_backward_flag*prescan_control_command.pose.position.x;
-
-        // prescan_control_command.pose.orientation.x =xy_pos_temp.x;
-        // prescan_control_command.pose.orientation.y =xy_pos_temp.y;
-        // prescan_control_command.pose.orientation.z =vnxy_pos_temp.x;
-        // prescan_control_command.pose.orientation.w = min_index;
+      // velocity orientation
+      prescan_control_command.pose.position.x = forward_backward_flag*prescan_control_command.pose.position.x;
+
+      // prescan_control_command.pose.orientation.x =xy_pos_temp.x;
+      // prescan_control_command.pose.orientation.y =xy_pos_temp.y;
+      // prescan_control_command.pose.orientation.z =vnxy_pos_temp.x;
+      // prescan_control_command.pose.orientation.w = min_index;
+      last_command_.angle_f  = prescan_control_command.pose.orientation.x;
+      last_command_.angle_r  = prescan_control_command.pose.orientation.z;
+      last_command_.velocity = prescan_control_command.pose.position.x;
+      if (control_vcu_pub_)
+      {
         control_vcu_pub_.publish(prescan_control_command);
       }
-      else
-      {
-        control_msgs::ADControlAGV control_msg;
-        control_msg.VehAgl_F = control_angle_f;
-        control_msg.VehAgl_R = control_angle_r;
+    }
+    else
+    {
+      control_msgs::ADControlAGV control_msg;
+      control_msg.VehAgl_F = control_angle_f;
+      control_msg.VehAgl_R = control_angle_r;
 
-        if(min_index >= (route_section_index_[1]+1 - 2))
-        {
-          control_msg.VehAgl_F = 0;
-          control_msg.VehAgl_R = 0;
-        }
-        if(min_index >= (route_section_index_[1]+1 - 1))
-        {
-          control_msg.Vel_Req  = 0;
-        }
+      if(min_index >= (route_section_index_[1]+1 - 2))
+      {
+        control_msg.VehAgl_F = 0;
+        control_msg.VehAgl_R = 0;
+      }
+      if(min_index >= (route_section_index_[1]+1 - 1))
+      {
+        control_msg.Vel_Req  = 0;
+      }
 
-        if (plan_flag == 0)
-        {
-          control_msg.Vel_Req  = 0;
-          control_msg.VehAgl_F = 0;
-          control_msg.VehAgl_R = 0;
-        }
-        else
-        {
-          control_msg.Vel_Req = nearst_pos_temp.velocity;
-        }
+      if (plan_flag == 0)
+      {
+        control_msg.Vel_Req  = 0;
+        control_msg.VehAgl_F = 0;
+        control_msg.VehAgl_R = 0;
+      }
+      else
+      {
+        control_msg.Vel_Req = nearst_pos_temp.velocity;
+      }
 
-        
-        if(refline_stop == 1)
+      
+      if(refline_stop == 1)
+      {
+        if(R_tmp >= 300)
         {
-          if(R_tmp >= 300)
-          {
 		  if(nearst_pos_temp.velocity >= refline_stop_msg.Vel_Req)
 		  {
 		    control_msg.Vel_Req = refline_stop_msg.Vel_Req;
 		  }
 		  control_msg.EStop = refline_stop_msg.EStop;
-          }
         }
-        
-        // velocity orientation
-        control_msg.Vel_Req = forward_backward_flag*control_msg.Vel_Req;
-
-        // control_msg.ACCexp = 0;
-        // control_msg.vehicle_x =xy_pos_temp.x;
-        // control_msg.vehicle_y =xy_pos_temp.y;
-        control_msg.vehicle_err =vnxy_pos_temp.x;
-        control_msg.min_index = min_index;
+      }
+      
+      // velocity orientation
+      control_msg.Vel_Req = forward_backward_flag*control_msg.Vel_Req;
+
+      // control_msg.ACCexp = 0;
+      // control_msg.vehicle_x =xy_pos_temp.x;
+      // control_msg.vehicle_y =xy_pos_temp.y;
+      control_msg.vehicle_err =vnxy_pos_temp.x;
+      control_msg.min_index = min_index;
+      last_command_.angle_f  = control_msg.VehAgl_F;
+      last_command_.angle_r  = control_msg.VehAgl_R;
+      last_command_.velocity = control_msg.Vel_Req;
+      if (control_vcu_pub_)
+      {
         control_vcu_pub_.publish(control_msg);
       }
+    }
 
-      //发布车辆实际运动路径
-      /*
+    //发布车辆实际运动路径
+    /*
 	this_pose_stamped.pose.position.x = xy_pos_temp.x;
 	this_pose_stamped.pose.position.y = xy_pos_temp.y;
 	this_pose_stamped.header.stamp = ros::Time::now();
@@ -383,9 +479,15 @@ void LFControl::lfControl()
 	path.header.frame_id = "odom";
 	path.poses.push_back(this_pose_stamped);
 	veh_path_pub_.publish(path);
-      */
+    */
+
+    last_command_.lateral_error = latteral_error;
+    last_command_.vehicle_err   = vnxy_pos_temp.x;
+    last_command_.seq++;
 
-      //发布车辆前轴中心点，最近点和预瞄点 用于rviz显示
+    //发布车辆前轴中心点，最近点和预瞄点 用于rviz显示
+    if (veh_point_pub_)
+    {
       geometry_msgs::PointStamped psmsg_veh;
       psmsg_veh.header.stamp    = ros::Time::now();
       psmsg_veh.header.frame_id = "odom";
@@ -409,19 +511,16 @@ void LFControl::lfControl()
       psmsg_gps.point.y         = pre_pos_temp.y;
       psmsg_gps.point.z         = 0;
       pre_point_pub_.publish(psmsg_gps);
+    }
 
-      start_tip_ = 1;
+    start_tip_ = 1;
 
-      previous_route_data_.clear();
-      vector< positionConf >().swap(previous_route_data_);
-      for(int i=0;i < route_data_.size();i++)
-      {
+    previous_route_data_.clear();
+    vector< positionConf >().swap(previous_route_data_);
+    for(int i=0;i < route_data_.size();i++)
+    {
 	previous_route_data_.push_back(route_data_[i]);
-      }
     }
-
-    ros::spinOnce();
-    loop_rate.sleep();
   }
 }
 
@@ -1265,27 +1364,6 @@ double LFControl::norm2(const double &dx, const double &dy)
   return sqrt(dx * dx + dy * dy);
 }
 
-void LFControl::findStrangePoints()
-{
-  if(previous_route_data_.size() == route_data_.size() && previous_route_data_[0].x == route_data_[0].x && previous_route_data_[0].y == route_data_[0].y && previous_route_data_[previous_route_data_.size()-1].x == route_data_[route_data_.size()-1].x && previous_route_data_[previous_route_data_.size()-1].y == route_data_[route_data_.size()-1].y)//与上一帧路径相同
-  {
-    
-  }
-  else//与上一帧路径不同
-  {
-    strange_points.clear();
-    vector< int >().swap(strange_points);
-    for(int i=0;i< (route_data_.size()-1);i++)
-    {
-      double dheading_tmp = computedheading(route_data_[i].heading,route_data_[i+1].heading);
-      if(abs(dheading_tmp) >= 90)
-      {
-        strange_points.push_back(i);    
-      }
-    }
-  }
-}
-
 void LFControl::route_cut(const positionConf &rpt)
 {
   if(previous_route_data_.size() == route_data_.size() && previous_route_data_[0].x == route_data_[0].x && previous_route_data_[0].y == route_data_[0].y && previous_route_data_[previous_route_data_.size()-1].x == route_data_[route_data_.size()-1].x && previous_route_data_[previous_route_data_.size()-1].y == route_data_[route_data_.size()-1].y)//与上一帧路径相同
@@ -1641,24 +1719,24 @@ int LFControl::findClosestFCRefPoint(const positionConf &rpt,const int &ref_loc_
 
 void LFControl::recvHuacePosCallback(const location_sensor_msgs::IMUAndGNSSInfo &msg)
 {
-  real_position_.velocity_x = msg.velocity.x;
-  real_position_.velocity_y = msg.velocity.y;
-  real_position_.velocity_z = msg.velocity.z;
-  real_position_.velocity =
+  recv_position_.velocity_x = msg.velocity.x;
+  recv_position_.velocity_y = msg.velocity.y;
+  recv_position_.velocity_z = msg.velocity.z;
+  recv_position_.velocity =
       sqrt(msg.velocity.x * msg.velocity.x + msg.velocity.y * msg.velocity.y + msg.velocity.z * msg.velocity.z);
 
-  real_position_.heading = msg.yaw;
-  real_position_.pitch   = msg.pitch;
-  real_position_.roll    = msg.roll;
+  recv_position_.heading = msg.yaw;
+  recv_position_.pitch   = msg.pitch;
+  recv_position_.roll    = msg.roll;
 
-  real_position_.lon    = msg.pose.y;
-  real_position_.lat    = msg.pose.x;
-  real_position_.height = msg.pose.z;
+  recv_position_.lon    = msg.pose.y;
+  recv_position_.lat    = msg.pose.x;
+  recv_position_.height = msg.pose.z;
 
-  real_position_.gps_seconds        = msg.GPS_sec;
-  real_position_.n_gps_sequence_num = msg.GPS_week;
+  recv_position_.gps_seconds        = msg.GPS_sec;
+  recv_position_.n_gps_sequence_num = msg.GPS_week;
 
-  start_tip_ = 2;
+  position_buf_.write(recv_position_);
 }
 
 double LFControl::sumSquares3D(const double &in_x, const double &in_y, const double &in_z)
@@ -1668,158 +1746,96 @@ double LFControl::sumSquares3D(const double &in_x, const double &in_y, const dou
 
 void LFControl::recvFusionPosCallback(const location_msgs::FusionDataInfo &msg)
 {
-  real_position_.velocity_x = msg.velocity.linear.x;
-  real_position_.velocity_y = msg.velocity.linear.y;
-  real_position_.velocity_z = msg.velocity.linear.z;
-  real_position_.velocity =
-      sqrt(sumSquares3D(real_position_.velocity_x, real_position_.velocity_y, real_position_.velocity_z));
+  recv_position_.velocity_x = msg.velocity.linear.x;
+  recv_position_.velocity_y = msg.velocity.linear.y;
+  recv_position_.velocity_z = msg.velocity.linear.z;
+  recv_position_.velocity =
+      sqrt(sumSquares3D(recv_position_.velocity_x, recv_position_.velocity_y, recv_position_.velocity_z));
 
-  real_position_.heading = msg.yaw;
-  real_position_.pitch   = msg.pitch;
-  real_position_.roll    = msg.roll;
+  recv_position_.heading = msg.yaw;
+  recv_position_.pitch   = msg.pitch;
+  recv_position_.roll    = msg.roll;
 
-  real_position_.lon    = msg.pose.x;
-  real_position_.lat    = msg.pose.y;
-  real_position_.height = msg.pose.z;
+  recv_position_.lon    = msg.pose.x;
+  recv_position_.lat    = msg.pose.y;
+  recv_position_.height = msg.pose.z;
 
-  real_position_.gps_seconds        = msg.sec;
-  real_position_.n_gps_sequence_num = msg.day;
+  recv_position_.gps_seconds        = msg.sec;
+  recv_position_.n_gps_sequence_num = msg.day;
 
-  start_tip_ = 2;
+  position_buf_.write(recv_position_);
 }
 
 void LFControl::recvPrescanRealtimePosCallback(const nav_msgs::Odometry &msg)
 {
-  real_position_.velocity_x = 0;
-  real_position_.velocity_y = 0;
-  real_position_.velocity_z = 0;
-  real_position_.velocity   = msg.twist.twist.linear.x;
+  recv_position_.velocity_x = 0;
+  recv_position_.velocity_y = 0;
+  recv_position_.velocity_z = 0;
+  recv_position_.velocity   = msg.twist.twist.linear.x;
 
-  real_position_.heading = msg.twist.twist.angular.x;
-  real_position_.pitch   = 0;
-  real_position_.roll    = 0;
+  recv_position_.heading = msg.twist.twist.angular.x;
+  recv_position_.pitch   = 0;
+  recv_position_.roll    = 0;
 
-  real_position_.lon    = msg.pose.pose.position.x;
-  real_position_.lat    = msg.pose.pose.position.y;
-  real_position_.height = msg.pose.pose.position.z;
+  recv_position_.lon    = msg.pose.pose.position.x;
+  recv_position_.lat    = msg.pose.pose.position.y;
+  recv_position_.height = msg.pose.pose.position.z;
 
-  real_position_.gps_seconds        = 0;
-  real_position_.n_gps_sequence_num = 0;
+  recv_position_.gps_seconds        = 0;
+  recv_position_.n_gps_sequence_num = 0;
 
-  start_tip_ = 2;
+  position_buf_.write(recv_position_);
 }
 
 void LFControl::recvLocalPathCallback(const plan_msgs::DecisionInfo &msg)
 {
-  positionConf read_position = {0};
-  lattice_route_data_.clear();
-  vector< positionConf >().swap(lattice_route_data_);
-  route_data_.clear();
-  vector< positionConf >().swap(route_data_);
+  //在写缓冲区中插值,容量在三个缓冲区之间复用
+  LocalPathConf &local_path = path_buf_.writeBuffer();
 
   if(msg.path_data_REF.size() > 0)
   {
-	  for (int i = 0; i < msg.path_data_REF.size(); i++)
-	  {
-	    read_position.x        = msg.path_data_REF[i].x;
-	    read_position.y        = msg.path_data_REF[i].y;
-	    read_position.heading  = msg.path_data_REF[i].theta;
-	    read_position.velocity = msg.path_data_REF[i].v;
-
-	    lattice_route_data_.push_back(read_position);
-	  }
-	  plan_flag = msg.path_plan_valid;
-          path_mode = msg.path_mode;
-
-	  //将传来的路径点插值变密
-	  int s = lattice_route_data_.size();
-	  for (int i = 0; i < (s - 1); i++)
-	  {
-	    route_data_.push_back(lattice_route_data_[i]);
-
-	    double l = sqrt((lattice_route_data_[i].x - lattice_route_data_[i + 1].x) *
-		                (lattice_route_data_[i].x - lattice_route_data_[i + 1].x) +
-		            (lattice_route_data_[i].y - lattice_route_data_[i + 1].y) *
-		                (lattice_route_data_[i].y - lattice_route_data_[i + 1].y));
-	    int n            = ceil(l / equal_length);
-	    double dx        = (lattice_route_data_[i + 1].x - lattice_route_data_[i].x) / n;
-	    double dy        = (lattice_route_data_[i + 1].y - lattice_route_data_[i].y) / n;
-	    double dheading  = (lattice_route_data_[i + 1].heading - lattice_route_data_[i].heading) / n;
-            double dheading_j = computedheading(lattice_route_data_[i].heading,lattice_route_data_[i + 1].heading);
-	    double dvelocity = (lattice_route_data_[i + 1].velocity - lattice_route_data_[i].velocity) / n;
-            if(abs(dheading_j) >= 90)
-            {
-              for (int j = 0; j < (n - 1); j++)
-	      {
-	        read_position.x        = lattice_route_data_[i].x + j * dx;
-	        read_position.y        = lattice_route_data_[i].y + j * dy;
-
-                read_position.heading  = lattice_route_data_[i+1].heading;
-	        read_position.velocity = lattice_route_data_[i].velocity + j * dvelocity;
-                if(read_position.velocity < tp_speed && read_position.velocity > 0)
-                {
-                  read_position.velocity = tp_speed;
-                }
-	        route_data_.push_back(read_position);
-	      }
-            }
-            else
-            {
-              for (int j = 0; j < (n - 1); j++)
-	      {
-	        read_position.x        = lattice_route_data_[i].x + j * dx;
-	        read_position.y        = lattice_route_data_[i].y + j * dy;
+    local_path.plan_flag = msg.path_plan_valid;
+    local_path.path_mode = msg.path_mode;
 
-                if(n*abs(dheading) >= 180)
-                {
-                  if(dheading > 0)
-                  {
-                    dheading = (360 - lattice_route_data_[i + 1].heading + lattice_route_data_[i].heading)/n;
-                    read_position.heading  = lattice_route_data_[i].heading - j * dheading;
-                    if(read_position.heading < 0)
-                    {
-                      read_position.heading = read_position.heading + 360;
-                    }
-                  }
-                  else//dheading < 0
-                  {
-                    dheading = (360 - lattice_route_data_[i].heading + lattice_route_data_[i+1].heading)/n;
-                    read_position.heading  = lattice_route_data_[i].heading + j * dheading;
-                    if(read_position.heading > 360)
-                    {
-                      read_position.heading = read_position.heading - 360;
-                    }
-                  } 
-                }
-                else
-                {
-                  read_position.heading  = lattice_route_data_[i].heading + j * dheading;
-                }
-	      
-	        read_position.velocity = lattice_route_data_[i].velocity + j * dvelocity;
-                if(read_position.velocity < tp_speed && read_position.velocity > 0)
-                {
-                  read_position.velocity = tp_speed;
-                }
-	        route_data_.push_back(read_position);
-	      }
-            }
-	    
-	  }
-	  route_data_.push_back(lattice_route_data_[s - 1]);
+    //剔除离群点并将传来的路径点插值变密,同时找出换向点
+    int removed = path_conditioner_.condition(msg.path_data_REF, local_path.route, local_path.cusps);
+    if (removed > 0)
+    {
+      ROS_DEBUG("path conditioner removed %d points", removed);
+    }
+    local_path.math_tip = 2;
 
-	  math_tip_ = 2;
+    if (publish_conditioned_path && conditioned_path_pub_)
+    {
+      publishConditionedPath(local_path.route);
+    }
   }
   else
   {
-    math_tip_ = 1;
+    local_path.math_tip = 1;
   }
-  
+  path_buf_.publish();
+}
+
+void LFControl::publishConditionedPath(const vector< positionConf > &route)
+{
+  conditioned_path_.header.stamp    = ros::Time::now();
+  conditioned_path_.header.frame_id = "odom";
+  conditioned_path_.poses.resize(route.size());
+  for (size_t i = 0; i < route.size(); i++)
+  {
+    geometry_msgs::PoseStamped &pose = conditioned_path_.poses[i];
+    pose.header                      = conditioned_path_.header;
+    pose.pose.position.x             = route[i].x;
+    pose.pose.position.y             = route[i].y;
+    pose.pose.orientation            = tf::createQuaternionMsgFromYaw((90 - route[i].heading) * M_PI / 180);
+  }
+  conditioned_path_pub_.publish(conditioned_path_);
 }
 
 void LFControl::recvReflineStopCallback(const control_msgs::ADControlAGV &msg)
 {
-  refline_stop_msg = msg;
+  refline_stop_buf_.write(msg);
 }
 
 } // namespace control
@@ -0,0 +1,761 @@
+#include "mpc_control.h"
+#include "control.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace std;
+using namespace control;
+
+namespace control
+{
+namespace
+{
+double wrapAngle(double a)
+{
+  while (a > M_PI)
+  {
+    a -= 2 * M_PI;
+  }
+  while (a < -M_PI)
+  {
+    a += 2 * M_PI;
+  }
+  return a;
+}
+} // namespace
+
+void MPCPath::swap(MPCPath &other)
+{
+  x.swap(other.x);
+  y.swap(other.y);
+  s.swap(other.s);
+  heading.swap(other.heading);
+  kappa.swap(other.kappa);
+  v.swap(other.v);
+  dir.swap(other.dir);
+  std::swap(plan_flag, other.plan_flag);
+  std::swap(valid, other.valid);
+}
+
+MPCControl::MPCControl(ros::NodeHandle &nh) : nh_(nh)
+{
+  ROS_INFO("Start initialization...");
+  initVariables();
+
+  ROS_INFO("Start to load paramaters...");
+  loadParams(nh);
+  executor_.loadConf(nh);
+  ROS_INFO("Paramaters loading finished.");
+
+  //发
+  if (mode == 0)
+  {
+    control_vcu_pub_ = nh.advertise< geometry_msgs::PoseStamped >("/control/control_agv", BUF_LEN, true);
+  }
+  else
+  {
+    control_vcu_pub_ = nh.advertise< control_msgs::ADControlAGV >("/control/control_agv", BUF_LEN, true);
+  }
+
+  //收
+  if (mode == 0)
+  {
+    pos_sub_ = nh.subscribe("/prescan/location_xyz", 10, &MPCControl::recvPrescanRealtimePosCallback, this);
+  }
+  else
+  {
+    pos_sub_ = nh.subscribe("/localization/fusion_msg", 10, &MPCControl::recvFusionPosCallback, this);
+  }
+  if (refline_stop == 1)
+  {
+    refline_stop_msg_sub_ = nh.subscribe("/map/stop_msg", 10, &MPCControl::recvReflineStopCallback, this);
+    local_path_sub_       = nh.subscribe("/map/decision_info", 10, &MPCControl::recvLocalPathCallback, this);
+  }
+  else
+  {
+    local_path_sub_ = nh.subscribe("/plan/decision_info", 10, &MPCControl::recvLocalPathCallback, this);
+  }
+  ROS_INFO("Initialization finished.");
+
+  mpcControl();
+}
+
+MPCControl::MPCControl(const ControlParamFile &params)
+{
+  //离线仿真: 不注册话题, 不进入主循环, 由调用者喂数据并调用mpcControlStep()
+  initVariables();
+  loadParams(params);
+}
+
+MPCControl::~MPCControl()
+{
+}
+
+void MPCControl::initVariables()
+{
+  start_tip_          = 1;
+  mode                = 0;
+  refline_stop        = 0;
+  turn_ratio          = 1;
+  max_turn_angle      = 40;
+  center2frontaxis    = 1;
+  center2rearaxis     = 1;
+  turnleft_ispositive = 1;
+
+  conf_.horizon          = 20;
+  conf_.dt               = 0.1;
+  conf_.q_lateral        = 1.0;
+  conf_.q_heading        = 1.0;
+  conf_.r_curvature      = 1.0;
+  conf_.r_curvature_rate = 10.0;
+  conf_.q_speed          = 1.0;
+  conf_.r_accel          = 0.5;
+  conf_.r_jerk           = 1.0;
+  conf_.max_accel        = 0.8;
+  conf_.max_decel        = 1.0;
+  conf_.max_lat_accel    = 0.8;
+  conf_.rear_ratio       = 1.0;
+  conf_.steer_rate       = 30;
+  conf_.delay            = 0.1;
+  conf_.min_speed        = 0.5;
+  conf_.speed_bin        = 0.1;
+  conf_.kappa_window     = 0.5;
+  conf_.stop_tolerance   = 0.05;
+  conf_.max_iter         = 100;
+
+  memset(&real_position_, 0, sizeof(real_position_));
+  memset(&recv_position_, 0, sizeof(recv_position_));
+  memset(&last_command_, 0, sizeof(last_command_));
+  path_.plan_flag = 0;
+  path_.valid     = 0;
+  kappa_prev_     = 0;
+  accel_prev_     = 0;
+  lat_speed_bin_  = -1;
+}
+
+template < typename ParamSource >
+void MPCControl::loadParams(const ParamSource &nh)
+{
+  nh.getParam("/control/mode", mode);
+  nh.getParam("/control/refline_stop", refline_stop);
+  nh.getParam("/control/turn_ratio", turn_ratio);
+  nh.getParam("/control/max_turn_angle", max_turn_angle);
+  nh.getParam("/control/center2frontaxis", center2frontaxis);
+  nh.getParam("/control/center2rearaxis", center2rearaxis);
+  nh.getParam("/control/turnleft_ispositive", turnleft_ispositive);
+
+  nh.getParam("/control/mpc/horizon", conf_.horizon);
+  nh.getParam("/control/mpc/dt", conf_.dt);
+  nh.getParam("/control/mpc/q_lateral", conf_.q_lateral);
+  nh.getParam("/control/mpc/q_heading", conf_.q_heading);
+  nh.getParam("/control/mpc/r_curvature", conf_.r_curvature);
+  nh.getParam("/control/mpc/r_curvature_rate", conf_.r_curvature_rate);
+  nh.getParam("/control/mpc/q_speed", conf_.q_speed);
+  nh.getParam("/control/mpc/r_accel", conf_.r_accel);
+  nh.getParam("/control/mpc/r_jerk", conf_.r_jerk);
+  nh.getParam("/control/mpc/max_accel", conf_.max_accel);
+  nh.getParam("/control/mpc/max_decel", conf_.max_decel);
+  nh.getParam("/control/mpc/max_lat_accel", conf_.max_lat_accel);
+  nh.getParam("/control/mpc/rear_ratio", conf_.rear_ratio);
+  nh.getParam("/control/mpc/steer_rate", conf_.steer_rate);
+  nh.getParam("/control/mpc/delay", conf_.delay);
+  nh.getParam("/control/mpc/min_speed", conf_.min_speed);
+  nh.getParam("/control/mpc/speed_bin", conf_.speed_bin);
+  nh.getParam("/control/mpc/kappa_window", conf_.kappa_window);
+  nh.getParam("/control/mpc/stop_tolerance", conf_.stop_tolerance);
+  nh.getParam("/control/mpc/max_iter", conf_.max_iter);
+
+  conf_.horizon   = max(2, conf_.horizon);
+  conf_.speed_bin = max(0.01, conf_.speed_bin);
+
+  //曲率上限与每个控制周期允许的曲率变化量
+  double wheelbase = center2frontaxis + center2rearaxis;
+  double tan_max   = tan(max_turn_angle / turn_ratio * M_PI / 180);
+  kappa_max_       = tan_max * (1 + conf_.rear_ratio) / wheelbase;
+  dkappa_max_      = (1 + conf_.rear_ratio) / wheelbase * conf_.steer_rate / turn_ratio * M_PI / 180;
+
+  setupLongitudinal();
+  ROS_INFO("MPC horizon:%d dt:%.2f kappa_max:%.4f", conf_.horizon, conf_.dt, kappa_max_);
+}
+template void MPCControl::loadParams(const ros::NodeHandle &nh);
+template void MPCControl::loadParams(const ControlParamFile &nh);
+
+const ControlCommand &MPCControl::lastCommand() const
+{
+  return last_command_;
+}
+
+void MPCControl::mpcControl()
+{
+  if (executor_.enabled())
+  {
+    //控制在独立线程中按绝对截止时间运行,本线程只处理回调
+    executor_.spin(nh_, std::bind(&MPCControl::mpcControlStep, this));
+    return;
+  }
+
+  ros::Rate loop_rate(FRE);
+  while (ros::ok())
+  {
+    mpcControlStep();
+    ros::spinOnce();
+    loop_rate.sleep();
+  }
+}
+
+void MPCControl::updateFromCallbacks()
+{
+  if (position_buf_.read(real_position_))
+  {
+    start_tip_ = 2;
+  }
+  if (path_buf_.update())
+  {
+    path_.swap(path_buf_.readBuffer());
+  }
+  refline_stop_buf_.read(refline_stop_msg);
+}
+
+////横向模型
+// 状态x=[横向偏差, 航向偏差], 输入u=曲率, 扰动w=参考曲率
+// x(k+1) = A*x(k) + B*(u(k) - w(k)), A=[1 v*dt; 0 1], B=[v^2*dt^2/2; v*dt]
+// 预测 X = Phi*x0 + Gamma*(U - W), 代价 X'QX + U'RU + (DU-d0)'Rd(DU-d0)
+// P = Gamma'Q*Gamma + R + D'Rd*D 只与速度有关, 按速度分档重建并分解
+void MPCControl::setupLateral(double v)
+{
+  int bin = (int)(v / conf_.speed_bin + 0.5);
+  if (bin == lat_speed_bin_)
+  {
+    return;
+  }
+  lat_speed_bin_ = bin;
+  v              = max(bin * conf_.speed_bin, conf_.speed_bin);
+
+  const int N     = conf_.horizon;
+  const double dt = conf_.dt;
+  // Gamma(2N*N), Phi(2N*2)
+  vector< double > gamma(2 * N * N, 0.0);
+  vector< double > phi(2 * N * 2, 0.0);
+  for (int k = 0; k < N; k++)
+  {
+    // x(k+1) = A^(k+1)*x0 + sum_j A^(k-j)*B*(u_j - w_j), A^m = [1 m*v*dt; 0 1]
+    phi[(2 * k) * 2 + 0]     = 1;
+    phi[(2 * k) * 2 + 1]     = (k + 1) * v * dt;
+    phi[(2 * k + 1) * 2 + 1] = 1;
+    for (int j = 0; j <= k; j++)
+    {
+      int m                     = k - j;
+      gamma[(2 * k) * N + j]     = v * v * dt * dt * (m + 0.5);
+      gamma[(2 * k + 1) * N + j] = v * dt;
+    }
+  }
+  // Gamma'Q, Gamma'Q*Gamma, Gamma'Q*Phi
+  lat_gtqg_.assign(N * N, 0.0);
+  lat_gtqphi_.assign(N * 2, 0.0);
+  for (int i = 0; i < N; i++)
+  {
+    for (int r = 0; r < 2 * N; r++)
+    {
+      double gq = gamma[r * N + i] * ((r % 2 == 0) ? conf_.q_lateral : conf_.q_heading);
+      if (gq == 0)
+      {
+        continue;
+      }
+      for (int j = 0; j < N; j++)
+      {
+        lat_gtqg_[i * N + j] += gq * gamma[r * N + j];
+      }
+      lat_gtqphi_[i * 2 + 0] += gq * phi[r * 2 + 0];
+      lat_gtqphi_[i * 2 + 1] += gq * phi[r * 2 + 1];
+    }
+  }
+  vector< double > P = lat_gtqg_;
+  for (int i = 0; i < N; i++)
+  {
+    // D'Rd*D: D为一阶差分矩阵,第一行为u0本身
+    P[i * N + i] += conf_.r_curvature + conf_.r_curvature_rate * (i + 1 < N ? 2 : 1);
+    if (i + 1 < N)
+    {
+      P[i * N + i + 1] -= conf_.r_curvature_rate;
+      P[(i + 1) * N + i] -= conf_.r_curvature_rate;
+    }
+  }
+
+  if (lat_solver_.size() != N)
+  {
+    // 约束 [I; D]*U
+    vector< double > A(2 * N * N, 0.0);
+    for (int i = 0; i < N; i++)
+    {
+      A[i * N + i]       = 1;
+      A[(N + i) * N + i] = 1;
+      if (i > 0)
+      {
+        A[(N + i) * N + i - 1] = -1;
+      }
+    }
+    QPSettings settings;
+    settings.rho      = 0.1;
+    settings.sigma    = 1e-6;
+    settings.alpha    = 1.6;
+    settings.max_iter = conf_.max_iter;
+    settings.eps_abs  = 1e-5;
+    settings.eps_rel  = 1e-4;
+    lat_solver_.setup(N, 2 * N, P, A, settings);
+    lat_q_.assign(N, 0.0);
+    lat_w_.assign(N, 0.0);
+    lat_l_.assign(2 * N, 0.0);
+    lat_u_.assign(2 * N, 0.0);
+  }
+  else
+  {
+    lat_solver_.updateP(P);
+  }
+}
+
+////纵向模型
+// 输入a=加速度, V = v0 + T*a, T为dt的下三角矩阵
+// 代价 (V-Vref)'Qv(V-Vref) + a'Ra*a + (Da-d0)'Rj(Da-d0), P为常数只分解一次
+void MPCControl::setupLongitudinal()
+{
+  const int N     = conf_.horizon;
+  const double dt = conf_.dt;
+  vector< double > P(N * N, 0.0);
+  for (int i = 0; i < N; i++)
+  {
+    for (int j = 0; j < N; j++)
+    {
+      // (T'T)_ij = dt^2 * (N - max(i,j))
+      P[i * N + j] = conf_.q_speed * dt * dt * (N - max(i, j));
+    }
+    P[i * N + i] += conf_.r_accel + conf_.r_jerk * (i + 1 < N ? 2 : 1);
+    if (i + 1 < N)
+    {
+      P[i * N + i + 1] -= conf_.r_jerk;
+      P[(i + 1) * N + i] -= conf_.r_jerk;
+    }
+  }
+  // 约束 [I; T/dt]*a, 速度约束行除以dt使两类约束量级一致
+  vector< double > A(2 * N * N, 0.0);
+  for (int i = 0; i < N; i++)
+  {
+    A[i * N + i] = 1;
+    for (int j = 0; j <= i; j++)
+    {
+      A[(N + i) * N + j] = 1;
+    }
+  }
+  QPSettings settings;
+  settings.rho      = 0.1;
+  settings.sigma    = 1e-6;
+  settings.alpha    = 1.6;
+  settings.max_iter = conf_.max_iter;
+  settings.eps_abs  = 1e-3;
+  settings.eps_rel  = 1e-3;
+  lon_solver_.setup(N, 2 * N, P, A, settings);
+  lon_q_.assign(N, 0.0);
+  lon_l_.assign(2 * N, 0.0);
+  lon_u_.assign(2 * N, 0.0);
+  lon_vref_.assign(N, 0.0);
+}
+
+double MPCControl::solveLateral(double v, double lateral, double heading_err, double s0, double s_end, int begin,
+                                int end)
+{
+  setupLateral(v);
+  const int N = conf_.horizon;
+  for (int k = 0; k < N; k++)
+  {
+    lat_w_[k] = interpolate(path_.kappa, min(s0 + v * conf_.dt * k, s_end), begin, end);
+  }
+  // q = Gamma'Q*Phi*x0 - Gamma'Q*Gamma*W - D'Rd*d0
+  for (int i = 0; i < N; i++)
+  {
+    double q = lat_gtqphi_[i * 2 + 0] * lateral + lat_gtqphi_[i * 2 + 1] * heading_err;
+    for (int j = 0; j < N; j++)
+    {
+      q -= lat_gtqg_[i * N + j] * lat_w_[j];
+    }
+    lat_q_[i] = q;
+  }
+  lat_q_[0] -= conf_.r_curvature_rate * kappa_prev_;
+
+  //曲率幅值约束, 变化率约束(首步按控制周期折算)
+  double dk_step = dkappa_max_ * conf_.dt;
+  for (int i = 0; i < N; i++)
+  {
+    lat_l_[i]     = -kappa_max_;
+    lat_u_[i]     = kappa_max_;
+    lat_l_[N + i] = -dk_step;
+    lat_u_[N + i] = dk_step;
+  }
+  double dk_cycle = dkappa_max_ / FRE;
+  lat_l_[N]       = kappa_prev_ - dk_cycle;
+  lat_u_[N]       = kappa_prev_ + dk_cycle;
+
+  lat_solver_.solve(lat_q_, lat_l_, lat_u_);
+  double kappa = lat_solver_.solution()[0];
+  return max(-kappa_max_, min(kappa_max_, kappa));
+}
+
+double MPCControl::solveLongitudinal(double v0, double s0, double s_end, int begin, int end)
+{
+  const int N     = conf_.horizon;
+  const double dt = conf_.dt;
+  for (int k = 0; k < N; k++)
+  {
+    //按当前车速外推, 停车时参考点不前移, 否则会在终点前提前停住
+    double s     = min(s0 + v0 * dt * (k + 1), s_end);
+    double v_ref = interpolate(path_.v, s, begin, end);
+    //弯道限速
+    double kappa = fabs(interpolate(path_.kappa, s, begin, end));
+    if (kappa > 1e-3)
+    {
+      v_ref = min(v_ref, sqrt(conf_.max_lat_accel / kappa));
+    }
+    //终点或换向点前按最大减速度停车
+    v_ref = min(v_ref, sqrt(2 * conf_.max_decel * max(0.0, s_end - s)));
+    if (path_.plan_flag == 0)
+    {
+      v_ref = 0;
+    }
+    if (refline_stop == 1)
+    {
+      v_ref = min(v_ref, (double)refline_stop_msg.Vel_Req);
+    }
+    lon_vref_[k] = max(0.0, v_ref);
+  }
+  // q = T'Qv(v0*1 - Vref) - D'Rj*d0
+  for (int i = 0; i < N; i++)
+  {
+    double q = 0;
+    for (int k = i; k < N; k++)
+    {
+      q += dt * conf_.q_speed * (v0 - lon_vref_[k]);
+    }
+    lon_q_[i] = q;
+  }
+  lon_q_[0] -= conf_.r_jerk * accel_prev_;
+
+  for (int k = 0; k < N; k++)
+  {
+    lon_l_[k]     = -conf_.max_decel;
+    lon_u_[k]     = conf_.max_accel;
+    //速度上限不低于按最大减速度能达到的速度,保证可行
+    double v_high = max(lon_vref_[k], v0 - conf_.max_decel * dt * (k + 1));
+    lon_l_[N + k] = -v0 / dt;
+    lon_u_[N + k] = (v_high - v0) / dt;
+  }
+  lon_solver_.solve(lon_q_, lon_l_, lon_u_);
+  accel_prev_ = max(-conf_.max_decel, min(conf_.max_accel, lon_solver_.solution()[0]));
+  return max(0.0, v0 + accel_prev_ * dt);
+}
+
+void MPCControl::curvature2angle(double kappa, int dir, double &angle_f, double &angle_r) const
+{
+  //对称四轮转向时车辆中心无侧偏: kappa = (tan(df) - tan(dr)) / L, tan(dr) = -ratio*tan(df)
+  double wheelbase = center2frontaxis + center2rearaxis;
+  double tan_lead  = kappa * wheelbase / (1 + conf_.rear_ratio);
+  double lead      = atan(tan_lead) * 180 / M_PI * turn_ratio;
+  double trail     = atan(-conf_.rear_ratio * tan_lead) * 180 / M_PI * turn_ratio;
+  if (turnleft_ispositive != 1)
+  {
+    lead  = -lead;
+    trail = -trail;
+  }
+  //后退时后轴为前导轴
+  if (dir >= 0)
+  {
+    angle_f = lead;
+    angle_r = trail;
+  }
+  else
+  {
+    angle_f = trail;
+    angle_r = lead;
+  }
+  angle_f = max(-max_turn_angle, min(max_turn_angle, angle_f));
+  angle_r = max(-max_turn_angle, min(max_turn_angle, angle_r));
+}
+
+void MPCControl::mpcControlStep()
+{
+  updateFromCallbacks();
+
+  if (start_tip_ != 2 || path_.valid != 1)
+  {
+    return;
+  }
+  start_tip_ = 1;
+
+  //车辆中心位置,与LFControl相同使用局部xy坐标
+  double px = real_position_.lon;
+  double py = real_position_.lat;
+
+  //投影到路径, 确定当前行驶方向段
+  const int n = path_.s.size();
+  double s0, lateral;
+  int index = projectOnPath(px, py, 0, n, s0, lateral);
+  int begin = index;
+  while (begin > 0 && path_.dir[begin - 1] == path_.dir[index])
+  {
+    begin--;
+  }
+  int end = index + 1;
+  while (end < n && path_.dir[end] == path_.dir[index])
+  {
+    end++;
+  }
+  //已到达换向点, 切换到下一段
+  if (end < n && path_.s[end - 1] - s0 < conf_.stop_tolerance && fabs(real_position_.velocity) < 0.05)
+  {
+    begin = end - 1;
+    end   = begin + 1;
+    while (end < n && path_.dir[end] == path_.dir[begin + 1])
+    {
+      end++;
+    }
+    index = projectOnPath(px, py, begin, end, s0, lateral);
+  }
+  int dir      = path_.dir[min(index + 1, end - 1)];
+  double s_end = path_.s[end - 1];
+
+  //横向与航向偏差, 航向逆时针为正
+  double heading     = real_position_.heading * M_PI / 180 + (dir < 0 ? M_PI : 0);
+  double heading_err = -wrapAngle(heading - interpolate(path_.heading, s0, begin, end));
+
+  double v0      = fabs(real_position_.velocity);
+  double v_model = max(v0, conf_.min_speed);
+
+  //延迟补偿: 用上一周期命令把状态外推到命令生效时刻
+  double kappa_ref0 = interpolate(path_.kappa, s0, begin, end);
+  lateral += v_model * conf_.delay * sin(heading_err);
+  heading_err += v_model * conf_.delay * (kappa_prev_ - kappa_ref0);
+  double s_pred = min(s0 + v0 * conf_.delay, s_end);
+
+  double kappa    = solveLateral(v_model, lateral, heading_err, s_pred, s_end, begin, end);
+  double velocity = solveLongitudinal(v0, s_pred, s_end, begin, end);
+  kappa_prev_     = kappa;
+  if (s_end - s0 < conf_.stop_tolerance)
+  {
+    velocity    = 0;
+    accel_prev_ = 0;
+  }
+
+  ControlCommand cmd = last_command_;
+  curvature2angle(kappa, dir, cmd.angle_f, cmd.angle_r);
+  cmd.velocity      = dir * velocity;
+  cmd.lateral_error = lateral;
+  cmd.vehicle_err   = -lateral;
+  cmd.seq++;
+  last_command_ = cmd;
+  publishCommand(cmd, index);
+}
+
+void MPCControl::publishCommand(const ControlCommand &cmd, int index)
+{
+  if (!control_vcu_pub_)
+  {
+    return;
+  }
+  if (mode == 0)
+  {
+    geometry_msgs::PoseStamped prescan_control_command;
+    prescan_control_command.pose.orientation.x = cmd.angle_f;
+    prescan_control_command.pose.orientation.z = cmd.angle_r;
+    prescan_control_command.pose.position.x    = cmd.velocity;
+    control_vcu_pub_.publish(prescan_control_command);
+  }
+  else
+  {
+    control_msgs::ADControlAGV control_msg;
+    control_msg.VehAgl_F    = cmd.angle_f;
+    control_msg.VehAgl_R    = cmd.angle_r;
+    control_msg.Vel_Req     = cmd.velocity;
+    control_msg.vehicle_err = cmd.vehicle_err;
+    control_msg.min_index   = index;
+    if (refline_stop == 1)
+    {
+      control_msg.EStop = refline_stop_msg.EStop;
+    }
+    control_vcu_pub_.publish(control_msg);
+  }
+}
+
+int MPCControl::projectOnPath(double px, double py, int begin, int end, double &s, double &lateral) const
+{
+  int best         = begin;
+  double best_dist = 1e300;
+  s                = path_.s[begin];
+  lateral          = 0;
+  for (int i = begin; i + 1 < end; i++)
+  {
+    double dx  = path_.x[i + 1] - path_.x[i];
+    double dy  = path_.y[i + 1] - path_.y[i];
+    double len = path_.s[i + 1] - path_.s[i];
+    double t   = ((px - path_.x[i]) * dx + (py - path_.y[i]) * dy) / (len * len);
+    t          = max(0.0, min(1.0, t));
+    double ex  = px - (path_.x[i] + t * dx);
+    double ey  = py - (path_.y[i] + t * dy);
+    double d   = ex * ex + ey * ey;
+    if (d < best_dist)
+    {
+      best_dist = d;
+      best      = i;
+      s         = path_.s[i] + t * len;
+      //行驶方向左侧为正
+      lateral = (dx * (py - path_.y[i]) - dy * (px - path_.x[i])) / len;
+    }
+  }
+  return best;
+}
+
+double MPCControl::interpolate(const vector< double > &value, double s, int begin, int end) const
+{
+  if (end - begin < 2 || s <= path_.s[begin])
+  {
+    return value[begin];
+  }
+  if (s >= path_.s[end - 1])
+  {
+    return value[end - 1];
+  }
+  int i = upper_bound(path_.s.begin() + begin, path_.s.begin() + end, s) - path_.s.begin() - 1;
+  double t = (s - path_.s[i]) / (path_.s[i + 1] - path_.s[i]);
+  return value[i] + t * (value[i + 1] - value[i]);
+}
+
+void MPCControl::buildPath(const plan_msgs::DecisionInfo &msg, MPCPath &path) const
+{
+  path.x.clear();
+  path.y.clear();
+  path.s.clear();
+  path.heading.clear();
+  path.kappa.clear();
+  path.v.clear();
+  path.dir.clear();
+  path.plan_flag = msg.path_plan_valid;
+  path.valid     = 0;
+
+  vector< double > theta;
+  for (size_t i = 0; i < msg.path_data_REF.size(); i++)
+  {
+    const common_msgs::PathPoint &p = msg.path_data_REF[i];
+    if (!path.x.empty())
+    {
+      double ds = sqrt((p.x - path.x.back()) * (p.x - path.x.back()) + (p.y - path.y.back()) * (p.y - path.y.back()));
+      if (ds < 1e-3)
+      {
+        continue;
+      }
+      path.s.push_back(path.s.back() + ds);
+    }
+    else
+    {
+      path.s.push_back(0);
+    }
+    path.x.push_back(p.x);
+    path.y.push_back(p.y);
+    path.v.push_back(fabs(p.v));
+    theta.push_back(p.theta * M_PI / 180);
+  }
+  const int n = path.x.size();
+  if (n < 2)
+  {
+    return;
+  }
+
+  //航向与点列走向相反的点为后退
+  path.dir.resize(n);
+  for (int i = 0; i < n; i++)
+  {
+    int j          = i + 1 < n ? i : i - 1;
+    double seg     = atan2(path.x[j + 1] - path.x[j], path.y[j + 1] - path.y[j]);
+    path.dir[i]    = fabs(wrapAngle(theta[i] - seg)) > M_PI / 2 ? -1 : 1;
+  }
+  //行驶方向航向, 段内展开为连续值
+  path.heading.resize(n);
+  for (int i = 0; i < n; i++)
+  {
+    double h = theta[i] + (path.dir[i] < 0 ? M_PI : 0);
+    if (i > 0 && path.dir[i] == path.dir[i - 1])
+    {
+      h = path.heading[i - 1] + wrapAngle(h - path.heading[i - 1]);
+    }
+    path.heading[i] = h;
+  }
+  //段内中心差分求曲率, 罗盘航向减小为左转
+  path.kappa.assign(n, 0.0);
+  int begin = 0;
+  while (begin < n)
+  {
+    int end = begin + 1;
+    while (end < n && path.dir[end] == path.dir[begin])
+    {
+      end++;
+    }
+    int lo = begin;
+    int hi = begin;
+    for (int i = begin; i < end; i++)
+    {
+      while (lo < i && path.s[i] - path.s[lo + 1] >= conf_.kappa_window)
+      {
+        lo++;
+      }
+      while (hi + 1 < end && path.s[hi] - path.s[i] < conf_.kappa_window)
+      {
+        hi++;
+      }
+      double ds = path.s[hi] - path.s[lo];
+      if (ds > 1e-3)
+      {
+        path.kappa[i] = -(path.heading[hi] - path.heading[lo]) / ds;
+      }
+    }
+    begin = end;
+  }
+  path.valid = 1;
+}
+
+////回调函数
+void MPCControl::recvPrescanRealtimePosCallback(const nav_msgs::Odometry &msg)
+{
+  recv_position_.velocity = msg.twist.twist.linear.x;
+  recv_position_.heading  = msg.twist.twist.angular.x;
+  recv_position_.lon      = msg.pose.pose.position.x;
+  recv_position_.lat      = msg.pose.pose.position.y;
+  recv_position_.height   = msg.pose.pose.position.z;
+  position_buf_.write(recv_position_);
+}
+
+void MPCControl::recvFusionPosCallback(const location_msgs::FusionDataInfo &msg)
+{
+  recv_position_.velocity_x = msg.velocity.linear.x;
+  recv_position_.velocity_y = msg.velocity.linear.y;
+  recv_position_.velocity_z = msg.velocity.linear.z;
+  recv_position_.velocity   = sqrt(recv_position_.velocity_x * recv_position_.velocity_x +
+                                 recv_position_.velocity_y * recv_position_.velocity_y +
+                                 recv_position_.velocity_z * recv_position_.velocity_z);
+  recv_position_.heading = msg.yaw;
+  recv_position_.pitch   = msg.pitch;
+  recv_position_.roll    = msg.roll;
+  recv_position_.lon     = msg.pose.x;
+  recv_position_.lat     = msg.pose.y;
+  recv_position_.height  = msg.pose.z;
+  position_buf_.write(recv_position_);
+}
+
+void MPCControl::recvLocalPathCallback(const plan_msgs::DecisionInfo &msg)
+{
+  //在写缓冲区中预处理,容量在三个缓冲区之间复用
+  buildPath(msg, path_buf_.writeBuffer());
+  path_buf_.publish();
+}
+
+void MPCControl::recvReflineStopCallback(const control_msgs::ADControlAGV &msg)
+{
+  refline_stop_buf_.write(msg);
+}
+
+} // namespace control
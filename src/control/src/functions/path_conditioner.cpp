@@ -0,0 +1,253 @@
+#include "path_conditioner.h"
+
+#include <math.h>
+
+using namespace std;
+using namespace control;
+
+namespace control
+{
+namespace
+{
+const double kDuplicateDist = 1e-3; //小于该距离的相邻点视为重复点
+}
+
+double headingDifference(double heading1, double heading2)
+{
+  double d = fmod(heading1 - heading2, 360.0);
+  if (d > 180)
+  {
+    d -= 360;
+  }
+  else if (d <= -180)
+  {
+    d += 360;
+  }
+  return d;
+}
+
+PathConditioner::PathConditioner()
+{
+  PathConditionConf conf;
+  conf.equal_length  = 0.1;
+  conf.tp_speed      = 0;
+  conf.outlier_angle = 0;
+  conf.smooth_window = 0;
+  setConf(conf);
+}
+
+void PathConditioner::setConf(const PathConditionConf &conf)
+{
+  conf_              = conf;
+  conf_.equal_length = max(conf_.equal_length, 0.01);
+  outlier_cos_       = conf_.outlier_angle > 0 ? cos(conf_.outlier_angle * M_PI / 180) : -2;
+
+  // 二次多项式Savitzky-Golay平滑中心点权重
+  // c_j = (3(3m^2+3m-1) - 15j^2) / ((2m-1)(2m+1)(2m+3)), j=-m..m
+  sg_weights_.clear();
+  if (conf_.smooth_window >= 5)
+  {
+    int m       = conf_.smooth_window / 2;
+    double norm = (2.0 * m - 1) * (2.0 * m + 1) * (2.0 * m + 3);
+    for (int j = -m; j <= m; j++)
+    {
+      sg_weights_.push_back((3.0 * (3 * m * m + 3 * m - 1) - 15.0 * j * j) / norm);
+    }
+  }
+}
+
+const PathConditionConf &PathConditioner::conf() const
+{
+  return conf_;
+}
+
+int PathConditioner::condition(const vector< common_msgs::PathPoint > &in, vector< positionConf > &route,
+                               vector< int > &cusps)
+{
+  route.clear();
+  cusps.clear();
+  const int size = in.size();
+  if (size == 0)
+  {
+    return 0;
+  }
+
+  //剔除重复点与离群点,首尾点始终保留
+  keep_.clear();
+  keep_.push_back(0);
+  for (int i = 1; i < size; i++)
+  {
+    const common_msgs::PathPoint &prev = in[keep_.back()];
+    const common_msgs::PathPoint &cur  = in[i];
+    double ax                          = cur.x - prev.x;
+    double ay                          = cur.y - prev.y;
+    double la                          = sqrt(ax * ax + ay * ay);
+    if (i == size - 1)
+    {
+      keep_.push_back(i);
+      break;
+    }
+    //重复点保留前一个,换向点处规划常给出两个重合点,前一个带原航向
+    if (la < kDuplicateDist)
+    {
+      continue;
+    }
+    //尖刺点: 前后两段方向几乎反向, 航向没有换向, 且跳过该点后与上一段方向一致
+    const common_msgs::PathPoint &next = in[i + 1];
+    double bx                          = next.x - cur.x;
+    double by                          = next.y - cur.y;
+    double lb                          = sqrt(bx * bx + by * by);
+    if (keep_.size() >= 2 && lb >= kDuplicateDist && (ax * bx + ay * by) < outlier_cos_ * la * lb &&
+        fabs(headingDifference(cur.theta, prev.theta)) < 90 && fabs(headingDifference(next.theta, cur.theta)) < 90)
+    {
+      const common_msgs::PathPoint &pprev = in[keep_[keep_.size() - 2]];
+      double px                           = prev.x - pprev.x;
+      double py                           = prev.y - pprev.y;
+      double cx                           = next.x - prev.x;
+      double cy                           = next.y - prev.y;
+      if ((px * cx + py * cy) > -outlier_cos_ * sqrt(px * px + py * py) * sqrt(cx * cx + cy * cy))
+      {
+        continue;
+      }
+    }
+    keep_.push_back(i);
+  }
+
+  //先统计每段插值点数,一次性分配输出
+  const int segments = keep_.size() - 1;
+  counts_.resize(max(segments, 0));
+  int total = 1;
+  for (int k = 0; k < segments; k++)
+  {
+    const common_msgs::PathPoint &p0 = in[keep_[k]];
+    const common_msgs::PathPoint &p1 = in[keep_[k + 1]];
+    double l                         = sqrt((p1.x - p0.x) * (p1.x - p0.x) + (p1.y - p0.y) * (p1.y - p0.y));
+    counts_[k]                       = max(1, (int)ceil(l / conf_.equal_length));
+    total += counts_[k];
+  }
+  route.resize(total);
+
+  positionConf zero = {0};
+  int o             = 0;
+  for (int k = 0; k < segments; k++)
+  {
+    const common_msgs::PathPoint &p0 = in[keep_[k]];
+    const common_msgs::PathPoint &p1 = in[keep_[k + 1]];
+    const int n                      = counts_[k];
+    const double dx                  = (p1.x - p0.x) / n;
+    const double dy                  = (p1.y - p0.y) / n;
+    const double dv                  = (p1.v - p0.v) / n;
+    double dheading                  = headingDifference(p1.theta, p0.theta);
+    //换向段内插值点取下一点航向,段首点为换向点
+    const bool cusp = fabs(dheading) >= 90;
+    if (cusp)
+    {
+      cusps.push_back(o);
+    }
+    dheading /= n;
+    for (int j = 0; j < n; j++, o++)
+    {
+      positionConf &p = route[o];
+      p               = zero;
+      p.x             = p0.x + j * dx;
+      p.y             = p0.y + j * dy;
+      p.velocity      = p0.v + j * dv;
+      if (j == 0)
+      {
+        p.heading = p0.theta;
+        continue;
+      }
+      if (cusp)
+      {
+        p.heading = p1.theta;
+      }
+      else
+      {
+        p.heading = p0.theta + j * dheading;
+        if (p.heading < 0)
+        {
+          p.heading += 360;
+        }
+        else if (p.heading >= 360)
+        {
+          p.heading -= 360;
+        }
+      }
+      if (p.velocity < conf_.tp_speed && p.velocity > 0)
+      {
+        p.velocity = conf_.tp_speed;
+      }
+    }
+  }
+  const common_msgs::PathPoint &last = in[keep_.back()];
+  positionConf &p                    = route[o];
+  p                                  = zero;
+  p.x                                = last.x;
+  p.y                                = last.y;
+  p.heading                          = last.theta;
+  p.velocity                         = last.v;
+
+  //按换向点分段平滑,换向点与首尾点不动
+  if (!sg_weights_.empty())
+  {
+    int begin = 0;
+    for (size_t c = 0; c <= cusps.size(); c++)
+    {
+      int end = (c < cusps.size()) ? cusps[c] + 1 : total;
+      smooth(route, begin, end);
+      begin = end;
+    }
+  }
+  return size - (int)keep_.size();
+}
+
+void PathConditioner::smooth(vector< positionConf > &route, int begin, int end)
+{
+  const int m = sg_weights_.size() / 2;
+  if (end - begin < 2 * m + 1)
+  {
+    return;
+  }
+  //sx_/sy_为平滑后的坐标,两端各m个点不动
+  sx_.resize(end - begin);
+  sy_.resize(end - begin);
+  for (int i = begin; i < end; i++)
+  {
+    if (i < begin + m || i >= end - m)
+    {
+      sx_[i - begin] = route[i].x;
+      sy_[i - begin] = route[i].y;
+      continue;
+    }
+    double x = 0, y = 0;
+    for (int j = -m; j <= m; j++)
+    {
+      x += sg_weights_[j + m] * route[i + j].x;
+      y += sg_weights_[j + m] * route[i + j].y;
+    }
+    sx_[i - begin] = x;
+    sy_[i - begin] = y;
+  }
+  //写回坐标,同时按平滑后的中心差分重算航向;与原航向相反(倒车段)时保持倒车航向
+  //段首点(换向点)与段尾点航向不变
+  for (int i = max(begin + 1, begin + m - 1); i < min(end - 1, end - m + 1); i++)
+  {
+    const int k = i - begin;
+    double dx   = sx_[k + 1] - sx_[k - 1];
+    double dy   = sy_[k + 1] - sy_[k - 1];
+    if (dx * dx + dy * dy > kDuplicateDist * kDuplicateDist)
+    {
+      double heading = atan2(dx, dy) * 180 / M_PI;
+      if (fabs(headingDifference(heading, route[i].heading)) > 90)
+      {
+        heading += 180;
+      }
+      heading = fmod(heading + 360, 360);
+      route[i].heading = heading;
+    }
+    route[i].x = sx_[k];
+    route[i].y = sy_[k];
+  }
+}
+
+} // namespace control
@@ -0,0 +1,274 @@
+#include "qp_solver.h"
+
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+using namespace control;
+
+namespace control
+{
+QPSolver::QPSolver() : n_(0), m_(0), converged_(false)
+{
+  settings_.rho      = 0.1;
+  settings_.sigma    = 1e-6;
+  settings_.alpha    = 1.6;
+  settings_.max_iter = 200;
+  settings_.eps_abs  = 1e-4;
+  settings_.eps_rel  = 1e-4;
+}
+
+bool QPSolver::setup(int n, int m, const vector< double > &P, const vector< double > &A, const QPSettings &settings)
+{
+  if (n <= 0 || m < 0 || (int)P.size() != n * n || (int)A.size() != m * n)
+  {
+    return false;
+  }
+  n_        = n;
+  m_        = m;
+  settings_ = settings;
+  P_        = P;
+  A_        = A;
+  L_.assign(n * n, 0.0);
+  rhs_.assign(n, 0.0);
+  xt_.assign(n, 0.0);
+  zt_.assign(m, 0.0);
+  rho_vec_.assign(m, settings_.rho);
+  equality_.assign(m, 0);
+  reset();
+  return factor();
+}
+
+bool QPSolver::updateP(const vector< double > &P)
+{
+  if ((int)P.size() != n_ * n_)
+  {
+    return false;
+  }
+  P_ = P;
+  return factor();
+}
+
+void QPSolver::reset()
+{
+  x_.assign(n_, 0.0);
+  z_.assign(m_, 0.0);
+  y_.assign(m_, 0.0);
+  converged_ = false;
+}
+
+// K = P + sigma*I + A'*diag(rho)*A = L*L'
+// 上下界相等的行按OSQP的做法使用1000倍rho, 否则ADMM在等式约束上收敛很慢
+bool QPSolver::factor()
+{
+  const int n = n_;
+  for (int r = 0; r < m_; r++)
+  {
+    rho_vec_[r] = equality_[r] ? settings_.rho * 1e3 : settings_.rho;
+  }
+  for (int i = 0; i < n; i++)
+  {
+    for (int j = 0; j <= i; j++)
+    {
+      double k = P_[i * n + j];
+      for (int r = 0; r < m_; r++)
+      {
+        k += rho_vec_[r] * A_[r * n + i] * A_[r * n + j];
+      }
+      if (i == j)
+      {
+        k += settings_.sigma;
+      }
+      L_[i * n + j] = k;
+    }
+  }
+  for (int j = 0; j < n; j++)
+  {
+    double d = L_[j * n + j];
+    for (int k = 0; k < j; k++)
+    {
+      d -= L_[j * n + k] * L_[j * n + k];
+    }
+    if (d <= 0)
+    {
+      return false;
+    }
+    d             = sqrt(d);
+    L_[j * n + j] = d;
+    for (int i = j + 1; i < n; i++)
+    {
+      double s = L_[i * n + j];
+      for (int k = 0; k < j; k++)
+      {
+        s -= L_[i * n + k] * L_[j * n + k];
+      }
+      L_[i * n + j] = s / d;
+    }
+  }
+  return true;
+}
+
+void QPSolver::cholSolve(vector< double > &b) const
+{
+  const int n = n_;
+  for (int i = 0; i < n; i++)
+  {
+    double s = b[i];
+    for (int k = 0; k < i; k++)
+    {
+      s -= L_[i * n + k] * b[k];
+    }
+    b[i] = s / L_[i * n + i];
+  }
+  for (int i = n - 1; i >= 0; i--)
+  {
+    double s = b[i];
+    for (int k = i + 1; k < n; k++)
+    {
+      s -= L_[k * n + i] * b[k];
+    }
+    b[i] = s / L_[i * n + i];
+  }
+}
+
+bool QPSolver::checkConvergence(const vector< double > &q, double &rho_scale) const
+{
+  const int n = n_;
+  // 原始残差 ||Ax - z||
+  double prim = 0, ax_norm = 0, z_norm = 0;
+  for (int r = 0; r < m_; r++)
+  {
+    double ax = 0;
+    for (int j = 0; j < n; j++)
+    {
+      ax += A_[r * n + j] * x_[j];
+    }
+    prim    = max(prim, fabs(ax - z_[r]));
+    ax_norm = max(ax_norm, fabs(ax));
+    z_norm  = max(z_norm, fabs(z_[r]));
+  }
+  // 对偶残差 ||Px + q + A'y||
+  double dual = 0, px_norm = 0, aty_norm = 0, q_norm = 0;
+  for (int i = 0; i < n; i++)
+  {
+    double px = 0, aty = 0;
+    for (int j = 0; j < n; j++)
+    {
+      px += P_[i * n + j] * x_[j];
+    }
+    for (int r = 0; r < m_; r++)
+    {
+      aty += A_[r * n + i] * y_[r];
+    }
+    dual     = max(dual, fabs(px + q[i] + aty));
+    px_norm  = max(px_norm, fabs(px));
+    aty_norm = max(aty_norm, fabs(aty));
+    q_norm   = max(q_norm, fabs(q[i]));
+  }
+  double prim_scale = max(ax_norm, z_norm);
+  double dual_scale = max(px_norm, max(aty_norm, q_norm));
+  // 与OSQP相同的自适应rho: 按归一化原始/对偶残差之比调整
+  rho_scale = sqrt((prim / (prim_scale + 1e-10)) / (dual / (dual_scale + 1e-10) + 1e-10));
+  return prim <= settings_.eps_abs + settings_.eps_rel * prim_scale &&
+         dual <= settings_.eps_abs + settings_.eps_rel * dual_scale;
+}
+
+int QPSolver::solve(const vector< double > &q, const vector< double > &l, const vector< double > &u)
+{
+  const int n        = n_;
+  const double sigma = settings_.sigma;
+  const double alpha = settings_.alpha;
+  converged_         = false;
+
+  //等式约束行变化时重新分解
+  bool pattern_changed = false;
+  for (int r = 0; r < m_; r++)
+  {
+    char eq = (u[r] - l[r] < 1e-6) ? 1 : 0;
+    if (eq != equality_[r])
+    {
+      equality_[r]    = eq;
+      pattern_changed = true;
+    }
+  }
+  if (pattern_changed)
+  {
+    factor();
+  }
+
+  int iter = 0;
+  while (iter < settings_.max_iter)
+  {
+    iter++;
+    // (P + sigma*I + A'*diag(rho)*A) xt = sigma*x - q + A'(rho.*z - y)
+    for (int i = 0; i < n; i++)
+    {
+      rhs_[i] = sigma * x_[i] - q[i];
+    }
+    for (int r = 0; r < m_; r++)
+    {
+      double w = rho_vec_[r] * z_[r] - y_[r];
+      for (int i = 0; i < n; i++)
+      {
+        rhs_[i] += A_[r * n + i] * w;
+      }
+    }
+    xt_ = rhs_;
+    cholSolve(xt_);
+
+    for (int r = 0; r < m_; r++)
+    {
+      double zt = 0;
+      for (int j = 0; j < n; j++)
+      {
+        zt += A_[r * n + j] * xt_[j];
+      }
+      zt_[r] = zt;
+    }
+    for (int i = 0; i < n; i++)
+    {
+      x_[i] = alpha * xt_[i] + (1 - alpha) * x_[i];
+    }
+    for (int r = 0; r < m_; r++)
+    {
+      double zr    = alpha * zt_[r] + (1 - alpha) * z_[r];
+      double z_new = min(u[r], max(l[r], zr + y_[r] / rho_vec_[r]));
+      y_[r] += rho_vec_[r] * (zr - z_new);
+      z_[r] = z_new;
+    }
+
+    if (iter % 5 == 0)
+    {
+      double rho_scale = 1;
+      if (checkConvergence(q, rho_scale))
+      {
+        converged_ = true;
+        break;
+      }
+      //残差比例失衡时更新rho并重新分解, y与z保持不变
+      if (iter % 25 == 0 && (rho_scale > 5 || rho_scale < 0.2))
+      {
+        settings_.rho = min(1e6, max(1e-6, settings_.rho * rho_scale));
+        factor();
+      }
+    }
+  }
+  return iter;
+}
+
+const vector< double > &QPSolver::solution() const
+{
+  return x_;
+}
+
+bool QPSolver::converged() const
+{
+  return converged_;
+}
+
+int QPSolver::size() const
+{
+  return n_;
+}
+
+} // namespace control
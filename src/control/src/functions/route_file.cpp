@@ -0,0 +1,306 @@
+#include "route_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace control;
+
+namespace control
+{
+namespace
+{
+uint32_t crc_table[256];
+bool crc_table_ready = false;
+
+void initCrcTable()
+{
+  for (uint32_t i = 0; i < 256; i++)
+  {
+    uint32_t c = i;
+    for (int k = 0; k < 8; k++)
+    {
+      c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+    }
+    crc_table[i] = c;
+  }
+  crc_table_ready = true;
+}
+
+double headingDiff(double h1, double h2)
+{
+  double d = h1 - h2;
+  if (d > 180)
+  {
+    d -= 360;
+  }
+  else if (d < -180)
+  {
+    d += 360;
+  }
+  return d;
+}
+
+bool checkHeader(const RouteFileHeader &header, size_t file_size, const char *path)
+{
+  if (header.magic != ROUTE_FILE_MAGIC)
+  {
+    ROS_ERROR("%s is not a binary route file.", path);
+    return false;
+  }
+  if (header.version != ROUTE_FILE_VERSION || header.header_size != sizeof(RouteFileHeader) ||
+      header.record_size != sizeof(RouteRecord))
+  {
+    ROS_ERROR("%s: unsupported route file version %u (header %u, record %u).", path, header.version,
+              header.header_size, header.record_size);
+    return false;
+  }
+  if (routeCrc32(&header, offsetof(RouteFileHeader, header_crc)) != header.header_crc)
+  {
+    ROS_ERROR("%s: route file header crc error.", path);
+    return false;
+  }
+  if (file_size != sizeof(RouteFileHeader) + (size_t)header.count * sizeof(RouteRecord))
+  {
+    ROS_ERROR("%s: route file size %lu does not match %u records.", path, (unsigned long)file_size, header.count);
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+uint32_t routeCrc32(const void *data, size_t len, uint32_t crc)
+{
+  if (!crc_table_ready)
+  {
+    initCrcTable();
+  }
+  const uint8_t *p = static_cast< const uint8_t * >(data);
+  crc              = ~crc;
+  for (size_t i = 0; i < len; i++)
+  {
+    crc = crc_table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+RouteFileMapping::RouteFileMapping() : addr_(NULL), length_(0)
+{
+}
+
+RouteFileMapping::~RouteFileMapping()
+{
+  close();
+}
+
+bool RouteFileMapping::open(const char *path)
+{
+  close();
+
+  int fd = ::open(path, O_RDONLY);
+  if (fd < 0)
+  {
+    ROS_ERROR("Open %s error: %s", path, strerror(errno));
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(RouteFileHeader))
+  {
+    ROS_ERROR("%s is too small to be a route file.", path);
+    ::close(fd);
+    return false;
+  }
+
+  void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED)
+  {
+    ROS_ERROR("mmap %s error: %s", path, strerror(errno));
+    return false;
+  }
+  addr_   = addr;
+  length_ = st.st_size;
+
+  if (!checkHeader(header(), length_, path))
+  {
+    close();
+    return false;
+  }
+  //顺序读取,提示内核预读
+  madvise(addr_, length_, MADV_SEQUENTIAL);
+  if (routeCrc32(records(), size() * sizeof(RouteRecord)) != header().data_crc)
+  {
+    ROS_ERROR("%s: route data crc error.", path);
+    close();
+    return false;
+  }
+  return true;
+}
+
+void RouteFileMapping::close()
+{
+  if (addr_ != NULL)
+  {
+    munmap(addr_, length_);
+    addr_   = NULL;
+    length_ = 0;
+  }
+}
+
+const RouteFileHeader &RouteFileMapping::header() const
+{
+  return *static_cast< const RouteFileHeader * >(addr_);
+}
+
+const RouteRecord *RouteFileMapping::records() const
+{
+  return reinterpret_cast< const RouteRecord * >(static_cast< const uint8_t * >(addr_) + sizeof(RouteFileHeader));
+}
+
+size_t RouteFileMapping::size() const
+{
+  return addr_ == NULL ? 0 : header().count;
+}
+
+bool isBinaryRouteFile(const char *path)
+{
+  FILE *fp = fopen(path, "rb");
+  if (fp == NULL)
+  {
+    return false;
+  }
+  uint32_t magic = 0;
+  size_t n       = fread(&magic, sizeof(magic), 1, fp);
+  fclose(fp);
+  return n == 1 && magic == ROUTE_FILE_MAGIC;
+}
+
+bool saveBinaryRoute(const char *path, const vector< positionConf > &route, uint32_t path_flags, double origin_lat,
+                     double origin_lon)
+{
+  vector< RouteRecord > records(route.size());
+  double length = 0;
+  for (size_t i = 0; i < route.size(); i++)
+  {
+    if (i > 0)
+    {
+      length += sqrt((route[i].x - route[i - 1].x) * (route[i].x - route[i - 1].x) +
+                     (route[i].y - route[i - 1].y) * (route[i].y - route[i - 1].y));
+    }
+    RouteRecord &r = records[i];
+    r.x            = route[i].x;
+    r.y            = route[i].y;
+    r.heading      = route[i].heading;
+    r.velocity     = route[i].velocity;
+    r.dist         = length;
+    r.flags        = 0;
+    if (i + 1 < route.size() && fabs(headingDiff(route[i].heading, route[i + 1].heading)) >= 90)
+    {
+      r.flags |= ROUTE_POINT_REVERSE;
+    }
+  }
+
+  RouteFileHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic       = ROUTE_FILE_MAGIC;
+  header.version     = ROUTE_FILE_VERSION;
+  header.header_size = sizeof(RouteFileHeader);
+  header.record_size = sizeof(RouteRecord);
+  header.count       = records.size();
+  header.path_flags  = path_flags;
+  header.data_crc    = routeCrc32(records.data(), records.size() * sizeof(RouteRecord));
+  header.origin_lat  = origin_lat;
+  header.origin_lon  = origin_lon;
+  header.length      = length;
+  header.header_crc  = routeCrc32(&header, offsetof(RouteFileHeader, header_crc));
+
+  char tmp_path[1024] = {0};
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+  FILE *fp = fopen(tmp_path, "wb");
+  if (fp == NULL)
+  {
+    ROS_ERROR("Open %s error: %s", tmp_path, strerror(errno));
+    return false;
+  }
+  bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+  if (ok && !records.empty())
+  {
+    ok = fwrite(records.data(), sizeof(RouteRecord), records.size(), fp) == records.size();
+  }
+  ok = (fflush(fp) == 0) && ok;
+  ok = (fsync(fileno(fp)) == 0) && ok;
+  fclose(fp);
+  if (!ok || rename(tmp_path, path) != 0)
+  {
+    ROS_ERROR("Write %s error: %s", path, strerror(errno));
+    unlink(tmp_path);
+    return false;
+  }
+  return true;
+}
+
+bool loadTextRoute(const char *path, vector< positionConf > &route)
+{
+  FILE *fp = fopen(path, "r");
+  if (fp == NULL)
+  {
+    return false;
+  }
+  positionConf read_position = {0};
+  while (fscanf(fp, "%u %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf", &read_position.n_gps_sequence_num,
+                &read_position.x, &read_position.y, &read_position.z, &read_position.lon, &read_position.lat,
+                &read_position.height, &read_position.velocity, &read_position.velocity_x,
+                &read_position.velocity_y, &read_position.velocity_z, &read_position.heading, &read_position.pitch,
+                &read_position.roll, &read_position.dist) == 15)
+  {
+    route.push_back(read_position);
+  }
+  fclose(fp);
+  return true;
+}
+
+bool loadBinaryRoute(const char *path, vector< positionConf > &route, uint32_t *path_flags)
+{
+  RouteFileMapping mapping;
+  if (!mapping.open(path))
+  {
+    return false;
+  }
+  const RouteRecord *records = mapping.records();
+  size_t count               = mapping.size();
+  size_t base                = route.size();
+  route.resize(base + count);
+  for (size_t i = 0; i < count; i++)
+  {
+    positionConf &p      = route[base + i];
+    memset(&p, 0, sizeof(p));
+    p.n_gps_sequence_num = i;
+    p.x                  = records[i].x;
+    p.y                  = records[i].y;
+    p.heading            = records[i].heading;
+    p.velocity           = records[i].velocity;
+    p.dist               = records[i].dist;
+  }
+  if (path_flags != NULL)
+  {
+    *path_flags = mapping.header().path_flags;
+  }
+  return true;
+}
+
+bool loadRouteFile(const char *path, vector< positionConf > &route)
+{
+  if (isBinaryRouteFile(path))
+  {
+    return loadBinaryRoute(path, route);
+  }
+  return loadTextRoute(path, route);
+}
+
+} // namespace control
@@ -16,6 +16,7 @@ RTKControl::RTKControl(ros::NodeHandle &nh) : nh_(nh)
   start_tip_ = 1;
   math_tip_  = 1;
   num_       = 0;
+  recv_position_valid_ = false;
 
   forward_backward_flag = 1;
 
@@ -67,6 +68,7 @@ RTKControl::RTKControl(ros::NodeHandle &nh) : nh_(nh)
   nh.getParam("/control/L0", L0);
   nh.getParam("/control/lamda0", lamda0);
   nh.getParam("/control/hb", hb);
+  executor_.loadConf(nh);
   ROS_INFO("Paramaters loading finished.");
 
   //发
@@ -162,28 +164,14 @@ void RTKControl::getRouteFromFile()
   printf("route date path name:%s\n", route_date_path_name);
 
   //读取地图 route_tip = 0 无图 route_tip = 1 有图
-  FILE *route_data_read_fp   = NULL;
-  route_data_read_fp         = fopen(route_date_path_name, "r");
-  positionConf read_position = {0};
-  if (route_data_read_fp == NULL)
+  //二进制格式直接mmap读取,旧的文本格式逐行解析
+  if (!loadRouteFile(route_date_path_name, route_data_))
   {
     ROS_INFO("Open route_data.bin error!");
     exit(1);
   }
   else
   {
-    ROS_INFO("route_date.bin is open!");
-    while (!feof(route_data_read_fp))
-    {
-      fscanf(route_data_read_fp, "%u %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
-             &read_position.n_gps_sequence_num, &read_position.x, &read_position.y, &read_position.z,
-             &read_position.lon, &read_position.lat, &read_position.height, &read_position.velocity,
-             &read_position.velocity_x, &read_position.velocity_y, &read_position.velocity_z, &read_position.heading,
-             &read_position.pitch, &read_position.roll, &read_position.dist);
-      route_data_.push_back(read_position);
-    }
-
-    fclose(route_data_read_fp);
     printf("read %lu row, route_date is ok!\n", route_data_.size());
 
     math_tip_ = 2;
@@ -193,8 +181,33 @@ void RTKControl::getRouteFromFile()
 void RTKControl::rtkControl()
 {
   ROS_INFO("into-2");
+
+  if (executor_.enabled())
+  {
+    //控制在独立线程中按绝对截止时间运行,本线程只处理回调
+    executor_.spin(nh_, std::bind(&RTKControl::rtkControlStep, this));
+    return;
+  }
+
   ros::Rate loop_rate(FRE);
+  while (ros::ok())
+  {
+    rtkControlStep();
+    ros::spinOnce();
+    loop_rate.sleep();
+  }
+}
 
+void RTKControl::updateFromCallbacks()
+{
+  if (position_buf_.read(real_position_))
+  {
+    start_tip_ = 2;
+  }
+}
+
+void RTKControl::rtkControlStep()
+{
   //临时变量
   positionConf real_pos_temp            = {0}; //组合导航传来的组合导航经纬度位姿
   positionConf pre_pos_temp             = {0}; //预瞄点的XYZ位姿
@@ -205,283 +218,278 @@ void RTKControl::rtkControl()
   positionConf vnxy_pos_temp_fc         = {0}; //距车辆前轴中心最近点的xyz车辆坐标系位姿
   positionConf vpxy_pos_temp            = {0}; //预瞄点的xyz车辆坐标系位姿
 
-  while (ros::ok())
+  updateFromCallbacks();
+
+  if (start_tip_ == 2 && math_tip_ == 2)
   {
 
-    if (start_tip_ == 2 && math_tip_ == 2)
+    real_pos_temp.lon                = real_position_.lon;
+    real_pos_temp.lat                = real_position_.lat;
+    real_pos_temp.height             = real_position_.height;
+    real_pos_temp.heading            = real_position_.heading;
+    real_pos_temp.pitch              = real_position_.pitch;
+    real_pos_temp.roll               = real_position_.roll;
+    real_pos_temp.velocity_x         = real_position_.velocity_x;
+    real_pos_temp.velocity_y         = real_position_.velocity_y;
+    real_pos_temp.velocity_z         = real_position_.velocity_z;
+    real_pos_temp.gps_seconds        = real_position_.gps_seconds;
+    real_pos_temp.n_gps_sequence_num = real_position_.n_gps_sequence_num;
+    real_pos_temp.velocity           = real_position_.velocity;
+
+    //经纬度转换成局部坐标
+    if (mode == 0)
     {
+      prescanxy2xy(xy_pos_temp, real_pos_temp);
+    }
+    else
+    {
+      gps2xy(xy_pos_temp, real_pos_temp);
+    }
 
-      real_pos_temp.lon                = real_position_.lon;
-      real_pos_temp.lat                = real_position_.lat;
-      real_pos_temp.height             = real_position_.height;
-      real_pos_temp.heading            = real_position_.heading;
-      real_pos_temp.pitch              = real_position_.pitch;
-      real_pos_temp.roll               = real_position_.roll;
-      real_pos_temp.velocity_x         = real_position_.velocity_x;
-      real_pos_temp.velocity_y         = real_position_.velocity_y;
-      real_pos_temp.velocity_z         = real_position_.velocity_z;
-      real_pos_temp.gps_seconds        = real_position_.gps_seconds;
-      real_pos_temp.n_gps_sequence_num = real_position_.n_gps_sequence_num;
-      real_pos_temp.velocity           = real_position_.velocity;
-
-      //经纬度转换成局部坐标
-      if (mode == 0)
-      {
-        prescanxy2xy(xy_pos_temp, real_pos_temp);
-      }
-      else
-      {
-        gps2xy(xy_pos_temp, real_pos_temp);
-      }
-
-      //组合导航坐标转成车辆中心坐标
-      insgps2center(xy_pos_temp);
+    //组合导航坐标转成车辆中心坐标
+    insgps2center(xy_pos_temp);
 
-      //查找奇点
-      findStrangePoints();
+    //查找奇点
+    findStrangePoints();
 
-      //路段截取
-      route_cut(xy_pos_temp);
+    //路段截取
+    route_cut(xy_pos_temp);
 
-      //最小索引 规划路径上的距离车辆中心的最接近点/距离车辆前轴中心的最接近点
-      int min_index_theory              = section_decide_num;
+    //最小索引 规划路径上的距离车辆中心的最接近点/距离车辆前轴中心的最接近点
+    int min_index_theory              = section_decide_num;
 
-      //判断前进还是后退
-      forward_backward_judge();
+    //判断前进还是后退
+    forward_backward_judge();
  
-      ////车辆中心坐标转成车辆前轴中心坐标
-      if(forward_backward_flag == -1)
+    ////车辆中心坐标转成车辆前轴中心坐标
+    if(forward_backward_flag == -1)
+    {
+      xy_pos_temp.heading = xy_pos_temp.heading + 180;
+      if(xy_pos_temp.heading > 360)
       {
-        xy_pos_temp.heading = xy_pos_temp.heading + 180;
-        if(xy_pos_temp.heading > 360)
-        {
-          xy_pos_temp.heading = xy_pos_temp.heading - 360;
-        }
-      } 
-      xy_pos_temp_front_center = xy_pos_temp;
-      center2frontaxis_tf(xy_pos_temp_front_center);
+        xy_pos_temp.heading = xy_pos_temp.heading - 360;
+      }
+    } 
+    xy_pos_temp_front_center = xy_pos_temp;
+    center2frontaxis_tf(xy_pos_temp_front_center);
 
-      int min_index_theory_front_center = findClosestFCRefPoint(xy_pos_temp_front_center,min_index_theory);
+    int min_index_theory_front_center = findClosestFCRefPoint(xy_pos_temp_front_center,min_index_theory);
 
 
-      //考虑系统延迟推算真正的最近点以及计算曲率半径的点
-      int min_index;
-      int min_index_front_center;
-      if (pathtype == 0)
-      {
-        min_index              = findRealMinIndex_ringpath(min_index_theory, xy_pos_temp);
-        min_index_front_center = findRealMinIndex_ringpath(min_index_theory_front_center, xy_pos_temp_front_center);
-        findPoints2ComputeRadius_ringpath(min_index, indexr1, indexf1, indexf2, indexf3);
-      }
-      else
-      {
-        min_index              = findRealMinIndex(min_index_theory, xy_pos_temp);
-        min_index_front_center = findRealMinIndex(min_index_theory_front_center, xy_pos_temp_front_center);
-        findPoints2ComputeRadius(min_index, indexr1, indexf1, indexf2, indexf3);
-      }
+    //考虑系统延迟推算真正的最近点以及计算曲率半径的点
+    int min_index;
+    int min_index_front_center;
+    if (pathtype == 0)
+    {
+      min_index              = findRealMinIndex_ringpath(min_index_theory, xy_pos_temp);
+      min_index_front_center = findRealMinIndex_ringpath(min_index_theory_front_center, xy_pos_temp_front_center);
+      findPoints2ComputeRadius_ringpath(min_index, indexr1, indexf1, indexf2, indexf3);
+    }
+    else
+    {
+      min_index              = findRealMinIndex(min_index_theory, xy_pos_temp);
+      min_index_front_center = findRealMinIndex(min_index_theory_front_center, xy_pos_temp_front_center);
+      findPoints2ComputeRadius(min_index, indexr1, indexf1, indexf2, indexf3);
+    }
 
-      //两个最近点以及计算曲率半径的点
-      positionConf &nearst_pos_temp    = route_data_[min_index];
-      positionConf &nearst_pos_temp_fc = route_data_[min_index_front_center];
-      positionConf &ir1                = route_data_[indexr1];
-      positionConf &ir2                = route_data_[indexr2];
-      positionConf &ir3                = route_data_[indexr3];
-      positionConf &if1                = route_data_[indexf1];
-      positionConf &if2                = route_data_[indexf2];
-      positionConf &if3                = route_data_[indexf3];
-
-      //计算曲率半径
-      double R1    = getR(nearst_pos_temp, ir1, if1);
-      double R4    = getR(nearst_pos_temp, if1, if2);
-      double R5    = getR(if1, if2, if3);
-      double R_tmp = getMinR(R1, R4, R5);
-
-      //计算预瞄点
-      if (pathtype == 0)
-      {
-        findPrePoint_ringpath(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
-      }
-      else
-      {
-        findPrePoint(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
-        findDiagPrePoint(diag_pre_pos_temp,xy_pos_temp,min_index,R_tmp);
-      }
+    //两个最近点以及计算曲率半径的点
+    positionConf &nearst_pos_temp    = route_data_[min_index];
+    positionConf &nearst_pos_temp_fc = route_data_[min_index_front_center];
+    positionConf &ir1                = route_data_[indexr1];
+    positionConf &ir2                = route_data_[indexr2];
+    positionConf &ir3                = route_data_[indexr3];
+    positionConf &if1                = route_data_[indexf1];
+    positionConf &if2                = route_data_[indexf2];
+    positionConf &if3                = route_data_[indexf3];
+
+    //计算曲率半径
+    double R1    = getR(nearst_pos_temp, ir1, if1);
+    double R4    = getR(nearst_pos_temp, if1, if2);
+    double R5    = getR(if1, if2, if3);
+    double R_tmp = getMinR(R1, R4, R5);
+
+    //计算预瞄点
+    if (pathtype == 0)
+    {
+      findPrePoint_ringpath(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
+    }
+    else
+    {
+      findPrePoint(pre_pos_temp, xy_pos_temp, min_index, R_tmp);
+      findDiagPrePoint(diag_pre_pos_temp,xy_pos_temp,min_index,R_tmp);
+    }
+
+    //将两个最近点和预瞄点的坐标转换到车辆坐标系下
+    xy2vxy(vnxy_pos_temp, nearst_pos_temp, xy_pos_temp);
+    xy2vxy(vnxy_pos_temp_fc, nearst_pos_temp_fc, xy_pos_temp_front_center);
+    xy2vxy(vpxy_pos_temp, pre_pos_temp, xy_pos_temp);
 
-      //将两个最近点和预瞄点的坐标转换到车辆坐标系下
-      xy2vxy(vnxy_pos_temp, nearst_pos_temp, xy_pos_temp);
-      xy2vxy(vnxy_pos_temp_fc, nearst_pos_temp_fc, xy_pos_temp_front_center);
-      xy2vxy(vpxy_pos_temp, pre_pos_temp, xy_pos_temp);
+    //横向控制模型计算横向误差
+    latteral_error = StanleyPreviewLatteralModel(xy_pos_temp, vnxy_pos_temp, vnxy_pos_temp_fc, vpxy_pos_temp);
 
-      //横向控制模型计算横向误差
-      latteral_error = StanleyPreviewLatteralModel(xy_pos_temp, vnxy_pos_temp, vnxy_pos_temp_fc, vpxy_pos_temp);
+    //计算前后轮转向比
+    if(forward_backward_flag == 1)
+    {
+      double sigma = ComputeSigma(R_tmp,nearst_pos_temp,xy_pos_temp,diag_pre_pos_temp,control_angle_f,control_angle_r);
+    }
+    else
+    {
+      double sigma = ComputeSigma(R_tmp,nearst_pos_temp,xy_pos_temp,diag_pre_pos_temp,control_angle_r,control_angle_f);
+    }
+    
+    //横摆角速度限制
+    time_now = ros::Time::now().toSec();
+    yawrate_constrain(time_now, time_previous, control_angle_f, previous_control_angle_f);
+    yawrate_constrain(time_now, time_previous, control_angle_r, previous_control_angle_r);
+
+    previous_control_angle_f = control_angle_f;
+    previous_control_angle_r = control_angle_r;
+    time_previous            = time_now;
+    //最大转角限制
+    angle_constrain(control_angle_f);
+    angle_constrain(control_angle_r);
+
+    //发布控制命令，包括转向角，期望速度，期望加速度，车辆速度
+    if (mode == 0)
+    {
+      geometry_msgs::PoseStamped prescan_control_command;
+      prescan_control_command.pose.position.x = control_angle_f;
+      prescan_control_command.pose.position.y = control_angle_r;
 
-      //计算前后轮转向比
-      if(forward_backward_flag == 1)
+      if (pathtype == 0)
       {
-        double sigma = ComputeSigma(R_tmp,nearst_pos_temp,xy_pos_temp,diag_pre_pos_temp,control_angle_f,control_angle_r);
+        prescan_control_command.pose.position.z = computespeed(R_tmp, straight_speed);
       }
       else
       {
-        double sigma = ComputeSigma(R_tmp,nearst_pos_temp,xy_pos_temp,diag_pre_pos_temp,control_angle_r,control_angle_f);
-      }
-      
-      //横摆角速度限制
-      time_now = ros::Time::now().toSec();
-      yawrate_constrain(time_now, time_previous, control_angle_f, previous_control_angle_f);
-      yawrate_constrain(time_now, time_previous, control_angle_r, previous_control_angle_r);
-
-      previous_control_angle_f = control_angle_f;
-      previous_control_angle_r = control_angle_r;
-      time_previous            = time_now;
-      //最大转角限制
-      angle_constrain(control_angle_f);
-      angle_constrain(control_angle_r);
-
-      //发布控制命令，包括转向角，期望速度，期望加速度，车辆速度
-      if (mode == 0)
-      {
-        geometry_msgs::PoseStamped prescan_control_command;
-        prescan_control_command.pose.position.x = control_angle_f;
-        prescan_control_command.pose.position.y = control_angle_r;
-
-        if (pathtype == 0)
+        if ((route_section_index_[1]+1 - min_index_theory) * equal_length <= start2stop_dist)
         {
-          prescan_control_command.pose.position.z = computespeed(R_tmp, straight_speed);
+          prescan_control_command.pose.position.z = sqrt((route_data_[route_section_index_[1]].x - route_data_[min_index_theory].x) *
+                                                             (route_data_[route_section_index_[1]].x - route_data_[min_index_theory].x) +
+                                                         (route_data_[route_section_index_[1]].y - route_data_[min_index_theory].y) *
+                                                             (route_data_[route_section_index_[1]].y - route_data_[min_index_theory].y)) *
+                                                    (speed_limit / start2stop_dist);
+          if((route_section_index_[1]+1 - min_index_theory) <= 2)
+          {
+            prescan_control_command.pose.position.x = 0;
+            prescan_control_command.pose.position.y = 0;
+          }
         }
         else
         {
-          if ((route_section_index_[1]+1 - min_index_theory) * equal_length <= start2stop_dist)
-          {
-            prescan_control_command.pose.position.z = sqrt((route_data_[route_section_index_[1]].x - route_data_[min_index_theory].x) *
-                                                               (route_data_[route_section_index_[1]].x - route_data_[min_index_theory].x) +
-                                                           (route_data_[route_section_index_[1]].y - route_data_[min_index_theory].y) *
-                                                               (route_data_[route_section_index_[1]].y - route_data_[min_index_theory].y)) *
-                                                      (speed_limit / start2stop_dist);
-            if((route_section_index_[1]+1 - min_index_theory) <= 2)
-            {
-              prescan_control_command.pose.position.x = 0;
-              prescan_control_command.pose.position.y = 0;
-            }
-          }
-          else
+          prescan_control_command.pose.position.z = computespeed(R_tmp, straight_speed);
+          if(prescan_control_command.pose.position.z < 0.5)
           {
-            prescan_control_command.pose.position.z = computespeed(R_tmp, straight_speed);
-            if(prescan_control_command.pose.position.z < 0.5)
-            {
-              prescan_control_command.pose.position.z = 0.5;
-            }
+            prescan_control_command.pose.position.z = 0.5;
           }
         }
+      }
 
-        // speed limitation
-        if (prescan_control_command.pose.position.z > speed_limit)
-        {
-          prescan_control_command.pose.position.z = speed_limit;
-        }
+      // speed limitation
+      if (prescan_control_command.pose.position.z > speed_limit)
+      {
+        prescan_control_command.pose.position.z = speed_limit;
+      }
  
-        // velocity orientation
-        prescan_control_command.pose.position.z = forward_backward_flag*prescan_control_command.pose.position.z;
-
-        prescan_control_command.pose.orientation.x = xy_pos_temp.x;
-        prescan_control_command.pose.orientation.y = xy_pos_temp.y;
-        prescan_control_command.pose.orientation.z = vnxy_pos_temp.x;
-        prescan_control_command.pose.orientation.w = min_index;
-        control_vcu_pub_.publish(prescan_control_command);
+      // velocity orientation
+      prescan_control_command.pose.position.z = forward_backward_flag*prescan_control_command.pose.position.z;
+
+      prescan_control_command.pose.orientation.x = xy_pos_temp.x;
+      prescan_control_command.pose.orientation.y = xy_pos_temp.y;
+      prescan_control_command.pose.orientation.z = vnxy_pos_temp.x;
+      prescan_control_command.pose.orientation.w = min_index;
+      control_vcu_pub_.publish(prescan_control_command);
+    }
+    else
+    {
+      control_msgs::ADControlAGV control_msg;
+      control_msg.VehAgl_F = control_angle_f;
+      control_msg.VehAgl_R = control_angle_r;
+
+      if (pathtype == 0)
+      {
+        control_msg.Vel_Req = nearst_pos_temp.velocity;
       }
       else
       {
-        control_msgs::ADControlAGV control_msg;
-        control_msg.VehAgl_F = control_angle_f;
-        control_msg.VehAgl_R = control_angle_r;
-
-        if (pathtype == 0)
+        if ((route_section_index_[1]+1 - min_index_theory) * equal_length <= start2stop_dist)
         {
-          control_msg.Vel_Req = nearst_pos_temp.velocity;
+          control_msg.Vel_Req = sqrt((route_data_[route_section_index_[1]].x - route_data_[min_index_theory].x) *
+                                         (route_data_[route_section_index_[1]].x - route_data_[min_index_theory].x) +
+                                     (route_data_[route_section_index_[1]].y - route_data_[min_index_theory].y) *
+                                         (route_data_[route_section_index_[1]].y - route_data_[min_index_theory].y)) *
+                                (speed_limit / start2stop_dist);
+          if((route_section_index_[1]+1 - min_index_theory) <= 2)
+          {
+            control_msg.VehAgl_F = 0;
+            control_msg.VehAgl_R = 0;
+          } 
         }
         else
         {
-          if ((route_section_index_[1]+1 - min_index_theory) * equal_length <= start2stop_dist)
-          {
-            control_msg.Vel_Req = sqrt((route_data_[route_section_index_[1]].x - route_data_[min_index_theory].x) *
-                                           (route_data_[route_section_index_[1]].x - route_data_[min_index_theory].x) +
-                                       (route_data_[route_section_index_[1]].y - route_data_[min_index_theory].y) *
-                                           (route_data_[route_section_index_[1]].y - route_data_[min_index_theory].y)) *
-                                  (speed_limit / start2stop_dist);
-            if((route_section_index_[1]+1 - min_index_theory) <= 2)
-            {
-              control_msg.VehAgl_F = 0;
-              control_msg.VehAgl_R = 0;
-            } 
-          }
-          else
-          {
-            control_msg.Vel_Req = nearst_pos_temp.velocity;
-          }
+          control_msg.Vel_Req = nearst_pos_temp.velocity;
         }
+      }
 
-        control_msg.Vel_Req = forward_backward_flag*control_msg.Vel_Req;
+      control_msg.Vel_Req = forward_backward_flag*control_msg.Vel_Req;
 
-        // control_msg.ACCexp = 0;
-        //control_msg.vehicle_x   = xy_pos_temp.x;
-        //control_msg.vehicle_y   = xy_pos_temp.y;
-        //control_msg.vehicle_err = vnxy_pos_temp.x;
-        //control_msg.min_index   = min_index;
-        control_vcu_pub_.publish(control_msg);
-      }
+      // control_msg.ACCexp = 0;
+      //control_msg.vehicle_x   = xy_pos_temp.x;
+      //control_msg.vehicle_y   = xy_pos_temp.y;
+      //control_msg.vehicle_err = vnxy_pos_temp.x;
+      //control_msg.min_index   = min_index;
+      control_vcu_pub_.publish(control_msg);
+    }
 
-      //发布车辆实际运动路径
-      
-      this_pose_stamped.pose.position.x = xy_pos_temp.x;
-      this_pose_stamped.pose.position.y = xy_pos_temp.y;
-      this_pose_stamped.header.stamp    = ros::Time::now();
-      this_pose_stamped.header.frame_id = "odom";
+    //发布车辆实际运动路径
+    
+    this_pose_stamped.pose.position.x = xy_pos_temp.x;
+    this_pose_stamped.pose.position.y = xy_pos_temp.y;
+    this_pose_stamped.header.stamp    = ros::Time::now();
+    this_pose_stamped.header.frame_id = "odom";
+
+    path.header.frame_id = "odom";
+    path.poses.push_back(this_pose_stamped);
+    if (num_ >= 100)
+    {
+      veh_path_pub_.publish(path);
+      num_ = 0;
+    }
+    
 
-      path.header.frame_id = "odom";
-      path.poses.push_back(this_pose_stamped);
-      if (num_ >= 100)
-      {
-        veh_path_pub_.publish(path);
-        num_ = 0;
-      }
-      
-
-      //发布车辆前轴中心点，最近点和预瞄点 用于rviz显示
-      geometry_msgs::PointStamped psmsg_veh;
-      psmsg_veh.header.stamp    = ros::Time::now();
-      psmsg_veh.header.frame_id = "odom";
-      psmsg_veh.point.x         = xy_pos_temp.x;
-      psmsg_veh.point.y         = xy_pos_temp.y;
-      psmsg_veh.point.z         = 0;
-      veh_point_pub_.publish(psmsg_veh);
-
-      geometry_msgs::PointStamped psmsg;
-      psmsg.header.stamp    = ros::Time::now();
-      psmsg.header.frame_id = "odom";
-      psmsg.point.x         = route_data_[min_index].x;
-      psmsg.point.y         = route_data_[min_index].y;
-      psmsg.point.z         = 0;
-      ref_point_pub_.publish(psmsg);
-
-      geometry_msgs::PointStamped psmsg_gps;
-      psmsg_gps.header.stamp    = ros::Time::now();
-      psmsg_gps.header.frame_id = "odom";
-      psmsg_gps.point.x         = pre_pos_temp.x;
-      psmsg_gps.point.y         = pre_pos_temp.y;
-      psmsg_gps.point.z         = 0;
-      pre_point_pub_.publish(psmsg_gps);
-
-      start_tip_ = 1;
-
-      previous_route_data_.clear();
-      vector< positionConf >().swap(previous_route_data_);
-      for(int i=0;i < route_data_.size();i++)
-      {
+    //发布车辆前轴中心点，最近点和预瞄点 用于rviz显示
+    geometry_msgs::PointStamped psmsg_veh;
+    psmsg_veh.header.stamp    = ros::Time::now();
+    psmsg_veh.header.frame_id = "odom";
+    psmsg_veh.point.x         = xy_pos_temp.x;
+    psmsg_veh.point.y         = xy_pos_temp.y;
+    psmsg_veh.point.z         = 0;
+    veh_point_pub_.publish(psmsg_veh);
+
+    geometry_msgs::PointStamped psmsg;
+    psmsg.header.stamp    = ros::Time::now();
+    psmsg.header.frame_id = "odom";
+    psmsg.point.x         = route_data_[min_index].x;
+    psmsg.point.y         = route_data_[min_index].y;
+    psmsg.point.z         = 0;
+    ref_point_pub_.publish(psmsg);
+
+    geometry_msgs::PointStamped psmsg_gps;
+    psmsg_gps.header.stamp    = ros::Time::now();
+    psmsg_gps.header.frame_id = "odom";
+    psmsg_gps.point.x         = pre_pos_temp.x;
+    psmsg_gps.point.y         = pre_pos_temp.y;
+    psmsg_gps.point.z         = 0;
+    pre_point_pub_.publish(psmsg_gps);
+
+    start_tip_ = 1;
+
+    previous_route_data_.clear();
+    vector< positionConf >().swap(previous_route_data_);
+    for(int i=0;i < route_data_.size();i++)
+    {
 	previous_route_data_.push_back(route_data_[i]);
-      }
     }
-
-    ros::spinOnce();
-    loop_rate.sleep();
   }
 }
 
@@ -1700,56 +1708,68 @@ int RTKControl::findClosestFCRefPoint(const positionConf &rpt,const int &ref_loc
 
 void RTKControl::recvVehDataCallback(const control_msgs::com2veh::ConstPtr &msg)
 {
-  real_position_.velocity = msg->VelSpeed / 3.6;
+  recv_position_.velocity = msg->VelSpeed / 3.6;
+  //只有速度/航向时不发布, 避免控制线程用未收到的位置计算
+  if (recv_position_valid_)
+  {
+    position_buf_.write(recv_position_);
+  }
 }
 
 void RTKControl::recvbestposCallback(const novatel_gps_msgs::NovatelPositionConstPtr &msg)
 {
-  real_position_.n_gps_sequence_num = msg->novatel_msg_header.sequence_num;
-  real_position_.lon                = msg->lon;    //经
-  real_position_.lat                = msg->lat;    //纬
-  real_position_.height             = msg->height; //高
+  recv_position_.n_gps_sequence_num = msg->novatel_msg_header.sequence_num;
+  recv_position_.lon                = msg->lon;    //经
+  recv_position_.lat                = msg->lat;    //纬
+  recv_position_.height             = msg->height; //高
 
-  real_position_.gps_seconds = msg->novatel_msg_header.gps_seconds; // gps秒时间
+  recv_position_.gps_seconds = msg->novatel_msg_header.gps_seconds; // gps秒时间
 
+  recv_position_valid_ = true;
   num_++;
-  start_tip_ = 2;
+  position_buf_.write(recv_position_);
 }
 
 void RTKControl::recvInspvaCallback(const novatel_gps_msgs::InspvaConstPtr &msg)
 {
-  real_position_.velocity_x = msg->north_velocity;
-  real_position_.velocity_y = msg->east_velocity;
-  real_position_.velocity_z = msg->up_velocity;
-  // real_position_.velocity = sqrt(msg->north_velocity*msg->north_velocity + msg->east_velocity*msg->east_velocity +
+  recv_position_.velocity_x = msg->north_velocity;
+  recv_position_.velocity_y = msg->east_velocity;
+  recv_position_.velocity_z = msg->up_velocity;
+  // recv_position_.velocity = sqrt(msg->north_velocity*msg->north_velocity + msg->east_velocity*msg->east_velocity +
   // msg->up_velocity*msg->up_velocity);
 
-  real_position_.heading = msg->azimuth;
-  real_position_.pitch   = msg->pitch;
-  real_position_.heading = msg->azimuth;
+  recv_position_.heading = msg->azimuth;
+  recv_position_.pitch   = msg->pitch;
+  recv_position_.heading = msg->azimuth;
+  //只有速度/航向时不发布, 避免控制线程用未收到的位置计算
+  if (recv_position_valid_)
+  {
+    position_buf_.write(recv_position_);
+  }
 }
 
 void RTKControl::recvHuacePosCallback(const location_sensor_msgs::IMUAndGNSSInfo &msg)
 {
-  real_position_.velocity_x = msg.velocity.x;
-  real_position_.velocity_y = msg.velocity.y;
-  real_position_.velocity_z = msg.velocity.z;
-  real_position_.velocity =
+  recv_position_.velocity_x = msg.velocity.x;
+  recv_position_.velocity_y = msg.velocity.y;
+  recv_position_.velocity_z = msg.velocity.z;
+  recv_position_.velocity =
       sqrt(msg.velocity.x * msg.velocity.x + msg.velocity.y * msg.velocity.y + msg.velocity.z * msg.velocity.z);
 
-  real_position_.heading = msg.yaw;
-  real_position_.pitch   = msg.pitch;
-  real_position_.roll    = msg.roll;
+  recv_position_.heading = msg.yaw;
+  recv_position_.pitch   = msg.pitch;
+  recv_position_.roll    = msg.roll;
 
-  real_position_.lon    = msg.pose.y;
-  real_position_.lat    = msg.pose.x;
-  real_position_.height = msg.pose.z;
+  recv_position_.lon    = msg.pose.y;
+  recv_position_.lat    = msg.pose.x;
+  recv_position_.height = msg.pose.z;
 
-  real_position_.gps_seconds        = msg.GPS_sec;
-  real_position_.n_gps_sequence_num = msg.GPS_week;
+  recv_position_.gps_seconds        = msg.GPS_sec;
+  recv_position_.n_gps_sequence_num = msg.GPS_week;
 
+  recv_position_valid_ = true;
   num_++;
-  start_tip_ = 2;
+  position_buf_.write(recv_position_);
 }
 
 void RTKControl::recvFusionPosCallback(const location_msgs::FusionDataInfo &msg)
@@ -1758,24 +1778,25 @@ void RTKControl::recvFusionPosCallback(const location_msgs::FusionDataInfo &msg)
 
 void RTKControl::recvPrescanRealtimePosCallback(const geometry_msgs::PoseStamped &msg)
 {
-  real_position_.velocity_x = 0;
-  real_position_.velocity_y = 0;
-  real_position_.velocity_z = 0;
-  real_position_.velocity   = msg.pose.orientation.x;
+  recv_position_.velocity_x = 0;
+  recv_position_.velocity_y = 0;
+  recv_position_.velocity_z = 0;
+  recv_position_.velocity   = msg.pose.orientation.x;
 
-  real_position_.heading = msg.pose.orientation.y;
-  real_position_.pitch   = 0;
-  real_position_.roll    = 0;
+  recv_position_.heading = msg.pose.orientation.y;
+  recv_position_.pitch   = 0;
+  recv_position_.roll    = 0;
 
-  real_position_.lon    = msg.pose.position.x;
-  real_position_.lat    = msg.pose.position.y;
-  real_position_.height = msg.pose.position.z;
+  recv_position_.lon    = msg.pose.position.x;
+  recv_position_.lat    = msg.pose.position.y;
+  recv_position_.height = msg.pose.position.z;
 
-  real_position_.gps_seconds        = 0;
-  real_position_.n_gps_sequence_num = 0;
+  recv_position_.gps_seconds        = 0;
+  recv_position_.n_gps_sequence_num = 0;
 
+  recv_position_valid_ = true;
   num_++;
-  start_tip_ = 2;
+  position_buf_.write(recv_position_);
 }
 
 } // namespace control
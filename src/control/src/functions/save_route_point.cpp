@@ -27,6 +27,7 @@ namespace control
 	nh.getParam("/control/L0",L0);
 	nh.getParam("/control/lamda0",lamda0);
 	nh.getParam("/control/hb",hb);
+	nh.param("/control/route_binary",route_binary,1);
 	ROS_INFO("Paramaters loading finished.");
 	
 	////Subscriber and Publisher
@@ -236,14 +237,6 @@ int SaveRoutePoint::get_char()
     char end1 =0x0d;// "/n"
     char end2 =0x0a;// "/r" 
 
-    route_data_save_fp = fopen(route_date_path_name,"w+");
-
-    if(route_data_save_fp  == NULL)
-    {
-      printf("fail to read");
-      exit (1) ;
-    }
-
     ROS_INFO("save file size is: %d",route_data_.size());
 
     int s = route_data_.size();
@@ -291,6 +284,8 @@ int SaveRoutePoint::get_char()
 		ROS_INFO("No position data recorded!");
 	}
 	
+	//闭合路径去掉末尾与起点重合的部分
+	int save_num = xy_route_data_.size();
 	if(pathtype == 0)
 	{
 		int s = xy_route_data_.size();
@@ -303,56 +298,51 @@ int SaveRoutePoint::get_char()
 			dis_tmp_previous = dis_tmp;
 			dis_tmp = sqrt((xy_route_data_[index].x - xy_route_data_[0].x)*(xy_route_data_[index].x - xy_route_data_[0].x) + (xy_route_data_[index].y - xy_route_data_[0].y)*(xy_route_data_[index].y - xy_route_data_[0].y));
 		}
-		
-		for(int i = 0; i <= index; i++)
-		{
-		  //fprintf(sentipsave,"%d",LeaveTip[sennum]);
-		  fprintf(route_data_save_fp,"%u %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf%c%c",
-									  xy_route_data_[i].n_gps_sequence_num,
-									  xy_route_data_[i].x,
-									  xy_route_data_[i].y,
-									  xy_route_data_[i].z,
-									  xy_route_data_[i].lon,
-									  xy_route_data_[i].lat,
-									  xy_route_data_[i].height,//
-									  xy_route_data_[i].velocity,
-									  xy_route_data_[i].velocity_x,
-									  xy_route_data_[i].velocity_y,
-									  xy_route_data_[i].velocity_z,
-									  xy_route_data_[i].heading,
-									  xy_route_data_[i].pitch,//
-									  xy_route_data_[i].roll,
-									  xy_route_data_[i].dist,
-									  end1,
-									  end2
-				);
-		}
+		save_num = index + 1;
 	}
-	else
+
+	if(route_binary == 1)
 	{
-		for(int i = 0; i < xy_route_data_.size(); i++)
+		xy_route_data_.resize(save_num);
+		if(!saveBinaryRoute(route_date_path_name, xy_route_data_, pathtype == 0 ? ROUTE_PATH_RING : 0, L0, lamda0))
 		{
-		  //fprintf(sentipsave,"%d",LeaveTip[sennum]);
-		  fprintf(route_data_save_fp,"%u %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf%c%c",
-									  xy_route_data_[i].n_gps_sequence_num,
-									  xy_route_data_[i].x,
-									  xy_route_data_[i].y,
-									  xy_route_data_[i].z,
-									  xy_route_data_[i].lon,
-									  xy_route_data_[i].lat,
-									  xy_route_data_[i].height,//
-									  xy_route_data_[i].velocity,
-									  xy_route_data_[i].velocity_x,
-									  xy_route_data_[i].velocity_y,
-									  xy_route_data_[i].velocity_z,
-									  xy_route_data_[i].heading,
-									  xy_route_data_[i].pitch,//
-									  xy_route_data_[i].roll,
-									  xy_route_data_[i].dist,
-									  end1,
-									  end2
-				);
+			printf("fail to write");
+			exit (1) ;
 		}
+		ROS_INFO("save file succeed.");
+		return;
+	}
+
+    route_data_save_fp = fopen(route_date_path_name,"w+");
+
+    if(route_data_save_fp  == NULL)
+    {
+      printf("fail to read");
+      exit (1) ;
+    }
+
+	for(int i = 0; i < save_num; i++)
+	{
+	  //fprintf(sentipsave,"%d",LeaveTip[sennum]);
+	  fprintf(route_data_save_fp,"%u %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf%c%c",
+								  xy_route_data_[i].n_gps_sequence_num,
+								  xy_route_data_[i].x,
+								  xy_route_data_[i].y,
+								  xy_route_data_[i].z,
+								  xy_route_data_[i].lon,
+								  xy_route_data_[i].lat,
+								  xy_route_data_[i].height,//
+								  xy_route_data_[i].velocity,
+								  xy_route_data_[i].velocity_x,
+								  xy_route_data_[i].velocity_y,
+								  xy_route_data_[i].velocity_z,
+								  xy_route_data_[i].heading,
+								  xy_route_data_[i].pitch,//
+								  xy_route_data_[i].roll,
+								  xy_route_data_[i].dist,
+								  end1,
+								  end2
+			);
 	}
 	
     fclose(route_data_save_fp);
@@ -11,8 +11,8 @@ int main(int argc, char **argv)
   int mode_tip = 0;
   mode_tip = atoi(argv[1]);
   //检查输入参数，单个参数
-  if(mode_tip != 1 && mode_tip != 2 && mode_tip != 3 && mode_tip != 4 && mode_tip != 5){
-    ROS_INFO("The valid number is 1,2,3, Please input correct parameter!");
+  if(mode_tip != 1 && mode_tip != 2 && mode_tip != 3 && mode_tip != 4 && mode_tip != 5 && mode_tip != 6){
+    ROS_INFO("The valid number is 1,2,3,4,5,6, Please input correct parameter!");
  //   exit(1);
     ros::shutdown();
   }
@@ -30,6 +30,7 @@ int main(int argc, char **argv)
   ros::NodeHandle n_lf; //follow lattice path
   ros::NodeHandle n_gp; //follow global path
   ros::NodeHandle n_dg; //diagonal control
+  ros::NodeHandle n_mpc; //model predictive control
 
   if(mode_tip == 1){
     ROS_INFO("Goto Save Router.");
@@ -56,6 +57,12 @@ int main(int argc, char **argv)
     ROS_INFO("Goto Diagonal Control.");
     DIAGControl dg_control(n_dg);
   }
+
+  if(mode_tip == 6)
+  {
+    ROS_INFO("Goto MPC Path Follow.");
+    MPCControl mpc_control(n_mpc);
+  }
   //主程序休眠
   ros::spin();
 
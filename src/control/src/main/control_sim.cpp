@@ -0,0 +1,870 @@
+#include "control.h"
+#include "control_param_file.h"
+#include "route_file.h"
+
+#include <ros/console.h>
+
+#include <algorithm>
+#include <deque>
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NODE_NAME "control_sim"
+
+using namespace std;
+using namespace control;
+
+// 控制算法离线闭环仿真
+// 参考线(录制路径或合成路径) -> 局部路径回调 -> 控制周期 -> 执行器延迟/速率限制 -> 运动学模型 -> 定位回调
+// 按控制周期步进仿真时间,不依赖roscore和底盘,比实时快,输出跟踪误差/命令平滑度/单周期CPU时间,
+// 设置阈值后不满足时返回非0,可作为调参和性能的回归测试
+namespace
+{
+const double DEG2RAD = M_PI / 180.0;
+const double RAD2DEG = 180.0 / M_PI;
+
+struct SimConf
+{
+  string param_file;
+  string route_file;
+  string scenario;       // straight/circle/lane_change/uturn
+  string controller;     // lf/mpc
+  string trace_file;
+  double speed;          // 参考速度,单位m/s,<=0时使用录制路径中的速度
+  double radius;         // 合成路径转弯半径,单位米
+  double duration;       // 最长仿真时间,单位秒,<=0时按路径长度估算
+  double act_delay;      // 执行器纯延迟,单位秒
+  double steer_rate;     // 车轮转角速度限制,单位deg/s
+  double accel;          // 加减速度限制,单位m/s^2
+  double plan_rate;      // 局部路径发布频率,单位Hz
+  double horizon;        // 局部路径前视长度,单位米
+  double plan_spacing;   // 局部路径点间距,单位米
+  double init_lateral;   // 初始横向偏移,单位米,左为正
+  double init_heading;   // 初始航向偏差,单位度
+  double max_lateral_rms;
+  double max_lateral;
+  double max_heading_rms;
+  double max_cycle_p99_us;
+  bool quiet;
+};
+
+struct VehicleState
+{
+  double x;
+  double y;
+  double heading; // 罗盘航向,单位度,0指向+y,顺时针为正
+  double v;       // 车速,单位m/s,后退为负
+  double steer_f; // 前轮转角,单位度,左转为正
+  double steer_r; // 后轮转角,单位度,左转为正
+};
+
+struct TimedCommand
+{
+  double t;
+  ControlCommand cmd;
+};
+
+// 统计量
+struct RunningStat
+{
+  RunningStat() : n(0), sum(0), sum_sq(0), max_abs(0)
+  {
+  }
+  void add(double v)
+  {
+    n++;
+    sum += v;
+    sum_sq += v * v;
+    max_abs = max(max_abs, fabs(v));
+  }
+  double mean() const
+  {
+    return n > 0 ? sum / n : 0;
+  }
+  double rms() const
+  {
+    return n > 0 ? sqrt(sum_sq / n) : 0;
+  }
+  long n;
+  double sum;
+  double sum_sq;
+  double max_abs;
+};
+
+double wrapHeading(double h)
+{
+  h = fmod(h, 360.0);
+  if (h < 0)
+  {
+    h += 360.0;
+  }
+  return h;
+}
+
+double headingDiff(double h1, double h2)
+{
+  double d = wrapHeading(h1 - h2);
+  return d > 180 ? d - 360 : d;
+}
+
+double threadCpuUs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+double monotonicSec()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+////参考线
+void appendPoint(vector< positionConf > &ref, double x, double y, double v)
+{
+  positionConf p = {0};
+  p.x            = x;
+  p.y            = y;
+  p.velocity     = v;
+  if (!ref.empty())
+  {
+    double dx = x - ref.back().x;
+    double dy = y - ref.back().y;
+    p.heading = wrapHeading(atan2(dx, dy) * RAD2DEG);
+    p.dist    = ref.back().dist + sqrt(dx * dx + dy * dy);
+    if (ref.size() == 1)
+    {
+      ref[0].heading = p.heading;
+    }
+  }
+  ref.push_back(p);
+}
+
+void appendLine(vector< positionConf > &ref, double length, double v)
+{
+  const double step = 0.1;
+  double x0         = ref.back().x;
+  double y0         = ref.back().y;
+  double h          = ref.back().heading * DEG2RAD;
+  for (double s = step; s <= length + 1e-6; s += step)
+  {
+    appendPoint(ref, x0 + s * sin(h), y0 + s * cos(h), v);
+  }
+}
+
+// 圆弧, angle为转过的角度(度),左转为正
+void appendArc(vector< positionConf > &ref, double radius, double angle, double v)
+{
+  const double step = 0.1;
+  double h0         = ref.back().heading * DEG2RAD;
+  double side       = angle > 0 ? 1 : -1; //左转圆心在航向左侧,罗盘航向减小
+  double cx         = ref.back().x - side * radius * cos(h0);
+  double cy         = ref.back().y + side * radius * sin(h0);
+  double total      = fabs(angle) * DEG2RAD * radius;
+  for (double s = step; s <= total + 1e-6; s += step)
+  {
+    double h = h0 - side * s / radius;
+    appendPoint(ref, cx + side * radius * cos(h), cy - side * radius * sin(h), v);
+  }
+}
+
+bool buildScenario(const SimConf &conf, vector< positionConf > &ref)
+{
+  double v = conf.speed > 0 ? conf.speed : 2.0;
+  ref.clear();
+  appendPoint(ref, 0, 0, v);
+  ref[0].heading = 0;
+  if (conf.scenario == "straight")
+  {
+    appendLine(ref, 100, v);
+  }
+  else if (conf.scenario == "circle")
+  {
+    appendLine(ref, 10, v);
+    appendArc(ref, conf.radius, 360, v);
+    appendLine(ref, 10, v);
+  }
+  else if (conf.scenario == "lane_change")
+  {
+    //余弦过渡的换道,横移3.5米
+    const double shift = 3.5;
+    const double len   = 30;
+    appendLine(ref, 30, v);
+    double y0 = ref.back().y;
+    for (double s = 0.1; s <= len + 1e-6; s += 0.1)
+    {
+      appendPoint(ref, shift * (1 - cos(M_PI * s / len)) / 2, y0 + s, v);
+    }
+    appendLine(ref, 40, v);
+  }
+  else if (conf.scenario == "uturn")
+  {
+    appendLine(ref, 20, v);
+    appendArc(ref, conf.radius, 180, v);
+    appendLine(ref, 20, v);
+  }
+  else
+  {
+    printf("unknown scenario %s\n", conf.scenario.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool loadReference(const SimConf &conf, vector< positionConf > &ref)
+{
+  if (conf.route_file.empty())
+  {
+    return buildScenario(conf, ref);
+  }
+  ref.clear();
+  if (!loadRouteFile(conf.route_file.c_str(), ref) || ref.size() < 2)
+  {
+    printf("read route %s error!\n", conf.route_file.c_str());
+    return false;
+  }
+  //重新计算里程,录制路径的dist字段可能是采点间距
+  ref[0].dist = 0;
+  for (size_t i = 1; i < ref.size(); i++)
+  {
+    double dx   = ref[i].x - ref[i - 1].x;
+    double dy   = ref[i].y - ref[i - 1].y;
+    ref[i].dist = ref[i - 1].dist + sqrt(dx * dx + dy * dy);
+    if (conf.speed > 0)
+    {
+      ref[i].velocity = conf.speed;
+    }
+  }
+  if (conf.speed > 0)
+  {
+    ref[0].velocity = conf.speed;
+  }
+  return true;
+}
+
+// 在上次最近点附近查找,避免闭合或交叉路径跳点
+size_t findNearest(const vector< positionConf > &ref, double x, double y, size_t hint, bool global)
+{
+  size_t begin = 0;
+  size_t end   = ref.size();
+  if (!global)
+  {
+    const size_t window = 200;
+    begin               = hint > window ? hint - window : 0;
+    end                 = min(ref.size(), hint + window);
+  }
+  size_t best      = begin;
+  double best_dist = 1e300;
+  for (size_t i = begin; i < end; i++)
+  {
+    double d = (ref[i].x - x) * (ref[i].x - x) + (ref[i].y - y) * (ref[i].y - y);
+    if (d < best_dist)
+    {
+      best_dist = d;
+      best      = i;
+    }
+  }
+  return best;
+}
+
+// 相对参考线的横向误差(左为正)与航向误差
+void trackingError(const vector< positionConf > &ref, size_t index, const VehicleState &s, double &lateral,
+                   double &heading)
+{
+  size_t i0 = index + 1 < ref.size() ? index : index - 1;
+  double dx = ref[i0 + 1].x - ref[i0].x;
+  double dy = ref[i0 + 1].y - ref[i0].y;
+  double l  = sqrt(dx * dx + dy * dy);
+  if (l < 1e-9)
+  {
+    lateral = 0;
+  }
+  else
+  {
+    lateral = (dx * (s.y - ref[i0].y) - dy * (s.x - ref[i0].x)) / l;
+  }
+  heading = headingDiff(s.heading, ref[index].heading);
+}
+
+// 取最近点后方2米至前方horizon米的参考线,按plan_spacing抽稀后作为局部路径
+void buildLocalPath(const SimConf &conf, const vector< positionConf > &ref, size_t index,
+                    plan_msgs::DecisionInfo &msg)
+{
+  msg.path_data_REF.clear();
+  double s_begin = ref[index].dist - 2.0;
+  double s_end   = ref[index].dist + conf.horizon;
+  double s_next  = s_begin;
+  for (size_t i = 0; i < ref.size(); i++)
+  {
+    if (ref[i].dist < s_next && i + 1 != ref.size())
+    {
+      continue;
+    }
+    if (ref[i].dist > s_end)
+    {
+      break;
+    }
+    common_msgs::PathPoint p;
+    p.x     = ref[i].x;
+    p.y     = ref[i].y;
+    p.theta = ref[i].heading;
+    p.v     = ref[i].velocity;
+    msg.path_data_REF.push_back(p);
+    s_next = ref[i].dist + conf.plan_spacing;
+  }
+  msg.path_plan_valid = 1;
+  msg.path_mode       = 1;
+}
+
+////被测控制器
+class SimController
+{
+public:
+  virtual ~SimController()
+  {
+  }
+  virtual void setPath(const plan_msgs::DecisionInfo &msg) = 0;
+  virtual void setPose(const nav_msgs::Odometry &msg)      = 0;
+  virtual void step()                                      = 0;
+  virtual const ControlCommand &command() const            = 0;
+};
+
+class LFSimController : public SimController
+{
+public:
+  explicit LFSimController(const ControlParamFile &params) : lf_(params)
+  {
+  }
+  void setPath(const plan_msgs::DecisionInfo &msg)
+  {
+    lf_.recvLocalPathCallback(msg);
+  }
+  void setPose(const nav_msgs::Odometry &msg)
+  {
+    lf_.recvPrescanRealtimePosCallback(msg);
+  }
+  void step()
+  {
+    lf_.lfControlStep();
+  }
+  const ControlCommand &command() const
+  {
+    return lf_.lastCommand();
+  }
+
+private:
+  LFControl lf_;
+};
+
+class MPCSimController : public SimController
+{
+public:
+  explicit MPCSimController(const ControlParamFile &params) : mpc_(params)
+  {
+  }
+  void setPath(const plan_msgs::DecisionInfo &msg)
+  {
+    mpc_.recvLocalPathCallback(msg);
+  }
+  void setPose(const nav_msgs::Odometry &msg)
+  {
+    mpc_.recvPrescanRealtimePosCallback(msg);
+  }
+  void step()
+  {
+    mpc_.mpcControlStep();
+  }
+  const ControlCommand &command() const
+  {
+    return mpc_.lastCommand();
+  }
+
+private:
+  MPCControl mpc_;
+};
+
+SimController *createController(const string &name, const ControlParamFile &params)
+{
+  if (name == "lf")
+  {
+    return new LFSimController(params);
+  }
+  if (name == "mpc")
+  {
+    return new MPCSimController(params);
+  }
+  printf("unknown controller %s\n", name.c_str());
+  return NULL;
+}
+
+////车辆模型
+struct VehicleConf
+{
+  double lf;            // 车辆中心到前轴距离
+  double lr;            // 车辆中心到后轴距离
+  double max_angle;     // 最大车轮转角,单位度
+  double turn_ratio;    // 命令转角与车轮转角比例
+  double left_sign;     // 命令转角左转为正时为1
+};
+
+double approach(double value, double target, double max_step)
+{
+  if (target > value + max_step)
+  {
+    return value + max_step;
+  }
+  if (target < value - max_step)
+  {
+    return value - max_step;
+  }
+  return target;
+}
+
+// 四轮转向运动学单车模型
+void vehicleStep(const VehicleConf &vc, const SimConf &conf, const ControlCommand &cmd, double dt, VehicleState &s)
+{
+  double target_f = cmd.angle_f * vc.left_sign / vc.turn_ratio;
+  double target_r = cmd.angle_r * vc.left_sign / vc.turn_ratio;
+  target_f        = max(-vc.max_angle, min(vc.max_angle, target_f));
+  target_r        = max(-vc.max_angle, min(vc.max_angle, target_r));
+  s.steer_f       = approach(s.steer_f, target_f, conf.steer_rate * dt);
+  s.steer_r       = approach(s.steer_r, target_r, conf.steer_rate * dt);
+  s.v             = approach(s.v, cmd.velocity, conf.accel * dt);
+
+  double tan_f    = tan(s.steer_f * DEG2RAD);
+  double tan_r    = tan(s.steer_r * DEG2RAD);
+  double wheelbase = vc.lf + vc.lr;
+  double beta     = atan((vc.lf * tan_r + vc.lr * tan_f) / wheelbase);
+  double yaw_rate = s.v * cos(beta) * (tan_f - tan_r) / wheelbase; //逆时针为正,单位rad/s
+
+  double course = (s.heading * DEG2RAD) - beta;
+  s.x += s.v * dt * sin(course);
+  s.y += s.v * dt * cos(course);
+  s.heading = wrapHeading(s.heading - yaw_rate * dt * RAD2DEG);
+}
+
+void usage(const char *name)
+{
+  printf("usage: %s -c <control_params.yaml> [options]\n", name);
+  printf("  -c, --config FILE            control parameter yaml\n");
+  printf("  -r, --route FILE             recorded route (binary or text) as reference line\n");
+  printf("  -s, --scenario NAME          synthetic reference: straight|circle|lane_change|uturn (default lane_change)\n");
+  printf("      --controller NAME        controller under test: lf (default) or mpc\n");
+  printf("  -v, --speed MPS              reference speed, overrides recorded speed (default 2.0)\n");
+  printf("      --radius M               turn radius of synthetic curves (default 20)\n");
+  printf("  -t, --duration S             max simulated time (default from route length)\n");
+  printf("      --delay S                actuator transport delay (default 0.1)\n");
+  printf("      --steer-rate DEG_S       wheel angle rate limit (default 30)\n");
+  printf("      --accel MPS2             acceleration limit (default 1.0)\n");
+  printf("      --plan-rate HZ           local path rate (default 10)\n");
+  printf("      --horizon M              local path length ahead (default 30)\n");
+  printf("      --plan-spacing M         local path point spacing (default 1.0)\n");
+  printf("      --init-lateral M         initial lateral offset, left positive (default 0)\n");
+  printf("      --init-heading DEG       initial heading offset (default 0)\n");
+  printf("  -o, --trace FILE             write per-cycle csv trace\n");
+  printf("      --max-lateral-rms M      fail if lateral error rms exceeds\n");
+  printf("      --max-lateral M          fail if max lateral error exceeds\n");
+  printf("      --max-heading-rms DEG    fail if heading error rms exceeds\n");
+  printf("      --max-cycle-p99-us US    fail if p99 control cycle cpu time exceeds\n");
+  printf("  -q, --quiet                  only log warnings from the controller\n");
+}
+
+enum
+{
+  OPT_CONTROLLER = 256,
+  OPT_RADIUS,
+  OPT_DELAY,
+  OPT_STEER_RATE,
+  OPT_ACCEL,
+  OPT_PLAN_RATE,
+  OPT_HORIZON,
+  OPT_PLAN_SPACING,
+  OPT_INIT_LATERAL,
+  OPT_INIT_HEADING,
+  OPT_MAX_LATERAL_RMS,
+  OPT_MAX_LATERAL,
+  OPT_MAX_HEADING_RMS,
+  OPT_MAX_CYCLE_P99,
+};
+
+bool parseArgs(int argc, char **argv, SimConf &conf)
+{
+  static struct option long_options[] = {
+    { "config", required_argument, 0, 'c' },
+    { "route", required_argument, 0, 'r' },
+    { "scenario", required_argument, 0, 's' },
+    { "controller", required_argument, 0, OPT_CONTROLLER },
+    { "speed", required_argument, 0, 'v' },
+    { "radius", required_argument, 0, OPT_RADIUS },
+    { "duration", required_argument, 0, 't' },
+    { "delay", required_argument, 0, OPT_DELAY },
+    { "steer-rate", required_argument, 0, OPT_STEER_RATE },
+    { "accel", required_argument, 0, OPT_ACCEL },
+    { "plan-rate", required_argument, 0, OPT_PLAN_RATE },
+    { "horizon", required_argument, 0, OPT_HORIZON },
+    { "plan-spacing", required_argument, 0, OPT_PLAN_SPACING },
+    { "init-lateral", required_argument, 0, OPT_INIT_LATERAL },
+    { "init-heading", required_argument, 0, OPT_INIT_HEADING },
+    { "trace", required_argument, 0, 'o' },
+    { "max-lateral-rms", required_argument, 0, OPT_MAX_LATERAL_RMS },
+    { "max-lateral", required_argument, 0, OPT_MAX_LATERAL },
+    { "max-heading-rms", required_argument, 0, OPT_MAX_HEADING_RMS },
+    { "max-cycle-p99-us", required_argument, 0, OPT_MAX_CYCLE_P99 },
+    { "quiet", no_argument, 0, 'q' },
+    { "help", no_argument, 0, 'h' },
+    { 0, 0, 0, 0 }
+  };
+
+  conf.scenario         = "lane_change";
+  conf.controller       = "lf";
+  conf.speed            = 2.0;
+  conf.radius           = 20;
+  conf.duration         = 0;
+  conf.act_delay        = 0.1;
+  conf.steer_rate       = 30;
+  conf.accel            = 1.0;
+  conf.plan_rate        = 10;
+  conf.horizon          = 30;
+  conf.plan_spacing     = 1.0;
+  conf.init_lateral     = 0;
+  conf.init_heading     = 0;
+  conf.max_lateral_rms  = -1;
+  conf.max_lateral      = -1;
+  conf.max_heading_rms  = -1;
+  conf.max_cycle_p99_us = -1;
+  conf.quiet            = false;
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "c:r:s:v:t:o:qh", long_options, NULL)) != -1)
+  {
+    switch (opt)
+    {
+    case 'c':
+      conf.param_file = optarg;
+      break;
+    case 'r':
+      conf.route_file = optarg;
+      conf.speed      = 0;
+      break;
+    case 's':
+      conf.scenario = optarg;
+      break;
+    case OPT_CONTROLLER:
+      conf.controller = optarg;
+      break;
+    case 'v':
+      conf.speed = atof(optarg);
+      break;
+    case OPT_RADIUS:
+      conf.radius = atof(optarg);
+      break;
+    case 't':
+      conf.duration = atof(optarg);
+      break;
+    case OPT_DELAY:
+      conf.act_delay = atof(optarg);
+      break;
+    case OPT_STEER_RATE:
+      conf.steer_rate = atof(optarg);
+      break;
+    case OPT_ACCEL:
+      conf.accel = atof(optarg);
+      break;
+    case OPT_PLAN_RATE:
+      conf.plan_rate = atof(optarg);
+      break;
+    case OPT_HORIZON:
+      conf.horizon = atof(optarg);
+      break;
+    case OPT_PLAN_SPACING:
+      conf.plan_spacing = atof(optarg);
+      break;
+    case OPT_INIT_LATERAL:
+      conf.init_lateral = atof(optarg);
+      break;
+    case OPT_INIT_HEADING:
+      conf.init_heading = atof(optarg);
+      break;
+    case 'o':
+      conf.trace_file = optarg;
+      break;
+    case OPT_MAX_LATERAL_RMS:
+      conf.max_lateral_rms = atof(optarg);
+      break;
+    case OPT_MAX_LATERAL:
+      conf.max_lateral = atof(optarg);
+      break;
+    case OPT_MAX_HEADING_RMS:
+      conf.max_heading_rms = atof(optarg);
+      break;
+    case OPT_MAX_CYCLE_P99:
+      conf.max_cycle_p99_us = atof(optarg);
+      break;
+    case 'q':
+      conf.quiet = true;
+      break;
+    default:
+      return false;
+    }
+  }
+  if (conf.param_file.empty() || optind != argc || conf.plan_rate <= 0 || conf.plan_spacing <= 0)
+  {
+    return false;
+  }
+  return true;
+}
+
+bool checkLimit(const char *name, double value, double limit)
+{
+  if (limit < 0 || value <= limit)
+  {
+    return true;
+  }
+  printf("FAIL: %s %.4f exceeds %.4f\n", name, value, limit);
+  return false;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+  SimConf conf;
+  if (!parseArgs(argc, argv, conf))
+  {
+    usage(argv[0]);
+    return 1;
+  }
+
+  ControlParamFile params;
+  if (!params.load(conf.param_file))
+  {
+    printf("read %s error!\n", conf.param_file.c_str());
+    return 1;
+  }
+  //仿真使用Prescan接口: 定位为局部xy坐标,输出PoseStamped命令
+  params.set("/control/mode", "0");
+  params.set("/control/refline_stop", "0");
+
+  //控制器内部使用ros::Time::now(),改为仿真时间,不连接master
+  ros::init(argc, argv, NODE_NAME, ros::init_options::NoSigintHandler | ros::init_options::AnonymousName |
+                                       ros::init_options::NoRosout);
+  if (conf.quiet &&
+      ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME, ros::console::levels::Warn))
+  {
+    ros::console::notifyLoggerLevelsChanged();
+  }
+  double sim_time = 1.0;
+  ros::Time::setNow(ros::Time(sim_time));
+
+  vector< positionConf > ref;
+  if (!loadReference(conf, ref))
+  {
+    return 1;
+  }
+
+  VehicleConf vc;
+  int turnleft_ispositive = 1;
+  vc.lf                   = 1.0;
+  vc.lr                   = 1.0;
+  vc.max_angle            = 40;
+  vc.turn_ratio           = 1;
+  params.getParam("/control/center2frontaxis", vc.lf);
+  params.getParam("/control/center2rearaxis", vc.lr);
+  params.getParam("/control/max_turn_angle", vc.max_angle);
+  params.getParam("/control/turn_ratio", vc.turn_ratio);
+  params.getParam("/control/turnleft_ispositive", turnleft_ispositive);
+  vc.left_sign = turnleft_ispositive == 1 ? 1 : -1;
+  if (vc.turn_ratio == 0)
+  {
+    vc.turn_ratio = 1;
+  }
+
+  SimController *controller = createController(conf.controller, params);
+  if (controller == NULL)
+  {
+    return 1;
+  }
+
+  const double dt        = 1.0 / FRE;
+  const int plan_divider = max(1, (int)round(FRE / conf.plan_rate));
+  double ref_speed       = max(0.1, conf.speed > 0 ? conf.speed : fabs(ref[ref.size() / 2].velocity));
+  double duration        = conf.duration > 0 ? conf.duration : ref.back().dist / ref_speed * 2 + 20;
+
+  //初始位姿: 参考线起点加横向/航向偏移
+  VehicleState state;
+  double h0     = ref[0].heading * DEG2RAD;
+  state.x       = ref[0].x - conf.init_lateral * cos(h0);
+  state.y       = ref[0].y + conf.init_lateral * sin(h0);
+  state.heading = wrapHeading(ref[0].heading + conf.init_heading);
+  state.v       = 0;
+  state.steer_f = 0;
+  state.steer_r = 0;
+
+  FILE *trace = NULL;
+  if (!conf.trace_file.empty())
+  {
+    trace = fopen(conf.trace_file.c_str(), "w");
+    if (trace == NULL)
+    {
+      printf("open %s error!\n", conf.trace_file.c_str());
+      delete controller;
+      return 1;
+    }
+    fprintf(trace, "t,x,y,heading,v,steer_f,steer_r,ref_index,lateral_err,heading_err,cmd_angle_f,cmd_angle_r,"
+                   "cmd_velocity,cycle_us\n");
+  }
+
+  deque< TimedCommand > pending;
+  ControlCommand applied;
+  memset(&applied, 0, sizeof(applied));
+  uint32_t last_seq = controller->command().seq;
+  double last_cmd_f = 0;
+  bool have_cmd     = false;
+
+  RunningStat lateral_stat, heading_stat, steer_rate_stat, accel_stat, path_cb_stat;
+  vector< double > cycle_us;
+  cycle_us.reserve((size_t)(duration * FRE) + 1);
+
+  size_t ref_index = findNearest(ref, state.x, state.y, 0, true);
+  bool diverged    = false;
+  bool finished    = false;
+  long cycles      = 0;
+  double wall0     = monotonicSec();
+
+  for (; sim_time - 1.0 < duration; sim_time += dt, cycles++)
+  {
+    ros::Time::setNow(ros::Time(sim_time));
+    ref_index = findNearest(ref, state.x, state.y, ref_index, false);
+
+    //局部路径,按规划频率发布
+    if (cycles % plan_divider == 0)
+    {
+      plan_msgs::DecisionInfo path_msg;
+      buildLocalPath(conf, ref, ref_index, path_msg);
+      double t0 = threadCpuUs();
+      controller->setPath(path_msg);
+      path_cb_stat.add(threadCpuUs() - t0);
+    }
+
+    //定位,车辆中心局部坐标
+    nav_msgs::Odometry odom;
+    odom.pose.pose.position.x = state.x;
+    odom.pose.pose.position.y = state.y;
+    odom.twist.twist.linear.x = fabs(state.v);
+    odom.twist.twist.angular.x = state.heading;
+    controller->setPose(odom);
+
+    double t0 = threadCpuUs();
+    controller->step();
+    double cpu = threadCpuUs() - t0;
+    cycle_us.push_back(cpu);
+
+    const ControlCommand &cmd = controller->command();
+    if (cmd.seq != last_seq)
+    {
+      last_seq = cmd.seq;
+      TimedCommand tc;
+      tc.t   = sim_time;
+      tc.cmd = cmd;
+      pending.push_back(tc);
+      if (have_cmd)
+      {
+        steer_rate_stat.add((cmd.angle_f - last_cmd_f) / dt);
+      }
+      last_cmd_f = cmd.angle_f;
+      have_cmd   = true;
+    }
+    //执行器纯延迟
+    while (!pending.empty() && pending.front().t <= sim_time - conf.act_delay + 1e-9)
+    {
+      applied = pending.front().cmd;
+      pending.pop_front();
+    }
+
+    double v_before = state.v;
+    vehicleStep(vc, conf, applied, dt, state);
+    accel_stat.add((state.v - v_before) / dt);
+
+    double lateral_err, heading_err;
+    trackingError(ref, ref_index, state, lateral_err, heading_err);
+    if (fabs(state.v) > 0.05)
+    {
+      lateral_stat.add(lateral_err);
+      heading_stat.add(heading_err);
+    }
+
+    if (trace != NULL)
+    {
+      fprintf(trace, "%.3f,%.4f,%.4f,%.3f,%.3f,%.3f,%.3f,%lu,%.4f,%.3f,%.3f,%.3f,%.3f,%.2f\n", sim_time - 1.0,
+              state.x, state.y, state.heading, state.v, state.steer_f, state.steer_r, (unsigned long)ref_index,
+              lateral_err, heading_err, cmd.angle_f, cmd.angle_r, cmd.velocity, cpu);
+    }
+
+    if (fabs(lateral_err) > 10)
+    {
+      printf("vehicle left the reference line at t=%.2f (lateral error %.2f m)\n", sim_time - 1.0, lateral_err);
+      diverged = true;
+      break;
+    }
+    if (ref.back().dist - ref[ref_index].dist < 0.3 && applied.velocity == 0 && fabs(state.v) < 0.01)
+    {
+      finished = true;
+      break;
+    }
+  }
+  double wall = monotonicSec() - wall0;
+  if (trace != NULL)
+  {
+    fclose(trace);
+  }
+  delete controller;
+
+  vector< double > sorted = cycle_us;
+  sort(sorted.begin(), sorted.end());
+  double cycle_mean = 0;
+  for (size_t i = 0; i < sorted.size(); i++)
+  {
+    cycle_mean += sorted[i];
+  }
+  double cycle_p99 = 0;
+  double cycle_max = 0;
+  if (!sorted.empty())
+  {
+    cycle_mean /= sorted.size();
+    cycle_p99 = sorted[min(sorted.size() - 1, (size_t)(sorted.size() * 0.99))];
+    cycle_max = sorted.back();
+  }
+  double sim_elapsed = cycles * dt;
+
+  printf("controller:          %s\n", conf.controller.c_str());
+  printf("reference:           %s (%lu points, %.1f m)\n",
+         conf.route_file.empty() ? conf.scenario.c_str() : conf.route_file.c_str(), (unsigned long)ref.size(),
+         ref.back().dist);
+  printf("simulated time:      %.2f s (%ld cycles), %s\n", sim_elapsed, cycles,
+         finished ? "reached end" : (diverged ? "diverged" : "timeout"));
+  printf("progress:            %.1f / %.1f m\n", ref[ref_index].dist, ref.back().dist);
+  printf("lateral error:       rms %.4f m  max %.4f m\n", lateral_stat.rms(), lateral_stat.max_abs);
+  printf("heading error:       rms %.3f deg  max %.3f deg\n", heading_stat.rms(), heading_stat.max_abs);
+  printf("steer cmd rate:      rms %.2f deg/s  max %.2f deg/s\n", steer_rate_stat.rms(), steer_rate_stat.max_abs);
+  printf("acceleration:        rms %.3f m/s2  max %.3f m/s2\n", accel_stat.rms(), accel_stat.max_abs);
+  printf("control cycle cpu:   mean %.2f us  p99 %.2f us  max %.2f us\n", cycle_mean, cycle_p99, cycle_max);
+  printf("path callback cpu:   mean %.2f us  max %.2f us\n", path_cb_stat.mean(), path_cb_stat.max_abs);
+  printf("wall time:           %.3f s (%.1fx real time)\n", wall, wall > 0 ? sim_elapsed / wall : 0);
+
+  bool pass = !diverged && finished;
+  if (!finished && !diverged)
+  {
+    printf("FAIL: reference end not reached within %.1f s\n", duration);
+  }
+  pass = checkLimit("lateral error rms", lateral_stat.rms(), conf.max_lateral_rms) && pass;
+  pass = checkLimit("max lateral error", lateral_stat.max_abs, conf.max_lateral) && pass;
+  pass = checkLimit("heading error rms", heading_stat.rms(), conf.max_heading_rms) && pass;
+  pass = checkLimit("control cycle p99", cycle_p99, conf.max_cycle_p99_us) && pass;
+  printf("%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 2;
+}
@@ -0,0 +1,69 @@
+//路径预处理耗时测试: rosrun control path_conditioner_bench [点数] [次数]
+#include "path_conditioner.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+using namespace control;
+
+namespace
+{
+double nowUs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+void run(PathConditioner &pc, const std::vector< common_msgs::PathPoint > &in, int loops, const char *name)
+{
+  std::vector< positionConf > route;
+  std::vector< int > cusps;
+  pc.condition(in, route, cusps); //预热, 分配输出
+  double total = 0, worst = 0;
+  for (int i = 0; i < loops; i++)
+  {
+    double t0 = nowUs();
+    pc.condition(in, route, cusps);
+    double dt = nowUs() - t0;
+    total += dt;
+    worst = dt > worst ? dt : worst;
+  }
+  printf("%-10s in %zu out %zu cusps %zu: avg %.1f us max %.1f us\n", name, in.size(), route.size(), cusps.size(),
+         total / loops, worst);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+  int points = argc > 1 ? atoi(argv[1]) : 200;
+  int loops  = argc > 2 ? atoi(argv[2]) : 2000;
+
+  //规划路径: 点间距1m的S形曲线, 中间一次换向
+  std::vector< common_msgs::PathPoint > in;
+  srand(1);
+  for (int i = 0; i < points; i++)
+  {
+    common_msgs::PathPoint p;
+    double s = (i < points / 2) ? i : points - i;
+    p.x      = 5 * sin(s / 15.0) + 0.05 * (rand() / (double)RAND_MAX - 0.5);
+    p.y      = s;
+    p.theta  = (i < points / 2) ? 0 : 180;
+    p.v      = (i < points / 2) ? 2.0 : -1.0;
+    in.push_back(p);
+  }
+
+  PathConditioner pc;
+  PathConditionConf conf;
+  conf.equal_length  = 0.1;
+  conf.tp_speed      = 0.3;
+  conf.outlier_angle = 150;
+  conf.smooth_window = 0;
+  pc.setConf(conf);
+  run(pc, in, loops, "plain");
+  conf.smooth_window = 21;
+  pc.setConf(conf);
+  run(pc, in, loops, "smooth21");
+  return 0;
+}
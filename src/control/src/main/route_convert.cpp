@@ -0,0 +1,109 @@
+#include "route_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace control;
+
+// 路径文件格式转换工具
+// route_convert [-r] [-o lat,lon] <文本路径文件> <二进制路径文件>   文本转二进制
+// route_convert -t <二进制路径文件> <文本路径文件>                   二进制转文本
+static void usage(const char *name)
+{
+  printf("usage: %s [-r] [-o lat,lon] <text_route> <binary_route>\n", name);
+  printf("       %s -t <binary_route> <text_route>\n", name);
+  printf("  -r  closed (ring) route\n");
+  printf("  -o  gps2xy origin stored in the header\n");
+  printf("  -t  convert binary route back to text\n");
+}
+
+static int binary2text(const char *in_path, const char *out_path)
+{
+  vector< positionConf > route;
+  if (!loadBinaryRoute(in_path, route))
+  {
+    return 1;
+  }
+  FILE *fp = fopen(out_path, "w");
+  if (fp == NULL)
+  {
+    printf("open %s error!\n", out_path);
+    return 1;
+  }
+  for (size_t i = 0; i < route.size(); i++)
+  {
+    fprintf(fp, "%u %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf %.8lf\r\n",
+            route[i].n_gps_sequence_num, route[i].x, route[i].y, route[i].z, route[i].lon, route[i].lat,
+            route[i].height, route[i].velocity, route[i].velocity_x, route[i].velocity_y, route[i].velocity_z,
+            route[i].heading, route[i].pitch, route[i].roll, route[i].dist);
+  }
+  fclose(fp);
+  printf("write %lu points to %s\n", route.size(), out_path);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  bool to_text      = false;
+  uint32_t flags    = 0;
+  double origin_lat = 0;
+  double origin_lon = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "rto:h")) != -1)
+  {
+    switch (opt)
+    {
+    case 'r':
+      flags |= ROUTE_PATH_RING;
+      break;
+    case 't':
+      to_text = true;
+      break;
+    case 'o':
+      if (sscanf(optarg, "%lf,%lf", &origin_lat, &origin_lon) != 2)
+      {
+        usage(argv[0]);
+        return 1;
+      }
+      break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (argc - optind != 2)
+  {
+    usage(argv[0]);
+    return 1;
+  }
+  const char *in_path  = argv[optind];
+  const char *out_path = argv[optind + 1];
+
+  if (to_text)
+  {
+    return binary2text(in_path, out_path);
+  }
+
+  if (isBinaryRouteFile(in_path))
+  {
+    printf("%s is already a binary route file.\n", in_path);
+    return 1;
+  }
+  vector< positionConf > route;
+  if (!loadTextRoute(in_path, route) || route.empty())
+  {
+    printf("read %s error!\n", in_path);
+    return 1;
+  }
+  if (!saveBinaryRoute(out_path, route, flags, origin_lat, origin_lon))
+  {
+    return 1;
+  }
+
+  printf("convert %lu points: %s -> %s\n", route.size(), in_path, out_path);
+  return 0;
+}
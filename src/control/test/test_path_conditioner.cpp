@@ -0,0 +1,191 @@
+#include "path_conditioner.h"
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <stdlib.h>
+
+using namespace control;
+
+namespace
+{
+common_msgs::PathPoint makePoint(double x, double y, double theta, double v)
+{
+  common_msgs::PathPoint p;
+  p.x     = x;
+  p.y     = y;
+  p.theta = theta;
+  p.v     = v;
+  return p;
+}
+
+// 航向与 control_sim 一致: atan2(dx, dy), 正北为0, 顺时针
+double travelHeading(const positionConf &a, const positionConf &b)
+{
+  double h = atan2(b.x - a.x, b.y - a.y) * 180 / M_PI;
+  return h < 0 ? h + 360 : h;
+}
+
+PathConditionConf makeConf(double equal_length, double outlier_angle, int smooth_window)
+{
+  PathConditionConf conf;
+  conf.equal_length  = equal_length;
+  conf.tp_speed      = 0;
+  conf.outlier_angle = outlier_angle;
+  conf.smooth_window = smooth_window;
+  return conf;
+}
+
+// 圆弧路径, 点间距约1m, 加入横向噪声
+std::vector< common_msgs::PathPoint > makeArc(int n, double radius, double noise, bool reverse)
+{
+  std::vector< common_msgs::PathPoint > in;
+  srand(7);
+  for (int i = 0; i < n; i++)
+  {
+    double a   = i / radius;
+    double r   = radius + noise * (rand() / (double)RAND_MAX - 0.5);
+    double x   = r * (1 - cos(a));
+    double y   = r * sin(a);
+    double hdg = a * 180 / M_PI; //沿弧切向
+    if (reverse)
+    {
+      hdg = fmod(hdg + 180, 360);
+    }
+    in.push_back(makePoint(x, y, hdg, 2.0));
+  }
+  return in;
+}
+} // namespace
+
+TEST(PathConditioner, StraightLineIsEquallySpaced)
+{
+  PathConditioner pc;
+  pc.setConf(makeConf(0.1, 0, 0));
+  std::vector< common_msgs::PathPoint > in;
+  for (int i = 0; i <= 10; i++)
+  {
+    in.push_back(makePoint(0, i, 0, 1.0));
+  }
+  std::vector< positionConf > route;
+  std::vector< int > cusps;
+  EXPECT_EQ(0, pc.condition(in, route, cusps));
+  ASSERT_EQ(101u, route.size());
+  EXPECT_TRUE(cusps.empty());
+  for (size_t i = 0; i < route.size(); i++)
+  {
+    EXPECT_NEAR(0.1 * i, route[i].y, 1e-9);
+    EXPECT_NEAR(0.0, route[i].heading, 1e-9);
+    EXPECT_NEAR(1.0, route[i].velocity, 1e-9);
+  }
+}
+
+TEST(PathConditioner, DuplicatePointsAreDropped)
+{
+  PathConditioner pc;
+  std::vector< common_msgs::PathPoint > in;
+  in.push_back(makePoint(0, 0, 0, 1));
+  in.push_back(makePoint(0, 1, 0, 1));
+  in.push_back(makePoint(0, 1, 0, 1));
+  in.push_back(makePoint(0, 2, 0, 1));
+  std::vector< positionConf > route;
+  std::vector< int > cusps;
+  EXPECT_EQ(1, pc.condition(in, route, cusps));
+  for (size_t i = 0; i < route.size(); i++)
+  {
+    EXPECT_FALSE(isnan(route[i].x) || isnan(route[i].y) || isnan(route[i].heading));
+  }
+  EXPECT_NEAR(2.0, route.back().y, 1e-9);
+}
+
+TEST(PathConditioner, ReversalIsReportedAsCusp)
+{
+  PathConditioner pc;
+  pc.setConf(makeConf(0.5, 0, 0));
+  std::vector< common_msgs::PathPoint > in;
+  in.push_back(makePoint(0, 0, 0, 1));
+  in.push_back(makePoint(0, 2, 0, 1));
+  in.push_back(makePoint(0, 2, 0, 1));   //换向处两个重合点, 保留前一个
+  in.push_back(makePoint(0, 0, 0, -1));  //倒车回到原点, 航向不变
+  in.push_back(makePoint(1, -2, 180, 1)); //再换向前进
+  std::vector< positionConf > route;
+  std::vector< int > cusps;
+  pc.condition(in, route, cusps);
+  ASSERT_EQ(1u, cusps.size());
+  EXPECT_NEAR(0.0, route[cusps[0]].x, 1e-9);
+  EXPECT_NEAR(0.0, route[cusps[0]].y, 1e-9);
+  EXPECT_NEAR(0.0, route[cusps[0]].heading, 1e-9);
+  EXPECT_NEAR(180.0, route[cusps[0] + 1].heading, 1e-9);
+}
+
+TEST(PathConditioner, SpikeIsDropped)
+{
+  PathConditioner pc;
+  pc.setConf(makeConf(0.5, 150, 0));
+  std::vector< common_msgs::PathPoint > in;
+  in.push_back(makePoint(0, 0, 0, 1));
+  in.push_back(makePoint(0, 1, 0, 1));
+  in.push_back(makePoint(0, 3, 0, 1));
+  in.push_back(makePoint(0, 2, 0, 1)); //折回的尖刺点
+  in.push_back(makePoint(0, 4, 0, 1));
+  in.push_back(makePoint(0, 5, 0, 1));
+  std::vector< positionConf > route;
+  std::vector< int > cusps;
+  EXPECT_EQ(1, pc.condition(in, route, cusps));
+  for (size_t i = 1; i < route.size(); i++)
+  {
+    EXPECT_GT(route[i].y, route[i - 1].y);
+  }
+}
+
+TEST(PathConditioner, SmoothedHeadingFollowsSmoothedGeometry)
+{
+  PathConditioner pc;
+  pc.setConf(makeConf(0.1, 0, 21));
+  std::vector< common_msgs::PathPoint > in = makeArc(40, 20.0, 0.1, false);
+  std::vector< positionConf > route;
+  std::vector< int > cusps;
+  pc.condition(in, route, cusps);
+  ASSERT_GT(route.size(), 300u);
+  double max_err = 0;
+  for (size_t i = 20; i + 20 < route.size(); i++)
+  {
+    double err = fabs(headingDifference(route[i].heading, travelHeading(route[i - 1], route[i + 1])));
+    max_err    = std::max(max_err, err);
+  }
+  EXPECT_LT(max_err, 0.5);
+}
+
+TEST(PathConditioner, SmoothedReverseSegmentKeepsReverseHeading)
+{
+  PathConditioner pc;
+  pc.setConf(makeConf(0.1, 0, 21));
+  std::vector< common_msgs::PathPoint > in = makeArc(40, 20.0, 0.1, true);
+  std::vector< positionConf > route;
+  std::vector< int > cusps;
+  pc.condition(in, route, cusps);
+  for (size_t i = 20; i + 20 < route.size(); i++)
+  {
+    double travel = travelHeading(route[i - 1], route[i + 1]);
+    EXPECT_NEAR(180.0, fabs(headingDifference(route[i].heading, travel)), 0.5);
+  }
+}
+
+TEST(PathConditioner, OutputBufferIsReused)
+{
+  PathConditioner pc;
+  std::vector< common_msgs::PathPoint > in = makeArc(40, 20.0, 0.0, false);
+  std::vector< positionConf > route;
+  std::vector< int > cusps;
+  pc.condition(in, route, cusps);
+  const positionConf *data = route.data();
+  size_t capacity          = route.capacity();
+  pc.condition(in, route, cusps);
+  EXPECT_EQ(data, route.data());
+  EXPECT_EQ(capacity, route.capacity());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -2,6 +2,7 @@
 #define DRIVERS_CAN_WR_INCLUDE_CAMERA_H_
 
 #include "can_rw.h"
+#include "can_signal.h"
 #include "driver_monitor.h"
 #include "logdata.h"
 #include "relay.h"
@@ -14,7 +15,7 @@ class CAMERA : private CANDrivers,public Driver_Monitor
 {
     typedef void (CAMERA::*pFun)(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype);
 
-    map< uint32_t, pFun > m_pHandlerMap;
+    CanDispatchTable< pFun > m_pHandlerMap;
 
     enum camera_recv_enum
     {
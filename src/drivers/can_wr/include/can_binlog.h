@@ -0,0 +1,84 @@
+#ifndef DRIVERS_CAN_WR_INCLUDE_CAN_BINLOG_H_
+#define DRIVERS_CAN_WR_INCLUDE_CAN_BINLOG_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "can_binlog_format.h"
+#include "device.h"
+#include "logmanager.h"
+
+#define CAN_BINLOG_RING_SIZE 8192          //每通道缓存帧数, 2的幂
+#define CAN_BINLOG_BLOCK_RECORDS 512       //每块最多帧数
+#define CAN_BINLOG_FLUSH_MS 200            //不满一块时的最长落盘间隔
+#define CAN_BINLOG_ROTATE_BYTES (64 << 20) //单文件最大字节数
+#define CAN_BINLOG_ROTATE_SECONDS 60       //按分钟切分, 与原 csv 日志一致
+
+//单生产者(接收线程)单消费者(写线程)无锁环形缓存
+class CanLogRing
+{
+public:
+  CanLogRing();
+  ~CanLogRing();
+
+  //缓存满时丢弃并计数
+  bool push(const CanLogRecord &record);
+  int pop(CanLogRecord *records, int max_num);
+  uint32_t size() const;
+  uint32_t takeDropCount();
+
+private:
+  std::vector< CanLogRecord > records_;
+  std::atomic< uint32_t > head_;
+  std::atomic< uint32_t > tail_;
+  std::atomic< uint32_t > drop_count_;
+};
+
+//接收线程只拷贝到缓存, 写线程按块写二进制文件
+//目录与原日志相同: ~/work/log/<sensor>/<YYYYMMDD-HH>/, 由 log_manager 按小时打包
+class CanBinLogger : public CheckDisk
+{
+public:
+  CanBinLogger(string sensor_name, string device_name, uint32_t channel);
+  ~CanBinLogger();
+
+  //读取成功(length > 0)的帧才记录
+  void write_log(const adcuCanData &can_buf, int length);
+
+private:
+  void writerLoop();
+  bool openLogFile(uint64_t stamp_ns);
+  void closeLogFile();
+  void writeBlock();
+  void dropBlock();
+  int my_mkdir(string muldir, mode_t mode);
+
+  string base_dir_path_;
+  string sensor_name_;
+  string device_name_;
+  uint32_t channel_;
+
+  CanLogRing ring_;
+  std::vector< CanLogRecord > block_;
+  std::atomic< bool > running_;
+  std::thread writer_;
+  //写线程空闲时在 writer_cond_ 上等待, 缓存攒够一块或停止时由接收线程唤醒
+  std::mutex writer_mtx_;
+  std::condition_variable writer_cond_;
+  std::atomic< bool > writer_waiting_;
+
+  FILE *log_file_;
+  uint64_t file_bytes_;
+  uint64_t file_period_;   //文件所属的切分周期序号
+  uint64_t failed_period_; //该周期打开文件失败, 不再重试
+  int file_part_;          //同一周期内按大小切分的序号
+  uint32_t lost_records_;  //写线程丢弃的帧数, 计入下一个写成功的块
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef DRIVERS_CAN_WR_INCLUDE_CAN_BINLOG_FORMAT_H_
+#define DRIVERS_CAN_WR_INCLUDE_CAN_BINLOG_FORMAT_H_
+
+#include <stdint.h>
+
+// CAN 二进制日志文件格式, 小端
+// 文件头 CanLogFileHeader, 之后为若干块: CanLogIndexBlock + record_num 个 CanLogRecord
+// 索引块带时间范围, 离线工具可按块跳过, 不必逐帧解析
+#define CAN_BINLOG_MAGIC 0x474C4E43       // "CNLG"
+#define CAN_BINLOG_INDEX_MAGIC 0x58444943 // "CIDX"
+#define CAN_BINLOG_VERSION 1
+#define CAN_BINLOG_SUFFIX ".canlog"
+
+#pragma pack(1)
+struct CanLogFileHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size;
+  uint32_t channel;
+  char sensor_name[16];
+  char device_name[16];
+  uint64_t create_stamp_ns;
+};
+
+struct CanLogIndexBlock
+{
+  uint32_t magic;
+  uint32_t record_num;
+  uint64_t first_stamp_ns;
+  uint64_t last_stamp_ns;
+  uint32_t drop_count; //本块之前丢弃的帧数: 接收线程缓存满, 或写线程打开/写入文件失败
+};
+
+struct CanLogRecord
+{
+  uint64_t stamp_ns; // CLOCK_REALTIME
+  uint32_t id;
+  uint8_t dlc;
+  uint8_t ide;
+  uint8_t rtr;
+  uint8_t reserve;
+  uint8_t data[8];
+};
+#pragma pack()
+
+#endif
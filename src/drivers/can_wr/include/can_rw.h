@@ -36,26 +36,6 @@ namespace superg_agv
 namespace drivers
 {
 
-class CANData_Output
-{
-  public:
-    CANData_Output(string &pram1);
-    ~CANData_Output();
-    // bool Openfile(string &path, string &filename);bool CANData_Output::Openfile(string &pram1, string &pram2, adcuCanData &data)
-    bool Openfile(string &pram1, string &pram2, adcuCanData &data, int &ch_);
-    bool Closefile(string &path, string &filename);
-    bool Isexistence(string &path, string &filename);
-    bool Writefile(string &path, string &filename, adcuCanData &data);
-  private:
-    ofstream logfile;
-    string filepath = "/home/higo/work/log/";
-    int min;
-    string sensor_type;
-    time_t systime;
-    struct tm *ptminfo;
-};
-
-
 class CANDrivers
 {
 
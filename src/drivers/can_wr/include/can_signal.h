@@ -0,0 +1,580 @@
+#ifndef DRIVERS_CAN_WR_INCLUDE_CAN_SIGNAL_H_
+#define DRIVERS_CAN_WR_INCLUDE_CAN_SIGNAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+namespace superg_agv
+{
+namespace drivers
+{
+
+//信号字节序
+// CAN_INTEL: 8字节按小端拼成64位, start_bit 为最低位的位置 (DBC @1)
+// CAN_MOTOROLA: 8字节按大端拼成64位, start_bit 为从 byte0 最高位数起的位置
+enum CanByteOrder
+{
+  CAN_INTEL = 0,
+  CAN_MOTOROLA
+};
+
+//信号定义, 与DBC的 SG_ 一致: 物理值 = 原始值 * factor + offset
+struct CanSignal
+{
+  uint8_t start_bit;
+  uint8_t length;
+  uint8_t byte_order;
+  uint8_t is_signed;
+  double factor;
+  double offset;
+};
+
+//报文定义, 按报文类型索引; CAN ID 到解析函数的分发由各传感器的 m_pHandlerMap (CanDispatchTable) 完成
+struct CanMessageDef
+{
+  int type;
+  const CanSignal *signals;
+  int signal_num;
+};
+
+inline uint32_t canSignalRaw(const uint8_t *can_data, const CanSignal &signal)
+{
+  uint64_t payload = 0;
+  uint64_t raw     = 0;
+  if (signal.byte_order == CAN_INTEL)
+  {
+    for (int i = 7; i >= 0; i--)
+    {
+      payload = (payload << 8) | can_data[i];
+    }
+    raw = payload >> signal.start_bit;
+  }
+  else
+  {
+    for (int i = 0; i < 8; i++)
+    {
+      payload = (payload << 8) | can_data[i];
+    }
+    raw = payload >> (64 - signal.start_bit - signal.length);
+  }
+  return ( uint32_t )(raw & ((1ull << signal.length) - 1));
+}
+
+inline double canSignalValue(const uint8_t *can_data, const CanSignal &signal)
+{
+  uint32_t raw = canSignalRaw(can_data, signal);
+  if (signal.is_signed && (raw >> (signal.length - 1)) & 0x01)
+  {
+    return (( int64_t )raw - (1ll << signal.length)) * signal.factor + signal.offset;
+  }
+  return raw * signal.factor + signal.offset;
+}
+
+/****************超声波********************/
+enum UltrasonicDataSignal
+{
+  ULTRASONIC_SIG_DISTANCE_1 = 0,
+  ULTRASONIC_SIG_DISTANCE_2,
+  ULTRASONIC_SIG_DISTANCE_3,
+  ULTRASONIC_SIG_DISTANCE_4,
+  ULTRASONIC_SIG_DISTANCE_5,
+  ULTRASONIC_SIG_DISTANCE_6,
+  ULTRASONIC_SIG_DISTANCE_7,
+  ULTRASONIC_SIG_DISTANCE_8,
+  ULTRASONIC_SIG_STATUS_1,
+  ULTRASONIC_SIG_STATUS_2,
+  ULTRASONIC_SIG_STATUS_3,
+  ULTRASONIC_SIG_STATUS_4,
+  ULTRASONIC_SIG_STATUS_5,
+  ULTRASONIC_SIG_STATUS_6,
+  ULTRASONIC_SIG_STATUS_7,
+  ULTRASONIC_SIG_STATUS_8,
+  ULTRASONIC_SIG_CONTROLLER_ID,
+  ULTRASONIC_SIG_NUM
+};
+
+/****************mobileye********************/
+enum MobileyeNumberOfObstaclesSignal
+{
+  MOBILEYE_SIG_NUMBER_OF_OBSTACLES = 0,
+  MOBILEYE_SIG_TIMESTAMP,
+  MOBILEYE_SIG_LEFT_CLOSE_RANG_CUT_IN,
+  MOBILEYE_SIG_RIGHT_CLOSE_RANG_CUT_IN,
+  MOBILEYE_SIG_GO,
+  MOBILEYE_SIG_CLOSE_CAR,
+  MOBILEYE_SIG_FAILSAFE,
+  MOBILEYE_NUMBER_OF_OBSTACLES_SIG_NUM
+};
+
+enum MobileyeObstacleDataASignal
+{
+  MOBILEYE_SIG_OBSTACLE_ID = 0,
+  MOBILEYE_SIG_OBSTACLE_POSITION_X,
+  MOBILEYE_SIG_OBSTACLE_POSITION_Y,
+  MOBILEYE_SIG_OBSTACLE_RELATIVE_VELOCITY_X,
+  MOBILEYE_SIG_OBSTACLE_TYPE,
+  MOBILEYE_SIG_OBSTACLE_STATUS,
+  MOBILEYE_SIG_OBSTACLE_BRAKE_LIGHTS,
+  MOBILEYE_SIG_CUT_IN_AND_OUT,
+  MOBILEYE_SIG_BLINKER_INFO,
+  MOBILEYE_SIG_OBSTACLE_VALID,
+  MOBILEYE_OBSTACLE_DATA_A_SIG_NUM
+};
+
+enum MobileyeObstacleDataCSignal
+{
+  MOBILEYE_SIG_OBSTACLE_ANGLE_RATE = 0,
+  MOBILEYE_SIG_OBSTACLE_SCALE_CHANGE,
+  MOBILEYE_SIG_OBJECT_ACCEL_X,
+  MOBILEYE_SIG_OBSTACLE_REPLACED,
+  MOBILEYE_SIG_OBSTACLE_ANGLE,
+  MOBILEYE_OBSTACLE_DATA_C_SIG_NUM
+};
+
+enum MobileyeObstacleDataBSignal
+{
+  MOBILEYE_SIG_OBSTACLE_LENGTH = 0,
+  MOBILEYE_SIG_OBSTACLE_WIDTH,
+  MOBILEYE_SIG_OBSTACLE_AGE,
+  MOBILEYE_SIG_OBSTACLE_LANE,
+  MOBILEYE_SIG_CIPV_FLAG,
+  MOBILEYE_SIG_RADAR_POSITION_X,
+  MOBILEYE_SIG_RADAR_VELOCITY_X,
+  MOBILEYE_SIG_RADAR_MATCH_CONFIDENCE,
+  MOBILEYE_SIG_MATCHED_RADAR_ID,
+  MOBILEYE_OBSTACLE_DATA_B_SIG_NUM
+};
+
+enum MobileyeLaneInfoAndMeasureSignal
+{
+  MOBILEYE_SIG_CONFIDENCE_LANE_LEFT = 0,
+  MOBILEYE_SIG_LDW_LEFT,
+  MOBILEYE_SIG_LANE_TYPE_LEFT,
+  MOBILEYE_SIG_DISTANCE_LANE_LEFT,
+  MOBILEYE_SIG_CONFIDENCE_LANE_RIGHT,
+  MOBILEYE_SIG_LDW_RIGHT,
+  MOBILEYE_SIG_LANE_TYPE_RIGHT,
+  MOBILEYE_SIG_DISTANCE_LANE_RIGHT,
+  MOBILEYE_LANE_INFO_AND_MEASURE_SIG_NUM
+};
+
+enum MobileyeSystemWarningSignal
+{
+  MOBILEYE_SIG_WARNING_SOUND_TYPE = 0,
+  MOBILEYE_SIG_WARNING_TIME_INDICATOR,
+  MOBILEYE_SIG_WARNING_ZERO_SPEED,
+  MOBILEYE_SIG_WARNING_HEADWAY_VALID,
+  MOBILEYE_SIG_WARNING_HEADWAY_MEASUREMENT,
+  MOBILEYE_SIG_WARNING_ERROR_VALID,
+  MOBILEYE_SIG_WARNING_ERROR_CODE,
+  MOBILEYE_SIG_WARNING_LDW_OFF,
+  MOBILEYE_SIG_WARNING_LEFT_LDW_ON,
+  MOBILEYE_SIG_WARNING_RIGHT_LDW_ON,
+  MOBILEYE_SIG_WARNING_FCW_ON,
+  MOBILEYE_SIG_WARNING_MAINTENANCE,
+  MOBILEYE_SIG_WARNING_FAILSAFE,
+  MOBILEYE_SIG_WARNING_PEDS_FCW,
+  MOBILEYE_SIG_WARNING_PEDS_IN_DZ,
+  MOBILEYE_SIG_WARNING_TAMPER_ALERT,
+  MOBILEYE_SIG_WARNING_TSR_ENABLED,
+  MOBILEYE_SIG_WARNING_TSR_WARNING_LEVEL,
+  MOBILEYE_SIG_WARNING_HEADWAY_WARNING_LEVEL,
+  MOBILEYE_SIG_WARNING_HW_REPEATABLE_ENABLED,
+  MOBILEYE_SYSTEM_WARNING_SIG_NUM
+};
+
+enum MobileyeTSRTypeAndPositionSignal
+{
+  MOBILEYE_SIG_TSR_VISION_ONLY_SIGN_TYPE = 0,
+  MOBILEYE_SIG_TSR_SUPPLEMENTARY_SIGN_TYPE,
+  MOBILEYE_SIG_TSR_SIGN_POSITION_X,
+  MOBILEYE_SIG_TSR_SIGN_POSITION_Y,
+  MOBILEYE_SIG_TSR_SIGN_POSITION_Z,
+  MOBILEYE_SIG_TSR_FILTER_TYPE,
+  MOBILEYE_TSR_TYPE_AND_POSITION_SIG_NUM
+};
+
+enum MobileyeTSRVisionDecisionSignal
+{
+  MOBILEYE_SIG_TSR_SIGN_TYPE_1 = 0,
+  MOBILEYE_SIG_TSR_SUPPLEMENTARY_SIGN_TYPE_1,
+  MOBILEYE_SIG_TSR_SIGN_TYPE_2,
+  MOBILEYE_SIG_TSR_SUPPLEMENTARY_SIGN_TYPE_2,
+  MOBILEYE_SIG_TSR_SIGN_TYPE_3,
+  MOBILEYE_SIG_TSR_SUPPLEMENTARY_SIGN_TYPE_3,
+  MOBILEYE_SIG_TSR_SIGN_TYPE_4,
+  MOBILEYE_SIG_TSR_SUPPLEMENTARY_SIGN_TYPE_4,
+  MOBILEYE_TSR_VISION_DECISION_SIG_NUM
+};
+
+enum MobileyeLightsLocationAndAnglesSignal
+{
+  MOBILEYE_SIG_LIGHTS_BNDRY_DOM_BOT_NGL_HLB = 0,
+  MOBILEYE_SIG_LIGHTS_BNDRY_DOM_NGL_LH_HLB,
+  MOBILEYE_SIG_LIGHTS_BNDRY_DOM_NGL_RH_HLB,
+  MOBILEYE_SIG_LIGHTS_OBJ_DIST_HLB,
+  MOBILEYE_SIG_LIGHTS_ST_BNDRY_DOM_BOT_NGL_HLB,
+  MOBILEYE_SIG_LIGHTS_ST_BNDRY_DOM_NGL_LH_HLB,
+  MOBILEYE_SIG_LIGHTS_ST_BNDRY_DOM_NGL_RH_HLB,
+  MOBILEYE_SIG_LIGHTS_ST_OBJ_DIST_HLB,
+  MOBILEYE_SIG_LIGHTS_LEFT_TARGET_CHANGE,
+  MOBILEYE_SIG_LIGHTS_RIGHT_TARGET_CHANGE,
+  MOBILEYE_SIG_LIGHTS_TOO_MANY_CARS,
+  MOBILEYE_SIG_LIGHTS_BUSY_SCENE,
+  MOBILEYE_LIGHTS_LOCATION_AND_ANGLES_SIG_NUM
+};
+
+enum MobileyeLaneInfoMeasureSignal
+{
+  MOBILEYE_SIG_LANE_CURVATURE = 0,
+  MOBILEYE_SIG_LANE_HEADING,
+  MOBILEYE_SIG_CA_CONSTRUCTION_AREA,
+  MOBILEYE_SIG_RIGHT_LDW_AVAILABILITY,
+  MOBILEYE_SIG_LEFT_LDW_AVAILABILITY,
+  MOBILEYE_SIG_YAW_ANGLE,
+  MOBILEYE_SIG_PITCH_ANGLE,
+  MOBILEYE_LANE_INFO_MEASURE_SIG_NUM
+};
+
+enum MobileyeSignalsStatusSignal
+{
+  MOBILEYE_SIG_BRAKE_SIGNAL = 0,
+  MOBILEYE_SIG_LEFT_SIGNAL,
+  MOBILEYE_SIG_RIGHT_SIGNAL,
+  MOBILEYE_SIG_WIPERS,
+  MOBILEYE_SIG_LOW_BEAM,
+  MOBILEYE_SIG_HIGH_BEAM,
+  MOBILEYE_SIG_WIPERS_AVAILABLE,
+  MOBILEYE_SIG_LOW_BEAM_AVAILABLE,
+  MOBILEYE_SIG_HIGH_BEAM_AVAILABLE,
+  MOBILEYE_SIG_SPEED_AVAILABLE,
+  MOBILEYE_SIG_SPEED,
+  MOBILEYE_SIGNALS_STATUS_SIG_NUM
+};
+
+// LKA 左右车道线及各条 next lane 共用
+enum MobileyeLKALaneASignal
+{
+  MOBILEYE_SIG_LKA_LANE_TYPE = 0,
+  MOBILEYE_SIG_LKA_QUALITY,
+  MOBILEYE_SIG_LKA_MODEL_DEGREE,
+  MOBILEYE_SIG_LKA_POSITION_C0,
+  MOBILEYE_SIG_LKA_CURVATURE_C2,
+  MOBILEYE_SIG_LKA_CURVATURE_DERIVATIVE_C3,
+  MOBILEYE_SIG_LKA_WIDTH_MARKING,
+  MOBILEYE_LKA_LANE_A_SIG_NUM
+};
+
+enum MobileyeLKALaneBSignal
+{
+  MOBILEYE_SIG_LKA_HEADING_ANGLE_C1 = 0,
+  MOBILEYE_SIG_LKA_VIEW_RANGE,
+  MOBILEYE_SIG_LKA_VIEW_RANGE_AVAILABILITY,
+  MOBILEYE_LKA_LANE_B_SIG_NUM
+};
+
+enum MobileyeReferencePointsSignal
+{
+  MOBILEYE_SIG_REF_POINT_1_POSITION = 0,
+  MOBILEYE_SIG_REF_POINT_1_DISTANCE,
+  MOBILEYE_SIG_REF_POINT_1_VALIDITY,
+  MOBILEYE_SIG_REF_POINT_2_POSITION,
+  MOBILEYE_SIG_REF_POINT_2_DISTANCE,
+  MOBILEYE_SIG_REF_POINT_2_VALIDITY,
+  MOBILEYE_REFERENCE_POINTS_SIG_NUM
+};
+
+enum MobileyeNumberOfNextLaneSignal
+{
+  MOBILEYE_SIG_NUMBER_OF_NEXT_LANE_MARKERS = 0,
+  MOBILEYE_NUMBER_OF_NEXT_LANE_SIG_NUM
+};
+
+/****************p2********************/
+// P2 组合导航报文为大端
+enum P2TimeSignal
+{
+  P2_SIG_GPS_WEEK = 0,
+  P2_SIG_GPS_TIME,
+  P2_TIME_SIG_NUM
+};
+
+// x/y/z 三轴各20位, 角速度/加速度的原始值与车体系报文共用
+enum P2Axis3Signal
+{
+  P2_SIG_X = 0,
+  P2_SIG_Y,
+  P2_SIG_Z,
+  P2_AXIS3_SIG_NUM
+};
+
+enum P2InsStatusSignal
+{
+  P2_SIG_SYSTEM_STATUS = 0,
+  P2_SIG_GPS_NUM_STATUS,
+  P2_SIG_SATELLITE_STATUS,
+  P2_INS_STATUS_SIG_NUM
+};
+
+enum P2LatitudeLongitudeSignal
+{
+  P2_SIG_POS_LAT = 0,
+  P2_SIG_POS_LON,
+  P2_LATITUDE_LONGITUDE_SIG_NUM
+};
+
+enum P2AltitudeSignal
+{
+  P2_SIG_POS_ALT = 0,
+  P2_ALTITUDE_SIG_NUM
+};
+
+// e/n/u 三向各16位
+enum P2EnuSignal
+{
+  P2_SIG_E = 0,
+  P2_SIG_N,
+  P2_SIG_U,
+  P2_ENU_SIG_NUM
+};
+
+// e/n/u 及合速度各16位
+enum P2VelocitySignal
+{
+  P2_SIG_VEL_E = 0,
+  P2_SIG_VEL_N,
+  P2_SIG_VEL_U,
+  P2_SIG_VEL,
+  P2_VELOCITY_SIG_NUM
+};
+
+enum P2HeadingPitchRollSignal
+{
+  P2_SIG_HEADING = 0,
+  P2_SIG_PITCH,
+  P2_SIG_ROLL,
+  P2_HEADING_PITCH_ROLL_SIG_NUM
+};
+
+/****************camera********************/
+//相机报文为大端, 与 protocol.h 中 ObjectStr/laneStr 位域顺序一致
+enum CameraObjectHeadSignal
+{
+  CAMERA_SIG_OBJECT_NUM = 0,
+  CAMERA_SIG_OBJECT_TIME,
+  CAMERA_OBJECT_HEAD_SIG_NUM
+};
+
+enum CameraObjectData0Signal
+{
+  CAMERA_SIG_OBJECT_ID = 0,
+  CAMERA_SIG_OBJECT_CLASS,
+  CAMERA_SIG_OBJECT_CONFIDENCE,
+  CAMERA_SIG_OBJECT_VELOCITY,
+  CAMERA_SIG_OBJECT_POSITION_X,
+  CAMERA_SIG_OBJECT_POSITION_Y,
+  CAMERA_OBJECT_DATA_0_SIG_NUM
+};
+
+enum CameraObjectData1Signal
+{
+  CAMERA_SIG_OBJECT_1_ID = 0,
+  CAMERA_SIG_OBJECT_WIDTH,
+  CAMERA_SIG_OBJECT_POLYGON_Y_MIN,
+  CAMERA_SIG_OBJECT_POLYGON_Y_MAX,
+  CAMERA_SIG_OBJECT_POLYGON_X_MIN,
+  CAMERA_SIG_OBJECT_POLYGON_X_MAX,
+  CAMERA_OBJECT_DATA_1_SIG_NUM
+};
+
+enum CameraLaneHeadSignal
+{
+  CAMERA_SIG_LANE_NUM = 0,
+  CAMERA_SIG_LANE_TIME,
+  CAMERA_LANE_HEAD_SIG_NUM
+};
+
+enum CameraLaneData0Signal
+{
+  CAMERA_SIG_LANE_ID = 0,
+  CAMERA_SIG_LANE_SLOPE,
+  CAMERA_SIG_LANE_DISTANCE,
+  CAMERA_SIG_LANE_START_POINT,
+  CAMERA_SIG_LANE_END_POINT,
+  CAMERA_LANE_DATA_0_SIG_NUM
+};
+
+enum CameraLaneData1Signal
+{
+  CAMERA_SIG_LANE_POLYNOMIAL_A = 0,
+  CAMERA_SIG_LANE_POLYNOMIAL_B,
+  CAMERA_SIG_LANE_POLYNOMIAL_C,
+  CAMERA_SIG_LANE_POLYNOMIAL_D,
+  CAMERA_SIG_LANE_1_ID,
+  CAMERA_LANE_DATA_1_SIG_NUM
+};
+
+//报文类型
+enum CanMessageType
+{
+  CAN_MSG_ULTRASONIC_DATA = 0,
+  CAN_MSG_MOBILEYE_NUMBER_OF_OBSTACLES,
+  CAN_MSG_MOBILEYE_OBSTACLE_DATA_A,
+  CAN_MSG_MOBILEYE_OBSTACLE_DATA_C,
+  CAN_MSG_CAMERA_OBJECT_HEAD,
+  CAN_MSG_CAMERA_OBJECT_DATA_0,
+  CAN_MSG_CAMERA_OBJECT_DATA_1,
+  CAN_MSG_CAMERA_LANE_HEAD,
+  CAN_MSG_CAMERA_LANE_DATA_0,
+  CAN_MSG_CAMERA_LANE_DATA_1,
+  CAN_MSG_MOBILEYE_OBSTACLE_DATA_B,
+  CAN_MSG_MOBILEYE_LANE_INFO_AND_MEASURE,
+  CAN_MSG_MOBILEYE_SYSTEM_WARNING,
+  CAN_MSG_MOBILEYE_TSR_TYPE_AND_POSITION,
+  CAN_MSG_MOBILEYE_TSR_VISION_DECISION,
+  CAN_MSG_MOBILEYE_LIGHTS_LOCATION_AND_ANGLES,
+  CAN_MSG_MOBILEYE_LANE_INFO_MEASURE,
+  CAN_MSG_MOBILEYE_SIGNALS_STATUS,
+  CAN_MSG_MOBILEYE_LKA_LANE_A,
+  CAN_MSG_MOBILEYE_LKA_LANE_B,
+  CAN_MSG_MOBILEYE_REFERENCE_POINTS,
+  CAN_MSG_MOBILEYE_NUMBER_OF_NEXT_LANE,
+  CAN_MSG_P2_TIME,
+  CAN_MSG_P2_ANG_RATE_RAW_IMU,
+  CAN_MSG_P2_ACCEL_IMU_RAW,
+  CAN_MSG_P2_INS_STATUS,
+  CAN_MSG_P2_LATITUDE_LONGITUDE,
+  CAN_MSG_P2_ALTITUDE,
+  CAN_MSG_P2_POS_SIGMA,
+  CAN_MSG_P2_VELOCITY_LEVEL,
+  CAN_MSG_P2_VELOCITY_LEVEL_SIGMA,
+  CAN_MSG_P2_ACCEL_VEHICLE,
+  CAN_MSG_P2_HEADING_PITCH_ROLL,
+  CAN_MSG_P2_HEADING_PITCH_ROLL_SIGMA,
+  CAN_MSG_P2_ANG_RATE_VEHICLE,
+  CAN_MSG_TYPE_NUM
+};
+
+//按报文类型顺序排列, can_message_db[type].type == type
+extern const CanMessageDef can_message_db[CAN_MSG_TYPE_NUM];
+
+inline void canDecodeMessage(const CanMessageDef &message, const uint8_t *can_data, double *values)
+{
+  for (int i = 0; i < message.signal_num; i++)
+  {
+    values[i] = canSignalValue(can_data, message.signals[i]);
+  }
+}
+
+//调用方已按ID分发, 按报文类型解码, 未定义的类型返回false
+inline bool canDecodeType(int type, const uint8_t *can_data, double *values)
+{
+  if (type < 0 || type >= CAN_MSG_TYPE_NUM)
+  {
+    return false;
+  }
+  canDecodeMessage(can_message_db[type], can_data, values);
+  return true;
+}
+
+//逐个信号写入消息结构体的字段, 位域字段无法取地址, 每个字段一个赋值函数
+template < typename T >
+struct CanFieldSetter
+{
+  typedef void (*Fn)(T &msg, double value);
+};
+
+#define CAN_FIELD(T, field) [](T &msg, double value) { msg.field = value; }
+
+// setters 按报文的信号枚举顺序排列, 数量与 signal_num 一致
+template < typename T >
+inline bool canDecodeInto(int type, const uint8_t *can_data, const typename CanFieldSetter< T >::Fn *setters, T &msg)
+{
+  if (type < 0 || type >= CAN_MSG_TYPE_NUM)
+  {
+    return false;
+  }
+  const CanMessageDef &message = can_message_db[type];
+  for (int i = 0; i < message.signal_num; i++)
+  {
+    setters[i](msg, canSignalValue(can_data, message.signals[i]));
+  }
+  return true;
+}
+
+//标准帧11位ID
+#define CAN_STANDARD_ID_NUM 0x800
+
+//按 CAN ID 分发的处理函数表: 标准帧按ID直接下标, 扩展帧查 map
+//与 map::insert 一致, 已添加的ID不覆盖; 未添加的ID返回 Handler() (空指针)
+template < typename Handler >
+class CanDispatchTable
+{
+public:
+  CanDispatchTable() : standard_(CAN_STANDARD_ID_NUM, Handler()), size_(0) {}
+
+  bool add(uint32_t can_id, Handler handler)
+  {
+    if (can_id < CAN_STANDARD_ID_NUM)
+    {
+      if (standard_[can_id] != Handler())
+      {
+        return false;
+      }
+      standard_[can_id] = handler;
+    }
+    else if (!extended_.insert(std::make_pair(can_id, handler)).second)
+    {
+      return false;
+    }
+    size_++;
+    return true;
+  }
+
+  Handler find(uint32_t can_id) const
+  {
+    if (can_id < CAN_STANDARD_ID_NUM)
+    {
+      return standard_[can_id];
+    }
+    typename std::map< uint32_t, Handler >::const_iterator it = extended_.find(can_id);
+    return it == extended_.end() ? Handler() : it->second;
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  //已添加的ID, 升序
+  std::vector< uint32_t > ids() const
+  {
+    std::vector< uint32_t > result;
+    for (uint32_t can_id = 0; can_id < CAN_STANDARD_ID_NUM; can_id++)
+    {
+      if (standard_[can_id] != Handler())
+      {
+        result.push_back(can_id);
+      }
+    }
+    typename std::map< uint32_t, Handler >::const_iterator it;
+    for (it = extended_.begin(); it != extended_.end(); ++it)
+    {
+      result.push_back(it->first);
+    }
+    return result;
+  }
+
+private:
+  std::vector< Handler > standard_;
+  std::map< uint32_t, Handler > extended_;
+  size_t size_;
+};
+
+} // namespace drivers
+} // namespace superg_agv
+
+#endif
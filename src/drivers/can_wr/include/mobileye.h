@@ -2,7 +2,8 @@
 #define DRIVERS_CAN_WR_INCLUDE_MOBILEYE_H_
 
 #include "can_rw.h"
-#include "logdata.h"
+#include "can_signal.h"
+#include "can_binlog.h"
 
 namespace superg_agv
 {
@@ -25,7 +26,7 @@ class MOBILEYE:private CANDrivers
 {
     typedef void (MOBILEYE::*pFun)(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype);
     
-    map <uint32_t, pFun> m_pHandlerMap;
+    CanDispatchTable<pFun> m_pHandlerMap;
     private:
         std::mutex mtx_mobileye;
         std::condition_variable cond_mobileye;
@@ -3,7 +3,8 @@
 
 #include "can_rw.h"
 #include "driver_monitor.h"
-#include "logdata.h"
+#include "can_binlog.h"
+#include "can_signal.h"
 
 namespace superg_agv
 {
@@ -13,7 +14,7 @@ class P2:private CANDrivers,public Driver_Monitor
 {
     typedef void (P2::*pFun)(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype);
 
-    map< uint32_t, pFun > m_pHandlerMap;
+    CanDispatchTable< pFun > m_pHandlerMap;
   private:
     std::mutex mtx_p2;
     std::mutex mtx_p2_data;
@@ -2,8 +2,9 @@
 #define DRIVERS_CAN_WR_INCLUDE_SENSOR_H_
 
 #include "can_rw.h"
+#include "can_signal.h"
 #include "driver_monitor.h"
-#include "logdata.h"
+#include "can_binlog.h"
 #include <Eigen/Dense>
 #include "power_control_msgs/PowerControlCmd.h"
 
@@ -53,7 +54,7 @@ class ULTRASONIC:private CANDrivers,public Driver_Monitor,public Ultra2Car
 {
     // typedef void (SENSOR::*pFun)(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype);
     typedef void (ULTRASONIC::*pFun)(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype);
-    map< uint32_t, pFun > m_pHandlerMap;
+    CanDispatchTable< pFun > m_pHandlerMap;
 
     enum 
     {
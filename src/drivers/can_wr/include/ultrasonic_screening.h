@@ -0,0 +1,129 @@
+#ifndef DECESION_ULTRASONIC_SCREENING_H_
+#define DECESION_ULTRASONIC_SCREENING_H_
+
+#include <stdint.h>
+
+namespace superg_agv
+{
+
+#define ULTRASONIC_SENSOR_NUM 32 //探头编号 0~31, 每个探头占掩码的一位
+
+//区域顺序与原 b_Array_Area 一致：前，左，后，右
+enum UltrasonicArea
+{
+    ULT_AREA_FRONT = 0,
+    ULT_AREA_LEFT,
+    ULT_AREA_TAIL,
+    ULT_AREA_RIGHT,
+    ULT_AREA_NUM
+};
+
+enum UltrasonicGear
+{
+    ULT_GEAR_FORWARD = 0, // Dir_PRND 1
+    ULT_GEAR_REVERSE,     // Dir_PRND 4
+    ULT_GEAR_OTHER,       //驻车/空挡，不关注任何区域
+    ULT_GEAR_NUM
+};
+
+enum UltrasonicSteer
+{
+    ULT_STEER_STRAIGHT = 0, //直行
+    ULT_STEER_TURN_LEFT,    //单桥左转
+    ULT_STEER_TURN_RIGHT,   //单桥右转
+    ULT_STEER_CRAB_LEFT,    //前后同向，左斜行
+    ULT_STEER_CRAB_RIGHT,   //前后同向，右斜行
+    ULT_STEER_COUNTER,      //前后反向，大角度转向
+    ULT_STEER_NUM
+};
+
+enum UltrasonicSpeed
+{
+    ULT_SPEED_STOP = 0,
+    ULT_SPEED_LOW,
+    ULT_SPEED_HIGH,
+    ULT_SPEED_NUM
+};
+
+struct UltrasonicScreeningConfig
+{
+    uint32_t area_sensor_mask[ULT_AREA_NUM]; //各区域包含的探头
+    float steer_deadband;                    //前后桥转角小于该值按0处理, deg
+    float speed_stop;                        //车速低于该值视为静止, m/s
+    float speed_high;                        //车速高于该值按高速处理, m/s
+    float stop_distance[ULT_SPEED_NUM];      //各速度档的停车距离, m
+    float release_margin;                    //解除停车时距离需大于停车时速度档的 stop_distance + release_margin, m
+    uint32_t stop_hold_ms;                   //命中持续该时间才停车, 0 为立即停车
+    uint32_t release_hold_ms;                //连续无命中该时间才解除停车
+    uint32_t data_timeout_ms;                //超声波数据超时, 超时按停车处理
+    uint32_t status_timeout_ms;              // agv状态超时, 超时按停车处理
+
+    UltrasonicScreeningConfig();
+};
+
+struct UltrasonicDecision
+{
+    bool stop;            //输出停车
+    bool timeout;         //输入超时导致的停车
+    uint32_t active_mask; //当前关注的探头
+    uint32_t hit_mask;    //关注区域内的障碍物/故障探头
+};
+
+//超声波关注区域筛选
+//按(档位, 转向)预先计算关注探头的掩码, 超声波数据到达时按速度档生成障碍物掩码,
+//每个决策周期只需一次按位与, 不依赖 ros, 输入时间为单调时钟毫秒
+class UltrasonicScreening
+{
+public:
+    UltrasonicScreening();
+    ~UltrasonicScreening();
+
+    void init(const UltrasonicScreeningConfig &config);
+
+    static UltrasonicGear quantizeGear(int dir_prnd);
+    UltrasonicSteer quantizeSteer(float agl_r, float agl_f) const;
+    UltrasonicSpeed quantizeSpeed(float speed) const;
+    uint32_t getActiveMask(UltrasonicGear gear, UltrasonicSteer steer) const
+    {
+        return active_mask_[gear][steer];
+    }
+
+    // agv状态, 对应 AGVStatus 的 Dir_PRND/ActualAgl_R/ActualAgl_F/ActualSpd
+    void updateStatus(int dir_prnd, float agl_r, float agl_f, float speed, uint64_t now_ms);
+    //一帧超声波数据, status 为 true 表示探头故障; 编号超出 0~31 的忽略
+    void beginDetection();
+    void addDetection(uint32_t id, float distance, bool status);
+    void endDetection(uint64_t now_ms);
+
+    //每个决策周期调用一次
+    UltrasonicDecision decide(uint64_t now_ms);
+
+private:
+    static uint32_t areaBits(UltrasonicGear gear, UltrasonicSteer steer);
+
+    UltrasonicScreeningConfig config_;
+    uint32_t active_mask_[ULT_GEAR_NUM][ULT_STEER_NUM];
+
+    UltrasonicGear gear_;
+    UltrasonicSteer steer_;
+    UltrasonicSpeed speed_;
+    uint64_t status_ms_;
+    bool status_valid_;
+
+    //障碍物掩码: [速度档][0 按停车距离, 1 按解除距离]
+    uint32_t near_mask_[ULT_SPEED_NUM][2];
+    uint32_t fault_mask_;
+    uint32_t pending_near_[ULT_SPEED_NUM][2];
+    uint32_t pending_fault_;
+    uint64_t detection_ms_;
+    bool detection_valid_;
+
+    bool stop_;
+    UltrasonicSpeed stop_speed_; //停车时的速度档, 停车后车速降为0也按该档的解除距离判断
+    bool hit_last_;
+    uint64_t hit_since_ms_;
+    uint64_t clear_since_ms_;
+};
+
+} // namespace superg_agv
+#endif
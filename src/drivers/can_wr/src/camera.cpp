@@ -10,47 +10,47 @@ CAMERA::CAMERA()
   // Camera_stat = Getstatus_Camera;
   //二院
   // 124全部启动
-  m_pHandlerMap.insert(make_pair(ALL_START_WORK, &CAMERA::cameraAllStartWork));
+  m_pHandlerMap.add(ALL_START_WORK, &CAMERA::cameraAllStartWork);
   // 125
-  m_pHandlerMap.insert(make_pair(ALL_GET_STATUS, &CAMERA::cameraAllGetStatus));
+  m_pHandlerMap.add(ALL_GET_STATUS, &CAMERA::cameraAllGetStatus);
   // 126
-  m_pHandlerMap.insert(make_pair(ALL_STOP_ACQUIRE, &CAMERA::cameraAllStopAcquire));
+  m_pHandlerMap.add(ALL_STOP_ACQUIRE, &CAMERA::cameraAllStopAcquire);
   for (size_t loop_i = 0; loop_i < MAX_CAMERA_NUM; loop_i++)
   {
     // 300 301 302
-    m_pHandlerMap.insert(make_pair(CAMERA_START_WORK + (loop_i + 1) * 10, &CAMERA::cameraStartWork));
-    m_pHandlerMap.insert(make_pair(CAMERA_STOP_WORK + (loop_i + 1) * 10, &CAMERA::cameraStopWork));
-    m_pHandlerMap.insert(make_pair(CAMERA_WORK_STATUS + (loop_i + 1) * 10, &CAMERA::cameraWorkStatusParse));
+    m_pHandlerMap.add(CAMERA_START_WORK + (loop_i + 1) * 10, &CAMERA::cameraStartWork);
+    m_pHandlerMap.add(CAMERA_STOP_WORK + (loop_i + 1) * 10, &CAMERA::cameraStopWork);
+    m_pHandlerMap.add(CAMERA_WORK_STATUS + (loop_i + 1) * 10, &CAMERA::cameraWorkStatusParse);
     // 200 201 202
     if ((loop_i + 1) == CAMERA_LANE_2 || (loop_i + 1) == CAMERA_LANE_4)
     {
       // 200 201 202
-      m_pHandlerMap.insert(make_pair(CAMERA_DATA_HEAD + (loop_i + 1) * 10, &CAMERA::laneHeadParse));
-      m_pHandlerMap.insert(make_pair(CAMERA_DATA_0 + (loop_i + 1) * 10, &CAMERA::laneDataFirstParse));
-      m_pHandlerMap.insert(make_pair(CAMERA_DATA_1 + (loop_i + 1) * 10, &CAMERA::laneDataSecondParse));
-      m_pHandlerMap.insert(make_pair(CAMERA_MAT_HEAD + (loop_i + 1) * 10, &CAMERA::matHeadParse));
-      m_pHandlerMap.insert(make_pair(CAMERA_MAT_RAW + (loop_i + 1) * 10, &CAMERA::matRawParse));
-      m_pHandlerMap.insert(make_pair(CAMERA_MAT_TAIL + (loop_i + 1) * 10, &CAMERA::matTailParse));
+      m_pHandlerMap.add(CAMERA_DATA_HEAD + (loop_i + 1) * 10, &CAMERA::laneHeadParse);
+      m_pHandlerMap.add(CAMERA_DATA_0 + (loop_i + 1) * 10, &CAMERA::laneDataFirstParse);
+      m_pHandlerMap.add(CAMERA_DATA_1 + (loop_i + 1) * 10, &CAMERA::laneDataSecondParse);
+      m_pHandlerMap.add(CAMERA_MAT_HEAD + (loop_i + 1) * 10, &CAMERA::matHeadParse);
+      m_pHandlerMap.add(CAMERA_MAT_RAW + (loop_i + 1) * 10, &CAMERA::matRawParse);
+      m_pHandlerMap.add(CAMERA_MAT_TAIL + (loop_i + 1) * 10, &CAMERA::matTailParse);
     }
     else
     {
       // 200 201 202
-      m_pHandlerMap.insert(make_pair(CAMERA_DATA_HEAD + (loop_i + 1) * 10, &CAMERA::objectHeadParse));
-      m_pHandlerMap.insert(make_pair(CAMERA_DATA_0 + (loop_i + 1) * 10, &CAMERA::objectDataFirstParse));
-      m_pHandlerMap.insert(make_pair(CAMERA_DATA_1 + (loop_i + 1) * 10, &CAMERA::objectDataSecondParse));
-      m_pHandlerMap.insert(make_pair(CAMERA_MAT_HEAD + (loop_i + 1) * 10, &CAMERA::matHeadParse));
-      m_pHandlerMap.insert(make_pair(CAMERA_MAT_RAW + (loop_i + 1) * 10, &CAMERA::matRawParse));
-      m_pHandlerMap.insert(make_pair(CAMERA_MAT_TAIL + (loop_i + 1) * 10, &CAMERA::matTailParse));
+      m_pHandlerMap.add(CAMERA_DATA_HEAD + (loop_i + 1) * 10, &CAMERA::objectHeadParse);
+      m_pHandlerMap.add(CAMERA_DATA_0 + (loop_i + 1) * 10, &CAMERA::objectDataFirstParse);
+      m_pHandlerMap.add(CAMERA_DATA_1 + (loop_i + 1) * 10, &CAMERA::objectDataSecondParse);
+      m_pHandlerMap.add(CAMERA_MAT_HEAD + (loop_i + 1) * 10, &CAMERA::matHeadParse);
+      m_pHandlerMap.add(CAMERA_MAT_RAW + (loop_i + 1) * 10, &CAMERA::matRawParse);
+      m_pHandlerMap.add(CAMERA_MAT_TAIL + (loop_i + 1) * 10, &CAMERA::matTailParse);
     }
   }
   for (uint16_t loop_i = CAMERA_MAT_DATA_BEGIN; loop_i <= CAMERA_MAT_DATA_END; ++loop_i)
   {
-    m_pHandlerMap.insert(make_pair(loop_i, &CAMERA::matDataParse));
+    m_pHandlerMap.add(loop_i, &CAMERA::matDataParse);
   }
-  map< uint32_t, pFun >::iterator it;
-  for (it = m_pHandlerMap.begin(); it != m_pHandlerMap.end(); ++it)
+  std::vector< uint32_t > keys = m_pHandlerMap.ids();
+  for (size_t i = 0; i < keys.size(); ++i)
   {
-    ROS_INFO("key %u", it->first);
+    ROS_INFO("key %u", keys[i]);
   }
   for(uint16_t i = 0;i < 8;++i)
   {
@@ -126,7 +126,7 @@ void CAMERA::CANCamera(int &ch_, int &dev_)
     }
     adcuCanData canbuf_;
     int length = 0;
-    map< uint32_t, pFun >::iterator it;
+    pFun handler;
     canOrder can_order_;
 
     // ROS_INFO("Camera_stase:Work!!!");
@@ -181,10 +181,10 @@ void CAMERA::CANCamera(int &ch_, int &dev_)
               array_camera_ObjectData[sensor_index].cameraobjectinfo.clear();
             }
           }
-          it = m_pHandlerMap.find(canbuf_.id);
-          if(it != m_pHandlerMap.end())
+          handler = m_pHandlerMap.find(canbuf_.id);
+          if(handler != NULL)
           {
-            (this->*(it->second))(canbuf_, canbuf_.id, can_order_, ch_, controltype);
+            (this->*handler)(canbuf_, canbuf_.id, can_order_, ch_, controltype);
           }
           if(array_camera_ObjectData[sensor_index].recv_count >= array_camera_ObjectData[sensor_index].count)//接收到指定长度的数据体
           {
@@ -232,10 +232,10 @@ void CAMERA::CANCamera(int &ch_, int &dev_)
                   // memset(&array_camera_ObjectData[sensor_index].cameraObjectData,0,sizeof(array_camera_ObjectData[sensor_index].cameraObjectData));
             }
           }
-          it = m_pHandlerMap.find(canbuf_.id);
-          if (it != m_pHandlerMap.end())
+          handler = m_pHandlerMap.find(canbuf_.id);
+          if (handler != NULL)
           {
-            (this->*(it->second))(canbuf_, canbuf_.id, can_order_, ch_, controltype);
+            (this->*handler)(canbuf_, canbuf_.id, can_order_, ch_, controltype);
           }
           if(array_camera_LaneData[sensor_index].recv_count >= array_camera_LaneData[sensor_index].count)//接收到指定长度的数据体
           {
@@ -263,10 +263,10 @@ void CAMERA::CANCamera(int &ch_, int &dev_)
       }
       else
       {
-        it = m_pHandlerMap.find(canbuf_.id);
-        if(it != m_pHandlerMap.end())
+        handler = m_pHandlerMap.find(canbuf_.id);
+        if(handler != NULL)
         {
-          (this->*(it->second))(canbuf_, canbuf_.id, can_order_, ch_, controltype);
+          (this->*handler)(canbuf_, canbuf_.id, can_order_, ch_, controltype);
         }
         //camera status save in camerastatus[9]
       }
@@ -763,6 +763,63 @@ void CAMERA::CANCameraWrite(int &dev_, int &ch_)
   }
 }
 
+//按信号顺序写入目标结构体, 与 can_message_db 中对应报文的信号表一一对应
+static const CanFieldSetter< camera_ObjectData_state >::Fn camera_object_head_setters[] = {
+  CAN_FIELD(camera_ObjectData_state, count),
+  CAN_FIELD(camera_ObjectData_state, time)
+};
+static_assert(sizeof(camera_object_head_setters) / sizeof(camera_object_head_setters[0]) == CAMERA_OBJECT_HEAD_SIG_NUM,
+              "camera_object_head_setters 与信号数不一致");
+
+static const CanFieldSetter< cameraObjectInfo >::Fn camera_object_data_0_setters[] = {
+  CAN_FIELD(cameraObjectInfo, object_id),
+  [](cameraObjectInfo &msg, double value) { msg.obj_class = class_enum(( uint32_t )value); },
+  CAN_FIELD(cameraObjectInfo, confidence),
+  CAN_FIELD(cameraObjectInfo, velocity),
+  CAN_FIELD(cameraObjectInfo, position_x),
+  CAN_FIELD(cameraObjectInfo, position_y)
+};
+static_assert(sizeof(camera_object_data_0_setters) / sizeof(camera_object_data_0_setters[0]) == CAMERA_OBJECT_DATA_0_SIG_NUM,
+              "camera_object_data_0_setters 与信号数不一致");
+
+static const CanFieldSetter< cameraObjectInfo >::Fn camera_object_data_1_setters[] = {
+  CAN_FIELD(cameraObjectInfo, object_id),
+  CAN_FIELD(cameraObjectInfo, width),
+  CAN_FIELD(cameraObjectInfo, polygon_y_min),
+  CAN_FIELD(cameraObjectInfo, polygon_y_max),
+  CAN_FIELD(cameraObjectInfo, polygon_x_min),
+  CAN_FIELD(cameraObjectInfo, polygon_x_max)
+};
+static_assert(sizeof(camera_object_data_1_setters) / sizeof(camera_object_data_1_setters[0]) == CAMERA_OBJECT_DATA_1_SIG_NUM,
+              "camera_object_data_1_setters 与信号数不一致");
+
+static const CanFieldSetter< camera_LaneData_state >::Fn camera_lane_head_setters[] = {
+  CAN_FIELD(camera_LaneData_state, count),
+  CAN_FIELD(camera_LaneData_state, time)
+};
+static_assert(sizeof(camera_lane_head_setters) / sizeof(camera_lane_head_setters[0]) == CAMERA_LANE_HEAD_SIG_NUM,
+              "camera_lane_head_setters 与信号数不一致");
+
+static const CanFieldSetter< cameraLaneInfo >::Fn camera_lane_data_0_setters[] = {
+  CAN_FIELD(cameraLaneInfo, lane_id),
+  CAN_FIELD(cameraLaneInfo, slope),
+  CAN_FIELD(cameraLaneInfo, distance),
+  CAN_FIELD(cameraLaneInfo, start_point),
+  CAN_FIELD(cameraLaneInfo, end_point)
+};
+static_assert(sizeof(camera_lane_data_0_setters) / sizeof(camera_lane_data_0_setters[0]) == CAMERA_LANE_DATA_0_SIG_NUM,
+              "camera_lane_data_0_setters 与信号数不一致");
+
+static const CanFieldSetter< cameraLaneInfo >::Fn camera_lane_data_1_setters[] = {
+  CAN_FIELD(cameraLaneInfo, polynomial_a),
+  CAN_FIELD(cameraLaneInfo, polynomial_b),
+  CAN_FIELD(cameraLaneInfo, polynomial_c),
+  CAN_FIELD(cameraLaneInfo, polynomial_d),
+  CAN_FIELD(cameraLaneInfo, lane_id)
+};
+static_assert(sizeof(camera_lane_data_1_setters) / sizeof(camera_lane_data_1_setters[0]) == CAMERA_LANE_DATA_1_SIG_NUM,
+              "camera_lane_data_1_setters 与信号数不一致");
+
 void CAMERA::objectHeadParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_,
                              uint16_t &contype)
 {
@@ -770,15 +827,9 @@ void CAMERA::objectHeadParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &c
   {
     // ROS_INFO("recv: %d objectHeadParse", can_id);
   }
-  ObjectStrHead object_str_head_parser;
-  object_str_head_parser.obj_num = can_buf.can_data[0];
-  uint32_t value_temp_;
-  value_temp_ = ((uint32_t)(can_buf.can_data[1]) << 19) + ((uint32_t)(can_buf.can_data[2]) << 11) +
-                ((uint32_t)(can_buf.can_data[3]) << 3) + ((uint32_t)(can_buf.can_data[4]) >> 5 & 0x07);
-  object_str_head_parser.r_time = value_temp_;
-
-  array_camera_ObjectData[can_id%100/10].count = object_str_head_parser.obj_num;
-  array_camera_ObjectData[can_id%100/10].time = object_str_head_parser.r_time;
+  //信号定义见 can_signal.cpp
+  canDecodeInto(CAN_MSG_CAMERA_OBJECT_HEAD, can_buf.can_data, camera_object_head_setters,
+                array_camera_ObjectData[can_id%100/10]);
   if (can_order.reserve != 1)
   {
     // ROS_INFO("recv:%u obj time:%u", array_camera_ObjectData[can_id%100/10].count, array_camera_ObjectData[can_id%100/10].time);
@@ -791,23 +842,12 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
   {
     // ROS_INFO("recv: %d objectDataFirstParse", can_id);
   }
-  //提取
-  ObjectStr0 object_str_0_parser;
-  object_str_0_parser.id         = can_buf.can_data[0];
-  object_str_0_parser.obj_class  = can_buf.can_data[1];
-  object_str_0_parser.confidence = can_buf.can_data[2];
-  object_str_0_parser.position_x = (can_buf.can_data[5] << 4) | (can_buf.can_data[6] >> 4 & 0x0F);
-  object_str_0_parser.position_y = ((can_buf.can_data[6] & 0x0F) << 8) | can_buf.can_data[7];
-  object_str_0_parser.velocity   = (can_buf.can_data[3] << 2) | (can_buf.can_data[4] >> 6 & 0x03);
-  //赋值
+  //提取并赋值
+  uint32_t obj_class = 0;
   if (ch_ == CHANNEL_CAMERA_1)
   {
-    cameraObjectInfo_1.object_id  = object_str_0_parser.id;
-    cameraObjectInfo_1.obj_class  = class_enum(object_str_0_parser.obj_class);
-    cameraObjectInfo_1.position_x = object_str_0_parser.position_x * 0.1;
-    cameraObjectInfo_1.position_y = object_str_0_parser.position_y * 0.1;
-    cameraObjectInfo_1.velocity   = object_str_0_parser.velocity * 0.1;
-    cameraObjectInfo_1.confidence = ( float )object_str_0_parser.confidence * 0.01;
+    canDecodeInto(CAN_MSG_CAMERA_OBJECT_DATA_0, can_buf.can_data, camera_object_data_0_setters, cameraObjectInfo_1);
+    obj_class = cameraObjectInfo_1.obj_class;
     if (can_order.reserve != 1)
     {
       switch(can_id)
@@ -817,7 +857,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_1.object_id << " (" << cameraObjectInfo_1.position_x
                       << "," << cameraObjectInfo_1.position_y << ") " << cameraObjectInfo_1.velocity
-                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << obj_class);
           }
           else
           {
@@ -829,7 +869,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_1.object_id << " (" << cameraObjectInfo_1.position_x
                       << "," << cameraObjectInfo_1.position_y << ") " << cameraObjectInfo_1.velocity
-                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << obj_class);
           }
           else
           {
@@ -841,7 +881,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_1.object_id << " (" << cameraObjectInfo_1.position_x
                       << "," << cameraObjectInfo_1.position_y << ") " << cameraObjectInfo_1.velocity
-                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << obj_class);
           }
           else
           {
@@ -853,7 +893,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_1.object_id << " (" << cameraObjectInfo_1.position_x
                       << "," << cameraObjectInfo_1.position_y << ") " << cameraObjectInfo_1.velocity
-                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << obj_class);
           }
           else
           {
@@ -865,7 +905,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_1.object_id << " (" << cameraObjectInfo_1.position_x
                       << "," << cameraObjectInfo_1.position_y << ") " << cameraObjectInfo_1.velocity
-                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << obj_class);
           }
           else
           {
@@ -877,7 +917,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_1.object_id << " (" << cameraObjectInfo_1.position_x
                       << "," << cameraObjectInfo_1.position_y << ") " << cameraObjectInfo_1.velocity
-                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << obj_class);
           }
           else
           {
@@ -889,17 +929,13 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
       }
       ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_1.object_id << " (" << cameraObjectInfo_1.position_x
                       << "," << cameraObjectInfo_1.position_y << ") " << cameraObjectInfo_1.velocity
-                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_1.confidence << "class:" << obj_class);
     }
   }
   else if (ch_ == CHANNEL_CAMERA_2)
   {
-    cameraObjectInfo_2.object_id  = object_str_0_parser.id;
-    cameraObjectInfo_2.obj_class  = class_enum(object_str_0_parser.obj_class);
-    cameraObjectInfo_2.position_x = object_str_0_parser.position_x * 0.1;
-    cameraObjectInfo_2.position_y = object_str_0_parser.position_y * 0.1;
-    cameraObjectInfo_2.velocity   = object_str_0_parser.velocity * 0.1;
-    cameraObjectInfo_2.confidence = ( float )object_str_0_parser.confidence * 0.01;
+    canDecodeInto(CAN_MSG_CAMERA_OBJECT_DATA_0, can_buf.can_data, camera_object_data_0_setters, cameraObjectInfo_2);
+    obj_class = cameraObjectInfo_2.obj_class;
     if (can_order.reserve != 1)
     {
       switch(can_id)
@@ -909,7 +945,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_2.object_id << " (" << cameraObjectInfo_2.position_x
                       << "," << cameraObjectInfo_2.position_y << ") " << cameraObjectInfo_2.velocity
-                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << obj_class);
           }
           else
           {
@@ -921,7 +957,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_2.object_id << " (" << cameraObjectInfo_2.position_x
                       << "," << cameraObjectInfo_2.position_y << ") " << cameraObjectInfo_2.velocity
-                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << obj_class);
           }
           else
           {
@@ -933,7 +969,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_2.object_id << " (" << cameraObjectInfo_2.position_x
                       << "," << cameraObjectInfo_2.position_y << ") " << cameraObjectInfo_2.velocity
-                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << obj_class);
           }
           else
           {
@@ -945,7 +981,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_2.object_id << " (" << cameraObjectInfo_2.position_x
                       << "," << cameraObjectInfo_2.position_y << ") " << cameraObjectInfo_2.velocity
-                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << obj_class);
           }
           else
           {
@@ -957,7 +993,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_2.object_id << " (" << cameraObjectInfo_2.position_x
                       << "," << cameraObjectInfo_2.position_y << ") " << cameraObjectInfo_2.velocity
-                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << obj_class);
           }
           else
           {
@@ -969,7 +1005,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
           {
             ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_2.object_id << " (" << cameraObjectInfo_2.position_x
                       << "," << cameraObjectInfo_2.position_y << ") " << cameraObjectInfo_2.velocity
-                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << obj_class);
           }
           else
           {
@@ -981,7 +1017,7 @@ void CAMERA::objectDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrd
       }
       ROS_INFO_STREAM("can_id:" << can_id << ",data:" << cameraObjectInfo_2.object_id << " (" << cameraObjectInfo_2.position_x
                       << "," << cameraObjectInfo_2.position_y << ") " << cameraObjectInfo_2.velocity
-                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << object_str_0_parser.obj_class);
+                      << "m/s con:" << cameraObjectInfo_2.confidence << "class:" << obj_class);
     }
   }
 }
@@ -992,32 +1028,14 @@ void CAMERA::objectDataSecondParse(adcuCanData &can_buf, uint32_t &can_id, canOr
   {
     // ROS_INFO("recv: %d objectDataSecondParse", can_id);
   }
-  //提取
-  ObjectStr1 object_str_1_parser;
-  object_str_1_parser.id            = can_buf.can_data[0];
-  object_str_1_parser.width         = (can_buf.can_data[1] << 4) | (can_buf.can_data[2] >> 4 & 0x0F);
-  object_str_1_parser.polygon_x_min = (can_buf.can_data[5] << 4) | (can_buf.can_data[6] >> 4 & 0x0F);
-  object_str_1_parser.polygon_x_max = (can_buf.can_data[6] & 0x0F) << 8 | (can_buf.can_data[7]);
-  object_str_1_parser.polygon_y_min = (can_buf.can_data[2] & 0x0F) << 6 | (can_buf.can_data[3] >> 2 & 0xCF);
-  object_str_1_parser.polygon_y_max = (can_buf.can_data[3] & 0x03) << 8 | can_buf.can_data[4];
-  //赋值
+  //提取并赋值
   if (ch_ == CHANNEL_CAMERA_1)
   {
-    cameraObjectInfo_1.object_id     = object_str_1_parser.id;
-    cameraObjectInfo_1.width         = object_str_1_parser.width * 0.1;
-    cameraObjectInfo_1.polygon_x_min = object_str_1_parser.polygon_x_min;
-    cameraObjectInfo_1.polygon_x_max = object_str_1_parser.polygon_x_max;
-    cameraObjectInfo_1.polygon_y_min = object_str_1_parser.polygon_y_min;
-    cameraObjectInfo_1.polygon_y_max = object_str_1_parser.polygon_y_max;
+    canDecodeInto(CAN_MSG_CAMERA_OBJECT_DATA_1, can_buf.can_data, camera_object_data_1_setters, cameraObjectInfo_1);
   }
   else if (ch_ == CHANNEL_CAMERA_2)
   {
-    cameraObjectInfo_2.object_id     = object_str_1_parser.id;
-    cameraObjectInfo_2.width         = object_str_1_parser.width * 0.1;
-    cameraObjectInfo_2.polygon_x_min = object_str_1_parser.polygon_x_min;
-    cameraObjectInfo_2.polygon_x_max = object_str_1_parser.polygon_x_max;
-    cameraObjectInfo_2.polygon_y_min = object_str_1_parser.polygon_y_min;
-    cameraObjectInfo_2.polygon_y_max = object_str_1_parser.polygon_y_max;
+    canDecodeInto(CAN_MSG_CAMERA_OBJECT_DATA_1, can_buf.can_data, camera_object_data_1_setters, cameraObjectInfo_2);
   }
   if (can_order.reserve != 1)
   {
@@ -1043,17 +1061,10 @@ void CAMERA::laneHeadParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can
   {
     // ROS_INFO("recv: %d laneHeadParse", can_id);
   }
-  laneStrHead lane_str_head_parser;
-  lane_str_head_parser.lane_num = can_buf.can_data[0];
-  uint32_t value_temp_;
-  value_temp_ = ((uint32_t)(can_buf.can_data[1]) << 19) + ((uint32_t)(can_buf.can_data[2]) << 11) +
-                ((uint32_t)(can_buf.can_data[3]) << 3) + ((uint32_t)(can_buf.can_data[4]) >> 5 & 0x07);
-  lane_str_head_parser.r_time = value_temp_;
-
   if (ch_ == CHANNEL_CAMERA_1)
   {
-    array_camera_LaneData[can_id%100/10].count = lane_str_head_parser.r_time;
-    array_camera_LaneData[can_id%100/10].time  = lane_str_head_parser.r_time;
+    canDecodeInto(CAN_MSG_CAMERA_LANE_HEAD, can_buf.can_data, camera_lane_head_setters,
+                  array_camera_LaneData[can_id%100/10]);
     if (can_order.reserve != 1)
     {
       // ROS_INFO("recv:%u lane time:%u", array_camera_LaneData[can_id%100/10].count, array_camera_LaneData[can_id%100/10].time);
@@ -1061,8 +1072,8 @@ void CAMERA::laneHeadParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can
   }
   else if (ch_ == CHANNEL_CAMERA_2)
   {
-    array_camera_LaneData[can_id%100/10].count = lane_str_head_parser.r_time;
-    array_camera_LaneData[can_id%100/10].time  = lane_str_head_parser.r_time;
+    canDecodeInto(CAN_MSG_CAMERA_LANE_HEAD, can_buf.can_data, camera_lane_head_setters,
+                  array_camera_LaneData[can_id%100/10]);
     if (can_order.reserve != 1)
     {
       // ROS_INFO("recv:%u lane time:%u", array_camera_LaneData[can_id%100/10].count, array_camera_LaneData[can_id%100/10].time);
@@ -1073,20 +1084,9 @@ void CAMERA::laneDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrder
                                 uint16_t &contype)
 {
   // ROS_INFO("recv: %d laneDataFirstParse", can_id);
-  laneStr0 lane_str_0_parser;
-  lane_str_0_parser.id          = can_buf.can_data[0];
-  lane_str_0_parser.start_point = (can_buf.can_data[4]) << 8 | (can_buf.can_data[5]);
-  lane_str_0_parser.end_point   = (can_buf.can_data[6]) << 8 | (can_buf.can_data[7]);
-  lane_str_0_parser.distance    = (can_buf.can_data[2]) << 8 | (can_buf.can_data[3]);
-  lane_str_0_parser.slope       = can_buf.can_data[1];
-
   if (ch_ == CHANNEL_CAMERA_1)
   {
-    cameraLaneInfo_1.lane_id     = lane_str_0_parser.id;
-    cameraLaneInfo_1.start_point = lane_str_0_parser.start_point * 0.1;
-    cameraLaneInfo_1.end_point   = lane_str_0_parser.end_point * 0.1;
-    cameraLaneInfo_1.distance    = lane_str_0_parser.distance * 0.1;
-    cameraLaneInfo_1.slope       = lane_str_0_parser.slope;
+    canDecodeInto(CAN_MSG_CAMERA_LANE_DATA_0, can_buf.can_data, camera_lane_data_0_setters, cameraLaneInfo_1);
     if (can_order.reserve != 1)
     {
       // ROS_INFO("data:%u Y-S:%fm -- %fm --> Y-E:%fm slope:%u", cameraLaneInfo_1.lane_id, cameraLaneInfo_1.start_point,
@@ -1095,11 +1095,7 @@ void CAMERA::laneDataFirstParse(adcuCanData &can_buf, uint32_t &can_id, canOrder
   }
   else if (ch_ == CHANNEL_CAMERA_2)
   {
-    cameraLaneInfo_2.lane_id     = lane_str_0_parser.id;
-    cameraLaneInfo_2.start_point = lane_str_0_parser.start_point * 0.1;
-    cameraLaneInfo_2.end_point   = lane_str_0_parser.end_point * 0.1;
-    cameraLaneInfo_2.distance    = lane_str_0_parser.distance * 0.1;
-    cameraLaneInfo_2.slope       = lane_str_0_parser.slope;
+    canDecodeInto(CAN_MSG_CAMERA_LANE_DATA_0, can_buf.can_data, camera_lane_data_0_setters, cameraLaneInfo_2);
     if (can_order.reserve != 1)
     {
       // ROS_INFO("data:%u Y-S:%fm -- %fm --> Y-E:%fm slope:%u", cameraLaneInfo_2.lane_id, cameraLaneInfo_2.start_point,
@@ -1112,20 +1108,9 @@ void CAMERA::laneDataSecondParse(adcuCanData &can_buf, uint32_t &can_id, canOrde
                                  uint16_t &contype)
 {
   // ROS_INFO("recv: %d laneDataSecondParse", can_id);
-  laneStr1 lane_str_1_parser;
-  lane_str_1_parser.polynomial_a = (can_buf.can_data[0]) << 8 | (can_buf.can_data[1]);
-  lane_str_1_parser.polynomial_b = (can_buf.can_data[2]) << 8 | (can_buf.can_data[3]);
-  lane_str_1_parser.polynomial_c = (can_buf.can_data[4]) << 8 | (can_buf.can_data[5]);
-  lane_str_1_parser.polynomial_d = (can_buf.can_data[6]) << 8 | (can_buf.can_data[7] >> 3 & 0x1F);
-  lane_str_1_parser.id           = (can_buf.can_data[7] & 0x07);
-
   if (ch_ == CHANNEL_CAMERA_1)
   {
-    cameraLaneInfo_1.polynomial_a = lane_str_1_parser.polynomial_a * 0.1;
-    cameraLaneInfo_1.polynomial_b = lane_str_1_parser.polynomial_b * 0.1;
-    cameraLaneInfo_1.polynomial_c = lane_str_1_parser.polynomial_c * 0.1;
-    cameraLaneInfo_1.polynomial_d = lane_str_1_parser.polynomial_d * 0.1;
-    cameraLaneInfo_1.lane_id      = lane_str_1_parser.id;
+    canDecodeInto(CAN_MSG_CAMERA_LANE_DATA_1, can_buf.can_data, camera_lane_data_1_setters, cameraLaneInfo_1);
     if (can_order.reserve != 1)
     {
       array_camera_LaneData[can_id%100/10].cameralaneinfo.push_back(cameraLaneInfo_1);
@@ -1135,11 +1120,7 @@ void CAMERA::laneDataSecondParse(adcuCanData &can_buf, uint32_t &can_id, canOrde
   }
   else if (ch_ == CHANNEL_CAMERA_2)
   {
-    cameraLaneInfo_2.polynomial_a = lane_str_1_parser.polynomial_a * 0.1;
-    cameraLaneInfo_2.polynomial_b = lane_str_1_parser.polynomial_b * 0.1;
-    cameraLaneInfo_2.polynomial_c = lane_str_1_parser.polynomial_c * 0.1;
-    cameraLaneInfo_2.polynomial_d = lane_str_1_parser.polynomial_d * 0.1;
-    cameraLaneInfo_2.lane_id      = lane_str_1_parser.id;
+    canDecodeInto(CAN_MSG_CAMERA_LANE_DATA_1, can_buf.can_data, camera_lane_data_1_setters, cameraLaneInfo_2);
     if (can_order.reserve != 1)
     {
       array_camera_LaneData[can_id%100/10].cameralaneinfo.push_back(cameraLaneInfo_2);
@@ -0,0 +1,311 @@
+#include "can_binlog.h"
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <iomanip>
+#include <sstream>
+
+#define CAN_BINLOG_RING_MASK (CAN_BINLOG_RING_SIZE - 1)
+#define CAN_BINLOG_FILE_BUFFER (64 << 10)
+
+static uint64_t steadyMs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ( uint64_t )ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint64_t stampPeriod(uint64_t stamp_ns)
+{
+  return stamp_ns / 1000000000ull / CAN_BINLOG_ROTATE_SECONDS;
+}
+
+CanLogRing::CanLogRing() : records_(CAN_BINLOG_RING_SIZE), head_(0), tail_(0), drop_count_(0)
+{
+}
+
+CanLogRing::~CanLogRing()
+{
+}
+
+bool CanLogRing::push(const CanLogRecord &record)
+{
+  uint32_t head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) >= CAN_BINLOG_RING_SIZE)
+  {
+    drop_count_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  records_[head & CAN_BINLOG_RING_MASK] = record;
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+int CanLogRing::pop(CanLogRecord *records, int max_num)
+{
+  uint32_t tail = tail_.load(std::memory_order_relaxed);
+  uint32_t num  = head_.load(std::memory_order_acquire) - tail;
+  if (num > ( uint32_t )max_num)
+  {
+    num = max_num;
+  }
+  for (uint32_t i = 0; i < num; i++)
+  {
+    records[i] = records_[(tail + i) & CAN_BINLOG_RING_MASK];
+  }
+  tail_.store(tail + num, std::memory_order_release);
+  return num;
+}
+
+uint32_t CanLogRing::size() const
+{
+  return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+}
+
+uint32_t CanLogRing::takeDropCount()
+{
+  return drop_count_.exchange(0, std::memory_order_relaxed);
+}
+
+CanBinLogger::CanBinLogger(string sensor_name, string device_name, uint32_t channel)
+    : sensor_name_(sensor_name), device_name_(device_name), channel_(channel), running_(true), writer_waiting_(false),
+      log_file_(NULL), file_bytes_(0), file_period_(0), failed_period_(0), file_part_(0), lost_records_(0)
+{
+  base_dir_path_ = getenv("HOME");
+  base_dir_path_ += "/work/log";
+  block_.reserve(CAN_BINLOG_BLOCK_RECORDS);
+  writer_ = std::thread(&CanBinLogger::writerLoop, this);
+}
+
+CanBinLogger::~CanBinLogger()
+{
+  running_ = false;
+  {
+    std::lock_guard< std::mutex > lock(writer_mtx_);
+    writer_cond_.notify_one();
+  }
+  if (writer_.joinable())
+  {
+    writer_.join();
+  }
+}
+
+void CanBinLogger::write_log(const adcuCanData &can_buf, int length)
+{
+  if (length <= 0)
+  {
+    return;
+  }
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  CanLogRecord record;
+  record.stamp_ns = ( uint64_t )ts.tv_sec * 1000000000ull + ts.tv_nsec;
+  record.id       = can_buf.id;
+  record.dlc      = can_buf.dlc;
+  record.ide      = can_buf.ide;
+  record.rtr      = can_buf.rtr;
+  record.reserve  = 0;
+  memcpy(record.data, can_buf.can_data, 8);
+  if (!ring_.push(record))
+  {
+    return;
+  }
+  //与写线程的 writer_waiting_ 置位/判空配对, 保证不漏唤醒; 写线程忙时不加锁
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (writer_waiting_.load(std::memory_order_relaxed) && ring_.size() >= CAN_BINLOG_BLOCK_RECORDS)
+  {
+    std::lock_guard< std::mutex > lock(writer_mtx_);
+    writer_cond_.notify_one();
+  }
+}
+
+void CanBinLogger::writerLoop()
+{
+  CanLogRecord records[64];
+  uint64_t last_write_ms = steadyMs();
+  while (true)
+  {
+    bool stop = !running_.load();
+    int num   = ring_.pop(records, 64);
+    for (int i = 0; i < num; i++)
+    {
+      //一个块只属于一个文件
+      if (!block_.empty() && stampPeriod(records[i].stamp_ns) != stampPeriod(block_.front().stamp_ns))
+      {
+        writeBlock();
+      }
+      block_.push_back(records[i]);
+      if (block_.size() >= CAN_BINLOG_BLOCK_RECORDS)
+      {
+        writeBlock();
+        last_write_ms = steadyMs();
+      }
+    }
+    if (!block_.empty() && (stop || steadyMs() - last_write_ms >= CAN_BINLOG_FLUSH_MS))
+    {
+      writeBlock();
+      last_write_ms = steadyMs();
+    }
+    if (num == 0)
+    {
+      if (stop)
+      {
+        break;
+      }
+      //缓存不足一块时睡到下一次落盘时间, 攒够一块或停止时被唤醒
+      uint64_t wait_ms = CAN_BINLOG_FLUSH_MS;
+      if (!block_.empty())
+      {
+        uint64_t elapsed_ms = steadyMs() - last_write_ms;
+        wait_ms             = elapsed_ms < CAN_BINLOG_FLUSH_MS ? CAN_BINLOG_FLUSH_MS - elapsed_ms : 0;
+      }
+      std::unique_lock< std::mutex > lock(writer_mtx_);
+      writer_waiting_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      writer_cond_.wait_for(lock, std::chrono::milliseconds(wait_ms), [this] {
+        return ring_.size() >= CAN_BINLOG_BLOCK_RECORDS || !running_.load();
+      });
+      writer_waiting_.store(false, std::memory_order_relaxed);
+    }
+  }
+  closeLogFile();
+}
+
+void CanBinLogger::writeBlock()
+{
+  uint64_t stamp_ns = block_.front().stamp_ns;
+  uint64_t period   = stampPeriod(stamp_ns);
+  if (log_file_ == NULL || period != file_period_ || file_bytes_ >= CAN_BINLOG_ROTATE_BYTES)
+  {
+    if (log_file_ != NULL && period == file_period_)
+    {
+      file_part_++;
+    }
+    else
+    {
+      file_part_ = 0;
+    }
+    closeLogFile();
+    if (period == failed_period_ || !openLogFile(stamp_ns))
+    {
+      failed_period_ = period;
+      dropBlock();
+      return;
+    }
+  }
+
+  CanLogIndexBlock index;
+  index.magic          = CAN_BINLOG_INDEX_MAGIC;
+  index.record_num     = block_.size();
+  index.first_stamp_ns = block_.front().stamp_ns;
+  index.last_stamp_ns  = block_.back().stamp_ns;
+  index.drop_count     = ring_.takeDropCount() + lost_records_;
+  //每块落盘, log_manager 打包时文件内容完整
+  if (fwrite(&index, sizeof(index), 1, log_file_) != 1 ||
+      fwrite(&block_[0], sizeof(CanLogRecord), block_.size(), log_file_) != block_.size() || fflush(log_file_) != 0)
+  {
+    //磁盘满或IO错误: 本周期不再写, 已写出的残块由 can_log_convert 按截断处理
+    ROS_WARN("write %s log failed: %s", sensor_name_.c_str(), strerror(errno));
+    closeLogFile();
+    failed_period_ = period;
+    lost_records_  = index.drop_count;
+    dropBlock();
+    return;
+  }
+  file_bytes_ += sizeof(index) + sizeof(CanLogRecord) * block_.size();
+  lost_records_ = 0;
+  block_.clear();
+}
+
+void CanBinLogger::dropBlock()
+{
+  lost_records_ += block_.size();
+  block_.clear();
+}
+
+bool CanBinLogger::openLogFile(uint64_t stamp_ns)
+{
+  if (!checkTheDiskOnce())
+  {
+    return false;
+  }
+
+  time_t raw_time = stamp_ns / 1000000000ull;
+  struct tm tm_info;
+  localtime_r(&raw_time, &tm_info);
+
+  ostringstream dir_path_stream;
+  dir_path_stream << base_dir_path_ << '/' << sensor_name_ << '/' << 1900 + tm_info.tm_year << setw(2)
+                  << setfill('0') << 1 + tm_info.tm_mon << setw(2) << setfill('0') << tm_info.tm_mday << '-' << setw(2)
+                  << setfill('0') << tm_info.tm_hour << '/';
+  ostringstream file_name_stream;
+  file_name_stream << sensor_name_ << '-' << device_name_ << '-' << channel_ << '-' << tm_info.tm_min;
+  if (file_part_ > 0)
+  {
+    file_name_stream << '_' << file_part_;
+  }
+  file_name_stream << CAN_BINLOG_SUFFIX;
+
+  string dir_path = dir_path_stream.str();
+  if (my_mkdir(dir_path, 0777) < 0)
+  {
+    ROS_WARN("mkdir %s failed: %s", dir_path.c_str(), strerror(errno));
+    return false;
+  }
+  string file_path = dir_path + file_name_stream.str();
+  log_file_        = fopen(file_path.c_str(), "wb");
+  if (log_file_ == NULL)
+  {
+    ROS_WARN("open %s failed: %s", file_path.c_str(), strerror(errno));
+    return false;
+  }
+  setvbuf(log_file_, NULL, _IOFBF, CAN_BINLOG_FILE_BUFFER);
+
+  CanLogFileHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic       = CAN_BINLOG_MAGIC;
+  header.version     = CAN_BINLOG_VERSION;
+  header.record_size = sizeof(CanLogRecord);
+  header.channel     = channel_;
+  strncpy(header.sensor_name, sensor_name_.c_str(), sizeof(header.sensor_name) - 1);
+  strncpy(header.device_name, device_name_.c_str(), sizeof(header.device_name) - 1);
+  header.create_stamp_ns = stamp_ns;
+  if (fwrite(&header, sizeof(header), 1, log_file_) != 1)
+  {
+    ROS_WARN("write %s failed: %s", file_path.c_str(), strerror(errno));
+    closeLogFile();
+    return false;
+  }
+
+  file_bytes_  = sizeof(header);
+  file_period_ = stampPeriod(stamp_ns);
+  return true;
+}
+
+void CanBinLogger::closeLogFile()
+{
+  if (log_file_ != NULL)
+  {
+    fclose(log_file_);
+    log_file_ = NULL;
+  }
+}
+
+int CanBinLogger::my_mkdir(string muldir, mode_t mode)
+{
+  vector< string > v_str;
+  SplitString(muldir, v_str, "/");
+
+  string temp_dir;
+  for (vector< string >::size_type i = 0; i != v_str.size(); ++i)
+  {
+    temp_dir += '/' + v_str[i];
+    //已存在(包括与其它通道的写线程同时创建)视为成功
+    if (mkdir(temp_dir.c_str(), mode) < 0 && errno != EEXIST)
+    {
+      return -1;
+    }
+  }
+  return 0;
+}
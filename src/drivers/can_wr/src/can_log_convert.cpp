@@ -0,0 +1,138 @@
+// CAN 二进制日志离线转换, 输出到标准输出
+// 用法: can_log_convert [--asc] <file.canlog>...
+// 默认为 candump -l 格式, 可用 canplayer 回放; --asc 输出 Vector ASC 格式
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "can_binlog_format.h"
+
+static void printCandump(const CanLogFileHeader &header, const CanLogRecord &record)
+{
+  printf("(%llu.%06llu) can%u ", ( unsigned long long )(record.stamp_ns / 1000000000ull),
+         ( unsigned long long )(record.stamp_ns % 1000000000ull / 1000), header.channel);
+  printf(record.ide ? "%08X#" : "%03X#", record.id);
+  if (record.rtr)
+  {
+    printf("R\n");
+    return;
+  }
+  for (int i = 0; i < record.dlc && i < 8; i++)
+  {
+    printf("%02X", record.data[i]);
+  }
+  printf("\n");
+}
+
+static void printAsc(const CanLogFileHeader &header, const CanLogRecord &record, uint64_t start_stamp_ns)
+{
+  uint64_t stamp_ns = record.stamp_ns - start_stamp_ns;
+  printf("%llu.%06llu %u %X%s Rx ", ( unsigned long long )(stamp_ns / 1000000000ull),
+         ( unsigned long long )(stamp_ns % 1000000000ull / 1000), header.channel + 1, record.id,
+         record.ide ? "x" : "");
+  if (record.rtr)
+  {
+    printf("r\n");
+    return;
+  }
+  printf("d %u", record.dlc);
+  for (int i = 0; i < record.dlc && i < 8; i++)
+  {
+    printf(" %02X", record.data[i]);
+  }
+  printf("\n");
+}
+
+static int convertFile(const char *file_path, bool asc)
+{
+  FILE *fp = fopen(file_path, "rb");
+  if (fp == NULL)
+  {
+    fprintf(stderr, "open %s failed\n", file_path);
+    return -1;
+  }
+
+  CanLogFileHeader header;
+  if (fread(&header, sizeof(header), 1, fp) != 1 || header.magic != CAN_BINLOG_MAGIC ||
+      header.record_size != sizeof(CanLogRecord))
+  {
+    fprintf(stderr, "%s is not a can binlog file\n", file_path);
+    fclose(fp);
+    return -1;
+  }
+
+  if (asc)
+  {
+    time_t raw_time = header.create_stamp_ns / 1000000000ull;
+    char time_str[64];
+    strftime(time_str, sizeof(time_str), "%a %b %d %I:%M:%S %p %Y", localtime(&raw_time));
+    printf("date %s\nbase hex  timestamps absolute\n", time_str);
+  }
+
+  std::vector< CanLogRecord > records;
+  uint32_t drop_count = 0;
+  int ret             = 0;
+  CanLogIndexBlock index;
+  while (fread(&index, sizeof(index), 1, fp) == 1)
+  {
+    if (index.magic != CAN_BINLOG_INDEX_MAGIC)
+    {
+      fprintf(stderr, "%s: bad index block at %ld\n", file_path, ftell(fp) - ( long )sizeof(index));
+      ret = -1;
+      break;
+    }
+    records.resize(index.record_num);
+    size_t read_num = fread(records.data(), sizeof(CanLogRecord), index.record_num, fp);
+    for (size_t i = 0; i < read_num; i++)
+    {
+      if (asc)
+      {
+        printAsc(header, records[i], header.create_stamp_ns);
+      }
+      else
+      {
+        printCandump(header, records[i]);
+      }
+    }
+    drop_count += index.drop_count;
+    //写入中途断电时最后一块可能不完整
+    if (read_num != index.record_num)
+    {
+      fprintf(stderr, "%s: truncated block\n", file_path);
+      break;
+    }
+  }
+  if (drop_count > 0)
+  {
+    fprintf(stderr, "%s: %u frames dropped while logging\n", file_path, drop_count);
+  }
+  fclose(fp);
+  return ret;
+}
+
+int main(int argc, char **argv)
+{
+  bool asc      = false;
+  int arg_start = 1;
+  if (argc > 1 && strcmp(argv[1], "--asc") == 0)
+  {
+    asc       = true;
+    arg_start = 2;
+  }
+  if (arg_start >= argc)
+  {
+    fprintf(stderr, "usage: %s [--asc] <file.canlog>...\n", argv[0]);
+    return 1;
+  }
+
+  int ret = 0;
+  for (int i = arg_start; i < argc; i++)
+  {
+    if (convertFile(argv[i], asc) != 0)
+    {
+      ret = 1;
+    }
+  }
+  return ret;
+}
@@ -8,107 +8,6 @@ namespace superg_agv
 {
 namespace drivers
 {
-CANData_Output::CANData_Output(string &pram1)
-{
-  sensor_type = pram1;
-  cout << filepath << endl;
-  filepath = filepath + sensor_type;
-  cout << sensor_type << endl;
-  cout << filepath << endl;
-  min = -1;
-  // filepath = path + filename + ".csv";
-  // cout << filepath << endl;
-} 
-
-CANData_Output::~CANData_Output()
-{
-  if(logfile.is_open())
-  {
-    logfile.close();
-  }
-}
-
-bool CANData_Output::Openfile(string &pram1, string &pram2, adcuCanData &data, int &ch_)
-{
-  char str[80] = {};
-  time(&systime);
-  ptminfo = localtime(&systime);
-  string closepath = "";
-  string logpath = "";
-  if(ch_ == CHANNEL_CAMERA_1)
-  {
-    logpath = filepath + "/" + to_string(ptminfo->tm_year + 1900) + to_string(ptminfo->tm_mon + 1) + to_string(ptminfo->tm_mday) + "-" + to_string(ptminfo->tm_hour)
-                  + "/" + sensor_type + "_1" + "-" + to_string(ptminfo->tm_min) + ".csv";
-  }
-  else if(ch_ == CHANNEL_CAMERA_2)
-  {
-    logpath = filepath + "/" + to_string(ptminfo->tm_year + 1900) + to_string(ptminfo->tm_mon + 1) + to_string(ptminfo->tm_mday) + "-" + to_string(ptminfo->tm_hour)
-                  + "/" + sensor_type + "_2" + "-" + to_string(ptminfo->tm_min) + ".csv";
-  }
-  else
-  {
-    logpath = filepath + "/" + to_string(ptminfo->tm_year + 1900) + to_string(ptminfo->tm_mon + 1) + to_string(ptminfo->tm_mday) + "-" + to_string(ptminfo->tm_hour)
-                  + "/" + sensor_type + "-" + to_string(ptminfo->tm_min) + ".csv";
-  }
-  if(-1 == min)
-  {
-    logfile.open(logpath);
-    min = ptminfo->tm_min;
-  }
-  if(min < ptminfo->tm_min || (59 == min && 0 == ptminfo->tm_min))
-  {
-    logfile.close();
-    logfile.open(logpath);
-    min = ptminfo->tm_min;
-  }
-  // logfile.open(logpath);
-  if(logfile.is_open())
-  {
-    sprintf(str,"%d-%d-%d %d:%d:%d  %d %d %d %d %d %d %d %d %d",ptminfo->tm_year + 1900,ptminfo->tm_mon + 1,ptminfo->tm_mday,ptminfo->tm_hour,ptminfo->tm_min,ptminfo->tm_sec,
-    data.id,data.can_data[0],data.can_data[1],data.can_data[2],data.can_data[3],data.can_data[4],data.can_data[5],data.can_data[6],data.can_data[7]);
-    logfile << str << endl;
-    // logfile.close();
-    return false;
-  }
-  else
-  {
-    logfile.open(logpath);
-    sprintf(str,"%d-%d-%d %d:%d:%d  %d %d %d %d %d %d %d %d %d",ptminfo->tm_year + 1900,ptminfo->tm_mon + 1,ptminfo->tm_mday,ptminfo->tm_hour,ptminfo->tm_min,ptminfo->tm_sec,
-    data.id,data.can_data[0],data.can_data[1],data.can_data[2],data.can_data[3],data.can_data[4],data.can_data[5],data.can_data[6],data.can_data[7]);
-    logfile << str << endl;
-    // logfile.open(filepath);
-    return true;
-  }
-}
-
-bool CANData_Output::Closefile(string &pram1, string &pram2)
-{
-  if(logfile.is_open())
-  {
-    logfile.close();
-  }
-  else
-  {
-    logfile.close();
-  }
-}
-
-bool CANData_Output::Isexistence(string &pram1, string &pram2)
-{
-  ;
-}
-
-bool CANData_Output::Writefile(string &pram1, string &pram2, adcuCanData &data)
-{
-  char str[80] = {};
-  time(&systime);
-  ptminfo = localtime(&systime);
-  sprintf(str,"%d-%d-%d %d:%d:%d  %d %d %d %d %d %d %d %d %d",ptminfo->tm_year + 1900,ptminfo->tm_mon + 1,ptminfo->tm_mday,ptminfo->tm_hour,ptminfo->tm_min,ptminfo->tm_sec,
-  data.id,data.can_data[0],data.can_data[1],data.can_data[2],data.can_data[3],data.can_data[4],data.can_data[5],data.can_data[6],data.can_data[7]);
-  cout << str << endl;
-  logfile << str << endl;
-}
-
 // Driver_Monitor::Driver_Monitor()
 // {
 //   p2_info.WAIT_TIME_MAX = 6000;
@@ -0,0 +1,379 @@
+#include "can_signal.h"
+
+namespace superg_agv
+{
+namespace drivers
+{
+
+/****************超声波********************/
+// 8路距离各6位, 之后8位状态, 2位控制器ID
+static constexpr CanSignal ultrasonic_data_signals[ULTRASONIC_SIG_NUM] = {
+    {0, 6, CAN_INTEL, 0, 0.05, 0.0},  // ultrasonic1_distance
+    {6, 6, CAN_INTEL, 0, 0.05, 0.0},  // ultrasonic2_distance
+    {12, 6, CAN_INTEL, 0, 0.05, 0.0}, // ultrasonic3_distance
+    {18, 6, CAN_INTEL, 0, 0.05, 0.0}, // ultrasonic4_distance
+    {24, 6, CAN_INTEL, 0, 0.05, 0.0}, // ultrasonic5_distance
+    {30, 6, CAN_INTEL, 0, 0.05, 0.0}, // ultrasonic6_distance
+    {36, 6, CAN_INTEL, 0, 0.05, 0.0}, // ultrasonic7_distance
+    {42, 6, CAN_INTEL, 0, 0.05, 0.0}, // ultrasonic8_distance
+    {48, 1, CAN_INTEL, 0, 1.0, 0.0},  // ultrasonic1_status
+    {49, 1, CAN_INTEL, 0, 1.0, 0.0},  // ultrasonic2_status
+    {50, 1, CAN_INTEL, 0, 1.0, 0.0},  // ultrasonic3_status
+    {51, 1, CAN_INTEL, 0, 1.0, 0.0},  // ultrasonic4_status
+    {52, 1, CAN_INTEL, 0, 1.0, 0.0},  // ultrasonic5_status
+    {53, 1, CAN_INTEL, 0, 1.0, 0.0},  // ultrasonic6_status
+    {54, 1, CAN_INTEL, 0, 1.0, 0.0},  // ultrasonic7_status
+    {55, 1, CAN_INTEL, 0, 1.0, 0.0},  // ultrasonic8_status
+    {56, 2, CAN_INTEL, 0, 1.0, 0.0}   // controller_id
+};
+
+/****************mobileye********************/
+static constexpr CanSignal mobileye_number_of_obstacles_signals[MOBILEYE_NUMBER_OF_OBSTACLES_SIG_NUM] = {
+    {0, 8, CAN_INTEL, 0, 1.0, 0.0},  // Number_Of_Obstacles
+    {8, 8, CAN_INTEL, 0, 1.0, 0.0},  // Timestamp
+    {26, 1, CAN_INTEL, 0, 1.0, 0.0}, // Left_Close_Rang_Cut_In
+    {27, 1, CAN_INTEL, 0, 1.0, 0.0}, // Right_Close_Rang_Cut_In
+    {28, 4, CAN_INTEL, 0, 1.0, 0.0}, // Go
+    {40, 1, CAN_INTEL, 0, 1.0, 0.0}, // Close_car
+    {41, 4, CAN_INTEL, 0, 1.0, 0.0}  // Failsafe
+};
+
+static constexpr CanSignal mobileye_obstacle_data_a_signals[MOBILEYE_OBSTACLE_DATA_A_SIG_NUM] = {
+    {0, 8, CAN_INTEL, 0, 1.0, 0.0},     // Obstacle_ID
+    {8, 12, CAN_INTEL, 0, 0.0625, 0.0}, // Obstacle_Position_X
+    {24, 10, CAN_INTEL, 0, 0.0625, 0.0}, // Obstacle_Position_Y
+    {40, 12, CAN_INTEL, 0, 0.0625, 0.0}, // Obstacle_Relative_Velocity_X
+    {52, 3, CAN_INTEL, 0, 1.0, 0.0},    // Obstacle_Type
+    {56, 3, CAN_INTEL, 0, 1.0, 0.0},    // Obstacle_Status
+    {59, 1, CAN_INTEL, 0, 1.0, 0.0},    // Obstacle_Brake_Lights
+    {37, 3, CAN_INTEL, 0, 1.0, 0.0},    // Cut_In_And_Out
+    {34, 3, CAN_INTEL, 0, 1.0, 0.0},    // Blinker_Info
+    {62, 2, CAN_INTEL, 0, 1.0, 0.0}     // Obstacle_Valid
+};
+
+static constexpr CanSignal mobileye_obstacle_data_c_signals[MOBILEYE_OBSTACLE_DATA_C_SIG_NUM] = {
+    {0, 16, CAN_INTEL, 0, 0.01, 0.0},    // Obstacle_Angle_Rate
+    {16, 16, CAN_INTEL, 0, 0.0002, 0.0}, // Obstacle_Scale_Change
+    {32, 10, CAN_INTEL, 0, 0.03, 0.0},   // Object_Accel_X
+    {44, 1, CAN_INTEL, 0, 1.0, 0.0},     // Obstacle_Replaced
+    {48, 16, CAN_INTEL, 0, 0.01, 0.0}    // Obstacle_Angle
+};
+
+static constexpr CanSignal mobileye_obstacle_data_b_signals[MOBILEYE_OBSTACLE_DATA_B_SIG_NUM] = {
+    {0, 8, CAN_INTEL, 0, 0.5, 0.0},      // Obstacle_Length
+    {8, 8, CAN_INTEL, 0, 0.05, 0.0},     // Obstacle_Width
+    {16, 8, CAN_INTEL, 0, 1.0, 0.0},     // Obstacle_Age
+    {24, 2, CAN_INTEL, 0, 1.0, 0.0},     // Obstacle_Lane
+    {26, 1, CAN_INTEL, 0, 1.0, 0.0},     // CIPV_Flag
+    {28, 12, CAN_INTEL, 0, 0.0625, 0.0}, // Radar_Position_X
+    {40, 12, CAN_INTEL, 0, 0.0625, 0.0}, // Radar_Velocity_X
+    {52, 3, CAN_INTEL, 0, 1.0, 0.0},     // Radar_Match_Confidence
+    {56, 7, CAN_INTEL, 0, 1.0, 0.0}      // Matched_Radar_ID
+};
+
+static constexpr CanSignal mobileye_lane_info_and_measure_signals[MOBILEYE_LANE_INFO_AND_MEASURE_SIG_NUM] = {
+    {0, 2, CAN_INTEL, 0, 1.0, 0.0},   // confidence_lane_left
+    {2, 1, CAN_INTEL, 0, 1.0, 0.0},   // LDW_left
+    {4, 4, CAN_INTEL, 0, 1.0, 0.0},   // lane_type_left
+    {12, 12, CAN_INTEL, 0, 1.0, 0.0}, // distance_lane_left
+    {40, 2, CAN_INTEL, 0, 1.0, 0.0},  // confidence_lane_right
+    {42, 1, CAN_INTEL, 0, 1.0, 0.0},  // LDW_right
+    {44, 4, CAN_INTEL, 0, 1.0, 0.0},  // lane_type_right
+    {52, 12, CAN_INTEL, 0, 1.0, 0.0}  // distance_lane_right
+};
+
+static constexpr CanSignal mobileye_system_warning_signals[MOBILEYE_SYSTEM_WARNING_SIG_NUM] = {
+    {0, 3, CAN_INTEL, 0, 1.0, 0.0},  // sound_type
+    {3, 2, CAN_INTEL, 0, 1.0, 0.0},  // Time_Indicator
+    {13, 1, CAN_INTEL, 0, 1.0, 0.0}, // Zero_speed
+    {16, 1, CAN_INTEL, 0, 1.0, 0.0}, // Headway_Valid
+    {17, 7, CAN_INTEL, 0, 0.1, 0.0}, // Headway_measurement
+    {24, 1, CAN_INTEL, 0, 1.0, 0.0}, // Error_Valid
+    {25, 7, CAN_INTEL, 0, 1.0, 0.0}, // Error_Code
+    {32, 1, CAN_INTEL, 0, 1.0, 0.0}, // LDW_Off
+    {33, 1, CAN_INTEL, 0, 1.0, 0.0}, // Left_LDW_On
+    {34, 1, CAN_INTEL, 0, 1.0, 0.0}, // Right_LDW_On
+    {35, 1, CAN_INTEL, 0, 1.0, 0.0}, // FCW_On
+    {38, 1, CAN_INTEL, 0, 1.0, 0.0}, // Maintenance
+    {39, 1, CAN_INTEL, 0, 1.0, 0.0}, // FailSafe
+    {41, 1, CAN_INTEL, 0, 1.0, 0.0}, // Peds_FCW
+    {42, 1, CAN_INTEL, 0, 1.0, 0.0}, // Peds_in_DZ
+    {45, 1, CAN_INTEL, 0, 1.0, 0.0}, // Tamper_Alert
+    {47, 1, CAN_INTEL, 0, 1.0, 0.0}, // TSR_Enabled
+    {48, 2, CAN_INTEL, 0, 1.0, 0.0}, // TSR_Warning_Level
+    {56, 1, CAN_INTEL, 0, 1.0, 0.0}, // Headway_Warning_Level
+    {57, 1, CAN_INTEL, 0, 1.0, 0.0}  // HW_Repeatable_Enabled
+};
+
+static constexpr CanSignal mobileye_tsr_type_and_position_signals[MOBILEYE_TSR_TYPE_AND_POSITION_SIG_NUM] = {
+    {0, 8, CAN_INTEL, 0, 1.0, 0.0},  // Vision_Only_Sign_Type
+    {8, 8, CAN_INTEL, 0, 1.0, 0.0},  // Supplementary_Sign_Type
+    {16, 8, CAN_INTEL, 0, 0.5, 0.0}, // Sign_Position_X
+    {24, 7, CAN_INTEL, 0, 0.5, 0.0}, // Sign_Position_Y
+    {32, 6, CAN_INTEL, 0, 0.5, 0.0}, // Sign_Position_Z
+    {40, 8, CAN_INTEL, 0, 1.0, 0.0}  // Filter_Type
+};
+
+//每个标志牌类型后跟其辅助标志类型
+static constexpr CanSignal mobileye_tsr_vision_decision_signals[MOBILEYE_TSR_VISION_DECISION_SIG_NUM] = {
+    {0, 8, CAN_INTEL, 0, 1.0, 0.0},  // Vision_only_Sign_Type_1
+    {8, 8, CAN_INTEL, 0, 1.0, 0.0},  // Vision_only_Supplementary_Sign_Type_1
+    {16, 8, CAN_INTEL, 0, 1.0, 0.0}, // Vision_only_Sign_Type_2
+    {24, 8, CAN_INTEL, 0, 1.0, 0.0}, // Vision_only_Supplementary_Sign_Type_2
+    {32, 8, CAN_INTEL, 0, 1.0, 0.0}, // Vision_only_Sign_Type_3
+    {40, 8, CAN_INTEL, 0, 1.0, 0.0}, // Vision_only_Supplementary_Sign_Type_3
+    {48, 8, CAN_INTEL, 0, 1.0, 0.0}, // Vision_only_Sign_Type_4
+    {56, 8, CAN_INTEL, 0, 1.0, 0.0}  // Vision_only_Supplementary_Sign_Type_4
+};
+
+static constexpr CanSignal mobileye_lights_location_and_angles_signals[MOBILEYE_LIGHTS_LOCATION_AND_ANGLES_SIG_NUM] = {
+    {0, 8, CAN_INTEL, 0, 0.1, -10.0},  // BNDRY_DOM_BOT_NGL_HLB
+    {8, 12, CAN_INTEL, 0, 0.1, -20.0}, // BNDRY_DOM_NGL_LH_HLB
+    {20, 12, CAN_INTEL, 0, 0.1, -20.0}, // BNDRY_DOM_NGL_RH_HLB
+    {32, 8, CAN_INTEL, 0, 2.0, 0.0},   // OBJ_DIST_HLB
+    {40, 2, CAN_INTEL, 0, 1.0, 0.0},   // ST_BNDRY_DOM_BOT_NGL_HLB
+    {42, 2, CAN_INTEL, 0, 1.0, 0.0},   // ST_BNDRY_DOM_NGL_LH_HLB
+    {44, 2, CAN_INTEL, 0, 1.0, 0.0},   // ST_BNDRY_DOM_NGL_RH_HLB
+    {46, 2, CAN_INTEL, 0, 1.0, 0.0},   // ST_OBJ_DIST_HLB
+    {48, 1, CAN_INTEL, 0, 1.0, 0.0},   // Left_Target_Change
+    {49, 1, CAN_INTEL, 0, 1.0, 0.0},   // Right_Target_Change
+    {50, 1, CAN_INTEL, 0, 1.0, 0.0},   // Too_Many_Cars
+    {51, 1, CAN_INTEL, 0, 1.0, 0.0}    // Busy_Scene
+};
+
+static constexpr CanSignal mobileye_lane_info_measure_signals[MOBILEYE_LANE_INFO_MEASURE_SIG_NUM] = {
+    {0, 16, CAN_INTEL, 1, 3.81e-6, 0.0},                                // Lane_Curvature
+    {16, 12, CAN_INTEL, 1, 0.0005, 0.0},                                // Lane_Heading
+    {28, 1, CAN_INTEL, 0, 1.0, 0.0},                                    // CA_construction_area
+    {29, 1, CAN_INTEL, 0, 1.0, 0.0},                                    // Right_LDW_Availability
+    {30, 1, CAN_INTEL, 0, 1.0, 0.0},                                    // Left_LDW_Availability
+    {32, 16, CAN_INTEL, 0, 1.0 / 1024, 0.0},                            // Yaw_Angle
+    {48, 16, CAN_INTEL, 0, 1.0 / 1024 / 512, -0x7FFF / 1024.0 / 512.0} // Pitch_Angle
+};
+
+static constexpr CanSignal mobileye_signals_status_signals[MOBILEYE_SIGNALS_STATUS_SIG_NUM] = {
+    {0, 1, CAN_INTEL, 0, 1.0, 0.0},  // Brake_signal
+    {1, 1, CAN_INTEL, 0, 1.0, 0.0},  // Left_signal
+    {2, 1, CAN_INTEL, 0, 1.0, 0.0},  // Right_signal
+    {3, 1, CAN_INTEL, 0, 1.0, 0.0},  // Wipers
+    {4, 1, CAN_INTEL, 0, 1.0, 0.0},  // Low_Beam
+    {5, 1, CAN_INTEL, 0, 1.0, 0.0},  // High_Beam
+    {11, 1, CAN_INTEL, 0, 1.0, 0.0}, // Wipers_available
+    {12, 1, CAN_INTEL, 0, 1.0, 0.0}, // Low_Beam_available
+    {13, 1, CAN_INTEL, 0, 1.0, 0.0}, // High_Beam_Available
+    {15, 1, CAN_INTEL, 0, 1.0, 0.0}, // Speed_Available
+    {16, 8, CAN_INTEL, 0, 1.0, 0.0}  // Speed
+};
+
+static constexpr CanSignal mobileye_lka_lane_a_signals[MOBILEYE_LKA_LANE_A_SIG_NUM] = {
+    {0, 4, CAN_INTEL, 0, 1.0, 0.0},                                       // Lane_type
+    {4, 2, CAN_INTEL, 0, 1.0, 0.0},                                       // Quality
+    {6, 2, CAN_INTEL, 0, 1.0, 0.0},                                       // Model_degree
+    {8, 16, CAN_INTEL, 1, 1.0 / 256, 0.0},                                // Position_Parameter_C0
+    {24, 16, CAN_INTEL, 0, 1.0 / 1024 / 1000, -0x7FFF / 1024.0 / 1000.0}, // Curvature_Parameter_C2
+    {40, 16, CAN_INTEL, 0, 1.0 / (1 << 28), -0x7FFF / double(1 << 28)},   // Curvature_Derivative_Parameter_C3
+    {56, 8, CAN_INTEL, 0, 0.01, 0.0}                                      // Width_Marking
+};
+
+static constexpr CanSignal mobileye_lka_lane_b_signals[MOBILEYE_LKA_LANE_B_SIG_NUM] = {
+    {0, 16, CAN_INTEL, 0, 1.0 / 1024, -0x7FFF / 1024.0}, // Heading_Angle_Parameter_C1
+    {16, 15, CAN_INTEL, 0, 1.0 / 256, 0.0},              // View_Range
+    {31, 1, CAN_INTEL, 0, 1.0, 0.0}                      // View_range_availability
+};
+
+static constexpr CanSignal mobileye_reference_points_signals[MOBILEYE_REFERENCE_POINTS_SIG_NUM] = {
+    {0, 16, CAN_INTEL, 0, 1.0 / 256, -0x7FFF / 256.0},  // Ref_Point_1_Position
+    {16, 15, CAN_INTEL, 0, 1.0 / 256, 0.0},             // Ref_Point_1_Distance
+    {31, 1, CAN_INTEL, 0, 1.0, 0.0},                    // Ref_Point_1_Validity
+    {32, 16, CAN_INTEL, 0, 1.0 / 256, -0x7FFF / 256.0}, // Ref_Point_2_Position
+    {48, 15, CAN_INTEL, 0, 1.0 / 256, 0.0},             // Ref_Point_2_Distance
+    {63, 1, CAN_INTEL, 0, 1.0, 0.0}                     // Ref_Point_2_Validity
+};
+
+static constexpr CanSignal mobileye_number_of_next_lane_signals[MOBILEYE_NUMBER_OF_NEXT_LANE_SIG_NUM] = {
+    {0, 8, CAN_INTEL, 0, 1.0, 0.0} // Number_Of_Next_Lane_Markers_Reported
+};
+
+/****************camera********************/
+// 5位目标数, 27位时间戳
+static constexpr CanSignal camera_object_head_signals[CAMERA_OBJECT_HEAD_SIG_NUM] = {
+    {3, 5, CAN_MOTOROLA, 0, 1.0, 0.0}, // obj_num
+    {8, 27, CAN_MOTOROLA, 0, 1.0, 0.0} // r_time
+};
+
+static constexpr CanSignal camera_object_data_0_signals[CAMERA_OBJECT_DATA_0_SIG_NUM] = {
+    {0, 8, CAN_MOTOROLA, 0, 1.0, 0.0},   // id
+    {8, 8, CAN_MOTOROLA, 0, 1.0, 0.0},   // obj_class
+    {16, 8, CAN_MOTOROLA, 0, 0.01, 0.0}, // confidence
+    {24, 10, CAN_MOTOROLA, 1, 0.1, 0.0}, // velocity
+    {40, 12, CAN_MOTOROLA, 1, 0.1, 0.0}, // position_x
+    {52, 12, CAN_MOTOROLA, 1, 0.1, 0.0}  // position_y
+};
+
+static constexpr CanSignal camera_object_data_1_signals[CAMERA_OBJECT_DATA_1_SIG_NUM] = {
+    {0, 8, CAN_MOTOROLA, 0, 1.0, 0.0},   // id
+    {8, 12, CAN_MOTOROLA, 0, 0.1, 0.0},  // width
+    {20, 10, CAN_MOTOROLA, 0, 1.0, 0.0}, // polygon_y_min
+    {30, 10, CAN_MOTOROLA, 0, 1.0, 0.0}, // polygon_y_max
+    {40, 12, CAN_MOTOROLA, 0, 1.0, 0.0}, // polygon_x_min
+    {52, 12, CAN_MOTOROLA, 0, 1.0, 0.0}  // polygon_x_max
+};
+
+// 3位车道线数, 27位时间戳
+static constexpr CanSignal camera_lane_head_signals[CAMERA_LANE_HEAD_SIG_NUM] = {
+    {5, 3, CAN_MOTOROLA, 0, 1.0, 0.0}, // lane_num
+    {8, 27, CAN_MOTOROLA, 0, 1.0, 0.0} // r_time
+};
+
+static constexpr CanSignal camera_lane_data_0_signals[CAMERA_LANE_DATA_0_SIG_NUM] = {
+    {0, 8, CAN_MOTOROLA, 0, 1.0, 0.0},   // id
+    {8, 8, CAN_MOTOROLA, 0, 1.0, 0.0},   // slope
+    {16, 16, CAN_MOTOROLA, 1, 0.1, 0.0}, // distance
+    {32, 16, CAN_MOTOROLA, 1, 0.1, 0.0}, // start_point
+    {48, 16, CAN_MOTOROLA, 1, 0.1, 0.0}  // end_point
+};
+
+static constexpr CanSignal camera_lane_data_1_signals[CAMERA_LANE_DATA_1_SIG_NUM] = {
+    {0, 16, CAN_MOTOROLA, 1, 0.1, 0.0},  // polynomial_a
+    {16, 16, CAN_MOTOROLA, 1, 0.1, 0.0}, // polynomial_b
+    {32, 16, CAN_MOTOROLA, 1, 0.1, 0.0}, // polynomial_c
+    {48, 13, CAN_MOTOROLA, 1, 0.1, 0.0}, // polynomial_d
+    {61, 3, CAN_MOTOROLA, 0, 1.0, 0.0}   // id
+};
+
+/****************p2********************/
+static constexpr CanSignal p2_time_signals[P2_TIME_SIG_NUM] = {
+    {0, 16, CAN_MOTOROLA, 0, 1.0, 0.0},   // gps_week
+    {16, 32, CAN_MOTOROLA, 0, 0.001, 0.0} // gps_time, ms
+};
+
+// 20位补码, 0.01 deg/s
+static constexpr CanSignal p2_ang_rate_raw_imu_signals[P2_AXIS3_SIG_NUM] = {
+    {0, 20, CAN_MOTOROLA, 1, 0.01, 0.0},  // ang_rate_raw_x
+    {20, 20, CAN_MOTOROLA, 1, 0.01, 0.0}, // ang_rate_raw_y
+    {40, 20, CAN_MOTOROLA, 1, 0.01, 0.0}  // ang_rate_raw_z
+};
+
+// 20位补码, 0.001 g
+static constexpr CanSignal p2_accel_imu_raw_signals[P2_AXIS3_SIG_NUM] = {
+    {0, 20, CAN_MOTOROLA, 1, 0.001, 0.0},  // accel_raw_x
+    {20, 20, CAN_MOTOROLA, 1, 0.001, 0.0}, // accel_raw_y
+    {40, 20, CAN_MOTOROLA, 1, 0.001, 0.0}  // accel_raw_z
+};
+
+static constexpr CanSignal p2_ins_status_signals[P2_INS_STATUS_SIG_NUM] = {
+    {0, 8, CAN_MOTOROLA, 0, 1.0, 0.0},  // system_status
+    {8, 8, CAN_MOTOROLA, 0, 1.0, 0.0},  // gps_num_status
+    {16, 8, CAN_MOTOROLA, 0, 1.0, 0.0}  // satellite_status
+};
+
+static constexpr CanSignal p2_latitude_longitude_signals[P2_LATITUDE_LONGITUDE_SIG_NUM] = {
+    {0, 32, CAN_MOTOROLA, 1, 1e-7, 0.0}, // pos_lat
+    {32, 32, CAN_MOTOROLA, 1, 1e-7, 0.0} // pos_lon
+};
+
+static constexpr CanSignal p2_altitude_signals[P2_ALTITUDE_SIG_NUM] = {
+    {0, 32, CAN_MOTOROLA, 1, 0.001, 0.0} // pos_alt
+};
+
+static constexpr CanSignal p2_pos_sigma_signals[P2_ENU_SIG_NUM] = {
+    {0, 16, CAN_MOTOROLA, 0, 0.01, 0.0},  // pos_e_sigma
+    {16, 16, CAN_MOTOROLA, 0, 0.01, 0.0}, // pos_n_sigma
+    {32, 16, CAN_MOTOROLA, 0, 0.01, 0.0}  // pos_u_sigma
+};
+
+static constexpr CanSignal p2_velocity_level_signals[P2_VELOCITY_SIG_NUM] = {
+    {0, 16, CAN_MOTOROLA, 1, 0.01, 0.0},  // vel_e
+    {16, 16, CAN_MOTOROLA, 1, 0.01, 0.0}, // vel_n
+    {32, 16, CAN_MOTOROLA, 1, 0.01, 0.0}, // vel_u
+    {48, 16, CAN_MOTOROLA, 1, 0.01, 0.0}  // vel
+};
+
+static constexpr CanSignal p2_velocity_level_sigma_signals[P2_VELOCITY_SIG_NUM] = {
+    {0, 16, CAN_MOTOROLA, 0, 0.01, 0.0},  // vel_e_sigma
+    {16, 16, CAN_MOTOROLA, 0, 0.01, 0.0}, // vel_n_sigma
+    {32, 16, CAN_MOTOROLA, 0, 0.01, 0.0}, // vel_u_sigma
+    {48, 16, CAN_MOTOROLA, 0, 0.01, 0.0}  // vel_sigma
+};
+
+// 20位补码, 0.0001 g 换算为 m/s^2
+static constexpr CanSignal p2_accel_vehicle_signals[P2_AXIS3_SIG_NUM] = {
+    {0, 20, CAN_MOTOROLA, 1, 0.0001 * 9.80665, 0.0},  // accel_vel_x
+    {20, 20, CAN_MOTOROLA, 1, 0.0001 * 9.80665, 0.0}, // accel_vel_y
+    {40, 20, CAN_MOTOROLA, 1, 0.0001 * 9.80665, 0.0}  // accel_vel_z
+};
+
+static constexpr CanSignal p2_heading_pitch_roll_signals[P2_HEADING_PITCH_ROLL_SIG_NUM] = {
+    {0, 16, CAN_MOTOROLA, 0, 0.01, 0.0},  // heading
+    {16, 16, CAN_MOTOROLA, 1, 0.01, 0.0}, // pitch
+    {32, 16, CAN_MOTOROLA, 1, 0.01, 0.0}  // roll
+};
+
+static constexpr CanSignal p2_heading_pitch_roll_sigma_signals[P2_HEADING_PITCH_ROLL_SIG_NUM] = {
+    {0, 16, CAN_MOTOROLA, 0, 0.01, 0.0},  // heading_sigma
+    {16, 16, CAN_MOTOROLA, 0, 0.01, 0.0}, // pitch_sigma
+    {32, 16, CAN_MOTOROLA, 0, 0.01, 0.0}  // roll_sigma
+};
+
+static constexpr CanSignal p2_ang_rate_vehicle_signals[P2_AXIS3_SIG_NUM] = {
+    {0, 20, CAN_MOTOROLA, 1, 0.01, 0.0},  // ang_rate_x
+    {20, 20, CAN_MOTOROLA, 1, 0.01, 0.0}, // ang_rate_y
+    {40, 20, CAN_MOTOROLA, 1, 0.01, 0.0}  // ang_rate_z
+};
+
+//新增报文在 CanMessageType 中加类型, 并按类型顺序在此添加报文定义
+constexpr CanMessageDef can_message_db[CAN_MSG_TYPE_NUM] = {
+    {CAN_MSG_ULTRASONIC_DATA, ultrasonic_data_signals, ULTRASONIC_SIG_NUM},
+    {CAN_MSG_MOBILEYE_NUMBER_OF_OBSTACLES, mobileye_number_of_obstacles_signals, MOBILEYE_NUMBER_OF_OBSTACLES_SIG_NUM},
+    {CAN_MSG_MOBILEYE_OBSTACLE_DATA_A, mobileye_obstacle_data_a_signals, MOBILEYE_OBSTACLE_DATA_A_SIG_NUM},
+    {CAN_MSG_MOBILEYE_OBSTACLE_DATA_C, mobileye_obstacle_data_c_signals, MOBILEYE_OBSTACLE_DATA_C_SIG_NUM},
+    {CAN_MSG_CAMERA_OBJECT_HEAD, camera_object_head_signals, CAMERA_OBJECT_HEAD_SIG_NUM},
+    {CAN_MSG_CAMERA_OBJECT_DATA_0, camera_object_data_0_signals, CAMERA_OBJECT_DATA_0_SIG_NUM},
+    {CAN_MSG_CAMERA_OBJECT_DATA_1, camera_object_data_1_signals, CAMERA_OBJECT_DATA_1_SIG_NUM},
+    {CAN_MSG_CAMERA_LANE_HEAD, camera_lane_head_signals, CAMERA_LANE_HEAD_SIG_NUM},
+    {CAN_MSG_CAMERA_LANE_DATA_0, camera_lane_data_0_signals, CAMERA_LANE_DATA_0_SIG_NUM},
+    {CAN_MSG_CAMERA_LANE_DATA_1, camera_lane_data_1_signals, CAMERA_LANE_DATA_1_SIG_NUM},
+    {CAN_MSG_MOBILEYE_OBSTACLE_DATA_B, mobileye_obstacle_data_b_signals, MOBILEYE_OBSTACLE_DATA_B_SIG_NUM},
+    {CAN_MSG_MOBILEYE_LANE_INFO_AND_MEASURE, mobileye_lane_info_and_measure_signals, MOBILEYE_LANE_INFO_AND_MEASURE_SIG_NUM},
+    {CAN_MSG_MOBILEYE_SYSTEM_WARNING, mobileye_system_warning_signals, MOBILEYE_SYSTEM_WARNING_SIG_NUM},
+    {CAN_MSG_MOBILEYE_TSR_TYPE_AND_POSITION, mobileye_tsr_type_and_position_signals, MOBILEYE_TSR_TYPE_AND_POSITION_SIG_NUM},
+    {CAN_MSG_MOBILEYE_TSR_VISION_DECISION, mobileye_tsr_vision_decision_signals, MOBILEYE_TSR_VISION_DECISION_SIG_NUM},
+    {CAN_MSG_MOBILEYE_LIGHTS_LOCATION_AND_ANGLES, mobileye_lights_location_and_angles_signals,
+     MOBILEYE_LIGHTS_LOCATION_AND_ANGLES_SIG_NUM},
+    {CAN_MSG_MOBILEYE_LANE_INFO_MEASURE, mobileye_lane_info_measure_signals, MOBILEYE_LANE_INFO_MEASURE_SIG_NUM},
+    {CAN_MSG_MOBILEYE_SIGNALS_STATUS, mobileye_signals_status_signals, MOBILEYE_SIGNALS_STATUS_SIG_NUM},
+    {CAN_MSG_MOBILEYE_LKA_LANE_A, mobileye_lka_lane_a_signals, MOBILEYE_LKA_LANE_A_SIG_NUM},
+    {CAN_MSG_MOBILEYE_LKA_LANE_B, mobileye_lka_lane_b_signals, MOBILEYE_LKA_LANE_B_SIG_NUM},
+    {CAN_MSG_MOBILEYE_REFERENCE_POINTS, mobileye_reference_points_signals, MOBILEYE_REFERENCE_POINTS_SIG_NUM},
+    {CAN_MSG_MOBILEYE_NUMBER_OF_NEXT_LANE, mobileye_number_of_next_lane_signals, MOBILEYE_NUMBER_OF_NEXT_LANE_SIG_NUM},
+    {CAN_MSG_P2_TIME, p2_time_signals, P2_TIME_SIG_NUM},
+    {CAN_MSG_P2_ANG_RATE_RAW_IMU, p2_ang_rate_raw_imu_signals, P2_AXIS3_SIG_NUM},
+    {CAN_MSG_P2_ACCEL_IMU_RAW, p2_accel_imu_raw_signals, P2_AXIS3_SIG_NUM},
+    {CAN_MSG_P2_INS_STATUS, p2_ins_status_signals, P2_INS_STATUS_SIG_NUM},
+    {CAN_MSG_P2_LATITUDE_LONGITUDE, p2_latitude_longitude_signals, P2_LATITUDE_LONGITUDE_SIG_NUM},
+    {CAN_MSG_P2_ALTITUDE, p2_altitude_signals, P2_ALTITUDE_SIG_NUM},
+    {CAN_MSG_P2_POS_SIGMA, p2_pos_sigma_signals, P2_ENU_SIG_NUM},
+    {CAN_MSG_P2_VELOCITY_LEVEL, p2_velocity_level_signals, P2_VELOCITY_SIG_NUM},
+    {CAN_MSG_P2_VELOCITY_LEVEL_SIGMA, p2_velocity_level_sigma_signals, P2_VELOCITY_SIG_NUM},
+    {CAN_MSG_P2_ACCEL_VEHICLE, p2_accel_vehicle_signals, P2_AXIS3_SIG_NUM},
+    {CAN_MSG_P2_HEADING_PITCH_ROLL, p2_heading_pitch_roll_signals, P2_HEADING_PITCH_ROLL_SIG_NUM},
+    {CAN_MSG_P2_HEADING_PITCH_ROLL_SIGMA, p2_heading_pitch_roll_sigma_signals, P2_HEADING_PITCH_ROLL_SIG_NUM},
+    {CAN_MSG_P2_ANG_RATE_VEHICLE, p2_ang_rate_vehicle_signals, P2_AXIS3_SIG_NUM}};
+
+//编译期检查报文表按类型排列, 且每个信号不超出8字节
+static constexpr bool canMessageDbValid(int type, int signal)
+{
+  return type >= CAN_MSG_TYPE_NUM
+             ? true
+             : signal >= can_message_db[type].signal_num
+                   ? can_message_db[type].type == type && canMessageDbValid(type + 1, 0)
+                   : can_message_db[type].signals[signal].length > 0 &&
+                         can_message_db[type].signals[signal].length <= 32 &&
+                         can_message_db[type].signals[signal].start_bit + can_message_db[type].signals[signal].length <= 64 &&
+                         canMessageDbValid(type, signal + 1);
+}
+
+static_assert(canMessageDbValid(0, 0), "can_message_db must be ordered by CanMessageType and fit in 8 bytes");
+
+} // namespace drivers
+} // namespace superg_agv
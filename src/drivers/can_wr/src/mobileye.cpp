@@ -8,39 +8,39 @@ namespace drivers
 MOBILEYE::MOBILEYE()
 {
     MOBILEYE_RECV_TYPE = NONE;
-    m_pHandlerMap.insert(make_pair(MOBILEYE_LANE_INFO_AND_MEASURE,&MOBILEYE::mobileyeLaneInfoAndMeasureParse));
-    m_pHandlerMap.insert(make_pair(MOBILEYE_SYSTE_MWARING,&MOBILEYE::mobileyeSystemWarningParse));
+    m_pHandlerMap.add(MOBILEYE_LANE_INFO_AND_MEASURE, &MOBILEYE::mobileyeLaneInfoAndMeasureParse);
+    m_pHandlerMap.add(MOBILEYE_SYSTE_MWARING, &MOBILEYE::mobileyeSystemWarningParse);
     // m_pHandlerMap.inset(make_pair(MOBILEYE_TSR_TYPE_AND_POSITION,&mobileye::mobileyeTSRTypeAndPositionParse));
     for(uint8_t i = 0; i < 7; ++i)
     {
-        m_pHandlerMap.insert(make_pair(MOBILEYE_TSR_TYPE_AND_POSITION + i,&MOBILEYE::mobileyeTSRTypeAndPositionParse));
+        m_pHandlerMap.add(MOBILEYE_TSR_TYPE_AND_POSITION + i, &MOBILEYE::mobileyeTSRTypeAndPositionParse);
     }
-    m_pHandlerMap.insert(make_pair(MOBILEYE_TSR_VISION_DECISION,&MOBILEYE::mobileyeTSRVisionDecisionPares));
-    m_pHandlerMap.insert(make_pair(MOBILEYE_LIGHTS_LOCATION_AND_ANGLES,&MOBILEYE::mobileyeLightsLocationAndAnglesPares));
-    m_pHandlerMap.insert(make_pair(MOBILEYE_LANE_INFO_MEASUREMENTS,&MOBILEYE::mobileyeLaneInfoMeasureParse));
-    m_pHandlerMap.insert(make_pair(MOBILEYE_NUMBER_OF_OBSTACLES,&MOBILEYE::mobileyeNumberOfObstaclesParse));
+    m_pHandlerMap.add(MOBILEYE_TSR_VISION_DECISION, &MOBILEYE::mobileyeTSRVisionDecisionPares);
+    m_pHandlerMap.add(MOBILEYE_LIGHTS_LOCATION_AND_ANGLES, &MOBILEYE::mobileyeLightsLocationAndAnglesPares);
+    m_pHandlerMap.add(MOBILEYE_LANE_INFO_MEASUREMENTS, &MOBILEYE::mobileyeLaneInfoMeasureParse);
+    m_pHandlerMap.add(MOBILEYE_NUMBER_OF_OBSTACLES, &MOBILEYE::mobileyeNumberOfObstaclesParse);
     for(uint8_t j = 0; j < 14; ++j)
     {
-        m_pHandlerMap.insert(make_pair(MOBILEYE_OBSTACLE_DATA_A + j,&MOBILEYE::mobileyeObstaclesData_AParse));
-        m_pHandlerMap.insert(make_pair(MOBILEYE_OBSTACLE_DATA_B + j,&MOBILEYE::mobileyeObstaclesData_BParse));
-        m_pHandlerMap.insert(make_pair(MOBILEYE_OBSTACLE_DATA_C + j,&MOBILEYE::mobileyeObstaclesData_CParse));
+        m_pHandlerMap.add(MOBILEYE_OBSTACLE_DATA_A + j, &MOBILEYE::mobileyeObstaclesData_AParse);
+        m_pHandlerMap.add(MOBILEYE_OBSTACLE_DATA_B + j, &MOBILEYE::mobileyeObstaclesData_BParse);
+        m_pHandlerMap.add(MOBILEYE_OBSTACLE_DATA_C + j, &MOBILEYE::mobileyeObstaclesData_CParse);
     }
     // m_pHandlerMap.inset(make_pair(MOBILEYE_OBSTACLE_DATA_A,&mobileye::mobileyeObstaclesData_AParse));
     // m_pHandlerMap.inset(make_pair(MOBILEYE_OBSTACLE_DATA_B,&mobileye::mobileyeObstaclesData_BParse));
     // m_pHandlerMap.inset(make_pair(MOBILEYE_OBSTACLE_DATA_C,&mobileye::mobileyeObstaclesData_CParse));
-    m_pHandlerMap.insert(make_pair(MOBILEYE_SIGNALS_STATUS_VEHICLE,&MOBILEYE::mobileyeSignalsStatusVehicleParse));
-    m_pHandlerMap.insert(make_pair(MOBILEYE_LKA_LEFT_LANE_A,&MOBILEYE::mobileyeLKALeftLane_AParse));
-    m_pHandlerMap.insert(make_pair(MOBILEYE_LKA_LEFT_LANE_B,&MOBILEYE::mobileyeLKALeftLane_BParse));
-    m_pHandlerMap.insert(make_pair(MOBILEYE_LKA_RIGHT_LANE_A,&MOBILEYE::mobileyeLKARightLane_AParse));
-    m_pHandlerMap.insert(make_pair(MOBILEYE_LKA_RIGHT_LANE_B,&MOBILEYE::mobileyeLKARightLane_BParse));
-    m_pHandlerMap.insert(make_pair(MOBILEYE_REFERENCE_POINTS,&MOBILEYE::mobileyeReference_PointsParse));
-    m_pHandlerMap.insert(make_pair(MOBILEYE_NUMBER_OF_NEXT_LANE,&MOBILEYE::mobileyeNunber_Of_Next_LaneParse));
+    m_pHandlerMap.add(MOBILEYE_SIGNALS_STATUS_VEHICLE, &MOBILEYE::mobileyeSignalsStatusVehicleParse);
+    m_pHandlerMap.add(MOBILEYE_LKA_LEFT_LANE_A, &MOBILEYE::mobileyeLKALeftLane_AParse);
+    m_pHandlerMap.add(MOBILEYE_LKA_LEFT_LANE_B, &MOBILEYE::mobileyeLKALeftLane_BParse);
+    m_pHandlerMap.add(MOBILEYE_LKA_RIGHT_LANE_A, &MOBILEYE::mobileyeLKARightLane_AParse);
+    m_pHandlerMap.add(MOBILEYE_LKA_RIGHT_LANE_B, &MOBILEYE::mobileyeLKARightLane_BParse);
+    m_pHandlerMap.add(MOBILEYE_REFERENCE_POINTS, &MOBILEYE::mobileyeReference_PointsParse);
+    m_pHandlerMap.add(MOBILEYE_NUMBER_OF_NEXT_LANE, &MOBILEYE::mobileyeNunber_Of_Next_LaneParse);
     for(uint8_t k = 0; k < 8; ++k)
     {
-        m_pHandlerMap.insert(make_pair(MOBILEYE_LEFT_NEXT_LANE_A + 4 * k,&MOBILEYE::mobileyeLKALeftLane_AParse));
-        m_pHandlerMap.insert(make_pair(MOBILEYE_LEFT_NEXT_LANE_B + 4 * k,&MOBILEYE::mobileyeLKALeftLane_BParse));
-        m_pHandlerMap.insert(make_pair(MOBILEYE_RIGHT_NEXT_LANE_A + 4 * k,&MOBILEYE::mobileyeLKARightLane_AParse));
-        m_pHandlerMap.insert(make_pair(MOBILEYE_RIGHT_NEXT_LANE_B + 4 * k,&MOBILEYE::mobileyeLKARightLane_BParse));
+        m_pHandlerMap.add(MOBILEYE_LEFT_NEXT_LANE_A + 4 * k, &MOBILEYE::mobileyeLKALeftLane_AParse);
+        m_pHandlerMap.add(MOBILEYE_LEFT_NEXT_LANE_B + 4 * k, &MOBILEYE::mobileyeLKALeftLane_BParse);
+        m_pHandlerMap.add(MOBILEYE_RIGHT_NEXT_LANE_A + 4 * k, &MOBILEYE::mobileyeLKARightLane_AParse);
+        m_pHandlerMap.add(MOBILEYE_RIGHT_NEXT_LANE_B + 4 * k, &MOBILEYE::mobileyeLKARightLane_BParse);
     }
 
 }
@@ -56,8 +56,7 @@ void MOBILEYE::CANMobileye(int &dev_, int &ch_)
     uint16_t controltype = 0;
     uint8_t RecvDataCount = 0;
     string logname = "camera";
-    logdata_output can_log(logname,to_string(dev_),ch_);
-    // CANData_Output data_Output(logname);
+    CanBinLogger can_log(logname, to_string(dev_), ch_);
     while(ros::ok())
     {
         if (adcuDevStatus(dev_) == ADCU_DEV_STATUS_ABNORMAL)
@@ -67,10 +66,10 @@ void MOBILEYE::CANMobileye(int &dev_, int &ch_)
         }
         adcuCanData canbuf_;
         int length = 0;
-        map< uint32_t, pFun >::iterator it;
+        pFun handler;
         canOrder can_order_;
         length     = adcuDevRead(dev_, ( uint8_t * )&canbuf_);
-        can_log.write_log(&canbuf_.can_data[0],canbuf_.id,8);
+        can_log.write_log(canbuf_, length);
         // data_Output.Openfile(logname,logname,canbuf_,ch_);
         if(length > 0)
         {
@@ -96,10 +95,10 @@ void MOBILEYE::CANMobileye(int &dev_, int &ch_)
                 case OBSTACLES:
                     if(RecvDataCount < mobileyeData.mobileyeObstaclesData.size())
                     {
-                        it = m_pHandlerMap.find(canbuf_.id);
-                        if(it != m_pHandlerMap.end())
+                        handler = m_pHandlerMap.find(canbuf_.id);
+                        if(handler != NULL)
                         {
-                            (this->*(it->second))(canbuf_, canbuf_.id, can_order_, ch_, controltype);
+                            (this->*handler)(canbuf_, canbuf_.id, can_order_, ch_, controltype);
                         }
                         if(MOBILEYE_OBSTACLE_DATA_C == canbuf_.id)
                         {
@@ -117,10 +116,10 @@ void MOBILEYE::CANMobileye(int &dev_, int &ch_)
                     if(MOBILEYE_LKA_RIGHT_LANE_B == canbuf_.id)
                     {
 
-                        it = m_pHandlerMap.find(canbuf_.id);
-                        if(it != m_pHandlerMap.end())
+                        handler = m_pHandlerMap.find(canbuf_.id);
+                        if(handler != NULL)
                         {
-                            (this->*(it->second))(canbuf_, canbuf_.id, can_order_, ch_, controltype);
+                            (this->*handler)(canbuf_, canbuf_.id, can_order_, ch_, controltype);
                         }
                         MOBILEYE_RECV_TYPE = NONE;
                         mobileyeData.bLaneReady = true;
@@ -128,10 +127,10 @@ void MOBILEYE::CANMobileye(int &dev_, int &ch_)
                     }
                     else
                     {
-                        it = m_pHandlerMap.find(canbuf_.id);
-                        if(it != m_pHandlerMap.end())
+                        handler = m_pHandlerMap.find(canbuf_.id);
+                        if(handler != NULL)
                         {
-                            (this->*(it->second))(canbuf_, canbuf_.id, can_order_, ch_, controltype);
+                            (this->*handler)(canbuf_, canbuf_.id, can_order_, ch_, controltype);
                         }
                     }
                     break;
@@ -339,59 +338,76 @@ void MOBILEYE::mobileye_Sender()
     }
 }
 
+static const CanFieldSetter<mobileyeDataStr>::Fn mobileye_lane_info_and_measure_setters[] = {
+    CAN_FIELD(mobileyeDataStr, confidence_lane_left),
+    CAN_FIELD(mobileyeDataStr, LDW_left),
+    CAN_FIELD(mobileyeDataStr, lane_type_left),
+    CAN_FIELD(mobileyeDataStr, distance_lane_left),
+    CAN_FIELD(mobileyeDataStr, confidence_lane_right),
+    CAN_FIELD(mobileyeDataStr, LDW_right),
+    CAN_FIELD(mobileyeDataStr, lane_type_right),
+    CAN_FIELD(mobileyeDataStr, distance_lane_right)
+};
+static_assert(sizeof(mobileye_lane_info_and_measure_setters) / sizeof(mobileye_lane_info_and_measure_setters[0]) == MOBILEYE_LANE_INFO_AND_MEASURE_SIG_NUM,
+              "mobileye_lane_info_and_measure_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeLaneInfoAndMeasureParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeLaneInfoAndMeasureParse", can_id);
-    mobileyeData.lane_type_left = can_buf.can_data[0] >> 4 & 0x0F;
-    mobileyeData.LDW_left = can_buf.can_data[0] >> 2 & 0x01;
-    mobileyeData.confidence_lane_left = can_buf.can_data[0] & 0x03;
-    mobileyeData.distance_lane_left = (can_buf.can_data[1] >> 4 & 0x0f) | can_buf.can_data[2] << 4;
-
-    mobileyeData.lane_type_right = can_buf.can_data[5] >> 4 & 0x0F;
-    mobileyeData.LDW_right = can_buf.can_data[5] >> 2 & 0x01;
-    mobileyeData.confidence_lane_right = can_buf.can_data[5] & 0x03;
-    mobileyeData.distance_lane_right = (can_buf.can_data[6] >> 4 & 0x0f) | can_buf.can_data[7] << 4;
+    canDecodeInto(CAN_MSG_MOBILEYE_LANE_INFO_AND_MEASURE, can_buf.can_data, mobileye_lane_info_and_measure_setters, mobileyeData);
 
     ROS_INFO("lane_type_left: %d, LDW_left: %d, confidence_lane_left: %d, distanc_lane_left: %d,lane_type_right: %d, LDW_right: %d, confidence_lane_right: %d, distance_lane_right: %d",
               mobileyeData.lane_type_left, mobileyeData.LDW_left, mobileyeData.confidence_lane_left, mobileyeData.distance_lane_left,
               mobileyeData.lane_type_right, mobileyeData.LDW_right, mobileyeData.confidence_lane_right, mobileyeData.distance_lane_right);
 }
 
+static const CanFieldSetter<mobileyeSystemWaringStr>::Fn mobileye_system_warning_setters[] = {
+    CAN_FIELD(mobileyeSystemWaringStr, sound_type),
+    CAN_FIELD(mobileyeSystemWaringStr, Time_Indicator),
+    CAN_FIELD(mobileyeSystemWaringStr, Zero_speed),
+    CAN_FIELD(mobileyeSystemWaringStr, Headway_Valid),
+    CAN_FIELD(mobileyeSystemWaringStr, Headway_measurement),
+    CAN_FIELD(mobileyeSystemWaringStr, Error_Valid),
+    CAN_FIELD(mobileyeSystemWaringStr, Error_Code),
+    CAN_FIELD(mobileyeSystemWaringStr, LDW_Off),
+    CAN_FIELD(mobileyeSystemWaringStr, Left_LDW_On),
+    CAN_FIELD(mobileyeSystemWaringStr, Right_LDW_On),
+    [](mobileyeSystemWaringStr &msg, double value) { msg.FCW_on = value; msg.FCW_On = value; },
+    CAN_FIELD(mobileyeSystemWaringStr, Maintenance),
+    CAN_FIELD(mobileyeSystemWaringStr, FailSafe),
+    CAN_FIELD(mobileyeSystemWaringStr, Peds_FCW),
+    CAN_FIELD(mobileyeSystemWaringStr, Peds_in_DZ),
+    CAN_FIELD(mobileyeSystemWaringStr, Tamper_Alert),
+    CAN_FIELD(mobileyeSystemWaringStr, TSR_Enabled),
+    CAN_FIELD(mobileyeSystemWaringStr, TSR_Warning_Level),
+    CAN_FIELD(mobileyeSystemWaringStr, Headway_Warning_Level),
+    CAN_FIELD(mobileyeSystemWaringStr, HW_Repeatable_Enabled)
+};
+static_assert(sizeof(mobileye_system_warning_setters) / sizeof(mobileye_system_warning_setters[0]) == MOBILEYE_SYSTEM_WARNING_SIG_NUM,
+              "mobileye_system_warning_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeSystemWarningParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeSystemWarningParse", can_id);
-    mobileyeData.mobileyeSystemWaring.sound_type = can_buf.can_data[0] & 0x07;
-    mobileyeData.mobileyeSystemWaring.Peds_in_DZ = can_buf.can_data[5] >> 2 & 0x01;
-    mobileyeData.mobileyeSystemWaring.Peds_FCW = can_buf.can_data[5] >> 1 & 0x01;
-    mobileyeData.mobileyeSystemWaring.FCW_on = can_buf.can_data[4] >> 3 & 0x01;
-    mobileyeData.mobileyeSystemWaring.Time_Indicator = can_buf.can_data[0] >> 3 & 0x03;
-    mobileyeData.mobileyeSystemWaring.Error_Valid = can_buf.can_data[3] & 0x01;
-    mobileyeData.mobileyeSystemWaring.Error_Code = can_buf.can_data[3] & 0xFE;
-    mobileyeData.mobileyeSystemWaring.Zero_speed = can_buf.can_data[1] >> 5 & 0x01;
-    mobileyeData.mobileyeSystemWaring.Headway_Valid = can_buf.can_data[2] & 0x01;
-    mobileyeData.mobileyeSystemWaring.Headway_measurement = (can_buf.can_data[2] & 0xFE) * 0.1;
-    mobileyeData.mobileyeSystemWaring.LDW_Off = can_buf.can_data[4] & 0x01;
-    mobileyeData.mobileyeSystemWaring.Left_LDW_On = can_buf.can_data[4] >> 1 & 0x01;
-    mobileyeData.mobileyeSystemWaring.Right_LDW_On = can_buf.can_data[4] >> 2 & 0x01;
-    mobileyeData.mobileyeSystemWaring.Maintenance = can_buf.can_data[4] >> 6 & 0x01;
-    mobileyeData.mobileyeSystemWaring.FailSafe = can_buf.can_data[4] >> 7 & 0x01;
-    mobileyeData.mobileyeSystemWaring.FCW_On = can_buf.can_data[4] >> 3 & 0x01;
-    mobileyeData.mobileyeSystemWaring.TSR_Enabled = can_buf.can_data[5] >> 7 & 0x01;
-    mobileyeData.mobileyeSystemWaring.HW_Repeatable_Enabled = can_buf.can_data[7] >> 1 & 0x03;
-    mobileyeData.mobileyeSystemWaring.Headway_Warning_Level = can_buf.can_data[7] & 0x01;
-    mobileyeData.mobileyeSystemWaring.TSR_Warning_Level = can_buf.can_data[6] & 0x03;
-    mobileyeData.mobileyeSystemWaring.Tamper_Alert = can_buf.can_data[5] >> 5 & 0x01;
+    canDecodeInto(CAN_MSG_MOBILEYE_SYSTEM_WARNING, can_buf.can_data, mobileye_system_warning_setters, mobileyeData.mobileyeSystemWaring);
 }
 
+static const CanFieldSetter<mobileyeTSRTypeAndPositionStr>::Fn mobileye_tsr_type_and_position_setters[] = {
+    CAN_FIELD(mobileyeTSRTypeAndPositionStr, Vision_Only_Sign_Type),
+    CAN_FIELD(mobileyeTSRTypeAndPositionStr, Supplementary_Sign_Type),
+    CAN_FIELD(mobileyeTSRTypeAndPositionStr, Sign_Position_X),
+    CAN_FIELD(mobileyeTSRTypeAndPositionStr, Sign_Position_Y),
+    CAN_FIELD(mobileyeTSRTypeAndPositionStr, Sign_Position_Z),
+    CAN_FIELD(mobileyeTSRTypeAndPositionStr, Filter_Type)
+};
+static_assert(sizeof(mobileye_tsr_type_and_position_setters) / sizeof(mobileye_tsr_type_and_position_setters[0]) == MOBILEYE_TSR_TYPE_AND_POSITION_SIG_NUM,
+              "mobileye_tsr_type_and_position_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeTSRTypeAndPositionParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeTSRTypeAndPositionParse", can_id);
-    mobileyeData.mobileyeTSRTypeAndPosition.Vision_Only_Sign_Type = can_buf.can_data[0];
-    mobileyeData.mobileyeTSRTypeAndPosition.Supplementary_Sign_Type = can_buf.can_data[1];
-    mobileyeData.mobileyeTSRTypeAndPosition.Sign_Position_X = can_buf.can_data[2] * 0.5;
-    mobileyeData.mobileyeTSRTypeAndPosition.Sign_Position_Y = (can_buf.can_data[3] & 0x7F) * 0.5;
-    mobileyeData.mobileyeTSRTypeAndPosition.Sign_Position_Z = (can_buf.can_data[4] & 0x3F) * 0.5;
-    mobileyeData.mobileyeTSRTypeAndPosition.Filter_Type = can_buf.can_data[5];
+    canDecodeInto(CAN_MSG_MOBILEYE_TSR_TYPE_AND_POSITION, can_buf.can_data, mobileye_tsr_type_and_position_setters,
+                  mobileyeData.mobileyeTSRTypeAndPosition);
     
     ROS_INFO("Vision_Only_Sign_Type: %d, Supplementary_Sign_Type: %d, Sign_Position_X: %d,Sign_Position_Y: %d, Sign_Position_Z: %d, Filter_Type: %d",
               mobileyeData.mobileyeTSRTypeAndPosition.Vision_Only_Sign_Type,mobileyeData.mobileyeTSRTypeAndPosition.Supplementary_Sign_Type,
@@ -399,17 +415,24 @@ void MOBILEYE::mobileyeTSRTypeAndPositionParse(adcuCanData &can_buf, uint32_t &c
               mobileyeData.mobileyeTSRTypeAndPosition.Sign_Position_Z,mobileyeData.mobileyeTSRTypeAndPosition.Filter_Type);
 }
 
+static const CanFieldSetter<mobileyeTSRVisionOnlyDecisionStr>::Fn mobileye_tsr_vision_decision_setters[] = {
+    CAN_FIELD(mobileyeTSRVisionOnlyDecisionStr, Vision_only_Sign_Type_1),
+    CAN_FIELD(mobileyeTSRVisionOnlyDecisionStr, Vision_only_Supplementary_Sign_Type_1),
+    CAN_FIELD(mobileyeTSRVisionOnlyDecisionStr, Vision_only_Sign_Type_2),
+    CAN_FIELD(mobileyeTSRVisionOnlyDecisionStr, Vision_only_Supplementary_Sign_Type_2),
+    CAN_FIELD(mobileyeTSRVisionOnlyDecisionStr, Vision_only_Sign_Type_3),
+    CAN_FIELD(mobileyeTSRVisionOnlyDecisionStr, Vision_only_Supplementary_Sign_Type_3),
+    CAN_FIELD(mobileyeTSRVisionOnlyDecisionStr, Vision_only_Sign_Type_4),
+    CAN_FIELD(mobileyeTSRVisionOnlyDecisionStr, Vision_only_Supplementary_Sign_Type_4)
+};
+static_assert(sizeof(mobileye_tsr_vision_decision_setters) / sizeof(mobileye_tsr_vision_decision_setters[0]) == MOBILEYE_TSR_VISION_DECISION_SIG_NUM,
+              "mobileye_tsr_vision_decision_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeTSRVisionDecisionPares(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeTSRVisionDecisionPares", can_id);
-    mobileyeData.mobileyeTSRVisionOnlyDecision.Vision_only_Sign_Type_1 = can_buf.can_data[0];
-    mobileyeData.mobileyeTSRVisionOnlyDecision.Vision_only_Supplementary_Sign_Type_1 = can_buf.can_data[0];
-    mobileyeData.mobileyeTSRVisionOnlyDecision.Vision_only_Sign_Type_2 = can_buf.can_data[0];
-    mobileyeData.mobileyeTSRVisionOnlyDecision.Vision_only_Supplementary_Sign_Type_2 = can_buf.can_data[0];
-    mobileyeData.mobileyeTSRVisionOnlyDecision.Vision_only_Sign_Type_3 = can_buf.can_data[0];
-    mobileyeData.mobileyeTSRVisionOnlyDecision.Vision_only_Supplementary_Sign_Type_3 = can_buf.can_data[0];
-    mobileyeData.mobileyeTSRVisionOnlyDecision.Vision_only_Sign_Type_4 = can_buf.can_data[0];
-    mobileyeData.mobileyeTSRVisionOnlyDecision.Vision_only_Supplementary_Sign_Type_4 = can_buf.can_data[0];
+    canDecodeInto(CAN_MSG_MOBILEYE_TSR_VISION_DECISION, can_buf.can_data, mobileye_tsr_vision_decision_setters,
+                  mobileyeData.mobileyeTSRVisionOnlyDecision);
 
     ROS_INFO("Vision_only_Sign_Type_1: %d, Vision_only_Sign_Type_1: %d, Vision_only_Sign_Type_1: %d, Vision_only_Sign_Type_1: %d,Vision_only_Supplementary_Sign_Type_1: %d, Vision_only_Supplementary_Sign_Type_2: %d, Vision_only_Supplementary_Sign_Type_3: %d, Vision_only_Supplementary_Sign_Type_4: %d", 
               mobileyeData.mobileyeTSRVisionOnlyDecision.Vision_only_Sign_Type_1,mobileyeData.mobileyeTSRVisionOnlyDecision.Vision_only_Sign_Type_2,
@@ -420,21 +443,28 @@ void MOBILEYE::mobileyeTSRVisionDecisionPares(adcuCanData &can_buf, uint32_t &ca
               mobileyeData.mobileyeTSRVisionOnlyDecision.Vision_only_Supplementary_Sign_Type_4);
 }
 
+static const CanFieldSetter<mobileyeLightsLocationAndAnglesStr>::Fn mobileye_lights_location_and_angles_setters[] = {
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, BNDRY_DOM_BOT_NGL_HLB),
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, BNDRY_DOM_NGL_LH_HLB),
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, BNDRY_DOM_NGL_RH_HLB),
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, OBJ_DIST_HLB),
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, ST_BNDRY_DOM_BOT_NGL_HLB),
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, ST_BNDRY_DOM_NGL_LH_HLB),
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, ST_BNDRY_DOM_NGL_RH_HLB),
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, ST_OBJ_DIST_HLB),
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, Left_Target_Change),
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, Right_Target_Change),
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, Too_Many_Cars),
+    CAN_FIELD(mobileyeLightsLocationAndAnglesStr, Busy_Scene)
+};
+static_assert(sizeof(mobileye_lights_location_and_angles_setters) / sizeof(mobileye_lights_location_and_angles_setters[0]) == MOBILEYE_LIGHTS_LOCATION_AND_ANGLES_SIG_NUM,
+              "mobileye_lights_location_and_angles_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeLightsLocationAndAnglesPares(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeLightsLocationAndAnglesPares", can_id);
-    mobileyeData.mobileyeLightsLocationAndAngles.BNDRY_DOM_BOT_NGL_HLB = can_buf.can_data[0] * 0.1 - 10;
-    mobileyeData.mobileyeLightsLocationAndAngles.BNDRY_DOM_NGL_LH_HLB = (can_buf.can_data[2] << 8 | can_buf.can_data[1]) * 0.1 - 20;
-    mobileyeData.mobileyeLightsLocationAndAngles.BNDRY_DOM_NGL_RH_HLB = (can_buf.can_data[3] << 4 | (can_buf.can_data[2] >> 4 & 0x0F)) * 0.1 - 20;
-    mobileyeData.mobileyeLightsLocationAndAngles.OBJ_DIST_HLB = (can_buf.can_data[4] & 0x00FF) * 2;
-    mobileyeData.mobileyeLightsLocationAndAngles.ST_BNDRY_DOM_BOT_NGL_HLB = can_buf.can_data[5] & 0x03;
-    mobileyeData.mobileyeLightsLocationAndAngles.ST_BNDRY_DOM_NGL_LH_HLB = can_buf.can_data[5] >> 2 & 0x03;
-    mobileyeData.mobileyeLightsLocationAndAngles.ST_BNDRY_DOM_NGL_RH_HLB = can_buf.can_data[5] >> 4 & 0x03;
-    mobileyeData.mobileyeLightsLocationAndAngles.ST_OBJ_DIST_HLB = can_buf.can_data[5] >> 6 & 0x03;
-    mobileyeData.mobileyeLightsLocationAndAngles.Left_Target_Change = can_buf.can_data[6] & 0x01;
-    mobileyeData.mobileyeLightsLocationAndAngles.Right_Target_Change = can_buf.can_data[6] >> 1 & 0x01;
-    mobileyeData.mobileyeLightsLocationAndAngles.Too_Many_Cars = can_buf.can_data[6] >> 2 & 0x01;
-    mobileyeData.mobileyeLightsLocationAndAngles.Busy_Scene = can_buf.can_data[6] >> 3 & 0x01;
+    canDecodeInto(CAN_MSG_MOBILEYE_LIGHTS_LOCATION_AND_ANGLES, can_buf.can_data, mobileye_lights_location_and_angles_setters,
+                  mobileyeData.mobileyeLightsLocationAndAngles);
 
     ROS_INFO("BNDRY_DOM_BOT_NGL_HLB: %d, BNDRY_DOM_NGL_LH_HLB: %d, BNDRY_DOM_NGL_RH_HLB: %d, OBJ_DIST_HLB: %d,ST_BNDRY_DOM_BOT_NGL_HLB: %d, ST_BNDRY_DOM_NGL_LH_HLB: %d, ST_BNDRY_DOM_NGL_RH_HLB: %d, ST_OBJ_DIST_HLB: %d, Left_Target_Change: %d, Right_Target_Change: %d, Too_Many_Cars: %d, Busy_Scene: %d",
               mobileyeData.mobileyeLightsLocationAndAngles.BNDRY_DOM_BOT_NGL_HLB,mobileyeData.mobileyeLightsLocationAndAngles.BNDRY_DOM_NGL_LH_HLB,
@@ -445,16 +475,23 @@ void MOBILEYE::mobileyeLightsLocationAndAnglesPares(adcuCanData &can_buf, uint32
               mobileyeData.mobileyeLightsLocationAndAngles.Too_Many_Cars,mobileyeData.mobileyeLightsLocationAndAngles.Busy_Scene);
 }
 
+static const CanFieldSetter<mobileyeLaneInfoMeasureStr>::Fn mobileye_lane_info_measure_setters[] = {
+    CAN_FIELD(mobileyeLaneInfoMeasureStr, Lane_Curvature),
+    CAN_FIELD(mobileyeLaneInfoMeasureStr, Lane_Heading),
+    CAN_FIELD(mobileyeLaneInfoMeasureStr, CA_construction_area),
+    CAN_FIELD(mobileyeLaneInfoMeasureStr, Right_LDW_Availability),
+    CAN_FIELD(mobileyeLaneInfoMeasureStr, Left_LDW_Availability),
+    CAN_FIELD(mobileyeLaneInfoMeasureStr, Yaw_Angle),
+    CAN_FIELD(mobileyeLaneInfoMeasureStr, Pitch_Angle)
+};
+static_assert(sizeof(mobileye_lane_info_measure_setters) / sizeof(mobileye_lane_info_measure_setters[0]) == MOBILEYE_LANE_INFO_MEASURE_SIG_NUM,
+              "mobileye_lane_info_measure_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeLaneInfoMeasureParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeLaneInfoMeasureParse", can_id);
-    mobileyeData.mobileyeLaneInfoMeasure.Lane_Curvature = (can_buf.can_data[0] + can_buf.can_data[1] << 8) * 3.81 * 0.000001;
-    mobileyeData.mobileyeLaneInfoMeasure.Lane_Heading = (can_buf.can_data[2] + can_buf.can_data[3] << 8 & 0x0F) * 0.0005;
-    mobileyeData.mobileyeLaneInfoMeasure.CA_construction_area = can_buf.can_data[3] >> 4 & 0x01;
-    mobileyeData.mobileyeLaneInfoMeasure.Pitch_Angle = (((can_buf.can_data[7] << 8 | can_buf.can_data[6]) - 0x7FFF)/1024)/512;
-    mobileyeData.mobileyeLaneInfoMeasure.Yaw_Angle = (can_buf.can_data[5] << 8 | can_buf.can_data[4])/1024;
-    mobileyeData.mobileyeLaneInfoMeasure.Right_LDW_Availability = can_buf.can_data[3] >> 5 & 0x01;
-    mobileyeData.mobileyeLaneInfoMeasure.Left_LDW_Availability = can_buf.can_data[3] >> 6 & 0x01;
+    canDecodeInto(CAN_MSG_MOBILEYE_LANE_INFO_MEASURE, can_buf.can_data, mobileye_lane_info_measure_setters,
+                  mobileyeData.mobileyeLaneInfoMeasure);
 
     ROS_INFO("Lane_Curvature: %f, Lane_Heading: %f, CA_construction_area: %d, Pitch_Angle: %f, Yaw_Angle: %f, Right_LDW_Availability: %d, Left_LDW_Availability: %d",
               mobileyeData.mobileyeLaneInfoMeasure.Lane_Curvature,mobileyeData.mobileyeLaneInfoMeasure.Lane_Heading,
@@ -463,16 +500,23 @@ void MOBILEYE::mobileyeLaneInfoMeasureParse(adcuCanData &can_buf, uint32_t &can_
               mobileyeData.mobileyeLaneInfoMeasure.Left_LDW_Availability);
 }
 
+static const CanFieldSetter<mobileyeNumberOfObstaclesStr>::Fn mobileye_number_of_obstacles_setters[] = {
+    CAN_FIELD(mobileyeNumberOfObstaclesStr, Number_Of_Obstacles),
+    CAN_FIELD(mobileyeNumberOfObstaclesStr, Timestamp),
+    CAN_FIELD(mobileyeNumberOfObstaclesStr, Left_Close_Rang_Cut_In),
+    CAN_FIELD(mobileyeNumberOfObstaclesStr, Right_Close_Rang_Cut_In),
+    CAN_FIELD(mobileyeNumberOfObstaclesStr, Go),
+    CAN_FIELD(mobileyeNumberOfObstaclesStr, Close_car),
+    CAN_FIELD(mobileyeNumberOfObstaclesStr, Failsafe)
+};
+static_assert(sizeof(mobileye_number_of_obstacles_setters) / sizeof(mobileye_number_of_obstacles_setters[0]) == MOBILEYE_NUMBER_OF_OBSTACLES_SIG_NUM,
+              "mobileye_number_of_obstacles_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeNumberOfObstaclesParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeNumberOfObstaclesParse", can_id);
-    mobileyeData.mobileyeNumberOfObstacles.Number_Of_Obstacles = can_buf.can_data[0];
-    mobileyeData.mobileyeNumberOfObstacles.Timestamp = can_buf.can_data[1];
-    mobileyeData.mobileyeNumberOfObstacles.Left_Close_Rang_Cut_In = can_buf.can_data[3] >> 2 & 0x01;
-    mobileyeData.mobileyeNumberOfObstacles.Right_Close_Rang_Cut_In = can_buf.can_data[3] >> 3 & 0x01;
-    mobileyeData.mobileyeNumberOfObstacles.Go = can_buf.can_data[3] >> 4 & 0x0F;
-    mobileyeData.mobileyeNumberOfObstacles.Close_car = can_buf.can_data[5] & 0x01;
-    mobileyeData.mobileyeNumberOfObstacles.Failsafe = can_buf.can_data[5] >> 1 & 0x0F;
+    canDecodeInto(CAN_MSG_MOBILEYE_NUMBER_OF_OBSTACLES, can_buf.can_data, mobileye_number_of_obstacles_setters,
+                  mobileyeData.mobileyeNumberOfObstacles);
 
     ROS_INFO("Number_Of_Obstacles: %d, Timestamp: %d,Left_Close_Rang_Cut_In: %d,Right_Close_Rang_Cut_In: %d,Go: %d, Close_car: %d, Failsafe: %d",
               mobileyeData.mobileyeNumberOfObstacles.Number_Of_Obstacles,mobileyeData.mobileyeNumberOfObstacles.Timestamp,
@@ -481,20 +525,26 @@ void MOBILEYE::mobileyeNumberOfObstaclesParse(adcuCanData &can_buf, uint32_t &ca
               mobileyeData.mobileyeNumberOfObstacles.Failsafe);
 }
 
+static const CanFieldSetter<mobileyeObstaclesDataStr>::Fn mobileye_obstacle_data_a_setters[] = {
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_ID),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Position_X),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Position_Y),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Relative_Velocity_X),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Type),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Status),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Brake_Lights),
+    CAN_FIELD(mobileyeObstaclesDataStr, Cut_In_And_Out),
+    CAN_FIELD(mobileyeObstaclesDataStr, Blinker_Info),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Valid)
+};
+static_assert(sizeof(mobileye_obstacle_data_a_setters) / sizeof(mobileye_obstacle_data_a_setters[0]) == MOBILEYE_OBSTACLE_DATA_A_SIG_NUM,
+              "mobileye_obstacle_data_a_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeObstaclesData_AParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeObstaclesData_AParse", can_id);
     mobileyeObstaclesDataStr mobileyeObstaclesData_;
-    mobileyeObstaclesData_.Obstacle_ID = can_buf.can_data[0];
-    mobileyeObstaclesData_.Obstacle_Position_X = ((can_buf.can_data[2] << 8 & 0x0F00) | can_buf.can_data[1]) * 0.0625;
-    mobileyeObstaclesData_.Obstacle_Position_Y = ((can_buf.can_data[4] << 8 & 0x0300) | can_buf.can_data[3]) * 0.0625;
-    mobileyeObstaclesData_.Obstacle_Relative_Velocity_X = ((can_buf.can_data[6] << 8 & 0x0F00) | can_buf.can_data[5]) * 0.0625;
-    mobileyeObstaclesData_.Obstacle_Type = can_buf.can_data[6] >> 4 & 0x07;
-    mobileyeObstaclesData_.Obstacle_Status = can_buf.can_data[7] & 0x07;
-    mobileyeObstaclesData_.Obstacle_Brake_Lights = can_buf.can_data[7] >> 3 & 0x01;
-    mobileyeObstaclesData_.Cut_In_And_Out = can_buf.can_data[4] >> 5 & 0x07;
-    mobileyeObstaclesData_.Blinker_Info = can_buf.can_data[4] >> 2 & 0x07;
-    mobileyeObstaclesData_.Obstacle_Valid = can_buf.can_data[7] >> 6 & 0x03;
+    canDecodeInto(CAN_MSG_MOBILEYE_OBSTACLE_DATA_A, can_buf.can_data, mobileye_obstacle_data_a_setters, mobileyeObstaclesData_);
 
     ROS_INFO("Obstacle_ID: %d, Obstacle_Position_X: %f, Obstacle_Position_Y: %f, Obstacle_Relative_Velocity_X: %f, Obstacle_Type: %d, Obstacle_Status: %d, Obstacle_Brake_Lights: %d, Cut_In_And_Out: %d, Blinker_Info: %d, Obstacle_Valid: %d",
               mobileyeObstaclesData_.Obstacle_ID,mobileyeObstaclesData_.Obstacle_Position_X,
@@ -523,19 +573,25 @@ void MOBILEYE::mobileyeObstaclesData_AParse(adcuCanData &can_buf, uint32_t &can_
     //           mobileyeData.mobileyeObstaclesData.Blinker_Info,mobileyeData.mobileyeObstaclesData.Obstacle_Valid);
 }
 
+static const CanFieldSetter<mobileyeObstaclesDataStr>::Fn mobileye_obstacle_data_b_setters[] = {
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Length),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Width),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Age),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Lane),
+    CAN_FIELD(mobileyeObstaclesDataStr, CIPV_Flag),
+    CAN_FIELD(mobileyeObstaclesDataStr, Radar_Position_X),
+    CAN_FIELD(mobileyeObstaclesDataStr, Radar_Velocity_X),
+    CAN_FIELD(mobileyeObstaclesDataStr, Radar_Match_Confidence),
+    CAN_FIELD(mobileyeObstaclesDataStr, Matched_Radar_ID)
+};
+static_assert(sizeof(mobileye_obstacle_data_b_setters) / sizeof(mobileye_obstacle_data_b_setters[0]) == MOBILEYE_OBSTACLE_DATA_B_SIG_NUM,
+              "mobileye_obstacle_data_b_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeObstaclesData_BParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeObstaclesData_BParse", can_id);
     mobileyeObstaclesDataStr mobileyeObstaclesData_;
-    mobileyeObstaclesData_.Obstacle_Length = can_buf.can_data[0] * 0.5;
-    mobileyeObstaclesData_.Obstacle_Width = can_buf.can_data[1] * 0.05;
-    mobileyeObstaclesData_.Obstacle_Age = can_buf.can_data[2];
-    mobileyeObstaclesData_.Obstacle_Lane = can_buf.can_data[3] & 0x03;
-    mobileyeObstaclesData_.CIPV_Flag = can_buf.can_data[3] >> 2 & 0x01;
-    mobileyeObstaclesData_.Radar_Position_X = ((can_buf.can_data[4] << 4 & 0x0FF0) | (can_buf.can_data[4] >> 4 & 0x0F)) * 0.0625;
-    mobileyeObstaclesData_.Radar_Velocity_X = ((can_buf.can_data[6] << 8 & 0xFF00) | can_buf.can_data[5]) * 0.0625;
-    mobileyeObstaclesData_.Radar_Match_Confidence = can_buf.can_data[6] >> 4 & 0x07;
-    mobileyeObstaclesData_.Matched_Radar_ID = can_buf.can_data[7] & 0x7F;
+    canDecodeInto(CAN_MSG_MOBILEYE_OBSTACLE_DATA_B, can_buf.can_data, mobileye_obstacle_data_b_setters, mobileyeObstaclesData_);
 
     ROS_INFO("Obstacle_Length: %f, Obstacle_Width: %f, Obstacle_Age: %d, Obstacle_Lane: %d, CIPV_Flag: %d, Radar_Position_X: %f, Radar_Velocity_X: %f, Radar_Match_Confidence: %d, Matched_Radar_ID: %d",
               mobileyeObstaclesData_.Obstacle_Length,mobileyeObstaclesData_.Obstacle_Width,
@@ -563,15 +619,21 @@ void MOBILEYE::mobileyeObstaclesData_BParse(adcuCanData &can_buf, uint32_t &can_
     //           mobileyeData.mobileyeObstaclesData.Matched_Radar_ID);
 }
 
+static const CanFieldSetter<mobileyeObstaclesDataStr>::Fn mobileye_obstacle_data_c_setters[] = {
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Angle_Rate),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Scale_Change),
+    CAN_FIELD(mobileyeObstaclesDataStr, Object_Accel_X),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Replaced),
+    CAN_FIELD(mobileyeObstaclesDataStr, Obstacle_Angle)
+};
+static_assert(sizeof(mobileye_obstacle_data_c_setters) / sizeof(mobileye_obstacle_data_c_setters[0]) == MOBILEYE_OBSTACLE_DATA_C_SIG_NUM,
+              "mobileye_obstacle_data_c_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeObstaclesData_CParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeObstaclesData_CParse", can_id);
     mobileyeObstaclesDataStr mobileyeObstaclesData_;
-    mobileyeObstaclesData_.Obstacle_Angle_Rate = ((can_buf.can_data[1] << 8 & 0xFF00) | can_buf.can_data[0]) * 0.01;
-    mobileyeObstaclesData_.Obstacle_Scale_Change = ((can_buf.can_data[3] << 8 & 0xFF00) | can_buf.can_data[2]) * 0.0002;
-    mobileyeObstaclesData_.Object_Accel_X = ((can_buf.can_data[5] << 8 & 0x0300) | can_buf.can_data[4]) * 0.03;
-    mobileyeObstaclesData_.Obstacle_Replaced = can_buf.can_data[5] >> 4 & 0x01;
-    mobileyeObstaclesData_.Obstacle_Angle = ((can_buf.can_data[7] << 8 & 0xFF00) | can_buf.can_data[6]) * 0.01;
+    canDecodeInto(CAN_MSG_MOBILEYE_OBSTACLE_DATA_C, can_buf.can_data, mobileye_obstacle_data_c_setters, mobileyeObstaclesData_);
     
     mobileyeData.mobileyeObstaclesData.push_back(mobileyeObstaclesData_);
 
@@ -592,20 +654,27 @@ void MOBILEYE::mobileyeObstaclesData_CParse(adcuCanData &can_buf, uint32_t &can_
     //           mobileyeData.mobileyeObstaclesData.Obstacle_Angle);
 }
 
+static const CanFieldSetter<mobileyeSignalsStatusStr>::Fn mobileye_signals_status_setters[] = {
+    CAN_FIELD(mobileyeSignalsStatusStr, Brake_signal),
+    CAN_FIELD(mobileyeSignalsStatusStr, Left_signal),
+    CAN_FIELD(mobileyeSignalsStatusStr, Right_signal),
+    CAN_FIELD(mobileyeSignalsStatusStr, Wipers),
+    CAN_FIELD(mobileyeSignalsStatusStr, Low_Beam),
+    CAN_FIELD(mobileyeSignalsStatusStr, High_Beam),
+    CAN_FIELD(mobileyeSignalsStatusStr, Wipers_available),
+    CAN_FIELD(mobileyeSignalsStatusStr, Low_Beam_available),
+    CAN_FIELD(mobileyeSignalsStatusStr, High_Beam_Available),
+    CAN_FIELD(mobileyeSignalsStatusStr, Speed_Available),
+    CAN_FIELD(mobileyeSignalsStatusStr, Speed)
+};
+static_assert(sizeof(mobileye_signals_status_setters) / sizeof(mobileye_signals_status_setters[0]) == MOBILEYE_SIGNALS_STATUS_SIG_NUM,
+              "mobileye_signals_status_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeSignalsStatusVehicleParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeSignalsStatusVehicleParse", can_id);
-    mobileyeData.mobileyeSignalsStatus.High_Beam = can_buf.can_data[0] >> 5 & 0x01;
-    mobileyeData.mobileyeSignalsStatus.Low_Beam = can_buf.can_data[0] >> 4 & 0x01;
-    mobileyeData.mobileyeSignalsStatus.Wipers = can_buf.can_data[0] >> 3 & 0x01;
-    mobileyeData.mobileyeSignalsStatus.Right_signal = can_buf.can_data[0] >> 2 & 0x01;
-    mobileyeData.mobileyeSignalsStatus.Left_signal = can_buf.can_data[0] >> 1 & 0x01;
-    mobileyeData.mobileyeSignalsStatus.Brake_signal = can_buf.can_data[0] & 0x01;
-    mobileyeData.mobileyeSignalsStatus.Wipers_available = can_buf.can_data[1] >> 3 & 0x01;
-    mobileyeData.mobileyeSignalsStatus.Low_Beam_available = can_buf.can_data[1] >> 4 & 0x01;
-    mobileyeData.mobileyeSignalsStatus.High_Beam_Available = can_buf.can_data[1] >> 5 & 0x01;
-    mobileyeData.mobileyeSignalsStatus.Speed_Available = can_buf.can_data[1] >> 7 & 0x01;
-    mobileyeData.mobileyeSignalsStatus.Speed = can_buf.can_data[2];
+    canDecodeInto(CAN_MSG_MOBILEYE_SIGNALS_STATUS, can_buf.can_data, mobileye_signals_status_setters,
+                  mobileyeData.mobileyeSignalsStatus);
 
     ROS_INFO("High_Beam: %d, Low_Beam: %d, Wipers: %d, Right_signal: %d, Left_signal: %d, Brake_signal: %d,Wipers_available: %d, Low_Beam_available: %d, High_Beam_Available: %d, Speed_Available: %d, Speed: %d",
               mobileyeData.mobileyeSignalsStatus.High_Beam,mobileyeData.mobileyeSignalsStatus.Low_Beam,
@@ -616,16 +685,31 @@ void MOBILEYE::mobileyeSignalsStatusVehicleParse(adcuCanData &can_buf, uint32_t
               mobileyeData.mobileyeSignalsStatus.Speed);
 }
 
+//左右车道线 A/B 报文格式相同, 共用赋值表
+static const CanFieldSetter<mobileyeLKALaneStr>::Fn mobileye_lka_lane_a_setters[] = {
+    CAN_FIELD(mobileyeLKALaneStr, Lane_type),
+    CAN_FIELD(mobileyeLKALaneStr, Quality),
+    CAN_FIELD(mobileyeLKALaneStr, Model_degree),
+    CAN_FIELD(mobileyeLKALaneStr, Position_Parameter_C0),
+    CAN_FIELD(mobileyeLKALaneStr, Curvature_Parameter_C2),
+    CAN_FIELD(mobileyeLKALaneStr, Curvature_Derivative_Parameter_C3),
+    CAN_FIELD(mobileyeLKALaneStr, Width_Marking)
+};
+static_assert(sizeof(mobileye_lka_lane_a_setters) / sizeof(mobileye_lka_lane_a_setters[0]) == MOBILEYE_LKA_LANE_A_SIG_NUM,
+              "mobileye_lka_lane_a_setters 与信号数不一致");
+
+static const CanFieldSetter<mobileyeLKALaneStr>::Fn mobileye_lka_lane_b_setters[] = {
+    CAN_FIELD(mobileyeLKALaneStr, Heading_Angle_Parameter_C1),
+    CAN_FIELD(mobileyeLKALaneStr, View_Range),
+    CAN_FIELD(mobileyeLKALaneStr, View_range_availability)
+};
+static_assert(sizeof(mobileye_lka_lane_b_setters) / sizeof(mobileye_lka_lane_b_setters[0]) == MOBILEYE_LKA_LANE_B_SIG_NUM,
+              "mobileye_lka_lane_b_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeLKALeftLane_AParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeLKALeftLane_AParse", can_id);
-    mobileyeLKALane_.Lane_type = can_buf.can_data[0] & 0x0F;
-    mobileyeLKALane_.Quality = can_buf.can_data[0] >> 4 & 0x03;
-    mobileyeLKALane_.Model_degree = can_buf.can_data[0] >> 6 & 0x03;
-    mobileyeLKALane_.Position_Parameter_C0 = (can_buf.can_data[2] << 8 & 0xFF00 | can_buf.can_data[1]) / 256;
-    mobileyeLKALane_.Curvature_Parameter_C2 = ((can_buf.can_data[4] << 8 & 0xFF00 | can_buf.can_data[3]) - 0x7FFF) / 1024 / 1000;
-    mobileyeLKALane_.Curvature_Derivative_Parameter_C3 = ((can_buf.can_data[6] << 8 & 0xFF00 | can_buf.can_data[5]) - 0x7FFF) / (1 << 28);
-    mobileyeLKALane_.Width_Marking = can_buf.can_data[7] * 0.01;
+    canDecodeInto(CAN_MSG_MOBILEYE_LKA_LANE_A, can_buf.can_data, mobileye_lka_lane_a_setters, mobileyeLKALane_);
 
     ROS_INFO("Lane_type: %d, Quality: %d, Model_degree: %d, Position_Parameter_C0: %f,Curvature_Parameter_C2: %f, Curvature_Derivative_Parameter_C3: %f, Width_Left_Marking: %f",
               mobileyeLKALane_.Lane_type,mobileyeLKALane_.Quality,mobileyeLKALane_.Model_degree,
@@ -650,9 +734,7 @@ void MOBILEYE::mobileyeLKALeftLane_AParse(adcuCanData &can_buf, uint32_t &can_id
 void MOBILEYE::mobileyeLKALeftLane_BParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeLKALeftLane_BParse", can_id);
-    mobileyeLKALane_.Heading_Angle_Parameter_C1 = ((can_buf.can_data[1] << 8 & 0xFF00 | can_buf.can_data[0]) - 0x7FFF) / 1024;
-    mobileyeLKALane_.View_Range = (can_buf.can_data[3] << 8 & 0x7F00 | can_buf.can_data[2]) / 256;
-    mobileyeLKALane_.View_range_availability = can_buf.can_data[3] >> 7 & 0x01;
+    canDecodeInto(CAN_MSG_MOBILEYE_LKA_LANE_B, can_buf.can_data, mobileye_lka_lane_b_setters, mobileyeLKALane_);
 
     mobileyeData.mobileyeLKALeftLane.push_back(mobileyeLKALane_);
 
@@ -674,13 +756,7 @@ void MOBILEYE::mobileyeLKALeftLane_BParse(adcuCanData &can_buf, uint32_t &can_id
 void MOBILEYE::mobileyeLKARightLane_AParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeLKARightLane_AParse", can_id);
-    mobileyeLKALane_.Lane_type = can_buf.can_data[0] & 0x0F;
-    mobileyeLKALane_.Quality = can_buf.can_data[0] >> 4 & 0x03;
-    mobileyeLKALane_.Model_degree = can_buf.can_data[0] >> 6 & 0x03;
-    mobileyeLKALane_.Position_Parameter_C0 = (can_buf.can_data[2] << 8 & 0xFF00 | can_buf.can_data[1]) / 256;
-    mobileyeLKALane_.Curvature_Parameter_C2 = ((can_buf.can_data[4] << 8 & 0xFF00 | can_buf.can_data[3]) - 0x7FFF) / 1024 / 1000;
-    mobileyeLKALane_.Curvature_Derivative_Parameter_C3 = ((can_buf.can_data[6] << 8 & 0xFF00 | can_buf.can_data[5]) - 0x7FFF) / (1 << 28);
-    mobileyeLKALane_.Width_Marking = can_buf.can_data[7] * 0.01;
+    canDecodeInto(CAN_MSG_MOBILEYE_LKA_LANE_A, can_buf.can_data, mobileye_lka_lane_a_setters, mobileyeLKALane_);
 
     ROS_INFO("Lane_type: %d, Quality: %d, Model_degree: %d, Position_Parameter_C0: %f,Curvature_Parameter_C2: %f, Curvature_Derivative_Parameter_C3: %f, Width_Left_Marking: %f",
               mobileyeLKALane_.Lane_type,mobileyeLKALane_.Quality,mobileyeLKALane_.Model_degree,
@@ -705,9 +781,7 @@ void MOBILEYE::mobileyeLKARightLane_AParse(adcuCanData &can_buf, uint32_t &can_i
 void MOBILEYE::mobileyeLKARightLane_BParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeLKARightLane_BParse", can_id);
-    mobileyeLKALane_.Heading_Angle_Parameter_C1 = ((can_buf.can_data[1] << 8 & 0xFF00 | can_buf.can_data[0]) - 0x7FFF) / 1024;
-    mobileyeLKALane_.View_Range = (can_buf.can_data[3] << 8 & 0x7F00 | can_buf.can_data[2]) / 256;
-    mobileyeLKALane_.View_range_availability = can_buf.can_data[3] >> 7 & 0x01;
+    canDecodeInto(CAN_MSG_MOBILEYE_LKA_LANE_B, can_buf.can_data, mobileye_lka_lane_b_setters, mobileyeLKALane_);
 
     mobileyeData.mobileyeLKARightLane.push_back(mobileyeLKALane_);
 
@@ -726,16 +800,22 @@ void MOBILEYE::mobileyeLKARightLane_BParse(adcuCanData &can_buf, uint32_t &can_i
     //           mobileyeData.mobileyeLKARightLane.View_range_availability);
 }
 
+static const CanFieldSetter<mobileyeReferencePointsStr>::Fn mobileye_reference_points_setters[] = {
+    CAN_FIELD(mobileyeReferencePointsStr, Ref_Point_1_Position),
+    CAN_FIELD(mobileyeReferencePointsStr, Ref_Point_1_Distance),
+    CAN_FIELD(mobileyeReferencePointsStr, Ref_Point_1_Validity),
+    CAN_FIELD(mobileyeReferencePointsStr, Ref_Point_2_Position),
+    CAN_FIELD(mobileyeReferencePointsStr, Ref_Point_2_Distance),
+    CAN_FIELD(mobileyeReferencePointsStr, Ref_Point_2_Validity)
+};
+static_assert(sizeof(mobileye_reference_points_setters) / sizeof(mobileye_reference_points_setters[0]) == MOBILEYE_REFERENCE_POINTS_SIG_NUM,
+              "mobileye_reference_points_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeReference_PointsParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeReference_PointsParse", can_id);
-    mobileyeData.mobileyeReferencePoints.Ref_Point_1_Position = (((can_buf.can_data[1] << 8 | 0xFF00) & can_buf.can_data[0]) - 0x7FFF) / 256;
-    mobileyeData.mobileyeReferencePoints.Ref_Point_1_Distance = ((can_buf.can_data[3] << 8 | 0x7F00) & can_buf.can_data[2]) / 256;
-    mobileyeData.mobileyeReferencePoints.Ref_Point_1_Validity = can_buf.can_data[3] >> 7 & 0x01;
-
-    mobileyeData.mobileyeReferencePoints.Ref_Point_2_Position = (((can_buf.can_data[5] << 8 | 0xFF00) & can_buf.can_data[4]) - 0x7FFF) / 256;
-    mobileyeData.mobileyeReferencePoints.Ref_Point_2_Distance = ((can_buf.can_data[7] << 8 | 0x7F00) & can_buf.can_data[6]) / 256;
-    mobileyeData.mobileyeReferencePoints.Ref_Point_2_Validity = can_buf.can_data[7] >> 7 & 0x01;
+    canDecodeInto(CAN_MSG_MOBILEYE_REFERENCE_POINTS, can_buf.can_data, mobileye_reference_points_setters,
+                  mobileyeData.mobileyeReferencePoints);
 
     ROS_INFO("Ref_Point_1_Position: %f, Ref_Point_1_Distance: %f, Ref_Point_1_Validity: %d,Ref_Point_2_Position: %f, Ref_Point_2_Distance: %f, Ref_Point_2_Validity: %d",
               mobileyeData.mobileyeReferencePoints.Ref_Point_1_Position,
@@ -746,10 +826,17 @@ void MOBILEYE::mobileyeReference_PointsParse(adcuCanData &can_buf, uint32_t &can
               mobileyeData.mobileyeReferencePoints.Ref_Point_2_Validity);
 }
 
+static const CanFieldSetter<mobileyeNUmberOfNextLaneStr>::Fn mobileye_number_of_next_lane_setters[] = {
+    CAN_FIELD(mobileyeNUmberOfNextLaneStr, Number_Of_Next_Lane_Markers_Reported)
+};
+static_assert(sizeof(mobileye_number_of_next_lane_setters) / sizeof(mobileye_number_of_next_lane_setters[0]) == MOBILEYE_NUMBER_OF_NEXT_LANE_SIG_NUM,
+              "mobileye_number_of_next_lane_setters 与信号数不一致");
+
 void MOBILEYE::mobileyeNunber_Of_Next_LaneParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_, uint16_t &contype)
 {
     ROS_INFO("recv: %d mobileyeNunber_Of_Next_LaneParse", can_id);
-    mobileyeData.mobileyeNUmberOfNextLane.Number_Of_Next_Lane_Markers_Reported = can_buf.can_data[0];
+    canDecodeInto(CAN_MSG_MOBILEYE_NUMBER_OF_NEXT_LANE, can_buf.can_data, mobileye_number_of_next_lane_setters,
+                  mobileyeData.mobileyeNUmberOfNextLane);
 
     ROS_INFO("Number_Of_Next_Lane_Markers_Reported: %d",mobileyeData.mobileyeNUmberOfNextLane.Number_Of_Next_Lane_Markers_Reported);
 }
@@ -31,7 +31,7 @@
 #include <time.h>
 // #include <TLHelp.h>
 #include <event.h>
-#include "Apath.h"
+#include "grid/grid_planner.h"
 #include "control_msgs/AGVStatus.h"
 #include "perception_sensor_msgs/UltrasonicInfo.h"
 #include "perception_sensor_msgs/ObjectList.h"
@@ -2840,34 +2840,30 @@ int main(int argc,char* argv[])
 
     // cout << 210%100/10 << endl;
 
-    int row = MAP_MAX_X, col = MAP_MAX_Y;
+    //约定：0是可走的，1表示障碍物不可走，2表示起点，3表示终点
     printf("hello world!\n");
-    LNode **map = Translate_array(arr,row, col); //这里将数组的地图转为节点map的地图
-    output(map,10,10);
-    LinkList open_List = InitList();     //定义并初始化一个开放列表
-    LinkList close_List = InitList();    //一个封闭列表
-    LNode* startLNode = find_start_LNode(map, row, col);
-    LNode* endLNode = find_end_LNode(map, row, col);
-
-    LNode* curLNode = startLNode;        //当前节点=开始节点
-    curLNode->G = 0;        //计算节点的三个值
-    count_LNode_H(curLNode, endLNode);
-    count_LNode_F(curLNode);
-    push_OpenList_Node(open_List, curLNode);        //先将开始节点插入开放列表
-    while (curLNode->data != 3)
-    {
-        printf("~~~~~~~~~~~~~~~~\n");
-        //LNode *e = NULL;
-        curLNode = pop_OpenList_minNode(open_List);
-        printfnode(curLNode);
-        insert_Into_CloseList(curLNode, close_List);
-        //2、查看起点周围的点是否在开放列表里，不在加入，在检测经过该点F值是否最小等；
-        check_around_curNode(curLNode, endLNode, open_List, map);
-    }
-    while (endLNode->path_next)
-    {
-        printf("x:%d---y:%d\n", endLNode->path_next->x,endLNode->path_next->y);
-        endLNode->path_next = endLNode->path_next->path_next;
+    pnc::GridMap map(10, 10);
+    pnc::GridCell start_cell, end_cell;
+    for (int i = 0; i < 10; ++i)
+    {
+        for (int j = 0; j < 10; ++j)
+        {
+            if (arr[i][j] == 1)
+                map.setCost(i, j, GRID_COST_LETHAL);
+            else if (arr[i][j] == 2)
+                start_cell = pnc::GridCell(i, j);
+            else if (arr[i][j] == 3)
+                end_cell = pnc::GridCell(i, j);
+        }
+    }
+    pnc::GridPlanner planner;
+    vector< pnc::GridCell > path;
+    if (planner.plan(map, start_cell, end_cell, path))
+    {
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            printf("x:%d---y:%d\n", path[i].x, path[i].y);
+        }
     }
     return 0;
 
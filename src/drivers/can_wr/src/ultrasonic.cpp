@@ -7,16 +7,16 @@ namespace drivers
 
 ULTRASONIC::ULTRASONIC()
 {
-  m_pHandlerMap.insert(make_pair(ULTRASONIC_DATA_1, &ULTRASONIC::ultrasonicDataParse));
-  m_pHandlerMap.insert(make_pair(ULTRASONIC_DATA_2, &ULTRASONIC::ultrasonicDataParse));
-  m_pHandlerMap.insert(make_pair(ULTRASONIC_DATA_3, &ULTRASONIC::ultrasonicDataParse));
-  m_pHandlerMap.insert(make_pair(ULTRASONIC_DATA_4, &ULTRASONIC::ultrasonicDataParse));
-  m_pHandlerMap.insert(make_pair(ULTRASONIC_CONTROL, &ULTRASONIC::ultrasonicDataParse));
+  m_pHandlerMap.add(ULTRASONIC_DATA_1, &ULTRASONIC::ultrasonicDataParse);
+  m_pHandlerMap.add(ULTRASONIC_DATA_2, &ULTRASONIC::ultrasonicDataParse);
+  m_pHandlerMap.add(ULTRASONIC_DATA_3, &ULTRASONIC::ultrasonicDataParse);
+  m_pHandlerMap.add(ULTRASONIC_DATA_4, &ULTRASONIC::ultrasonicDataParse);
+  m_pHandlerMap.add(ULTRASONIC_CONTROL, &ULTRASONIC::ultrasonicDataParse);
   Ultrasonic_stat = Allstart_Ultrasonic;
-  map< uint32_t, pFun >::iterator it;
-  for (it = m_pHandlerMap.begin(); it != m_pHandlerMap.end(); ++it)
+  std::vector< uint32_t > keys = m_pHandlerMap.ids();
+  for (size_t i = 0; i < keys.size(); ++i)
   {
-    ROS_INFO("key %u", it->first);
+    ROS_INFO("key %u", keys[i]);
   }
 }
 
@@ -33,7 +33,7 @@ void ULTRASONIC::CANUltrasonic(int &ch_, int &dev_)
   uint16_t controltype      = 0;
   int sensor_num            = 0;
   string logname            = "ultrasonic";
-  logdata_output can_log(logname, to_string(dev_), ch_);
+  CanBinLogger can_log(logname, to_string(dev_), ch_);
   openCanRelay();
   // openCanRelay_();
   while (ros::ok())
@@ -49,7 +49,7 @@ void ULTRASONIC::CANUltrasonic(int &ch_, int &dev_)
     }
     adcuCanData canbuf_;
     int length = 0;
-    map< uint32_t, pFun >::iterator it;
+    pFun handler;
     canOrder can_order_;
     switch (Ultrasonic_stat)
     {
@@ -101,7 +101,7 @@ void ULTRASONIC::CANUltrasonic(int &ch_, int &dev_)
     case Work_Ultrasonic:
       // ROS_INFO("Ultrasonic_stat:Work!!!");
       length = adcuDevRead(dev_, ( uint8_t * )&canbuf_);
-      can_log.write_log(&canbuf_.can_data[0], canbuf_.id, 8);
+      can_log.write_log(canbuf_, length);
       // canbuf_.id = ULTRASONIC_DATA_1;
       sensor_num = int(canbuf_.id);
       q_sensor_push(sensor_num);
@@ -117,10 +117,10 @@ void ULTRASONIC::CANUltrasonic(int &ch_, int &dev_)
         if (canbuf_.id == ULTRASONIC_DATA_1 || canbuf_.id == ULTRASONIC_DATA_2 || canbuf_.id == ULTRASONIC_DATA_3 ||
             canbuf_.id == ULTRASONIC_DATA_4)
         {
-          it = m_pHandlerMap.find(canbuf_.id);
-          if (it != m_pHandlerMap.end())
+          handler = m_pHandlerMap.find(canbuf_.id);
+          if (handler != NULL)
           {
-            (this->*(it->second))(canbuf_, canbuf_.id, can_order_, ch_, controltype);
+            (this->*handler)(canbuf_, canbuf_.id, can_order_, ch_, controltype);
           }
           ++ultrasonicData.recv_count;
           if (ultrasonicData.recv_count >= 4)
@@ -256,6 +256,29 @@ void ULTRASONIC::ultrasonic_Sender()
   }
 }
 
+//按信号顺序写入 ultrasonicData, 与 can_message_db 中的超声波信号表一一对应
+static const CanFieldSetter< ultrasonicDataStr >::Fn ultrasonic_data_setters[] = {
+  CAN_FIELD(ultrasonicDataStr, ultrasonic1_distance),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic2_distance),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic3_distance),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic4_distance),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic5_distance),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic6_distance),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic7_distance),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic8_distance),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic1_status),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic2_status),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic3_status),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic4_status),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic5_status),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic6_status),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic7_status),
+  CAN_FIELD(ultrasonicDataStr, ultrasonic8_status),
+  CAN_FIELD(ultrasonicDataStr, controller_id)
+};
+static_assert(sizeof(ultrasonic_data_setters) / sizeof(ultrasonic_data_setters[0]) == ULTRASONIC_SIG_NUM,
+              "ultrasonic_data_setters 与信号数不一致");
+
 void ULTRASONIC::ultrasonicDataParse(adcuCanData &can_buf, uint32_t &can_id, canOrder &can_order, uint8_t ch_,
                                      uint16_t &contype)
 {
@@ -263,25 +286,8 @@ void ULTRASONIC::ultrasonicDataParse(adcuCanData &can_buf, uint32_t &can_id, can
   {
     // ROS_INFO("recv: %d ultrasonicDataParse", can_id);
   }
-  ultrasonicData.ultrasonic1_distance = (can_buf.can_data[0] & 0x3F) * 0.05;
-  ultrasonicData.ultrasonic2_distance = ((can_buf.can_data[1] << 2 & 0x3C) | (can_buf.can_data[0] >> 6 & 0x03)) * 0.05;
-  ultrasonicData.ultrasonic3_distance = ((can_buf.can_data[2] << 4 & 0x30) | (can_buf.can_data[1] >> 4 & 0x0F)) * 0.05;
-  ultrasonicData.ultrasonic4_distance = (can_buf.can_data[2] >> 2 & 0x3F) * 0.05;
-  ultrasonicData.ultrasonic5_distance = (can_buf.can_data[3] & 0x3F) * 0.05;
-  ultrasonicData.ultrasonic6_distance = ((can_buf.can_data[4] << 2 & 0x3C) | (can_buf.can_data[3] >> 6 & 0x03)) * 0.05;
-  ultrasonicData.ultrasonic7_distance = ((can_buf.can_data[5] << 4 & 0x30) | (can_buf.can_data[4] >> 4 & 0x0F)) * 0.05;
-  ultrasonicData.ultrasonic8_distance = (can_buf.can_data[5] >> 2 & 0x3F) * 0.05;
-
-  ultrasonicData.ultrasonic1_status = can_buf.can_data[6] & 0x01;
-  ultrasonicData.ultrasonic2_status = can_buf.can_data[6] & 0x02 >> 1;
-  ultrasonicData.ultrasonic3_status = can_buf.can_data[6] & 0x04 >> 2;
-  ultrasonicData.ultrasonic4_status = can_buf.can_data[6] & 0x08 >> 3;
-  ultrasonicData.ultrasonic5_status = can_buf.can_data[6] & 0x10 >> 4;
-  ultrasonicData.ultrasonic6_status = can_buf.can_data[6] & 0x20 >> 5;
-  ultrasonicData.ultrasonic7_status = can_buf.can_data[6] & 0x40 >> 6;
-  ultrasonicData.ultrasonic8_status = can_buf.can_data[6] & 0x80 >> 7;
-
-  ultrasonicData.controller_id = can_buf.can_data[7] & 0x03;
+  //信号定义见 can_signal.cpp
+  canDecodeInto(CAN_MSG_ULTRASONIC_DATA, can_buf.can_data, ultrasonic_data_setters, ultrasonicData);
   ultrasonicInfoStr ultrasonicInfo;
   if (ultrasonicData.ultrasonic1_distance <= ULTRASONIC_SAFEDISTANCE && ultrasonicData.ultrasonic1_distance >= ULTRASONIC_MINDISTANCE)
   {
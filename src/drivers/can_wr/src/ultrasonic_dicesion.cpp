@@ -1,4 +1,5 @@
 #include "ultrasonic_dicesion.h"
+#include <time.h>
 
 #define ULTRASONIC_DICESION_YAML_FILE_PATH "/work/superg_agv/src/drivers/can_wr/config/ultrasonic_dicesion.yaml"
 // #define ULTRASONIC_DICESION_FILE_NAME "/ultrasonic_dicesion.yaml"
@@ -6,38 +7,27 @@
 namespace superg_agv
 {
 
+static uint64_t steadyMs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
 Ultrasonic_Dicesion::Ultrasonic_Dicesion(ros::NodeHandle &nh)
 {
     // memset(agvstatus,0,sizeof(control_msgs::AGVStatus));
     // memset(ultrasonic_info,0,sizeof(perception_sensor_msgs::UltrasonicInfo));
-    b_Array_Area.clear();
-    i_Array_Ultrasonic_front.clear();
-    i_Array_Ultrasonic_tail.clear();
-    i_Array_Ultrasonic_right.clear();
-    i_Array_Ultrasonic_left.clear();
-    i_Array_Ultrasonic.clear();
     v_ultrantic_left.clear();
     v_ultrantic_right.clear();
     v_ultrantic_front.clear();
     v_ultrantic_tail.clear();
-    v_ultrantic_regional.clear();
     agvstatus.used = true;
     ultrasonic_info.used = true;
     string yaml_path = getenv("HOME");
     yaml_path += ULTRASONIC_DICESION_YAML_FILE_PATH;
     ROS_INFO_STREAM(yaml_path);
     YAML::Node yamlConfig = YAML::LoadFile(yaml_path);
-    for(uint16_t i = 0;i < 32;++i)
-    {
-        if(i < 4)
-            i_Array_Ultrasonic_front.push_back(i);
-        else if(i < 16)
-            i_Array_Ultrasonic_left.push_back(i);
-        else if(i < 20)
-            i_Array_Ultrasonic_tail.push_back(i);
-        else
-            i_Array_Ultrasonic_right.push_back(i);
-    }
     // car_length = 15470;
     // car_width = 2865;
     // Lf = 5508.5;
@@ -46,15 +36,6 @@ Ultrasonic_Dicesion::Ultrasonic_Dicesion(ros::NodeHandle &nh)
     car_width = yamlConfig["car_width"].as<float>();
     Lf = yamlConfig["Lf"].as<float>();
     Lr = yamlConfig["Lf"].as<float>();
-    car_slip_angle = 0;
-    car_w = 0;
-    car_R = 0;
-    Ox = 0;
-    Oy = 0;
-    car_R1 = 0;
-    car_R2 = 0;
-    car_R3 = 0;
-    car_R4 = 0;
     point point_;
     for(unsigned j = 0;j < yamlConfig["Ultrasonic_front_list"].size();++j)
     {
@@ -121,6 +102,53 @@ Ultrasonic_Dicesion::Ultrasonic_Dicesion(ros::NodeHandle &nh)
     //         v_ultrantic_right.push_back(point_);
     //     }
     // }
+
+    //区域探头掩码取自上面的探头列表, 其余参数缺省时使用 UltrasonicScreeningConfig 的默认值
+    UltrasonicScreeningConfig screening_config;
+    const vector<point> *area_list[ULT_AREA_NUM] = {&v_ultrantic_front,&v_ultrantic_left,&v_ultrantic_tail,&v_ultrantic_right};
+    for(int area = 0;area < ULT_AREA_NUM;++area)
+    {
+        screening_config.area_sensor_mask[area] = 0;
+        for(vector<point>::const_iterator ite_point = area_list[area]->begin();ite_point != area_list[area]->end();++ite_point)
+        {
+            if(ite_point->index >= 0 && ite_point->index < ULTRASONIC_SENSOR_NUM)
+            {
+                screening_config.area_sensor_mask[area] |= 1u << ite_point->index;
+            }
+        }
+    }
+    YAML::Node screening_node = yamlConfig["Screening"];
+    if(screening_node)
+    {
+        if(screening_node["steer_deadband"])
+            screening_config.steer_deadband = screening_node["steer_deadband"].as<float>();
+        if(screening_node["speed_stop"])
+            screening_config.speed_stop = screening_node["speed_stop"].as<float>();
+        if(screening_node["speed_high"])
+            screening_config.speed_high = screening_node["speed_high"].as<float>();
+        if(screening_node["stop_distance"] && screening_node["stop_distance"].size() == ULT_SPEED_NUM)
+        {
+            for(unsigned j = 0;j < ULT_SPEED_NUM;++j)
+            {
+                screening_config.stop_distance[j] = screening_node["stop_distance"][j].as<float>();
+            }
+        }
+        if(screening_node["release_margin"])
+            screening_config.release_margin = screening_node["release_margin"].as<float>();
+        if(screening_node["stop_hold_ms"])
+            screening_config.stop_hold_ms = screening_node["stop_hold_ms"].as<uint32_t>();
+        if(screening_node["release_hold_ms"])
+            screening_config.release_hold_ms = screening_node["release_hold_ms"].as<uint32_t>();
+        if(screening_node["data_timeout_ms"])
+            screening_config.data_timeout_ms = screening_node["data_timeout_ms"].as<uint32_t>();
+        if(screening_node["status_timeout_ms"])
+            screening_config.status_timeout_ms = screening_node["status_timeout_ms"].as<uint32_t>();
+    }
+    screening.init(screening_config);
+    ROS_INFO("area mask front:0x%08x,left:0x%08x,tail:0x%08x,right:0x%08x",screening_config.area_sensor_mask[ULT_AREA_FRONT],
+             screening_config.area_sensor_mask[ULT_AREA_LEFT],screening_config.area_sensor_mask[ULT_AREA_TAIL],
+             screening_config.area_sensor_mask[ULT_AREA_RIGHT]);
+
     agvstatus_sub = nh.subscribe("/drivers/com2agv/agv_status",10,&Ultrasonic_Dicesion::AGV_Status_CB,this);
     ultrasonic_sub = nh.subscribe("/drivers/can_wr/sonser_info",10,&Ultrasonic_Dicesion::Ultrasonic_Info_CB,this);
     agvstatus_pub = nh.advertise<control_msgs::AGVStatus>("/control/control_agv",10,true);
@@ -174,300 +202,6 @@ void Ultrasonic_Dicesion::Ultrasonic_Info_CB(const perception_sensor_msgs::Ultra
 //   }
 // }
 
-void Ultrasonic_Dicesion::set_Regional_Screening(const control_msgs::AGVStatus &_agvstatus)
-{
-    v_ultrantic_regional.clear();
-    float temp_y = 0;
-    point point_;
-    switch(_agvstatus.Dir_PRND)
-    {
-        case 1://前进挡
-            if(_agvstatus.ActualSpd > 0)
-            {
-                for(vector<point>::iterator ite_v_ultrantic = v_ultrantic_front.begin();ite_v_ultrantic != v_ultrantic_front.end();++ite_v_ultrantic)
-                {
-                    point_ = *ite_v_ultrantic;
-                    point_.safe_distance = 2500;
-                    v_ultrantic_regional.push_back(point_);
-                }
-                ROS_INFO_STREAM("o3x:" << -car_length/2 << ",o3y:" << -sqrt(pow(car_R3,2) - pow((-car_length/2 - Ox),2)) + Oy);
-                for(vector<point>::iterator ite_v_ultrantic = v_ultrantic_left.begin();ite_v_ultrantic != v_ultrantic_left.end();++ite_v_ultrantic)
-                {
-                    temp_y = min((-sqrt(pow(car_R3,2) - pow((ite_v_ultrantic->x - Ox),2)) + Oy),(sqrt(pow(car_R3,2) - pow((ite_v_ultrantic->x - Ox),2)) + Oy));
-                        // ROS_INFO("temp_y:%f",temp_y);
-                    if(ite_v_ultrantic->y > temp_y)
-                    {
-                        point_ = *ite_v_ultrantic;
-                            // ROS_INFO_STREAM("ult_index:" << point_.index << ",ult_x:" << point_.x << ",ult_y:" << point_.y);
-                        point_.safe_distance = fabs(ite_v_ultrantic->y - temp_y);
-                        v_ultrantic_regional.push_back(point_);
-                            // ROS_INFO_STREAM("ult_index:" << ite_v_ultrantic->index << ",ult_x:" << ite_v_ultrantic->x << ",ult_y:" << ite_v_ultrantic->y);
-                    }
-                }
-                for(vector<point>::iterator ite_v_ultrantic = v_ultrantic_right.begin();ite_v_ultrantic != v_ultrantic_right.end();++ite_v_ultrantic)
-                {
-                    temp_y = min((-sqrt(pow(car_R4,2) - pow((ite_v_ultrantic->x - Ox),2)) + Oy),(sqrt(pow(car_R4,2) - pow((ite_v_ultrantic->x - Ox),2)) + Oy));
-                    if(ite_v_ultrantic->y < temp_y)
-                    {
-                        point_ = *ite_v_ultrantic;
-                            // ROS_INFO_STREAM("ult_index:" << point_.index << ",ult_x:" << point_.x << ",ult_y:" << point_.y);
-                        point_.safe_distance = fabs(ite_v_ultrantic->y - temp_y);
-                        v_ultrantic_regional.push_back(point_);
-                            // ROS_INFO_STREAM("ult_index:" << ite_v_ultrantic->index << ",ult_x:" << ite_v_ultrantic->x << ",ult_y:" << ite_v_ultrantic->y);
-                    }
-                }
-            }
-            break;
-        case 4://后退挡
-            // ROS_INFO_STREAM("o3x:" << -car_length/2 << ",o3y:" << -sqrt(pow(car_R3,2) - pow((-car_length/2 - Ox),2)) + Oy);
-            for(vector<point>::iterator ite_v_ultrantic = v_ultrantic_tail.begin();ite_v_ultrantic != v_ultrantic_tail.end();++ite_v_ultrantic)
-            {
-                point_ = *ite_v_ultrantic;
-                point_.safe_distance = 2500;
-                v_ultrantic_regional.push_back(point_);
-            }
-            for(vector<point>::iterator ite_v_ultrantic = v_ultrantic_left.begin();ite_v_ultrantic != v_ultrantic_left.end();++ite_v_ultrantic)
-            {
-                // temp_y = -sqrt(pow(R1,2) - pow((7735 - ite_v_ultrantic->x),2)) - (2865/2);
-                temp_y = min((-sqrt(pow(car_R1,2) - pow((ite_v_ultrantic->x - Ox),2)) + Oy),(sqrt(pow(car_R1,2) - pow((ite_v_ultrantic->x - Ox),2)) + Oy));
-                // ROS_INFO("temp_y:%f",temp_y);
-                if(ite_v_ultrantic->y > temp_y)
-                {
-                    point_ = *ite_v_ultrantic;
-                    point_.safe_distance = fabs(ite_v_ultrantic->y - temp_y);
-                    v_ultrantic_regional.push_back(point_);
-                    // ROS_INFO_STREAM("ult_index:" << ite_v_ultrantic->index << ",ult_x:" << ite_v_ultrantic->x << ",ult_y:" << ite_v_ultrantic->y);
-                }
-            }
-            for(vector<point>::iterator ite_v_ultrantic = v_ultrantic_right.begin();ite_v_ultrantic != v_ultrantic_right.end();++ite_v_ultrantic)
-            {
-                // temp_y = -sqrt(pow(R1,2) - pow((7735 - ite_v_ultrantic->x),2)) - (2865/2);
-                temp_y = min((-sqrt(pow(car_R2,2) - pow((ite_v_ultrantic->x - Ox),2)) + Oy),(sqrt(pow(car_R2,2) - pow((ite_v_ultrantic->x - Ox),2)) + Oy));
-                // ROS_INFO("temp_y:%f",temp_y);
-                if(ite_v_ultrantic->y < temp_y)
-                {
-                    point_ = *ite_v_ultrantic;
-                    point_.safe_distance = fabs(ite_v_ultrantic->y - temp_y);
-                    v_ultrantic_regional.push_back(point_);
-                    // ROS_INFO_STREAM("ult_index:" << ite_v_ultrantic->index << ",ult_x:" << ite_v_ultrantic->x << ",ult_y:" << ite_v_ultrantic->y);
-                }
-            }
-            break;
-        default:
-            break;    
-    }
-}
-
-void Ultrasonic_Dicesion::Regional_Screening(const control_msgs::AGVStatus &_agvstatus)
-{
-    ROS_INFO_STREAM("Dir_PRND:" << _agvstatus.Dir_PRND);
-    b_Array_Area.clear();
-    switch(_agvstatus.Dir_PRND)
-    {
-        case 1://前进挡
-            ROS_INFO_STREAM("a:" << _agvstatus.ActualAgl_R * _agvstatus.ActualAgl_F);
-            if((_agvstatus.ActualAgl_R * _agvstatus.ActualAgl_F) > 0)//斜行
-            {
-                if(_agvstatus.ActualAgl_R > 0)//右斜行，前，右
-                {
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(true);
-                }
-                else//左斜行，前，左
-                {
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(false);
-                }
-            }
-            else if((_agvstatus.ActualAgl_R * _agvstatus.ActualAgl_F) < 0)//大角度转向,全区域
-            {
-                b_Array_Area.push_back(true);
-                b_Array_Area.push_back(true);
-                b_Array_Area.push_back(true);
-                b_Array_Area.push_back(true);
-            }
-            else//
-            {
-                if(_agvstatus.ActualAgl_R == _agvstatus.ActualAgl_F)//直行，前，左，右
-                {
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(true);
-                }
-                else if((_agvstatus.ActualAgl_R + _agvstatus.ActualAgl_F) > 0)//前，右
-                {
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(true);
-                }
-                else//前，左
-                {
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(false);
-                }
-            }
-            for(vector<bool>::iterator ite_Array_Area = b_Array_Area.begin();ite_Array_Area != b_Array_Area.end();++ite_Array_Area)
-            {
-                ROS_INFO_STREAM("b_Array_Area:" << *ite_Array_Area);
-            }
-            break;
-        case 4://后退挡
-            if((_agvstatus.ActualAgl_R * _agvstatus.ActualAgl_F) > 0)//斜行
-            {
-                if(_agvstatus.ActualAgl_R > 0)//右斜行，前，右
-                {
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(false);
-                }
-                else//左斜行，前，左
-                {
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(true);
-                }
-            }
-            else if((_agvstatus.ActualAgl_R * _agvstatus.ActualAgl_F) < 0)//大角度转向,全区域
-            {
-                b_Array_Area.push_back(true);
-                b_Array_Area.push_back(true);
-                b_Array_Area.push_back(true);
-                b_Array_Area.push_back(true);
-            }
-            else//
-            {
-                if(_agvstatus.ActualAgl_R == _agvstatus.ActualAgl_F)//直行，前，左，右
-                {
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(true);
-                }
-                else if((_agvstatus.ActualAgl_R + _agvstatus.ActualAgl_F) > 0)//前，右
-                {
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(false);
-                }
-                else//前，左
-                {
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(false);
-                    b_Array_Area.push_back(true);
-                    b_Array_Area.push_back(true);
-                }
-            }
-            for(vector<bool>::iterator ite_Array_Area = b_Array_Area.begin();ite_Array_Area != b_Array_Area.end();++ite_Array_Area)
-            {
-                ROS_INFO_STREAM("b_Array_Area:" << *ite_Array_Area);
-            }
-            break;
-        default:
-            b_Array_Area.push_back(false);
-            b_Array_Area.push_back(false);
-            b_Array_Area.push_back(false);
-            b_Array_Area.push_back(false);
-            break;
-    }
-}
-
-void Ultrasonic_Dicesion::Dicesion(const perception_sensor_msgs::UltrasonicInfo &ultrasonic_info_ ,vector<bool> b_Array_Area)
-{
-    // uint8_t i = 0;
-    // if(!ultrasonic_info.ult_obstacle.size())
-    // {
-    //     for(vector<bool>::iterator ite_Area = b_Array_Area.begin();ite_Area != b_Array_Area.end();++ite_Area)
-    //     {
-    //         if(ite_Area)
-    //         {
-    //             for(vector<uint16_t>::iterator ite_Ultrasonic = )
-    //         }
-    //     }
-    // }
-    vector<uint16_t>::iterator it;
-    uint32_t ultrasonic_id = 32;
-    if(ultrasonic_info_.ult_obstacle.size())
-    {
-        printf("!ultrasonic_info_.ult_obstacle.size()\n");
-        for(uint8_t j = 0;j < ultrasonic_info_.ult_obstacle.size();++j)
-        {
-            ultrasonic_id = ultrasonic_info_.ult_obstacle.at(j).id;
-            ROS_INFO_STREAM("ultrasonic_id:" << ultrasonic_id);
-            for(uint8_t i = 0;i < b_Array_Area.size();++i)
-            {
-                if(b_Array_Area[i] && 0 == i)
-                {
-                    it = find(i_Array_Ultrasonic_front.begin(),i_Array_Ultrasonic_front.end(),ultrasonic_id);
-                    if(it != i_Array_Ultrasonic_front.end())
-                    {
-                        printf("front ultransonic warrning\n");
-                        //存在
-                    }
-                    else
-                    {
-                        printf("front ultransonic is clear\n");
-                        //不存在
-                    }
-                }
-                if(b_Array_Area[i] && 1 == i)
-                {
-                    it = find(i_Array_Ultrasonic_left.begin(),i_Array_Ultrasonic_left.end(),ultrasonic_id);
-                    if(it != i_Array_Ultrasonic_left.end())
-                    {
-                        printf("left ultransonic warrning\n");
-                        //存在
-                    }
-                    else
-                    {
-                        printf("left ultransonic is clear\n");
-                        //不存在
-                    }
-                }
-                if(b_Array_Area[i] && 2 == i)
-                {
-                    it = find(i_Array_Ultrasonic_tail.begin(),i_Array_Ultrasonic_tail.end(),ultrasonic_id);
-                    if(it != i_Array_Ultrasonic_tail.end())
-                    {
-                        printf("tail ultransonic warrning\n");
-                        //存在
-                    }
-                    else
-                    {
-                        printf("tail ultransonic is clear\n");
-                        //不存在
-                    }
-                }
-                if(b_Array_Area[i] && 3 == i)
-                {
-                    it = find(i_Array_Ultrasonic_right.begin(),i_Array_Ultrasonic_right.end(),ultrasonic_id);
-                    if(it != i_Array_Ultrasonic_right.end())
-                    {
-                        printf("right ultransonic warrning\n");
-                        //存在
-                    }
-                    else
-                    {
-                        printf("right ultransonic is clear\n");
-                        //不存在
-                    }
-                }
-            }
-        }
-        // ultrasonic_info.clear();
-    }
-}
-
 void Ultrasonic_Dicesion::set_agvstatus(const control_msgs::AGVStatus &msg)
 {
     mtx_agvstatus.lock();
@@ -505,9 +239,10 @@ bool Ultrasonic_Dicesion::get_ultrasonic_info_used()
 control_msgs::AGVStatus Ultrasonic_Dicesion::get_agvstatus_value()
 {
     control_msgs::AGVStatus agvstatus_;
-    mtx_ultrasonic_info.lock();
+    mtx_agvstatus.lock();
     agvstatus_ = agvstatus.agvstatus;
-    mtx_ultrasonic_info.unlock();
+    agvstatus.used = true;
+    mtx_agvstatus.unlock();
     return agvstatus_;
 }
 
@@ -530,32 +265,46 @@ void Ultrasonic_Dicesion::Ultrasonic_Dicesion_Node()
 {
     perception_sensor_msgs::UltrasonicInfo ultrasonic_info_;
     control_msgs::AGVStatus agvstatus_;
+    UltrasonicDecision decision;
+    bool auto_mode = false;
+    bool stop_last = false;
     ros::Rate loop_rate(100);
     while(ros::ok())
     {
-        // printf("thread Ultrasonic_Dicesion_Node runnning~!\n");
-        if(!get_ultrasonic_info_used())//收到agv消息
+        uint64_t now_ms = steadyMs();
+        if(!get_agvstatus_used())//收到agv消息
+        {
+            agvstatus_ = get_agvstatus_value();
+            auto_mode = (2 == agvstatus_.VEHMode);
+            screening.updateStatus(agvstatus_.Dir_PRND,agvstatus_.ActualAgl_R,agvstatus_.ActualAgl_F,agvstatus_.ActualSpd,now_ms);
+        }
+        if(!get_ultrasonic_info_used())//收到超声波消息
         {
-            printf("!get_ultrasonic_info_used()\n");
             ultrasonic_info_ = get_ultrasonic_info_value();
-            ROS_INFO_STREAM("size:" << ultrasonic_info_.ult_obstacle.size());
-            if(0 != ultrasonic_info_.ult_obstacle.size())//有超声波信息
+            screening.beginDetection();
+            for(size_t j = 0;j < ultrasonic_info_.ult_obstacle.size();++j)
+            {
+                const common_msgs::UltrasonicPoint &point_ = ultrasonic_info_.ult_obstacle[j];
+                screening.addDetection(point_.id,point_.distance,point_.status);
+            }
+            screening.endDetection(now_ms);
+        }
+        //每周期都输出决策, 输入中断时由超时判断停车
+        decision = screening.decide(now_ms);
+        bool stop_ = auto_mode && decision.stop;
+        if(stop_)
+        {
+            if(!stop_last)
             {
-                if(!get_agvstatus_used())
-                {
-                    printf("!get_agvstatus_used()\n");
-                    agvstatus_ = get_agvstatus_value();
-                    if(2 == agvstatus_.VEHMode)
-                    {
-                        Regional_Screening(agvstatus_);
-                        Dicesion(ultrasonic_info_,b_Array_Area);
-                    }
-                }
+                ROS_WARN("ultrasonic stop, timeout:%d, active:0x%08x, hit:0x%08x",decision.timeout,decision.active_mask,decision.hit_mask);
             }
-            // turnv_compute(agvstatus,turnv);
-            // Regional_Screening(agvstatus);//根据车辆信息计算出关注区域
-            // Dicesion(ultrasonic_info,b_Array_Area);
+            send_stop();
+        }
+        else if(stop_last)
+        {
+            ROS_INFO("ultrasonic stop released");
         }
+        stop_last = stop_;
         ros::spinOnce();
         loop_rate.sleep();
     }
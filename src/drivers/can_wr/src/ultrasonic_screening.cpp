@@ -0,0 +1,278 @@
+#include "ultrasonic_screening.h"
+#include <math.h>
+#include <string.h>
+
+namespace superg_agv
+{
+
+#define ULT_AREA_BIT(area) (1u << (area))
+
+UltrasonicScreeningConfig::UltrasonicScreeningConfig()
+{
+    //与原 Regional_Screening 的探头划分一致
+    area_sensor_mask[ULT_AREA_FRONT] = 0x0000000F; // 0~3
+    area_sensor_mask[ULT_AREA_LEFT]  = 0x0000FFF0; // 4~15
+    area_sensor_mask[ULT_AREA_TAIL]  = 0x000F0000; // 16~19
+    area_sensor_mask[ULT_AREA_RIGHT] = 0xFFF00000; // 20~31
+    steer_deadband                   = 1.0;
+    speed_stop                       = 0.05;
+    speed_high                       = 1.0;
+    stop_distance[ULT_SPEED_STOP]    = 1.0;
+    stop_distance[ULT_SPEED_LOW]     = 1.5;
+    stop_distance[ULT_SPEED_HIGH]    = 2.0;
+    release_margin                   = 0.2;
+    stop_hold_ms                     = 0;
+    release_hold_ms                  = 500;
+    data_timeout_ms                  = 500;
+    status_timeout_ms                = 500;
+}
+
+UltrasonicScreening::UltrasonicScreening()
+{
+    init(UltrasonicScreeningConfig());
+}
+
+UltrasonicScreening::~UltrasonicScreening()
+{
+}
+
+void UltrasonicScreening::init(const UltrasonicScreeningConfig &config)
+{
+    config_ = config;
+    for (int gear = 0; gear < ULT_GEAR_NUM; ++gear)
+    {
+        for (int steer = 0; steer < ULT_STEER_NUM; ++steer)
+        {
+            uint32_t bits = areaBits(( UltrasonicGear )gear, ( UltrasonicSteer )steer);
+            uint32_t mask = 0;
+            for (int area = 0; area < ULT_AREA_NUM; ++area)
+            {
+                if (bits & ULT_AREA_BIT(area))
+                {
+                    mask |= config_.area_sensor_mask[area];
+                }
+            }
+            active_mask_[gear][steer] = mask;
+        }
+    }
+
+    gear_            = ULT_GEAR_OTHER;
+    steer_           = ULT_STEER_STRAIGHT;
+    speed_           = ULT_SPEED_STOP;
+    status_ms_       = 0;
+    status_valid_    = false;
+    memset(near_mask_, 0, sizeof(near_mask_));
+    memset(pending_near_, 0, sizeof(pending_near_));
+    fault_mask_      = 0;
+    pending_fault_   = 0;
+    detection_ms_    = 0;
+    detection_valid_ = false;
+    //收到数据前按停车处理
+    stop_           = true;
+    stop_speed_     = ULT_SPEED_STOP;
+    hit_last_       = true;
+    hit_since_ms_   = 0;
+    clear_since_ms_ = 0;
+}
+
+//各(档位, 转向)下关注的区域, 规则与原 Regional_Screening 相同
+uint32_t UltrasonicScreening::areaBits(UltrasonicGear gear, UltrasonicSteer steer)
+{
+    const uint32_t front = ULT_AREA_BIT(ULT_AREA_FRONT);
+    const uint32_t left  = ULT_AREA_BIT(ULT_AREA_LEFT);
+    const uint32_t tail  = ULT_AREA_BIT(ULT_AREA_TAIL);
+    const uint32_t right = ULT_AREA_BIT(ULT_AREA_RIGHT);
+    if (ULT_GEAR_FORWARD == gear)
+    {
+        switch (steer)
+        {
+            case ULT_STEER_CRAB_RIGHT:
+            case ULT_STEER_TURN_RIGHT:
+                return front | right;
+            case ULT_STEER_CRAB_LEFT:
+            case ULT_STEER_TURN_LEFT:
+                return front | left;
+            case ULT_STEER_COUNTER:
+                return front | left | tail | right;
+            default:
+                return front | left | right;
+        }
+    }
+    if (ULT_GEAR_REVERSE == gear)
+    {
+        switch (steer)
+        {
+            case ULT_STEER_CRAB_RIGHT:
+            case ULT_STEER_TURN_RIGHT:
+                return left | tail;
+            case ULT_STEER_CRAB_LEFT:
+            case ULT_STEER_TURN_LEFT:
+                return tail | right;
+            case ULT_STEER_COUNTER:
+                return front | left | tail | right;
+            default:
+                return left | tail | right;
+        }
+    }
+    return 0;
+}
+
+UltrasonicGear UltrasonicScreening::quantizeGear(int dir_prnd)
+{
+    switch (dir_prnd)
+    {
+        case 1: //前进挡
+            return ULT_GEAR_FORWARD;
+        case 4: //后退挡
+            return ULT_GEAR_REVERSE;
+        default:
+            return ULT_GEAR_OTHER;
+    }
+}
+
+//原逻辑用转角是否严格相等判断直行, 浮点转角抖动时区域来回切换, 这里先按死区归零
+UltrasonicSteer UltrasonicScreening::quantizeSteer(float agl_r, float agl_f) const
+{
+    if (fabs(agl_r) < config_.steer_deadband)
+    {
+        agl_r = 0;
+    }
+    if (fabs(agl_f) < config_.steer_deadband)
+    {
+        agl_f = 0;
+    }
+    if (agl_r * agl_f > 0) //斜行
+    {
+        return agl_r > 0 ? ULT_STEER_CRAB_RIGHT : ULT_STEER_CRAB_LEFT;
+    }
+    if (agl_r * agl_f < 0) //大角度转向
+    {
+        return ULT_STEER_COUNTER;
+    }
+    if (agl_r == agl_f) //直行
+    {
+        return ULT_STEER_STRAIGHT;
+    }
+    return (agl_r + agl_f) > 0 ? ULT_STEER_TURN_RIGHT : ULT_STEER_TURN_LEFT;
+}
+
+UltrasonicSpeed UltrasonicScreening::quantizeSpeed(float speed) const
+{
+    speed = fabs(speed);
+    if (speed < config_.speed_stop)
+    {
+        return ULT_SPEED_STOP;
+    }
+    return speed < config_.speed_high ? ULT_SPEED_LOW : ULT_SPEED_HIGH;
+}
+
+void UltrasonicScreening::updateStatus(int dir_prnd, float agl_r, float agl_f, float speed, uint64_t now_ms)
+{
+    gear_         = quantizeGear(dir_prnd);
+    steer_        = quantizeSteer(agl_r, agl_f);
+    speed_        = quantizeSpeed(speed);
+    status_ms_    = now_ms;
+    status_valid_ = true;
+}
+
+void UltrasonicScreening::beginDetection()
+{
+    memset(pending_near_, 0, sizeof(pending_near_));
+    pending_fault_ = 0;
+}
+
+void UltrasonicScreening::addDetection(uint32_t id, float distance, bool status)
+{
+    if (id >= ULTRASONIC_SENSOR_NUM)
+    {
+        return;
+    }
+    uint32_t bit = 1u << id;
+    if (status)
+    {
+        pending_fault_ |= bit;
+        return;
+    }
+    for (int speed = 0; speed < ULT_SPEED_NUM; ++speed)
+    {
+        if (distance <= config_.stop_distance[speed])
+        {
+            pending_near_[speed][0] |= bit;
+        }
+        if (distance <= config_.stop_distance[speed] + config_.release_margin)
+        {
+            pending_near_[speed][1] |= bit;
+        }
+    }
+}
+
+void UltrasonicScreening::endDetection(uint64_t now_ms)
+{
+    memcpy(near_mask_, pending_near_, sizeof(near_mask_));
+    fault_mask_      = pending_fault_;
+    detection_ms_    = now_ms;
+    detection_valid_ = true;
+}
+
+UltrasonicDecision UltrasonicScreening::decide(uint64_t now_ms)
+{
+    UltrasonicDecision decision;
+    decision.active_mask = active_mask_[gear_][steer_];
+    decision.hit_mask    = 0;
+    decision.timeout     = !status_valid_ || !detection_valid_ || now_ms - status_ms_ > config_.status_timeout_ms ||
+                       now_ms - detection_ms_ > config_.data_timeout_ms;
+    if (decision.timeout)
+    {
+        //数据恢复后仍需连续 release_hold_ms 无命中才解除
+        if (!stop_)
+        {
+            stop_speed_ = speed_;
+        }
+        stop_         = true;
+        hit_last_     = true;
+        decision.stop = true;
+        return decision;
+    }
+
+    //停车状态下按更远的解除距离判断, 避免障碍物在停车距离附近时反复启停
+    //停车后车速降为0, 速度档也随之降低; 解除距离取停车时与当前速度档中较高的一档, 否则低速停车后按静止档距离解除, 起步后又停车
+    uint32_t near_mask = 0;
+    if (stop_)
+    {
+        near_mask = near_mask_[speed_ > stop_speed_ ? speed_ : stop_speed_][1];
+    }
+    else
+    {
+        near_mask = near_mask_[speed_][0];
+    }
+    decision.hit_mask = decision.active_mask & (near_mask | fault_mask_);
+    if (decision.hit_mask)
+    {
+        if (!hit_last_)
+        {
+            hit_since_ms_ = now_ms;
+        }
+        hit_last_ = true;
+        if (!stop_ && now_ms - hit_since_ms_ >= config_.stop_hold_ms)
+        {
+            stop_       = true;
+            stop_speed_ = speed_;
+        }
+    }
+    else
+    {
+        if (hit_last_)
+        {
+            clear_since_ms_ = now_ms;
+        }
+        hit_last_ = false;
+        if (stop_ && now_ms - clear_since_ms_ >= config_.release_hold_ms)
+        {
+            stop_ = false;
+        }
+    }
+    decision.stop = stop_;
+    return decision;
+}
+
+} // namespace superg_agv
@@ -0,0 +1,730 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "can_signal.h"
+#include "protocol.h"
+
+using namespace superg_agv::drivers;
+
+namespace
+{
+//以下为改用信号表之前各解析函数的手写表达式, 结果先存入 protocol.h 中原来的位域结构体,
+//再按原代码乘系数, 与信号表解码结果逐位比较
+
+std::vector< double > handUltrasonicData(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back((can_data[0] & 0x3F) * 0.05);
+  values.push_back(((can_data[1] << 2 & 0x3C) | (can_data[0] >> 6 & 0x03)) * 0.05);
+  values.push_back(((can_data[2] << 4 & 0x30) | (can_data[1] >> 4 & 0x0F)) * 0.05);
+  values.push_back((can_data[2] >> 2 & 0x3F) * 0.05);
+  values.push_back((can_data[3] & 0x3F) * 0.05);
+  values.push_back(((can_data[4] << 2 & 0x3C) | (can_data[3] >> 6 & 0x03)) * 0.05);
+  values.push_back(((can_data[5] << 4 & 0x30) | (can_data[4] >> 4 & 0x0F)) * 0.05);
+  values.push_back((can_data[5] >> 2 & 0x3F) * 0.05);
+  //原写法 can_data[6] & 0x02 >> 1 因优先级每路都取bit0, 信号表按每路各自的位, 此处为修正后的表达式
+  for (int i = 0; i < 8; i++)
+  {
+    values.push_back(can_data[6] >> i & 0x01);
+  }
+  ultrasonicDataStr data;
+  data.controller_id = can_data[7] & 0x03;
+  values.push_back(data.controller_id);
+  return values;
+}
+
+std::vector< double > handMobileyeNumberOfObstacles(const uint8_t *can_data)
+{
+  mobileyeNumberOfObstaclesStr data;
+  data.Number_Of_Obstacles     = can_data[0];
+  data.Timestamp               = can_data[1];
+  data.Left_Close_Rang_Cut_In  = can_data[3] >> 2 & 0x01;
+  data.Right_Close_Rang_Cut_In = can_data[3] >> 3 & 0x01;
+  data.Go                      = can_data[3] >> 4 & 0x0F;
+  data.Close_car               = can_data[5] & 0x01;
+  data.Failsafe                = can_data[5] >> 1 & 0x0F;
+
+  std::vector< double > values;
+  values.push_back(data.Number_Of_Obstacles);
+  values.push_back(data.Timestamp);
+  values.push_back(data.Left_Close_Rang_Cut_In);
+  values.push_back(data.Right_Close_Rang_Cut_In);
+  values.push_back(data.Go);
+  values.push_back(data.Close_car);
+  values.push_back(data.Failsafe);
+  return values;
+}
+
+std::vector< double > handMobileyeObstacleDataA(const uint8_t *can_data)
+{
+  mobileyeObstaclesDataStr data;
+  data.Obstacle_ID           = can_data[0];
+  data.Obstacle_Type         = can_data[6] >> 4 & 0x07;
+  data.Obstacle_Status       = can_data[7] & 0x07;
+  data.Obstacle_Brake_Lights = can_data[7] >> 3 & 0x01;
+  data.Cut_In_And_Out        = can_data[4] >> 5 & 0x07;
+  data.Blinker_Info          = can_data[4] >> 2 & 0x07;
+  data.Obstacle_Valid        = can_data[7] >> 6 & 0x03;
+
+  std::vector< double > values;
+  values.push_back(data.Obstacle_ID);
+  values.push_back(((can_data[2] << 8 & 0x0F00) | can_data[1]) * 0.0625);
+  values.push_back(((can_data[4] << 8 & 0x0300) | can_data[3]) * 0.0625);
+  values.push_back(((can_data[6] << 8 & 0x0F00) | can_data[5]) * 0.0625);
+  values.push_back(data.Obstacle_Type);
+  values.push_back(data.Obstacle_Status);
+  values.push_back(data.Obstacle_Brake_Lights);
+  values.push_back(data.Cut_In_And_Out);
+  values.push_back(data.Blinker_Info);
+  values.push_back(data.Obstacle_Valid);
+  return values;
+}
+
+std::vector< double > handMobileyeObstacleDataC(const uint8_t *can_data)
+{
+  mobileyeObstaclesDataStr data;
+  data.Obstacle_Replaced = can_data[5] >> 4 & 0x01;
+
+  std::vector< double > values;
+  values.push_back(((can_data[1] << 8 & 0xFF00) | can_data[0]) * 0.01);
+  values.push_back(((can_data[3] << 8 & 0xFF00) | can_data[2]) * 0.0002);
+  values.push_back(((can_data[5] << 8 & 0x0300) | can_data[4]) * 0.03);
+  values.push_back(data.Obstacle_Replaced);
+  values.push_back(((can_data[7] << 8 & 0xFF00) | can_data[6]) * 0.01);
+  return values;
+}
+
+std::vector< double > handCameraObjectHead(const uint8_t *can_data)
+{
+  ObjectStrHead data;
+  data.obj_num = can_data[0];
+  data.r_time  = ((uint32_t)(can_data[1]) << 19) + ((uint32_t)(can_data[2]) << 11) + ((uint32_t)(can_data[3]) << 3) +
+                ((uint32_t)(can_data[4]) >> 5 & 0x07);
+
+  std::vector< double > values;
+  values.push_back(data.obj_num);
+  values.push_back(data.r_time);
+  return values;
+}
+
+std::vector< double > handCameraObjectData0(const uint8_t *can_data)
+{
+  ObjectStr0 data;
+  data.id         = can_data[0];
+  data.obj_class  = can_data[1];
+  data.confidence = can_data[2];
+  data.position_x = (can_data[5] << 4) | (can_data[6] >> 4 & 0x0F);
+  data.position_y = ((can_data[6] & 0x0F) << 8) | can_data[7];
+  data.velocity   = (can_data[3] << 2) | (can_data[4] >> 6 & 0x03);
+
+  std::vector< double > values;
+  values.push_back(data.id);
+  values.push_back(data.obj_class);
+  values.push_back(( float )data.confidence * 0.01);
+  values.push_back(data.velocity * 0.1);
+  values.push_back(data.position_x * 0.1);
+  values.push_back(data.position_y * 0.1);
+  return values;
+}
+
+std::vector< double > handCameraObjectData1(const uint8_t *can_data)
+{
+  ObjectStr1 data;
+  data.id            = can_data[0];
+  data.width         = (can_data[1] << 4) | (can_data[2] >> 4 & 0x0F);
+  data.polygon_x_min = (can_data[5] << 4) | (can_data[6] >> 4 & 0x0F);
+  data.polygon_x_max = (can_data[6] & 0x0F) << 8 | (can_data[7]);
+  //原掩码 0xCF 丢掉了 bit4/bit5, 此处为修正后的 0x3F
+  data.polygon_y_min = (can_data[2] & 0x0F) << 6 | (can_data[3] >> 2 & 0x3F);
+  data.polygon_y_max = (can_data[3] & 0x03) << 8 | can_data[4];
+
+  std::vector< double > values;
+  values.push_back(data.id);
+  values.push_back(data.width * 0.1);
+  values.push_back(data.polygon_y_min);
+  values.push_back(data.polygon_y_max);
+  values.push_back(data.polygon_x_min);
+  values.push_back(data.polygon_x_max);
+  return values;
+}
+
+std::vector< double > handCameraLaneHead(const uint8_t *can_data)
+{
+  laneStrHead data;
+  data.lane_num = can_data[0];
+  data.r_time   = ((uint32_t)(can_data[1]) << 19) + ((uint32_t)(can_data[2]) << 11) + ((uint32_t)(can_data[3]) << 3) +
+                ((uint32_t)(can_data[4]) >> 5 & 0x07);
+
+  std::vector< double > values;
+  values.push_back(data.lane_num);
+  values.push_back(data.r_time);
+  return values;
+}
+
+std::vector< double > handCameraLaneData0(const uint8_t *can_data)
+{
+  laneStr0 data;
+  data.id          = can_data[0];
+  data.start_point = (can_data[4]) << 8 | (can_data[5]);
+  data.end_point   = (can_data[6]) << 8 | (can_data[7]);
+  data.distance    = (can_data[2]) << 8 | (can_data[3]);
+  data.slope       = can_data[1];
+
+  std::vector< double > values;
+  values.push_back(data.id);
+  values.push_back(data.slope);
+  values.push_back(data.distance * 0.1);
+  values.push_back(data.start_point * 0.1);
+  values.push_back(data.end_point * 0.1);
+  return values;
+}
+
+std::vector< double > handCameraLaneData1(const uint8_t *can_data)
+{
+  laneStr1 data;
+  data.polynomial_a = (can_data[0]) << 8 | (can_data[1]);
+  data.polynomial_b = (can_data[2]) << 8 | (can_data[3]);
+  data.polynomial_c = (can_data[4]) << 8 | (can_data[5]);
+  //原写法 can_data[6] << 8 截断到13位后只剩 byte6 低5位, 与 id 前的13位不符, 此处为修正后的 << 5
+  data.polynomial_d = (can_data[6]) << 5 | (can_data[7] >> 3 & 0x1F);
+  data.id           = (can_data[7] & 0x07);
+
+  std::vector< double > values;
+  values.push_back(data.polynomial_a * 0.1);
+  values.push_back(data.polynomial_b * 0.1);
+  values.push_back(data.polynomial_c * 0.1);
+  values.push_back(data.polynomial_d * 0.1);
+  values.push_back(data.id);
+  return values;
+}
+
+//按字节拼出原始值后补码扩展, 与信号表的有符号信号比较
+int64_t signExtend(uint32_t raw, int length)
+{
+  if (raw >> (length - 1) & 0x01)
+  {
+    return ( int64_t )raw - (1ll << length);
+  }
+  return raw;
+}
+
+std::vector< double > handMobileyeObstacleDataB(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back(can_data[0] * 0.5);
+  values.push_back(can_data[1] * 0.05);
+  values.push_back(can_data[2]);
+  values.push_back(can_data[3] & 0x03);
+  values.push_back(can_data[3] >> 2 & 0x01);
+  //原写法两次取 byte4, 此处为修正后的 byte3 高4位与 byte4
+  values.push_back(((can_data[4] << 4) | (can_data[3] >> 4 & 0x0F)) * 0.0625);
+  //原写法取满16位, 与 Radar_Match_Confidence 重叠, 此处为修正后的12位
+  values.push_back(((can_data[6] << 8 & 0x0F00) | can_data[5]) * 0.0625);
+  values.push_back(can_data[6] >> 4 & 0x07);
+  values.push_back(can_data[7] & 0x7F);
+  return values;
+}
+
+std::vector< double > handMobileyeLaneInfoAndMeasure(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back(can_data[0] & 0x03);
+  values.push_back(can_data[0] >> 2 & 0x01);
+  values.push_back(can_data[0] >> 4 & 0x0F);
+  values.push_back((can_data[1] >> 4 & 0x0F) | can_data[2] << 4);
+  values.push_back(can_data[5] & 0x03);
+  values.push_back(can_data[5] >> 2 & 0x01);
+  values.push_back(can_data[5] >> 4 & 0x0F);
+  values.push_back((can_data[6] >> 4 & 0x0F) | can_data[7] << 4);
+  return values;
+}
+
+std::vector< double > handMobileyeSystemWarning(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back(can_data[0] & 0x07);
+  values.push_back(can_data[0] >> 3 & 0x03);
+  values.push_back(can_data[1] >> 5 & 0x01);
+  values.push_back(can_data[2] & 0x01);
+  //原写法 (can_data[2] & 0xFE) * 0.1 未右移, 此处为修正后的 bit17..23
+  values.push_back((can_data[2] >> 1 & 0x7F) * 0.1);
+  values.push_back(can_data[3] & 0x01);
+  //原写法 can_data[3] & 0xFE 未右移, 此处为修正后的 bit25..31
+  values.push_back(can_data[3] >> 1 & 0x7F);
+  values.push_back(can_data[4] & 0x01);
+  values.push_back(can_data[4] >> 1 & 0x01);
+  values.push_back(can_data[4] >> 2 & 0x01);
+  values.push_back(can_data[4] >> 3 & 0x01);
+  values.push_back(can_data[4] >> 6 & 0x01);
+  values.push_back(can_data[4] >> 7 & 0x01);
+  values.push_back(can_data[5] >> 1 & 0x01);
+  values.push_back(can_data[5] >> 2 & 0x01);
+  values.push_back(can_data[5] >> 5 & 0x01);
+  values.push_back(can_data[5] >> 7 & 0x01);
+  values.push_back(can_data[6] & 0x03);
+  values.push_back(can_data[7] & 0x01);
+  //原写法取2位, 此处为修正后的 bit57 单独1位
+  values.push_back(can_data[7] >> 1 & 0x01);
+  return values;
+}
+
+std::vector< double > handMobileyeTSRTypeAndPosition(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back(can_data[0]);
+  values.push_back(can_data[1]);
+  values.push_back(can_data[2] * 0.5);
+  values.push_back((can_data[3] & 0x7F) * 0.5);
+  values.push_back((can_data[4] & 0x3F) * 0.5);
+  values.push_back(can_data[5]);
+  return values;
+}
+
+std::vector< double > handMobileyeTSRVisionDecision(const uint8_t *can_data)
+{
+  //原写法每个信号都取 byte0, 此处为修正后的逐字节
+  std::vector< double > values;
+  for (int i = 0; i < 8; i++)
+  {
+    values.push_back(can_data[i]);
+  }
+  return values;
+}
+
+std::vector< double > handMobileyeLightsLocationAndAngles(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back(can_data[0] * 0.1 - 10);
+  //原写法取满16位, 与 NGL_RH 重叠, 此处为修正后的12位
+  values.push_back(((can_data[2] << 8 & 0x0F00) | can_data[1]) * 0.1 - 20);
+  values.push_back((can_data[3] << 4 | (can_data[2] >> 4 & 0x0F)) * 0.1 - 20);
+  values.push_back(can_data[4] * 2.0);
+  values.push_back(can_data[5] & 0x03);
+  values.push_back(can_data[5] >> 2 & 0x03);
+  values.push_back(can_data[5] >> 4 & 0x03);
+  values.push_back(can_data[5] >> 6 & 0x03);
+  values.push_back(can_data[6] & 0x01);
+  values.push_back(can_data[6] >> 1 & 0x01);
+  values.push_back(can_data[6] >> 2 & 0x01);
+  values.push_back(can_data[6] >> 3 & 0x01);
+  return values;
+}
+
+std::vector< double > handMobileyeLaneInfoMeasure(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  //原写法 a + b << 8 因优先级先加后移且按无符号, 此处为修正后的16位补码
+  values.push_back(signExtend(can_data[1] << 8 | can_data[0], 16) * 3.81e-6);
+  values.push_back(signExtend((can_data[3] & 0x0F) << 8 | can_data[2], 12) * 0.0005);
+  values.push_back(can_data[3] >> 4 & 0x01);
+  values.push_back(can_data[3] >> 5 & 0x01);
+  values.push_back(can_data[3] >> 6 & 0x01);
+  //原写法整数除法丢掉小数, 此处为修正后的浮点系数
+  values.push_back((can_data[5] << 8 | can_data[4]) * (1.0 / 1024));
+  values.push_back((can_data[7] << 8 | can_data[6]) * (1.0 / 1024 / 512) + -0x7FFF / 1024.0 / 512.0);
+  return values;
+}
+
+std::vector< double > handMobileyeSignalsStatus(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  for (int i = 0; i < 6; i++)
+  {
+    values.push_back(can_data[0] >> i & 0x01);
+  }
+  values.push_back(can_data[1] >> 3 & 0x01);
+  values.push_back(can_data[1] >> 4 & 0x01);
+  values.push_back(can_data[1] >> 5 & 0x01);
+  values.push_back(can_data[1] >> 7 & 0x01);
+  values.push_back(can_data[2]);
+  return values;
+}
+
+//原写法 C0/C1/C2/C3/View_Range 均为整数除法, 此处为修正后的浮点系数, C0 按补码
+std::vector< double > handMobileyeLKALaneA(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back(can_data[0] & 0x0F);
+  values.push_back(can_data[0] >> 4 & 0x03);
+  values.push_back(can_data[0] >> 6 & 0x03);
+  values.push_back(signExtend(can_data[2] << 8 | can_data[1], 16) * (1.0 / 256));
+  values.push_back((can_data[4] << 8 | can_data[3]) * (1.0 / 1024 / 1000) + -0x7FFF / 1024.0 / 1000.0);
+  values.push_back((can_data[6] << 8 | can_data[5]) * (1.0 / (1 << 28)) + -0x7FFF / double(1 << 28));
+  values.push_back(can_data[7] * 0.01);
+  return values;
+}
+
+std::vector< double > handMobileyeLKALaneB(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back((can_data[1] << 8 | can_data[0]) * (1.0 / 1024) + -0x7FFF / 1024.0);
+  values.push_back(((can_data[3] << 8 & 0x7F00) | can_data[2]) * (1.0 / 256));
+  values.push_back(can_data[3] >> 7 & 0x01);
+  return values;
+}
+
+std::vector< double > handMobileyeReferencePoints(const uint8_t *can_data)
+{
+  //原写法 | 与 & 写反, 此处为修正后的拼接
+  std::vector< double > values;
+  for (int i = 0; i < 8; i += 4)
+  {
+    values.push_back((can_data[i + 1] << 8 | can_data[i]) * (1.0 / 256) + -0x7FFF / 256.0);
+    values.push_back(((can_data[i + 3] << 8 & 0x7F00) | can_data[i + 2]) * (1.0 / 256));
+    values.push_back(can_data[i + 3] >> 7 & 0x01);
+  }
+  return values;
+}
+
+std::vector< double > handMobileyeNumberOfNextLane(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back(can_data[0]);
+  return values;
+}
+
+std::vector< double > handP2Time(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back((can_data[0]) << 8 | (can_data[1]));
+  //原写法先整除10再乘0.01, 丢掉毫秒位, 此处为修正后的 ms * 0.001
+  values.push_back((((uint32_t)(can_data[2]) << 24) + ((uint32_t)(can_data[3]) << 16) +
+                    ((uint32_t)(can_data[4]) << 8) + (uint32_t)(can_data[5])) *
+                   0.001);
+  return values;
+}
+
+//三轴各20位补码: x 为 byte0..byte2高4位, y 为 byte2低4位..byte4, z 为 byte5..byte7高4位
+//原写法存入 int:16 位域后被截断, 此处为修正后的完整20位
+std::vector< double > handP2Axis3(const uint8_t *can_data, double factor)
+{
+  std::vector< double > values;
+  values.push_back(
+      signExtend((can_data[0]) << 12 | (can_data[1]) << 4 | ((can_data[2]) >> 4 & 0x0F), 20) * factor);
+  values.push_back(signExtend(((can_data[2]) & 0x0F) << 16 | (can_data[3]) << 8 | (can_data[4]), 20) * factor);
+  values.push_back(
+      signExtend((can_data[5]) << 12 | (can_data[6]) << 4 | ((can_data[7]) >> 4 & 0x0F), 20) * factor);
+  return values;
+}
+
+std::vector< double > handP2AngRateRawIMU(const uint8_t *can_data)
+{
+  return handP2Axis3(can_data, 0.01);
+}
+
+//原写法 y 左移12位与 x 重叠, 且三轴都写入 accel_raw_x
+std::vector< double > handP2AccelIMURaw(const uint8_t *can_data)
+{
+  return handP2Axis3(can_data, 0.001);
+}
+
+std::vector< double > handP2InsStatus(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back(can_data[0]);
+  values.push_back(can_data[1]);
+  values.push_back(can_data[2]);
+  return values;
+}
+
+uint32_t bigEndian32(const uint8_t *can_data)
+{
+  return ((uint32_t)(can_data[0]) << 24) + ((uint32_t)(can_data[1]) << 16) + ((uint32_t)(can_data[2]) << 8) +
+         (uint32_t)(can_data[3]);
+}
+
+std::vector< double > handP2LatitudeLongitude(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back(signExtend(bigEndian32(can_data), 32) * 1e-7);
+  values.push_back(signExtend(bigEndian32(can_data + 4), 32) * 1e-7);
+  return values;
+}
+
+std::vector< double > handP2Altitude(const uint8_t *can_data)
+{
+  std::vector< double > values;
+  values.push_back(signExtend(bigEndian32(can_data), 32) * 0.001);
+  return values;
+}
+
+//每2字节一个16位信号, 大端
+std::vector< double > handP2Words(const uint8_t *can_data, int num, bool is_signed)
+{
+  std::vector< double > values;
+  for (int i = 0; i < num; i++)
+  {
+    uint32_t raw = (can_data[2 * i]) << 8 | (can_data[2 * i + 1]);
+    values.push_back((is_signed ? signExtend(raw, 16) : raw) * 0.01);
+  }
+  return values;
+}
+
+std::vector< double > handP2PosSigma(const uint8_t *can_data)
+{
+  return handP2Words(can_data, 3, false);
+}
+
+std::vector< double > handP2VelocityLevel(const uint8_t *can_data)
+{
+  return handP2Words(can_data, 4, true);
+}
+
+std::vector< double > handP2VelocityLevelSigma(const uint8_t *can_data)
+{
+  return handP2Words(can_data, 4, false);
+}
+
+std::vector< double > handP2AccelVehicle(const uint8_t *can_data)
+{
+  return handP2Axis3(can_data, 0.0001 * 9.80665);
+}
+
+std::vector< double > handP2HeadingPitchRoll(const uint8_t *can_data)
+{
+  std::vector< double > values = handP2Words(can_data, 3, true);
+  values[0]                    = ((can_data[0]) << 8 | (can_data[1])) * 0.01;
+  return values;
+}
+
+std::vector< double > handP2HeadingPitchRollSigma(const uint8_t *can_data)
+{
+  return handP2Words(can_data, 3, false);
+}
+
+std::vector< double > handP2AngRateVehicle(const uint8_t *can_data)
+{
+  return handP2Axis3(can_data, 0.01);
+}
+
+typedef std::vector< double > (*HandDecoder)(const uint8_t *can_data);
+
+const HandDecoder hand_decoders[CAN_MSG_TYPE_NUM] = {
+    handUltrasonicData,
+    handMobileyeNumberOfObstacles,
+    handMobileyeObstacleDataA,
+    handMobileyeObstacleDataC,
+    handCameraObjectHead,
+    handCameraObjectData0,
+    handCameraObjectData1,
+    handCameraLaneHead,
+    handCameraLaneData0,
+    handCameraLaneData1,
+    handMobileyeObstacleDataB,
+    handMobileyeLaneInfoAndMeasure,
+    handMobileyeSystemWarning,
+    handMobileyeTSRTypeAndPosition,
+    handMobileyeTSRVisionDecision,
+    handMobileyeLightsLocationAndAngles,
+    handMobileyeLaneInfoMeasure,
+    handMobileyeSignalsStatus,
+    handMobileyeLKALaneA,
+    handMobileyeLKALaneB,
+    handMobileyeReferencePoints,
+    handMobileyeNumberOfNextLane,
+    handP2Time,
+    handP2AngRateRawIMU,
+    handP2AccelIMURaw,
+    handP2InsStatus,
+    handP2LatitudeLongitude,
+    handP2Altitude,
+    handP2PosSigma,
+    handP2VelocityLevel,
+    handP2VelocityLevelSigma,
+    handP2AccelVehicle,
+    handP2HeadingPitchRoll,
+    handP2HeadingPitchRollSigma,
+    handP2AngRateVehicle};
+
+//逐个报文类型比较, 返回第一个不一致的信号序号, 一致返回-1
+int compareWithHand(int type, const uint8_t *can_data)
+{
+  double values[64];
+  if (!canDecodeType(type, can_data, values))
+  {
+    return -2;
+  }
+  std::vector< double > expect = hand_decoders[type](can_data);
+  if (( int )expect.size() != can_message_db[type].signal_num)
+  {
+    return -3;
+  }
+  for (size_t i = 0; i < expect.size(); i++)
+  {
+    //逐位相等, 不允许误差
+    if (memcmp(&values[i], &expect[i], sizeof(double)) != 0)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+} // namespace
+
+TEST(CanSignal, MessageDbOrderedByType)
+{
+  for (int type = 0; type < CAN_MSG_TYPE_NUM; type++)
+  {
+    EXPECT_EQ(type, can_message_db[type].type);
+  }
+  uint8_t can_data[8] = {0};
+  double values[64];
+  EXPECT_FALSE(canDecodeType(-1, can_data, values));
+  EXPECT_FALSE(canDecodeType(CAN_MSG_TYPE_NUM, can_data, values));
+}
+
+//全0, 全1及逐位置1的报文覆盖每个信号的边界位
+TEST(CanSignal, SingleBitPayloadsMatchHandDecoders)
+{
+  for (int type = 0; type < CAN_MSG_TYPE_NUM; type++)
+  {
+    uint8_t can_data[8];
+    memset(can_data, 0x00, sizeof(can_data));
+    ASSERT_EQ(-1, compareWithHand(type, can_data)) << "type " << type << " all zero";
+    memset(can_data, 0xFF, sizeof(can_data));
+    ASSERT_EQ(-1, compareWithHand(type, can_data)) << "type " << type << " all one";
+    for (int bit = 0; bit < 64; bit++)
+    {
+      memset(can_data, 0x00, sizeof(can_data));
+      can_data[bit / 8] = 1 << (bit % 8);
+      ASSERT_EQ(-1, compareWithHand(type, can_data)) << "type " << type << " bit " << bit;
+      memset(can_data, 0xFF, sizeof(can_data));
+      can_data[bit / 8] = ~(1 << (bit % 8));
+      ASSERT_EQ(-1, compareWithHand(type, can_data)) << "type " << type << " cleared bit " << bit;
+    }
+  }
+}
+
+TEST(CanSignal, RandomPayloadsMatchHandDecoders)
+{
+  srand(43);
+  for (int n = 0; n < 200000; n++)
+  {
+    uint8_t can_data[8];
+    for (int i = 0; i < 8; i++)
+    {
+      can_data[i] = rand() & 0xFF;
+    }
+    for (int type = 0; type < CAN_MSG_TYPE_NUM; type++)
+    {
+      int signal = compareWithHand(type, can_data);
+      ASSERT_EQ(-1, signal) << "type " << type << " signal " << signal << " payload " << std::hex << ( int )can_data[0]
+                            << " " << ( int )can_data[1] << " " << ( int )can_data[2] << " " << ( int )can_data[3] << " "
+                            << ( int )can_data[4] << " " << ( int )can_data[5] << " " << ( int )can_data[6] << " "
+                            << ( int )can_data[7];
+    }
+  }
+}
+
+//有符号信号: 相机目标横向位置12位补码, 0xFFF 为 -0.1m
+TEST(CanSignal, MotorolaSignedSignal)
+{
+  uint8_t can_data[8] = {0, 0, 0, 0, 0, 0, 0x0F, 0xFF};
+  double values[CAMERA_OBJECT_DATA_0_SIG_NUM];
+  ASSERT_TRUE(canDecodeType(CAN_MSG_CAMERA_OBJECT_DATA_0, can_data, values));
+  EXPECT_DOUBLE_EQ(-0.1, values[CAMERA_SIG_OBJECT_POSITION_Y]);
+  EXPECT_DOUBLE_EQ(0.0, values[CAMERA_SIG_OBJECT_POSITION_X]);
+}
+
+//按信号表直接写入位域结构体, 与 canDecodeType 的结果一致
+TEST(CanSignal, DecodeIntoBitFieldStruct)
+{
+  static const CanFieldSetter< mobileyeSystemWaringStr >::Fn setters[] = {
+      CAN_FIELD(mobileyeSystemWaringStr, sound_type),
+      CAN_FIELD(mobileyeSystemWaringStr, Time_Indicator),
+      CAN_FIELD(mobileyeSystemWaringStr, Zero_speed),
+      CAN_FIELD(mobileyeSystemWaringStr, Headway_Valid),
+      CAN_FIELD(mobileyeSystemWaringStr, Headway_measurement),
+      CAN_FIELD(mobileyeSystemWaringStr, Error_Valid),
+      CAN_FIELD(mobileyeSystemWaringStr, Error_Code),
+      CAN_FIELD(mobileyeSystemWaringStr, LDW_Off),
+      CAN_FIELD(mobileyeSystemWaringStr, Left_LDW_On),
+      CAN_FIELD(mobileyeSystemWaringStr, Right_LDW_On),
+      CAN_FIELD(mobileyeSystemWaringStr, FCW_On),
+      CAN_FIELD(mobileyeSystemWaringStr, Maintenance),
+      CAN_FIELD(mobileyeSystemWaringStr, FailSafe),
+      CAN_FIELD(mobileyeSystemWaringStr, Peds_FCW),
+      CAN_FIELD(mobileyeSystemWaringStr, Peds_in_DZ),
+      CAN_FIELD(mobileyeSystemWaringStr, Tamper_Alert),
+      CAN_FIELD(mobileyeSystemWaringStr, TSR_Enabled),
+      CAN_FIELD(mobileyeSystemWaringStr, TSR_Warning_Level),
+      CAN_FIELD(mobileyeSystemWaringStr, Headway_Warning_Level),
+      CAN_FIELD(mobileyeSystemWaringStr, HW_Repeatable_Enabled)};
+  ASSERT_EQ(MOBILEYE_SYSTEM_WARNING_SIG_NUM, ( int )(sizeof(setters) / sizeof(setters[0])));
+
+  uint8_t can_data[8] = {0x1D, 0x20, 0x15, 0x0B, 0xC9, 0xA6, 0x02, 0x03};
+  mobileyeSystemWaringStr msg;
+  memset(&msg, 0, sizeof(msg));
+  ASSERT_TRUE(canDecodeInto(CAN_MSG_MOBILEYE_SYSTEM_WARNING, can_data, setters, msg));
+  EXPECT_EQ(5u, ( uint32_t )msg.sound_type);
+  EXPECT_EQ(3u, ( uint32_t )msg.Time_Indicator);
+  EXPECT_EQ(1u, ( uint32_t )msg.Zero_speed);
+  EXPECT_EQ(1u, ( uint32_t )msg.Headway_Valid);
+  EXPECT_FLOAT_EQ(1.0, msg.Headway_measurement);
+  EXPECT_EQ(1u, ( uint32_t )msg.Error_Valid);
+  EXPECT_EQ(5u, ( uint32_t )msg.Error_Code);
+  EXPECT_EQ(1u, ( uint32_t )msg.LDW_Off);
+  EXPECT_EQ(1u, ( uint32_t )msg.FCW_On);
+  EXPECT_EQ(1u, ( uint32_t )msg.Maintenance);
+  EXPECT_EQ(1u, ( uint32_t )msg.FailSafe);
+  EXPECT_EQ(1u, ( uint32_t )msg.Peds_FCW);
+  EXPECT_EQ(1u, ( uint32_t )msg.Peds_in_DZ);
+  EXPECT_EQ(1u, ( uint32_t )msg.Tamper_Alert);
+  EXPECT_EQ(1u, ( uint32_t )msg.TSR_Enabled);
+  EXPECT_EQ(2u, ( uint32_t )msg.TSR_Warning_Level);
+  EXPECT_EQ(1u, ( uint32_t )msg.Headway_Warning_Level);
+  EXPECT_EQ(1u, ( uint32_t )msg.HW_Repeatable_Enabled);
+
+  EXPECT_FALSE(canDecodeInto(CAN_MSG_TYPE_NUM, can_data, setters, msg));
+}
+
+namespace
+{
+int handlerA(int)
+{
+  return 1;
+}
+int handlerB(int)
+{
+  return 2;
+}
+} // namespace
+
+//标准帧按下标, 扩展帧查 map; 与 map::insert 一致先添加的ID不被覆盖
+TEST(CanSignal, DispatchTable)
+{
+  typedef int (*Handler)(int);
+  CanDispatchTable< Handler > table;
+  EXPECT_TRUE(table.add(0x7FF, handlerA));
+  EXPECT_TRUE(table.add(1849, handlerA));
+  EXPECT_FALSE(table.add(1849, handlerB));
+  EXPECT_TRUE(table.add(0x18FF0001, handlerB));
+  EXPECT_FALSE(table.add(0x18FF0001, handlerA));
+  EXPECT_TRUE(table.add(5, handlerB));
+
+  EXPECT_EQ(4u, table.size());
+  EXPECT_EQ(handlerA, table.find(0x7FF));
+  EXPECT_EQ(handlerA, table.find(1849));
+  EXPECT_EQ(handlerB, table.find(0x18FF0001));
+  EXPECT_EQ(handlerB, table.find(5));
+  EXPECT_TRUE(table.find(6) == NULL);
+  EXPECT_TRUE(table.find(0x800) == NULL);
+  EXPECT_TRUE(table.find(0x18FF0002) == NULL);
+
+  std::vector< uint32_t > ids = table.ids();
+  ASSERT_EQ(4u, ids.size());
+  EXPECT_EQ(5u, ids[0]);
+  EXPECT_EQ(1849u, ids[1]);
+  EXPECT_EQ(0x7FFu, ids[2]);
+  EXPECT_EQ(0x18FF0001u, ids[3]);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
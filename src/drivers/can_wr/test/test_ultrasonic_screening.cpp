@@ -0,0 +1,243 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "control_msgs/AGVStatus.h"
+#include "perception_sensor_msgs/UltrasonicInfo.h"
+#include "ultrasonic_screening.h"
+
+using namespace superg_agv;
+
+namespace
+{
+#define REPLAY_MAX_POINTS 3
+
+//回放表的一行: 某一时刻收到的 AGVStatus / UltrasonicInfo, 以及该周期期望的决策
+//has_status/has_ultrasonic 为 false 时该周期没有收到对应消息; point_num 为 0 表示收到空的超声波帧
+struct ReplayFrame
+{
+  uint64_t t_ms;
+  bool has_status;
+  int dir_prnd;
+  float agl_r;
+  float agl_f;
+  float speed;
+  bool has_ultrasonic;
+  int point_num;
+  uint32_t id[REPLAY_MAX_POINTS];
+  float distance[REPLAY_MAX_POINTS];
+  bool fault[REPLAY_MAX_POINTS];
+  bool expect_stop;
+  bool expect_timeout;
+};
+
+//与 Ultrasonic_Dicesion_Node 相同的输入方式: 先状态, 再超声波, 每周期决策一次
+void replay(UltrasonicScreening &screening, const ReplayFrame *frames, int frame_num)
+{
+  for (int i = 0; i < frame_num; i++)
+  {
+    const ReplayFrame &frame = frames[i];
+    if (frame.has_status)
+    {
+      control_msgs::AGVStatus status;
+      status.Dir_PRND    = frame.dir_prnd;
+      status.ActualAgl_R = frame.agl_r;
+      status.ActualAgl_F = frame.agl_f;
+      status.ActualSpd   = frame.speed;
+      screening.updateStatus(status.Dir_PRND, status.ActualAgl_R, status.ActualAgl_F, status.ActualSpd, frame.t_ms);
+    }
+    if (frame.has_ultrasonic)
+    {
+      perception_sensor_msgs::UltrasonicInfo info;
+      for (int k = 0; k < frame.point_num; k++)
+      {
+        common_msgs::UltrasonicPoint point;
+        point.id       = frame.id[k];
+        point.distance = frame.distance[k];
+        point.status   = frame.fault[k];
+        info.ult_obstacle.push_back(point);
+      }
+      info.obstacle_num = info.ult_obstacle.size();
+      screening.beginDetection();
+      for (size_t k = 0; k < info.ult_obstacle.size(); k++)
+      {
+        screening.addDetection(info.ult_obstacle[k].id, info.ult_obstacle[k].distance, info.ult_obstacle[k].status);
+      }
+      screening.endDetection(frame.t_ms);
+    }
+    UltrasonicDecision decision = screening.decide(frame.t_ms);
+    ASSERT_EQ(frame.expect_stop, decision.stop) << "frame " << i << " t " << frame.t_ms << " hit 0x" << std::hex
+                                                << decision.hit_mask;
+    ASSERT_EQ(frame.expect_timeout, decision.timeout) << "frame " << i << " t " << frame.t_ms;
+  }
+}
+
+//原 Regional_Screening 的区域规则, 返回[前, 左, 后, 右]区域位
+uint32_t oldRegionalAreas(int dir_prnd, float agl_r, float agl_f)
+{
+  bool front = false, left = false, tail = false, right = false;
+  if (1 == dir_prnd || 4 == dir_prnd)
+  {
+    bool forward = 1 == dir_prnd;
+    if (agl_r * agl_f > 0)
+    {
+      bool to_right = agl_r > 0;
+      front         = forward;
+      tail          = !forward;
+      right         = forward ? to_right : !to_right;
+      left          = !right;
+    }
+    else if (agl_r * agl_f < 0)
+    {
+      front = left = tail = right = true;
+    }
+    else if (agl_r == agl_f)
+    {
+      front = forward;
+      tail  = !forward;
+      left = right = true;
+    }
+    else
+    {
+      bool to_right = agl_r + agl_f > 0;
+      front         = forward;
+      tail          = !forward;
+      right         = forward ? to_right : !to_right;
+      left          = !right;
+    }
+  }
+  return (front ? 1u << ULT_AREA_FRONT : 0) | (left ? 1u << ULT_AREA_LEFT : 0) | (tail ? 1u << ULT_AREA_TAIL : 0) |
+         (right ? 1u << ULT_AREA_RIGHT : 0);
+}
+} // namespace
+
+TEST(UltrasonicScreening, ActiveMaskMatchesRegionalScreening)
+{
+  UltrasonicScreeningConfig config;
+  config.steer_deadband = 0;
+  UltrasonicScreening screening;
+  screening.init(config);
+  const float angles[] = {-20, -5, -0.5f, 0, 0.5f, 5, 20};
+  for (int dir_prnd = 0; dir_prnd < 6; dir_prnd++)
+  {
+    for (int r = 0; r < 7; r++)
+    {
+      for (int f = 0; f < 7; f++)
+      {
+        uint32_t areas  = oldRegionalAreas(dir_prnd, angles[r], angles[f]);
+        uint32_t expect = 0;
+        for (int area = 0; area < ULT_AREA_NUM; area++)
+        {
+          if (areas & (1u << area))
+          {
+            expect |= config.area_sensor_mask[area];
+          }
+        }
+        UltrasonicGear gear   = UltrasonicScreening::quantizeGear(dir_prnd);
+        UltrasonicSteer steer = screening.quantizeSteer(angles[r], angles[f]);
+        ASSERT_EQ(expect, screening.getActiveMask(gear, steer))
+            << "prnd " << dir_prnd << " agl_r " << angles[r] << " agl_f " << angles[f];
+      }
+    }
+  }
+}
+
+TEST(UltrasonicScreening, SteerDeadband)
+{
+  UltrasonicScreening screening;
+  EXPECT_EQ(ULT_STEER_STRAIGHT, screening.quantizeSteer(0.5f, -0.3f));
+  EXPECT_EQ(ULT_STEER_TURN_RIGHT, screening.quantizeSteer(0.5f, 3.0f));
+}
+
+//前进直行低速: 停车距离1.5m, 解除距离1.7m, 连续500ms无命中解除
+TEST(UltrasonicScreening, ReplayForwardStopAndRelease)
+{
+  const ReplayFrame frames[] = {
+      //  t   状态  prnd  R  F   spd   超声波 n  id          距离               故障    stop   timeout
+      {0, true, 1, 0, 0, 0.5f, false, 0, {}, {}, {}, true, true},                     //只有状态, 无超声波
+      {10, true, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, true, false},                    //数据到达, 等待解除
+      {400, true, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, true, false},                   //
+      {510, true, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, false, false},                  // 500ms 无命中解除
+      {520, true, 1, 0, 0, 0.5f, true, 1, {17}, {0.5f}, {false}, false, false},       //后方障碍, 前进不关注
+      {530, true, 1, 0, 0, 0.5f, true, 1, {2}, {1.4f}, {false}, true, false},         //前方1.4m < 1.5m 停车
+      {540, true, 1, 0, 0, 0.5f, true, 1, {2}, {1.6f}, {false}, true, false},         // 1.6m < 1.7m 保持
+      {600, true, 1, 0, 0, 0.5f, true, 1, {2}, {1.8f}, {false}, true, false},         //超过解除距离, 开始计时
+      {1000, true, 1, 0, 0, 0.5f, true, 1, {2}, {1.8f}, {false}, true, false},        //
+      {1100, true, 1, 0, 0, 0.5f, true, 1, {2}, {1.8f}, {false}, false, false},       // 500ms 后解除
+      {1110, true, 1, 0, 0, 0.5f, true, 1, {2}, {1.6f}, {false}, false, false},       // 1.6m > 1.5m 不停车
+      {1120, true, 1, 0, 0, 1.5f, true, 1, {2}, {1.9f}, {false}, true, false},        //高速, 1.9m < 2.0m 停车
+      {1130, true, 1, 0, 0, 1.5f, true, 2, {2, 3}, {1.9f, 2.5f}, {false, false}, true, false}, //
+  };
+  UltrasonicScreening screening;
+  replay(screening, frames, sizeof(frames) / sizeof(frames[0]));
+}
+
+//低速在1.3m处停车后车速降为0, 静止档解除距离只有1.2m; 解除距离应按停车时的低速档1.7m,
+//否则停稳500ms后解除, 起步后再次停车, 反复启停
+TEST(UltrasonicScreening, ReplayStopLatchesSpeedBucket)
+{
+  const ReplayFrame frames[] = {
+      {0, true, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, true, false},              //
+      {500, true, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, false, false},           //解除初始停车
+      {510, true, 1, 0, 0, 0.5f, true, 1, {1}, {1.3f}, {false}, true, false},  //低速 1.3m 停车
+      {520, true, 1, 0, 0, 0.2f, true, 1, {1}, {1.3f}, {false}, true, false},  //
+      {530, true, 1, 0, 0, 0.0f, true, 1, {1}, {1.3f}, {false}, true, false},  //停稳
+      {1040, true, 1, 0, 0, 0.0f, true, 1, {1}, {1.3f}, {false}, true, false}, //超过 500ms 仍保持停车
+      {2000, true, 1, 0, 0, 0.0f, true, 1, {1}, {1.3f}, {false}, true, false}, //
+      {2010, true, 1, 0, 0, 0.0f, true, 1, {1}, {1.6f}, {false}, true, false}, // 1.6m 仍在低速档解除距离内
+      {2020, true, 1, 0, 0, 0.0f, true, 1, {1}, {1.8f}, {false}, true, false}, //障碍物离开, 开始计时
+      {2520, true, 1, 0, 0, 0.0f, true, 1, {1}, {1.8f}, {false}, false, false}, //解除, 此后按当前速度档
+      {2530, true, 1, 0, 0, 0.0f, true, 1, {1}, {1.1f}, {false}, false, false}, //静止档停车距离1.0m
+      {2540, true, 1, 0, 0, 0.0f, true, 1, {1}, {0.9f}, {false}, true, false},  //静止时停车
+      {3050, true, 1, 0, 0, 0.0f, true, 1, {1}, {1.3f}, {false}, true, false},  //静止档 1.3m > 1.2m, 开始计时
+      {3550, true, 1, 0, 0, 0.0f, true, 1, {1}, {1.3f}, {false}, false, false}, //
+  };
+  UltrasonicScreening screening;
+  replay(screening, frames, sizeof(frames) / sizeof(frames[0]));
+}
+
+//探头故障按命中处理; 倒车及倒车斜行时的关注区域
+TEST(UltrasonicScreening, ReplayFaultAndReverse)
+{
+  const ReplayFrame frames[] = {
+      {0, true, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, true, false},               //
+      {500, true, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, false, false},            //
+      {510, true, 1, 0, 0, 0.5f, true, 1, {25}, {1.9f}, {true}, true, false},   //右侧探头故障
+      {520, true, 4, 0, 0, 0.5f, true, 1, {2}, {0.3f}, {false}, true, false},   //倒车, 前方不关注, 开始计时
+      {1020, true, 4, 0, 0, 0.5f, true, 1, {2}, {0.3f}, {false}, false, false}, //
+      {1030, true, 4, 10, 10, 0.5f, true, 1, {25}, {0.3f}, {false}, false, false}, //倒车右斜行只关注左、后
+      {1040, true, 4, 10, 10, 0.5f, true, 1, {5}, {0.3f}, {false}, true, false},   //左侧命中
+      {1050, true, 2, 0, 0, 0.0f, true, 1, {5}, {0.3f}, {false}, true, false},     //驻车不关注, 开始计时
+      {1550, true, 2, 0, 0, 0.0f, true, 1, {5}, {0.3f}, {false}, false, false},    //
+      {1560, true, 1, 0, 0, 0.5f, true, 1, {40}, {0.3f}, {false}, false, false},   //编号超出范围忽略
+  };
+  UltrasonicScreening screening;
+  replay(screening, frames, sizeof(frames) / sizeof(frames[0]));
+}
+
+//超声波或 agv 状态中断超过 500ms 停车, 恢复后仍需连续 500ms 无命中才解除
+TEST(UltrasonicScreening, ReplayInputTimeout)
+{
+  const ReplayFrame frames[] = {
+      {0, true, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, true, false},           //
+      {500, true, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, false, false},        //
+      {900, true, 1, 0, 0, 0.5f, false, 0, {}, {}, {}, false, false},       //超声波 400ms 未更新
+      {1001, true, 1, 0, 0, 0.5f, false, 0, {}, {}, {}, true, true},        //超声波超时
+      {1100, true, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, true, false},        //恢复, 开始计时
+      {1600, true, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, false, false},       //
+      {2101, false, 1, 0, 0, 0.5f, true, 0, {}, {}, {}, true, true},        // agv状态超时
+      {2110, true, 1, 0, 0, 0.5f, true, 1, {2}, {1.6f}, {false}, true, false}, //按超时前的低速档解除距离
+      {2700, true, 1, 0, 0, 0.5f, true, 1, {2}, {1.8f}, {false}, true, false}, //
+      {3200, true, 1, 0, 0, 0.5f, true, 1, {2}, {1.8f}, {false}, false, false}, //
+  };
+  UltrasonicScreening screening;
+  replay(screening, frames, sizeof(frames) / sizeof(frames[0]));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -35,6 +35,8 @@
 
 #include "relay.h"
 #include "agv2p2.h"
+#include "seq_lock.h"
+#include "veh_io.h"
 
 // #define Test_TurnPeriod 20      //unit: s 转角测试标志，如果不需要请注释该行
 // #define Test_TurnAngle  40      //unit: degree 转角测试标志，如果不需要请注释该行
@@ -95,6 +97,19 @@ struct AGV2ControlInfo
     uint8_t SOC;                //电池电量剩余
     uint8_t Rolling_Counter;    //心跳信号
 }AGV2ControlInfo;
+//接收线程解析出的 VCU 状态, 通过 SeqLock 交给主循环
+struct VcuStatus
+{
+    struct AGV2ControlInfo info;
+    double stamp;               //最近一次收到 VCU2C112 的时间, 0 为还没收到
+};
+//主循环组好的 VCU 指令, 通过 SeqLock 交给发送定时器
+#define VCU_CMD_STALE_PERIODS 5 //指令超过该周期数未更新时只发送零速请求
+struct VcuCommand
+{
+    superg_agv::common::VehCanFrame frame;
+    uint64_t stamp_ns;          //组帧时间, CLOCK_MONOTONIC
+};
 struct Control2AGVInfo
 {
     float Vel_Req;              //车辆速度请求
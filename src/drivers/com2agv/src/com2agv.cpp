@@ -3,6 +3,11 @@
 using namespace std;
 using namespace superg_agv;
 using namespace drivers;
+using superg_agv::common::SeqLock;
+using superg_agv::common::VehCanFrame;
+using superg_agv::common::VehIo;
+using superg_agv::common::VehIoStats;
+using superg_agv::common::vehIoNowNs;
 
 double VCU_starttime ;
 double main_starttime;
@@ -26,6 +31,13 @@ bool keyboard_valid = false;
 bool controlvcu_valid = false;
 bool TestCycleStart = false;
 
+int devid;
+AGV2P2 *agv2p2 = NULL;
+VehIo vehIo;
+SeqLock< VcuStatus > vcu_status_slot;		//接收线程写, 主循环读
+SeqLock< VcuCommand > vcu_cmd_slot;		//主循环写, 发送定时器读
+std::atomic< uint64_t > vcu_cmd_stale(0);	//发送定时器发出的零速帧数
+
 /******param declare******/
 float Test_MovePeriod_;
 float Test_TurnPeriod_;
@@ -198,123 +210,126 @@ void recvOperationVCUCallback(const control_msgs::ADControlAGV& msg)
 	//Control2AGVInfo.AutoDrive_Enable = msg.is_AD_status;
 //}
 
+//接收：VCU 状态帧, 在 I/O 线程(ADCU 时为读线程)中解析
+void onVehicleFrame(const VehCanFrame &frame, uint64_t rx_ns)
+{
+	static VcuStatus vcu_status;
+	static control_msgs::AGVStatus2 vcu_wheel_spd;
+	const uint8_t *rec_buf = frame.data;
+
+	switch (frame.id)
+	{
+		case VCU2C112:
+			vcu_status.info.ActualSpd = (float)(rec_buf[0]<<4 | rec_buf[1]>>4) * 0.01f;
+			AGVSta_msg.ActualSpd = vcu_status.info.ActualSpd;
+			vcu_status.info.ActualAgl_R = (float)(((rec_buf[1] & 0x0f)  << 6) | rec_buf[2] >> 2) * 0.1f - 45.0f;
+			AGVSta_msg.ActualAgl_R = vcu_status.info.ActualAgl_R;
+			vcu_status.info.ActualAgl_F = (float)(((rec_buf[2] & 0x03) << 8) | rec_buf[3] ) * 0.1f - 45.0f;
+			AGVSta_msg.ActualAgl_F = vcu_status.info.ActualAgl_F;
+			vcu_status.info.VEHMode = rec_buf[4] & 0x03;
+			AGVSta_msg.VEHMode = vcu_status.info.VEHMode;
+			vcu_status.info.VEHFlt = (rec_buf[4] & 0x0c) >> 2;
+			AGVSta_msg.VEHFlt = vcu_status.info.VEHFlt;
+			vcu_status.info.LiftStatus = (rec_buf[4] & 0x30) >> 4;
+			AGVSta_msg.LiftStatus = vcu_status.info.LiftStatus;
+			vcu_status.info.HVStatus = (rec_buf[4] & 0x40) >> 6;
+			AGVSta_msg.HVStatus = vcu_status.info.HVStatus;
+			vcu_status.info.EStopStatus = (rec_buf[4] & 0x80) >> 7;
+			AGVSta_msg.EStopStatus = vcu_status.info.EStopStatus;
+			vcu_status.info.EPBStatus = rec_buf[5] & 0x01;
+			AGVSta_msg.EPBStatus = vcu_status.info.EPBStatus;
+			vcu_status.info.Dir_PRND = (rec_buf[5] & 0x0e) >> 1;
+			AGVSta_msg.Dir_PRND = vcu_status.info.Dir_PRND;
+			vcu_status.info.SOC = (rec_buf[5] & 0x30) >> 4;
+			AGVSta_msg.SOC = vcu_status.info.SOC;
+			vcu_status.info.Rolling_Counter =  rec_buf[7] & 0x0f;
+			AGVSta_msg.Rolling_Counter= vcu_status.info.Rolling_Counter;
+
+			AGVSta_msg.header.stamp = ros::Time::now();
+			AGVSta_msg.header.frame_id = "/driver/AGVStatus";
+			AGVSta_pub.publish(AGVSta_msg);
+			vcu_status.stamp = AGVSta_msg.header.stamp.toSec();
+			vcu_status_slot.store(vcu_status);
+
+			agv2p2->setAgvstatus(AGVSta_msg);
+
+			break;
+		case VCU2C113:
+			vcu_wheel_spd.WheelRotSpd_FL		= (rec_buf[1]<<8 | rec_buf[0]) - 12000;
+			vcu_wheel_spd.WheelRotSpd_FR		= (rec_buf[3]<<8 | rec_buf[2]) - 12000;
+			vcu_wheel_spd.WheelRotSpd_RL		= (rec_buf[5]<<8 | rec_buf[4]) - 12000;
+			vcu_wheel_spd.WheelRotSpd_RR		= (rec_buf[7]<<8 | rec_buf[6]) - 12000;
+
+			agv2p2->setAgvwheelspd(rec_buf,vcu_wheel_spd);
+			agv2p2->agv2p2_(vcu_wheel_spd);
+
+			vcu_wheel_spd.header.stamp 		= ros::Time::now();
+			vcu_wheel_spd.header.frame_id 	= "/driver/AGVStatus2";
+
+			AGVSta2_pub.publish(vcu_wheel_spd);
+
+			break;
+	}
+}
+
+//发送：I/O 线程按 Freq_com2agv 定时取主循环给出的最新指令, 只在这里填心跳
+//主循环卡住使指令过期时, 保持档位和转角, 速度请求置0, 心跳照常, 让车辆减速停车
+bool buildVcuCommand(VehCanFrame *frame)
+{
+	static uint8_t rolling_counter = 0;
+	VcuCommand cmd;
+	if (vcu_cmd_slot.load(&cmd) == 0)
+	{
+		return false;			//主循环还没有给出指令
+	}
+	*frame = cmd.frame;
+	if (vehIoNowNs() - cmd.stamp_ns > VCU_CMD_STALE_PERIODS * 1000000000ull / Freq_com2agv)
+	{
+		frame->data[0] = 0;
+		frame->data[1] &= 0x0f;
+		vcu_cmd_stale.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (++rolling_counter > 15)
+	{
+		rolling_counter = 0;
+	}
+	frame->data[7] = rolling_counter;
+	return true;
+}
+
+bool writeAdcu(const VehCanFrame &frame)
+{
+	adcuCanData canbuf;
+	memset(&canbuf, 0, sizeof(canbuf));
+	canbuf.ide = frame.ext;			//IDE=0:Standard,IDE=1:Extended
+	canbuf.dlc = frame.dlc;
+	canbuf.rtr = frame.rtr;
+	canbuf.prio = 0x00;
+	canbuf.id = frame.id;
+	memcpy(canbuf.can_data, frame.data, CAN_DATA_SIZE);
+	return adcuDevWrite(devid, (uint8_t *)&canbuf, sizeof(canbuf)) > 0;	//发送CAN报文给VCU控制车辆
+}
+
+//ADCU SDK 只有阻塞读, 没有可以 epoll 的 fd, 单独一个线程读到后交给 vehIo
 pthread_t ReadThread;
 void *readLoop(void *pdata)
 {
   int deviceid = *(int *)pdata;
-  int packageCounter = 0;
-  bool recv_vcu_motor = false;
   adcuCanData canBuffer;
-  control_msgs::AGVStatus2 vcu_wheel_spd;
-  resetcontrolparam();
-
-  AGV2P2 AGV2P2_;
-//   control_msgs::AGVStatus agvstatus;
-//   AgvWheelSpd agvwheelspd;
 
   while (1)
   {
-    // uint8_t buffer[1024];
-    int length = 0;
-    length = adcuDevRead(deviceid, (uint8_t *)&canBuffer);
+    int length = adcuDevRead(deviceid, (uint8_t *)&canBuffer);
     if (length > 0)
     {
-//        memcpy(candatareceive.candata, &buffer, length);
-		bool recv_motor = false;
-		uint8_t rec_buf[canBuffer.dlc]={0};
-		// uint8_t rec_buf[]={0};
-
-		// canBuffer.dlc = 8;
-		// if(canBuffer.id == 0x112)
-		// {
-		// 	canBuffer.id = 0x113;
-		// }
-		// else
-		// {
-		// 	canBuffer.id = 0x112;
-		// }
-		// canBuffer.can_data[0] = 0x01;
-		// canBuffer.can_data[1] = 0x02;
-		// canBuffer.can_data[2] = 0x03;
-		// canBuffer.can_data[3] = 0x04;
-		// canBuffer.can_data[4] = 0x05;
-		// canBuffer.can_data[5] = 0x06;
-		// canBuffer.can_data[6] = 0x07;
-		// canBuffer.can_data[7] = 0x08;
-
-		// sleep(1);
-
-		switch (canBuffer.id)
-		{
-			case VCU2C112:
-				for(int i = 0; i < canBuffer.dlc; i++)
-				{
-					rec_buf[i] = canBuffer.can_data[i];
-					// printf(" %02X", rec_buf[i]);
-				}
-				// printf("receive VCU2C112!\n");
-				// printf("\n");
-				AGV2ControlInfo.ActualSpd = (float)(rec_buf[0]<<4 | rec_buf[1]>>4) * 0.01f;
-				AGVSta_msg.ActualSpd = AGV2ControlInfo.ActualSpd;
-				AGV2ControlInfo.ActualAgl_R = (float)(((rec_buf[1] & 0x0f)  << 6) | rec_buf[2] >> 2) * 0.1f - 45.0f;
-				AGVSta_msg.ActualAgl_R = AGV2ControlInfo.ActualAgl_R;
-				AGV2ControlInfo.ActualAgl_F = (float)(((rec_buf[2] & 0x03) << 8) | rec_buf[3] ) * 0.1f - 45.0f;
-				AGVSta_msg.ActualAgl_F = AGV2ControlInfo.ActualAgl_F;
-				AGV2ControlInfo.VEHMode = rec_buf[4] & 0x03;
-				AGVSta_msg.VEHMode = AGV2ControlInfo.VEHMode;
-				AGV2ControlInfo.VEHFlt = (rec_buf[4] & 0x0c) >> 2;
-				AGVSta_msg.VEHFlt = AGV2ControlInfo.VEHFlt;
-				AGV2ControlInfo.LiftStatus = (rec_buf[4] & 0x30) >> 4;
-				AGVSta_msg.LiftStatus = AGV2ControlInfo.LiftStatus;
-				AGV2ControlInfo.HVStatus = (rec_buf[4] & 0x40) >> 6;
-				AGVSta_msg.HVStatus = AGV2ControlInfo.HVStatus;
-				AGV2ControlInfo.EStopStatus = (rec_buf[4] & 0x80) >> 7;
-				AGVSta_msg.EStopStatus = AGV2ControlInfo.EStopStatus;
-				AGV2ControlInfo.EPBStatus = rec_buf[5] & 0x01;
-				AGVSta_msg.EPBStatus = AGV2ControlInfo.EPBStatus;
-				AGV2ControlInfo.Dir_PRND = (rec_buf[5] & 0x0e) >> 1;
-				AGVSta_msg.Dir_PRND = AGV2ControlInfo.Dir_PRND;
-				AGV2ControlInfo.SOC = (rec_buf[5] & 0x30) >> 4;
-				AGVSta_msg.SOC = AGV2ControlInfo.SOC;
-				AGV2ControlInfo.Rolling_Counter =  rec_buf[7] & 0x0f;
-				AGVSta_msg.Rolling_Counter= AGV2ControlInfo.Rolling_Counter;
-
-				AGVSta_msg.header.stamp = ros::Time::now();
-				AGVSta_msg.header.frame_id = "/driver/AGVStatus";
-				AGVSta_pub.publish(AGVSta_msg);
-				vcu_valid = true;
-				VCU_starttime = ros::Time::now().toSec();
-
-				AGV2P2_.setAgvstatus(AGVSta_msg);
-
-				break;
-			case VCU2C113:
-				for(int i = 0; i < canBuffer.dlc; i++)
-				{
-					rec_buf[i] = canBuffer.can_data[i];
-					// printf(" %02X", rec_buf[i]);
-				}
-				// printf("receive VCU2C113!\n");
-				vcu_wheel_spd.WheelRotSpd_FL		= (rec_buf[1]<<8 | rec_buf[0]) - 12000;
-				vcu_wheel_spd.WheelRotSpd_FR		= (rec_buf[3]<<8 | rec_buf[2]) - 12000;
-				vcu_wheel_spd.WheelRotSpd_RL		= (rec_buf[5]<<8 | rec_buf[4]) - 12000;
-				vcu_wheel_spd.WheelRotSpd_RR		= (rec_buf[7]<<8 | rec_buf[6]) - 12000;
-
-				AGV2P2_.setAgvwheelspd(rec_buf,vcu_wheel_spd);
-				AGV2P2_.agv2p2_(vcu_wheel_spd);
-
-				vcu_wheel_spd.header.stamp 		= ros::Time::now();
-				vcu_wheel_spd.header.frame_id 	= "/driver/AGVStatus2";
-
-				AGVSta2_pub.publish(vcu_wheel_spd);
-				recv_vcu_motor = true;
-
-				// AGV2P2_.setAgvwheelspd(rec_buf);
-				// AGV2P2_.agv2p2_(vcu_wheel_spd);
-
-				break;
-		}
-		
+      VehCanFrame frame;
+      memset(&frame, 0, sizeof(frame));
+      frame.id = canBuffer.id;
+      frame.ext = canBuffer.ide;
+      frame.rtr = canBuffer.rtr;
+      frame.dlc = canBuffer.dlc > CAN_DATA_SIZE ? CAN_DATA_SIZE : canBuffer.dlc;
+      memcpy(frame.data, canBuffer.can_data, frame.dlc);
+      vehIo.dispatchRx(frame);
     }
   }
 }
@@ -344,15 +359,26 @@ int main(int argc, char *argv[])
 	ns.state_num = 1;
 	uint8_t pub_count = 0;
 	int counter = 0;
-	int devid;
-	uint8_t data[100];
 	uint8_t opt_buf[16];
-	int len = 0;
 	adcuDeviceType deviceType;
 	int channel;
-	adcuSDKInit();
+
+	//车辆通信链路: adcu(默认, ADCU CAN 通道) / serial(串口 CAN 转换器) / udp(CANET 网关)
+	ros::NodeHandle pn("~");
+	std::string vehicle_link, serial_dev, udp_ip;
+	int serial_baud, udp_remote_port, udp_local_port;
+	double io_stats_period;
+	pn.param<std::string>("vehicle_link", vehicle_link, "adcu");
+	pn.param<std::string>("serial_dev", serial_dev, "/dev/ttyUSB0");
+	pn.param("serial_baud", serial_baud, 115200);
+	pn.param<std::string>("udp_ip", udp_ip, "192.168.0.178");
+	pn.param("udp_remote_port", udp_remote_port, 4001);
+	pn.param("udp_local_port", udp_local_port, 4001);
+	pn.param("io_stats_period", io_stats_period, 10.0);
+	bool use_adcu = (vehicle_link == "adcu");
+
 	channel = VCUCANChannel;//atoi(argv[1]);
-	if (channel <= 0 || channel >= ADCU_CHANNEL_MAX)
+	if (use_adcu && (channel <= 0 || channel >= ADCU_CHANNEL_MAX))
 	{
 		printf("please input correct channel number<%d ~ %d>\n", ADCU_CHANNEL_1, ADCU_CHANNEL_MAX - 1);
 		return 0;
@@ -389,39 +415,67 @@ int main(int argc, char *argv[])
 		paraminit(n);
 	}
 
-	bzero(data, 100);
-	adcuCanData canbuf;
-	canbuf.ide = 0x00;			//IDE=0:Standard,IDE=1:Extended
-	canbuf.dlc = 0x08;
-	canbuf.rtr = 0x00;
-	canbuf.prio = 0x00;
-	canbuf.id = VCU2C111;
-
-	deviceType = adcuCAN;
-	len = sizeof(adcuCanData);
-	memcpy(data, (uint8_t *)&canbuf, len);
-
-	devid = adcuDevOpen(deviceType, (adcuDeviceChannel)channel);
-	pthread_create(&ReadThread, NULL, readLoop, &devid);
+	resetcontrolparam();
+	agv2p2 = new AGV2P2();
+	vehIo.setRxHandler(onVehicleFrame);
+	vehIo.setTxTimer(Freq_com2agv, buildVcuCommand);
 
-	opt_buf[0] = channel - 1;
-	opt_buf[1] = 3;				//BaudRate<1 ~ 7> : 100k 125k 250k 400k 500k 800k 1000k
-	adcuDevSetOpt(devid,opt_buf,2);
+	bool io_ok = false;
+	if (use_adcu)
+	{
+		adcuSDKInit();
+		deviceType = adcuCAN;
+		devid = adcuDevOpen(deviceType, (adcuDeviceChannel)channel);
+		io_ok = vehIo.openExternal(writeAdcu);
+		pthread_create(&ReadThread, NULL, readLoop, &devid);
+
+		opt_buf[0] = channel - 1;
+		opt_buf[1] = 3;				//BaudRate<1 ~ 7> : 100k 125k 250k 400k 500k 800k 1000k
+		adcuDevSetOpt(devid,opt_buf,2);
+	}
+	else if (vehicle_link == "serial")
+	{
+		io_ok = vehIo.openSerial(serial_dev, serial_baud);
+	}
+	else if (vehicle_link == "udp")
+	{
+		io_ok = vehIo.openUdp(udp_ip, udp_remote_port, udp_local_port);
+	}
+	if (!io_ok || !vehIo.start())
+	{
+		ROS_ERROR("open vehicle link %s failed: %s", vehicle_link.c_str(), strerror(errno));
+		return 0;
+	}
 	sleep(1);
 
 	ros::Rate loop_rate(Freq_com2agv);
 	main_starttime = ros::Time::now().toSec();
 	double t_prev = main_starttime - 1.0 / (float)Freq_com2agv;
+	double stats_time = main_starttime;
 
 	relay.openCanRelay(18,1);
 
 	while (ros::ok())
 	{
-		if (adcuDevStatus(devid) == ADCU_DEV_STATUS_ABNORMAL)
+		if (use_adcu && adcuDevStatus(devid) == ADCU_DEV_STATUS_ABNORMAL)
+		{
+			break;
+		}
+		if (vehIo.failed())
 		{
+			printf("main write error\n");
 			break;
 		}
 
+		VcuStatus vcu_status;
+		vcu_status_slot.load(&vcu_status);
+		AGV2ControlInfo = vcu_status.info;
+		if (vcu_status.stamp > VCU_starttime)
+		{
+			VCU_starttime = vcu_status.stamp;
+			vcu_valid = true;
+		}
+
 		if (sign_ != -2)
 		{
 			double t = ros::Time::now().toSec();
@@ -497,32 +551,16 @@ int main(int argc, char *argv[])
 						Control2AGVInfo.AutoDrive_Enable <<2 | 
 						Control2AGVInfo.EStop <<1 |
 						Control2AGVInfo.EPB;
-        if (++Control2AGVInfo.Rolling_Counter > 15)
-        {
-            Control2AGVInfo.Rolling_Counter = 0;
-        }
-        
-		send_buf[7] = 	Control2AGVInfo.Rolling_Counter;
-		
-		for(int i = 0; i < canbuf.dlc; i++)
-		{
-			canbuf.can_data[i] = send_buf[i];
-		}
-		
-		bzero(data, 100);
-		memcpy(data, (uint8_t *)&canbuf, len);
+		//心跳在发送定时器中填写
+		VcuCommand vcu_cmd;
+		memset(&vcu_cmd, 0, sizeof(vcu_cmd));
+		vcu_cmd.frame.id = VCU2C111;
+		vcu_cmd.frame.dlc = 8;
+		memcpy(vcu_cmd.frame.data, send_buf, sizeof(send_buf));
+		vcu_cmd.stamp_ns = vehIoNowNs();
 		//TODO: 如果调试完成加入VCU通信有效判断
 		//if (vcu_valid) {}
-		if (adcuDevWrite(devid, data, len) <= 0)	//发送CAN报文给VCU控制车辆
-		{
-			printf("main write error\n");
-			goto __end;
-		} 
-		else
-		{
-			// ROS_INFO("CAN1 TX ID:0x%08X data:0x %02X %02X %02X %02X %02X %02X %02X %02X", canbuf.id,canbuf.can_data[0],canbuf.can_data[1],canbuf.can_data[2],canbuf.can_data[3],canbuf.can_data[4],canbuf.can_data[5],canbuf.can_data[6],canbuf.can_data[7]);
-
-		}
+		vcu_cmd_slot.store(vcu_cmd);
 
 		c2v_msg.VehAgl_F = Control2AGVInfo.VehAgl_F;
 		c2v_msg.VehAgl_R = Control2AGVInfo.VehAgl_R;
@@ -581,14 +619,30 @@ int main(int argc, char *argv[])
 			pub_count = 0;
 		}
 		pub_count++;
-		
+
+		if (io_stats_period > 0 && ros::Time::now().toSec() - stats_time >= io_stats_period)
+		{
+			stats_time = ros::Time::now().toSec();
+			VehIoStats st = vehIo.takeStats();
+			ROS_INFO("vehicle io: rx %lu crc_err %lu fmt_err %lu | tx %lu err %lu drop %lu overrun %lu late %lu stale %lu | "
+					 "wake avg %.1fus max %.1fus send avg %.1fus max %.1fus",
+					 (unsigned long)st.rx_frames, (unsigned long)st.crc_errors, (unsigned long)st.format_errors,
+					 (unsigned long)st.tx_frames, (unsigned long)st.tx_errors, (unsigned long)st.tx_dropped,
+					 (unsigned long)st.tx_overruns, (unsigned long)st.tx_late,
+					 (unsigned long)vcu_cmd_stale.exchange(0, std::memory_order_relaxed), st.wake_ns_avg / 1e3,
+					 st.wake_ns_max / 1e3, st.send_ns_avg / 1e3, st.send_ns_max / 1e3);
+		}
+
 		ros::spinOnce();
 		loop_rate.sleep();
 	}
-	__end:
-		printf("dinit all \n");
+	printf("dinit all \n");
+	vehIo.stop();
+	if (use_adcu)
+	{
 		adcuDevClose(devid);
 		adcuSDKDeinit();
-		relay.openCanRelay(18,0);
-		return 0;
+	}
+	relay.openCanRelay(18,0);
+	return 0;
 }
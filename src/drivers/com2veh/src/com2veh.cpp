@@ -18,6 +18,8 @@
 #include "adcuSDK.h"
 #include "control_msgs/com2veh.h"
 #include "control_algo.h"
+#include "seq_lock.h"
+#include "veh_io.h"
 #include <geometry_msgs/PoseStamped.h>
 
 using namespace std;
@@ -25,6 +27,12 @@ using namespace std;
 #define SteerTurnTest false
 #define SteerAngle_MAX 406		//单位：度
 #define ExpSpeed_MAX 20				//单位：km/h
+#define StaleDecel 1.0f				//指令过期时的制动减速度, 单位：m/s^2
+
+using superg_agv::common::SeqLock;
+using superg_agv::common::VehCanFrame;
+using superg_agv::common::VehIo;
+using superg_agv::common::vehIoNowNs;
 
 uint32_t timecount = 0;
 uint32_t starttime = 0;
@@ -46,17 +54,54 @@ union CANdataUN
 	uint8_t candata[16];
 }candatareceive;
 
+//ROS 回调给出的期望值, 接收线程和发送定时器读
+struct VehCommand
+{
+	float ExpVelSpeed;
+	float ExpAngle;
+	bool AutodriveEnable;
+	bool SteerEnable;
+	uint64_t stamp_ns;		//写入时间, CLOCK_MONOTONIC
+};
+//接收线程速度 PID 的输出, 发送定时器读
+struct VehAccel
+{
+	float ExpAcce;
+	float ExpDecel;        //deceleration 
+	bool BrakeEnable;
+	bool AccelEnable;
+};
+
 float Vkm2mConst = 1/3.6f;
 float VelSpeed = 0.0f;        //车辆速度单位是： is: Km/h
 float SteerAngle = 0.0f;
 float ExpVelSpeed = 6.0f;
-float ExpDecel = 0.0f;        //deceleration 
-float ExpAcce = 0.0f;
 float ExpAngle=0.0f;
-bool BrakeEnable = false;
-bool AccelEnable = false;
-bool SteerEnable = false;
 bool AutodriveEnable = false;
+bool SteerEnable = false;
+
+int devid;
+VehIo vehIo;
+SeqLock< VehCommand > cmd_slot;
+SeqLock< VehAccel > accel_slot;
+uint64_t cmd_timeout_ns;		//期望值超过该时间未更新视为过期
+
+//控制节点停发或卡住时, 期望速度按 0 处理
+bool commandStale(const VehCommand &cmd)
+{
+	return vehIoNowNs() - cmd.stamp_ns > cmd_timeout_ns;
+}
+
+void storeCommand(void)
+{
+	VehCommand cmd;
+	cmd.ExpVelSpeed = ExpVelSpeed;
+	cmd.ExpAngle = ExpAngle;
+	cmd.AutodriveEnable = AutodriveEnable;
+	cmd.SteerEnable = SteerEnable;
+	cmd.stamp_ns = vehIoNowNs();
+	cmd_slot.store(cmd);
+}
 
 void paraminit(void)
 {
@@ -79,97 +124,186 @@ void recvControlVCUCallback(const control_msgs::com2veh& msg)
 	//control_stamp = msg.header.stamp.toSec();
 	AutodriveEnable = true;
 	SteerEnable = true;
+	storeCommand();
+}
+
+//接收：车速/转角帧, 在 I/O 线程(ADCU 时为读线程)中解析并做速度 PID
+void onVehicleFrame(const VehCanFrame &frame, uint64_t rx_ns)
+{
+	if (frame.id != vel_spd && frame.id != steer_angle)
+	{
+		return;
+	}
+	const uint8_t *rec_buf = frame.data;
+	uint8_t sign=0;
+	switch (frame.id)
+	{
+		case vel_spd:
+			VelSpeed = (float)((rec_buf[0] & 0x1f <<8) | rec_buf[1]) * 0.05625f;
+			//printf("velspeed is : %f \n", VelSpeed);
+			msg.VelSpeed = VelSpeed;
+			break;
+		case steer_angle:
+			sign = rec_buf[2] & 0x01;
+			SteerAngle = (float)((rec_buf[1] <<7) | (rec_buf[2] >>1)) * 0.1f;
+			if (!sign) {
+				SteerAngle = -SteerAngle;
+			}
+			msg.SteerAngle = SteerAngle;
+			//printf("SteerAngle is : %f \n", SteerAngle);
+			break;
+		default:
+			break;
+	}
+
+	VehCommand cmd;
+	cmd_slot.load(&cmd);
+	if (commandStale(cmd))
+	{
+		cmd.ExpVelSpeed = 0.0f;
+	}
+	VehAccel accel;
+	pid_loop(&speedcontrol, cmd.ExpVelSpeed * Vkm2mConst, VelSpeed * Vkm2mConst, ros::Time::now().toSec());
+	//printf("speedOutput is : %f \n", speedcontrol.Output);
+	if (speedcontrol.Output > 0.02f)
+	{
+		accel.ExpAcce = speedcontrol.Output;
+		accel.ExpDecel = 0.0f;
+		accel.AccelEnable = true;
+		accel.BrakeEnable = false;
+	}
+	else if (speedcontrol.Output < -0.08f)
+	{
+		accel.ExpAcce = 0.0f;
+		accel.ExpDecel = -speedcontrol.Output;  // * 1.2f;
+		if (accel.ExpDecel > 6.5f)
+		{
+			accel.ExpDecel = 6.5f;
+		}
+
+		accel.AccelEnable = false;
+		accel.BrakeEnable = true;
+	}
+	else
+	{
+		accel.ExpAcce = 0.0f;
+		accel.ExpDecel = 0.0f;
+		accel.AccelEnable = false;
+		accel.BrakeEnable = false;
+	}
+	accel_slot.store(accel);
+	if (SteerTurnTest)
+	{
+		msg.ExpAngle = 30 * sin((ros::Time::now().toSec() - starttime)/3);
+	}
+	msg.ExpSpeed =  cmd.ExpVelSpeed;
+	msg.ACCexp = speedcontrol.Output;
+	com2veh_pub.publish(msg);
+}
+
+//发送：I/O 线程按 100Hz 用最新的期望值和 PID 输出组帧
+//期望值过期时不再驱动, 至少以 StaleDecel 制动, 转角保持; 车速帧也停了时 PID 输出不会更新, 不能只靠它减速
+bool buildVehCommand(VehCanFrame *frame)
+{
+	static bool stale_logged = false;
+	VehCommand cmd;
+	VehAccel accel;
+	cmd_slot.load(&cmd);
+	accel_slot.load(&accel);
+	bool stale = commandStale(cmd);
+	if (stale != stale_logged)
+	{
+		stale_logged = stale;
+		if (stale)
+		{
+			ROS_WARN("control command older than %.3fs, stop driving", cmd_timeout_ns / 1e9);
+		}
+		else
+		{
+			ROS_INFO("control command resumed");
+		}
+	}
+	if (stale && cmd.AutodriveEnable)
+	{
+		accel.AccelEnable = false;
+		accel.ExpAcce = 0.0f;
+		accel.BrakeEnable = true;
+		if (accel.ExpDecel < StaleDecel)
+		{
+			accel.ExpDecel = StaleDecel;
+		}
+	}
+
+	uint8_t send_buf[8]={0};
+	if (SteerTurnTest)
+	{
+			cmd.AutodriveEnable=true;
+			cmd.SteerEnable=true;
+			cmd.ExpAngle = 30 * sin((ros::Time::now().toSec() - starttime)/3);
+	}
+
+	uint8_t WorkMode=cmd.AutodriveEnable, BrkReq=accel.BrakeEnable, DriReq=accel.AccelEnable, StrReq=cmd.SteerEnable;
+
+	send_buf[0] = WorkMode<<6 | BrkReq<<3 | DriReq<<2 | StrReq<<1;
+	float TrgDriAcc = accel.ExpAcce;
+	send_buf[4] = (uint8_t)(TrgDriAcc * 10.0f);
+	float TrgBrkAcc = accel.ExpDecel;
+	send_buf[5] = (uint8_t)(TrgBrkAcc * 10.0f);
+	float TrgStrAngle =cmd.ExpAngle;
+	if (TrgStrAngle < 0.0f) {
+		TrgStrAngle = -TrgStrAngle;
+		send_buf[6] = ((uint16_t)(TrgStrAngle * 10.0f)) >>8 | 0x80;
+	} 
+	else 
+	{
+		send_buf[6] = ((uint16_t)(TrgStrAngle * 10.0f)) >>8;
+	}
+	//TrgStrAngle need 2 bytes and it is intel format          
+	send_buf[7] = (uint16_t)(TrgStrAngle * 10.0f) & 0x00ff;
+
+	memset(frame, 0, sizeof(*frame));
+	frame->id = 0x238;
+	frame->dlc = 8;
+	memcpy(frame->data, send_buf, sizeof(send_buf));
+	//在 I/O 线程中每帧打印会拉高发送延迟, 改为 debug 级别
+	ROS_DEBUG("CAN1 TX ID:0x%08X data:0x %02X %02X %02X %02X %02X %02X %02X %02X", frame->id,frame->data[0],frame->data[1],frame->data[2],frame->data[3],frame->data[4],frame->data[5],frame->data[6],frame->data[7]);
+	return true;
+}
+
+bool writeAdcu(const VehCanFrame &frame)
+{
+	adcuCanData canbuf;
+	memset(&canbuf, 0, sizeof(canbuf));
+	canbuf.ide = frame.ext;
+	canbuf.dlc = frame.dlc;
+	canbuf.rtr = frame.rtr;
+	canbuf.prio = 0x00;
+	canbuf.id = frame.id;
+	memcpy(canbuf.can_data, frame.data, CAN_DATA_SIZE);
+	return adcuDevWrite(devid, (uint8_t *)&canbuf, sizeof(canbuf)) > 0;
 }
 
+//ADCU SDK 只有阻塞读, 没有可以 epoll 的 fd, 单独一个线程读到后交给 vehIo
 pthread_t ReadThread;
 void *readLoop(void *pdata)
 {
   int deviceid = *(int *)pdata;
-  int packageCounter = 0;
-  paraminit();
 
   while (1)
   {
     uint8_t buffer[1024];
-    int length = 0;
-		
-    length = adcuDevRead(deviceid, buffer, 1000);
+    int length = adcuDevRead(deviceid, buffer, 1000);
     if (length > 0)
     {
-    //   packageCounter++;
-    //   printf("RX %9d:", packageCounter);
-    //   for (int i = 0; i < length; i++)
-    //   {
-    //     printf("%02X ", buffer[i]);
-    //   }
-    //   printf("\n");
-		memcpy(candatareceive.candata, &buffer, length);
-        if (candatareceive.canrecvbuf.id == vel_spd || candatareceive.canrecvbuf.id == steer_angle)
-        {
-					uint8_t rec_buf[sizeof(adcuCanData)]={0};
-          for(int i = 0; i < sizeof(adcuCanData); i++)
-          {
-            rec_buf[i] = candatareceive.canrecvbuf.can_data[i];
-            // printf(" %02X", rec_buf[i]);
-          }
-          
-          uint8_t sign=0;
-          switch (candatareceive.canrecvbuf.id)
-          {
-            case vel_spd:
-              VelSpeed = (float)((rec_buf[0] & 0x1f <<8) | rec_buf[1]) * 0.05625f;
-              //printf("velspeed is : %f \n", VelSpeed);
-              msg.VelSpeed = VelSpeed;
-              break;
-            case steer_angle:
-              sign = rec_buf[2] & 0x01;
-              SteerAngle = (float)((rec_buf[1] <<7) | (rec_buf[2] >>1)) * 0.1f;
-              if (!sign) {
-                SteerAngle = -SteerAngle;
-              }
-              msg.SteerAngle = SteerAngle;
-              //printf("SteerAngle is : %f \n", SteerAngle);
-              break;
-            default:
-              break;
-          }
-          pid_loop(&speedcontrol, ExpVelSpeed * Vkm2mConst, VelSpeed * Vkm2mConst, ros::Time::now().toSec());
-          //printf("speedOutput is : %f \n", speedcontrol.Output);
-          if (speedcontrol.Output > 0.02f)
-          {
-            ExpAcce = speedcontrol.Output;
-            ExpDecel = 0.0f;
-            AccelEnable = true;
-            BrakeEnable = false;
-          }
-          else if (speedcontrol.Output < -0.08f)
-          {
-            ExpAcce = 0.0f;
-            ExpDecel = -speedcontrol.Output;  // * 1.2f;
-            if (ExpDecel > 6.5f)
-            {
-              ExpDecel = 6.5f;
-            }
-            
-            AccelEnable = false;
-            BrakeEnable = true;
-          }
-          else
-          {
-            ExpAcce = 0.0f;
-            ExpDecel = 0.0f;
-            AccelEnable = false;
-            BrakeEnable = false;
-          }
-					if (SteerTurnTest)
-					{
-							ExpAngle = 30 * sin((ros::Time::now().toSec() - starttime)/3);
-							msg.ExpAngle = ExpAngle;
-					}
-          msg.ExpSpeed =  ExpVelSpeed;                   
-          msg.ACCexp = speedcontrol.Output;
-          com2veh_pub.publish(msg);
-        }
+      memcpy(candatareceive.candata, &buffer, length > (int)sizeof(candatareceive) ? sizeof(candatareceive) : length);
+      VehCanFrame frame;
+      memset(&frame, 0, sizeof(frame));
+      frame.id = candatareceive.canrecvbuf.id;
+      frame.ext = candatareceive.canrecvbuf.ide;
+      frame.rtr = candatareceive.canrecvbuf.rtr;
+      frame.dlc = CAN_DATA_SIZE;
+      memcpy(frame.data, candatareceive.canrecvbuf.can_data, CAN_DATA_SIZE);
+      vehIo.dispatchRx(frame);
     }
   }
 }
@@ -180,106 +314,96 @@ int main(int argc, char *argv[])
 	ros::NodeHandle n;
 	com2veh_pub = n.advertise<control_msgs::com2veh>("com2vehmsg", 1000);
 	control_vcu_sub_ = n.subscribe("/control/control_vcu",10,recvControlVCUCallback);
-	int devid;
 
-	uint8_t data[100];
-	int len = 0;
-	uint32_t delayTime = 0x0FFFFF;
+	//车辆通信链路: adcu(默认, ADCU CAN 通道) / serial(串口 CAN 转换器) / udp(CANET 网关)
+	ros::NodeHandle pn("~");
+	std::string vehicle_link, serial_dev, udp_ip;
+	int serial_baud, udp_remote_port, udp_local_port;
+	pn.param<std::string>("vehicle_link", vehicle_link, "adcu");
+	pn.param<std::string>("serial_dev", serial_dev, "/dev/ttyUSB0");
+	pn.param("serial_baud", serial_baud, 115200);
+	pn.param<std::string>("udp_ip", udp_ip, "192.168.0.178");
+	pn.param("udp_remote_port", udp_remote_port, 4001);
+	pn.param("udp_local_port", udp_local_port, 4001);
+	//控制指令超时(s), 默认 0.2 即 20 个发送周期
+	double cmd_timeout;
+	pn.param("cmd_timeout", cmd_timeout, 0.2);
+	cmd_timeout_ns = (uint64_t)(cmd_timeout * 1e9);
+	bool use_adcu = (vehicle_link == "adcu");
 
 	adcuDeviceType deviceType;
-	int channel;
+	int channel = 0;
 
-	adcuSDKInit();
-	if (argc != 2)
+	if (use_adcu)
 	{
-		printf("please input correct parameters<channelNumber>\n");
-		return 0;
+		adcuSDKInit();
+		if (argc != 2)
+		{
+			printf("please input correct parameters<channelNumber>\n");
+			return 0;
+		}
+		channel = atoi(argv[1]);
+		if (channel <= 0 || channel >= ADCU_CHANNEL_MAX)
+		{
+			printf("please input correct channel number<%d ~ %d>\n", ADCU_CHANNEL_1, ADCU_CHANNEL_MAX - 1);
+			return 0;
+		}
 	}
-	channel = atoi(argv[1]);
-	if (channel <= 0 || channel >= ADCU_CHANNEL_MAX)
+
+	paraminit();
+	storeCommand();
+	accel_slot.store(VehAccel());
+	starttime = ros::Time::now().toSec();
+	vehIo.setRxHandler(onVehicleFrame);
+	vehIo.setTxTimer(100, buildVehCommand);
+
+	bool io_ok = false;
+	if (use_adcu)
+	{
+		deviceType = adcuCAN;
+		devid = adcuDevOpen(deviceType, (adcuDeviceChannel)channel);
+		io_ok = vehIo.openExternal(writeAdcu);
+		pthread_create(&ReadThread, NULL, readLoop, &devid);
+	}
+	else if (vehicle_link == "serial")
 	{
-		printf("please input correct channel number<%d ~ %d>\n", ADCU_CHANNEL_1, ADCU_CHANNEL_MAX - 1);
+		io_ok = vehIo.openSerial(serial_dev, serial_baud);
+	}
+	else if (vehicle_link == "udp")
+	{
+		io_ok = vehIo.openUdp(udp_ip, udp_remote_port, udp_local_port);
+	}
+	if (!io_ok || !vehIo.start())
+	{
+		ROS_ERROR("open vehicle link %s failed: %s", vehicle_link.c_str(), strerror(errno));
 		return 0;
 	}
 
-	bzero(data, 100);
-	adcuCanData canbuf;
-	canbuf.ide = 0x00;
-	canbuf.dlc = 0x08;
-	canbuf.rtr = 0x00;
-	canbuf.prio = 0x00;
-	canbuf.id = 0x238;
-
-	deviceType = adcuCAN;
-	len = sizeof(adcuCanData);
-	memcpy(data, (uint8_t *)&canbuf, len);
-	delayTime = 1000 / 60;
-
-	devid = adcuDevOpen(deviceType, (adcuDeviceChannel)channel);
-	pthread_create(&ReadThread, NULL, readLoop, &devid);
-
-
 	ros::Rate loop_rate(100);
-	starttime = ros::Time::now().toSec();
 
 	while (ros::ok())
 	{
-		if (adcuDevStatus(devid) == ADCU_DEV_STATUS_ABNORMAL)
+		if (use_adcu && adcuDevStatus(devid) == ADCU_DEV_STATUS_ABNORMAL)
 		{
 			break;
 		}
-
-		uint8_t send_buf[8]={0};
-		if (SteerTurnTest)
-		{
-				AutodriveEnable=true;
-				SteerEnable=true;
-		}
-
-		uint8_t WorkMode=AutodriveEnable, BrkReq=BrakeEnable, DriReq=AccelEnable, StrReq=SteerEnable;
-
-		send_buf[0] = WorkMode<<6 | BrkReq<<3 | DriReq<<2 | StrReq<<1;
-		float TrgDriAcc = ExpAcce;
-		send_buf[4] = (uint8_t)(TrgDriAcc * 10.0f);
-		float TrgBrkAcc = ExpDecel;
-		send_buf[5] = (uint8_t)(TrgBrkAcc * 10.0f);
-		float TrgStrAngle =ExpAngle;
-		if (TrgStrAngle < 0.0f) {
-			TrgStrAngle = -TrgStrAngle;
-			send_buf[6] = ((uint16_t)(TrgStrAngle * 10.0f)) >>8 | 0x80;
-		} 
-		else 
-		{
-			send_buf[6] = ((uint16_t)(TrgStrAngle * 10.0f)) >>8;
-		}
-		//TrgStrAngle need 2 bytes and it is intel format          
-		send_buf[7] = (uint16_t)(TrgStrAngle * 10.0f) & 0x00ff;
-		for(int i = 0; i < canbuf.dlc; i++)
-		{
-			canbuf.can_data[i] = send_buf[i];
-		}
-		
-		bzero(data, 100);
-		memcpy(data, (uint8_t *)&canbuf, len);
-		if (adcuDevWrite(devid, data, len) <= 0)
+		if (vehIo.failed())
 		{
 			printf("main write error\n");
-			goto __end;
-		} 
-		else
-		{
-			ROS_INFO("CAN1 TX ID:0x%08X data:0x %02X %02X %02X %02X %02X %02X %02X %02X", canbuf.id,canbuf.can_data[0],canbuf.can_data[1],canbuf.can_data[2],canbuf.can_data[3],canbuf.can_data[4],canbuf.can_data[5],canbuf.can_data[6],canbuf.can_data[7]);
-
+			break;
 		}
-		
+
 		//chatter_pub.publish(msg);
 		ros::spinOnce();
 
 		loop_rate.sleep();
 	}
-	__end:
-		printf("dinit all \n");
+	printf("dinit all \n");
+	vehIo.stop();
+	if (use_adcu)
+	{
 		adcuDevClose(devid);
 		adcuSDKDeinit();
-		return 0;
-}
\ No newline at end of file
+	}
+	return 0;
+}
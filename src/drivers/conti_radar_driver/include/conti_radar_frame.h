@@ -0,0 +1,304 @@
+#ifndef CONTI_RADAR_FRAME_H_
+#define CONTI_RADAR_FRAME_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// ARS408 目标列表 CAN ID
+#define CONTI_OBJ_LIST_STATUS 0x60A
+#define CONTI_OBJ_GENERAL 0x60B
+#define CONTI_OBJ_QUALITY 0x60C
+
+#define CONTI_MAX_OBJECT_ID 256 // Obj_ID 为8位
+#define CONTI_QUEUE_SIZE 8      //可缓存 CONTI_QUEUE_SIZE - 1 个周期
+
+// CAN 信号定义, 8字节按大端拼成64位, start_bit 为从 byte0 最高位数起的位置
+typedef struct
+{
+  uint8_t start_bit;
+  uint8_t length;
+  double factor;
+  double offset;
+} ContiSignal;
+
+enum ContiListStatusSignal
+{
+  CONTI_LIST_NOF_OBJECTS = 0,
+  CONTI_LIST_MEAS_COUNTER,
+  CONTI_LIST_SIGNAL_NUM
+};
+
+enum ContiGeneralSignal
+{
+  CONTI_GENERAL_ID = 0,
+  CONTI_GENERAL_DIST_LONG,
+  CONTI_GENERAL_DIST_LAT,
+  CONTI_GENERAL_VREL_LONG,
+  CONTI_GENERAL_VREL_LAT,
+  CONTI_GENERAL_DYN_PROP,
+  CONTI_GENERAL_SIGNAL_NUM
+};
+
+enum ContiQualitySignal
+{
+  CONTI_QUALITY_ID = 0,
+  CONTI_QUALITY_PROB_OF_EXIST,
+  CONTI_QUALITY_SIGNAL_NUM
+};
+
+// 0x60A Object_0_Status
+static const ContiSignal conti_list_status_signals[CONTI_LIST_SIGNAL_NUM] = {
+    {0, 8, 1.0, 0.0}, // Object_NofObjects
+    {8, 16, 1.0, 0.0} // Object_MeasCounter
+};
+
+// 0x60B Object_1_General
+static const ContiSignal conti_general_signals[CONTI_GENERAL_SIGNAL_NUM] = {
+    {0, 8, 1.0, 0.0},       // Object_ID
+    {8, 13, 0.2, -500.0},   // Object_DistLong
+    {21, 11, 0.2, -204.6},  // Object_DistLat
+    {32, 10, 0.25, -128.0}, // Object_VrelLong
+    {42, 9, 0.25, -64.0},   // Object_VrelLat
+    {53, 3, 1.0, 0.0}       // Object_DynProp
+};
+
+// 0x60C Object_2_Quality
+static const ContiSignal conti_quality_signals[CONTI_QUALITY_SIGNAL_NUM] = {
+    {0, 8, 1.0, 0.0}, // Obj_ID
+    {48, 3, 1.0, 0.0} // Obj_ProbOfExist
+};
+
+inline uint64_t contiCanPayload(const uint8_t *can_data)
+{
+  uint64_t raw = 0;
+  for (int i = 0; i < 8; i++)
+  {
+    raw = (raw << 8) | can_data[i];
+  }
+  return raw;
+}
+
+inline uint32_t contiSignalRaw(uint64_t payload, const ContiSignal &signal)
+{
+  return ( uint32_t )((payload >> (64 - signal.start_bit - signal.length)) & ((1ull << signal.length) - 1));
+}
+
+inline double contiSignalValue(uint64_t payload, const ContiSignal &signal)
+{
+  return contiSignalRaw(payload, signal) * signal.factor + signal.offset;
+}
+
+typedef struct
+{
+  uint8_t Object_ID_;        // Object ID
+  double Object_DistLong_;   // Longitudinal (x) coordinate
+  double Object_DistLat_;    // Lateral (y) coordinate
+  double Object_VrelLong_;   // Relative velocity in longitudinal direction (x)
+  double Object_VrelLat_;    // Relative velocity in lateral direction (y)
+  uint8_t Object_DynProp_;   // Dynamic property of the object indicating if the object is moving or stationary
+  uint8_t Obj_ProbOfExist_;  // Probability of existence
+  uint32_t cycle_seq_;       //收到 0x60B 时所在周期的序号, 与周期序号相同才属于该周期
+  bool has_quality_;         //本周期收到 0x60C
+} * p_ContiObject, ContiObject;
+
+//一个测量周期的目标, objects_ 按目标ID索引, object_ids_ 为按到达顺序的ID
+typedef struct
+{
+  uint8_t Object_NofObjects_;   // Number of objects (max. 100 Objects)
+  uint16_t Object_MeasCounter_; // Measurement cycle counter
+  uint32_t cycle_seq_;          //组帧序号, 槽复用时不必清空目标数组
+  int object_count_;            //已收到 0x60B 的目标数
+  int quality_count_;           //已收到 0x60C 的目标数
+  uint8_t object_ids_[CONTI_MAX_OBJECT_ID];
+  ContiObject objects_[CONTI_MAX_OBJECT_ID];
+} * p_ContiRadarCycle, ContiRadarCycle;
+
+//单生产者单消费者的周期队列, 生产者(UDP线程)直接在队尾空槽组帧, 完成后提交
+//数据通路无锁, 只有消费者等待时用条件变量唤醒
+class ContiCycleQueue
+{
+public:
+  ContiCycleQueue() : head_(0), tail_(0), drop_count_(0)
+  {
+    memset(slots_, 0, sizeof(slots_));
+  }
+
+  //生产者: 当前组帧的槽, 提交前消费者不可见
+  ContiRadarCycle &writeSlot()
+  {
+    return slots_[head_.load(std::memory_order_relaxed)];
+  }
+
+  //生产者: 提交当前槽, 队列满时丢弃该周期
+  bool commit()
+  {
+    unsigned head = head_.load(std::memory_order_relaxed);
+    unsigned next = (head + 1) % CONTI_QUEUE_SIZE;
+    if (next == tail_.load(std::memory_order_acquire))
+    {
+      drop_count_++;
+      return false;
+    }
+    head_.store(next, std::memory_order_release);
+
+    //加锁只为避免消费者检查队列后、进入等待前错过唤醒
+    {
+      std::lock_guard< std::mutex > lock(wait_mutex_);
+    }
+    wait_cond_.notify_one();
+    return true;
+  }
+
+  //消费者: 取出一个周期, 超时返回false
+  bool pop(ContiRadarCycle &cycle, int timeout_ms)
+  {
+    unsigned tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire))
+    {
+      std::unique_lock< std::mutex > lock(wait_mutex_);
+      if (!wait_cond_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                               [&] { return tail != head_.load(std::memory_order_acquire); }))
+      {
+        return false;
+      }
+    }
+
+    const ContiRadarCycle &slot = slots_[tail];
+    cycle.Object_NofObjects_  = slot.Object_NofObjects_;
+    cycle.Object_MeasCounter_ = slot.Object_MeasCounter_;
+    cycle.cycle_seq_          = slot.cycle_seq_;
+    cycle.object_count_       = slot.object_count_;
+    cycle.quality_count_      = slot.quality_count_;
+    for (int k = 0; k < slot.object_count_; k++)
+    {
+      uint8_t id             = slot.object_ids_[k];
+      cycle.object_ids_[k]   = id;
+      cycle.objects_[id]     = slot.objects_[id];
+    }
+    tail_.store((tail + 1) % CONTI_QUEUE_SIZE, std::memory_order_release);
+    return true;
+  }
+
+  unsigned long dropCount() const
+  {
+    return drop_count_;
+  }
+
+private:
+  ContiRadarCycle slots_[CONTI_QUEUE_SIZE];
+  std::atomic< unsigned > head_;
+  std::atomic< unsigned > tail_;
+  unsigned long drop_count_; //只由生产者修改
+
+  std::mutex wait_mutex_;
+  std::condition_variable wait_cond_;
+};
+
+// CAN 帧组装为测量周期
+// 0x60A 开始新周期; 0x60B/0x60C 按目标ID写入; 收齐 NofObjects 个目标(及其质量信息)或下一个 0x60A 到达时提交
+class ContiFrameAssembler
+{
+public:
+  ContiFrameAssembler() : active_(false), cycle_seq_(0)
+  {
+  }
+
+  void onCanFrame(uint32_t can_id, const uint8_t *can_data)
+  {
+    uint64_t payload = contiCanPayload(can_data);
+
+    if (can_id == CONTI_OBJ_LIST_STATUS)
+    {
+      if (active_)
+      {
+        queue_.commit();
+      }
+      ContiRadarCycle &cycle   = queue_.writeSlot();
+      cycle.Object_NofObjects_ = contiSignalRaw(payload, conti_list_status_signals[CONTI_LIST_NOF_OBJECTS]);
+      cycle.Object_MeasCounter_ =
+          contiSignalRaw(payload, conti_list_status_signals[CONTI_LIST_MEAS_COUNTER]);
+      cycle.cycle_seq_     = ++cycle_seq_;
+      cycle.object_count_  = 0;
+      cycle.quality_count_ = 0;
+      active_              = true;
+      //没有目标的周期直接提交
+      checkComplete();
+      return;
+    }
+
+    if (!active_)
+    {
+      return;
+    }
+
+    ContiRadarCycle &cycle = queue_.writeSlot();
+    if (can_id == CONTI_OBJ_GENERAL)
+    {
+      uint8_t id          = contiSignalRaw(payload, conti_general_signals[CONTI_GENERAL_ID]);
+      ContiObject &object = cycle.objects_[id];
+      if (!isInCycle(cycle, id))
+      {
+        cycle.object_ids_[cycle.object_count_++] = id;
+        object.has_quality_                      = false;
+        object.Obj_ProbOfExist_                  = 0;
+      }
+      object.Object_ID_       = id;
+      object.Object_DistLong_ = contiSignalValue(payload, conti_general_signals[CONTI_GENERAL_DIST_LONG]);
+      object.Object_DistLat_  = contiSignalValue(payload, conti_general_signals[CONTI_GENERAL_DIST_LAT]);
+      object.Object_VrelLong_ = contiSignalValue(payload, conti_general_signals[CONTI_GENERAL_VREL_LONG]);
+      object.Object_VrelLat_  = contiSignalValue(payload, conti_general_signals[CONTI_GENERAL_VREL_LAT]);
+      object.Object_DynProp_  = contiSignalRaw(payload, conti_general_signals[CONTI_GENERAL_DYN_PROP]);
+      object.cycle_seq_       = cycle.cycle_seq_;
+      checkComplete();
+    }
+    else if (can_id == CONTI_OBJ_QUALITY)
+    {
+      uint8_t id = contiSignalRaw(payload, conti_quality_signals[CONTI_QUALITY_ID]);
+      //质量信息在 0x60B 之后发送, 不属于本周期目标的丢弃
+      if (!isInCycle(cycle, id))
+      {
+        return;
+      }
+      ContiObject &object = cycle.objects_[id];
+      if (!object.has_quality_)
+      {
+        cycle.quality_count_++;
+      }
+      object.Obj_ProbOfExist_ = contiSignalRaw(payload, conti_quality_signals[CONTI_QUALITY_PROB_OF_EXIST]);
+      object.has_quality_     = true;
+      checkComplete();
+    }
+  }
+
+  ContiCycleQueue &queue()
+  {
+    return queue_;
+  }
+
+private:
+  bool isInCycle(const ContiRadarCycle &cycle, uint8_t id) const
+  {
+    return cycle.objects_[id].cycle_seq_ == cycle.cycle_seq_;
+  }
+
+  void checkComplete()
+  {
+    ContiRadarCycle &cycle = queue_.writeSlot();
+    if (cycle.object_count_ >= cycle.Object_NofObjects_ && cycle.quality_count_ >= cycle.Object_NofObjects_)
+    {
+      queue_.commit();
+      active_ = false;
+    }
+  }
+
+  ContiCycleQueue queue_;
+  bool active_;        //当前槽正在组帧
+  uint32_t cycle_seq_; //从1开始, 目标的0表示未写入
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include <iostream>
 
 #include "common_functions.h"
+#include "conti_radar_frame.h"
 // #include <sys/types.h>
 
 #include <boost/predef/other/endian.h>
@@ -21,9 +22,6 @@
 
 #include <thread>
 
-#include <list>
-#include <map>
-
 #include <yaml-cpp/yaml.h>
 
 #include <sys/syscall.h>
@@ -71,46 +69,6 @@ void operator>>(const YAML::Node &node, Conti_Device &contiDevice)
   node["topic_name_2"] >> contiDevice.topic_name_2;
 }
 
-typedef struct
-{
-  uint8_t ide;         /*!< 0: standard frame, 1: extended frame */
-  uint8_t dlc;         /*!< data length */
-  uint8_t rtr;         /*!< remote transmission request */
-  uint8_t prio;        /*!< priority */
-  uint32_t id;         /*!< identify */
-  uint8_t can_data[8]; /*!< datas */
-} * p_myCanData, myCanData;
-
-typedef struct
-{
-  uint8_t Object_ID_;      // Object ID
-  double Object_DistLong_; // Longitudinal (x) coordinate
-  double Object_DistLat_;  // Lateral (y) coordinate
-  double Object_VrelLong_; // Relative velocity in longitudinal direction (x)
-  double Object_VrelLat_;  // Relative velocity in lateral direction (y)
-  uint8_t Object_DynProp_; // Dynamic property of the object indicating if the object is moving or stationary
-
-} * p_ars60B_Data, ars60B_Data;
-
-typedef struct
-{
-  uint32_t icount_;         // 60C msgs counter
-  uint8_t Obj_ProbOfExist_; // Probability of existence
-} * p_ars60C_Data, ars60C_Data;
-
-typedef struct
-{
-  int iflag_;
-  uint8_t Object_NofObjects_;   // Number of objects (max. 100 Objects)
-  uint16_t Object_MeasCounter_; // Measurement cycle counter (counting up since startup of sensor and restarting at 0
-  // when > 65535)
-  int obj60b_count;
-  int obj60c_count;
-  map< int, ars60B_Data > map_ars60B_data_;
-  map< int, ars60C_Data > map_ars60C_data_;
-
-} * p_arsABC_ObjData, arsABC_ObjData;
-
 class RadarDataProcess : public UdpProcessCallBack
 {
 public:
@@ -124,11 +82,11 @@ public:
 
   void start();
 
-  list< arsABC_ObjData > list_arsABC_objdata_;
-
-  arsABC_ObjData arsABC_objdata_;
+  // UDP线程组帧, 发送线程取出完整周期
+  ContiFrameAssembler assembler_;
 
-  list< myCanData > list_myCanData_;
+  //发送线程使用, 只拷贝本周期目标
+  ContiRadarCycle cycle_;
 
   std::string topic1_, topic2_;
 
@@ -139,15 +97,12 @@ public:
 RadarDataProcess::RadarDataProcess(std::string topic1, std::string topic2) : topic1_(topic1), topic2_(topic2)
 {
   ROS_INFO("process[%d] thread[%u] %s", getpid(), ( unsigned int )pthread_self(), topic1_.data());
-
-  arsABC_objdata_.iflag_ = 0;
 }
 RadarDataProcess::RadarDataProcess(std::string log_dir, std::string sensor_name, Conti_Device &ContiDevice)
 {
   // ROS_INFO("RadarDataProcess process[%d] thread[%lu] %s", getpid(), ( unsigned int )pthread_self(), topic1_.data());
-  arsABC_objdata_.iflag_ = 0;
-  topic1_                = ContiDevice.topic_name_1;
-  topic2_                = ContiDevice.topic_name_2;
+  topic1_ = ContiDevice.topic_name_1;
+  topic2_ = ContiDevice.topic_name_2;
 
   // udp_.reset(new UdpProcess());
   // udp_->log_dir_     = log_dir;
@@ -164,59 +119,8 @@ RadarDataProcess::~RadarDataProcess()
 
 void RadarDataProcess::OnUdpProcessCallBack(unsigned char *data, int len, struct sockaddr_in addr_)
 {
-
-  //解析CAN协议 提取CAN ID
-  myCanData canbuf_;
-  canbuf_.id = bytesToInt32(&data[1], 4);
-  memcpy(canbuf_.can_data, &data[5], 8);
-
-  list_myCanData_.push_back(canbuf_);
-
-  //判断是否等于 60A 添加到发送列表并清空单包变量
-  if (canbuf_.id == 0x60A)
-  {
-    if (arsABC_objdata_.iflag_ == 1)
-      list_arsABC_objdata_.push_back(arsABC_objdata_);
-    arsABC_objdata_.iflag_              = 1;
-    arsABC_objdata_.obj60b_count        = 0;
-    arsABC_objdata_.obj60c_count        = 0;
-    arsABC_objdata_.Object_NofObjects_  = canbuf_.can_data[0];
-    arsABC_objdata_.Object_MeasCounter_ = bytesToInt16(&canbuf_.can_data[1]);
-    arsABC_objdata_.map_ars60B_data_.clear();
-    arsABC_objdata_.map_ars60C_data_.clear();
-  }
-  // printf("%d-%d \n", data[5], data[5]);
-  // printf("%d-%d \n", arsABC_objdata_.Object_NofObjects_, arsABC_objdata_.Object_MeasCounter_);
-
-  // 60B 加入 OBJ 数据
-  if (canbuf_.id == 0x60B)
-  {
-    ars60B_Data ars60B_Data_;
-    // ID
-    ars60B_Data_.Object_ID_ = (canbuf_.can_data[0] >> 0);
-    // distance x
-    ars60B_Data_.Object_DistLong_ = ((canbuf_.can_data[1] << 5) | (canbuf_.can_data[2] >> 3)) * 0.2 - 500;
-    // distance y
-    ars60B_Data_.Object_DistLat_ = (((canbuf_.can_data[2] & 0x07) << 8) | (canbuf_.can_data[3] >> 0)) * 0.2 - 204.6;
-    // velocity x
-    ars60B_Data_.Object_VrelLong_ = ((canbuf_.can_data[4] << 2) | (canbuf_.can_data[5] >> 6)) * 0.25 - 128;
-    // velocity y
-    ars60B_Data_.Object_VrelLat_ = (((canbuf_.can_data[5] & 0x3F) << 3) | (canbuf_.can_data[6] >> 5)) * 0.25 - 64;
-    arsABC_objdata_.map_ars60B_data_.insert({arsABC_objdata_.obj60b_count, ars60B_Data_});
-    arsABC_objdata_.obj60b_count++;
-  }
-  // 60C 加入
-  if (canbuf_.id == 0x60C)
-  {
-    ars60C_Data ars60C_Data_;
-    // ID
-    ars60C_Data_.icount_ = arsABC_objdata_.obj60c_count;
-    // existance probability
-    ars60C_Data_.Obj_ProbOfExist_ = canbuf_.can_data[6] >> 5;
-
-    arsABC_objdata_.map_ars60C_data_.insert({arsABC_objdata_.obj60c_count, ars60C_Data_});
-    arsABC_objdata_.obj60c_count++;
-  }
+  //解析CAN协议 提取CAN ID, 按ID写入当前周期
+  assembler_.onCanFrame(bytesToInt32(&data[1], 4), &data[5]);
 }
 
 //发布话题
@@ -229,75 +133,74 @@ void RadarDataProcess::radar_Sender()
   ros::Publisher radar_info_pub_        = nh.advertise< perception_sensor_msgs::ObjectList >(topic1_.data(), 2);
   ros::Publisher radar_point_cloud_pub_ = nh.advertise< sensor_msgs::PointCloud2 >(topic2_.data(), 2);
 
-  ros::Rate loop_rate(100);
+  perception_sensor_msgs::ObjectList object_list;
+  common_msgs::DetectionInfo detection_info;
+  pcl::PointCloud< pcl::PointXYZ > radar_point;
+  pcl::PointXYZ pcl_point;
+
+  detection_info.obj_class       = 255;
+  detection_info.measurement_cov = {0.009, 0, 0, 0, 0, 0.009, 0, 0, 0, 0, 0.09, 0, 0, 0, 0, 0.09};
+  for (int i = 0; i < 4; i++)
+  {
+    detection_info.peek[i].x = 2147483647;
+    detection_info.peek[i].y = 2147483647;
+  }
+
+  unsigned long drop_count = 0;
   while (ros::ok())
   {
-    loop_rate.sleep();
-    if (!list_arsABC_objdata_.empty())
+    //周期收齐即发布, 超时只为检查 ros::ok()
+    if (!assembler_.queue().pop(cycle_, 100))
     {
-      // ROS_INFO("thread[%u] list size = %d", ( unsigned int )pthread_self(), ( int )list_arsABC_objdata_.size());
-      arsABC_ObjData arsABC_obj_;
-      arsABC_obj_ = list_arsABC_objdata_.front();
-
-      perception_sensor_msgs::ObjectList object_list;
-      common_msgs::DetectionInfo detection_info;
-      // perception_sensor_msgs::Point point;
-
-      pcl::PointCloud< pcl::PointXYZ > radar_point;
-      pcl::PointXYZ pcl_point;
-      // pcl::PointXYZI pcl_pointxyzi_;
-
-      object_list.obstacle_num    = arsABC_obj_.Object_NofObjects_;
-      object_list.header.frame_id = "odom";
-      object_list.header.stamp    = ros::Time::now();
-      for (int k = 0; k < object_list.obstacle_num; k++)
-      {
-        detection_info.id = arsABC_obj_.map_ars60B_data_[k].Object_ID_;
-
-        detection_info.obj_class       = 255;
-        detection_info.state[0]        = arsABC_obj_.map_ars60B_data_[k].Object_DistLong_ * 1000;
-        detection_info.state[1]        = arsABC_obj_.map_ars60B_data_[k].Object_DistLat_ * 1000;
-        detection_info.state[2]        = arsABC_obj_.map_ars60B_data_[k].Object_VrelLong_ * 1000;
-        detection_info.state[3]        = arsABC_obj_.map_ars60B_data_[k].Object_VrelLat_ * 1000;
-        detection_info.measurement_cov = {0.009, 0, 0, 0, 0, 0.009, 0, 0, 0, 0, 0.09, 0, 0, 0, 0, 0.09};
-        detection_info.confidence      = arsABC_obj_.map_ars60C_data_[k].Obj_ProbOfExist_;
-        detection_info.peek[0].x       = 2147483647;
-        detection_info.peek[0].y       = 2147483647;
-        detection_info.peek[1].x       = 2147483647;
-        detection_info.peek[1].y       = 2147483647;
-        detection_info.peek[2].x       = 2147483647;
-        detection_info.peek[2].y       = 2147483647;
-        detection_info.peek[3].x       = 2147483647;
-        detection_info.peek[3].y       = 2147483647;
-
-        object_list.object_list.push_back(detection_info);
-
-        // pub for projection
-        pcl_point.x = arsABC_obj_.map_ars60B_data_[k].Object_DistLong_;
-        pcl_point.y = arsABC_obj_.map_ars60B_data_[k].Object_DistLat_;
-        pcl_point.z = 0;
-        // pcl_point.intensity = 1.1;
-
-        radar_point.push_back(pcl_point);
-      }
+      continue;
+    }
+
+    if (assembler_.queue().dropCount() != drop_count)
+    {
+      drop_count = assembler_.queue().dropCount();
+      ROS_WARN("%s radar cycle dropped, total %lu", topic1_.data(), drop_count);
+    }
 
-      sensor_msgs::PointCloud2 msg_radar;
-      pcl::toROSMsg(radar_point, msg_radar);
-      msg_radar.header.frame_id = "odom";
-      msg_radar.header.stamp    = ros::Time::now();
-      radar_point_cloud_pub_.publish(msg_radar);
-      radar_point.clear();
+    object_list.object_list.clear();
+    object_list.object_list.reserve(cycle_.object_count_);
+    radar_point.clear();
+    radar_point.reserve(cycle_.object_count_);
 
-      if (radar_info_pub_.getNumSubscribers() != 0) // no one listening?// avoid much work
-      {
-        radar_info_pub_.publish(object_list);
-      }
+    object_list.obstacle_num    = cycle_.object_count_;
+    object_list.header.frame_id = "odom";
+    object_list.header.stamp    = ros::Time::now();
+    for (int k = 0; k < cycle_.object_count_; k++)
+    {
+      const ContiObject &object = cycle_.objects_[cycle_.object_ids_[k]];
+
+      detection_info.id         = object.Object_ID_;
+      detection_info.state[0]   = object.Object_DistLong_ * 1000;
+      detection_info.state[1]   = object.Object_DistLat_ * 1000;
+      detection_info.state[2]   = object.Object_VrelLong_ * 1000;
+      detection_info.state[3]   = object.Object_VrelLat_ * 1000;
+      detection_info.confidence = object.Obj_ProbOfExist_;
+
+      object_list.object_list.push_back(detection_info);
 
-      object_list.object_list.clear();
-      list_arsABC_objdata_.pop_front();
+      // pub for projection
+      pcl_point.x = object.Object_DistLong_;
+      pcl_point.y = object.Object_DistLat_;
+      pcl_point.z = 0;
 
-    } // list_arsABC_objdata_.empty()
-  }   // while (ros::ok())
+      radar_point.push_back(pcl_point);
+    }
+
+    sensor_msgs::PointCloud2 msg_radar;
+    pcl::toROSMsg(radar_point, msg_radar);
+    msg_radar.header.frame_id = "odom";
+    msg_radar.header.stamp    = object_list.header.stamp;
+    radar_point_cloud_pub_.publish(msg_radar);
+
+    if (radar_info_pub_.getNumSubscribers() != 0) // no one listening?// avoid much work
+    {
+      radar_info_pub_.publish(object_list);
+    }
+  } // while (ros::ok())
 }
 
 void RadarDataProcess::start()
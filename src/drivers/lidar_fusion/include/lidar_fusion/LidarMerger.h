@@ -0,0 +1,74 @@
+#ifndef LIDAR_MERGER_H
+#define LIDAR_MERGER_H
+
+#include <pcl/point_types.h>
+#include <pcl/point_cloud.h>
+#include <Eigen/Geometry>
+#include <string>
+#include <vector>
+#include <ostream>
+
+//单个雷达的缓存和统计
+struct LidarSlot
+{
+    std::string name;
+    Eigen::Affine3f extrinsic;                  //雷达到输出坐标系的变换，启动时计算一次
+    pcl::PointCloud<pcl::PointXYZI> cloud;      //已变换的最新一帧，内存重复使用
+    double stamp;                               //最新一帧的时间戳
+    double last_recv_time;                      //最近一次收到的系统时间，小于0表示从未收到
+    bool ready;                                 //已收到且未参与融合
+
+    int recv_count;         //收到帧数
+    int merge_count;        //参与融合的帧数
+    int drop_count;         //未参与融合就被丢弃的帧数
+    int dropout_count;      //超时未收到，融合时被跳过的次数
+    double age_sum;         //参与融合时 当前时间-时间戳 的累计
+    double age_max;
+};
+
+//多雷达近似时间同步融合
+//每帧点云到达时只变换一次，存入该雷达的缓存；所有在线雷达都有未融合的帧，
+//且时间戳最大差不超过tolerance时拼接输出；超过dropout_timeout未收到的雷达视为掉线，不等待
+class LidarMerger
+{
+public:
+    //构造函数和析构函数
+    LidarMerger();
+    ~LidarMerger();
+
+    //添加雷达，返回雷达序号
+    int addLidar(const std::string &name, const Eigen::Affine3f &extrinsic);
+
+    void setTolerance(double tolerance);
+    void setDropoutTimeout(double dropout_timeout);
+
+    //输入雷达坐标系下的点云，满足同步条件时返回true，用getMergedCloud取结果
+    bool addCloud(int index, double stamp, double now, const pcl::PointCloud<pcl::PointXYZI> &cloud);
+
+    const pcl::PointCloud<pcl::PointXYZI> &getMergedCloud() const;
+    double getMergedStamp() const;
+    int getMergedCount() const;
+    int getRecvCount() const;
+    //上次融合之后收到的帧数，持续增长说明同步失败
+    int getUnmergedCount() const;
+
+    //输出各雷达统计
+    void printStatistics(std::ostream &os) const;
+
+private:
+    bool tryMerge(double now);
+    bool isOnline(const LidarSlot &slot, double now) const;
+
+    std::vector<LidarSlot> slots_;
+    pcl::PointCloud<pcl::PointXYZI> merged_cloud_;     //融合结果，内存重复使用
+    double merged_stamp_;
+    int merged_count_;
+    int recv_count_;            //所有雷达收到的帧数
+    int unmerged_count_;        //上次融合之后收到的帧数
+
+    double tolerance_;          //同一融合帧内时间戳最大差(s)
+    double dropout_timeout_;    //超过该时间未收到视为掉线(s)
+};
+
+
+#endif
@@ -0,0 +1,191 @@
+#include "LidarMerger.h"
+#include <pcl/common/transforms.h>
+#include <iomanip>
+
+//构造函数
+LidarMerger::LidarMerger():
+    merged_stamp_(0.0),
+    merged_count_(0),
+    recv_count_(0),
+    unmerged_count_(0),
+    tolerance_(0.05),
+    dropout_timeout_(0.5)
+{}
+
+//析构函数
+LidarMerger::~LidarMerger()
+{}
+
+int LidarMerger::addLidar(const std::string &name, const Eigen::Affine3f &extrinsic)
+{
+    LidarSlot slot;
+    slot.name = name;
+    slot.extrinsic = extrinsic;
+    slot.stamp = 0.0;
+    slot.last_recv_time = -1.0;
+    slot.ready = false;
+    slot.recv_count = 0;
+    slot.merge_count = 0;
+    slot.drop_count = 0;
+    slot.dropout_count = 0;
+    slot.age_sum = 0.0;
+    slot.age_max = 0.0;
+    slots_.push_back(slot);
+    return slots_.size() - 1;
+}
+
+void LidarMerger::setTolerance(double tolerance)
+{
+    tolerance_ = tolerance;
+}
+
+void LidarMerger::setDropoutTimeout(double dropout_timeout)
+{
+    dropout_timeout_ = dropout_timeout;
+}
+
+bool LidarMerger::addCloud(int index, double stamp, double now, const pcl::PointCloud<pcl::PointXYZI> &cloud)
+{
+    LidarSlot &slot = slots_[index];
+
+    //上一帧还没参与融合就被覆盖
+    if(slot.ready)
+        slot.drop_count ++;
+
+    //只变换一次，直接写入该雷达的缓存
+    pcl::transformPointCloud(cloud, slot.cloud, slot.extrinsic);
+    slot.stamp = stamp;
+    slot.last_recv_time = now;
+    slot.ready = true;
+    slot.recv_count ++;
+    recv_count_ ++;
+    unmerged_count_ ++;
+
+    return tryMerge(now);
+}
+
+bool LidarMerger::tryMerge(double now)
+{
+    //在线雷达都要有未融合的帧
+    double min_stamp = 0.0;
+    double max_stamp = 0.0;
+    int oldest = -1;
+    int online = 0;
+    for(int i = 0; i < slots_.size(); i ++)
+    {
+        const LidarSlot &slot = slots_[i];
+        if(!isOnline(slot, now))
+            continue;
+        if(!slot.ready)
+            return false;
+
+        if(online == 0 || slot.stamp < min_stamp)
+        {
+            min_stamp = slot.stamp;
+            oldest = i;
+        }
+        if(online == 0 || slot.stamp > max_stamp)
+            max_stamp = slot.stamp;
+        online ++;
+    }
+    if(online == 0)
+        return false;
+
+    //最旧的一帧不可能再与其它雷达的新帧匹配，丢弃后等待该雷达的下一帧
+    if(max_stamp - min_stamp > tolerance_)
+    {
+        slots_[oldest].ready = false;
+        slots_[oldest].drop_count ++;
+        return false;
+    }
+
+    int total = 0;
+    for(int i = 0; i < slots_.size(); i ++)
+    {
+        if(isOnline(slots_[i], now))
+            total += slots_[i].cloud.size();
+    }
+    merged_cloud_.points.resize(total);
+    merged_cloud_.width = total;
+    merged_cloud_.height = 1;
+    merged_cloud_.is_dense = true;
+
+    int offset = 0;
+    for(int i = 0; i < slots_.size(); i ++)
+    {
+        LidarSlot &slot = slots_[i];
+        if(!isOnline(slot, now))
+        {
+            //掉线前留下的帧已过时
+            if(slot.ready)
+            {
+                slot.ready = false;
+                slot.drop_count ++;
+            }
+            slot.dropout_count ++;
+            continue;
+        }
+        std::copy(slot.cloud.points.begin(), slot.cloud.points.end(), merged_cloud_.points.begin() + offset);
+        offset += slot.cloud.size();
+        merged_cloud_.is_dense = merged_cloud_.is_dense && slot.cloud.is_dense;
+
+        double age = now - slot.stamp;
+        slot.age_sum += age;
+        if(age > slot.age_max)
+            slot.age_max = age;
+        slot.merge_count ++;
+        slot.ready = false;
+    }
+    merged_stamp_ = max_stamp;
+    merged_count_ ++;
+    unmerged_count_ = 0;
+    return true;
+}
+
+bool LidarMerger::isOnline(const LidarSlot &slot, double now) const
+{
+    return slot.last_recv_time >= 0 && now - slot.last_recv_time <= dropout_timeout_;
+}
+
+const pcl::PointCloud<pcl::PointXYZI> &LidarMerger::getMergedCloud() const
+{
+    return merged_cloud_;
+}
+
+double LidarMerger::getMergedStamp() const
+{
+    return merged_stamp_;
+}
+
+int LidarMerger::getMergedCount() const
+{
+    return merged_count_;
+}
+
+int LidarMerger::getRecvCount() const
+{
+    return recv_count_;
+}
+
+int LidarMerger::getUnmergedCount() const
+{
+    return unmerged_count_;
+}
+
+void LidarMerger::printStatistics(std::ostream &os) const
+{
+    os << "Merged frames: " << merged_count_ << " received: " << recv_count_
+       << " since last merge: " << unmerged_count_ << std::endl;
+    for(int i = 0; i < slots_.size(); i ++)
+    {
+        const LidarSlot &slot = slots_[i];
+        double age_mean = slot.merge_count > 0 ? slot.age_sum / slot.merge_count : 0.0;
+        os << slot.name << " recv: " << slot.recv_count
+           << " merged: " << slot.merge_count
+           << " dropped: " << slot.drop_count
+           << " dropout: " << slot.dropout_count
+           << std::setprecision(4)
+           << " age mean: " << age_mean
+           << " age max: " << slot.age_max << std::endl;
+    }
+}
@@ -8,16 +8,18 @@
 #include <message_filters/time_synchronizer.h>
 #include <pcl/common/transforms.h>
 #include <boost/foreach.hpp>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <pcl/common/angles.h>
 #include <pcl/io/pcd_io.h>
-#include "ImageSegment.h"
+#include "range_image_ground.h"
+#include "LidarMerger.h"
 
 using namespace message_filters;
 
 ros::Publisher pub;
-ImageSegment imageSegment;
+superg_agv::common::RangeImageGround rangeImage;     //16线, 水平分辨率0.2度
 
 //lidar_201 --> lidar_202
 Eigen::Matrix4f R12;	
@@ -30,45 +32,63 @@ Eigen::Matrix4f transform_matrix_110_car;
 
 std::ofstream log_file("/home/wangdigang/lidar_fusion.log", std::ios::out | std::ios::app);;
 
-pcl::PointCloud<pcl::PointXYZI> lidar, lidar1, lidar2, lidar3, lidar4;
+const char *lidar_names[4] = {"velodyne 201", "velodyne 202", "robotsensor 109", "robotsensor 110"};
+pcl::PointCloud<pcl::PointXYZI> lidar_clouds[4];
+LidarMerger lidarMerger;
+int stats_interval = 100;       //每收到多少帧输出一次统计
+int merge_warn_frames = 20;     //连续收到多少帧仍未融合时报警
 
-void lidar1Callback(const sensor_msgs::PointCloud2::ConstPtr &msg)
+//4x4外参矩阵转Eigen::Affine3f
+Eigen::Affine3f toAffine(const Eigen::Matrix4f &matrix)
+{
+    Eigen::Affine3f affine;
+    affine.matrix() = matrix;
+    return affine;
+}
+
+//地面分割: 按坐标求线号和列号填入距离图像, (min_angle, max_angle) 为车体遮挡的水平角度
+void segmentGround(const pcl::PointCloud<pcl::PointXYZI> &laser, float min_angle, float max_angle,
+                   pcl::PointCloud<pcl::PointXYZI> &filtered, pcl::PointCloud<pcl::PointXYZI> *ground)
 {
-    log_file << "Timestamp of velodyne 201: " << std::setprecision(15) << msg->header.stamp << std::endl;
+    rangeImage.setSkipAngle(min_angle, max_angle);
+    rangeImage.clear();
+    for(const pcl::PointXYZI &point : laser)
+        rangeImage.addPoint(point.x, point.y, point.z);
+    rangeImage.label();
+    rangeImage.extract(ground, &filtered);
+}
+
+//单个雷达的处理: 分割后交给融合器，变换只在融合器内做一次；满足同步条件时发布
+void lidarCallback(const sensor_msgs::PointCloud2::ConstPtr &msg, int index, float min_angle, float max_angle)
+{
+    log_file << "Timestamp of " << lidar_names[index] << ": " << std::setprecision(15) << msg->header.stamp << std::endl;
     log_file << "Start timestamp of lidar fusion is: " << ros::Time::now().toSec() << std::endl;
     double start_time = ros::Time::now().toSec();
     log_file << "Start delay time is: " << std::setprecision(15) << ros::Time::now().toSec() - msg->header.stamp.toSec() << std::endl;
-    lidar1.clear();
-    pcl::fromROSMsg(*msg, lidar1);
-    // velodyne lidar (IP: 192.168.2.201)
-    imageSegment.setMinAndMaxAngle(-98.0, 9.0);
-    // imageSegment.setMinAndMaxAngle(-180.0, 180.0);
-    imageSegment.setPointCloud(lidar1);
-    imageSegment.segment();
-    pcl::PointCloud<pcl::PointXYZI> filtered = imageSegment.getFilteredCloud();
-    pcl::PointCloud<pcl::PointXYZI> ground = imageSegment.getGround();
-    //lidar_201 --> lidar_202
-    pcl::transformPointCloud(filtered, filtered, R12);
-    //lidar_201 --> car
-    pcl::transformPointCloud(filtered, filtered, R2c);
-
-    Eigen::AngleAxisf q_v(pcl::deg2rad(90.0), Eigen::Vector3f::UnitZ());
-    Eigen::Matrix4f Rinv = Eigen::Matrix4f::Identity();
-    Rinv.block<3,3>(0,0) = q_v.matrix();
-    pcl::transformPointCloud(filtered, filtered, Rinv);
-
-    lidar.clear();
-    lidar1 = filtered;
-    lidar += lidar1;
-    lidar += lidar2;
-    lidar += lidar3;
-    lidar += lidar4;
-
-    sensor_msgs::PointCloud2 newMsg;
-    pcl::toROSMsg(lidar, newMsg);
-    newMsg.header = msg->header;
-    newMsg.header.frame_id = "velodyne";
-    pub.publish(newMsg);
+    lidar_clouds[index].clear();
+    pcl::fromROSMsg(*msg, lidar_clouds[index]);
+    pcl::PointCloud<pcl::PointXYZI> filtered;
+    segmentGround(lidar_clouds[index], min_angle, max_angle, filtered, NULL);
+
+    if(lidarMerger.addCloud(index, msg->header.stamp.toSec(), start_time, filtered))
+    {
+        sensor_msgs::PointCloud2 newMsg;
+        pcl::toROSMsg(lidarMerger.getMergedCloud(), newMsg);
+        newMsg.header = msg->header;
+        newMsg.header.stamp = ros::Time(lidarMerger.getMergedStamp());
+        newMsg.header.frame_id = "velodyne";
+        pub.publish(newMsg);
+    }
+
+    //按收到的帧数输出统计，同步失败一直不融合时也能看到
+    if(lidarMerger.getRecvCount() % stats_interval == 0)
+        lidarMerger.printStatistics(log_file);
+    if(lidarMerger.getUnmergedCount() >= merge_warn_frames)
+    {
+        ROS_WARN_THROTTLE(1.0, "lidar fusion: no merge for %d frames, check lidar timestamps", lidarMerger.getUnmergedCount());
+        if(lidarMerger.getUnmergedCount() % merge_warn_frames == 0)
+            log_file << "No merge for " << lidarMerger.getUnmergedCount() << " frames" << std::endl;
+    }
 
     log_file << "End timestamp is: " << std::setprecision(15) << ros::Time::now().toSec() << std::endl;
     log_file << "End delay time is: " << std::setprecision(15) << ros::Time::now().toSec() - msg->header.stamp.toSec() << std::endl;
@@ -76,132 +96,28 @@ void lidar1Callback(const sensor_msgs::PointCloud2::ConstPtr &msg)
     log_file << "Elapsed time of lidar fusion is: " << std::setprecision(15) << elapsed_time << std::endl << std::endl;
 }
 
+void lidar1Callback(const sensor_msgs::PointCloud2::ConstPtr &msg)
+{
+    // velodyne lidar (IP: 192.168.2.201)
+    lidarCallback(msg, 0, -98.0, 9.0);
+}
+
 void lidar2Callback(const sensor_msgs::PointCloud2::ConstPtr &msg)
 {
-    log_file << "Timestamp of velodyne 202: " << std::setprecision(15) << msg->header.stamp << std::endl;
-    log_file << "Start timestamp of lidar fusion is: " << ros::Time::now().toSec() << std::endl;
-    double start_time = ros::Time::now().toSec();
-    log_file << "Start delay time is: " << std::setprecision(15) << ros::Time::now().toSec() - msg->header.stamp.toSec() << std::endl;
-    lidar2.clear();
-    pcl::fromROSMsg(*msg, lidar2);
     // velodyne lidar (IP: 192.168.2.202)
-    imageSegment.setMinAndMaxAngle(-6.0, 99.0);
-    // imageSegment.setMinAndMaxAngle(-180.0, 180.0);
-    imageSegment.setPointCloud(lidar2);
-    imageSegment.segment();
-    pcl::PointCloud<pcl::PointXYZI> filtered = imageSegment.getFilteredCloud();
-    pcl::PointCloud<pcl::PointXYZI> ground = imageSegment.getGround();
-    //lidar_202 --> car
-    pcl::transformPointCloud(filtered, filtered, R2c);
-
-    Eigen::AngleAxisf q_v(pcl::deg2rad(90.0), Eigen::Vector3f::UnitZ());
-    Eigen::Matrix4f Rinv = Eigen::Matrix4f::Identity();
-    Rinv.block<3,3>(0,0) = q_v.matrix();
-    pcl::transformPointCloud(filtered, filtered, Rinv);
-
-    lidar.clear();
-    lidar2 = filtered;
-    lidar += lidar1;
-    lidar += lidar2;
-    lidar += lidar3;
-    lidar += lidar4;
-
-    sensor_msgs::PointCloud2 newMsg;
-    pcl::toROSMsg(lidar, newMsg);
-    newMsg.header = msg->header;
-    newMsg.header.frame_id = "velodyne";
-    pub.publish(newMsg);
-
-    log_file << "End timestamp is: " << std::setprecision(15) << ros::Time::now().toSec() << std::endl;
-    log_file << "End delay time is: " << std::setprecision(15) << ros::Time::now().toSec() - msg->header.stamp.toSec() << std::endl;
-    double elapsed_time = ros::Time::now().toSec() - start_time;
-    log_file << "Elapsed time of lidar fusion is: " << std::setprecision(15) << elapsed_time << std::endl << std::endl;
+    lidarCallback(msg, 1, -6.0, 99.0);
 }
 
 void lidar3Callback(const sensor_msgs::PointCloud2::ConstPtr &msg)
 {
-    log_file << "Timestamp of robotsensor 109: " << std::setprecision(15) << msg->header.stamp << std::endl;
-    log_file << "Start timestamp of lidar fusion is: " << ros::Time::now().toSec() << std::endl;
-    double start_time = ros::Time::now().toSec();
-    log_file << "Start delay time is: " << std::setprecision(15) << ros::Time::now().toSec() - msg->header.stamp.toSec() << std::endl;
-    lidar3.clear();
-    pcl::fromROSMsg(*msg, lidar3);
     // robotsensor lidar (IP: 192.168.2.109)
-    imageSegment.setMinAndMaxAngle(8.0, 121.0);
-    // imageSegment.setMinAndMaxAngle(-180.0, 180.0);
-    imageSegment.setPointCloud(lidar3);
-    imageSegment.segment();
-    pcl::PointCloud<pcl::PointXYZI> filtered = imageSegment.getFilteredCloud();
-    pcl::PointCloud<pcl::PointXYZI> ground = imageSegment.getGround();
-    // lidar (IP: 192.168.2.109) --> lidar (IP: 192.168.2.110)
-    pcl::transformPointCloud(filtered, filtered, transform_matrix_109_110);
-    // lidar (IP: 192.168.2.109) --> car
-    pcl::transformPointCloud(filtered, filtered, transform_matrix_110_car);
-
-    Eigen::AngleAxisf q_v(pcl::deg2rad(90.0), Eigen::Vector3f::UnitZ());
-    Eigen::Matrix4f Rinv = Eigen::Matrix4f::Identity();
-    Rinv.block<3,3>(0,0) = q_v.matrix();
-    pcl::transformPointCloud(filtered, filtered, Rinv);
-
-    lidar.clear();
-    lidar3 = filtered;
-    lidar += lidar1;
-    lidar += lidar2;
-    lidar += lidar3;
-    lidar += lidar4;
-
-    sensor_msgs::PointCloud2 newMsg;
-    pcl::toROSMsg(lidar, newMsg);
-    newMsg.header = msg->header;
-    newMsg.header.frame_id = "velodyne";
-    pub.publish(newMsg);
-
-    log_file << "End timestamp is: " << std::setprecision(15) << ros::Time::now().toSec() << std::endl;
-    log_file << "End delay time is: " << std::setprecision(15) << ros::Time::now().toSec() - msg->header.stamp.toSec() << std::endl;
-    double elapsed_time = ros::Time::now().toSec() - start_time;
-    log_file << "Elapsed time of lidar fusion is: " << std::setprecision(15) << elapsed_time << std::endl << std::endl;
+    lidarCallback(msg, 2, 8.0, 121.0);
 }
 
 void lidar4Callback(const sensor_msgs::PointCloud2::ConstPtr &msg)
 {
-    log_file << "Timestamp of robotsensor 110: " << std::setprecision(15) << msg->header.stamp << std::endl;
-    log_file << "Start timestamp of lidar fusion is: " << ros::Time::now().toSec() << std::endl;
-    double start_time = ros::Time::now().toSec();
-    log_file << "Start delay time is: " << std::setprecision(15) << ros::Time::now().toSec() - msg->header.stamp.toSec() << std::endl;
-    lidar4.clear();
-    pcl::fromROSMsg(*msg, lidar4);
     // robotsensor lidar (IP: 192.168.2.110)
-    imageSegment.setMinAndMaxAngle(-110.0, 5.0);
-    // imageSegment.setMinAndMaxAngle(-180.0, 180.0);
-    imageSegment.setPointCloud(lidar4);
-    imageSegment.segment();
-    pcl::PointCloud<pcl::PointXYZI> filtered = imageSegment.getFilteredCloud();
-    pcl::PointCloud<pcl::PointXYZI> ground = imageSegment.getGround();
-    //lidar (IP: 192.168.2.110) --> car
-    pcl::transformPointCloud(filtered, filtered, transform_matrix_110_car);
-
-    Eigen::AngleAxisf q_v(pcl::deg2rad(90.0), Eigen::Vector3f::UnitZ());
-    Eigen::Matrix4f Rinv = Eigen::Matrix4f::Identity();
-    Rinv.block<3,3>(0,0) = q_v.matrix();
-    pcl::transformPointCloud(filtered, filtered, Rinv);
-
-    lidar.clear();
-    lidar4 = filtered;
-    lidar += lidar1;
-    lidar += lidar2;
-    lidar += lidar3;
-    lidar += lidar4;
-
-    sensor_msgs::PointCloud2 newMsg;
-    pcl::toROSMsg(lidar, newMsg);
-    newMsg.header = msg->header;
-    newMsg.header.frame_id = "velodyne";
-    pub.publish(newMsg);
-
-    log_file << "End timestamp is: " << std::setprecision(15) << ros::Time::now().toSec() << std::endl;
-    log_file << "End delay time is: " << std::setprecision(15) << ros::Time::now().toSec() - msg->header.stamp.toSec() << std::endl;
-    double elapsed_time = ros::Time::now().toSec() - start_time;
-    log_file << "Elapsed time of lidar fusion is: " << std::setprecision(15) << elapsed_time << std::endl << std::endl;
+    lidarCallback(msg, 3, -110.0, 5.0);
 }
 
 void laserCallback(const sensor_msgs::PointCloud2::ConstPtr &msg1, const sensor_msgs::PointCloud2::ConstPtr &msg2, const sensor_msgs::PointCloud2::ConstPtr &msg3, const sensor_msgs::PointCloud2::ConstPtr &msg4)
@@ -230,36 +146,20 @@ void laserCallback(const sensor_msgs::PointCloud2::ConstPtr &msg1, const sensor_
     pcl::fromROSMsg(*msg4, laser4);
 
     // velodyne lidar (IP: 192.168.2.201)
-    imageSegment.setMinAndMaxAngle(-103.0, 9.0);
-    // imageSegment.setMinAndMaxAngle(-180.0, 180.0);
-    imageSegment.setPointCloud(laser1);
-    imageSegment.segment();
-    pcl::PointCloud<pcl::PointXYZI> filtered1 = imageSegment.getFilteredCloud();
-    pcl::PointCloud<pcl::PointXYZI> ground1 = imageSegment.getGround();
+    pcl::PointCloud<pcl::PointXYZI> filtered1, ground1;
+    segmentGround(laser1, -103.0, 9.0, filtered1, &ground1);
 
     // velodyne lidar 202 (IP: 192.168.2.202)
-    imageSegment.setMinAndMaxAngle(-6.0, 104.0);
-    // imageSegment.setMinAndMaxAngle(-180.0, 180.0);
-    imageSegment.setPointCloud(laser2);
-    imageSegment.segment();
-    pcl::PointCloud<pcl::PointXYZI> filtered2 = imageSegment.getFilteredCloud();
-    pcl::PointCloud<pcl::PointXYZI> ground2 = imageSegment.getGround();
+    pcl::PointCloud<pcl::PointXYZI> filtered2, ground2;
+    segmentGround(laser2, -6.0, 104.0, filtered2, &ground2);
 
     // robotsensor lidar (IP: 192.168.2.109)
-    imageSegment.setMinAndMaxAngle(8.0, 121.0);
-    // imageSegment.setMinAndMaxAngle(-180.0, 180.0);
-    imageSegment.setPointCloud(laser3);
-    imageSegment.segment();
-    pcl::PointCloud<pcl::PointXYZI> filtered3 = imageSegment.getFilteredCloud();
-    pcl::PointCloud<pcl::PointXYZI> ground3 = imageSegment.getGround();
+    pcl::PointCloud<pcl::PointXYZI> filtered3, ground3;
+    segmentGround(laser3, 8.0, 121.0, filtered3, &ground3);
 
     // robotsensor lidar (IP: 192.168.2.110)
-    imageSegment.setMinAndMaxAngle(-110.0, 5.0);
-    // imageSegment.setMinAndMaxAngle(-180.0, 180.0);
-    imageSegment.setPointCloud(laser4);
-    imageSegment.segment();
-    pcl::PointCloud<pcl::PointXYZI> filtered4 = imageSegment.getFilteredCloud();
-    pcl::PointCloud<pcl::PointXYZI> ground4 = imageSegment.getGround();
+    pcl::PointCloud<pcl::PointXYZI> filtered4, ground4;
+    segmentGround(laser4, -110.0, 5.0, filtered4, &ground4);
 
     //lidar_201 --> lidar_202
     pcl::transformPointCloud(filtered1, filtered1, R12);
@@ -306,6 +206,8 @@ int main(int argc, char **argv)
     ros::init(argc, argv, "lidar_fusion");
     ros::NodeHandle nh;
 
+    rangeImage.setup(16, 1800);
+
     // lidar_201 --> lidar_202
     R12 << 0.993971, 0.108927, -0.0125533, -0.101221,
 	   -0.108862, 0.99404, 0.00572173, -2.48301,
@@ -330,6 +232,26 @@ int main(int argc, char **argv)
 				0.0105377, -0.0322082, 0.999426, -0.881568,
 				0, 0, 0, 1;
 
+    ros::NodeHandle private_nh("~");
+    double sync_tolerance, dropout_timeout;
+    private_nh.param("sync_tolerance", sync_tolerance, 0.05);
+    private_nh.param("dropout_timeout", dropout_timeout, 0.5);
+    private_nh.param("stats_interval", stats_interval, 100);
+    private_nh.param("merge_warn_frames", merge_warn_frames, 20);
+    stats_interval = std::max(stats_interval, 1);
+    merge_warn_frames = std::max(merge_warn_frames, 1);
+    lidarMerger.setTolerance(sync_tolerance);
+    lidarMerger.setDropoutTimeout(dropout_timeout);
+
+    Eigen::AngleAxisf q_v(pcl::deg2rad(90.0), Eigen::Vector3f::UnitZ());
+    Eigen::Matrix4f Rinv = Eigen::Matrix4f::Identity();
+    Rinv.block<3,3>(0,0) = q_v.matrix();
+    // 添加顺序与lidar_names一致
+    lidarMerger.addLidar(lidar_names[0], toAffine(Rinv * R2c * R12));
+    lidarMerger.addLidar(lidar_names[1], toAffine(Rinv * R2c));
+    lidarMerger.addLidar(lidar_names[2], toAffine(Rinv * transform_matrix_110_car * transform_matrix_109_110));
+    lidarMerger.addLidar(lidar_names[3], toAffine(Rinv * transform_matrix_110_car));
+
     //时间同步器
     // message_filters::Subscriber<sensor_msgs::PointCloud2> laser201_sub(nh, "/velodyne1/velodyne_points", 100);
     // message_filters::Subscriber<sensor_msgs::PointCloud2> laser202_sub(nh, "/velodyne2/velodyne_points", 100);
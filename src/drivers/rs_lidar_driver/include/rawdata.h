@@ -158,6 +158,17 @@ public:
   int isABPacket(int distance);
 
   void processDifop(const rslidar_msgs::rslidarPacket::ConstPtr &difop_msg);
+
+  /*ring index of channel dsr, 0 is the lowest laser*/
+  int ringOfLaser(int dsr) const
+  {
+    return RING_INDEX[dsr];
+  }
+
+  int numOfLaser() const
+  {
+    return numOfLasers;
+  }
   ros::Subscriber difop_sub_;
   bool is_init_curve_;
   bool is_init_angle_;
@@ -167,6 +178,9 @@ public:
   int intensityFactor;
 
 private:
+  /*sort channels by vertical angle, call after VERT_ANGLE changed*/
+  void updateRingIndex();
+
   float R1_;
   float R2_;
   bool angle_flag_;
@@ -179,6 +193,7 @@ private:
   bool info_print_flag_;
 
   float VERT_ANGLE[32];
+  int RING_INDEX[32];
   float HORI_ANGLE[32];
   float aIntensityCal[7][32];
   float aIntensityCal_old[1600][32];
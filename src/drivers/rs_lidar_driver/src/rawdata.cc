@@ -46,6 +46,11 @@ RawData::RawData()
   tempPacketNum     = 0;
   numOfLasers       = 16;
   TEMPERATURE_RANGE = 40;
+
+  for (int i = 0; i < 32; i++)
+  {
+    RING_INDEX[i] = i;
+  }
 }
 
 void RawData::loadConfigFile(ros::NodeHandle node)
@@ -214,6 +219,7 @@ void RawData::loadConfigFile(ros::NodeHandle node)
       HORI_ANGLE[loopn] = d[loopn] * 100;
     }
     fclose(f_angle);
+    updateRingIndex();
   }
 
   //=============================================================
@@ -298,6 +304,23 @@ void RawData::loadConfigFile(ros::NodeHandle node)
   difop_sub_ = node.subscribe(output_difop_topic_, 10, &RawData::processDifop, ( RawData * )this);
 }
 
+//按垂直角从下到上给每个通道编线号
+void RawData::updateRingIndex()
+{
+  for (int i = 0; i < numOfLasers; i++)
+  {
+    int ring = 0;
+    for (int j = 0; j < numOfLasers; j++)
+    {
+      if (VERT_ANGLE[j] < VERT_ANGLE[i] || (VERT_ANGLE[j] == VERT_ANGLE[i] && j < i))
+      {
+        ring++;
+      }
+    }
+    RING_INDEX[i] = ring;
+  }
+}
+
 void RawData::processDifop(const rslidar_msgs::rslidarPacket::ConstPtr &difop_msg)
 {
   // std::cout << "Enter difop callback!" << std::endl;
@@ -467,6 +490,7 @@ void RawData::processDifop(const rslidar_msgs::rslidarPacket::ConstPtr &difop_ms
           // TODO
           HORI_ANGLE[loopn] = 0;
         }
+        updateRingIndex();
         this->is_init_angle_ = true;
         ROS_INFO_STREAM("angle data is wrote in difop packet!");
         // std::cout << "this->is_init_angle_ = "
@@ -775,7 +799,6 @@ void RawData::unpack(const rslidar_msgs::rslidarPacket &pkt, pcl::PointCloud< pc
     return;
   }
   float azimuth; // 0.01 dgree
-  int intensity;
   // float intensity;
   float azimuth_diff;
   float azimuth_corrected_f;
@@ -885,9 +908,8 @@ void RawData::unpack(const rslidar_msgs::rslidarPacket &pkt, pcl::PointCloud< pc
           point.y = -distance2 * cos(arg_vert) * sin(arg_horiz) - R1_ * sin(arg_horiz_orginal);
           point.z = distance2 * sin(arg_vert) - R2_;
 
-          intensity       = round(pcl::rad2deg(atan2(point.z, sqrt(pow(point.x, 2) + pow(point.y, 2)))));
-          intensity       = (intensity + 15) / 2;
-          point.intensity = intensity;
+          // intensity 为线号, 按垂直角预先排好, 不再逐点 atan2
+          point.intensity = RING_INDEX[dsr];
           pointcloud->at(2 * this->block_num + firing, dsr) = point;
         }
       }
@@ -1,6 +1,7 @@
 #include <ros/ros.h>
 
 // #include "glog_helper.h"
+#include "packet_replay.h"
 #include "udp_process.h"
 #include <iostream>
 #include <sstream> //
@@ -61,7 +62,7 @@
 
 #include "rawdata.h"
 
-#include "ImageSegment_linh.h"
+#include "range_image_ground.h"
 // 20191031 运动补偿
 #include "location_interpolation.h"
 
@@ -107,6 +108,13 @@ public:
   void lidar_raw_pl2();
 
   void start();
+  //需在 Initial/start 之前调用
+  void setPacketStats(boost::shared_ptr< PacketStats > stats, bool benchmark);
+
+  //按解码布局填充距离图像: 列为发射顺序, 行为按垂直角排好的线号
+  void setRangeImage(const pcl::PointCloud< pcl::PointXYZI > &organized);
+  //运动补偿, 平移量按包内顺序(列 x 通道)排列
+  int doRangeImageCorrect(const std::vector< XYZShift > &frame_points_shift_);
 
   void recvFusionLocationCallback(const location_msgs::FusionDataInfo::ConstPtr &location_msg);
 
@@ -114,6 +122,14 @@ private:
   ros::NodeHandle nh_;
   ros::Subscriber location_sub_; // = n.subscribe("/localization/fusion_msg", 1, recvFusionLocationCallback);
 
+  boost::shared_ptr< PacketStats > stats_;
+  bool benchmark_;
+  int stage_packet_;
+  int stage_unpack_;
+  int stage_segment_;
+  int stage_cut_;
+  int stage_publish_;
+
   boost::shared_ptr< rslidar_rawdata::RawData > cut_data_;
 
   boost::shared_ptr< rslidar_rawdata::RawData > raw_data_;
@@ -130,7 +146,7 @@ private:
   int pub_raw_data_;
   int is_motion_compensation_;
 
-  ImageSegment imageSegment;
+  superg_agv::common::RangeImageGround range_image_; //线号 x 发射列 距离图像, 用于地面分割
   Eigen::Matrix4f Matrix4f_1_;
   // Eigen::Matrix4f Matrix4f_2_;
 
@@ -247,6 +263,63 @@ LidarDataProcess::LidarDataProcess(ros::NodeHandle node)
 
   last_azimuth = 0;
   isHandle     = true;
+
+  benchmark_     = false;
+  stage_packet_  = -1;
+  stage_unpack_  = -1;
+  stage_segment_ = -1;
+  stage_cut_     = -1;
+  stage_publish_ = -1;
+}
+
+void LidarDataProcess::setPacketStats(boost::shared_ptr< PacketStats > stats, bool benchmark)
+{
+  stats_         = stats;
+  benchmark_     = benchmark;
+  stage_packet_  = stats_->addStage("packet");
+  stage_unpack_  = stats_->addStage("unpack");
+  stage_segment_ = stats_->addStage("segment");
+  stage_cut_     = stats_->addStage("cut");
+  stage_publish_ = stats_->addStage("publish");
+}
+
+void LidarDataProcess::setRangeImage(const pcl::PointCloud< pcl::PointXYZI > &organized)
+{
+  int columns = ( int )organized.width;
+  range_image_.setup(( int )organized.height, columns);
+  range_image_.clear();
+  for (int dsr = 0; dsr < ( int )organized.height; dsr++)
+  {
+    int ring                     = cut_data_->ringOfLaser(dsr);
+    const pcl::PointXYZI *points = &organized.points[dsr * columns];
+    for (int col = 0; col < columns; col++)
+    {
+      //无效点解码时为 NAN
+      if (!std::isnan(points[col].x))
+      {
+        range_image_.setPoint(ring, col, points[col].x, points[col].y, points[col].z);
+      }
+    }
+  }
+}
+
+int LidarDataProcess::doRangeImageCorrect(const std::vector< XYZShift > &frame_points_shift_)
+{
+  int rings   = range_image_.rings();
+  int columns = range_image_.columns();
+  if (frame_points_shift_.size() != ( size_t )rings * columns)
+  {
+    return -1;
+  }
+  for (int col = 0; col < columns; col++)
+  {
+    for (int dsr = 0; dsr < rings; dsr++)
+    {
+      const XYZShift &shift = frame_points_shift_[col * rings + dsr];
+      range_image_.translate(cut_data_->ringOfLaser(dsr), col, shift.x, shift.y, shift.z);
+    }
+  }
+  return 1;
 }
 
 LidarDataProcess::~LidarDataProcess()
@@ -320,6 +393,7 @@ void LidarDataProcess::OnUdpProcessCallBack(unsigned char *data, int len, struct
                  ( int )syscall(__NR_gettid));
 
   //接收到76包数据后，组合成一帧数据 放入list中，如果list非空，清空list后放入，保证点云处理线程每次都处理当前最新数据
+  StageClock stage_clock(stats_.get());
   ros::Time t           = ros::Time::now();
   double bag_start_time = t.toSec();
 
@@ -409,6 +483,8 @@ void LidarDataProcess::OnUdpProcessCallBack(unsigned char *data, int len, struct
     if (isHandle)
     {
       list_cut_rslidarScan_.push_back(temp_cut_);
+      if (stats_)
+        stats_->frameQueued();
     }
     isHandle = !isHandle;
 
@@ -431,6 +507,7 @@ void LidarDataProcess::OnUdpProcessCallBack(unsigned char *data, int len, struct
     //   pthread_mutex_unlock(&list_mutex_raw);
     // }
   }
+  stage_clock.mark(stage_packet_);
 }
 
 //发布话题
@@ -446,7 +523,8 @@ void LidarDataProcess::lidar_data_cut()
   if (pub_raw_data_ == 1)
     raw_point_cloud_pub_ = nh_.advertise< sensor_msgs::PointCloud2 >(config_.raw_data_topic_.data(), 1);
 
-  ros::Rate loop_rate(100);
+  //压测时缩短轮询间隔, 避免轮询限制帧率
+  ros::Rate loop_rate(benchmark_ ? 2000 : 100);
   while (ros::ok())
   {
     loop_rate.sleep();
@@ -454,6 +532,7 @@ void LidarDataProcess::lidar_data_cut()
     {
       perception_sensor_msgs::LidarPointCloud temp_lidar_Point_set;
       std::vector< XYZShift > temp_frame_points_shift_ver_;
+      StageClock stage_clock(stats_.get());
       // begin time
       ros::Time t1 = ros::Time::now();
 
@@ -509,16 +588,15 @@ void LidarDataProcess::lidar_data_cut()
       // data->pcl:XYZIR
       ros::Time t3 = ros::Time::now();
       oss << "data->pcl:XYZIR[" << ((t3 - t2).toNSec() / 1000000.0) << "] ";
+      stage_clock.mark(stage_unpack_);
 
-      // pcl:XYZIR->pcl:XYZI
-      // imageSegment.setMinAndMaxAngle(0.0,0.0);
-      imageSegment.setPacketsSize(cut_.packets.size());
-      imageSegment.setPointCloud(*rs_cut_points);
+      // pcl:XYZIR->range image
+      setRangeImage(*rs_cut_points);
       ros::Time t4 = ros::Time::now();
-      oss << "pcl:XYZIR->pcl:XYZI[" << ((t4 - t3).toNSec() / 1000000.0) << "] ";
+      oss << "pcl:XYZIR->range image[" << ((t4 - t3).toNSec() / 1000000.0) << "] ";
 
       //转换坐标系  tf lidar1->lidar2
-      imageSegment.tf(Matrix4f_1_);
+      range_image_.transform(Matrix4f_1_);
 
       ros::Time t5 = ros::Time::now();
       oss << "tf lidar->car[" << ((t5 - t4).toNSec() / 1000000.0) << "] ";
@@ -529,7 +607,7 @@ void LidarDataProcess::lidar_data_cut()
       {
         if (cur_LocationMsg_count < LocationMsg_count)
         {
-          doLidarPointsCorrect(imageSegment.full_cloud_, temp_frame_points_shift_ver_);
+          doRangeImageCorrect(temp_frame_points_shift_ver_);
           cur_LocationMsg_count = LocationMsg_count;
         }
       }
@@ -538,14 +616,15 @@ void LidarDataProcess::lidar_data_cut()
       oss << "motion compensation[" << ((t51 - t5).toNSec() / 1000000.0) << "] ";
       //分割
 
-      imageSegment.segment();
-      pcl::PointCloud< pcl::PointXYZI > filtered = imageSegment.getFilteredCloud();
-      pcl::PointCloud< pcl::PointXYZI > ground   = imageSegment.getGround();
-      //       pcl::PointCloud< pcl::PointXYZI > ground = imageSegment.full_cloud_;
+      range_image_.label();
+      pcl::PointCloud< pcl::PointXYZI > filtered;
+      pcl::PointCloud< pcl::PointXYZI > ground;
+      range_image_.extract(&ground, &filtered);
 
       // segment
       ros::Time t6 = ros::Time::now();
       oss << "segment[" << ((t6 - t51).toNSec() / 1000000.0) << "] ";
+      stage_clock.mark(stage_segment_);
 
       //切割车体
       pcl::PointCloud< pcl::PointXYZI > car_cut;
@@ -563,6 +642,7 @@ void LidarDataProcess::lidar_data_cut()
       }
       ros::Time t7 = ros::Time::now();
       oss << "cut agv[" << ((t7 - t6).toNSec() / 1000000.0) << "] ";
+      stage_clock.mark(stage_cut_);
 
       pcl::toROSMsg(ground, temp_lidar_Point_set.point_cloud_ground);
       temp_lidar_Point_set.point_cloud_ground.header.stamp    = cut_.header.stamp;
@@ -584,7 +664,6 @@ void LidarDataProcess::lidar_data_cut()
         sensor_msgs::PointCloud2 laserMsg;
 
         pcl::toROSMsg(*rs_cut_points, laserMsg);
-        // pcl::toROSMsg(imageSegment.full_cloud_, laserMsg);
         laserMsg.header.stamp    = cut_.header.stamp;
         laserMsg.header.frame_id = cut_.header.frame_id;
 
@@ -600,6 +679,9 @@ void LidarDataProcess::lidar_data_cut()
       {
         lidar_cut_point_pub_.publish(temp_lidar_Point_set);
       }
+      stage_clock.mark(stage_publish_);
+      if (stats_)
+        stats_->frameDone();
 
       // ros::Time t9 = ros::Time::now();
       // oss << "pub obj pc2[" << ((t9 - t8).toNSec() / 1000000.0) << "] ";
@@ -780,7 +862,8 @@ int main(int argc, char *argv[])
 
   //////////////////建立difop UDP接收通道，并启动数据处理///////////////////////
 
-  boost::shared_ptr< UdpProcess > difop_udp_(new UdpProcess());
+  //实时 UDP 或按 replay_file 回放, 见 packet_replay.h
+  boost::shared_ptr< PacketSource > difop_udp_ = createPacketSource(node);
   difop_udp_->log_dir_     = log_dir_stream.str();
   difop_udp_->sensor_name_ = sensor_name_;
   difop_udp_->device_name_ = device_Name_;
@@ -795,13 +878,14 @@ int main(int argc, char *argv[])
 
   //////////////////建立UDP接收通道，并启动数据处理///////////////////////
 
-  boost::shared_ptr< UdpProcess > udp_(new UdpProcess());
+  boost::shared_ptr< PacketSource > udp_ = createPacketSource(node);
   udp_->log_dir_     = log_dir_stream.str();
   udp_->sensor_name_ = sensor_name_;
   udp_->device_name_ = device_Name_;
 
   // radar data process class
   boost::shared_ptr< LidarDataProcess > lidar_(new LidarDataProcess(node));
+  lidar_->setPacketStats(udp_->stats(), udp_->isBenchmark());
 
   if (udp_->Initial(lidar_, device_ip_, intput_port_, packet_size_) == 1)
   {
@@ -25,6 +25,7 @@
 
 #include "common_functions.h"
 #include "glog_helper.h"
+#include "packet_replay.h"
 #include "udp_process.h"
 
 #include <list>
@@ -156,9 +157,19 @@ public:
 
   void start();
 
+  //需在 Initial/start 之前调用
+  void setPacketStats(boost::shared_ptr< PacketStats > stats, bool benchmark);
+
   //  void setTanWayParams(TanWay_Device &TanWay_Device_info);
 
   list< sensor_msgs::PointCloud2 > list_ros_cloud_;
+  pthread_mutex_t list_mutex_;
+
+  boost::shared_ptr< PacketStats > stats_;
+  bool benchmark_    = false;
+  int stage_decode_  = -1;
+  int stage_frame_   = -1;
+  int stage_publish_ = -1;
 
   // pcl::PointCloud< pcl::PointXYZRGB >::Ptr point_cloud_ptr1(new pcl::PointCloud< pcl::PointXYZRGB >);
   pcl::PointCloud< pcl::PointXYZRGB >::Ptr point_cloud_clr_ptr_n1_;
@@ -178,6 +189,8 @@ TWLidarDataProcess::TWLidarDataProcess(TanWay_Device &TanWay_Device_info)
 
   point_cloud_clr_ptr_n1_.reset(new pcl::PointCloud< pcl::PointXYZRGB >);
 
+  pthread_mutex_init(&list_mutex_, NULL);
+
   if (VerticleAngle == 11)
   {
     memcpy(verticalChannels, verticalChannels11, sizeof(verticalChannels11));
@@ -187,7 +200,19 @@ TWLidarDataProcess::TWLidarDataProcess(TanWay_Device &TanWay_Device_info)
     memcpy(verticalChannels, verticalChannels26, sizeof(verticalChannels11));
   }
 }
-TWLidarDataProcess::~TWLidarDataProcess(){};
+TWLidarDataProcess::~TWLidarDataProcess()
+{
+  pthread_mutex_destroy(&list_mutex_);
+};
+
+void TWLidarDataProcess::setPacketStats(boost::shared_ptr< PacketStats > stats, bool benchmark)
+{
+  stats_         = stats;
+  benchmark_     = benchmark;
+  stage_decode_  = stats_->addStage("decode");
+  stage_frame_   = stats_->addStage("frame");
+  stage_publish_ = stats_->addStage("publish");
+}
 // void TWLidarDataProcess::getParam()
 // {
 
@@ -286,6 +311,7 @@ TWLidarDataProcess::process_XYZ(pcl::PointCloud< pcl::PointXYZRGB >::Ptr point_c
 
 void TWLidarDataProcess::OnUdpProcessCallBack(unsigned char *data, int len, struct sockaddr_in addr_)
 {
+  StageClock stage_clock(stats_.get());
 
   //计算hA
   float hA = TwoHextoFourX(data[8], data[7]) / 100.0f;
@@ -297,6 +323,7 @@ void TWLidarDataProcess::OnUdpProcessCallBack(unsigned char *data, int len, stru
     point_cloud_clr_ptr_n1_ =
         process_XYZ(point_cloud_clr_ptr_n1_, verticalChannels, data, hA, StaticQuantityFirst, Color);
   }
+  stage_clock.mark(stage_decode_);
 
   if (hA > EndAngle && needPublishCloud)
   {
@@ -331,12 +358,17 @@ void TWLidarDataProcess::OnUdpProcessCallBack(unsigned char *data, int len, stru
     {
       ros_cloud.header.stamp = ros::Time::now();
     }
+    pthread_mutex_lock(&list_mutex_);
     list_ros_cloud_.push_back(ros_cloud);
+    pthread_mutex_unlock(&list_mutex_);
+    if (stats_)
+      stats_->frameQueued();
 
     point_cloud_clr_ptr_n1_->points.clear();
 
     /* pthread_create(&pid, &pida, clearVector, &point_cloud_clr_ptr_n1_->points);*/
     needPublishCloud = false;
+    stage_clock.mark(stage_frame_);
   }
 
   if (hAPre != hA)
@@ -355,19 +387,31 @@ void TWLidarDataProcess::TW_lidar_Sender()
 
   ros::Publisher pubCloud = nh.advertise< sensor_msgs::PointCloud2 >(topic, 1);
 
-  ros::Rate loop_rate(100);
+  //压测时缩短轮询间隔, 避免轮询限制帧率
+  ros::Rate loop_rate(benchmark_ ? 2000 : 100);
   while (ros::ok())
   {
     loop_rate.sleep();
-    if (!list_ros_cloud_.empty())
+    StageClock stage_clock(stats_.get());
+    //判空与取帧在同一次加锁内, 处理线程可能同时在 push_back
+    sensor_msgs::PointCloud2 ros_cloud;
+    pthread_mutex_lock(&list_mutex_);
+    bool has_cloud = !list_ros_cloud_.empty();
+    if (has_cloud)
     {
-      sensor_msgs::PointCloud2 ros_cloud = list_ros_cloud_.front();
+      ros_cloud = list_ros_cloud_.front();
+      list_ros_cloud_.pop_front();
+    }
+    pthread_mutex_unlock(&list_mutex_);
 
+    if (has_cloud)
+    {
       pubCloud.publish(ros_cloud);
+      stage_clock.mark(stage_publish_);
+      if (stats_)
+        stats_->frameDone();
 
-      list_ros_cloud_.pop_front();
-
-    } // list_ros_cloud_.empty()
+    } // has_cloud
   }   // while (ros::ok())
 }
 void TWLidarDataProcess::start()
@@ -410,8 +454,8 @@ int main(int argc, char *argv[])
   log_dir_stream << home_path << doc["log_dir"].as< string >();
   SUPERG_INFO << "log_dir_: " << log_dir_stream.str();
 
-  // udp class
-  UdpProcess udp_[doc["device_list"].size()];
+  // udp class, 实时 UDP 或按 replay_file 回放, 见 packet_replay.h
+  boost::shared_ptr< PacketSource > udp_[doc["device_list"].size()];
 
   // radar data process class
   boost::shared_ptr< TWLidarDataProcess > lidar_[doc["device_list"].size()];
@@ -428,13 +472,15 @@ int main(int argc, char *argv[])
 
     if (TanWay_Device_.device_enable)
     {
-      udp_[i].log_dir_     = log_dir_stream.str();
-      udp_[i].sensor_name_ = doc["sensor_name"].as< string >();
-      udp_[i].device_name_ = TanWay_Device_.device_name;
+      udp_[i]               = createPacketSource(nh);
+      udp_[i]->log_dir_     = log_dir_stream.str();
+      udp_[i]->sensor_name_ = doc["sensor_name"].as< string >();
+      udp_[i]->device_name_ = TanWay_Device_.device_name;
 
       lidar_[i].reset(new TWLidarDataProcess(TanWay_Device_));
+      lidar_[i]->setPacketStats(udp_[i]->stats(), udp_[i]->isBenchmark());
 
-      if (udp_[i].Initial(lidar_[i], TanWay_Device_.device_ip, TanWay_Device_.intput_port, 205) == 1)
+      if (udp_[i]->Initial(lidar_[i], TanWay_Device_.device_ip, TanWay_Device_.intput_port, 205) == 1)
       {
         lidar_[i]->start();
       }
@@ -0,0 +1,85 @@
+#ifndef PACKET_REPLAY_H
+#define PACKET_REPLAY_H
+
+#include <ros/ros.h>
+
+#include <pthread.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "packet_source.h"
+
+struct ReplayConfig
+{
+  std::string files; //回放文件, 多个文件用逗号分隔; 支持 pcap 与 UdpData_Output 记录的 csv 日志
+  double rate;       //回放速度倍率, 1 为原始时间间隔, 0 为不等待
+  bool loop;         //回放结束后从头开始
+  bool benchmark;    //压测模式, 见 PacketSource::isBenchmark
+  int max_pending;   //压测模式下允许已组帧未处理完的帧数
+
+  ReplayConfig() : rate(1.0), loop(false), benchmark(false), max_pending(2)
+  {
+  }
+};
+
+struct ReplayPacket
+{
+  double stamp; //记录时间 s
+  unsigned char *data;
+  int len;
+  int port;          //目的端口
+  sockaddr_in addr;  //发送端地址, csv 日志中没有时为设备IP
+};
+
+//文件回放：pcap 按目的端口(及设备IP)过滤, csv 日志按记录的端口过滤, 长度与 udp_data_len 不一致的包丢弃
+//析构时停止回放线程并等待其退出
+class PacketReplay : public PacketSource
+{
+public:
+  explicit PacketReplay(const ReplayConfig &config);
+  ~PacketReplay();
+
+  int Initial(boost::shared_ptr< UdpProcessCallBack > p_DLCallBack, const std::string dev_ip, const int intput_port,
+              const int udp_data_len);
+
+  bool isBenchmark() const
+  {
+    return config_.benchmark;
+  }
+
+  void replayFiles();
+
+private:
+  int replayFile(const std::string &file_path);
+  void waitUntil(double stamp);
+  void finish();
+  bool running() const
+  {
+    return !stop_.load() && ros::ok();
+  }
+
+  ReplayConfig config_;
+  std::vector< std::string > file_list_;
+
+  boost::shared_ptr< UdpProcessCallBack > p_DLCallBack_;
+  pthread_t m_threadID;
+  bool thread_started_;
+  std::atomic< bool > stop_;
+
+  std::string devip_str_;
+  in_addr devip_;
+  int intput_port_;
+  int udp_data_size_;
+
+  bool time_started_;
+  double base_stamp_;
+  double last_stamp_;
+  uint64_t base_ns_;
+};
+
+//按参数创建数据源：replay_file 为空时为实时 UDP, 否则为文件回放
+// replay_file / replay_rate / replay_loop / benchmark / stats_period
+boost::shared_ptr< PacketSource > createPacketSource(ros::NodeHandle &node);
+
+#endif // PACKET_REPLAY_H
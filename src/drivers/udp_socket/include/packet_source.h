@@ -0,0 +1,52 @@
+#ifndef PACKET_SOURCE_H
+#define PACKET_SOURCE_H
+
+#include <netinet/in.h>
+
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+#include "packet_stats.h"
+
+class UdpProcessCallBack
+{
+  //回调类，这里自定义所有回调函数
+public:
+  virtual void OnUdpProcessCallBack(unsigned char *data_, int len_, struct sockaddr_in addr_) = 0;
+};
+
+//数据包来源：实时 UDP(UdpProcess) 或文件回放(PacketReplay)
+//Initial 成功返回 1, 之后在内部线程中按包调用回调
+class PacketSource
+{
+public:
+  PacketSource();
+  virtual ~PacketSource();
+
+  virtual int Initial(boost::shared_ptr< UdpProcessCallBack > p_DLCallBack, const std::string dev_ip,
+                      const int intput_port, const int udp_data_len) = 0;
+
+  //压测模式：回放不等待, 按帧反压, 回放结束后输出统计并退出节点
+  virtual bool isBenchmark() const
+  {
+    return false;
+  }
+
+  boost::shared_ptr< PacketStats > stats()
+  {
+    return stats_;
+  }
+
+  std::string log_dir_;
+  std::string device_name_;
+  std::string sensor_name_;
+
+  double stats_period_; //统计输出周期 s, 0 不输出
+
+protected:
+  void setStatsName(const int intput_port);
+
+  boost::shared_ptr< PacketStats > stats_;
+};
+
+#endif // PACKET_SOURCE_H
@@ -0,0 +1,77 @@
+#ifndef PACKET_STATS_H
+#define PACKET_STATS_H
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#define PACKET_STATS_STAGE_MAX 16
+
+//驱动吞吐统计：包/帧计数与各处理阶段的线程 CPU 时间
+//计数可在任意线程累加, 阶段需在处理线程启动前注册
+class PacketStats
+{
+public:
+  PacketStats();
+  ~PacketStats();
+
+  void setName(const std::string &name);
+  int addStage(const std::string &stage_name);
+
+  void addPacket(int bytes);
+  void addStageTime(int stage, uint64_t cpu_ns);
+
+  //回放压测时用于反压：已组帧待处理 / 已处理完成
+  void frameQueued();
+  void frameDone();
+  int64_t pendingFrames() const;
+
+  //输出并清零自上次输出以来的统计
+  void report();
+  //距上次输出超过 period 秒时输出, period <= 0 不输出
+  void reportEvery(double period);
+
+  static uint64_t threadCpuNs();
+  static uint64_t steadyNs();
+
+private:
+  std::string name_;
+  int stage_num_;
+  std::string stage_name_[PACKET_STATS_STAGE_MAX];
+  std::atomic< uint64_t > stage_ns_[PACKET_STATS_STAGE_MAX];
+  std::atomic< uint64_t > stage_count_[PACKET_STATS_STAGE_MAX];
+
+  std::atomic< uint64_t > packets_;
+  std::atomic< uint64_t > bytes_;
+  std::atomic< uint64_t > frames_queued_;
+  std::atomic< uint64_t > frames_done_;
+  uint64_t frames_reported_;
+
+  std::mutex report_mutex_;
+  std::atomic< uint64_t > last_report_ns_;
+};
+
+//单线程内按阶段累计 CPU 时间：每个阶段结束时调用 mark(stage)
+class StageClock
+{
+public:
+  explicit StageClock(PacketStats *stats) : stats_(stats), last_ns_(PacketStats::threadCpuNs())
+  {
+  }
+  void mark(int stage)
+  {
+    uint64_t now_ns = PacketStats::threadCpuNs();
+    if (stats_ != NULL && stage >= 0)
+    {
+      stats_->addStageTime(stage, now_ns - last_ns_);
+    }
+    last_ns_ = now_ns;
+  }
+
+private:
+  PacketStats *stats_;
+  uint64_t last_ns_;
+};
+
+#endif // PACKET_STATS_H
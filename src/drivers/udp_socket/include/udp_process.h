@@ -48,6 +48,8 @@
 
 #include "spdlog/fmt/bin_to_hex.h"
 
+#include "packet_source.h"
+
 using namespace std;
 
 // pthread_mutex_t rec_mutex;        //创建线程锁
@@ -104,14 +106,7 @@ public:
   char *shm_addr; // = ( char * )shmat(shmid, NULL, 0);
 };
 
-class UdpProcessCallBack
-{
-  //回调类，这里自定义所有回调函数
-public:
-  virtual void OnUdpProcessCallBack(unsigned char *data_, int len_, struct sockaddr_in addr_) = 0;
-};
-
-class UdpProcess
+class UdpProcess : public PacketSource
 {
 public:
   UdpProcess();
@@ -123,10 +118,6 @@ public:
   void recUdpInfo();
   void sendUdpInfo(udpSendInfo *udp_send_info_);
 
-  std::string log_dir_;
-  std::string device_name_;
-  std::string sensor_name_;
-
 private:
   int initUdp();
 
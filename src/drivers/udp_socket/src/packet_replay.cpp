@@ -0,0 +1,468 @@
+#include "packet_replay.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <fstream>
+
+#include "udp_process.h"
+
+#define PCAP_MAGIC_US 0xa1b2c3d4
+#define PCAP_MAGIC_NS 0xa1b23c4d
+#define PCAP_LINKTYPE_NULL 0
+#define PCAP_LINKTYPE_ETHERNET 1
+#define PCAP_LINKTYPE_RAW 101
+#define PCAP_LINKTYPE_LINUX_SLL 113
+#define REPLAY_BUFFER_SIZE 65536
+#define REPLAY_STOP_CHECK_NS 100000000ull //按记录间隔等待时, 每隔该时间检查一次是否停止
+
+// udp_process.cpp
+void SplitString(const string &s, vector< string > &v, const string &c);
+
+//压测模式下仍在回放的数据源个数, 全部结束后退出节点
+static std::atomic< int > g_benchmark_active(0);
+
+//回放文件读取：next 返回 false 表示文件结束
+class ReplayReader
+{
+public:
+  virtual ~ReplayReader()
+  {
+  }
+  virtual bool next(ReplayPacket &packet) = 0;
+};
+
+// pcap 文件, 只解析 IPv4 UDP 且未分片的包
+class PcapReader : public ReplayReader
+{
+public:
+  PcapReader(FILE *file) : file_(file), swapped_(false), nano_(false), link_type_(PCAP_LINKTYPE_ETHERNET)
+  {
+  }
+  ~PcapReader()
+  {
+    fclose(file_);
+  }
+
+  bool open()
+  {
+    uint32_t header[6];
+    if (fread(header, sizeof(header), 1, file_) != 1)
+    {
+      return false;
+    }
+    uint32_t magic = header[0];
+    if (magic == PCAP_MAGIC_US || magic == PCAP_MAGIC_NS)
+    {
+      swapped_ = false;
+    }
+    else if (__builtin_bswap32(magic) == PCAP_MAGIC_US || __builtin_bswap32(magic) == PCAP_MAGIC_NS)
+    {
+      swapped_ = true;
+      magic    = __builtin_bswap32(magic);
+    }
+    else
+    {
+      return false;
+    }
+    nano_      = (magic == PCAP_MAGIC_NS);
+    link_type_ = toHost(header[5]) & 0xFFFF;
+    if (link_type_ != PCAP_LINKTYPE_NULL && link_type_ != PCAP_LINKTYPE_ETHERNET && link_type_ != PCAP_LINKTYPE_RAW &&
+        link_type_ != PCAP_LINKTYPE_LINUX_SLL)
+    {
+      SPDLOG_ERROR("pcap link type {} not supported", link_type_);
+      return false;
+    }
+    return true;
+  }
+
+  bool next(ReplayPacket &packet)
+  {
+    uint32_t record[4];
+    while (fread(record, sizeof(record), 1, file_) == 1)
+    {
+      uint32_t incl_len = toHost(record[2]);
+      if (incl_len > REPLAY_BUFFER_SIZE || fread(buffer_, 1, incl_len, file_) != incl_len)
+      {
+        return false;
+      }
+      packet.stamp = toHost(record[0]) + toHost(record[1]) * (nano_ ? 1e-9 : 1e-6);
+      if (parse(incl_len, packet))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  uint32_t toHost(uint32_t value) const
+  {
+    return swapped_ ? __builtin_bswap32(value) : value;
+  }
+
+  bool parse(uint32_t len, ReplayPacket &packet)
+  {
+    uint32_t offset = 0;
+    uint16_t ether_type;
+    switch (link_type_)
+    {
+      case PCAP_LINKTYPE_ETHERNET:
+        if (len < 14)
+          return false;
+        ether_type = (buffer_[12] << 8) | buffer_[13];
+        offset     = 14;
+        if (ether_type == 0x8100 && len >= 18) // VLAN
+        {
+          ether_type = (buffer_[16] << 8) | buffer_[17];
+          offset     = 18;
+        }
+        if (ether_type != 0x0800)
+          return false;
+        break;
+      case PCAP_LINKTYPE_LINUX_SLL:
+        if (len < 16 || ((buffer_[14] << 8) | buffer_[15]) != 0x0800)
+          return false;
+        offset = 16;
+        break;
+      case PCAP_LINKTYPE_NULL:
+        offset = 4;
+        break;
+      default:
+        break;
+    }
+
+    const unsigned char *ip = buffer_ + offset;
+    if (len < offset + 20 || (ip[0] >> 4) != 4 || ip[9] != IPPROTO_UDP)
+      return false;
+    uint32_t ip_header_len = (ip[0] & 0x0F) * 4;
+    if ((((ip[6] << 8) | ip[7]) & 0x3FFF) != 0) //分片
+      return false;
+    const unsigned char *udp = ip + ip_header_len;
+    uint32_t udp_offset      = offset + ip_header_len;
+    if (len < udp_offset + 8)
+      return false;
+    uint32_t udp_len = (udp[4] << 8) | udp[5];
+    if (udp_len < 8 || len < udp_offset + udp_len)
+      return false;
+
+    memset(&packet.addr, 0, sizeof(packet.addr));
+    packet.addr.sin_family = AF_INET;
+    memcpy(&packet.addr.sin_addr.s_addr, ip + 12, 4);
+    memcpy(&packet.addr.sin_port, udp, 2);
+    packet.port = (udp[2] << 8) | udp[3];
+    packet.data = buffer_ + udp_offset + 8;
+    packet.len  = udp_len - 8;
+    return true;
+  }
+
+  FILE *file_;
+  bool swapped_;
+  bool nano_;
+  uint32_t link_type_;
+  unsigned char buffer_[REPLAY_BUFFER_SIZE];
+};
+
+// UdpData_Output 记录的日志：时间,传感器-设备-端口,十六进制数据
+class CsvLogReader : public ReplayReader
+{
+public:
+  CsvLogReader(const std::string &file_path, const in_addr &devip) : file_(file_path.c_str()), last_sec_(0)
+  {
+    memset(&addr_, 0, sizeof(addr_));
+    addr_.sin_family = AF_INET;
+    addr_.sin_addr   = devip;
+  }
+
+  bool isOpen() const
+  {
+    return file_.is_open();
+  }
+
+  bool next(ReplayPacket &packet)
+  {
+    while (std::getline(file_, line_))
+    {
+      // 2019-10-31-12:34:56.789,rslidar-lidar1-2370,FFEE...
+      std::string::size_type pos1 = line_.find(',');
+      std::string::size_type pos2 = line_.find(',', pos1 + 1);
+      if (pos1 == std::string::npos || pos2 == std::string::npos || pos1 < 23)
+        continue;
+      std::string::size_type port_pos = line_.rfind('-', pos2);
+      if (port_pos == std::string::npos || port_pos < pos1)
+        continue;
+
+      //同一秒内只做一次 mktime
+      if (line_.compare(0, 19, last_sec_str_) != 0)
+      {
+        struct tm tm_info;
+        memset(&tm_info, 0, sizeof(tm_info));
+        if (sscanf(line_.c_str(), "%d-%d-%d-%d:%d:%d", &tm_info.tm_year, &tm_info.tm_mon, &tm_info.tm_mday,
+                   &tm_info.tm_hour, &tm_info.tm_min, &tm_info.tm_sec) != 6)
+          continue;
+        tm_info.tm_year -= 1900;
+        tm_info.tm_mon -= 1;
+        tm_info.tm_isdst = -1;
+        last_sec_        = mktime(&tm_info);
+        last_sec_str_    = line_.substr(0, 19);
+      }
+      packet.stamp = last_sec_ + atoi(line_.c_str() + 20) / 1000.0;
+      packet.port  = atoi(line_.c_str() + port_pos + 1);
+
+      int len = 0;
+      for (std::string::size_type i = pos2 + 1; i + 1 < line_.size() && len < REPLAY_BUFFER_SIZE; i += 2)
+      {
+        int high = hexValue(line_[i]);
+        int low  = hexValue(line_[i + 1]);
+        if (high < 0 || low < 0)
+          break;
+        buffer_[len++] = (high << 4) | low;
+      }
+      packet.data = buffer_;
+      packet.len  = len;
+      packet.addr = addr_;
+      return true;
+    }
+    return false;
+  }
+
+private:
+  static int hexValue(char c)
+  {
+    if (c >= '0' && c <= '9')
+      return c - '0';
+    if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+    return -1;
+  }
+
+  std::ifstream file_;
+  std::string line_;
+  std::string last_sec_str_;
+  time_t last_sec_;
+  sockaddr_in addr_;
+  unsigned char buffer_[REPLAY_BUFFER_SIZE];
+};
+
+static void *thread_ReplayProcess(void *arg)
+{
+  PacketReplay *pReplay = ( PacketReplay * )arg;
+  pReplay->replayFiles();
+  pthread_exit(( void * )0);
+  return 0;
+}
+
+PacketReplay::PacketReplay(const ReplayConfig &config) : config_(config), thread_started_(false), stop_(false)
+{
+  SplitString(config_.files, file_list_, ",");
+  if (config_.benchmark)
+  {
+    config_.rate = 0.0;
+    config_.loop = false;
+  }
+  time_started_ = false;
+  base_stamp_   = 0.0;
+  last_stamp_   = 0.0;
+  base_ns_      = 0;
+  memset(&devip_, 0, sizeof(devip_));
+}
+
+PacketReplay::~PacketReplay()
+{
+  //回放线程使用本对象, 先让其退出再释放
+  stop_.store(true);
+  if (thread_started_)
+  {
+    pthread_join(m_threadID, NULL);
+  }
+}
+
+int PacketReplay::Initial(boost::shared_ptr< UdpProcessCallBack > p_DLCallBack, const std::string dev_ip,
+                          const int intput_port, const int udp_data_len)
+{
+  SPDLOG_DEBUG("PacketReplay::Initial: dev_ip:{} port {} files {}", dev_ip.c_str(), intput_port, config_.files);
+
+  p_DLCallBack_  = p_DLCallBack;
+  devip_str_     = dev_ip;
+  intput_port_   = intput_port;
+  udp_data_size_ = udp_data_len;
+  if (!devip_str_.empty())
+  {
+    inet_aton(devip_str_.c_str(), &devip_);
+  }
+  setStatsName(intput_port);
+
+  if (file_list_.empty())
+  {
+    SPDLOG_ERROR("replay file is empty!");
+    return 0;
+  }
+  if (config_.benchmark)
+  {
+    g_benchmark_active++;
+  }
+  if (pthread_create(&m_threadID, NULL, thread_ReplayProcess, ( void * )this) != 0)
+  {
+    SPDLOG_ERROR("create thread of ReplayProcess failed!");
+    return -1;
+  }
+  thread_started_ = true;
+  return 1;
+}
+
+void PacketReplay::replayFiles()
+{
+  do
+  {
+    int count = 0;
+    for (size_t i = 0; i < file_list_.size() && running(); i++)
+    {
+      count += replayFile(file_list_[i]);
+    }
+    if (count == 0)
+    {
+      SPDLOG_ERROR("no packet of port {} in replay files", intput_port_);
+      break;
+    }
+    SPDLOG_INFO("port {} replayed {} packets", intput_port_, count);
+  } while (config_.loop && running());
+  finish();
+}
+
+int PacketReplay::replayFile(const std::string &file_path)
+{
+  boost::shared_ptr< ReplayReader > reader;
+  FILE *file = fopen(file_path.c_str(), "rb");
+  if (file == NULL)
+  {
+    SPDLOG_ERROR("open replay file {} failed", file_path);
+    return 0;
+  }
+  PcapReader *pcap_reader = new PcapReader(file);
+  reader.reset(pcap_reader);
+  if (!pcap_reader->open())
+  {
+    CsvLogReader *csv_reader = new CsvLogReader(file_path, devip_);
+    reader.reset(csv_reader);
+    if (!csv_reader->isOpen())
+    {
+      SPDLOG_ERROR("open replay file {} failed", file_path);
+      return 0;
+    }
+  }
+
+  int count = 0;
+  ReplayPacket packet;
+  while (running() && reader->next(packet))
+  {
+    if (packet.port != intput_port_ || packet.len != udp_data_size_)
+    {
+      continue;
+    }
+    if (!devip_str_.empty() && packet.addr.sin_addr.s_addr != devip_.s_addr)
+    {
+      continue;
+    }
+
+    if (config_.benchmark)
+    {
+      //处理线程跟不上时等待, 保证每一帧都走完整条处理链
+      while (stats_->pendingFrames() >= config_.max_pending && running())
+      {
+        usleep(100);
+      }
+    }
+    else if (config_.rate > 0.0)
+    {
+      waitUntil(packet.stamp);
+    }
+
+    stats_->addPacket(packet.len);
+    p_DLCallBack_->OnUdpProcessCallBack(packet.data, packet.len, packet.addr);
+    stats_->reportEvery(stats_period_);
+    count++;
+  }
+  return count;
+}
+
+//按记录时间间隔 / rate 等待; 时间倒退(文件循环或多文件)时重新对齐
+void PacketReplay::waitUntil(double stamp)
+{
+  if (!time_started_ || stamp < last_stamp_)
+  {
+    time_started_ = true;
+    base_stamp_   = stamp;
+    base_ns_      = PacketStats::steadyNs();
+  }
+  last_stamp_ = stamp;
+
+  uint64_t target_ns = base_ns_ + ( uint64_t )((stamp - base_stamp_) / config_.rate * 1e9);
+  //分段休眠, 记录间隔很长时析构也不必等完
+  while (running())
+  {
+    uint64_t now_ns = PacketStats::steadyNs();
+    if (now_ns >= target_ns)
+    {
+      break;
+    }
+    uint64_t wake_ns = target_ns - now_ns > REPLAY_STOP_CHECK_NS ? now_ns + REPLAY_STOP_CHECK_NS : target_ns;
+    struct timespec ts;
+    ts.tv_sec  = wake_ns / 1000000000ull;
+    ts.tv_nsec = wake_ns % 1000000000ull;
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+  }
+}
+
+void PacketReplay::finish()
+{
+  SPDLOG_INFO("port {} replay finished", intput_port_);
+  if (!config_.benchmark)
+  {
+    return;
+  }
+  //等待最后的帧处理完成
+  uint64_t wait_start_ns = PacketStats::steadyNs();
+  while (stats_->pendingFrames() > 0 && PacketStats::steadyNs() - wait_start_ns < 10000000000ull && running())
+  {
+    usleep(1000);
+  }
+  stats_->report();
+  if (--g_benchmark_active == 0)
+  {
+    SPDLOG_INFO("benchmark finished");
+    ros::shutdown();
+  }
+}
+
+boost::shared_ptr< PacketSource > createPacketSource(ros::NodeHandle &node)
+{
+  ReplayConfig config;
+  node.param("replay_file", config.files, std::string(""));
+  node.param("replay_rate", config.rate, 1.0);
+  node.param("replay_loop", config.loop, false);
+  node.param("benchmark", config.benchmark, false);
+  node.param("benchmark_max_pending", config.max_pending, 2);
+
+  boost::shared_ptr< PacketSource > source;
+  if (config.files.empty())
+  {
+    if (config.benchmark)
+    {
+      SPDLOG_ERROR("benchmark needs replay_file, use live udp");
+    }
+    source.reset(new UdpProcess());
+  }
+  else
+  {
+    source.reset(new PacketReplay(config));
+  }
+  node.param("stats_period", source->stats_period_, config.benchmark ? 1.0 : 0.0);
+  return source;
+}
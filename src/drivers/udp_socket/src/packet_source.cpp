@@ -0,0 +1,14 @@
+#include "packet_source.h"
+
+PacketSource::PacketSource() : stats_period_(0.0), stats_(new PacketStats())
+{
+}
+
+PacketSource::~PacketSource()
+{
+}
+
+void PacketSource::setStatsName(const int intput_port)
+{
+  stats_->setName(sensor_name_ + "-" + device_name_ + "-" + std::to_string(intput_port));
+}
@@ -0,0 +1,129 @@
+#include "packet_stats.h"
+
+#include <time.h>
+#include <sstream>
+
+#include "spdlog/spdlog.h"
+
+PacketStats::PacketStats()
+    : stage_num_(0), packets_(0), bytes_(0), frames_queued_(0), frames_done_(0), frames_reported_(0),
+      last_report_ns_(steadyNs())
+{
+  for (int i = 0; i < PACKET_STATS_STAGE_MAX; i++)
+  {
+    stage_ns_[i]    = 0;
+    stage_count_[i] = 0;
+  }
+}
+
+PacketStats::~PacketStats()
+{
+}
+
+void PacketStats::setName(const std::string &name)
+{
+  name_ = name;
+}
+
+int PacketStats::addStage(const std::string &stage_name)
+{
+  for (int i = 0; i < stage_num_; i++)
+  {
+    if (stage_name_[i] == stage_name)
+    {
+      return i;
+    }
+  }
+  if (stage_num_ >= PACKET_STATS_STAGE_MAX)
+  {
+    return -1;
+  }
+  stage_name_[stage_num_] = stage_name;
+  return stage_num_++;
+}
+
+void PacketStats::addPacket(int bytes)
+{
+  packets_.fetch_add(1, std::memory_order_relaxed);
+  bytes_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void PacketStats::addStageTime(int stage, uint64_t cpu_ns)
+{
+  if (stage < 0 || stage >= stage_num_)
+  {
+    return;
+  }
+  stage_ns_[stage].fetch_add(cpu_ns, std::memory_order_relaxed);
+  stage_count_[stage].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PacketStats::frameQueued()
+{
+  frames_queued_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PacketStats::frameDone()
+{
+  frames_done_.fetch_add(1, std::memory_order_release);
+}
+
+int64_t PacketStats::pendingFrames() const
+{
+  return ( int64_t )(frames_queued_.load(std::memory_order_relaxed) - frames_done_.load(std::memory_order_acquire));
+}
+
+void PacketStats::report()
+{
+  std::lock_guard< std::mutex > lock(report_mutex_);
+  uint64_t now_ns = steadyNs();
+  double elapsed  = (now_ns - last_report_ns_.load()) / 1e9;
+  last_report_ns_ = now_ns;
+  if (elapsed <= 0.0)
+  {
+    return;
+  }
+
+  uint64_t packets     = packets_.exchange(0);
+  uint64_t bytes       = bytes_.exchange(0);
+  uint64_t frames_done = frames_done_.load();
+  uint64_t frames      = frames_done - frames_reported_;
+  frames_reported_     = frames_done;
+
+  std::ostringstream oss;
+  oss.setf(std::ios::fixed);
+  oss.precision(2);
+  oss << '[' << name_ << "] " << elapsed << "s packets " << packets << " (" << packets / elapsed << "/s, "
+      << bytes * 8 / elapsed / 1e6 << " Mbit/s) frames " << frames << " (" << frames / elapsed << "/s)";
+  //各阶段：平均每次 CPU 时间 us, 次数, 占单核百分比
+  for (int i = 0; i < stage_num_; i++)
+  {
+    uint64_t stage_ns    = stage_ns_[i].exchange(0);
+    uint64_t stage_count = stage_count_[i].exchange(0);
+    oss << " | " << stage_name_[i] << ' ' << (stage_count ? stage_ns / 1e3 / stage_count : 0.0) << "us x"
+        << stage_count << ' ' << stage_ns / 1e7 / elapsed << "%cpu";
+  }
+  SPDLOG_INFO("{}", oss.str());
+}
+
+void PacketStats::reportEvery(double period)
+{
+  if (period > 0.0 && steadyNs() - last_report_ns_.load(std::memory_order_relaxed) >= period * 1e9)
+  {
+    report();
+  }
+}
+
+uint64_t PacketStats::threadCpuNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ( uint64_t )ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+uint64_t PacketStats::steadyNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ( uint64_t )ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
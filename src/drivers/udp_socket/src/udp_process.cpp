@@ -309,6 +309,7 @@ int UdpProcess::Initial(boost::shared_ptr< UdpProcessCallBack > p_DLCallBack, co
   SPDLOG_DEBUG("IP address: {}", devip_str_.c_str());
 
   udplog_.reset(new UdpData_Output(log_dir_, sensor_name_, device_name_, dev_ip, intput_port));
+  setStatsName(intput_port);
 
   isOpen_ = initUdp();
 
@@ -411,11 +412,13 @@ void UdpProcess::recUdpInfo()
       }
       else
       {
+        stats_->addPacket(nbytes);
         udplog_->write_log(&rebuf[0], nbytes);
         // pthread_mutex_lock(&rec_mutex);
         // m_DLCallBack->OnUdpProcessCallBack(rebuf, udp_data_size_, sender_address);
         p_DLCallBack_->OnUdpProcessCallBack(rebuf, udp_data_size_, sender_address);
         // pthread_mutex_unlock(&rec_mutex);
+        stats_->reportEvery(stats_period_);
       }
     } // if (nbytes == udp_data_size_)
   }   // while end
@@ -1,6 +1,7 @@
 #ifndef __POINTCLOUDXYZIR_H
 #define __POINTCLOUDXYZIR_H
 
+#include "range_image_ground.h"
 #include "rawdata.h"
 #include <sensor_msgs/PointCloud2.h>
 
@@ -10,7 +11,9 @@ class PointcloudXYZIR : public velodyne_driver::DataContainerBase
 {
 public:
   velodyne_driver::VPointCloud pc;
-  PointcloudXYZIR()
+  //非空时解码的同时按 线号 x 方位角 填入距离图像
+  superg_agv::common::RangeImageGround *image;
+  PointcloudXYZIR() : image(NULL)
   {
   }
 
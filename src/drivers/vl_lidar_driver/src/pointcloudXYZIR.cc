@@ -3,7 +3,7 @@
 namespace velodyne_driver
 {
 void PointcloudXYZIR::addPoint(const float &x, const float &y, const float &z, const uint16_t &ring,
-                               const uint16_t & /*azimuth*/, const float & /*distance*/, const float &intensity)
+                               const uint16_t &azimuth, const float & /*distance*/, const float &intensity)
 {
   velodyne_driver::VPoint point;
   point.ring      = ring;
@@ -15,5 +15,10 @@ void PointcloudXYZIR::addPoint(const float &x, const float &y, const float &z, c
   // std::cout << point.ring << std::endl;
   pc.points.push_back(point);
   ++pc.width;
+
+  if (image != NULL)
+  {
+    image->setPoint(ring, image->column(azimuth), x, y, z);
+  }
 }
 }
@@ -481,8 +481,8 @@ double RawData::unpack_vlp16(const velodyne_msgs::VelodynePacket &pkt, DataConta
           float y_coord = -x;
           float z_coord = z;
 
-          intensity = round(pcl::rad2deg(atan2(z_coord, sqrt(pow(x_coord, 2) + pow(y_coord, 2)))));
-          intensity = (intensity + 15) / 2;
+          // intensity 为线号, 标定文件中已按垂直角排序, 不再逐点 atan2
+          intensity = corrections.laser_ring;
 
           /** Intensity Calculation */
           // float min_intensity = corrections.min_intensity;
@@ -1,6 +1,7 @@
 #include <ros/ros.h>
 
 // #include "glog_helper.h"
+#include "packet_replay.h"
 #include "udp_process.h"
 #include <iostream>
 #include <sstream> //
@@ -60,7 +61,7 @@
 #include <sensor_msgs/PointCloud2.h>
 #include <velodyne_msgs/VelodyneScan.h>
 
-#include "ImageSegment_linh.h"
+#include "range_image_ground.h"
 
 using namespace std;
 using namespace boost;
@@ -99,6 +100,8 @@ public:
   void lidar_raw_pl2();
 
   void start();
+  //需在 Initial/start 之前调用
+  void setPacketStats(boost::shared_ptr< PacketStats > stats, bool benchmark);
 
   void recvFusionLocationCallback(const location_msgs::FusionDataInfo::ConstPtr &location_msg);
 
@@ -106,6 +109,14 @@ private:
   ros::NodeHandle nh_;
   ros::Subscriber location_sub_; // = n.subscribe("/localization/fusion_msg", 1, recvFusionLocationCallback);
 
+  boost::shared_ptr< PacketStats > stats_;
+  bool benchmark_;
+  int stage_packet_;
+  int stage_unpack_;
+  int stage_segment_;
+  int stage_cut_;
+  int stage_publish_;
+
   boost::shared_ptr< velodyne_driver::RawData > raw_data_;
 
   list< velodyne_msgs::VelodyneScan > list_raw_VelodyneScan_;
@@ -120,7 +131,7 @@ private:
   // int t1;
   int pub_raw_data_;
 
-  ImageSegment imageSegment;
+  superg_agv::common::RangeImageGround range_image_; //线号 x 方位角 距离图像, 用于地面分割
   Eigen::Matrix4f Matrix4f_1_;
   Eigen::Matrix4f Matrix4f_2_;
 
@@ -209,6 +220,24 @@ LidarDataProcess::LidarDataProcess(ros::NodeHandle node) : nh_(node), raw_data_(
   // ttt = 0;
   // t1  = 0;
   isHandle = true;
+
+  benchmark_     = false;
+  stage_packet_  = -1;
+  stage_unpack_  = -1;
+  stage_segment_ = -1;
+  stage_cut_     = -1;
+  stage_publish_ = -1;
+}
+
+void LidarDataProcess::setPacketStats(boost::shared_ptr< PacketStats > stats, bool benchmark)
+{
+  stats_         = stats;
+  benchmark_     = benchmark;
+  stage_packet_  = stats_->addStage("packet");
+  stage_unpack_  = stats_->addStage("unpack");
+  stage_segment_ = stats_->addStage("segment");
+  stage_cut_     = stats_->addStage("cut");
+  stage_publish_ = stats_->addStage("publish");
 }
 
 LidarDataProcess::~LidarDataProcess()
@@ -226,6 +255,7 @@ void LidarDataProcess::OnUdpProcessCallBack(unsigned char *data, int len, struct
 {
   // SPDLOG_DEBUG("OnUdpProcessCallBack thread=[{}]", pthread_self());
   //接收到76包数据后，组合成一帧数据 放入list中，如果list非空，清空list后放入，保证点云处理线程每次都处理当前最新数据
+  StageClock stage_clock(stats_.get());
   velodyne_msgs::VelodynePacket tmp_packet;
 
   tmp_packet.stamp = ros::Time::now();
@@ -300,6 +330,8 @@ void LidarDataProcess::OnUdpProcessCallBack(unsigned char *data, int len, struct
     {
 
       list_cut_VelodyneScan_.push_back(temp_cut_);
+      if (stats_)
+        stats_->frameQueued();
     }
     isHandle = !isHandle;
 
@@ -320,6 +352,7 @@ void LidarDataProcess::OnUdpProcessCallBack(unsigned char *data, int len, struct
     //   pthread_mutex_unlock(&list_mutex_raw);
     // }
   }
+  stage_clock.mark(stage_packet_);
 }
 
 //发布话题
@@ -335,13 +368,15 @@ void LidarDataProcess::lidar_data_cut()
   if (pub_raw_data_ == 1)
     raw_point_cloud_pub_ = nh_.advertise< sensor_msgs::PointCloud2 >(config_.raw_data_topic_.data(), 1);
 
-  ros::Rate loop_rate(100);
+  //压测时缩短轮询间隔, 避免轮询限制帧率
+  ros::Rate loop_rate(benchmark_ ? 2000 : 100);
   while (ros::ok())
   {
     loop_rate.sleep();
     if (!list_cut_VelodyneScan_.empty())
     {
       perception_sensor_msgs::LidarPointCloud temp_lidar_Point_set;
+      StageClock stage_clock(stats_.get());
       // begin time
       ros::Time t1 = ros::Time::now();
 
@@ -373,6 +408,11 @@ void LidarDataProcess::lidar_data_cut()
       velodyne_pl_cut.pc.header.frame_id = cut_.header.frame_id;
       velodyne_pl_cut.pc.height          = 1;
 
+      //解码时直接按 线号 x 方位角 填入距离图像, 每包 24 列
+      range_image_.setup(16, 24 * ( int )cut_.packets.size());
+      range_image_.clear();
+      velodyne_pl_cut.image = &range_image_;
+
       // double timestamp = 0;
       for (size_t i = 0; i < cut_.packets.size(); ++i)
       {
@@ -400,27 +440,22 @@ void LidarDataProcess::lidar_data_cut()
       // data->pcl:XYZIR
       ros::Time t3 = ros::Time::now();
       oss << "data->pcl:XYZIR[" << ((t3 - t2).toNSec() / 1000000.0) << "] ";
-
-      // pcl:XYZIR->pcl:XYZI
-      // imageSegment.setMinAndMaxAngle(0.0,0.0);
-      imageSegment.setPacketsSize(cut_.packets.size());
-      imageSegment.setPointCloud(velodyne_pl_cut.pc);
-      ros::Time t4 = ros::Time::now();
-      oss << "pcl:XYZIR->pcl:XYZI[" << ((t4 - t3).toNSec() / 1000000.0) << "] ";
+      stage_clock.mark(stage_unpack_);
 
       //转换坐标系  tf lidar2->car
-      imageSegment.tf(Matrix4f_1_);
+      range_image_.transform(Matrix4f_1_);
       ros::Time t5 = ros::Time::now();
-      oss << "tf lidar->car[" << ((t5 - t4).toNSec() / 1000000.0) << "] ";
+      oss << "tf lidar->car[" << ((t5 - t3).toNSec() / 1000000.0) << "] ";
 
       //分割
-      // imageSegment.setPointCloud(new_pcl_);
-      imageSegment.segment();
-      pcl::PointCloud< pcl::PointXYZI > filtered = imageSegment.getFilteredCloud();
-      pcl::PointCloud< pcl::PointXYZI > ground   = imageSegment.getGround();
+      range_image_.label();
+      pcl::PointCloud< pcl::PointXYZI > filtered;
+      pcl::PointCloud< pcl::PointXYZI > ground;
+      range_image_.extract(&ground, &filtered);
 
       ros::Time t6 = ros::Time::now();
       oss << "segment[" << ((t6 - t5).toNSec() / 1000000.0) << "] ";
+      stage_clock.mark(stage_segment_);
 
       //切割车体
       pcl::PointCloud< pcl::PointXYZI > car_cut;
@@ -436,6 +471,7 @@ void LidarDataProcess::lidar_data_cut()
       }
       ros::Time t7 = ros::Time::now();
       oss << "cut agv[" << ((t7 - t6).toNSec() / 1000000.0) << "] ";
+      stage_clock.mark(stage_cut_);
       // sensor_msgs::PointCloud2 laserMsg;
 
       pcl::toROSMsg(ground, temp_lidar_Point_set.point_cloud_ground);
@@ -463,6 +499,9 @@ void LidarDataProcess::lidar_data_cut()
       }
       ros::Time t9 = ros::Time::now();
       oss << "pub obj pc2[" << ((t9 - t8).toNSec() / 1000000.0) << "] ";
+      stage_clock.mark(stage_publish_);
+      if (stats_)
+        stats_->frameDone();
 
       ///////////////raw pc2
       if (pub_raw_data_ == 1)
@@ -598,13 +637,15 @@ int main(int argc, char *argv[])
 
   //////////////////建立UDP接收通道，并启动数据处理///////////////////////
 
-  boost::shared_ptr< UdpProcess > udp_(new UdpProcess());
+  //实时 UDP 或按 replay_file 回放, 见 packet_replay.h
+  boost::shared_ptr< PacketSource > udp_ = createPacketSource(node);
   udp_->log_dir_     = log_dir_stream.str();
   udp_->sensor_name_ = sensor_name_;
   udp_->device_name_ = device_Name_;
 
   // radar data process class
   boost::shared_ptr< LidarDataProcess > lidar_(new LidarDataProcess(node));
+  lidar_->setPacketStats(udp_->stats(), udp_->isBenchmark());
 
   if (udp_->Initial(lidar_, device_ip_, intput_port_, packet_size_) == 1)
   {
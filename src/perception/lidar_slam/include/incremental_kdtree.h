@@ -0,0 +1,470 @@
+#ifndef _INCREMENTAL_KDTREE_H_
+#define _INCREMENTAL_KDTREE_H_
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cfloat>
+#include <vector>
+
+// 增量k-d树,用于scan-to-map匹配的局部地图
+// 1. 插入: 沿树下降插入叶子,同时更新子树大小和包围盒;插入时按最小间距去重,代替对整个地图重复体素滤波
+// 2. 删除: 按包围盒删除离开局部窗口的点,整棵子树落在删除盒内时只打标记
+// 3. 惰性重平衡: 子树左右规模失衡或已删除点比例过高时才重建该子树
+// PointT需要有x,y,z成员
+template <typename PointT>
+class IncrementalKdTree
+{
+public:
+  struct Box
+  {
+    float min[3];
+    float max[3];
+  };
+
+  IncrementalKdTree(float balanceRatio = 0.7, float deleteRatio = 0.5, int minRebuildSize = 16)
+    : root(NULL), balanceRatio(balanceRatio), deleteRatio(deleteRatio), minRebuildSize(minRebuildSize), rebuildCount(0)
+  {
+  }
+
+  ~IncrementalKdTree()
+  {
+    clear();
+  }
+
+  void clear()
+  {
+    freeTree(root);
+    root = NULL;
+  }
+
+  // 用一组点重建整棵树
+  template <typename Container>
+  void build(const Container& points)
+  {
+    clear();
+    nodeBuffer.clear();
+    for (size_t i = 0; i < points.size(); ++i)
+      nodeBuffer.push_back(newNode(points[i]));
+    root = buildTree(0, (int)nodeBuffer.size());
+  }
+
+  // 插入一组点,与已有点距离小于minDist的点不插入,返回插入点数
+  template <typename Container>
+  int addPoints(const Container& points, float minDist)
+  {
+    int added = 0;
+    float minSqDist = minDist * minDist;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      if (minSqDist > 0 && root != NULL && root->size > root->invalid)
+      {
+        const Node* nearest = NULL;
+        float sqDist = minSqDist;
+        nearestOne(root, points[i], nearest, sqDist);
+        if (nearest != NULL)
+          continue;
+      }
+      addPoint(points[i]);
+      ++added;
+    }
+    return added;
+  }
+
+  void addPoint(const PointT& point)
+  {
+    Node* node = newNode(point);
+    // 下降过程中更新子树统计,记录路径用于回溯查找失衡节点
+    insertPath.clear();
+    Node** link = &root;
+    while (*link != NULL)
+    {
+      Node* cur = *link;
+      if (cur->treeDeleted)
+      {
+        // 整棵已删除的子树直接释放,新点放在这里
+        for (size_t i = 0; i < insertPath.size(); ++i)
+        {
+          (*insertPath[i])->size -= cur->size;
+          (*insertPath[i])->invalid -= cur->invalid;
+        }
+        freeTree(cur);
+        *link = NULL;
+        break;
+      }
+      insertPath.push_back(link);
+      cur->size++;
+      expandBox(cur, point);
+      link = coord(point, cur->axis) < coord(cur->point, cur->axis) ? &cur->left : &cur->right;
+    }
+    *link = node;
+    // 只重建最上层的失衡子树
+    for (size_t i = 0; i < insertPath.size(); ++i)
+    {
+      if (needRebuild(*insertPath[i]))
+      {
+        *insertPath[i] = rebuild(*insertPath[i]);
+        break;
+      }
+    }
+  }
+
+  // 删除包围盒内的点(惰性标记),返回删除点数
+  int deleteBox(const Box& box)
+  {
+    int deleted = 0;
+    root = deleteBox(root, box, deleted);
+    return deleted;
+  }
+
+  // 删除包围盒外的点,按最多6个半空间盒分别删除
+  int deleteOutsideBox(const Box& box)
+  {
+    int deleted = 0;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      Box side;
+      for (int j = 0; j < 3; ++j)
+      {
+        side.min[j] = -FLT_MAX;
+        side.max[j] = FLT_MAX;
+      }
+      side.max[axis] = box.min[axis];
+      deleted += deleteBox(side);
+      side.max[axis] = FLT_MAX;
+      side.min[axis] = box.max[axis];
+      deleted += deleteBox(side);
+    }
+    return deleted;
+  }
+
+  // k近邻搜索,结果按距离从近到远排列,返回找到的点数
+  // 结果直接写入调用者的缓冲区,缓冲区复用时查询过程不分配内存
+  // 只读查询,树不被修改时可多线程同时调用
+  template <typename Container>
+  int nearestKSearch(const PointT& point, int k, Container& neighbors, std::vector<float>& sqDists) const
+  {
+    neighbors.clear();
+    sqDists.clear();
+    if (k > 0)
+      knnSearch(root, point, k, neighbors, sqDists);
+    return (int)neighbors.size();
+  }
+
+  // 有效点数
+  int size() const
+  {
+    return root == NULL ? 0 : root->size - root->invalid;
+  }
+
+  // 子树重建次数,用于统计
+  int rebuilds() const
+  {
+    return rebuildCount;
+  }
+
+  // 取出全部有效点
+  template <typename Container>
+  void getPoints(Container& points) const
+  {
+    points.clear();
+    collectPoints(root, points);
+  }
+
+private:
+  struct Node
+  {
+    PointT point;
+    Node* left;
+    Node* right;
+    int axis;
+    int size;           // 子树点数(含已删除点)
+    int invalid;        // 子树中已删除点数
+    bool deleted;       // 本节点已删除
+    bool treeDeleted;   // 整棵子树已删除
+    float boxMin[3];
+    float boxMax[3];
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  static float coord(const PointT& p, int axis)
+  {
+    return axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+  }
+
+  Node* newNode(const PointT& point)
+  {
+    Node* node = new Node;
+    node->point = point;
+    node->left = NULL;
+    node->right = NULL;
+    node->axis = 0;
+    node->size = 1;
+    node->invalid = 0;
+    node->deleted = false;
+    node->treeDeleted = false;
+    for (int j = 0; j < 3; ++j)
+      node->boxMin[j] = node->boxMax[j] = coord(point, j);
+    return node;
+  }
+
+  static void expandBox(Node* node, const PointT& point)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      float v = coord(point, j);
+      node->boxMin[j] = std::min(node->boxMin[j], v);
+      node->boxMax[j] = std::max(node->boxMax[j], v);
+    }
+  }
+
+  static void freeTree(Node* node)
+  {
+    if (node == NULL)
+      return;
+    freeTree(node->left);
+    freeTree(node->right);
+    delete node;
+  }
+
+  bool needRebuild(const Node* node) const
+  {
+    if (node->size < minRebuildSize)
+      return false;
+    int leftSize = node->left == NULL ? 0 : node->left->size;
+    int rightSize = node->right == NULL ? 0 : node->right->size;
+    if (std::max(leftSize, rightSize) > balanceRatio * (node->size - 1))
+      return true;
+    return node->invalid > deleteRatio * node->size;
+  }
+
+  // 收集子树中的有效节点,释放已删除节点
+  void flattenTree(Node* node, std::vector<Node*>& nodes)
+  {
+    if (node == NULL)
+      return;
+    if (node->treeDeleted)
+    {
+      freeTree(node);
+      return;
+    }
+    flattenTree(node->left, nodes);
+    flattenTree(node->right, nodes);
+    if (node->deleted)
+    {
+      delete node;
+    }
+    else
+    {
+      node->left = node->right = NULL;
+      nodes.push_back(node);
+    }
+  }
+
+  Node* rebuild(Node* node)
+  {
+    ++rebuildCount;
+    nodeBuffer.clear();
+    flattenTree(node, nodeBuffer);
+    return buildTree(0, (int)nodeBuffer.size());
+  }
+
+  struct AxisLess
+  {
+    int axis;
+    bool operator()(const Node* a, const Node* b) const
+    {
+      return coord(a->point, axis) < coord(b->point, axis);
+    }
+  };
+
+  // 按包围盒最长边取中位数建树
+  Node* buildTree(int begin, int end)
+  {
+    if (begin >= end)
+      return NULL;
+    float lo[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float hi[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int i = begin; i < end; ++i)
+    {
+      for (int j = 0; j < 3; ++j)
+      {
+        float v = coord(nodeBuffer[i]->point, j);
+        lo[j] = std::min(lo[j], v);
+        hi[j] = std::max(hi[j], v);
+      }
+    }
+    int axis = 0;
+    for (int j = 1; j < 3; ++j)
+    {
+      if (hi[j] - lo[j] > hi[axis] - lo[axis])
+        axis = j;
+    }
+    int mid = (begin + end) / 2;
+    AxisLess less;
+    less.axis = axis;
+    std::nth_element(nodeBuffer.begin() + begin, nodeBuffer.begin() + mid, nodeBuffer.begin() + end, less);
+    Node* node = nodeBuffer[mid];
+    node->axis = axis;
+    node->size = end - begin;
+    node->invalid = 0;
+    for (int j = 0; j < 3; ++j)
+    {
+      node->boxMin[j] = lo[j];
+      node->boxMax[j] = hi[j];
+    }
+    node->left = buildTree(begin, mid);
+    node->right = buildTree(mid + 1, end);
+    return node;
+  }
+
+  static bool boxContains(const Box& box, const float* lo, const float* hi)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      if (lo[j] < box.min[j] || hi[j] > box.max[j])
+        return false;
+    }
+    return true;
+  }
+
+  static bool boxDisjoint(const Box& box, const float* lo, const float* hi)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      if (hi[j] < box.min[j] || lo[j] > box.max[j])
+        return true;
+    }
+    return false;
+  }
+
+  Node* deleteBox(Node* node, const Box& box, int& deleted)
+  {
+    if (node == NULL || node->treeDeleted || boxDisjoint(box, node->boxMin, node->boxMax))
+      return node;
+    if (boxContains(box, node->boxMin, node->boxMax))
+    {
+      deleted += node->size - node->invalid;
+      node->treeDeleted = true;
+      node->invalid = node->size;
+      return node;
+    }
+    if (!node->deleted)
+    {
+      float p[3] = { node->point.x, node->point.y, node->point.z };
+      if (boxContains(box, p, p))
+      {
+        node->deleted = true;
+        ++deleted;
+      }
+    }
+    node->left = deleteBox(node->left, box, deleted);
+    node->right = deleteBox(node->right, box, deleted);
+    node->invalid = (node->deleted ? 1 : 0) + (node->left == NULL ? 0 : node->left->invalid) +
+                    (node->right == NULL ? 0 : node->right->invalid);
+    node->size = 1 + (node->left == NULL ? 0 : node->left->size) + (node->right == NULL ? 0 : node->right->size);
+    if (node->invalid == node->size)
+    {
+      node->treeDeleted = true;
+      return node;
+    }
+    if (needRebuild(node))
+      return rebuild(node);
+    return node;
+  }
+
+  static float boxSqDist(const Node* node, const PointT& point)
+  {
+    float d = 0;
+    for (int j = 0; j < 3; ++j)
+    {
+      float v = coord(point, j);
+      float gap = 0;
+      if (v < node->boxMin[j])
+        gap = node->boxMin[j] - v;
+      else if (v > node->boxMax[j])
+        gap = v - node->boxMax[j];
+      d += gap * gap;
+    }
+    return d;
+  }
+
+  static float pointSqDist(const PointT& a, const PointT& b)
+  {
+    float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+    return dx * dx + dy * dy + dz * dz;
+  }
+
+  template <typename Container>
+  void knnSearch(const Node* node, const PointT& point, int k, Container& neighbors, std::vector<float>& sqDists) const
+  {
+    if (node == NULL || node->treeDeleted)
+      return;
+    if ((int)sqDists.size() == k && boxSqDist(node, point) >= sqDists.back())
+      return;
+    if (!node->deleted)
+    {
+      float d = pointSqDist(node->point, point);
+      if ((int)sqDists.size() < k || d < sqDists.back())
+      {
+        // k很小(5),有序数组插入比堆更快
+        if ((int)sqDists.size() == k)
+        {
+          neighbors.pop_back();
+          sqDists.pop_back();
+        }
+        int pos = (int)sqDists.size();
+        while (pos > 0 && sqDists[pos - 1] > d)
+          --pos;
+        sqDists.insert(sqDists.begin() + pos, d);
+        neighbors.insert(neighbors.begin() + pos, node->point);
+      }
+    }
+    bool goLeft = coord(point, node->axis) < coord(node->point, node->axis);
+    knnSearch(goLeft ? node->left : node->right, point, k, neighbors, sqDists);
+    knnSearch(goLeft ? node->right : node->left, point, k, neighbors, sqDists);
+  }
+
+  void nearestOne(const Node* node, const PointT& point, const Node*& nearest, float& sqDist) const
+  {
+    if (node == NULL || node->treeDeleted || boxSqDist(node, point) >= sqDist)
+      return;
+    if (!node->deleted)
+    {
+      float d = pointSqDist(node->point, point);
+      if (d < sqDist)
+      {
+        sqDist = d;
+        nearest = node;
+      }
+    }
+    bool goLeft = coord(point, node->axis) < coord(node->point, node->axis);
+    nearestOne(goLeft ? node->left : node->right, point, nearest, sqDist);
+    nearestOne(goLeft ? node->right : node->left, point, nearest, sqDist);
+  }
+
+  template <typename Container>
+  static void collectPoints(const Node* node, Container& points)
+  {
+    if (node == NULL || node->treeDeleted)
+      return;
+    collectPoints(node->left, points);
+    if (!node->deleted)
+      points.push_back(node->point);
+    collectPoints(node->right, points);
+  }
+
+  Node* root;
+  float balanceRatio;  // 子树一侧点数超过该比例时重建
+  float deleteRatio;   // 子树已删除点超过该比例时重建
+  int minRebuildSize;  // 小于该规模的子树不检查
+  int rebuildCount;
+
+  std::vector<Node*> nodeBuffer;
+  std::vector<Node**> insertPath;
+
+  IncrementalKdTree(const IncrementalKdTree&);
+  IncrementalKdTree& operator=(const IncrementalKdTree&);
+};
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef _SCAN_CONTEXT_H_
+#define _SCAN_CONTEXT_H_
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+// 基于Scan Context描述子的回环候选检索
+// 1. 描述子: 关键帧局部点云在水平面(camera系x-z)按半径分numRing环, 按方位角分numSector扇区, 每格取最大高度
+// 2. ring key: 每环的平均值, 与航向无关, 用k-d树检索候选
+// 3. 对候选按列循环移位计算余弦距离, 得到相似度和相对航向
+// 方位角定义为atan2(x, z), 即绕camera系y轴(竖直向上)
+class ScanContext
+{
+public:
+  ScanContext(int numRing = 20, int numSector = 60, float maxRadius = 80.0, float heightOffset = 2.0,
+              int candidateNum = 10, int treeRebuildPeriod = 10)
+    : numRing(numRing)
+    , numSector(numSector)
+    , maxRadius(maxRadius)
+    , heightOffset(heightOffset)
+    , candidateNum(candidateNum)
+    , treeRebuildPeriod(treeRebuildPeriod)
+    , treeSize(0)
+  {
+  }
+
+  int size() const
+  {
+    return descriptors.size();
+  }
+
+  // 单个关键帧的描述子及其ring key/sector key
+  struct KeyFrame
+  {
+    Eigen::MatrixXf desc;
+    Eigen::VectorXf ringKey;
+    Eigen::VectorXf sectorKey;
+    double time;
+  };
+
+  // 计算关键帧描述子, points为关键帧局部坐标系下的点; 不修改索引, 可以在锁外调用
+  template <typename PointT, typename Alloc>
+  void makeKeyFrame(const std::vector<PointT, Alloc>& points, double time, KeyFrame& keyFrame) const
+  {
+    keyFrame.desc = Eigen::MatrixXf::Zero(numRing, numSector);
+    Eigen::MatrixXf& desc = keyFrame.desc;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      const PointT& p = points[i];
+      float radius = sqrt(p.x * p.x + p.z * p.z);
+      if (radius >= maxRadius || radius < 1e-3)
+        continue;
+      float angle = atan2(p.x, p.z) + M_PI;
+      int ring = std::min(int(radius / maxRadius * numRing), numRing - 1);
+      int sector = std::min(int(angle / (2 * M_PI) * numSector), numSector - 1);
+      float height = std::max(p.y + heightOffset, 0.0f);
+      if (height > desc(ring, sector))
+        desc(ring, sector) = height;
+    }
+    keyFrame.ringKey = desc.rowwise().mean();
+    keyFrame.sectorKey = desc.colwise().mean().transpose();
+    keyFrame.time = time;
+  }
+
+  // 把makeKeyFrame算好的描述子加入索引
+  void addKeyFrame(const KeyFrame& keyFrame)
+  {
+    descriptors.push_back(keyFrame.desc);
+    ringKeys.push_back(keyFrame.ringKey);
+    sectorKeys.push_back(keyFrame.sectorKey);
+    times.push_back(keyFrame.time);
+
+    // 定期重建ring key的k-d树, 新关键帧在下次重建前不参与检索
+    if ((int)descriptors.size() - treeSize >= treeRebuildPeriod)
+      buildTree();
+  }
+
+  template <typename PointT, typename Alloc>
+  void addKeyFrame(const std::vector<PointT, Alloc>& points, double time)
+  {
+    KeyFrame keyFrame;
+    makeKeyFrame(points, time, keyFrame);
+    addKeyFrame(keyFrame);
+  }
+
+  // 两关键帧描述子的距离, yaw为把queryId局部坐标旋转到matchId局部坐标的航向角
+  float distance(int queryId, int matchId, float& yaw) const
+  {
+    int shift = 0;
+    float dist = alignedDistance(descriptors[queryId], sectorKeys[queryId], descriptors[matchId], sectorKeys[matchId],
+                                 shift);
+    yaw = -shift * 2 * M_PI / numSector;
+    return dist;
+  }
+
+  // 检索queryId的回环候选, 与queryId时间差小于minTimeDiff的关键帧不参与
+  bool detectLoop(int queryId, double minTimeDiff, int& matchId, float& dist, float& yaw) const
+  {
+    if (treeSize == 0)
+      return false;
+
+    std::vector<std::pair<float, int> > knn;
+    knnSearch(0, treeSize, 0, ringKeys[queryId], candidateNum, minTimeDiff, times[queryId], knn);
+
+    matchId = -1;
+    dist = FLT_MAX;
+    for (size_t i = 0; i < knn.size(); ++i)
+    {
+      int shift = 0;
+      float d = alignedDistance(descriptors[queryId], sectorKeys[queryId], descriptors[knn[i].second],
+                                sectorKeys[knn[i].second], shift);
+      if (d < dist)
+      {
+        dist = d;
+        matchId = knn[i].second;
+        yaw = -shift * 2 * M_PI / numSector;
+      }
+    }
+    return matchId >= 0;
+  }
+
+private:
+  // 列移位shift时的平均余弦距离, 只统计两边都非空的列
+  float shiftedDistance(const Eigen::MatrixXf& query, const Eigen::MatrixXf& match, int shift) const
+  {
+    float sum = 0;
+    int count = 0;
+    for (int j = 0; j < numSector; ++j)
+    {
+      int k = (j + shift) % numSector;
+      float normQuery = query.col(k).norm();
+      float normMatch = match.col(j).norm();
+      if (normQuery == 0 || normMatch == 0)
+        continue;
+      sum += query.col(k).dot(match.col(j)) / (normQuery * normMatch);
+      ++count;
+    }
+    if (count == 0)
+      return 1.0;
+    return 1.0 - sum / count;
+  }
+
+  // 先用sector key粗对齐, 再在粗对齐附近逐列搜索
+  float alignedDistance(const Eigen::MatrixXf& query, const Eigen::VectorXf& querySectorKey,
+                        const Eigen::MatrixXf& match, const Eigen::VectorXf& matchSectorKey, int& bestShift) const
+  {
+    int coarseShift = 0;
+    float coarseDist = FLT_MAX;
+    for (int s = 0; s < numSector; ++s)
+    {
+      float d = 0;
+      for (int j = 0; j < numSector; ++j)
+        d += fabs(querySectorKey((j + s) % numSector) - matchSectorKey(j));
+      if (d < coarseDist)
+      {
+        coarseDist = d;
+        coarseShift = s;
+      }
+    }
+
+    int searchRange = std::max(1, numSector / 10);
+    float bestDist = FLT_MAX;
+    for (int s = coarseShift - searchRange; s <= coarseShift + searchRange; ++s)
+    {
+      int shift = (s + numSector) % numSector;
+      float d = shiftedDistance(query, match, shift);
+      if (d < bestDist)
+      {
+        bestDist = d;
+        bestShift = shift;
+      }
+    }
+    return bestDist;
+  }
+
+  // ring key的静态k-d树, 按treeIndex[begin, end)的中位数原地划分
+  void buildTree()
+  {
+    treeSize = descriptors.size();
+    treeIndex.resize(treeSize);
+    for (int i = 0; i < treeSize; ++i)
+      treeIndex[i] = i;
+    buildNode(0, treeSize, 0);
+  }
+
+  void buildNode(int begin, int end, int depth)
+  {
+    if (end - begin <= 1)
+      return;
+    int axis = depth % numRing;
+    int mid = (begin + end) / 2;
+    std::nth_element(treeIndex.begin() + begin, treeIndex.begin() + mid, treeIndex.begin() + end,
+                     [&](int a, int b) { return ringKeys[a](axis) < ringKeys[b](axis); });
+    buildNode(begin, mid, depth + 1);
+    buildNode(mid + 1, end, depth + 1);
+  }
+
+  // knn按距离升序保存至多k个(平方距离, 关键帧序号)
+  void knnSearch(int begin, int end, int depth, const Eigen::VectorXf& key, int k, double minTimeDiff,
+                 double queryTime, std::vector<std::pair<float, int> >& knn) const
+  {
+    if (end <= begin)
+      return;
+    int axis = depth % numRing;
+    int mid = (begin + end) / 2;
+    int id = treeIndex[mid];
+
+    if (fabs(times[id] - queryTime) >= minTimeDiff)
+    {
+      float sqDist = (ringKeys[id] - key).squaredNorm();
+      if ((int)knn.size() < k || sqDist < knn.back().first)
+      {
+        std::pair<float, int> item(sqDist, id);
+        knn.insert(std::upper_bound(knn.begin(), knn.end(), item), item);
+        if ((int)knn.size() > k)
+          knn.pop_back();
+      }
+    }
+
+    float diff = key(axis) - ringKeys[id](axis);
+    if (diff < 0)
+    {
+      knnSearch(begin, mid, depth + 1, key, k, minTimeDiff, queryTime, knn);
+      if ((int)knn.size() < k || diff * diff < knn.back().first)
+        knnSearch(mid + 1, end, depth + 1, key, k, minTimeDiff, queryTime, knn);
+    }
+    else
+    {
+      knnSearch(mid + 1, end, depth + 1, key, k, minTimeDiff, queryTime, knn);
+      if ((int)knn.size() < k || diff * diff < knn.back().first)
+        knnSearch(begin, mid, depth + 1, key, k, minTimeDiff, queryTime, knn);
+    }
+  }
+
+  int numRing;
+  int numSector;
+  float maxRadius;
+  float heightOffset;  // 雷达安装高度, 保证高度值非负
+  int candidateNum;
+  int treeRebuildPeriod;
+
+  std::vector<Eigen::MatrixXf> descriptors;
+  std::vector<Eigen::VectorXf> ringKeys;
+  std::vector<Eigen::VectorXf> sectorKeys;
+  std::vector<double> times;
+
+  std::vector<int> treeIndex;
+  int treeSize;
+};
+
+#endif
@@ -0,0 +1,530 @@
+#ifndef _TILE_MAP_H_
+#define _TILE_MAP_H_
+
+#include <Eigen/Core>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 二进制分块点云地图
+// 地图坐标系为camera_init(y轴向上), 按x-z水平面划分为边长tileSize的方形分块
+// 文件格式(小端):
+//   TileMapHeader
+//   TileMapIndex[tileCount]   按(ix, iz)升序排列
+//   各分块数据                 cornerNum个角点后接surfNum个面点, 每点为TileMapPoint
+static const char tileMapMagic[8] = { 'A', 'G', 'V', 'T', 'M', 'A', 'P', '\0' };
+static const uint32_t tileMapVersion = 1;
+
+struct TileMapHeader
+{
+  char magic[8];
+  uint32_t version;
+  float tileSize;
+  uint32_t tileCount;
+  uint32_t reserved;
+};
+
+struct TileMapIndex
+{
+  int32_t ix;
+  int32_t iz;
+  uint64_t offset;  // 分块数据在文件中的偏移
+  uint32_t cornerNum;
+  uint32_t surfNum;
+};
+
+struct TileMapPoint
+{
+  float x;
+  float y;
+  float z;
+  float intensity;
+};
+
+inline int tileMapCoord(float v, float tileSize)
+{
+  return (int)std::floor(v / tileSize);
+}
+
+// 将角点/面点地图按分块写入path, 先写临时文件再重命名, 写入中断不会破坏已有地图
+template <typename Container>
+bool saveTileMap(const std::string& path, const Container& corner, const Container& surf, float tileSize)
+{
+  if (tileSize <= 0)
+    return false;
+
+  // (分块, 类别, 点序号), 排序后同一分块的点连续存放
+  struct Entry
+  {
+    int32_t ix;
+    int32_t iz;
+    uint32_t layer;
+    uint32_t index;
+    bool operator<(const Entry& other) const
+    {
+      if (ix != other.ix)
+        return ix < other.ix;
+      if (iz != other.iz)
+        return iz < other.iz;
+      if (layer != other.layer)
+        return layer < other.layer;
+      return index < other.index;
+    }
+  };
+  std::vector<Entry> entries;
+  entries.reserve(corner.size() + surf.size());
+  const Container* layers[2] = { &corner, &surf };
+  for (uint32_t layer = 0; layer < 2; ++layer)
+  {
+    const Container& cloud = *layers[layer];
+    for (size_t i = 0; i < cloud.size(); ++i)
+    {
+      if (!std::isfinite(cloud[i].x) || !std::isfinite(cloud[i].y) || !std::isfinite(cloud[i].z))
+        continue;
+      Entry entry;
+      entry.ix = tileMapCoord(cloud[i].x, tileSize);
+      entry.iz = tileMapCoord(cloud[i].z, tileSize);
+      entry.layer = layer;
+      entry.index = (uint32_t)i;
+      entries.push_back(entry);
+    }
+  }
+  std::sort(entries.begin(), entries.end());
+
+  std::vector<TileMapIndex> index;
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    if (index.empty() || index.back().ix != entries[i].ix || index.back().iz != entries[i].iz)
+    {
+      TileMapIndex tile;
+      tile.ix = entries[i].ix;
+      tile.iz = entries[i].iz;
+      tile.offset = 0;
+      tile.cornerNum = 0;
+      tile.surfNum = 0;
+      index.push_back(tile);
+    }
+    if (entries[i].layer == 0)
+      index.back().cornerNum++;
+    else
+      index.back().surfNum++;
+  }
+
+  uint64_t offset = sizeof(TileMapHeader) + index.size() * sizeof(TileMapIndex);
+  for (size_t i = 0; i < index.size(); ++i)
+  {
+    index[i].offset = offset;
+    offset += (uint64_t)(index[i].cornerNum + index[i].surfNum) * sizeof(TileMapPoint);
+  }
+
+  TileMapHeader header;
+  memcpy(header.magic, tileMapMagic, sizeof(header.magic));
+  header.version = tileMapVersion;
+  header.tileSize = tileSize;
+  header.tileCount = (uint32_t)index.size();
+  header.reserved = 0;
+
+  std::string tmpPath = path + ".tmp";
+  FILE* fp = fopen(tmpPath.c_str(), "wb");
+  if (fp == NULL)
+    return false;
+  bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+  if (ok && !index.empty())
+    ok = fwrite(&index[0], sizeof(TileMapIndex), index.size(), fp) == index.size();
+
+  std::vector<TileMapPoint> buffer;
+  buffer.reserve(4096);
+  for (size_t i = 0; ok && i < entries.size(); ++i)
+  {
+    const Container& cloud = *layers[entries[i].layer];
+    const typename Container::value_type& p = cloud[entries[i].index];
+    TileMapPoint point;
+    point.x = p.x;
+    point.y = p.y;
+    point.z = p.z;
+    point.intensity = p.intensity;
+    buffer.push_back(point);
+    if (buffer.size() == buffer.capacity() || i + 1 == entries.size())
+    {
+      ok = fwrite(&buffer[0], sizeof(TileMapPoint), buffer.size(), fp) == buffer.size();
+      buffer.clear();
+    }
+  }
+  ok = (fclose(fp) == 0) && ok;
+  if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+  {
+    remove(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+// 分块地图读取, open()只读入文件头与索引, 分块数据按需读取
+class TileMapReader
+{
+public:
+  TileMapReader() : fp(NULL)
+  {
+    memset(&header, 0, sizeof(header));
+  }
+
+  ~TileMapReader()
+  {
+    close();
+  }
+
+  bool open(const std::string& path)
+  {
+    close();
+    fp = fopen(path.c_str(), "rb");
+    if (fp == NULL)
+      return false;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || memcmp(header.magic, tileMapMagic, sizeof(header.magic)) != 0 ||
+        header.version != tileMapVersion || !(header.tileSize > 0))
+    {
+      close();
+      return false;
+    }
+    index.resize(header.tileCount);
+    if (header.tileCount > 0 && fread(&index[0], sizeof(TileMapIndex), header.tileCount, fp) != header.tileCount)
+    {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  void close()
+  {
+    if (fp != NULL)
+      fclose(fp);
+    fp = NULL;
+    index.clear();
+  }
+
+  bool isOpen() const
+  {
+    return fp != NULL;
+  }
+
+  float tileSize() const
+  {
+    return header.tileSize;
+  }
+
+  int tileCount() const
+  {
+    return (int)index.size();
+  }
+
+  const TileMapIndex& tile(int i) const
+  {
+    return index[i];
+  }
+
+  // 按分块坐标查找, 不存在返回-1
+  int findTile(int ix, int iz) const
+  {
+    std::vector<TileMapIndex>::const_iterator it =
+        std::lower_bound(index.begin(), index.end(), std::make_pair(ix, iz), indexLess);
+    if (it == index.end() || it->ix != ix || it->iz != iz)
+      return -1;
+    return (int)(it - index.begin());
+  }
+
+  // 读取第i个分块, 点追加到corner/surf之后
+  template <typename Container>
+  bool readTile(int i, Container& corner, Container& surf)
+  {
+    if (fp == NULL || i < 0 || i >= (int)index.size())
+      return false;
+    const TileMapIndex& tile = index[i];
+    buffer.resize(tile.cornerNum + tile.surfNum);
+    if (buffer.empty())
+      return true;
+    if (fseeko(fp, (off_t)tile.offset, SEEK_SET) != 0 ||
+        fread(&buffer[0], sizeof(TileMapPoint), buffer.size(), fp) != buffer.size())
+      return false;
+    for (size_t j = 0; j < buffer.size(); ++j)
+    {
+      typename Container::value_type p;
+      p.x = buffer[j].x;
+      p.y = buffer[j].y;
+      p.z = buffer[j].z;
+      p.intensity = buffer[j].intensity;
+      if (j < tile.cornerNum)
+        corner.push_back(p);
+      else
+        surf.push_back(p);
+    }
+    return true;
+  }
+
+  template <typename Container>
+  bool readAll(Container& corner, Container& surf)
+  {
+    for (int i = 0; i < (int)index.size(); ++i)
+    {
+      if (!readTile(i, corner, surf))
+        return false;
+    }
+    return true;
+  }
+
+private:
+  static bool indexLess(const TileMapIndex& tile, const std::pair<int, int>& key)
+  {
+    return tile.ix < key.first || (tile.ix == key.first && tile.iz < key.second);
+  }
+
+  FILE* fp;
+  TileMapHeader header;
+  std::vector<TileMapIndex> index;
+  std::vector<TileMapPoint> buffer;
+
+  TileMapReader(const TileMapReader&);
+  TileMapReader& operator=(const TileMapReader&);
+};
+
+// 分块地图LRU缓存, 按车辆位置取出周围的分块, 不在缓存中的分块从文件读取
+// 缓存满时淘汰最久未使用的分块, 地图不必整体常驻内存
+template <typename PointT>
+class TileMapCache
+{
+public:
+  typedef std::vector<PointT, Eigen::aligned_allocator<PointT> > Cloud;
+  typedef std::pair<int, int> TileKey;
+
+  TileMapCache() : capacity(64), hits(0), misses(0)
+  {
+  }
+
+  bool open(const std::string& path, int capacityTiles)
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    tiles.clear();
+    lookup.clear();
+    capacity = std::max(1, capacityTiles);
+    hits = 0;
+    misses = 0;
+    return reader.open(path);
+  }
+
+  bool isOpen() const
+  {
+    return reader.isOpen();
+  }
+
+  float tileSize() const
+  {
+    return reader.tileSize();
+  }
+
+  int tileCount() const
+  {
+    return reader.tileCount();
+  }
+
+  // 水平面上与以(x, z)为圆心、radius为半径的圆相交且文件中存在的分块, 按坐标排序
+  void tilesAround(float x, float z, float radius, std::vector<TileKey>& keys) const
+  {
+    keys.clear();
+    if (!reader.isOpen())
+      return;
+    const float size = reader.tileSize();
+    int ix0 = tileMapCoord(x - radius, size), ix1 = tileMapCoord(x + radius, size);
+    int iz0 = tileMapCoord(z - radius, size), iz1 = tileMapCoord(z + radius, size);
+    for (int ix = ix0; ix <= ix1; ++ix)
+    {
+      float dx = std::max(0.f, std::max(ix * size - x, x - (ix + 1) * size));
+      for (int iz = iz0; iz <= iz1; ++iz)
+      {
+        float dz = std::max(0.f, std::max(iz * size - z, z - (iz + 1) * size));
+        if (dx * dx + dz * dz <= radius * radius && reader.findTile(ix, iz) >= 0)
+          keys.push_back(TileKey(ix, iz));
+      }
+    }
+  }
+
+  // 将keys中的分块追加到corner/surf, 返回从文件读取的分块数, 读取失败返回-1
+  template <typename Container>
+  int gather(const std::vector<TileKey>& keys, Container& corner, Container& surf)
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    int loaded = 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+      typename std::map<TileKey, typename std::list<Tile>::iterator>::iterator it = lookup.find(keys[i]);
+      if (it != lookup.end())
+      {
+        tiles.splice(tiles.begin(), tiles, it->second);
+        hits++;
+      }
+      else
+      {
+        int index = reader.findTile(keys[i].first, keys[i].second);
+        if (index < 0)
+          continue;
+        tiles.push_front(Tile());
+        Tile& tile = tiles.front();
+        tile.key = keys[i];
+        if (!reader.readTile(index, tile.corner, tile.surf))
+        {
+          tiles.pop_front();
+          return -1;
+        }
+        lookup[tile.key] = tiles.begin();
+        misses++;
+        loaded++;
+      }
+      const Tile& tile = tiles.front();
+      corner.insert(corner.end(), tile.corner.begin(), tile.corner.end());
+      surf.insert(surf.end(), tile.surf.begin(), tile.surf.end());
+    }
+    // 本次用到的分块都在表头, 只淘汰其余的分块
+    while ((int)tiles.size() > std::max(capacity, (int)keys.size()))
+    {
+      lookup.erase(tiles.back().key);
+      tiles.pop_back();
+    }
+    return loaded;
+  }
+
+  int cacheHits() const
+  {
+    return hits;
+  }
+
+  int cacheMisses() const
+  {
+    return misses;
+  }
+
+private:
+  struct Tile
+  {
+    TileKey key;
+    Cloud corner;
+    Cloud surf;
+  };
+
+  std::mutex mtx;
+  TileMapReader reader;
+  std::list<Tile> tiles;  // 表头为最近使用
+  std::map<TileKey, typename std::list<Tile>::iterator> lookup;
+  int capacity;
+  int hits;
+  int misses;
+};
+
+// 分块地图异步写入, save()拷贝点云后立即返回, 由后台线程写文件
+// 上一次写入未完成时, 新的请求覆盖还在排队的请求, 只保证最新的地图被写入
+class TileMapWriter
+{
+public:
+  TileMapWriter() : pending(false), busy(false), stop(false), result(true), worker(&TileMapWriter::run, this)
+  {
+  }
+
+  ~TileMapWriter()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stop = true;
+    }
+    cond.notify_all();
+    worker.join();
+  }
+
+  template <typename Container>
+  void save(const std::string& path, const Container& corner, const Container& surf, float tileSize)
+  {
+    std::vector<TileMapPoint> cornerCopy, surfCopy;
+    copyPoints(corner, cornerCopy);
+    copyPoints(surf, surfCopy);
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      pendingPath = path;
+      pendingTileSize = tileSize;
+      pendingCorner.swap(cornerCopy);
+      pendingSurf.swap(surfCopy);
+      pending = true;
+    }
+    cond.notify_all();
+  }
+
+  // 等待排队和正在进行的写入完成, 返回最后一次写入是否成功
+  bool wait()
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    cond.wait(lock, [this] { return !pending && !busy; });
+    return result;
+  }
+
+private:
+  template <typename Container>
+  static void copyPoints(const Container& cloud, std::vector<TileMapPoint>& points)
+  {
+    points.resize(cloud.size());
+    for (size_t i = 0; i < cloud.size(); ++i)
+    {
+      points[i].x = cloud[i].x;
+      points[i].y = cloud[i].y;
+      points[i].z = cloud[i].z;
+      points[i].intensity = cloud[i].intensity;
+    }
+  }
+
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true)
+    {
+      cond.wait(lock, [this] { return pending || stop; });
+      if (!pending)
+        break;
+      std::string path;
+      float tileSize = pendingTileSize;
+      std::vector<TileMapPoint> corner, surf;
+      path.swap(pendingPath);
+      corner.swap(pendingCorner);
+      surf.swap(pendingSurf);
+      pending = false;
+      busy = true;
+      lock.unlock();
+      bool ok = saveTileMap(path, corner, surf, tileSize);
+      lock.lock();
+      busy = false;
+      result = ok;
+      cond.notify_all();
+    }
+  }
+
+  std::mutex mtx;
+  std::condition_variable cond;
+  std::string pendingPath;
+  float pendingTileSize;
+  std::vector<TileMapPoint> pendingCorner;
+  std::vector<TileMapPoint> pendingSurf;
+  bool pending;
+  bool busy;
+  bool stop;
+  bool result;
+  std::thread worker;
+
+  TileMapWriter(const TileMapWriter&);
+  TileMapWriter& operator=(const TileMapWriter&);
+};
+
+#endif
@@ -55,6 +55,10 @@ extern const string imuTopic = "/imu/data";
 
 // Save pcd
 extern const string fileDirectory = "/home/ads/data/TW/";
+// Binary tile map (corner + surf), used by lidarLocalization
+extern const string tileMapFile = fileDirectory + "map.tmap";
+extern const float tileMapSize = 50.0;             // tile edge length in meters
+extern const double tileMapSaveInterval = 60.0;    // background tile map snapshot while mapping, seconds
 
 // TW-16
 typedef pcl::PointXYZI PointType;
@@ -93,12 +97,15 @@ extern const float surroundingKeyframeSearchRadius = 50.0;  // key frame that is
                                                             // be considerd for scan-to-map optimization (when loop
                                                             // closure disabled)
 extern const int surroundingKeyframeSearchNum = 50;         // submap size (when loop closure enabled)
+extern const int numberOfCores = 4;                         // threads used by scan-to-map feature matching
 // history key frames (history submap for loop closure)
 extern const float historyKeyframeSearchRadius =
     7.0;  // key frame that is within n meters from current pose will be considerd for loop closure
 extern const int historyKeyframeSearchNum =
     25;  // 2n+1 number of history key frames will be fused into a submap for loop closure
 extern const float historyKeyframeFitnessScore = 0.3;  // the smaller the better alignment
+extern const float scanContextDistThreshold = 0.2;     // 描述子检索到的回环候选的距离阈值
+extern const float scanContextGateThreshold = 0.4;     // 半径搜索到的候选做ICP前的描述子距离门限
 
 extern const float globalMapVisualizationSearchRadius = 500.0;  // key frames with in n meters will be visualized
 
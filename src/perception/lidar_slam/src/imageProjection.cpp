@@ -28,6 +28,8 @@
 
 #include "../include/utility.h"
 
+#include <std_msgs/Float32MultiArray.h>
+
 class ImageProjection
 {
 private:
@@ -43,6 +45,7 @@ private:
   ros::Publisher pubSegmentedCloudPure;
   ros::Publisher pubSegmentedCloudInfo;
   ros::Publisher pubOutlierCloud;
+  ros::Publisher pubProjectionTime;
 
   pcl::PointCloud< PointType >::Ptr laserCloudIn;
 
@@ -67,19 +70,36 @@ private:
   cloud_msgs::cloud_info segMsg; // info of segmented cloud
   std_msgs::Header cloudHeader;
 
-  std::vector< std::pair< uint8_t, uint8_t > > neighborIterator; // neighbor iterator for segmentaiton process
+  std::vector< std::pair< int8_t, int8_t > > neighborIterator; // neighbor iterator for segmentaiton process
+  float neighborSin[4];                                         // 各邻域方向的角分辨率sin/cos表
+  float neighborCos[4];
+  float segmentTanTheta; // tan(segmentTheta), 用正切比较代替atan2
+
+  int segmentMethod;  // 0: BFS, 1: 按行并行的并查集
+  bool segmentVerify; // 与原始atan2 BFS结果逐点比对
+
+  std::vector< int > queueInd; // 展平的BFS队列, 出队顺序即该分割的全部点
 
-  uint16_t *allPushedIndX; // array for tracking points of a segmented object
-  uint16_t *allPushedIndY;
+  std::vector< int > unionParent;        // 并查集父节点, 根为该连通域光栅顺序的第一个点
+  std::vector< uint8_t > verticalLink;   // (i,j)与(i+1,j)是否连通
+  std::vector< int > componentSize;      // 以根索引记录的连通域点数
+  std::vector< uint64_t > componentLine; // 除种子点外覆盖的线束
+  std::vector< int > componentRoots;     // 按光栅顺序出现的根
 
-  uint16_t *queueIndX; // array for breadth-first search process of segmentation
-  uint16_t *queueIndY;
+  double timeProjection; // 各阶段耗时, ms
+  double timeGround;
+  double timeSegmentation;
 
 public:
   ImageProjection() : nh("~")
   {
     // 读入参数配置
     segmentTheta = nh.param("/segmentParam/segmentTheta", 40) * M_PI / 180;
+    nh.param("/segmentParam/segmentMethod", segmentMethod, 0);
+    nh.param("/segmentParam/segmentVerify", segmentVerify, false);
+    // 正切比较要求阈值在(0, 90)度内
+    segmentTheta    = std::min(std::max(segmentTheta, 1e-3f), float(M_PI / 2) - 1e-3f);
+    segmentTanTheta = tan(segmentTheta);
 
     subLaserCloud = nh.subscribe< sensor_msgs::PointCloud2 >(pointCloudTopic, 1, &ImageProjection::cloudHandler, this);
 
@@ -91,6 +111,7 @@ public:
     pubSegmentedCloudPure = nh.advertise< sensor_msgs::PointCloud2 >("/segmented_cloud_pure", 1);
     pubSegmentedCloudInfo = nh.advertise< cloud_msgs::cloud_info >("/segmented_cloud_info", 1);
     pubOutlierCloud       = nh.advertise< sensor_msgs::PointCloud2 >("/outlier_cloud", 1);
+    pubProjectionTime     = nh.advertise< std_msgs::Float32MultiArray >("/image_projection_time", 1);
 
     nanPoint.x         = std::numeric_limits< float >::quiet_NaN();
     nanPoint.y         = std::numeric_limits< float >::quiet_NaN();
@@ -137,11 +158,24 @@ public:
     neighbor.second = 0;
     neighborIterator.push_back(neighbor);
 
-    allPushedIndX = new uint16_t[N_SCAN * Horizon_SCAN];
-    allPushedIndY = new uint16_t[N_SCAN * Horizon_SCAN];
+    for (size_t k = 0; k < neighborIterator.size(); ++k)
+    {
+      float alpha    = neighborIterator[k].first == 0 ? segmentAlphaX : segmentAlphaY;
+      neighborSin[k] = sin(alpha);
+      neighborCos[k] = cos(alpha);
+    }
+
+    queueInd.resize(N_SCAN * Horizon_SCAN);
 
-    queueIndX = new uint16_t[N_SCAN * Horizon_SCAN];
-    queueIndY = new uint16_t[N_SCAN * Horizon_SCAN];
+    unionParent.resize(N_SCAN * Horizon_SCAN);
+    verticalLink.resize(N_SCAN * Horizon_SCAN);
+    componentSize.resize(N_SCAN * Horizon_SCAN);
+    componentLine.resize(N_SCAN * Horizon_SCAN);
+    componentRoots.reserve(N_SCAN * Horizon_SCAN);
+
+    rangeMat  = cv::Mat(N_SCAN, Horizon_SCAN, CV_32F);
+    groundMat = cv::Mat(N_SCAN, Horizon_SCAN, CV_8S);
+    labelMat  = cv::Mat(N_SCAN, Horizon_SCAN, CV_32S);
   }
 
   void resetParameters()
@@ -152,9 +186,9 @@ public:
     segmentedCloudPure->clear();
     outlierCloud->clear();
 
-    rangeMat   = cv::Mat(N_SCAN, Horizon_SCAN, CV_32F, cv::Scalar::all(FLT_MAX));
-    groundMat  = cv::Mat(N_SCAN, Horizon_SCAN, CV_8S, cv::Scalar::all(0));
-    labelMat   = cv::Mat(N_SCAN, Horizon_SCAN, CV_32S, cv::Scalar::all(0));
+    rangeMat.setTo(cv::Scalar::all(FLT_MAX));
+    groundMat.setTo(cv::Scalar::all(0));
+    labelMat.setTo(cv::Scalar::all(0));
     labelCount = 1;
 
     std::fill(fullCloud->points.begin(), fullCloud->points.end(), nanPoint);
@@ -179,18 +213,26 @@ public:
 
   void cloudHandler(const sensor_msgs::PointCloud2ConstPtr &laserCloudMsg)
   {
+    ros::WallTime timeStart = ros::WallTime::now();
     // 1. Convert ros message to pcl point cloud
     copyPointCloud(laserCloudMsg);
     // 2. Start and end angle of a scan
     findStartEndAngle();
     // 3. Range image projection
+    ros::WallTime timeStage = ros::WallTime::now();
     projectPointCloud();
+    timeProjection = (ros::WallTime::now() - timeStage).toSec() * 1000;
     // 4. Mark ground points
+    timeStage = ros::WallTime::now();
     groundRemoval();
+    timeGround = (ros::WallTime::now() - timeStage).toSec() * 1000;
     // 5. Point cloud segmentation
+    timeStage = ros::WallTime::now();
     cloudSegmentation();
+    timeSegmentation = (ros::WallTime::now() - timeStage).toSec() * 1000;
     // 6. Publish all clouds
     publishCloud();
+    publishTime((ros::WallTime::now() - timeStart).toSec() * 1000);
     // 7. Reset parameters for next iteration
     resetParameters();
   }
@@ -330,11 +372,24 @@ public:
 
   void cloudSegmentation()
   {
+    cv::Mat labelMatRef;
+    if (segmentVerify)
+      labelMatRef = labelMat.clone();
     // segmentation process
-    for (size_t i = 0; i < N_SCAN; ++i)
-      for (size_t j = 0; j < Horizon_SCAN; ++j)
-        if (labelMat.at< int >(i, j) == 0)
-          labelComponents(i, j);
+    if (segmentMethod == 1)
+      labelComponentsUnionFind();
+    else
+    {
+      for (size_t i = 0; i < N_SCAN; ++i)
+      {
+        const int *labelRow = labelMat.ptr< int >(i);
+        for (size_t j = 0; j < Horizon_SCAN; ++j)
+          if (labelRow[j] == 0)
+            labelComponents(i, j);
+      }
+    }
+    if (segmentVerify)
+      verifySegmentation(labelMatRef);
 
     int sizeOfSegCloud = 0;
     // extract segmented cloud for lidar odometry
@@ -383,10 +438,6 @@ public:
 
     // extract segmented cloud for visualization
     // todo 可以在此处将点云分割成为单个独立的点云
-    pcl::IndicesClusters segmented_cloud_indices;
-    segmented_cloud_indices.clear();
-    segmented_cloud_indices.resize(labelCount);
-
     if (pubSegmentedCloudPure.getNumSubscribers() != 0) // 只有segmentedpoints
     {
       for (size_t i = 0; i < N_SCAN; ++i)
@@ -403,111 +454,228 @@ public:
     }
   }
 
+  // 两相邻点是否属于同一物体: atan2(d2*sin(a), d1-d2*cos(a)) > theta
+  // 分子恒正, theta在(0, 90)度内时等价于 d2*sin(a) > tan(theta)*(d1-d2*cos(a))
+  inline bool segmentConnected(float range1, float range2, int neighbor) const
+  {
+    float d1 = std::max(range1, range2);
+    float d2 = std::min(range1, range2);
+    return d2 * neighborSin[neighbor] > segmentTanTheta * (d1 - d2 * neighborCos[neighbor]);
+  }
+
+  // 按原LeGO-LOAM规则判断分割是否有效, lineMask不含种子点所在线束
+  inline bool feasibleSegment(int segmentSize, uint64_t lineMask) const
+  {
+    if (segmentSize >= 30)
+      return true;
+    if (segmentSize < segmentValidPointNum)
+      return false;
+    int lineCount = 0;
+    for (; lineMask; lineMask &= lineMask - 1)
+      ++lineCount;
+    return lineCount >= segmentValidLineNum;
+  }
+
   void labelComponents(int row, int col)
   {
-    // use std::queue std::vector std::deque will slow the program down greatly
-    float d1, d2, alpha, angle;
-    int fromIndX, fromIndY, thisIndX, thisIndY;
-    bool lineCountFlag[N_SCAN] = {false};
-
-    queueIndX[0]      = row;
-    queueIndY[0]      = col;
-    int queueSize     = 1;
-    int queueStartInd = 0;
-    int queueEndInd   = 1;
-
-    allPushedIndX[0]     = row;
-    allPushedIndY[0]     = col;
-    int allPushedIndSize = 1;
-
-    while (queueSize > 0)
+    static_assert(N_SCAN <= 64, "line mask holds at most 64 scans");
+    int *label         = labelMat.ptr< int >(0);
+    const float *range = rangeMat.ptr< float >(0);
+    uint64_t lineMask  = 0;
+
+    // 队列中已出队的部分即为该分割的全部点, 不再单独记录
+    queueInd[0]        = col + row * Horizon_SCAN;
+    int queueStartInd  = 0;
+    int queueEndInd    = 1;
+    label[queueInd[0]] = labelCount;
+
+    while (queueStartInd < queueEndInd)
     {
       // Pop point
-      fromIndX = queueIndX[queueStartInd];
-      fromIndY = queueIndY[queueStartInd];
-      --queueSize;
-      ++queueStartInd;
-      // Mark popped point
-      labelMat.at< int >(fromIndX, fromIndY) = labelCount;
+      int fromInd  = queueInd[queueStartInd++];
+      int fromIndX = fromInd / Horizon_SCAN;
+      int fromIndY = fromInd - fromIndX * Horizon_SCAN;
       // Loop through all the neighboring grids of popped grid
-      for (auto iter = neighborIterator.begin(); iter != neighborIterator.end(); ++iter)
+      for (int k = 0; k < 4; ++k)
       {
-        // new index
-        thisIndX = fromIndX + (*iter).first;
-        thisIndY = fromIndY + (*iter).second;
-        // index should be within the boundary
-        if (thisIndX < 0 || thisIndX >= N_SCAN) // tanway不是连续的
-        {
-          continue;
-        }
-        // at range image margin (left or right side)
-        if (thisIndY < 0)
-        {
-          //   thisIndY = Horizon_SCAN - 1;
+        int thisIndX = fromIndX + neighborIterator[k].first;
+        int thisIndY = fromIndY + neighborIterator[k].second;
+        // index should be within the boundary, tanway不是连续的, 左右边界不相连
+        if (thisIndX < 0 || thisIndX >= N_SCAN || thisIndY < 0 || thisIndY >= Horizon_SCAN)
           continue;
-        }
-        if (thisIndY >= Horizon_SCAN)
-        {
-          continue;
-          thisIndY = 0;
-        }
+        int thisInd = thisIndY + thisIndX * Horizon_SCAN;
         // prevent infinite loop (caused by put already examined point back)
-        if (labelMat.at< int >(thisIndX, thisIndY) != 0)
+        if (label[thisInd] != 0)
+          continue;
+        if (!segmentConnected(range[fromInd], range[thisInd], k))
           continue;
 
-        d1 = std::max(rangeMat.at< float >(fromIndX, fromIndY), rangeMat.at< float >(thisIndX, thisIndY));
-        d2 = std::min(rangeMat.at< float >(fromIndX, fromIndY), rangeMat.at< float >(thisIndX, thisIndY));
+        label[thisInd] = labelCount; // 这个实际可以认为是障碍物ID,也可以认为最终结果是障碍物个数
+        lineMask |= uint64_t(1) << thisIndX;
+        queueInd[queueEndInd++] = thisInd;
+      }
+    }
 
-        if ((*iter).first == 0)
-          alpha = segmentAlphaX;
-        else
-          alpha = segmentAlphaY;
+    // segment is valid, mark these points
+    if (feasibleSegment(queueEndInd, lineMask))
+    {
+      ++labelCount;
+    }
+    else
+    { // segment is invalid, mark these points
+      for (int i = 0; i < queueEndInd; ++i)
+        label[queueInd[i]] = 999999;
+    }
+  }
 
-        angle = atan2(d2 * sin(alpha), (d1 - d2 * cos(alpha)));
+  inline int findRoot(int ind)
+  {
+    while (unionParent[ind] != ind)
+    {
+      unionParent[ind] = unionParent[unionParent[ind]];
+      ind              = unionParent[ind];
+    }
+    return ind;
+  }
 
-        if (angle > segmentTheta)
-        {
-          queueIndX[queueEndInd] = thisIndX;
-          queueIndY[queueEndInd] = thisIndY;
-          ++queueSize;
-          ++queueEndInd;
-
-          labelMat.at< int >(thisIndX, thisIndY) =
-              labelCount; // 这个实际可以认为是障碍物ID,也可以认为最终结果是障碍物个数
-          lineCountFlag[thisIndX] = true;
-
-          allPushedIndX[allPushedIndSize] = thisIndX;
-          allPushedIndY[allPushedIndSize] = thisIndY;
-          ++allPushedIndSize;
-        }
+  // 与labelComponents结果一致的并查集实现: 行内连通与线间连通判断按行并行,
+  // 根取光栅顺序最小的点, 因此标签编号与逐点BFS的种子顺序相同
+  void labelComponentsUnionFind()
+  {
+    int *label         = labelMat.ptr< int >(0);
+    const float *range = rangeMat.ptr< float >(0);
+
+#pragma omp parallel for num_threads(numberOfCores)
+    for (int i = 0; i < N_SCAN; ++i)
+    {
+      int rowStart = i * Horizon_SCAN;
+      for (int j = 0; j < Horizon_SCAN; ++j)
+      {
+        int ind           = rowStart + j;
+        unionParent[ind]  = ind;
+        verticalLink[ind] = 0;
+        if (label[ind] != 0)
+          continue;
+        // 行内连续段直接指向段首
+        if (j > 0 && label[ind - 1] == 0 && segmentConnected(range[ind - 1], range[ind], 1))
+          unionParent[ind] = unionParent[ind - 1];
+        if (i + 1 < N_SCAN && label[ind + Horizon_SCAN] == 0)
+          verticalLink[ind] = segmentConnected(range[ind], range[ind + Horizon_SCAN], 3);
       }
     }
 
-    // check if this segment is valid
-    bool feasibleSegment = false;
-    if (allPushedIndSize >= 30)
-      feasibleSegment = true;
-    else if (allPushedIndSize >= segmentValidPointNum)
+    // 线间合并, 小索引为根
+    for (int ind = 0; ind < (N_SCAN - 1) * Horizon_SCAN; ++ind)
     {
-      int lineCount = 0;
-      for (size_t i = 0; i < N_SCAN; ++i)
-        if (lineCountFlag[i] == true)
-          ++lineCount;
-      if (lineCount >= segmentValidLineNum)
-        feasibleSegment = true;
+      if (!verticalLink[ind])
+        continue;
+      int root1 = findRoot(ind);
+      int root2 = findRoot(ind + Horizon_SCAN);
+      if (root1 < root2)
+        unionParent[root2] = root1;
+      else if (root2 < root1)
+        unionParent[root1] = root2;
     }
-    // segment is valid, mark these points
-    if (feasibleSegment == true)
+
+    // 统计各连通域点数和线束, 根即BFS的种子点, 其所在线束不计入
+    componentRoots.clear();
+    for (int ind = 0; ind < N_SCAN * Horizon_SCAN; ++ind)
     {
-      ++labelCount;
+      if (label[ind] != 0)
+        continue;
+      int root = findRoot(ind);
+      if (root == ind)
+      {
+        componentSize[ind] = 1;
+        componentLine[ind] = 0;
+        componentRoots.push_back(ind);
+      }
+      else
+      {
+        ++componentSize[root];
+        componentLine[root] |= uint64_t(1) << (ind / Horizon_SCAN);
+      }
     }
-    else
-    { // segment is invalid, mark these points
-      for (size_t i = 0; i < allPushedIndSize; ++i)
+
+    // 按种子顺序分配标签, componentSize复用为标签
+    for (size_t k = 0; k < componentRoots.size(); ++k)
+    {
+      int root = componentRoots[k];
+      if (feasibleSegment(componentSize[root], componentLine[root]))
+        componentSize[root] = labelCount++;
+      else
+        componentSize[root] = 999999;
+    }
+    for (int ind = 0; ind < N_SCAN * Horizon_SCAN; ++ind)
+      if (label[ind] == 0)
+        label[ind] = componentSize[findRoot(ind)];
+  }
+
+  // 用原始的atan2逐点BFS重新分割, 与当前结果逐点比对, 用于回放录制数据验证
+  void verifySegmentation(cv::Mat &labelMatRef)
+  {
+    int labelCountRef = 1;
+    std::vector< int > queue;
+    for (int row = 0; row < N_SCAN; ++row)
+    {
+      for (int col = 0; col < Horizon_SCAN; ++col)
       {
-        labelMat.at< int >(allPushedIndX[i], allPushedIndY[i]) = 999999;
+        if (labelMatRef.at< int >(row, col) != 0)
+          continue;
+        bool lineCountFlag[N_SCAN] = {false};
+        queue.assign(1, col + row * Horizon_SCAN);
+        labelMatRef.at< int >(row, col) = labelCountRef;
+        for (size_t q = 0; q < queue.size(); ++q)
+        {
+          int fromIndX = queue[q] / Horizon_SCAN;
+          int fromIndY = queue[q] % Horizon_SCAN;
+          for (auto iter = neighborIterator.begin(); iter != neighborIterator.end(); ++iter)
+          {
+            int thisIndX = fromIndX + (*iter).first;
+            int thisIndY = fromIndY + (*iter).second;
+            if (thisIndX < 0 || thisIndX >= N_SCAN || thisIndY < 0 || thisIndY >= Horizon_SCAN)
+              continue;
+            if (labelMatRef.at< int >(thisIndX, thisIndY) != 0)
+              continue;
+            float d1    = std::max(rangeMat.at< float >(fromIndX, fromIndY), rangeMat.at< float >(thisIndX, thisIndY));
+            float d2    = std::min(rangeMat.at< float >(fromIndX, fromIndY), rangeMat.at< float >(thisIndX, thisIndY));
+            float alpha = (*iter).first == 0 ? segmentAlphaX : segmentAlphaY;
+            if (atan2(d2 * sin(alpha), (d1 - d2 * cos(alpha))) > segmentTheta)
+            {
+              labelMatRef.at< int >(thisIndX, thisIndY) = labelCountRef;
+              lineCountFlag[thisIndX]                   = true;
+              queue.push_back(thisIndX * Horizon_SCAN + thisIndY);
+            }
+          }
+        }
+        int lineCount = 0;
+        for (size_t i = 0; i < N_SCAN; ++i)
+          if (lineCountFlag[i] == true)
+            ++lineCount;
+        if (queue.size() >= 30 || (queue.size() >= segmentValidPointNum && lineCount >= segmentValidLineNum))
+          ++labelCountRef;
+        else
+          for (size_t q = 0; q < queue.size(); ++q)
+            labelMatRef.at< int >(queue[q] / Horizon_SCAN, queue[q] % Horizon_SCAN) = 999999;
       }
     }
+
+    int mismatch = cv::countNonZero(labelMatRef != labelMat);
+    if (mismatch != 0 || labelCountRef != labelCount)
+      ROS_WARN("Segmentation mismatch: %d points, %d/%d labels", mismatch, labelCount, labelCountRef);
+  }
+
+  // 各阶段耗时: 投影, 地面提取, 分割, 总计, 单位ms
+  void publishTime(double timeTotal)
+  {
+    if (pubProjectionTime.getNumSubscribers() == 0)
+      return;
+    std_msgs::Float32MultiArray timeMsg;
+    timeMsg.data.push_back(timeProjection);
+    timeMsg.data.push_back(timeGround);
+    timeMsg.data.push_back(timeSegmentation);
+    timeMsg.data.push_back(timeTotal);
+    pubProjectionTime.publish(timeMsg);
   }
 
   void publishCloud()
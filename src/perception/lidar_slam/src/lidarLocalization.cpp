@@ -1,1651 +1,1503 @@
-// // Copyright 2013, Ji Zhang, Carnegie Mellon University
-// // Further contributions copyright (c) 2016, Southwest Research Institute
-// // All rights reserved.
-// //
-// // Redistribution and use in source and binary forms, with or without
-// // modification, are permitted provided that the following conditions are met:
-// //
-// // 1. Redistributions of source code must retain the above copyright notice,
-// //    this list of conditions and the following disclaimer.
-// // 2. Redistributions in binary form must reproduce the above copyright notice,
-// //    this list of conditions and the following disclaimer in the documentation
-// //    and/or other materials provided with the distribution.
-// // 3. Neither the name of the copyright holder nor the names of its
-// //    contributors may be used to endorse or promote products derived from this
-// //    software without specific prior written permission.
-// //
-// // THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-// // AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-// // IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-// // ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
-// // LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-// // CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-// // SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-// // INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-// // CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-// // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-// // POSSIBILITY OF SUCH DAMAGE.
-// //
-// // This is an implementation of the algorithm described in the following paper:
-// //   J. Zhang and S. Singh. LOAM: Lidar Odometry and Mapping in Real-time.
-// //     Robotics: Science and Systems Conference (RSS). Berkeley, CA, July 2014.
-// //   T. Shan and B. Englot. LeGO-LOAM: Lightweight and Ground-Optimized Lidar Odometry and Mapping on Variable Terrain
-// //      IEEE/RSJ International Conference on Intelligent Robots and Systems (IROS). October 2018.
-// #include "../include/utility.h"
-
-// #include <gtsam/geometry/Pose3.h>
-// #include <gtsam/geometry/Rot3.h>
-// #include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
-// #include <gtsam/nonlinear/Marginals.h>
-// #include <gtsam/nonlinear/NonlinearFactorGraph.h>
-// #include <gtsam/nonlinear/Values.h>
-// #include <gtsam/slam/BetweenFactor.h>
-// #include <gtsam/slam/PriorFactor.h>
-
-// #include <gtsam/nonlinear/ISAM2.h>
-
-// using namespace gtsam;
-
-// class mapOptimization
-// {
-// private:
-//   NonlinearFactorGraph gtSAMgraph;
-//   Values initialEstimate;
-//   Values optimizedEstimate;
-//   ISAM2* isam;
-//   Values isamCurrentEstimate;
-
-//   noiseModel::Diagonal::shared_ptr priorNoise;
-//   noiseModel::Diagonal::shared_ptr odometryNoise;
-//   noiseModel::Diagonal::shared_ptr constraintNoise;
-
-//   ros::NodeHandle nh;
-
-//   ros::Publisher pubLaserCloudSurround;
-//   ros::Publisher pubOdomAftMapped;
-//   ros::Publisher pubKeyPoses;
-
-//   ros::Publisher pubHistoryKeyFrames;
-//   ros::Publisher pubIcpKeyFrames;
-//   ros::Publisher pubRecentKeyFrames;
-
-//   ros::Subscriber subLaserCloudCornerLast;
-//   ros::Subscriber subLaserCloudSurfLast;
-//   ros::Subscriber subOutlierCloudLast;
-//   ros::Subscriber subLaserOdometry;
-//   ros::Subscriber subImu;
-
-//   nav_msgs::Odometry odomAftMapped;
-//   tf::StampedTransform aftMappedTrans;
-//   tf::TransformBroadcaster tfBroadcaster;
-
-//   vector<pcl::PointCloud<PointType>::Ptr> cornerCloudKeyFrames;
-//   vector<pcl::PointCloud<PointType>::Ptr> surfCloudKeyFrames;
-//   vector<pcl::PointCloud<PointType>::Ptr> outlierCloudKeyFrames;
-
-//   deque<pcl::PointCloud<PointType>::Ptr> recentCornerCloudKeyFrames;
-//   deque<pcl::PointCloud<PointType>::Ptr> recentSurfCloudKeyFrames;
-//   deque<pcl::PointCloud<PointType>::Ptr> recentOutlierCloudKeyFrames;
-//   int latestFrameID;
-
-//   vector<int> surroundingExistingKeyPosesID;
-//   deque<pcl::PointCloud<PointType>::Ptr> surroundingCornerCloudKeyFrames;
-//   deque<pcl::PointCloud<PointType>::Ptr> surroundingSurfCloudKeyFrames;
-//   deque<pcl::PointCloud<PointType>::Ptr> surroundingOutlierCloudKeyFrames;
-
-//   PointType previousRobotPosPoint;
-//   PointType currentRobotPosPoint;
-
-//   pcl::PointCloud<PointType>::Ptr cloudKeyPoses3D;
-//   pcl::PointCloud<PointTypePose>::Ptr cloudKeyPoses6D;
-
-//   pcl::PointCloud<PointType>::Ptr surroundingKeyPoses;
-//   pcl::PointCloud<PointType>::Ptr surroundingKeyPosesDS;
-
-//   pcl::PointCloud<PointType>::Ptr laserCloudCornerLast;    // corner feature set from odoOptimization
-//   pcl::PointCloud<PointType>::Ptr laserCloudSurfLast;      // surf feature set from odoOptimization
-//   pcl::PointCloud<PointType>::Ptr laserCloudCornerLastDS;  // downsampled corner featuer set from odoOptimization
-//   pcl::PointCloud<PointType>::Ptr laserCloudSurfLastDS;    // downsampled surf featuer set from odoOptimization
-
-//   pcl::PointCloud<PointType>::Ptr laserCloudOutlierLast;    // corner feature set from odoOptimization
-//   pcl::PointCloud<PointType>::Ptr laserCloudOutlierLastDS;  // corner feature set from odoOptimization
-
-//   pcl::PointCloud<PointType>::Ptr laserCloudSurfTotalLast;    // surf feature set from odoOptimization
-//   pcl::PointCloud<PointType>::Ptr laserCloudSurfTotalLastDS;  // downsampled corner featuer set from odoOptimization
-
-//   pcl::PointCloud<PointType>::Ptr laserCloudOri;
-//   pcl::PointCloud<PointType>::Ptr coeffSel;
-
-//   pcl::PointCloud<PointType>::Ptr laserCloudCornerFromMap;
-//   pcl::PointCloud<PointType>::Ptr laserCloudSurfFromMap;
-//   pcl::PointCloud<PointType>::Ptr laserCloudCornerFromMapDS;
-//   pcl::PointCloud<PointType>::Ptr laserCloudSurfFromMapDS;
-
-//   pcl::KdTreeFLANN<PointType>::Ptr kdtreeCornerFromMap;
-//   pcl::KdTreeFLANN<PointType>::Ptr kdtreeSurfFromMap;
-
-//   pcl::KdTreeFLANN<PointType>::Ptr kdtreeSurroundingKeyPoses;
-//   pcl::KdTreeFLANN<PointType>::Ptr kdtreeHistoryKeyPoses;
-
-//   pcl::PointCloud<PointType>::Ptr nearHistoryCornerKeyFrameCloud;
-//   pcl::PointCloud<PointType>::Ptr nearHistoryCornerKeyFrameCloudDS;
-//   pcl::PointCloud<PointType>::Ptr nearHistorySurfKeyFrameCloud;
-//   pcl::PointCloud<PointType>::Ptr nearHistorySurfKeyFrameCloudDS;
-
-//   pcl::PointCloud<PointType>::Ptr latestCornerKeyFrameCloud;
-//   pcl::PointCloud<PointType>::Ptr latestSurfKeyFrameCloud;
-//   pcl::PointCloud<PointType>::Ptr latestSurfKeyFrameCloudDS;
-
-//   pcl::KdTreeFLANN<PointType>::Ptr kdtreeGlobalMap;
-//   pcl::PointCloud<PointType>::Ptr globalMapKeyPoses;
-//   pcl::PointCloud<PointType>::Ptr globalMapKeyPosesDS;
-//   pcl::PointCloud<PointType>::Ptr globalMapKeyFrames;
-//   pcl::PointCloud<PointType>::Ptr globalMapKeyFramesDS;
-
-//   std::vector<int> pointSearchInd;
-//   std::vector<float> pointSearchSqDis;
-
-//   pcl::VoxelGrid<PointType> downSizeFilterCorner;
-//   pcl::VoxelGrid<PointType> downSizeFilterSurf;
-//   pcl::VoxelGrid<PointType> downSizeFilterOutlier;
-//   pcl::VoxelGrid<PointType> downSizeFilterHistoryKeyFrames;     // for histor key frames of loop closure
-//   pcl::VoxelGrid<PointType> downSizeFilterSurroundingKeyPoses;  // for surrounding key poses of scan-to-map optimization
-//   pcl::VoxelGrid<PointType> downSizeFilterGlobalMapKeyPoses;    // for global map visualization
-//   pcl::VoxelGrid<PointType> downSizeFilterGlobalMapKeyFrames;   // for global map visualization
-
-//   double timeLaserCloudCornerLast;
-//   double timeLaserCloudSurfLast;
-//   double timeLaserOdometry;
-//   double timeLaserCloudOutlierLast;
-//   double timeLastGloalMapPublish;
-
-//   bool newLaserCloudCornerLast;
-//   bool newLaserCloudSurfLast;
-//   bool newLaserOdometry;
-//   bool newLaserCloudOutlierLast;
-
-//   float transformLast[6];
-//   float transformSum[6];
-//   float transformIncre[6];
-//   float transformTobeMapped[6];
-//   float transformBefMapped[6];
-//   float transformAftMapped[6];
-
-//   int imuPointerFront;
-//   int imuPointerLast;
-
-//   double imuTime[imuQueLength];
-//   float imuRoll[imuQueLength];
-//   float imuPitch[imuQueLength];
-
-//   std::mutex mtx;
-
-//   double timeLastProcessing;
-
-//   PointType pointOri, pointSel, pointProj, coeff;
-
-//   cv::Mat matA0;
-//   cv::Mat matB0;
-//   cv::Mat matX0;
-
-//   cv::Mat matA1;
-//   cv::Mat matD1;
-//   cv::Mat matV1;
-
-//   bool isDegenerate;
-//   cv::Mat matP;
-
-//   int laserCloudCornerFromMapDSNum;
-//   int laserCloudSurfFromMapDSNum;
-//   int laserCloudCornerLastDSNum;
-//   int laserCloudSurfLastDSNum;
-//   int laserCloudOutlierLastDSNum;
-//   int laserCloudSurfTotalLastDSNum;
-
-//   bool potentialLoopFlag;
-//   double timeSaveFirstCurrentScanForLoopClosure;
-//   int closestHistoryFrameID;
-//   int latestFrameIDLoopCloure;
-
-//   bool aLoopIsClosed;
-
-//   float cRoll, sRoll, cPitch, sPitch, cYaw, sYaw, tX, tY, tZ;
-//   float ctRoll, stRoll, ctPitch, stPitch, ctYaw, stYaw, tInX, tInY, tInZ;
-
-// public:
-//   mapOptimization() : nh("~")
-//   {
-//     ISAM2Params parameters;
-//     parameters.relinearizeThreshold = 0.01;
-//     parameters.relinearizeSkip = 1;
-//     isam = new ISAM2(parameters);
-
-//     pubKeyPoses = nh.advertise<sensor_msgs::PointCloud2>("/key_pose_origin", 2);
-//     pubLaserCloudSurround = nh.advertise<sensor_msgs::PointCloud2>("/laser_cloud_surround", 2);
-//     pubOdomAftMapped = nh.advertise<nav_msgs::Odometry>("/aft_mapped_to_init", 5);
-
-//     subLaserCloudCornerLast = nh.subscribe<sensor_msgs::PointCloud2>(
-//         "/laser_cloud_corner_last", 2, &mapOptimization::laserCloudCornerLastHandler,
-//         this);  // 接收了 /laser_cloud_corner_last 这个消息,然后将它转换为关键帧
-//     subLaserCloudSurfLast = nh.subscribe<sensor_msgs::PointCloud2>("/laser_cloud_surf_last", 2,
-//                                                                    &mapOptimization::laserCloudSurfLastHandler, this);
-//     subOutlierCloudLast = nh.subscribe<sensor_msgs::PointCloud2>("/outlier_cloud_last", 2,
-//                                                                  &mapOptimization::laserCloudOutlierLastHandler, this);
-//     subLaserOdometry =
-//         nh.subscribe<nav_msgs::Odometry>("/laser_odom_to_init", 5, &mapOptimization::laserOdometryHandler, this);
-//     subImu = nh.subscribe<sensor_msgs::Imu>(imuTopic, 50, &mapOptimization::imuHandler, this);
-
-//     pubHistoryKeyFrames = nh.advertise<sensor_msgs::PointCloud2>("/history_cloud", 2);
-//     pubIcpKeyFrames = nh.advertise<sensor_msgs::PointCloud2>("/corrected_cloud", 2);
-//     pubRecentKeyFrames = nh.advertise<sensor_msgs::PointCloud2>("/recent_cloud", 2);
-
-//     downSizeFilterCorner.setLeafSize(0.2, 0.2, 0.2);
-//     downSizeFilterSurf.setLeafSize(0.4, 0.4, 0.4);
-//     downSizeFilterOutlier.setLeafSize(0.4, 0.4, 0.4);
-
-//     downSizeFilterHistoryKeyFrames.setLeafSize(0.4, 0.4, 0.4);  // for histor key frames of loop closure
-//     downSizeFilterSurroundingKeyPoses.setLeafSize(1.0, 1.0,
-//                                                   1.0);  // for surrounding key poses of scan-to-map optimization
-
-//     downSizeFilterGlobalMapKeyPoses.setLeafSize(1.0, 1.0, 1.0);   // for global map visualization
-//     downSizeFilterGlobalMapKeyFrames.setLeafSize(0.4, 0.4, 0.4);  // for global map visualization
-
-//     odomAftMapped.header.frame_id = "/camera_init";
-//     odomAftMapped.child_frame_id = "/aft_mapped";
-
-//     aftMappedTrans.frame_id_ = "/camera_init";
-//     aftMappedTrans.child_frame_id_ = "/aft_mapped";
-
-//     allocateMemory();
-//   }
-
-//   void allocateMemory()
-//   {
-//     cloudKeyPoses3D.reset(new pcl::PointCloud<PointType>());
-//     cloudKeyPoses6D.reset(new pcl::PointCloud<PointTypePose>());
-
-//     kdtreeSurroundingKeyPoses.reset(new pcl::KdTreeFLANN<PointType>());
-//     kdtreeHistoryKeyPoses.reset(new pcl::KdTreeFLANN<PointType>());
-
-//     surroundingKeyPoses.reset(new pcl::PointCloud<PointType>());
-//     surroundingKeyPosesDS.reset(new pcl::PointCloud<PointType>());
-
-//     laserCloudCornerLast.reset(new pcl::PointCloud<PointType>());  // corner feature set from odoOptimization
-//     laserCloudSurfLast.reset(new pcl::PointCloud<PointType>());    // surf feature set from odoOptimization
-//     laserCloudCornerLastDS.reset(
-//         new pcl::PointCloud<PointType>());  // downsampled corner featuer set from odoOptimization
-//     laserCloudSurfLastDS.reset(new pcl::PointCloud<PointType>());   // downsampled surf featuer set from odoOptimization
-//     laserCloudOutlierLast.reset(new pcl::PointCloud<PointType>());  // corner feature set from odoOptimization
-//     laserCloudOutlierLastDS.reset(
-//         new pcl::PointCloud<PointType>());  // downsampled corner feature set from odoOptimization
-//     laserCloudSurfTotalLast.reset(new pcl::PointCloud<PointType>());  // surf feature set from odoOptimization
-//     laserCloudSurfTotalLastDS.reset(
-//         new pcl::PointCloud<PointType>());  // downsampled surf featuer set from odoOptimization
-
-//     laserCloudOri.reset(new pcl::PointCloud<PointType>());
-//     coeffSel.reset(new pcl::PointCloud<PointType>());
-
-//     laserCloudCornerFromMap.reset(new pcl::PointCloud<PointType>());
-//     laserCloudSurfFromMap.reset(new pcl::PointCloud<PointType>());
-//     laserCloudCornerFromMapDS.reset(new pcl::PointCloud<PointType>());
-//     laserCloudSurfFromMapDS.reset(new pcl::PointCloud<PointType>());
-
-//     kdtreeCornerFromMap.reset(new pcl::KdTreeFLANN<PointType>());
-//     kdtreeSurfFromMap.reset(new pcl::KdTreeFLANN<PointType>());
-
-//     nearHistoryCornerKeyFrameCloud.reset(new pcl::PointCloud<PointType>());
-//     nearHistoryCornerKeyFrameCloudDS.reset(new pcl::PointCloud<PointType>());
-//     nearHistorySurfKeyFrameCloud.reset(new pcl::PointCloud<PointType>());
-//     nearHistorySurfKeyFrameCloudDS.reset(new pcl::PointCloud<PointType>());
-
-//     latestCornerKeyFrameCloud.reset(new pcl::PointCloud<PointType>());
-//     latestSurfKeyFrameCloud.reset(new pcl::PointCloud<PointType>());
-//     latestSurfKeyFrameCloudDS.reset(new pcl::PointCloud<PointType>());
-
-//     kdtreeGlobalMap.reset(new pcl::KdTreeFLANN<PointType>());
-//     globalMapKeyPoses.reset(new pcl::PointCloud<PointType>());
-//     globalMapKeyPosesDS.reset(new pcl::PointCloud<PointType>());
-//     globalMapKeyFrames.reset(new pcl::PointCloud<PointType>());
-//     globalMapKeyFramesDS.reset(new pcl::PointCloud<PointType>());
-
-//     timeLaserCloudCornerLast = 0;
-//     timeLaserCloudSurfLast = 0;
-//     timeLaserOdometry = 0;
-//     timeLaserCloudOutlierLast = 0;
-//     timeLastGloalMapPublish = 0;
-
-//     timeLastProcessing = -1;
-
-//     newLaserCloudCornerLast = false;
-//     newLaserCloudSurfLast = false;
-
-//     newLaserOdometry = false;
-//     newLaserCloudOutlierLast = false;
-
-//     for (int i = 0; i < 6; ++i)
-//     {
-//       transformLast[i] = 0;
-//       transformSum[i] = 0;
-//       transformIncre[i] = 0;
-//       transformTobeMapped[i] = 0;
-//       transformBefMapped[i] = 0;
-//       transformAftMapped[i] = 0;
-//     }
-
-//     imuPointerFront = 0;
-//     imuPointerLast = -1;
-
-//     for (int i = 0; i < imuQueLength; ++i)
-//     {
-//       imuTime[i] = 0;
-//       imuRoll[i] = 0;
-//       imuPitch[i] = 0;
-//     }
-
-//     gtsam::Vector Vector6(6);
-//     Vector6 << 1e-6, 1e-6, 1e-6, 1e-8, 1e-8, 1e-6;
-//     priorNoise = noiseModel::Diagonal::Variances(Vector6);
-//     odometryNoise = noiseModel::Diagonal::Variances(Vector6);
-
-//     matA0 = cv::Mat(5, 3, CV_32F, cv::Scalar::all(0));
-//     matB0 = cv::Mat(5, 1, CV_32F, cv::Scalar::all(-1));
-//     matX0 = cv::Mat(3, 1, CV_32F, cv::Scalar::all(0));
-
-//     matA1 = cv::Mat(3, 3, CV_32F, cv::Scalar::all(0));
-//     matD1 = cv::Mat(1, 3, CV_32F, cv::Scalar::all(0));
-//     matV1 = cv::Mat(3, 3, CV_32F, cv::Scalar::all(0));
-
-//     isDegenerate = false;
-//     matP = cv::Mat(6, 6, CV_32F, cv::Scalar::all(0));
-
-//     laserCloudCornerFromMapDSNum = 0;
-//     laserCloudSurfFromMapDSNum = 0;
-//     laserCloudCornerLastDSNum = 0;
-//     laserCloudSurfLastDSNum = 0;
-//     laserCloudOutlierLastDSNum = 0;
-//     laserCloudSurfTotalLastDSNum = 0;
-
-//     potentialLoopFlag = false;
-//     aLoopIsClosed = false;
-
-//     latestFrameID = 0;
-//   }
-
-//   void transformAssociateToMap()
-//   {
-//     float x1 = cos(transformSum[1]) * (transformBefMapped[3] - transformSum[3]) -
-//                sin(transformSum[1]) * (transformBefMapped[5] - transformSum[5]);
-//     float y1 = transformBefMapped[4] - transformSum[4];
-//     float z1 = sin(transformSum[1]) * (transformBefMapped[3] - transformSum[3]) +
-//                cos(transformSum[1]) * (transformBefMapped[5] - transformSum[5]);
-
-//     float x2 = x1;
-//     float y2 = cos(transformSum[0]) * y1 + sin(transformSum[0]) * z1;
-//     float z2 = -sin(transformSum[0]) * y1 + cos(transformSum[0]) * z1;
-
-//     transformIncre[3] = cos(transformSum[2]) * x2 + sin(transformSum[2]) * y2;
-//     transformIncre[4] = -sin(transformSum[2]) * x2 + cos(transformSum[2]) * y2;
-//     transformIncre[5] = z2;
-
-//     float sbcx = sin(transformSum[0]);
-//     float cbcx = cos(transformSum[0]);
-//     float sbcy = sin(transformSum[1]);
-//     float cbcy = cos(transformSum[1]);
-//     float sbcz = sin(transformSum[2]);
-//     float cbcz = cos(transformSum[2]);
-
-//     float sblx = sin(transformBefMapped[0]);
-//     float cblx = cos(transformBefMapped[0]);
-//     float sbly = sin(transformBefMapped[1]);
-//     float cbly = cos(transformBefMapped[1]);
-//     float sblz = sin(transformBefMapped[2]);
-//     float cblz = cos(transformBefMapped[2]);
-
-//     float salx = sin(transformAftMapped[0]);
-//     float calx = cos(transformAftMapped[0]);
-//     float saly = sin(transformAftMapped[1]);
-//     float caly = cos(transformAftMapped[1]);
-//     float salz = sin(transformAftMapped[2]);
-//     float calz = cos(transformAftMapped[2]);
-
-//     float srx = -sbcx * (salx * sblx + calx * cblx * salz * sblz + calx * calz * cblx * cblz) -
-//                 cbcx * sbcy * (calx * calz * (cbly * sblz - cblz * sblx * sbly) -
-//                                calx * salz * (cbly * cblz + sblx * sbly * sblz) + cblx * salx * sbly) -
-//                 cbcx * cbcy * (calx * salz * (cblz * sbly - cbly * sblx * sblz) -
-//                                calx * calz * (sbly * sblz + cbly * cblz * sblx) + cblx * cbly * salx);
-//     transformTobeMapped[0] = -asin(srx);
-
-//     float srycrx = sbcx * (cblx * cblz * (caly * salz - calz * salx * saly) -
-//                            cblx * sblz * (caly * calz + salx * saly * salz) + calx * saly * sblx) -
-//                    cbcx * cbcy * ((caly * calz + salx * saly * salz) * (cblz * sbly - cbly * sblx * sblz) +
-//                                   (caly * salz - calz * salx * saly) * (sbly * sblz + cbly * cblz * sblx) -
-//                                   calx * cblx * cbly * saly) +
-//                    cbcx * sbcy * ((caly * calz + salx * saly * salz) * (cbly * cblz + sblx * sbly * sblz) +
-//                                   (caly * salz - calz * salx * saly) * (cbly * sblz - cblz * sblx * sbly) +
-//                                   calx * cblx * saly * sbly);
-//     float crycrx = sbcx * (cblx * sblz * (calz * saly - caly * salx * salz) -
-//                            cblx * cblz * (saly * salz + caly * calz * salx) + calx * caly * sblx) +
-//                    cbcx * cbcy * ((saly * salz + caly * calz * salx) * (sbly * sblz + cbly * cblz * sblx) +
-//                                   (calz * saly - caly * salx * salz) * (cblz * sbly - cbly * sblx * sblz) +
-//                                   calx * caly * cblx * cbly) -
-//                    cbcx * sbcy * ((saly * salz + caly * calz * salx) * (cbly * sblz - cblz * sblx * sbly) +
-//                                   (calz * saly - caly * salx * salz) * (cbly * cblz + sblx * sbly * sblz) -
-//                                   calx * caly * cblx * sbly);
-//     transformTobeMapped[1] = atan2(srycrx / cos(transformTobeMapped[0]), crycrx / cos(transformTobeMapped[0]));
-
-//     float srzcrx =
-//         (cbcz * sbcy - cbcy * sbcx * sbcz) * (calx * salz * (cblz * sbly - cbly * sblx * sblz) -
-//                                               calx * calz * (sbly * sblz + cbly * cblz * sblx) + cblx * cbly * salx) -
-//         (cbcy * cbcz + sbcx * sbcy * sbcz) * (calx * calz * (cbly * sblz - cblz * sblx * sbly) -
-//                                               calx * salz * (cbly * cblz + sblx * sbly * sblz) + cblx * salx * sbly) +
-//         cbcx * sbcz * (salx * sblx + calx * cblx * salz * sblz + calx * calz * cblx * cblz);
-//     float crzcrx =
-//         (cbcy * sbcz - cbcz * sbcx * sbcy) * (calx * calz * (cbly * sblz - cblz * sblx * sbly) -
-//                                               calx * salz * (cbly * cblz + sblx * sbly * sblz) + cblx * salx * sbly) -
-//         (sbcy * sbcz + cbcy * cbcz * sbcx) * (calx * salz * (cblz * sbly - cbly * sblx * sblz) -
-//                                               calx * calz * (sbly * sblz + cbly * cblz * sblx) + cblx * cbly * salx) +
-//         cbcx * cbcz * (salx * sblx + calx * cblx * salz * sblz + calx * calz * cblx * cblz);
-//     transformTobeMapped[2] = atan2(srzcrx / cos(transformTobeMapped[0]), crzcrx / cos(transformTobeMapped[0]));
-
-//     x1 = cos(transformTobeMapped[2]) * transformIncre[3] - sin(transformTobeMapped[2]) * transformIncre[4];
-//     y1 = sin(transformTobeMapped[2]) * transformIncre[3] + cos(transformTobeMapped[2]) * transformIncre[4];
-//     z1 = transformIncre[5];
-
-//     x2 = x1;
-//     y2 = cos(transformTobeMapped[0]) * y1 - sin(transformTobeMapped[0]) * z1;
-//     z2 = sin(transformTobeMapped[0]) * y1 + cos(transformTobeMapped[0]) * z1;
-
-//     transformTobeMapped[3] =
-//         transformAftMapped[3] - (cos(transformTobeMapped[1]) * x2 + sin(transformTobeMapped[1]) * z2);
-//     transformTobeMapped[4] = transformAftMapped[4] - y2;
-//     transformTobeMapped[5] =
-//         transformAftMapped[5] - (-sin(transformTobeMapped[1]) * x2 + cos(transformTobeMapped[1]) * z2);
-//   }
-
-//   void transformUpdate()
-//   {
-//     if (imuPointerLast >= 0)
-//     {
-//       float imuRollLast = 0, imuPitchLast = 0;
-//       while (imuPointerFront != imuPointerLast)
-//       {
-//         if (timeLaserOdometry + scanPeriod < imuTime[imuPointerFront])
-//         {
-//           break;
-//         }
-//         imuPointerFront = (imuPointerFront + 1) % imuQueLength;
-//       }
-
-//       if (timeLaserOdometry + scanPeriod > imuTime[imuPointerFront])
-//       {
-//         imuRollLast = imuRoll[imuPointerFront];
-//         imuPitchLast = imuPitch[imuPointerFront];
-//       }
-//       else
-//       {
-//         int imuPointerBack = (imuPointerFront + imuQueLength - 1) % imuQueLength;
-//         float ratioFront = (timeLaserOdometry + scanPeriod - imuTime[imuPointerBack]) /
-//                            (imuTime[imuPointerFront] - imuTime[imuPointerBack]);
-//         float ratioBack = (imuTime[imuPointerFront] - timeLaserOdometry - scanPeriod) /
-//                           (imuTime[imuPointerFront] - imuTime[imuPointerBack]);
-
-//         imuRollLast = imuRoll[imuPointerFront] * ratioFront + imuRoll[imuPointerBack] * ratioBack;
-//         imuPitchLast = imuPitch[imuPointerFront] * ratioFront + imuPitch[imuPointerBack] * ratioBack;
-//       }
-
-//       transformTobeMapped[0] = 0.998 * transformTobeMapped[0] + 0.002 * imuPitchLast;
-//       transformTobeMapped[2] = 0.998 * transformTobeMapped[2] + 0.002 * imuRollLast;
-//     }
-
-//     for (int i = 0; i < 6; i++)
-//     {
-//       transformBefMapped[i] = transformSum[i];
-//       transformAftMapped[i] = transformTobeMapped[i];
-//     }
-//   }
-
-//   void updatePointAssociateToMapSinCos()
-//   {
-//     cRoll = cos(transformTobeMapped[0]);
-//     sRoll = sin(transformTobeMapped[0]);
-
-//     cPitch = cos(transformTobeMapped[1]);
-//     sPitch = sin(transformTobeMapped[1]);
-
-//     cYaw = cos(transformTobeMapped[2]);
-//     sYaw = sin(transformTobeMapped[2]);
-
-//     tX = transformTobeMapped[3];
-//     tY = transformTobeMapped[4];
-//     tZ = transformTobeMapped[5];
-//   }
-
-//   void pointAssociateToMap(PointType const* const pi, PointType* const po)
-//   {
-//     float x1 = cYaw * pi->x - sYaw * pi->y;
-//     float y1 = sYaw * pi->x + cYaw * pi->y;
-//     float z1 = pi->z;
-
-//     float x2 = x1;
-//     float y2 = cRoll * y1 - sRoll * z1;
-//     float z2 = sRoll * y1 + cRoll * z1;
-
-//     po->x = cPitch * x2 + sPitch * z2 + tX;
-//     po->y = y2 + tY;
-//     po->z = -sPitch * x2 + cPitch * z2 + tZ;
-//     po->intensity = pi->intensity;
-//   }
-
-//   void updateTransformPointCloudSinCos(PointTypePose* tIn)
-//   {
-//     ctRoll = cos(tIn->roll);
-//     stRoll = sin(tIn->roll);
-
-//     ctPitch = cos(tIn->pitch);
-//     stPitch = sin(tIn->pitch);
-
-//     ctYaw = cos(tIn->yaw);
-//     stYaw = sin(tIn->yaw);
-
-//     tInX = tIn->x;
-//     tInY = tIn->y;
-//     tInZ = tIn->z;
-//   }
-
-//   pcl::PointCloud<PointType>::Ptr transformPointCloud(pcl::PointCloud<PointType>::Ptr cloudIn)
-//   {
-//     // !!! DO NOT use pcl for point cloud transformation, results are not accurate
-//     // Reason: unkown
-//     pcl::PointCloud<PointType>::Ptr cloudOut(new pcl::PointCloud<PointType>());
-
-//     PointType* pointFrom;
-//     PointType pointTo;
-
-//     int cloudSize = cloudIn->points.size();
-//     cloudOut->resize(cloudSize);
-
-//     for (int i = 0; i < cloudSize; ++i)
-//     {
-//       pointFrom = &cloudIn->points[i];
-//       float x1 = ctYaw * pointFrom->x - stYaw * pointFrom->y;
-//       float y1 = stYaw * pointFrom->x + ctYaw * pointFrom->y;
-//       float z1 = pointFrom->z;
-
-//       float x2 = x1;
-//       float y2 = ctRoll * y1 - stRoll * z1;
-//       float z2 = stRoll * y1 + ctRoll * z1;
-
-//       pointTo.x = ctPitch * x2 + stPitch * z2 + tInX;
-//       pointTo.y = y2 + tInY;
-//       pointTo.z = -stPitch * x2 + ctPitch * z2 + tInZ;
-//       pointTo.intensity = pointFrom->intensity;
-
-//       cloudOut->points[i] = pointTo;
-//     }
-//     return cloudOut;
-//   }
-
-//   pcl::PointCloud<PointType>::Ptr transformPointCloud(pcl::PointCloud<PointType>::Ptr cloudIn,
-//                                                       PointTypePose* transformIn)
-//   {
-//     pcl::PointCloud<PointType>::Ptr cloudOut(new pcl::PointCloud<PointType>());
-
-//     PointType* pointFrom;
-//     PointType pointTo;
-
-//     int cloudSize = cloudIn->points.size();
-//     cloudOut->resize(cloudSize);
-
-//     for (int i = 0; i < cloudSize; ++i)
-//     {
-//       pointFrom = &cloudIn->points[i];
-//       float x1 = cos(transformIn->yaw) * pointFrom->x - sin(transformIn->yaw) * pointFrom->y;
-//       float y1 = sin(transformIn->yaw) * pointFrom->x + cos(transformIn->yaw) * pointFrom->y;
-//       float z1 = pointFrom->z;
-
-//       float x2 = x1;
-//       float y2 = cos(transformIn->roll) * y1 - sin(transformIn->roll) * z1;
-//       float z2 = sin(transformIn->roll) * y1 + cos(transformIn->roll) * z1;
-
-//       pointTo.x = cos(transformIn->pitch) * x2 + sin(transformIn->pitch) * z2 + transformIn->x;
-//       pointTo.y = y2 + transformIn->y;
-//       pointTo.z = -sin(transformIn->pitch) * x2 + cos(transformIn->pitch) * z2 + transformIn->z;
-//       pointTo.intensity = pointFrom->intensity;
-
-//       cloudOut->points[i] = pointTo;
-//     }
-//     return cloudOut;
-//   }
-
-//   void laserCloudOutlierLastHandler(const sensor_msgs::PointCloud2ConstPtr& msg)
-//   {
-//     timeLaserCloudOutlierLast = msg->header.stamp.toSec();
-//     laserCloudOutlierLast->clear();
-//     pcl::fromROSMsg(*msg, *laserCloudOutlierLast);
-//     newLaserCloudOutlierLast = true;
-//   }
-
-//   void laserCloudCornerLastHandler(const sensor_msgs::PointCloud2ConstPtr& msg)
-//   {
-//     timeLaserCloudCornerLast = msg->header.stamp.toSec();
-//     laserCloudCornerLast->clear();
-//     pcl::fromROSMsg(*msg, *laserCloudCornerLast);  // 从msg copy来的关键帧
-//     newLaserCloudCornerLast = true;
-//   }
-
-//   void laserCloudSurfLastHandler(const sensor_msgs::PointCloud2ConstPtr& msg)
-//   {
-//     timeLaserCloudSurfLast = msg->header.stamp.toSec();
-//     laserCloudSurfLast->clear();
-//     pcl::fromROSMsg(*msg, *laserCloudSurfLast);
-//     newLaserCloudSurfLast = true;
-//   }
-
-//   void laserOdometryHandler(const nav_msgs::Odometry::ConstPtr& laserOdometry)
-//   {
-//     timeLaserOdometry = laserOdometry->header.stamp.toSec();
-//     double roll, pitch, yaw;
-//     geometry_msgs::Quaternion geoQuat = laserOdometry->pose.pose.orientation;
-//     tf::Matrix3x3(tf::Quaternion(geoQuat.z, -geoQuat.x, -geoQuat.y, geoQuat.w)).getRPY(roll, pitch, yaw);
-//     transformSum[0] = -pitch;
-//     transformSum[1] = -yaw;
-//     transformSum[2] = roll;
-//     transformSum[3] = laserOdometry->pose.pose.position.x;
-//     transformSum[4] = laserOdometry->pose.pose.position.y;
-//     transformSum[5] = laserOdometry->pose.pose.position.z;
-//     newLaserOdometry = true;
-//   }
-
-//   void imuHandler(const sensor_msgs::Imu::ConstPtr& imuIn)
-//   {
-//     double roll, pitch, yaw;
-//     tf::Quaternion orientation;
-//     tf::quaternionMsgToTF(imuIn->orientation, orientation);
-//     tf::Matrix3x3(orientation).getRPY(roll, pitch, yaw);
-//     imuPointerLast = (imuPointerLast + 1) % imuQueLength;
-//     imuTime[imuPointerLast] = imuIn->header.stamp.toSec();
-//     imuRoll[imuPointerLast] = roll;
-//     imuPitch[imuPointerLast] = pitch;
-//   }
-
-//   void publishTF()
-//   {
-//     geometry_msgs::Quaternion geoQuat =
-//         tf::createQuaternionMsgFromRollPitchYaw(transformAftMapped[2], -transformAftMapped[0], -transformAftMapped[1]);
-
-//     odomAftMapped.header.stamp = ros::Time().fromSec(timeLaserOdometry);
-//     odomAftMapped.pose.pose.orientation.x = -geoQuat.y;
-//     odomAftMapped.pose.pose.orientation.y = -geoQuat.z;
-//     odomAftMapped.pose.pose.orientation.z = geoQuat.x;
-//     odomAftMapped.pose.pose.orientation.w = geoQuat.w;
-//     odomAftMapped.pose.pose.position.x = transformAftMapped[3];
-//     odomAftMapped.pose.pose.position.y = transformAftMapped[4];
-//     odomAftMapped.pose.pose.position.z = transformAftMapped[5];
-//     odomAftMapped.twist.twist.angular.x = transformBefMapped[0];
-//     odomAftMapped.twist.twist.angular.y = transformBefMapped[1];
-//     odomAftMapped.twist.twist.angular.z = transformBefMapped[2];
-//     odomAftMapped.twist.twist.linear.x = transformBefMapped[3];
-//     odomAftMapped.twist.twist.linear.y = transformBefMapped[4];
-//     odomAftMapped.twist.twist.linear.z = transformBefMapped[5];
-//     pubOdomAftMapped.publish(odomAftMapped);
-
-//     aftMappedTrans.stamp_ = ros::Time().fromSec(timeLaserOdometry);
-//     aftMappedTrans.setRotation(tf::Quaternion(-geoQuat.y, -geoQuat.z, geoQuat.x, geoQuat.w));
-//     aftMappedTrans.setOrigin(tf::Vector3(transformAftMapped[3], transformAftMapped[4], transformAftMapped[5]));
-//     tfBroadcaster.sendTransform(aftMappedTrans);
-//   }
-
-//   void publishKeyPosesAndFrames()
-//   {
-//     if (pubKeyPoses.getNumSubscribers() != 0)
-//     {
-//       sensor_msgs::PointCloud2 cloudMsgTemp;
-//       pcl::toROSMsg(*cloudKeyPoses3D, cloudMsgTemp);
-//       cloudMsgTemp.header.stamp = ros::Time().fromSec(timeLaserOdometry);
-//       cloudMsgTemp.header.frame_id = "/camera_init";
-//       pubKeyPoses.publish(cloudMsgTemp);
-//     }
-
-//     if (pubRecentKeyFrames.getNumSubscribers() != 0)
-//     {
-//       sensor_msgs::PointCloud2 cloudMsgTemp;
-//       pcl::toROSMsg(*laserCloudSurfFromMapDS, cloudMsgTemp);
-//       cloudMsgTemp.header.stamp = ros::Time().fromSec(timeLaserOdometry);
-//       cloudMsgTemp.header.frame_id = "/camera_init";
-//       pubRecentKeyFrames.publish(cloudMsgTemp);
-//     }
-//   }
-
-//   void visualizeGlobalMapThread()
-//   {
-//     ros::Rate rate(0.2);
-//     while (ros::ok())
-//     {
-//       rate.sleep();
-//       publishGlobalMap();
-//     }
-//     // save final point cloud
-//     pcl::io::savePCDFileASCII(fileDirectory + "finalCloud.pcd", *globalMapKeyFramesDS);
-
-//     string cornerMapString = "/home/ads/data/TW/cornerMap.pcd";
-//     string surfaceMapString = "/home/ads/data/TW/surfaceMap.pcd";
-//     string trajectoryString = "/home/ads/data/TW/trajectory.pcd";
-
-//     pcl::PointCloud<PointType>::Ptr cornerMapCloud(new pcl::PointCloud<PointType>());
-//     pcl::PointCloud<PointType>::Ptr cornerMapCloudDS(new pcl::PointCloud<PointType>());
-//     pcl::PointCloud<PointType>::Ptr surfaceMapCloud(new pcl::PointCloud<PointType>());
-//     pcl::PointCloud<PointType>::Ptr surfaceMapCloudDS(new pcl::PointCloud<PointType>());
-
-//     for (int i = 0; i < cornerCloudKeyFrames.size(); i++)
-//     {
-//       *cornerMapCloud +=
-//           *transformPointCloud(cornerCloudKeyFrames[i], &cloudKeyPoses6D->points[i]);  // 把关键帧进行累加,保存
-//       *surfaceMapCloud += *transformPointCloud(surfCloudKeyFrames[i], &cloudKeyPoses6D->points[i]);
-//       *surfaceMapCloud += *transformPointCloud(outlierCloudKeyFrames[i], &cloudKeyPoses6D->points[i]);
-//     }
-
-//     downSizeFilterCorner.setInputCloud(cornerMapCloud);
-//     downSizeFilterCorner.filter(*cornerMapCloudDS);
-//     downSizeFilterSurf.setInputCloud(surfaceMapCloud);
-//     downSizeFilterSurf.filter(*surfaceMapCloudDS);
-
-//     pcl::io::savePCDFileASCII(fileDirectory + "cornerMap.pcd", *cornerMapCloudDS);  // 保存累计点云下采样后结果
-//     pcl::io::savePCDFileASCII(fileDirectory + "surfaceMap.pcd", *surfaceMapCloudDS);
-//     pcl::io::savePCDFileASCII(fileDirectory + "trajectory.pcd", *cloudKeyPoses3D);
-//   }
-
-//   void publishGlobalMap()
-//   {
-//     if (pubLaserCloudSurround.getNumSubscribers() == 0)
-//       return;
-
-//     if (cloudKeyPoses3D->points.empty() == true)
-//       return;
-//     // kd-tree to find near key frames to visualize
-//     std::vector<int> pointSearchIndGlobalMap;
-//     std::vector<float> pointSearchSqDisGlobalMap;
-//     // search near key frames to visualize
-//     mtx.lock();
-//     kdtreeGlobalMap->setInputCloud(cloudKeyPoses3D);
-//     kdtreeGlobalMap->radiusSearch(currentRobotPosPoint, globalMapVisualizationSearchRadius, pointSearchIndGlobalMap,
-//                                   pointSearchSqDisGlobalMap, 0);
-//     mtx.unlock();
-
-//     for (int i = 0; i < pointSearchIndGlobalMap.size(); ++i)
-//       globalMapKeyPoses->points.push_back(cloudKeyPoses3D->points[pointSearchIndGlobalMap[i]]);
-//     // downsample near selected key frames
-//     downSizeFilterGlobalMapKeyPoses.setInputCloud(globalMapKeyPoses);
-//     downSizeFilterGlobalMapKeyPoses.filter(*globalMapKeyPosesDS);
-//     // extract visualized and downsampled key frames
-//     for (int i = 0; i < globalMapKeyPosesDS->points.size(); ++i)
-//     {
-//       int thisKeyInd = (int)globalMapKeyPosesDS->points[i].intensity;
-//       *globalMapKeyFrames +=
-//           *transformPointCloud(cornerCloudKeyFrames[thisKeyInd], &cloudKeyPoses6D->points[thisKeyInd]);
-//       *globalMapKeyFrames += *transformPointCloud(surfCloudKeyFrames[thisKeyInd], &cloudKeyPoses6D->points[thisKeyInd]);
-//       *globalMapKeyFrames +=
-//           *transformPointCloud(outlierCloudKeyFrames[thisKeyInd], &cloudKeyPoses6D->points[thisKeyInd]);
-//     }
-//     // downsample visualized points
-//     downSizeFilterGlobalMapKeyFrames.setInputCloud(globalMapKeyFrames);
-//     downSizeFilterGlobalMapKeyFrames.filter(*globalMapKeyFramesDS);
-
-//     sensor_msgs::PointCloud2 cloudMsgTemp;
-//     pcl::toROSMsg(*globalMapKeyFramesDS, cloudMsgTemp);
-//     cloudMsgTemp.header.stamp = ros::Time().fromSec(timeLaserOdometry);
-//     cloudMsgTemp.header.frame_id = "/camera_init";
-//     pubLaserCloudSurround.publish(cloudMsgTemp);
-
-//     globalMapKeyPoses->clear();
-//     globalMapKeyPosesDS->clear();
-//     globalMapKeyFrames->clear();
-//     // globalMapKeyFramesDS->clear();
-//   }
-
-//   void loopClosureThread()
-//   {
-//     if (loopClosureEnableFlag == false)
-//       return;
-
-//     ros::Rate rate(1);
-//     while (ros::ok())
-//     {
-//       rate.sleep();
-//       performLoopClosure();
-//     }
-//   }
-
-//   bool detectLoopClosure()
-//   {
-//     latestSurfKeyFrameCloud->clear();
-//     nearHistorySurfKeyFrameCloud->clear();
-//     nearHistorySurfKeyFrameCloudDS->clear();
-
-//     std::lock_guard<std::mutex> lock(mtx);
-//     // find the closest history key frame
-//     std::vector<int> pointSearchIndLoop;
-//     std::vector<float> pointSearchSqDisLoop;
-//     kdtreeHistoryKeyPoses->setInputCloud(cloudKeyPoses3D);
-//     kdtreeHistoryKeyPoses->radiusSearch(currentRobotPosPoint, historyKeyframeSearchRadius, pointSearchIndLoop,
-//                                         pointSearchSqDisLoop, 0);
-
-//     closestHistoryFrameID = -1;
-//     for (int i = 0; i < pointSearchIndLoop.size(); ++i)
-//     {
-//       int id = pointSearchIndLoop[i];
-//       if (abs(cloudKeyPoses6D->points[id].time - timeLaserOdometry) > 30.0)
-//       {
-//         closestHistoryFrameID = id;
-//         break;
-//       }
-//     }
-//     if (closestHistoryFrameID == -1)
-//     {
-//       return false;
-//     }
-//     // save latest key frames
-//     latestFrameIDLoopCloure = cloudKeyPoses3D->points.size() - 1;
-//     *latestSurfKeyFrameCloud += *transformPointCloud(cornerCloudKeyFrames[latestFrameIDLoopCloure],
-//                                                      &cloudKeyPoses6D->points[latestFrameIDLoopCloure]);
-//     *latestSurfKeyFrameCloud += *transformPointCloud(surfCloudKeyFrames[latestFrameIDLoopCloure],
-//                                                      &cloudKeyPoses6D->points[latestFrameIDLoopCloure]);
-
-//     pcl::PointCloud<PointType>::Ptr hahaCloud(new pcl::PointCloud<PointType>());
-//     int cloudSize = latestSurfKeyFrameCloud->points.size();
-//     for (int i = 0; i < cloudSize; ++i)
-//     {
-//       if ((int)latestSurfKeyFrameCloud->points[i].intensity >= 0)
-//       {
-//         hahaCloud->push_back(latestSurfKeyFrameCloud->points[i]);
-//       }
-//     }
-//     latestSurfKeyFrameCloud->clear();
-//     *latestSurfKeyFrameCloud = *hahaCloud;
-//     // save history near key frames
-//     for (int j = -historyKeyframeSearchNum; j <= historyKeyframeSearchNum; ++j)
-//     {
-//       if (closestHistoryFrameID + j < 0 || closestHistoryFrameID + j > latestFrameIDLoopCloure)
-//         continue;
-//       *nearHistorySurfKeyFrameCloud += *transformPointCloud(cornerCloudKeyFrames[closestHistoryFrameID + j],
-//                                                             &cloudKeyPoses6D->points[closestHistoryFrameID + j]);
-//       *nearHistorySurfKeyFrameCloud += *transformPointCloud(surfCloudKeyFrames[closestHistoryFrameID + j],
-//                                                             &cloudKeyPoses6D->points[closestHistoryFrameID + j]);
-//     }
-
-//     downSizeFilterHistoryKeyFrames.setInputCloud(nearHistorySurfKeyFrameCloud);
-//     downSizeFilterHistoryKeyFrames.filter(*nearHistorySurfKeyFrameCloudDS);
-//     // publish history near key frames
-//     if (pubHistoryKeyFrames.getNumSubscribers() != 0)
-//     {
-//       sensor_msgs::PointCloud2 cloudMsgTemp;
-//       pcl::toROSMsg(*nearHistorySurfKeyFrameCloudDS, cloudMsgTemp);
-//       cloudMsgTemp.header.stamp = ros::Time().fromSec(timeLaserOdometry);
-//       cloudMsgTemp.header.frame_id = "/camera_init";
-//       pubHistoryKeyFrames.publish(cloudMsgTemp);
-//     }
-
-//     return true;
-//   }
-
-//   void performLoopClosure()
-//   {
-//     if (cloudKeyPoses3D->points.empty() == true)
-//       return;
-//     // try to find close key frame if there are any
-//     if (potentialLoopFlag == false)
-//     {
-//       if (detectLoopClosure() == true)
-//       {
-//         potentialLoopFlag = true;  // find some key frames that is old enough or close enough for loop closure
-//         timeSaveFirstCurrentScanForLoopClosure = timeLaserOdometry;
-//       }
-//       if (potentialLoopFlag == false)
-//         return;
-//     }
-//     // reset the flag first no matter icp successes or not
-//     potentialLoopFlag = false;
-//     // ICP Settings
-//     pcl::IterativeClosestPoint<PointType, PointType> icp;
-//     icp.setMaxCorrespondenceDistance(100);
-//     icp.setMaximumIterations(100);
-//     icp.setTransformationEpsilon(1e-6);
-//     icp.setEuclideanFitnessEpsilon(1e-6);
-//     icp.setRANSACIterations(0);
-//     // Align clouds
-//     icp.setInputSource(latestSurfKeyFrameCloud);
-//     icp.setInputTarget(nearHistorySurfKeyFrameCloudDS);
-//     pcl::PointCloud<PointType>::Ptr unused_result(new pcl::PointCloud<PointType>());
-//     icp.align(*unused_result);
-
-//     if (icp.hasConverged() == false || icp.getFitnessScore() > historyKeyframeFitnessScore)
-//       return;
-//     // publish corrected cloud
-//     if (pubIcpKeyFrames.getNumSubscribers() != 0)
-//     {
-//       pcl::PointCloud<PointType>::Ptr closed_cloud(new pcl::PointCloud<PointType>());
-//       pcl::transformPointCloud(*latestSurfKeyFrameCloud, *closed_cloud, icp.getFinalTransformation());
-//       sensor_msgs::PointCloud2 cloudMsgTemp;
-//       pcl::toROSMsg(*closed_cloud, cloudMsgTemp);
-//       cloudMsgTemp.header.stamp = ros::Time().fromSec(timeLaserOdometry);
-//       cloudMsgTemp.header.frame_id = "/camera_init";
-//       pubIcpKeyFrames.publish(cloudMsgTemp);
-//     }
-//     /*
-//         get pose constraint
-//         */
-//     float x, y, z, roll, pitch, yaw;
-//     Eigen::Affine3f correctionCameraFrame;
-//     correctionCameraFrame =
-//         icp.getFinalTransformation();  // get transformation in camera frame (because points are in camera frame)
-//     pcl::getTranslationAndEulerAngles(correctionCameraFrame, x, y, z, roll, pitch, yaw);
-//     Eigen::Affine3f correctionLidarFrame = pcl::getTransformation(z, x, y, yaw, roll, pitch);
-//     // transform from world origin to wrong pose
-//     Eigen::Affine3f tWrong = pclPointToAffine3fCameraToLidar(cloudKeyPoses6D->points[latestFrameIDLoopCloure]);
-//     // transform from world origin to corrected pose
-//     Eigen::Affine3f tCorrect =
-//         correctionLidarFrame * tWrong;  // pre-multiplying -> successive rotation about a fixed frame
-//     pcl::getTranslationAndEulerAngles(tCorrect, x, y, z, roll, pitch, yaw);
-//     gtsam::Pose3 poseFrom = Pose3(Rot3::RzRyRx(roll, pitch, yaw), Point3(x, y, z));
-//     gtsam::Pose3 poseTo = pclPointTogtsamPose3(cloudKeyPoses6D->points[closestHistoryFrameID]);
-//     gtsam::Vector Vector6(6);
-//     float noiseScore = icp.getFitnessScore();
-//     Vector6 << noiseScore, noiseScore, noiseScore, noiseScore, noiseScore, noiseScore;
-//     constraintNoise = noiseModel::Diagonal::Variances(Vector6);
-//     /*
-//         add constraints
-//         */
-//     std::lock_guard<std::mutex> lock(mtx);
-//     gtSAMgraph.add(BetweenFactor<Pose3>(latestFrameIDLoopCloure, closestHistoryFrameID, poseFrom.between(poseTo),
-//                                         constraintNoise));
-//     isam->update(gtSAMgraph);
-//     isam->update();
-//     gtSAMgraph.resize(0);
-
-//     aLoopIsClosed = true;
-//   }
-
-//   Pose3 pclPointTogtsamPose3(PointTypePose thisPoint)
-//   {  // camera frame to lidar frame
-//     return Pose3(Rot3::RzRyRx(double(thisPoint.yaw), double(thisPoint.roll), double(thisPoint.pitch)),
-//                  Point3(double(thisPoint.z), double(thisPoint.x), double(thisPoint.y)));
-//   }
-
-//   Eigen::Affine3f pclPointToAffine3fCameraToLidar(PointTypePose thisPoint)
-//   {  // camera frame to lidar frame
-//     return pcl::getTransformation(thisPoint.z, thisPoint.x, thisPoint.y, thisPoint.yaw, thisPoint.roll,
-//                                   thisPoint.pitch);
-//   }
-
-//   void extractSurroundingKeyFrames()
-//   {
-//     if (cloudKeyPoses3D->points.empty() == true)
-//       return;
-
-//     if (loopClosureEnableFlag == true)
-//     {
-//       // only use recent key poses for graph building
-//       if (recentCornerCloudKeyFrames.size() < surroundingKeyframeSearchNum)
-//       {  // queue is not full (the beginning of mapping or a loop is just closed)
-//         // clear recent key frames queue
-//         recentCornerCloudKeyFrames.clear();
-//         recentSurfCloudKeyFrames.clear();
-//         recentOutlierCloudKeyFrames.clear();
-//         int numPoses = cloudKeyPoses3D->points.size();
-//         for (int i = numPoses - 1; i >= 0; --i)
-//         {
-//           int thisKeyInd = (int)cloudKeyPoses3D->points[i].intensity;
-//           PointTypePose thisTransformation = cloudKeyPoses6D->points[thisKeyInd];
-//           updateTransformPointCloudSinCos(&thisTransformation);
-//           // extract surrounding map
-//           recentCornerCloudKeyFrames.push_front(transformPointCloud(cornerCloudKeyFrames[thisKeyInd]));
-//           recentSurfCloudKeyFrames.push_front(transformPointCloud(surfCloudKeyFrames[thisKeyInd]));
-//           recentOutlierCloudKeyFrames.push_front(transformPointCloud(outlierCloudKeyFrames[thisKeyInd]));
-//           if (recentCornerCloudKeyFrames.size() >= surroundingKeyframeSearchNum)
-//             break;
-//         }
-//       }
-//       else
-//       {  // queue is full, pop the oldest key frame and push the latest key frame
-//         if (latestFrameID != cloudKeyPoses3D->points.size() - 1)
-//         {  // if the robot is not moving, no need to update recent frames
-
-//           recentCornerCloudKeyFrames.pop_front();
-//           recentSurfCloudKeyFrames.pop_front();
-//           recentOutlierCloudKeyFrames.pop_front();
-//           // push latest scan to the end of queue
-//           latestFrameID = cloudKeyPoses3D->points.size() - 1;
-//           PointTypePose thisTransformation = cloudKeyPoses6D->points[latestFrameID];
-//           updateTransformPointCloudSinCos(&thisTransformation);
-//           recentCornerCloudKeyFrames.push_back(transformPointCloud(cornerCloudKeyFrames[latestFrameID]));
-//           recentSurfCloudKeyFrames.push_back(transformPointCloud(surfCloudKeyFrames[latestFrameID]));
-//           recentOutlierCloudKeyFrames.push_back(transformPointCloud(outlierCloudKeyFrames[latestFrameID]));
-//         }
-//       }
-
-//       for (int i = 0; i < recentCornerCloudKeyFrames.size(); ++i)
-//       {
-//         *laserCloudCornerFromMap += *recentCornerCloudKeyFrames[i];
-//         *laserCloudSurfFromMap += *recentSurfCloudKeyFrames[i];
-//         *laserCloudSurfFromMap += *recentOutlierCloudKeyFrames[i];
-//       }
-//     }
-//     else
-//     {
-//       surroundingKeyPoses->clear();
-//       surroundingKeyPosesDS->clear();
-//       // extract all the nearby key poses and downsample them
-//       kdtreeSurroundingKeyPoses->setInputCloud(cloudKeyPoses3D);
-//       kdtreeSurroundingKeyPoses->radiusSearch(currentRobotPosPoint, (double)surroundingKeyframeSearchRadius,
-//                                               pointSearchInd, pointSearchSqDis, 0);
-//       for (int i = 0; i < pointSearchInd.size(); ++i)
-//         surroundingKeyPoses->points.push_back(cloudKeyPoses3D->points[pointSearchInd[i]]);
-//       downSizeFilterSurroundingKeyPoses.setInputCloud(surroundingKeyPoses);
-//       downSizeFilterSurroundingKeyPoses.filter(*surroundingKeyPosesDS);
-//       // delete key frames that are not in surrounding region
-//       int numSurroundingPosesDS = surroundingKeyPosesDS->points.size();
-//       for (int i = 0; i < surroundingExistingKeyPosesID.size(); ++i)
-//       {
-//         bool existingFlag = false;
-//         for (int j = 0; j < numSurroundingPosesDS; ++j)
-//         {
-//           if (surroundingExistingKeyPosesID[i] == (int)surroundingKeyPosesDS->points[j].intensity)
-//           {
-//             existingFlag = true;
-//             break;
-//           }
-//         }
-//         if (existingFlag == false)
-//         {
-//           surroundingExistingKeyPosesID.erase(surroundingExistingKeyPosesID.begin() + i);
-//           surroundingCornerCloudKeyFrames.erase(surroundingCornerCloudKeyFrames.begin() + i);
-//           surroundingSurfCloudKeyFrames.erase(surroundingSurfCloudKeyFrames.begin() + i);
-//           surroundingOutlierCloudKeyFrames.erase(surroundingOutlierCloudKeyFrames.begin() + i);
-//           --i;
-//         }
-//       }
-//       // add new key frames that are not in calculated existing key frames
-//       for (int i = 0; i < numSurroundingPosesDS; ++i)
-//       {
-//         bool existingFlag = false;
-//         for (auto iter = surroundingExistingKeyPosesID.begin(); iter != surroundingExistingKeyPosesID.end(); ++iter)
-//         {
-//           if ((*iter) == (int)surroundingKeyPosesDS->points[i].intensity)
-//           {
-//             existingFlag = true;
-//             break;
-//           }
-//         }
-//         if (existingFlag == true)
-//         {
-//           continue;
-//         }
-//         else
-//         {
-//           int thisKeyInd = (int)surroundingKeyPosesDS->points[i].intensity;
-//           PointTypePose thisTransformation = cloudKeyPoses6D->points[thisKeyInd];
-//           updateTransformPointCloudSinCos(&thisTransformation);
-//           surroundingExistingKeyPosesID.push_back(thisKeyInd);
-//           surroundingCornerCloudKeyFrames.push_back(transformPointCloud(cornerCloudKeyFrames[thisKeyInd]));
-//           surroundingSurfCloudKeyFrames.push_back(transformPointCloud(surfCloudKeyFrames[thisKeyInd]));
-//           surroundingOutlierCloudKeyFrames.push_back(transformPointCloud(outlierCloudKeyFrames[thisKeyInd]));
-//         }
-//       }
-
-//       for (int i = 0; i < surroundingExistingKeyPosesID.size(); ++i)
-//       {
-//         *laserCloudCornerFromMap += *surroundingCornerCloudKeyFrames[i];
-//         *laserCloudSurfFromMap += *surroundingSurfCloudKeyFrames[i];
-//         *laserCloudSurfFromMap += *surroundingOutlierCloudKeyFrames[i];
-//       }
-//     }
-//     // Downsample the surrounding corner key frames (or map)
-//     downSizeFilterCorner.setInputCloud(laserCloudCornerFromMap);
-//     downSizeFilterCorner.filter(*laserCloudCornerFromMapDS);
-//     laserCloudCornerFromMapDSNum = laserCloudCornerFromMapDS->points.size();
-//     // Downsample the surrounding surf key frames (or map)
-//     downSizeFilterSurf.setInputCloud(laserCloudSurfFromMap);
-//     downSizeFilterSurf.filter(*laserCloudSurfFromMapDS);
-//     laserCloudSurfFromMapDSNum = laserCloudSurfFromMapDS->points.size();
-//   }
-
-//   void downsampleCurrentScan()
-//   {
-//     laserCloudCornerLastDS->clear();
-//     downSizeFilterCorner.setInputCloud(laserCloudCornerLast);  // 关键帧,下采样成laserCloudCornerLastDS
-//     downSizeFilterCorner.filter(*laserCloudCornerLastDS);
-//     laserCloudCornerLastDSNum = laserCloudCornerLastDS->points.size();
-
-//     laserCloudSurfLastDS->clear();
-//     downSizeFilterSurf.setInputCloud(laserCloudSurfLast);
-//     downSizeFilterSurf.filter(*laserCloudSurfLastDS);
-//     laserCloudSurfLastDSNum = laserCloudSurfLastDS->points.size();
-
-//     laserCloudOutlierLastDS->clear();
-//     downSizeFilterOutlier.setInputCloud(laserCloudOutlierLast);
-//     downSizeFilterOutlier.filter(*laserCloudOutlierLastDS);
-//     laserCloudOutlierLastDSNum = laserCloudOutlierLastDS->points.size();
-
-//     laserCloudSurfTotalLast->clear();
-//     laserCloudSurfTotalLastDS->clear();
-//     *laserCloudSurfTotalLast += *laserCloudSurfLastDS;
-//     *laserCloudSurfTotalLast += *laserCloudOutlierLastDS;
-//     downSizeFilterSurf.setInputCloud(laserCloudSurfTotalLast);
-//     downSizeFilterSurf.filter(*laserCloudSurfTotalLastDS);
-//     laserCloudSurfTotalLastDSNum = laserCloudSurfTotalLastDS->points.size();
-//   }
-
-//   void cornerOptimization(int iterCount)
-//   {
-//     updatePointAssociateToMapSinCos();
-//     for (int i = 0; i < laserCloudCornerLastDSNum; i++)
-//     {
-//       pointOri = laserCloudCornerLastDS->points[i];
-//       pointAssociateToMap(&pointOri, &pointSel);
-//       kdtreeCornerFromMap->nearestKSearch(pointSel, 5, pointSearchInd, pointSearchSqDis);
-
-//       if (pointSearchSqDis[4] < 1.0)
-//       {
-//         float cx = 0, cy = 0, cz = 0;
-//         for (int j = 0; j < 5; j++)
-//         {
-//           cx += laserCloudCornerFromMapDS->points[pointSearchInd[j]].x;
-//           cy += laserCloudCornerFromMapDS->points[pointSearchInd[j]].y;
-//           cz += laserCloudCornerFromMapDS->points[pointSearchInd[j]].z;
-//         }
-//         cx /= 5;
-//         cy /= 5;
-//         cz /= 5;
-
-//         float a11 = 0, a12 = 0, a13 = 0, a22 = 0, a23 = 0, a33 = 0;
-//         for (int j = 0; j < 5; j++)
-//         {
-//           float ax = laserCloudCornerFromMapDS->points[pointSearchInd[j]].x - cx;
-//           float ay = laserCloudCornerFromMapDS->points[pointSearchInd[j]].y - cy;
-//           float az = laserCloudCornerFromMapDS->points[pointSearchInd[j]].z - cz;
-
-//           a11 += ax * ax;
-//           a12 += ax * ay;
-//           a13 += ax * az;
-//           a22 += ay * ay;
-//           a23 += ay * az;
-//           a33 += az * az;
-//         }
-//         a11 /= 5;
-//         a12 /= 5;
-//         a13 /= 5;
-//         a22 /= 5;
-//         a23 /= 5;
-//         a33 /= 5;
-
-//         matA1.at<float>(0, 0) = a11;
-//         matA1.at<float>(0, 1) = a12;
-//         matA1.at<float>(0, 2) = a13;
-//         matA1.at<float>(1, 0) = a12;
-//         matA1.at<float>(1, 1) = a22;
-//         matA1.at<float>(1, 2) = a23;
-//         matA1.at<float>(2, 0) = a13;
-//         matA1.at<float>(2, 1) = a23;
-//         matA1.at<float>(2, 2) = a33;
-
-//         cv::eigen(matA1, matD1, matV1);
-
-//         if (matD1.at<float>(0, 0) > 3 * matD1.at<float>(0, 1))
-//         {
-//           float x0 = pointSel.x;
-//           float y0 = pointSel.y;
-//           float z0 = pointSel.z;
-//           float x1 = cx + 0.1 * matV1.at<float>(0, 0);
-//           float y1 = cy + 0.1 * matV1.at<float>(0, 1);
-//           float z1 = cz + 0.1 * matV1.at<float>(0, 2);
-//           float x2 = cx - 0.1 * matV1.at<float>(0, 0);
-//           float y2 = cy - 0.1 * matV1.at<float>(0, 1);
-//           float z2 = cz - 0.1 * matV1.at<float>(0, 2);
-
-//           float a012 =
-//               sqrt(((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) +
-//                    ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) +
-//                    ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1)) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1)));
-
-//           float l12 = sqrt((x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2) + (z1 - z2) * (z1 - z2));
-
-//           float la = ((y1 - y2) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) +
-//                       (z1 - z2) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1))) /
-//                      a012 / l12;
-
-//           float lb = -((x1 - x2) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) -
-//                        (z1 - z2) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1))) /
-//                      a012 / l12;
-
-//           float lc = -((x1 - x2) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) +
-//                        (y1 - y2) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1))) /
-//                      a012 / l12;
-
-//           float ld2 = a012 / l12;
-
-//           float s = 1 - 0.9 * fabs(ld2);
-
-//           coeff.x = s * la;
-//           coeff.y = s * lb;
-//           coeff.z = s * lc;
-//           coeff.intensity = s * ld2;
-
-//           if (s > 0.1)
-//           {
-//             laserCloudOri->push_back(pointOri);
-//             coeffSel->push_back(coeff);
-//           }
-//         }
-//       }
-//     }
-//   }
-
-//   void surfOptimization(int iterCount)
-//   {
-//     updatePointAssociateToMapSinCos();
-//     for (int i = 0; i < laserCloudSurfTotalLastDSNum; i++)
-//     {
-//       pointOri = laserCloudSurfTotalLastDS->points[i];
-//       pointAssociateToMap(&pointOri, &pointSel);
-//       kdtreeSurfFromMap->nearestKSearch(pointSel, 5, pointSearchInd, pointSearchSqDis);
-
-//       if (pointSearchSqDis[4] < 1.0)
-//       {
-//         for (int j = 0; j < 5; j++)
-//         {
-//           matA0.at<float>(j, 0) = laserCloudSurfFromMapDS->points[pointSearchInd[j]].x;
-//           matA0.at<float>(j, 1) = laserCloudSurfFromMapDS->points[pointSearchInd[j]].y;
-//           matA0.at<float>(j, 2) = laserCloudSurfFromMapDS->points[pointSearchInd[j]].z;
-//         }
-//         cv::solve(matA0, matB0, matX0, cv::DECOMP_QR);
-
-//         float pa = matX0.at<float>(0, 0);
-//         float pb = matX0.at<float>(1, 0);
-//         float pc = matX0.at<float>(2, 0);
-//         float pd = 1;
-
-//         float ps = sqrt(pa * pa + pb * pb + pc * pc);
-//         pa /= ps;
-//         pb /= ps;
-//         pc /= ps;
-//         pd /= ps;
-
-//         bool planeValid = true;
-//         for (int j = 0; j < 5; j++)
-//         {
-//           if (fabs(pa * laserCloudSurfFromMapDS->points[pointSearchInd[j]].x +
-//                    pb * laserCloudSurfFromMapDS->points[pointSearchInd[j]].y +
-//                    pc * laserCloudSurfFromMapDS->points[pointSearchInd[j]].z + pd) > 0.2)
-//           {
-//             planeValid = false;
-//             break;
-//           }
-//         }
-
-//         if (planeValid)
-//         {
-//           float pd2 = pa * pointSel.x + pb * pointSel.y + pc * pointSel.z + pd;
-
-//           float s =
-//               1 -
-//               0.9 * fabs(pd2) / sqrt(sqrt(pointSel.x * pointSel.x + pointSel.y * pointSel.y + pointSel.z * pointSel.z));
-
-//           coeff.x = s * pa;
-//           coeff.y = s * pb;
-//           coeff.z = s * pc;
-//           coeff.intensity = s * pd2;
-
-//           if (s > 0.1)
-//           {
-//             laserCloudOri->push_back(pointOri);
-//             coeffSel->push_back(coeff);
-//           }
-//         }
-//       }
-//     }
-//   }
-
-//   bool LMOptimization(int iterCount)
-//   {
-//     float srx = sin(transformTobeMapped[0]);
-//     float crx = cos(transformTobeMapped[0]);
-//     float sry = sin(transformTobeMapped[1]);
-//     float cry = cos(transformTobeMapped[1]);
-//     float srz = sin(transformTobeMapped[2]);
-//     float crz = cos(transformTobeMapped[2]);
-
-//     int laserCloudSelNum = laserCloudOri->points.size();
-//     if (laserCloudSelNum < 50)
-//     {
-//       return false;
-//     }
-
-//     cv::Mat matA(laserCloudSelNum, 6, CV_32F, cv::Scalar::all(0));
-//     cv::Mat matAt(6, laserCloudSelNum, CV_32F, cv::Scalar::all(0));
-//     cv::Mat matAtA(6, 6, CV_32F, cv::Scalar::all(0));
-//     cv::Mat matB(laserCloudSelNum, 1, CV_32F, cv::Scalar::all(0));
-//     cv::Mat matAtB(6, 1, CV_32F, cv::Scalar::all(0));
-//     cv::Mat matX(6, 1, CV_32F, cv::Scalar::all(0));
-//     for (int i = 0; i < laserCloudSelNum; i++)
-//     {
-//       pointOri = laserCloudOri->points[i];
-//       coeff = coeffSel->points[i];
-
-//       float arx = (crx * sry * srz * pointOri.x + crx * crz * sry * pointOri.y - srx * sry * pointOri.z) * coeff.x +
-//                   (-srx * srz * pointOri.x - crz * srx * pointOri.y - crx * pointOri.z) * coeff.y +
-//                   (crx * cry * srz * pointOri.x + crx * cry * crz * pointOri.y - cry * srx * pointOri.z) * coeff.z;
-
-//       float ary = ((cry * srx * srz - crz * sry) * pointOri.x + (sry * srz + cry * crz * srx) * pointOri.y +
-//                    crx * cry * pointOri.z) *
-//                       coeff.x +
-//                   ((-cry * crz - srx * sry * srz) * pointOri.x + (cry * srz - crz * srx * sry) * pointOri.y -
-//                    crx * sry * pointOri.z) *
-//                       coeff.z;
-
-//       float arz = ((crz * srx * sry - cry * srz) * pointOri.x + (-cry * crz - srx * sry * srz) * pointOri.y) * coeff.x +
-//                   (crx * crz * pointOri.x - crx * srz * pointOri.y) * coeff.y +
-//                   ((sry * srz + cry * crz * srx) * pointOri.x + (crz * sry - cry * srx * srz) * pointOri.y) * coeff.z;
-
-//       matA.at<float>(i, 0) = arx;
-//       matA.at<float>(i, 1) = ary;
-//       matA.at<float>(i, 2) = arz;
-//       matA.at<float>(i, 3) = coeff.x;
-//       matA.at<float>(i, 4) = coeff.y;
-//       matA.at<float>(i, 5) = coeff.z;
-//       matB.at<float>(i, 0) = -coeff.intensity;
-//     }
-//     cv::transpose(matA, matAt);
-//     matAtA = matAt * matA;
-//     matAtB = matAt * matB;
-//     cv::solve(matAtA, matAtB, matX, cv::DECOMP_QR);
-
-//     if (iterCount == 0)
-//     {
-//       cv::Mat matE(1, 6, CV_32F, cv::Scalar::all(0));
-//       cv::Mat matV(6, 6, CV_32F, cv::Scalar::all(0));
-//       cv::Mat matV2(6, 6, CV_32F, cv::Scalar::all(0));
-
-//       cv::eigen(matAtA, matE, matV);
-//       matV.copyTo(matV2);
-
-//       isDegenerate = false;
-//       float eignThre[6] = { 100, 100, 100, 100, 100, 100 };
-//       for (int i = 5; i >= 0; i--)
-//       {
-//         if (matE.at<float>(0, i) < eignThre[i])
-//         {
-//           for (int j = 0; j < 6; j++)
-//           {
-//             matV2.at<float>(i, j) = 0;
-//           }
-//           isDegenerate = true;
-//         }
-//         else
-//         {
-//           break;
-//         }
-//       }
-//       matP = matV.inv() * matV2;
-//     }
-
-//     if (isDegenerate)
-//     {
-//       cv::Mat matX2(6, 1, CV_32F, cv::Scalar::all(0));
-//       matX.copyTo(matX2);
-//       matX = matP * matX2;
-//     }
-
-//     transformTobeMapped[0] += matX.at<float>(0, 0);
-//     transformTobeMapped[1] += matX.at<float>(1, 0);
-//     transformTobeMapped[2] += matX.at<float>(2, 0);
-//     transformTobeMapped[3] += matX.at<float>(3, 0);
-//     transformTobeMapped[4] += matX.at<float>(4, 0);
-//     transformTobeMapped[5] += matX.at<float>(5, 0);
-
-//     float deltaR = sqrt(pow(pcl::rad2deg(matX.at<float>(0, 0)), 2) + pow(pcl::rad2deg(matX.at<float>(1, 0)), 2) +
-//                         pow(pcl::rad2deg(matX.at<float>(2, 0)), 2));
-//     float deltaT = sqrt(pow(matX.at<float>(3, 0) * 100, 2) + pow(matX.at<float>(4, 0) * 100, 2) +
-//                         pow(matX.at<float>(5, 0) * 100, 2));
-
-//     if (deltaR < 0.05 && deltaT < 0.05)
-//     {
-//       return true;
-//     }
-//     return false;
-//   }
-
-//   void scan2MapOptimization()
-//   {
-//     if (laserCloudCornerFromMapDSNum > 10 && laserCloudSurfFromMapDSNum > 100)
-//     {
-//       kdtreeCornerFromMap->setInputCloud(laserCloudCornerFromMapDS);
-//       kdtreeSurfFromMap->setInputCloud(laserCloudSurfFromMapDS);
-
-//       for (int iterCount = 0; iterCount < 10; iterCount++)
-//       {
-//         laserCloudOri->clear();
-//         coeffSel->clear();
-
-//         cornerOptimization(iterCount);
-//         surfOptimization(iterCount);
-
-//         if (LMOptimization(iterCount) == true)
-//           break;
-//       }
-
-//       transformUpdate();
-//     }
-//   }
-
-//   void saveKeyFramesAndFactor()
-//   {
-//     currentRobotPosPoint.x = transformAftMapped[3];
-//     currentRobotPosPoint.y = transformAftMapped[4];
-//     currentRobotPosPoint.z = transformAftMapped[5];
-
-//     bool saveThisKeyFrame = true;
-//     if (sqrt((previousRobotPosPoint.x - currentRobotPosPoint.x) * (previousRobotPosPoint.x - currentRobotPosPoint.x) +
-//              (previousRobotPosPoint.y - currentRobotPosPoint.y) * (previousRobotPosPoint.y - currentRobotPosPoint.y) +
-//              (previousRobotPosPoint.z - currentRobotPosPoint.z) * (previousRobotPosPoint.z - currentRobotPosPoint.z)) <
-//         0.3)
-//     {
-//       saveThisKeyFrame = false;
-//     }
-
-//     if (saveThisKeyFrame == false && !cloudKeyPoses3D->points.empty())
-//       return;
-
-//     previousRobotPosPoint = currentRobotPosPoint;
-//     /**
-//      * update grsam graph
-//      */
-//     if (cloudKeyPoses3D->points.empty())
-//     {
-//       gtSAMgraph.add(PriorFactor<Pose3>(
-//           0, Pose3(Rot3::RzRyRx(transformTobeMapped[2], transformTobeMapped[0], transformTobeMapped[1]),
-//                    Point3(transformTobeMapped[5], transformTobeMapped[3], transformTobeMapped[4])),
-//           priorNoise));
-//       initialEstimate.insert(0,
-//                              Pose3(Rot3::RzRyRx(transformTobeMapped[2], transformTobeMapped[0], transformTobeMapped[1]),
-//                                    Point3(transformTobeMapped[5], transformTobeMapped[3], transformTobeMapped[4])));
-//       for (int i = 0; i < 6; ++i)
-//         transformLast[i] = transformTobeMapped[i];
-//     }
-//     else
-//     {
-//       gtsam::Pose3 poseFrom = Pose3(Rot3::RzRyRx(transformLast[2], transformLast[0], transformLast[1]),
-//                                     Point3(transformLast[5], transformLast[3], transformLast[4]));
-//       gtsam::Pose3 poseTo = Pose3(Rot3::RzRyRx(transformAftMapped[2], transformAftMapped[0], transformAftMapped[1]),
-//                                   Point3(transformAftMapped[5], transformAftMapped[3], transformAftMapped[4]));
-//       gtSAMgraph.add(BetweenFactor<Pose3>(cloudKeyPoses3D->points.size() - 1, cloudKeyPoses3D->points.size(),
-//                                           poseFrom.between(poseTo), odometryNoise));
-//       initialEstimate.insert(cloudKeyPoses3D->points.size(),
-//                              Pose3(Rot3::RzRyRx(transformAftMapped[2], transformAftMapped[0], transformAftMapped[1]),
-//                                    Point3(transformAftMapped[5], transformAftMapped[3], transformAftMapped[4])));
-//     }
-//     /**
-//      * update iSAM
-//      */
-//     isam->update(gtSAMgraph, initialEstimate);
-//     isam->update();
-
-//     gtSAMgraph.resize(0);
-//     initialEstimate.clear();
-
-//     /**
-//      * save key poses
-//      */
-//     PointType thisPose3D;
-//     PointTypePose thisPose6D;
-//     Pose3 latestEstimate;
-
-//     isamCurrentEstimate = isam->calculateEstimate();
-//     latestEstimate = isamCurrentEstimate.at<Pose3>(isamCurrentEstimate.size() - 1);
-
-//     thisPose3D.x = latestEstimate.translation().y();
-//     thisPose3D.y = latestEstimate.translation().z();
-//     thisPose3D.z = latestEstimate.translation().x();
-//     thisPose3D.intensity = cloudKeyPoses3D->points.size();  // this can be used as index
-//     cloudKeyPoses3D->push_back(thisPose3D);
-
-//     thisPose6D.x = thisPose3D.x;
-//     thisPose6D.y = thisPose3D.y;
-//     thisPose6D.z = thisPose3D.z;
-//     thisPose6D.intensity = thisPose3D.intensity;  // this can be used as index
-//     thisPose6D.roll = latestEstimate.rotation().pitch();
-//     thisPose6D.pitch = latestEstimate.rotation().yaw();
-//     thisPose6D.yaw = latestEstimate.rotation().roll();  // in camera frame
-//     thisPose6D.time = timeLaserOdometry;
-//     cloudKeyPoses6D->push_back(thisPose6D);
-//     /**
-//      * save updated transform
-//      */
-//     if (cloudKeyPoses3D->points.size() > 1)
-//     {
-//       transformAftMapped[0] = latestEstimate.rotation().pitch();
-//       transformAftMapped[1] = latestEstimate.rotation().yaw();
-//       transformAftMapped[2] = latestEstimate.rotation().roll();
-//       transformAftMapped[3] = latestEstimate.translation().y();
-//       transformAftMapped[4] = latestEstimate.translation().z();
-//       transformAftMapped[5] = latestEstimate.translation().x();
-
-//       for (int i = 0; i < 6; ++i)
-//       {
-//         transformLast[i] = transformAftMapped[i];
-//         transformTobeMapped[i] = transformAftMapped[i];
-//       }
-//     }
-
-//     pcl::PointCloud<PointType>::Ptr thisCornerKeyFrame(new pcl::PointCloud<PointType>());
-//     pcl::PointCloud<PointType>::Ptr thisSurfKeyFrame(new pcl::PointCloud<PointType>());
-//     pcl::PointCloud<PointType>::Ptr thisOutlierKeyFrame(new pcl::PointCloud<PointType>());
-
-//     pcl::copyPointCloud(*laserCloudCornerLastDS, *thisCornerKeyFrame);  // laserCloudCornerLastDS是关键帧
-//     pcl::copyPointCloud(*laserCloudSurfLastDS, *thisSurfKeyFrame);
-//     pcl::copyPointCloud(*laserCloudOutlierLastDS, *thisOutlierKeyFrame);
-
-//     cornerCloudKeyFrames.push_back(
-//         thisCornerKeyFrame);  // 这个地方保存了关键帧,看如何把保存的地图载入到这个地方 thisCornerKeyFrame
-//     surfCloudKeyFrames.push_back(thisSurfKeyFrame);
-//     outlierCloudKeyFrames.push_back(thisOutlierKeyFrame);
-//   }
-
-//   void correctPoses()
-//   {
-//     if (aLoopIsClosed == true)
-//     {
-//       recentCornerCloudKeyFrames.clear();
-//       recentSurfCloudKeyFrames.clear();
-//       recentOutlierCloudKeyFrames.clear();
-//       // update key poses
-//       int numPoses = isamCurrentEstimate.size();
-//       for (int i = 0; i < numPoses; ++i)
-//       {
-//         cloudKeyPoses3D->points[i].x = isamCurrentEstimate.at<Pose3>(i).translation().y();
-//         cloudKeyPoses3D->points[i].y = isamCurrentEstimate.at<Pose3>(i).translation().z();
-//         cloudKeyPoses3D->points[i].z = isamCurrentEstimate.at<Pose3>(i).translation().x();
-
-//         cloudKeyPoses6D->points[i].x = cloudKeyPoses3D->points[i].x;
-//         cloudKeyPoses6D->points[i].y = cloudKeyPoses3D->points[i].y;
-//         cloudKeyPoses6D->points[i].z = cloudKeyPoses3D->points[i].z;
-//         cloudKeyPoses6D->points[i].roll = isamCurrentEstimate.at<Pose3>(i).rotation().pitch();
-//         cloudKeyPoses6D->points[i].pitch = isamCurrentEstimate.at<Pose3>(i).rotation().yaw();
-//         cloudKeyPoses6D->points[i].yaw = isamCurrentEstimate.at<Pose3>(i).rotation().roll();
-//       }
-
-//       aLoopIsClosed = false;
-//     }
-//   }
-
-//   void clearCloud()
-//   {
-//     laserCloudCornerFromMap->clear();
-//     laserCloudSurfFromMap->clear();
-//     laserCloudCornerFromMapDS->clear();
-//     laserCloudSurfFromMapDS->clear();
-//   }
-
-//   void run()
-//   {
-//     if (newLaserCloudCornerLast && std::abs(timeLaserCloudCornerLast - timeLaserOdometry) < 0.005 &&
-//         newLaserCloudSurfLast && std::abs(timeLaserCloudSurfLast - timeLaserOdometry) < 0.005 &&
-//         newLaserCloudOutlierLast && std::abs(timeLaserCloudOutlierLast - timeLaserOdometry) < 0.005 && newLaserOdometry)
-//     {
-//       newLaserCloudCornerLast = false;
-//       newLaserCloudSurfLast = false;
-//       newLaserCloudOutlierLast = false;
-//       newLaserOdometry = false;
-
-//       std::lock_guard<std::mutex> lock(mtx);
-
-//       if (timeLaserOdometry - timeLastProcessing >= mappingProcessInterval)
-//       {
-//         timeLastProcessing = timeLaserOdometry;
-
-//         transformAssociateToMap();
-
-//         extractSurroundingKeyFrames();
-
-//         downsampleCurrentScan();
-
-//         scan2MapOptimization();
-
-//         saveKeyFramesAndFactor();
-
-//         correctPoses();
-
-//         publishTF();
-
-//         publishKeyPosesAndFrames();
-
-//         clearCloud();
-//       }
-//     }
-//   }
-// };
-
-// int main(int argc, char** argv)
-// {
-//   ros::init(argc, argv, "lego_loam");
-
-//   ROS_INFO("\033[1;32m---->\033[0m Map Optimization Started.");
-
-//   mapOptimization MO;
-
-//   std::thread loopthread(&mapOptimization::loopClosureThread, &MO);
-//   std::thread visualizeMapThread(&mapOptimization::visualizeGlobalMapThread, &MO);
-
-//   ros::Rate rate(200);
-//   while (ros::ok())
-//   {
-//     ros::spinOnce();
-
-//     MO.run();
-
-//     rate.sleep();
-//   }
-
-//   loopthread.join();
-//   visualizeMapThread.join();
-
-//   return 0;
-// }
+// Copyright 2013, Ji Zhang, Carnegie Mellon University
+// Further contributions copyright (c) 2016, Southwest Research Institute
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+// This is an implementation of the algorithm described in the following paper:
+//   J. Zhang and S. Singh. LOAM: Lidar Odometry and Mapping in Real-time.
+//     Robotics: Science and Systems Conference (RSS). Berkeley, CA, July 2014.
+//   T. Shan and B. Englot. LeGO-LOAM: Lightweight and Ground-Optimized Lidar Odometry and Mapping on Variable Terrain
+//      IEEE/RSJ International Conference on Intelligent Robots and Systems (IROS). October 2018.
+#include "../include/utility.h"
+#include "../include/tile_map.h"
+
+#include <geometry_msgs/PoseWithCovarianceStamped.h>
+#include <location_msgs/FusionDataInfo.h>
+#include <location_sensor_msgs/LidarInfo.h>
+
+// 基于先验地图的激光定位
+// 1. 按车辆位置从mapOptmization保存的二进制分块地图中取出周围分块(LRU缓存), 角点/面点各建一棵静态k-d树,
+//    只在周围分块变化时重建
+// 2. 以FusionCenter输出的融合里程计增量预测位姿, 没有融合数据时退回featureAssociation的激光里程计增量,
+//    scan-to-map匹配修正, 与mapOptmization相同
+// 3. 收到粗略位姿(/initialpose)、启动后有融合位姿或连续匹配失败时, 在粗略位姿附近做网格搜索全局重定位
+// 4. 输出/aft_mapped_to_init供transformFusion使用, 输出带协方差的经纬高位姿供FusionCenter使用
+class lidarLocalization
+{
+private:
+  ros::NodeHandle nh;
+
+  ros::Publisher pubOdomAftMapped;
+  ros::Publisher pubLidarPose;
+  ros::Publisher pubLidarInfo;
+  ros::Publisher pubMapCloud;
+
+  ros::Subscriber subLaserCloudCornerLast;
+  ros::Subscriber subLaserCloudSurfLast;
+  ros::Subscriber subOutlierCloudLast;
+  ros::Subscriber subLaserOdometry;
+  ros::Subscriber subImu;
+  ros::Subscriber subInitialPose;
+  ros::Subscriber subFusionOdometry;
+
+  nav_msgs::Odometry odomAftMapped;
+  tf::StampedTransform aftMappedTrans;
+  tf::TransformBroadcaster tfBroadcaster;
+
+  pcl::PointCloud<PointType>::Ptr laserCloudCornerFromMap;
+  pcl::PointCloud<PointType>::Ptr laserCloudSurfFromMap;
+  pcl::KdTreeFLANN<PointType>::Ptr kdtreeCornerFromMap;
+  pcl::KdTreeFLANN<PointType>::Ptr kdtreeSurfFromMap;
+
+  TileMapCache<PointType> tileMapCache;
+  std::vector<TileMapCache<PointType>::TileKey> localMapTiles;  // 当前局部地图包含的分块
+  std::vector<TileMapCache<PointType>::TileKey> tileKeys;
+  bool localMapValid;
+
+  pcl::PointCloud<PointType>::Ptr laserCloudCornerLast;
+  pcl::PointCloud<PointType>::Ptr laserCloudSurfLast;
+  pcl::PointCloud<PointType>::Ptr laserCloudOutlierLast;
+  pcl::PointCloud<PointType>::Ptr laserCloudCornerLastDS;
+  pcl::PointCloud<PointType>::Ptr laserCloudSurfLastDS;
+  pcl::PointCloud<PointType>::Ptr laserCloudOutlierLastDS;
+  pcl::PointCloud<PointType>::Ptr laserCloudSurfTotalLast;
+  pcl::PointCloud<PointType>::Ptr laserCloudSurfTotalLastDS;
+
+  pcl::PointCloud<PointType>::Ptr laserCloudOri;
+  pcl::PointCloud<PointType>::Ptr coeffSel;
+
+  pcl::PointCloud<PointType>::VectorType laserCloudOriCornerVec;
+  pcl::PointCloud<PointType>::VectorType coeffSelCornerVec;
+  std::vector<uint8_t> laserCloudOriCornerFlag;
+  pcl::PointCloud<PointType>::VectorType laserCloudOriSurfVec;
+  pcl::PointCloud<PointType>::VectorType coeffSelSurfVec;
+  std::vector<uint8_t> laserCloudOriSurfFlag;
+
+  pcl::VoxelGrid<PointType> downSizeFilterCorner;
+  pcl::VoxelGrid<PointType> downSizeFilterSurf;
+  pcl::VoxelGrid<PointType> downSizeFilterOutlier;
+
+  double timeLaserCloudCornerLast;
+  double timeLaserCloudSurfLast;
+  double timeLaserOdometry;
+  double timeLaserCloudOutlierLast;
+  double timeLastProcessing;
+
+  bool newLaserCloudCornerLast;
+  bool newLaserCloudSurfLast;
+  bool newLaserOdometry;
+  bool newLaserCloudOutlierLast;
+
+  float transformSum[6];
+  float transformIncre[6];
+  float transformTobeMapped[6];
+  float transformBefMapped[6];
+  float transformAftMapped[6];
+
+  int imuPointerFront;
+  int imuPointerLast;
+  double imuTime[imuQueLength];
+  float imuRoll[imuQueLength];
+  float imuPitch[imuQueLength];
+
+  // 融合里程计, map坐标系x,y,yaw
+  static const int fusionQueLength = 200;
+  int fusionPointerLast;
+  int fusionCount;
+  double fusionTime[fusionQueLength];
+  double fusionPose[fusionQueLength][3];
+
+  float cRoll, sRoll, cPitch, sPitch, cYaw, sYaw, tX, tY, tZ;
+
+  int laserCloudCornerLastDSNum;
+  int laserCloudSurfTotalLastDSNum;
+
+  bool isDegenerate;
+  cv::Mat matP;
+  double matAtALast[6][6];  // 最后一次迭代的法方程, 用于估计协方差
+  double residualSqSum;
+
+  // 定位状态
+  bool localized;
+  bool relocalizeRequested;
+  float coarsePose[3];  // 粗略位姿, map坐标系x,y,yaw
+  int lostCount;
+  float inlierRatio;
+  double timeLastMapped;      // 上一次匹配成功的激光帧时间
+  double timeLastRelocalize;  // 上一次自动重定位的时间
+
+  // 参数
+  std::string mapFile;
+  std::string fusionTopic;
+  double fusionMaxGap;
+  double localMapRadius;
+  int cacheTiles;
+  double processInterval;
+  double searchRadius;
+  double searchStep;
+  double yawRange;
+  double yawStep;
+  double minInlierRatio;
+  double goodInlierRatio;
+  int lostFrames;
+  double originLLH[3];  // map坐标系原点纬经高, 单位度/米
+  double originHeading;  // map坐标系x轴方向, 由东向北逆时针为正, 单位度
+  double originECEF[3];
+
+  // map/camera_init/base_link之间的固定旋转, 与launch中的static_transform_publisher一致
+  tf::Matrix3x3 rotMapToCamera;
+  tf::Matrix3x3 rotCameraToBase;
+
+  double lastPublishTime;
+  double lastEnu[3];
+  double lastYaw;
+
+public:
+  lidarLocalization() : nh("~")
+  {
+    nh.param<std::string>("/localizationParam/mapFile", mapFile, tileMapFile);
+    nh.param<std::string>("/localizationParam/fusionTopic", fusionTopic, "/localization/fusion_msg");
+    nh.param("/localizationParam/fusionMaxGap", fusionMaxGap, 0.2);
+    nh.param("/localizationParam/localMapRadius", localMapRadius, 100.0);
+    nh.param("/localizationParam/cacheTiles", cacheTiles, 64);
+    nh.param("/localizationParam/processInterval", processInterval, 0.1);
+    nh.param("/localizationParam/searchRadius", searchRadius, 3.0);
+    nh.param("/localizationParam/searchStep", searchStep, 1.0);
+    nh.param("/localizationParam/yawRange", yawRange, 180.0);
+    nh.param("/localizationParam/yawStep", yawStep, 10.0);
+    nh.param("/localizationParam/minInlierRatio", minInlierRatio, 0.3);
+    nh.param("/localizationParam/goodInlierRatio", goodInlierRatio, 0.6);
+    nh.param("/localizationParam/lostFrames", lostFrames, 5);
+    nh.param("/localizationParam/originLatitude", originLLH[0], 0.0);
+    nh.param("/localizationParam/originLongitude", originLLH[1], 0.0);
+    nh.param("/localizationParam/originAltitude", originLLH[2], 0.0);
+    nh.param("/localizationParam/originHeading", originHeading, 0.0);
+
+    pubOdomAftMapped = nh.advertise<nav_msgs::Odometry>("/aft_mapped_to_init", 5);
+    pubLidarPose = nh.advertise<geometry_msgs::PoseWithCovarianceStamped>("/localization/lidar_pose", 5);
+    pubLidarInfo = nh.advertise<location_sensor_msgs::LidarInfo>("/localization/lidar_msg", 5);
+    pubMapCloud = nh.advertise<sensor_msgs::PointCloud2>("/localization/map_cloud", 1, true);
+
+    subLaserCloudCornerLast = nh.subscribe<sensor_msgs::PointCloud2>(
+        "/laser_cloud_corner_last", 2, &lidarLocalization::laserCloudCornerLastHandler, this);
+    subLaserCloudSurfLast = nh.subscribe<sensor_msgs::PointCloud2>("/laser_cloud_surf_last", 2,
+                                                                   &lidarLocalization::laserCloudSurfLastHandler, this);
+    subOutlierCloudLast = nh.subscribe<sensor_msgs::PointCloud2>(
+        "/outlier_cloud_last", 2, &lidarLocalization::laserCloudOutlierLastHandler, this);
+    subLaserOdometry =
+        nh.subscribe<nav_msgs::Odometry>("/laser_odom_to_init", 5, &lidarLocalization::laserOdometryHandler, this);
+    subImu = nh.subscribe<sensor_msgs::Imu>(imuTopic, 50, &lidarLocalization::imuHandler, this);
+    subInitialPose = nh.subscribe<geometry_msgs::PoseWithCovarianceStamped>(
+        "/initialpose", 1, &lidarLocalization::initialPoseHandler, this);
+    subFusionOdometry = nh.subscribe<location_msgs::FusionDataInfo>(fusionTopic, 50,
+                                                                    &lidarLocalization::fusionOdometryHandler, this);
+
+    downSizeFilterCorner.setLeafSize(0.2, 0.2, 0.2);
+    downSizeFilterSurf.setLeafSize(0.4, 0.4, 0.4);
+    downSizeFilterOutlier.setLeafSize(0.4, 0.4, 0.4);
+
+    odomAftMapped.header.frame_id = "/camera_init";
+    odomAftMapped.child_frame_id = "/aft_mapped";
+
+    aftMappedTrans.frame_id_ = "/camera_init";
+    aftMappedTrans.child_frame_id_ = "/aft_mapped";
+
+    rotMapToCamera.setRPY(M_PI / 2, 0, M_PI / 2);
+    rotCameraToBase.setRPY(0, -M_PI / 2, -M_PI / 2);
+
+    allocateMemory();
+    llhToECEF(originLLH, originECEF);
+
+    // 启动时可由参数给出粗略位姿, 否则等待/initialpose
+    bool initialSearch = false;
+    nh.param("/localizationParam/initialSearch", initialSearch, false);
+    if (initialSearch)
+    {
+      double x, y, yaw;
+      nh.param("/localizationParam/initialX", x, 0.0);
+      nh.param("/localizationParam/initialY", y, 0.0);
+      nh.param("/localizationParam/initialYaw", yaw, 0.0);
+      coarsePose[0] = x;
+      coarsePose[1] = y;
+      coarsePose[2] = yaw * M_PI / 180;
+      relocalizeRequested = true;
+    }
+  }
+
+  void allocateMemory()
+  {
+    laserCloudCornerFromMap.reset(new pcl::PointCloud<PointType>());
+    laserCloudSurfFromMap.reset(new pcl::PointCloud<PointType>());
+    kdtreeCornerFromMap.reset(new pcl::KdTreeFLANN<PointType>());
+    kdtreeSurfFromMap.reset(new pcl::KdTreeFLANN<PointType>());
+    localMapValid = false;
+
+    laserCloudCornerLast.reset(new pcl::PointCloud<PointType>());
+    laserCloudSurfLast.reset(new pcl::PointCloud<PointType>());
+    laserCloudOutlierLast.reset(new pcl::PointCloud<PointType>());
+    laserCloudCornerLastDS.reset(new pcl::PointCloud<PointType>());
+    laserCloudSurfLastDS.reset(new pcl::PointCloud<PointType>());
+    laserCloudOutlierLastDS.reset(new pcl::PointCloud<PointType>());
+    laserCloudSurfTotalLast.reset(new pcl::PointCloud<PointType>());
+    laserCloudSurfTotalLastDS.reset(new pcl::PointCloud<PointType>());
+
+    laserCloudOri.reset(new pcl::PointCloud<PointType>());
+    coeffSel.reset(new pcl::PointCloud<PointType>());
+
+    timeLaserCloudCornerLast = 0;
+    timeLaserCloudSurfLast = 0;
+    timeLaserOdometry = 0;
+    timeLaserCloudOutlierLast = 0;
+    timeLastProcessing = -1;
+
+    newLaserCloudCornerLast = false;
+    newLaserCloudSurfLast = false;
+    newLaserOdometry = false;
+    newLaserCloudOutlierLast = false;
+
+    for (int i = 0; i < 6; ++i)
+    {
+      transformSum[i] = 0;
+      transformIncre[i] = 0;
+      transformTobeMapped[i] = 0;
+      transformBefMapped[i] = 0;
+      transformAftMapped[i] = 0;
+    }
+
+    imuPointerFront = 0;
+    imuPointerLast = -1;
+    for (int i = 0; i < imuQueLength; ++i)
+    {
+      imuTime[i] = 0;
+      imuRoll[i] = 0;
+      imuPitch[i] = 0;
+    }
+
+    fusionPointerLast = -1;
+    fusionCount = 0;
+    for (int i = 0; i < fusionQueLength; ++i)
+    {
+      fusionTime[i] = 0;
+      fusionPose[i][0] = fusionPose[i][1] = fusionPose[i][2] = 0;
+    }
+
+    laserCloudCornerLastDSNum = 0;
+    laserCloudSurfTotalLastDSNum = 0;
+
+    isDegenerate = false;
+    matP = cv::Mat(6, 6, CV_32F, cv::Scalar::all(0));
+    memset(matAtALast, 0, sizeof(matAtALast));
+    residualSqSum = 0;
+
+    localized = false;
+    relocalizeRequested = false;
+    coarsePose[0] = coarsePose[1] = coarsePose[2] = 0;
+    lostCount = 0;
+    inlierRatio = 0;
+    timeLastMapped = -1;
+    timeLastRelocalize = -1;
+
+    lastPublishTime = -1;
+    lastEnu[0] = lastEnu[1] = lastEnu[2] = 0;
+    lastYaw = 0;
+  }
+
+  bool openMap()
+  {
+    if (!tileMapCache.open(mapFile, cacheTiles))
+    {
+      ROS_ERROR("Failed to open tile map %s", mapFile.c_str());
+      return false;
+    }
+    ROS_INFO("Tile map opened: %d tiles of %.0f m", tileMapCache.tileCount(), tileMapCache.tileSize());
+    return true;
+  }
+
+  // 取出camera_init坐标系下(x, z)周围radius内的分块作为局部地图, 分块集合不变时不重建k-d树
+  bool updateLocalMap(float x, float z, float radius)
+  {
+    tileMapCache.tilesAround(x, z, radius, tileKeys);
+    if (tileKeys == localMapTiles)
+      return localMapValid;
+
+    laserCloudCornerFromMap->clear();
+    laserCloudSurfFromMap->clear();
+    int loaded = tileMapCache.gather(tileKeys, laserCloudCornerFromMap->points, laserCloudSurfFromMap->points);
+    if (loaded < 0)
+    {
+      // 读取失败时不记录分块集合, 下一帧重新读取
+      ROS_ERROR("Failed to read tile map %s", mapFile.c_str());
+      localMapTiles.clear();
+      localMapValid = false;
+      return false;
+    }
+    localMapTiles = tileKeys;
+    laserCloudCornerFromMap->width = laserCloudCornerFromMap->points.size();
+    laserCloudCornerFromMap->height = 1;
+    laserCloudSurfFromMap->width = laserCloudSurfFromMap->points.size();
+    laserCloudSurfFromMap->height = 1;
+
+    localMapValid = laserCloudCornerFromMap->points.size() > 10 &&
+                    laserCloudSurfFromMap->points.size() > 100;
+    if (!localMapValid)
+    {
+      ROS_WARN("Local map around (%.1f, %.1f) has too few points", z, x);
+      return false;
+    }
+    kdtreeCornerFromMap->setInputCloud(laserCloudCornerFromMap);
+    kdtreeSurfFromMap->setInputCloud(laserCloudSurfFromMap);
+    ROS_INFO("Local map: %lu tiles (%d loaded), %lu corner points, %lu surf points", localMapTiles.size(), loaded,
+             laserCloudCornerFromMap->points.size(), laserCloudSurfFromMap->points.size());
+
+    sensor_msgs::PointCloud2 cloudMsgTemp;
+    pcl::toROSMsg(*laserCloudSurfFromMap, cloudMsgTemp);
+    cloudMsgTemp.header.stamp = ros::Time().fromSec(timeLaserOdometry);
+    cloudMsgTemp.header.frame_id = "/camera_init";
+    pubMapCloud.publish(cloudMsgTemp);
+    return true;
+  }
+
+  void transformAssociateToMap()
+  {
+    float x1 = cos(transformSum[1]) * (transformBefMapped[3] - transformSum[3]) -
+               sin(transformSum[1]) * (transformBefMapped[5] - transformSum[5]);
+    float y1 = transformBefMapped[4] - transformSum[4];
+    float z1 = sin(transformSum[1]) * (transformBefMapped[3] - transformSum[3]) +
+               cos(transformSum[1]) * (transformBefMapped[5] - transformSum[5]);
+
+    float x2 = x1;
+    float y2 = cos(transformSum[0]) * y1 + sin(transformSum[0]) * z1;
+    float z2 = -sin(transformSum[0]) * y1 + cos(transformSum[0]) * z1;
+
+    transformIncre[3] = cos(transformSum[2]) * x2 + sin(transformSum[2]) * y2;
+    transformIncre[4] = -sin(transformSum[2]) * x2 + cos(transformSum[2]) * y2;
+    transformIncre[5] = z2;
+
+    float sbcx = sin(transformSum[0]);
+    float cbcx = cos(transformSum[0]);
+    float sbcy = sin(transformSum[1]);
+    float cbcy = cos(transformSum[1]);
+    float sbcz = sin(transformSum[2]);
+    float cbcz = cos(transformSum[2]);
+
+    float sblx = sin(transformBefMapped[0]);
+    float cblx = cos(transformBefMapped[0]);
+    float sbly = sin(transformBefMapped[1]);
+    float cbly = cos(transformBefMapped[1]);
+    float sblz = sin(transformBefMapped[2]);
+    float cblz = cos(transformBefMapped[2]);
+
+    float salx = sin(transformAftMapped[0]);
+    float calx = cos(transformAftMapped[0]);
+    float saly = sin(transformAftMapped[1]);
+    float caly = cos(transformAftMapped[1]);
+    float salz = sin(transformAftMapped[2]);
+    float calz = cos(transformAftMapped[2]);
+
+    float srx = -sbcx * (salx * sblx + calx * cblx * salz * sblz + calx * calz * cblx * cblz) -
+                cbcx * sbcy * (calx * calz * (cbly * sblz - cblz * sblx * sbly) -
+                               calx * salz * (cbly * cblz + sblx * sbly * sblz) + cblx * salx * sbly) -
+                cbcx * cbcy * (calx * salz * (cblz * sbly - cbly * sblx * sblz) -
+                               calx * calz * (sbly * sblz + cbly * cblz * sblx) + cblx * cbly * salx);
+    transformTobeMapped[0] = -asin(srx);
+
+    float srycrx = sbcx * (cblx * cblz * (caly * salz - calz * salx * saly) -
+                           cblx * sblz * (caly * calz + salx * saly * salz) + calx * saly * sblx) -
+                   cbcx * cbcy * ((caly * calz + salx * saly * salz) * (cblz * sbly - cbly * sblx * sblz) +
+                                  (caly * salz - calz * salx * saly) * (sbly * sblz + cbly * cblz * sblx) -
+                                  calx * cblx * cbly * saly) +
+                   cbcx * sbcy * ((caly * calz + salx * saly * salz) * (cbly * cblz + sblx * sbly * sblz) +
+                                  (caly * salz - calz * salx * saly) * (cbly * sblz - cblz * sblx * sbly) +
+                                  calx * cblx * saly * sbly);
+    float crycrx = sbcx * (cblx * sblz * (calz * saly - caly * salx * salz) -
+                           cblx * cblz * (saly * salz + caly * calz * salx) + calx * caly * sblx) +
+                   cbcx * cbcy * ((saly * salz + caly * calz * salx) * (sbly * sblz + cbly * cblz * sblx) +
+                                  (calz * saly - caly * salx * salz) * (cblz * sbly - cbly * sblx * sblz) +
+                                  calx * caly * cblx * cbly) -
+                   cbcx * sbcy * ((saly * salz + caly * calz * salx) * (cbly * sblz - cblz * sblx * sbly) +
+                                  (calz * saly - caly * salx * salz) * (cbly * cblz + sblx * sbly * sblz) -
+                                  calx * caly * cblx * sbly);
+    transformTobeMapped[1] = atan2(srycrx / cos(transformTobeMapped[0]), crycrx / cos(transformTobeMapped[0]));
+
+    float srzcrx =
+        (cbcz * sbcy - cbcy * sbcx * sbcz) * (calx * salz * (cblz * sbly - cbly * sblx * sblz) -
+                                              calx * calz * (sbly * sblz + cbly * cblz * sblx) + cblx * cbly * salx) -
+        (cbcy * cbcz + sbcx * sbcy * sbcz) * (calx * calz * (cbly * sblz - cblz * sblx * sbly) -
+                                              calx * salz * (cbly * cblz + sblx * sbly * sblz) + cblx * salx * sbly) +
+        cbcx * sbcz * (salx * sblx + calx * cblx * salz * sblz + calx * calz * cblx * cblz);
+    float crzcrx =
+        (cbcy * sbcz - cbcz * sbcx * sbcy) * (calx * calz * (cbly * sblz - cblz * sblx * sbly) -
+                                              calx * salz * (cbly * cblz + sblx * sbly * sblz) + cblx * salx * sbly) -
+        (sbcy * sbcz + cbcy * cbcz * sbcx) * (calx * salz * (cblz * sbly - cbly * sblx * sblz) -
+                                              calx * calz * (sbly * sblz + cbly * cblz * sblx) + cblx * cbly * salx) +
+        cbcx * cbcz * (salx * sblx + calx * cblx * salz * sblz + calx * calz * cblx * cblz);
+    transformTobeMapped[2] = atan2(srzcrx / cos(transformTobeMapped[0]), crzcrx / cos(transformTobeMapped[0]));
+
+    x1 = cos(transformTobeMapped[2]) * transformIncre[3] - sin(transformTobeMapped[2]) * transformIncre[4];
+    y1 = sin(transformTobeMapped[2]) * transformIncre[3] + cos(transformTobeMapped[2]) * transformIncre[4];
+    z1 = transformIncre[5];
+
+    x2 = x1;
+    y2 = cos(transformTobeMapped[0]) * y1 - sin(transformTobeMapped[0]) * z1;
+    z2 = sin(transformTobeMapped[0]) * y1 + cos(transformTobeMapped[0]) * z1;
+
+    transformTobeMapped[3] =
+        transformAftMapped[3] - (cos(transformTobeMapped[1]) * x2 + sin(transformTobeMapped[1]) * z2);
+    transformTobeMapped[4] = transformAftMapped[4] - y2;
+    transformTobeMapped[5] =
+        transformAftMapped[5] - (-sin(transformTobeMapped[1]) * x2 + cos(transformTobeMapped[1]) * z2);
+  }
+
+  // 以融合里程计在两帧之间的平面运动增量(车体系前进/左移/转角)预测位姿, 横滚/俯仰/高度沿用上一次匹配结果
+  // camera_init坐标系下 tz为map x, tx为map y, ry为map yaw
+  void transformAssociateToFusion(const double* fusionLast, const double* fusionCur)
+  {
+    double dx = fusionCur[0] - fusionLast[0];
+    double dy = fusionCur[1] - fusionLast[1];
+    double forward = cos(fusionLast[2]) * dx + sin(fusionLast[2]) * dy;
+    double left = -sin(fusionLast[2]) * dx + cos(fusionLast[2]) * dy;
+    double dyaw = atan2(sin(fusionCur[2] - fusionLast[2]), cos(fusionCur[2] - fusionLast[2]));
+
+    float yaw = transformAftMapped[1];
+    for (int i = 0; i < 6; i++)
+      transformTobeMapped[i] = transformAftMapped[i];
+    transformTobeMapped[1] = yaw + dyaw;
+    transformTobeMapped[3] = transformAftMapped[3] + sin(yaw) * forward + cos(yaw) * left;
+    transformTobeMapped[5] = transformAftMapped[5] + cos(yaw) * forward - sin(yaw) * left;
+  }
+
+  // 取time时刻的融合位姿, 在前后两帧之间线性插值; 缓存中没有覆盖该时刻或相邻两帧间隔过大时返回false
+  bool getFusionPose(double time, double* pose)
+  {
+    if (fusionCount < 2)
+      return false;
+    int back = fusionPointerLast;
+    for (int n = 1; n < fusionCount; n++)
+    {
+      int front = back;
+      back = (front + fusionQueLength - 1) % fusionQueLength;
+      if (fusionTime[back] > time)
+        continue;
+      if (fusionTime[front] < time || fusionTime[front] - fusionTime[back] > fusionMaxGap)
+        return false;
+      double ratio = (time - fusionTime[back]) / std::max(fusionTime[front] - fusionTime[back], 1e-6);
+      double dyaw = fusionPose[front][2] - fusionPose[back][2];
+      dyaw = atan2(sin(dyaw), cos(dyaw));
+      pose[0] = fusionPose[back][0] + ratio * (fusionPose[front][0] - fusionPose[back][0]);
+      pose[1] = fusionPose[back][1] + ratio * (fusionPose[front][1] - fusionPose[back][1]);
+      pose[2] = fusionPose[back][2] + ratio * dyaw;
+      return true;
+    }
+    return false;
+  }
+
+  void transformUpdate()
+  {
+    if (imuPointerLast >= 0)
+    {
+      float imuRollLast = 0, imuPitchLast = 0;
+      while (imuPointerFront != imuPointerLast)
+      {
+        if (timeLaserOdometry + scanPeriod < imuTime[imuPointerFront])
+        {
+          break;
+        }
+        imuPointerFront = (imuPointerFront + 1) % imuQueLength;
+      }
+
+      if (timeLaserOdometry + scanPeriod > imuTime[imuPointerFront])
+      {
+        imuRollLast = imuRoll[imuPointerFront];
+        imuPitchLast = imuPitch[imuPointerFront];
+      }
+      else
+      {
+        int imuPointerBack = (imuPointerFront + imuQueLength - 1) % imuQueLength;
+        float ratioFront = (timeLaserOdometry + scanPeriod - imuTime[imuPointerBack]) /
+                           (imuTime[imuPointerFront] - imuTime[imuPointerBack]);
+        float ratioBack = (imuTime[imuPointerFront] - timeLaserOdometry - scanPeriod) /
+                          (imuTime[imuPointerFront] - imuTime[imuPointerBack]);
+
+        imuRollLast = imuRoll[imuPointerFront] * ratioFront + imuRoll[imuPointerBack] * ratioBack;
+        imuPitchLast = imuPitch[imuPointerFront] * ratioFront + imuPitch[imuPointerBack] * ratioBack;
+      }
+
+      transformTobeMapped[0] = 0.998 * transformTobeMapped[0] + 0.002 * imuPitchLast;
+      transformTobeMapped[2] = 0.998 * transformTobeMapped[2] + 0.002 * imuRollLast;
+    }
+
+    for (int i = 0; i < 6; i++)
+    {
+      transformBefMapped[i] = transformSum[i];
+      transformAftMapped[i] = transformTobeMapped[i];
+    }
+  }
+
+  void updatePointAssociateToMapSinCos()
+  {
+    cRoll = cos(transformTobeMapped[0]);
+    sRoll = sin(transformTobeMapped[0]);
+
+    cPitch = cos(transformTobeMapped[1]);
+    sPitch = sin(transformTobeMapped[1]);
+
+    cYaw = cos(transformTobeMapped[2]);
+    sYaw = sin(transformTobeMapped[2]);
+
+    tX = transformTobeMapped[3];
+    tY = transformTobeMapped[4];
+    tZ = transformTobeMapped[5];
+  }
+
+  void pointAssociateToMap(PointType const* const pi, PointType* const po)
+  {
+    float x1 = cYaw * pi->x - sYaw * pi->y;
+    float y1 = sYaw * pi->x + cYaw * pi->y;
+    float z1 = pi->z;
+
+    float x2 = x1;
+    float y2 = cRoll * y1 - sRoll * z1;
+    float z2 = sRoll * y1 + cRoll * z1;
+
+    po->x = cPitch * x2 + sPitch * z2 + tX;
+    po->y = y2 + tY;
+    po->z = -sPitch * x2 + cPitch * z2 + tZ;
+    po->intensity = pi->intensity;
+  }
+
+  void laserCloudOutlierLastHandler(const sensor_msgs::PointCloud2ConstPtr& msg)
+  {
+    timeLaserCloudOutlierLast = msg->header.stamp.toSec();
+    laserCloudOutlierLast->clear();
+    pcl::fromROSMsg(*msg, *laserCloudOutlierLast);
+    newLaserCloudOutlierLast = true;
+  }
+
+  void laserCloudCornerLastHandler(const sensor_msgs::PointCloud2ConstPtr& msg)
+  {
+    timeLaserCloudCornerLast = msg->header.stamp.toSec();
+    laserCloudCornerLast->clear();
+    pcl::fromROSMsg(*msg, *laserCloudCornerLast);
+    newLaserCloudCornerLast = true;
+  }
+
+  void laserCloudSurfLastHandler(const sensor_msgs::PointCloud2ConstPtr& msg)
+  {
+    timeLaserCloudSurfLast = msg->header.stamp.toSec();
+    laserCloudSurfLast->clear();
+    pcl::fromROSMsg(*msg, *laserCloudSurfLast);
+    newLaserCloudSurfLast = true;
+  }
+
+  void laserOdometryHandler(const nav_msgs::Odometry::ConstPtr& laserOdometry)
+  {
+    timeLaserOdometry = laserOdometry->header.stamp.toSec();
+    double roll, pitch, yaw;
+    geometry_msgs::Quaternion geoQuat = laserOdometry->pose.pose.orientation;
+    tf::Matrix3x3(tf::Quaternion(geoQuat.z, -geoQuat.x, -geoQuat.y, geoQuat.w)).getRPY(roll, pitch, yaw);
+    transformSum[0] = -pitch;
+    transformSum[1] = -yaw;
+    transformSum[2] = roll;
+    transformSum[3] = laserOdometry->pose.pose.position.x;
+    transformSum[4] = laserOdometry->pose.pose.position.y;
+    transformSum[5] = laserOdometry->pose.pose.position.z;
+    newLaserOdometry = true;
+  }
+
+  // FusionCenter输出的融合位姿, 纬经高与北向顺时针航向转到map坐标系
+  void fusionOdometryHandler(const location_msgs::FusionDataInfo::ConstPtr& msg)
+  {
+    // 初始化阶段或没有位置输出时不使用
+    if (msg->system_status == 0 || (msg->pose_llh.x == 0 && msg->pose_llh.y == 0))
+      return;
+    double time = msg->header.stamp.toSec();
+    if (fusionPointerLast >= 0 && time <= fusionTime[fusionPointerLast])
+      return;
+
+    double llh[3] = { msg->pose_llh.x, msg->pose_llh.y, msg->pose_llh.z };
+    double enu[3];
+    llhToENU(llh, enu);
+    double heading = originHeading * M_PI / 180;
+    double yawEnu = (90 - msg->yaw) * M_PI / 180;
+
+    fusionPointerLast = (fusionPointerLast + 1) % fusionQueLength;
+    fusionCount = std::min(fusionCount + 1, (int)fusionQueLength);
+    fusionTime[fusionPointerLast] = time;
+    fusionPose[fusionPointerLast][0] = cos(heading) * enu[0] + sin(heading) * enu[1];
+    fusionPose[fusionPointerLast][1] = -sin(heading) * enu[0] + cos(heading) * enu[1];
+    fusionPose[fusionPointerLast][2] = atan2(sin(yawEnu - heading), cos(yawEnu - heading));
+  }
+
+  void imuHandler(const sensor_msgs::Imu::ConstPtr& imuIn)
+  {
+    double roll, pitch, yaw;
+    tf::Quaternion orientation;
+    tf::quaternionMsgToTF(imuIn->orientation, orientation);
+    tf::Matrix3x3(orientation).getRPY(roll, pitch, yaw);
+    imuPointerLast = (imuPointerLast + 1) % imuQueLength;
+    imuTime[imuPointerLast] = imuIn->header.stamp.toSec();
+    imuRoll[imuPointerLast] = roll;
+    imuPitch[imuPointerLast] = pitch;
+  }
+
+  // rviz "2D Pose Estimate", map坐标系
+  void initialPoseHandler(const geometry_msgs::PoseWithCovarianceStamped::ConstPtr& msg)
+  {
+    double roll, pitch, yaw;
+    tf::Quaternion orientation;
+    tf::quaternionMsgToTF(msg->pose.pose.orientation, orientation);
+    tf::Matrix3x3(orientation).getRPY(roll, pitch, yaw);
+    coarsePose[0] = msg->pose.pose.position.x;
+    coarsePose[1] = msg->pose.pose.position.y;
+    coarsePose[2] = yaw;
+    relocalizeRequested = true;
+    ROS_INFO("Relocalization requested at x %.2f y %.2f yaw %.1f", coarsePose[0], coarsePose[1], yaw * 180 / M_PI);
+  }
+
+  void downsampleCurrentScan()
+  {
+    laserCloudCornerLastDS->clear();
+    downSizeFilterCorner.setInputCloud(laserCloudCornerLast);
+    downSizeFilterCorner.filter(*laserCloudCornerLastDS);
+    laserCloudCornerLastDSNum = laserCloudCornerLastDS->points.size();
+
+    laserCloudSurfLastDS->clear();
+    downSizeFilterSurf.setInputCloud(laserCloudSurfLast);
+    downSizeFilterSurf.filter(*laserCloudSurfLastDS);
+
+    laserCloudOutlierLastDS->clear();
+    downSizeFilterOutlier.setInputCloud(laserCloudOutlierLast);
+    downSizeFilterOutlier.filter(*laserCloudOutlierLastDS);
+
+    laserCloudSurfTotalLast->clear();
+    laserCloudSurfTotalLastDS->clear();
+    *laserCloudSurfTotalLast += *laserCloudSurfLastDS;
+    *laserCloudSurfTotalLast += *laserCloudOutlierLastDS;
+    downSizeFilterSurf.setInputCloud(laserCloudSurfTotalLast);
+    downSizeFilterSurf.filter(*laserCloudSurfTotalLastDS);
+    laserCloudSurfTotalLastDSNum = laserCloudSurfTotalLastDS->points.size();
+  }
+
+  void cornerOptimization()
+  {
+    updatePointAssociateToMapSinCos();
+#pragma omp parallel for num_threads(numberOfCores) schedule(dynamic, 64)
+    for (int i = 0; i < laserCloudCornerLastDSNum; i++)
+    {
+      PointType pointOri, pointSel, coeff;
+      std::vector<int> pointSearchInd;
+      std::vector<float> pointSearchSqDis;
+      cv::Matx33f matA1;
+      cv::Matx31f matD1;
+      cv::Matx33f matV1;
+      laserCloudOriCornerFlag[i] = 0;
+      pointOri = laserCloudCornerLastDS->points[i];
+      pointAssociateToMap(&pointOri, &pointSel);
+      kdtreeCornerFromMap->nearestKSearch(pointSel, 5, pointSearchInd, pointSearchSqDis);
+
+      if (pointSearchSqDis.size() == 5 && pointSearchSqDis[4] < 1.0)
+      {
+        float cx = 0, cy = 0, cz = 0;
+        for (int j = 0; j < 5; j++)
+        {
+          cx += laserCloudCornerFromMap->points[pointSearchInd[j]].x;
+          cy += laserCloudCornerFromMap->points[pointSearchInd[j]].y;
+          cz += laserCloudCornerFromMap->points[pointSearchInd[j]].z;
+        }
+        cx /= 5;
+        cy /= 5;
+        cz /= 5;
+
+        float a11 = 0, a12 = 0, a13 = 0, a22 = 0, a23 = 0, a33 = 0;
+        for (int j = 0; j < 5; j++)
+        {
+          float ax = laserCloudCornerFromMap->points[pointSearchInd[j]].x - cx;
+          float ay = laserCloudCornerFromMap->points[pointSearchInd[j]].y - cy;
+          float az = laserCloudCornerFromMap->points[pointSearchInd[j]].z - cz;
+
+          a11 += ax * ax;
+          a12 += ax * ay;
+          a13 += ax * az;
+          a22 += ay * ay;
+          a23 += ay * az;
+          a33 += az * az;
+        }
+        a11 /= 5;
+        a12 /= 5;
+        a13 /= 5;
+        a22 /= 5;
+        a23 /= 5;
+        a33 /= 5;
+
+        matA1(0, 0) = a11;
+        matA1(0, 1) = a12;
+        matA1(0, 2) = a13;
+        matA1(1, 0) = a12;
+        matA1(1, 1) = a22;
+        matA1(1, 2) = a23;
+        matA1(2, 0) = a13;
+        matA1(2, 1) = a23;
+        matA1(2, 2) = a33;
+
+        cv::eigen(matA1, matD1, matV1);
+
+        if (matD1(0, 0) > 3 * matD1(1, 0))
+        {
+          float x0 = pointSel.x;
+          float y0 = pointSel.y;
+          float z0 = pointSel.z;
+          float x1 = cx + 0.1 * matV1(0, 0);
+          float y1 = cy + 0.1 * matV1(0, 1);
+          float z1 = cz + 0.1 * matV1(0, 2);
+          float x2 = cx - 0.1 * matV1(0, 0);
+          float y2 = cy - 0.1 * matV1(0, 1);
+          float z2 = cz - 0.1 * matV1(0, 2);
+
+          float a012 =
+              sqrt(((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) +
+                   ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) +
+                   ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1)) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1)));
+
+          float l12 = sqrt((x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2) + (z1 - z2) * (z1 - z2));
+
+          float la = ((y1 - y2) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) +
+                      (z1 - z2) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1))) /
+                     a012 / l12;
+
+          float lb = -((x1 - x2) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) -
+                       (z1 - z2) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1))) /
+                     a012 / l12;
+
+          float lc = -((x1 - x2) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) +
+                       (y1 - y2) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1))) /
+                     a012 / l12;
+
+          float ld2 = a012 / l12;
+
+          float s = 1 - 0.9 * fabs(ld2);
+
+          coeff.x = s * la;
+          coeff.y = s * lb;
+          coeff.z = s * lc;
+          coeff.intensity = s * ld2;
+
+          if (s > 0.1)
+          {
+            laserCloudOriCornerVec[i] = pointOri;
+            coeffSelCornerVec[i] = coeff;
+            laserCloudOriCornerFlag[i] = 1;
+          }
+        }
+      }
+    }
+  }
+
+  void surfOptimization()
+  {
+    updatePointAssociateToMapSinCos();
+#pragma omp parallel for num_threads(numberOfCores) schedule(dynamic, 64)
+    for (int i = 0; i < laserCloudSurfTotalLastDSNum; i++)
+    {
+      PointType pointOri, pointSel, coeff;
+      std::vector<int> pointSearchInd;
+      std::vector<float> pointSearchSqDis;
+      cv::Matx<float, 5, 3> matA0;
+      cv::Matx<float, 5, 1> matB0(-1, -1, -1, -1, -1);
+      cv::Matx31f matX0;
+      laserCloudOriSurfFlag[i] = 0;
+      pointOri = laserCloudSurfTotalLastDS->points[i];
+      pointAssociateToMap(&pointOri, &pointSel);
+      kdtreeSurfFromMap->nearestKSearch(pointSel, 5, pointSearchInd, pointSearchSqDis);
+
+      if (pointSearchSqDis.size() == 5 && pointSearchSqDis[4] < 1.0)
+      {
+        for (int j = 0; j < 5; j++)
+        {
+          matA0(j, 0) = laserCloudSurfFromMap->points[pointSearchInd[j]].x;
+          matA0(j, 1) = laserCloudSurfFromMap->points[pointSearchInd[j]].y;
+          matA0(j, 2) = laserCloudSurfFromMap->points[pointSearchInd[j]].z;
+        }
+        cv::solve(matA0, matB0, matX0, cv::DECOMP_QR);
+
+        float pa = matX0(0, 0);
+        float pb = matX0(1, 0);
+        float pc = matX0(2, 0);
+        float pd = 1;
+
+        float ps = sqrt(pa * pa + pb * pb + pc * pc);
+        pa /= ps;
+        pb /= ps;
+        pc /= ps;
+        pd /= ps;
+
+        bool planeValid = true;
+        for (int j = 0; j < 5; j++)
+        {
+          if (fabs(pa * laserCloudSurfFromMap->points[pointSearchInd[j]].x +
+                   pb * laserCloudSurfFromMap->points[pointSearchInd[j]].y +
+                   pc * laserCloudSurfFromMap->points[pointSearchInd[j]].z + pd) > 0.2)
+          {
+            planeValid = false;
+            break;
+          }
+        }
+
+        if (planeValid)
+        {
+          float pd2 = pa * pointSel.x + pb * pointSel.y + pc * pointSel.z + pd;
+
+          float s =
+              1 -
+              0.9 * fabs(pd2) / sqrt(sqrt(pointSel.x * pointSel.x + pointSel.y * pointSel.y + pointSel.z * pointSel.z));
+
+          coeff.x = s * pa;
+          coeff.y = s * pb;
+          coeff.z = s * pc;
+          coeff.intensity = s * pd2;
+
+          if (s > 0.1)
+          {
+            laserCloudOriSurfVec[i] = pointOri;
+            coeffSelSurfVec[i] = coeff;
+            laserCloudOriSurfFlag[i] = 1;
+          }
+        }
+      }
+    }
+  }
+
+  void combineOptimizationCoeffs()
+  {
+    for (int i = 0; i < laserCloudCornerLastDSNum; i++)
+    {
+      if (laserCloudOriCornerFlag[i])
+      {
+        laserCloudOri->push_back(laserCloudOriCornerVec[i]);
+        coeffSel->push_back(coeffSelCornerVec[i]);
+      }
+    }
+    for (int i = 0; i < laserCloudSurfTotalLastDSNum; i++)
+    {
+      if (laserCloudOriSurfFlag[i])
+      {
+        laserCloudOri->push_back(laserCloudOriSurfVec[i]);
+        coeffSel->push_back(coeffSelSurfVec[i]);
+      }
+    }
+  }
+
+  bool LMOptimization(int iterCount)
+  {
+    float srx = sin(transformTobeMapped[0]);
+    float crx = cos(transformTobeMapped[0]);
+    float sry = sin(transformTobeMapped[1]);
+    float cry = cos(transformTobeMapped[1]);
+    float srz = sin(transformTobeMapped[2]);
+    float crz = cos(transformTobeMapped[2]);
+
+    int laserCloudSelNum = laserCloudOri->points.size();
+    if (laserCloudSelNum < 50)
+    {
+      return false;
+    }
+
+    double ata[6][6] = { { 0 } };
+    double atb[6] = { 0 };
+    residualSqSum = 0;
+    for (int i = 0; i < laserCloudSelNum; i++)
+    {
+      const PointType& pointOri = laserCloudOri->points[i];
+      const PointType& coeff = coeffSel->points[i];
+
+      float arx = (crx * sry * srz * pointOri.x + crx * crz * sry * pointOri.y - srx * sry * pointOri.z) * coeff.x +
+                  (-srx * srz * pointOri.x - crz * srx * pointOri.y - crx * pointOri.z) * coeff.y +
+                  (crx * cry * srz * pointOri.x + crx * cry * crz * pointOri.y - cry * srx * pointOri.z) * coeff.z;
+
+      float ary = ((cry * srx * srz - crz * sry) * pointOri.x + (sry * srz + cry * crz * srx) * pointOri.y +
+                   crx * cry * pointOri.z) *
+                      coeff.x +
+                  ((-cry * crz - srx * sry * srz) * pointOri.x + (cry * srz - crz * srx * sry) * pointOri.y -
+                   crx * sry * pointOri.z) *
+                      coeff.z;
+
+      float arz = ((crz * srx * sry - cry * srz) * pointOri.x + (-cry * crz - srx * sry * srz) * pointOri.y) * coeff.x +
+                  (crx * crz * pointOri.x - crx * srz * pointOri.y) * coeff.y +
+                  ((sry * srz + cry * crz * srx) * pointOri.x + (crz * sry - cry * srx * srz) * pointOri.y) * coeff.z;
+
+      const float jac[6] = { arx, ary, arz, coeff.x, coeff.y, coeff.z };
+      for (int r = 0; r < 6; r++)
+      {
+        for (int c = r; c < 6; c++)
+          ata[r][c] += jac[r] * jac[c];
+        atb[r] -= jac[r] * coeff.intensity;
+      }
+      residualSqSum += coeff.intensity * coeff.intensity;
+    }
+
+    cv::Mat matAtA(6, 6, CV_32F, cv::Scalar::all(0));
+    cv::Mat matAtB(6, 1, CV_32F, cv::Scalar::all(0));
+    cv::Mat matX(6, 1, CV_32F, cv::Scalar::all(0));
+    for (int r = 0; r < 6; r++)
+    {
+      for (int c = r; c < 6; c++)
+      {
+        matAtA.at<float>(r, c) = ata[r][c];
+        matAtA.at<float>(c, r) = ata[r][c];
+        matAtALast[r][c] = ata[r][c];
+        matAtALast[c][r] = ata[r][c];
+      }
+      matAtB.at<float>(r, 0) = atb[r];
+    }
+    cv::solve(matAtA, matAtB, matX, cv::DECOMP_QR);
+
+    if (iterCount == 0)
+    {
+      cv::Mat matE(1, 6, CV_32F, cv::Scalar::all(0));
+      cv::Mat matV(6, 6, CV_32F, cv::Scalar::all(0));
+      cv::Mat matV2(6, 6, CV_32F, cv::Scalar::all(0));
+
+      cv::eigen(matAtA, matE, matV);
+      matV.copyTo(matV2);
+
+      isDegenerate = false;
+      float eignThre[6] = { 100, 100, 100, 100, 100, 100 };
+      for (int i = 5; i >= 0; i--)
+      {
+        if (matE.at<float>(0, i) < eignThre[i])
+        {
+          for (int j = 0; j < 6; j++)
+          {
+            matV2.at<float>(i, j) = 0;
+          }
+          isDegenerate = true;
+        }
+        else
+        {
+          break;
+        }
+      }
+      matP = matV.inv() * matV2;
+    }
+
+    if (isDegenerate)
+    {
+      cv::Mat matX2(6, 1, CV_32F, cv::Scalar::all(0));
+      matX.copyTo(matX2);
+      matX = matP * matX2;
+    }
+
+    transformTobeMapped[0] += matX.at<float>(0, 0);
+    transformTobeMapped[1] += matX.at<float>(1, 0);
+    transformTobeMapped[2] += matX.at<float>(2, 0);
+    transformTobeMapped[3] += matX.at<float>(3, 0);
+    transformTobeMapped[4] += matX.at<float>(4, 0);
+    transformTobeMapped[5] += matX.at<float>(5, 0);
+
+    float deltaR = sqrt(pow(pcl::rad2deg(matX.at<float>(0, 0)), 2) + pow(pcl::rad2deg(matX.at<float>(1, 0)), 2) +
+                        pow(pcl::rad2deg(matX.at<float>(2, 0)), 2));
+    float deltaT = sqrt(pow(matX.at<float>(3, 0) * 100, 2) + pow(matX.at<float>(4, 0) * 100, 2) +
+                        pow(matX.at<float>(5, 0) * 100, 2));
+
+    if (deltaR < 0.05 && deltaT < 0.05)
+    {
+      return true;
+    }
+    return false;
+  }
+
+  // 以transformTobeMapped为初值做scan-to-map匹配, 返回匹配上的特征点比例
+  float scan2MapOptimization(int maxIterations)
+  {
+    int featureNum = laserCloudCornerLastDSNum + laserCloudSurfTotalLastDSNum;
+    if (featureNum == 0)
+      return 0;
+
+    laserCloudOriCornerVec.resize(laserCloudCornerLastDSNum);
+    coeffSelCornerVec.resize(laserCloudCornerLastDSNum);
+    laserCloudOriCornerFlag.resize(laserCloudCornerLastDSNum);
+    laserCloudOriSurfVec.resize(laserCloudSurfTotalLastDSNum);
+    coeffSelSurfVec.resize(laserCloudSurfTotalLastDSNum);
+    laserCloudOriSurfFlag.resize(laserCloudSurfTotalLastDSNum);
+
+    for (int iterCount = 0; iterCount < maxIterations; iterCount++)
+    {
+      laserCloudOri->clear();
+      coeffSel->clear();
+
+      cornerOptimization();
+      surfOptimization();
+      combineOptimizationCoeffs();
+
+      if (LMOptimization(iterCount) == true)
+        break;
+    }
+    return (float)laserCloudOri->points.size() / featureNum;
+  }
+
+  // 面点最近邻距离小于0.5米的比例, 用于重定位候选位姿的粗评分
+  float scoreCandidate(const float* transform, int stride)
+  {
+    float cr = cos(transform[0]), sr = sin(transform[0]);
+    float cp = cos(transform[1]), sp = sin(transform[1]);
+    float cy = cos(transform[2]), sy = sin(transform[2]);
+    int total = 0, matched = 0;
+    std::vector<int> pointSearchInd;
+    std::vector<float> pointSearchSqDis;
+    for (int i = 0; i < laserCloudSurfTotalLastDSNum; i += stride)
+    {
+      const PointType& pi = laserCloudSurfTotalLastDS->points[i];
+      float x1 = cy * pi.x - sy * pi.y;
+      float y1 = sy * pi.x + cy * pi.y;
+      float z1 = pi.z;
+      float y2 = cr * y1 - sr * z1;
+      float z2 = sr * y1 + cr * z1;
+      PointType po;
+      po.x = cp * x1 + sp * z2 + transform[3];
+      po.y = y2 + transform[4];
+      po.z = -sp * x1 + cp * z2 + transform[5];
+      po.intensity = pi.intensity;
+      total++;
+      if (kdtreeSurfFromMap->nearestKSearch(po, 1, pointSearchInd, pointSearchSqDis) > 0 &&
+          pointSearchSqDis[0] < 0.25)
+        matched++;
+    }
+    return total > 0 ? (float)matched / total : 0;
+  }
+
+  // 在粗略位姿(map坐标系x,y,yaw)附近网格搜索, 取评分最高的若干候选做scan-to-map匹配
+  bool relocalize(float x, float y, float yaw, float radius, float yawSpan)
+  {
+    struct Candidate
+    {
+      float transform[6];
+      float score;
+      bool operator<(const Candidate& other) const
+      {
+        return score > other.score;
+      }
+    };
+
+    // map坐标系(x前y左z上)与camera_init坐标系(z前x左y上)
+    if (!updateLocalMap(y, x, localMapRadius + radius))
+      return false;
+    float rx = localized ? transformAftMapped[0] : 0;
+    float rz = localized ? transformAftMapped[2] : 0;
+    float height = localized ? transformAftMapped[4] : 0;
+    int radiusSteps = std::max(0, (int)(radius / searchStep));
+    int yawSteps = std::max(0, (int)(yawSpan / yawStep));
+    std::vector<Candidate> candidates;
+    for (int dy = -yawSteps; dy <= yawSteps; dy++)
+    {
+      for (int ix = -radiusSteps; ix <= radiusSteps; ix++)
+      {
+        for (int iy = -radiusSteps; iy <= radiusSteps; iy++)
+        {
+          Candidate candidate;
+          candidate.transform[0] = rx;
+          candidate.transform[1] = yaw + dy * yawStep * M_PI / 180;
+          candidate.transform[2] = rz;
+          candidate.transform[3] = y + iy * searchStep;
+          candidate.transform[4] = height;
+          candidate.transform[5] = x + ix * searchStep;
+          candidate.score = 0;
+          candidates.push_back(candidate);
+        }
+      }
+    }
+
+    // 评分只用约500个面点
+    int stride = std::max(1, laserCloudSurfTotalLastDSNum / 500);
+#pragma omp parallel for num_threads(numberOfCores) schedule(dynamic, 8)
+    for (int i = 0; i < (int)candidates.size(); i++)
+      candidates[i].score = scoreCandidate(candidates[i].transform, stride);
+
+    int refineNum = std::min((int)candidates.size(), 5);
+    std::partial_sort(candidates.begin(), candidates.begin() + refineNum, candidates.end());
+
+    float bestRatio = 0;
+    float bestTransform[6];
+    for (int i = 0; i < refineNum; i++)
+    {
+      for (int j = 0; j < 6; j++)
+        transformTobeMapped[j] = candidates[i].transform[j];
+      float ratio = scan2MapOptimization(30);
+      if (ratio > bestRatio)
+      {
+        bestRatio = ratio;
+        for (int j = 0; j < 6; j++)
+          bestTransform[j] = transformTobeMapped[j];
+      }
+    }
+
+    ROS_INFO("Relocalization: %lu candidates, best score %.2f, inlier ratio %.2f", candidates.size(),
+             candidates.empty() ? 0.f : candidates[0].score, bestRatio);
+    if (bestRatio < goodInlierRatio)
+      return false;
+
+    for (int j = 0; j < 6; j++)
+      transformTobeMapped[j] = bestTransform[j];
+    // 用最优结果重新计算一次法方程, 供协方差估计
+    inlierRatio = scan2MapOptimization(10);
+    return true;
+  }
+
+  // map坐标系下车体位姿
+  void getVehiclePose(const float* transform, double* position, double& roll, double& pitch, double& yaw)
+  {
+    tf::Matrix3x3 rotX, rotY, rotZ;
+    rotX.setRPY(transform[0], 0, 0);
+    rotY.setRPY(0, transform[1], 0);
+    rotZ.setRPY(0, 0, transform[2]);
+    tf::Matrix3x3 rotation = rotMapToCamera * rotY * rotX * rotZ * rotCameraToBase;
+    rotation.getRPY(roll, pitch, yaw);
+    tf::Vector3 p = rotMapToCamera * tf::Vector3(transform[3], transform[4], transform[5]);
+    position[0] = p.x();
+    position[1] = p.y();
+    position[2] = p.z();
+  }
+
+  // 协方差 = 残差方差 * (A'A)^-1, 顺序由camera_init的(rx,ry,rz,tx,ty,tz)换为map坐标系的(x,y,z,roll,pitch,yaw)
+  void getCovariance(double* covariance)
+  {
+    cv::Mat matAtA(6, 6, CV_64F, matAtALast);
+    cv::Mat matCov;
+    cv::invert(matAtA, matCov, cv::DECOMP_SVD);
+    int selNum = laserCloudOri->points.size();
+    double sigma2 = selNum > 6 ? residualSqSum / (selNum - 6) : 1.0;
+    const int order[6] = { 5, 3, 4, 2, 0, 1 };
+    for (int r = 0; r < 6; r++)
+    {
+      for (int c = 0; c < 6; c++)
+        covariance[r * 6 + c] = sigma2 * matCov.at<double>(order[r], order[c]);
+    }
+  }
+
+  void llhToECEF(const double* llh, double* ecef)
+  {
+    const double a = 6378137.0;
+    const double e2 = 6.69437999014e-3;
+    double lat = llh[0] * M_PI / 180;
+    double lon = llh[1] * M_PI / 180;
+    double n = a / sqrt(1 - e2 * sin(lat) * sin(lat));
+    ecef[0] = (n + llh[2]) * cos(lat) * cos(lon);
+    ecef[1] = (n + llh[2]) * cos(lat) * sin(lon);
+    ecef[2] = (n * (1 - e2) + llh[2]) * sin(lat);
+  }
+
+  void llhToENU(const double* llh, double* enu)
+  {
+    double ecef[3];
+    llhToECEF(llh, ecef);
+    double lat0 = originLLH[0] * M_PI / 180;
+    double lon0 = originLLH[1] * M_PI / 180;
+    double dx = ecef[0] - originECEF[0];
+    double dy = ecef[1] - originECEF[1];
+    double dz = ecef[2] - originECEF[2];
+    enu[0] = -sin(lon0) * dx + cos(lon0) * dy;
+    enu[1] = -sin(lat0) * cos(lon0) * dx - sin(lat0) * sin(lon0) * dy + cos(lat0) * dz;
+    enu[2] = cos(lat0) * cos(lon0) * dx + cos(lat0) * sin(lon0) * dy + sin(lat0) * dz;
+  }
+
+  void enuToLLH(const double* enu, double* llh)
+  {
+    const double a = 6378137.0;
+    const double e2 = 6.69437999014e-3;
+    double lat0 = originLLH[0] * M_PI / 180;
+    double lon0 = originLLH[1] * M_PI / 180;
+    double x = originECEF[0] - sin(lon0) * enu[0] - sin(lat0) * cos(lon0) * enu[1] + cos(lat0) * cos(lon0) * enu[2];
+    double y = originECEF[1] + cos(lon0) * enu[0] - sin(lat0) * sin(lon0) * enu[1] + cos(lat0) * sin(lon0) * enu[2];
+    double z = originECEF[2] + cos(lat0) * enu[1] + sin(lat0) * enu[2];
+
+    double p = sqrt(x * x + y * y);
+    double lat = atan2(z, p * (1 - e2));
+    double h = 0;
+    for (int i = 0; i < 5; i++)
+    {
+      double n = a / sqrt(1 - e2 * sin(lat) * sin(lat));
+      h = p / cos(lat) - n;
+      lat = atan2(z, p * (1 - e2 * n / (n + h)));
+    }
+    llh[0] = lat * 180 / M_PI;
+    llh[1] = atan2(y, x) * 180 / M_PI;
+    llh[2] = h;
+  }
+
+  void publishTF()
+  {
+    geometry_msgs::Quaternion geoQuat =
+        tf::createQuaternionMsgFromRollPitchYaw(transformAftMapped[2], -transformAftMapped[0], -transformAftMapped[1]);
+
+    odomAftMapped.header.stamp = ros::Time().fromSec(timeLaserOdometry);
+    odomAftMapped.pose.pose.orientation.x = -geoQuat.y;
+    odomAftMapped.pose.pose.orientation.y = -geoQuat.z;
+    odomAftMapped.pose.pose.orientation.z = geoQuat.x;
+    odomAftMapped.pose.pose.orientation.w = geoQuat.w;
+    odomAftMapped.pose.pose.position.x = transformAftMapped[3];
+    odomAftMapped.pose.pose.position.y = transformAftMapped[4];
+    odomAftMapped.pose.pose.position.z = transformAftMapped[5];
+    odomAftMapped.twist.twist.angular.x = transformBefMapped[0];
+    odomAftMapped.twist.twist.angular.y = transformBefMapped[1];
+    odomAftMapped.twist.twist.angular.z = transformBefMapped[2];
+    odomAftMapped.twist.twist.linear.x = transformBefMapped[3];
+    odomAftMapped.twist.twist.linear.y = transformBefMapped[4];
+    odomAftMapped.twist.twist.linear.z = transformBefMapped[5];
+    pubOdomAftMapped.publish(odomAftMapped);
+
+    aftMappedTrans.stamp_ = ros::Time().fromSec(timeLaserOdometry);
+    aftMappedTrans.setRotation(tf::Quaternion(-geoQuat.y, -geoQuat.z, geoQuat.x, geoQuat.w));
+    aftMappedTrans.setOrigin(tf::Vector3(transformAftMapped[3], transformAftMapped[4], transformAftMapped[5]));
+    tfBroadcaster.sendTransform(aftMappedTrans);
+  }
+
+  void publishPose()
+  {
+    double position[3], roll, pitch, yaw;
+    getVehiclePose(transformAftMapped, position, roll, pitch, yaw);
+    double covariance[36];
+    getCovariance(covariance);
+
+    geometry_msgs::PoseWithCovarianceStamped pose;
+    pose.header.stamp = ros::Time().fromSec(timeLaserOdometry);
+    pose.header.frame_id = "/map";
+    pose.pose.pose.position.x = position[0];
+    pose.pose.pose.position.y = position[1];
+    pose.pose.pose.position.z = position[2];
+    pose.pose.pose.orientation = tf::createQuaternionMsgFromRollPitchYaw(roll, pitch, yaw);
+    for (int i = 0; i < 36; i++)
+      pose.pose.covariance[i] = covariance[i];
+    pubLidarPose.publish(pose);
+
+    // map坐标系转东北天, 协方差的xy部分随之旋转
+    double heading = originHeading * M_PI / 180;
+    double ch = cos(heading), sh = sin(heading);
+    double enu[3];
+    enu[0] = ch * position[0] - sh * position[1];
+    enu[1] = sh * position[0] + ch * position[1];
+    enu[2] = position[2];
+    double rot[36] = { 0 };
+    for (int i = 0; i < 6; i++)
+      rot[i * 6 + i] = 1;
+    rot[0] = ch;
+    rot[1] = -sh;
+    rot[6] = sh;
+    rot[7] = ch;
+    double tmp[36], covEnu[36];
+    for (int r = 0; r < 6; r++)
+    {
+      for (int c = 0; c < 6; c++)
+      {
+        tmp[r * 6 + c] = 0;
+        for (int k = 0; k < 6; k++)
+          tmp[r * 6 + c] += rot[r * 6 + k] * covariance[k * 6 + c];
+      }
+    }
+    for (int r = 0; r < 6; r++)
+    {
+      for (int c = 0; c < 6; c++)
+      {
+        covEnu[r * 6 + c] = 0;
+        for (int k = 0; k < 6; k++)
+          covEnu[r * 6 + c] += tmp[r * 6 + k] * rot[c * 6 + k];
+      }
+    }
+
+    double llh[3];
+    enuToLLH(enu, llh);
+    // 航向角由北向东顺时针为正, 与组合导航一致
+    double yawEnu = heading + yaw;
+    double yawDeg = 90 - yawEnu * 180 / M_PI;
+    yawDeg = fmod(yawDeg, 360.0);
+    if (yawDeg < 0)
+      yawDeg += 360;
+
+    location_sensor_msgs::LidarInfo info;
+    info.header.stamp = ros::Time().fromSec(timeLaserOdometry);
+    info.header.frame_id = "/map";
+    time_t stamp = (time_t)timeLaserOdometry;
+    struct tm tmStamp;
+    localtime_r(&stamp, &tmStamp);
+    info.year = tmStamp.tm_year + 1900;
+    info.month = tmStamp.tm_mon + 1;
+    info.day = tmStamp.tm_mday;
+    info.hour = tmStamp.tm_hour;
+    info.min = tmStamp.tm_min;
+    info.sec = tmStamp.tm_sec;
+    info.msec = (timeLaserOdometry - stamp) * 1000;
+    // 位置为纬经高, 协方差为东北天坐标系下的米/弧度
+    info.pose_cov.pose.position.x = llh[0];
+    info.pose_cov.pose.position.y = llh[1];
+    info.pose_cov.pose.position.z = llh[2];
+    info.pose_cov.pose.orientation = tf::createQuaternionMsgFromRollPitchYaw(roll, pitch, yawEnu);
+    for (int i = 0; i < 36; i++)
+      info.pose_cov.covariance[i] = covEnu[i];
+    info.yaw = yawDeg;
+    info.pitch = pitch * 180 / M_PI;
+    info.roll = roll * 180 / M_PI;
+
+    double dt = timeLaserOdometry - lastPublishTime;
+    if (lastPublishTime > 0 && dt > 0 && dt < 1.0)
+    {
+      info.vel_cov.twist.linear.x = (enu[0] - lastEnu[0]) / dt;
+      info.vel_cov.twist.linear.y = (enu[1] - lastEnu[1]) / dt;
+      info.vel_cov.twist.linear.z = (enu[2] - lastEnu[2]) / dt;
+      double dyaw = yaw - lastYaw;
+      dyaw = atan2(sin(dyaw), cos(dyaw));
+      info.vel_cov.twist.angular.z = dyaw / dt * 180 / M_PI;
+    }
+    lastPublishTime = timeLaserOdometry;
+    lastEnu[0] = enu[0];
+    lastEnu[1] = enu[1];
+    lastEnu[2] = enu[2];
+    lastYaw = yaw;
+
+    // 匹配点比例在minInlierRatio到goodInlierRatio之间线性映射到0到1, 退化时不可信
+    float confidence = (inlierRatio - minInlierRatio) / std::max(goodInlierRatio - minInlierRatio, 1e-3);
+    confidence = std::min(1.f, std::max(0.f, confidence));
+    if (isDegenerate)
+      confidence = 0;
+    info.pose_confidence = confidence;
+    info.orien_confidence = confidence;
+    info.linear_confidence = confidence;
+    info.angular_confidence = confidence;
+    pubLidarInfo.publish(info);
+  }
+
+  void run()
+  {
+    if (newLaserCloudCornerLast && std::abs(timeLaserCloudCornerLast - timeLaserOdometry) < 0.005 &&
+        newLaserCloudSurfLast && std::abs(timeLaserCloudSurfLast - timeLaserOdometry) < 0.005 &&
+        newLaserCloudOutlierLast && std::abs(timeLaserCloudOutlierLast - timeLaserOdometry) < 0.005 && newLaserOdometry)
+    {
+      newLaserCloudCornerLast = false;
+      newLaserCloudSurfLast = false;
+      newLaserCloudOutlierLast = false;
+      newLaserOdometry = false;
+
+      if (timeLaserOdometry - timeLastProcessing < processInterval)
+        return;
+      timeLastProcessing = timeLaserOdometry;
+
+      downsampleCurrentScan();
+
+      double fusionLast[3], fusionCur[3];
+      bool fusionValid = getFusionPose(timeLaserOdometry, fusionCur);
+
+      // 启动后没有给出粗略位姿时, 以融合位姿为中心自动重定位, 失败后每秒重试一次
+      if (!localized && !relocalizeRequested && fusionValid && timeLaserOdometry - timeLastRelocalize > 1.0)
+      {
+        timeLastRelocalize = timeLaserOdometry;
+        coarsePose[0] = fusionCur[0];
+        coarsePose[1] = fusionCur[1];
+        coarsePose[2] = fusionCur[2];
+        relocalizeRequested = true;
+      }
+
+      if (relocalizeRequested)
+      {
+        relocalizeRequested = false;
+        localized = false;
+        if (relocalize(coarsePose[0], coarsePose[1], coarsePose[2], searchRadius, yawRange))
+        {
+          localized = true;
+          lostCount = 0;
+          ROS_INFO("Relocalization succeeded");
+        }
+        else
+        {
+          ROS_WARN("Relocalization failed, waiting for a new initial pose");
+        }
+      }
+      else if (localized)
+      {
+        if (fusionValid && getFusionPose(timeLastMapped, fusionLast))
+          transformAssociateToFusion(fusionLast, fusionCur);
+        else
+          transformAssociateToMap();
+        inlierRatio = 0;
+        if (updateLocalMap(transformTobeMapped[3], transformTobeMapped[5], localMapRadius))
+          inlierRatio = scan2MapOptimization(10);
+        if (inlierRatio < minInlierRatio)
+        {
+          // 连续匹配失败时, 在融合位姿(没有时用最后一次成功的位姿)附近重定位
+          lostCount++;
+          ROS_WARN("Scan-to-map inlier ratio %.2f, lost %d frames", inlierRatio, lostCount);
+          if (lostCount < lostFrames)
+            return;
+          double position[3], roll, pitch, yaw;
+          getVehiclePose(transformAftMapped, position, roll, pitch, yaw);
+          if (fusionValid)
+          {
+            position[0] = fusionCur[0];
+            position[1] = fusionCur[1];
+            yaw = fusionCur[2];
+          }
+          localized = relocalize(position[0], position[1], yaw, searchRadius, 3 * yawStep);
+          lostCount = 0;
+          if (!localized)
+          {
+            ROS_WARN("Lost localization, waiting for a new initial pose");
+            return;
+          }
+        }
+        else
+        {
+          lostCount = 0;
+        }
+      }
+
+      if (!localized)
+        return;
+
+      transformUpdate();
+      timeLastMapped = timeLaserOdometry;
+      publishTF();
+      publishPose();
+    }
+  }
+};
+
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "lego_loam");
+
+  ROS_INFO("\033[1;32m---->\033[0m Lidar Localization Started.");
+
+  lidarLocalization LL;
+  if (!LL.openMap())
+    return 1;
+
+  ros::Rate rate(200);
+  while (ros::ok())
+  {
+    ros::spinOnce();
+
+    LL.run();
+
+    rate.sleep();
+  }
+
+  return 0;
+}
@@ -32,6 +32,9 @@
 //   T. Shan and B. Englot. LeGO-LOAM: Lightweight and Ground-Optimized Lidar Odometry and Mapping on Variable Terrain
 //      IEEE/RSJ International Conference on Intelligent Robots and Systems (IROS). October 2018.
 #include "../include/utility.h"
+#include "../include/incremental_kdtree.h"
+#include "../include/tile_map.h"
+#include "../include/scan_context.h"
 
 #include <gtsam/geometry/Pose3.h>
 #include <gtsam/geometry/Rot3.h>
@@ -83,15 +86,8 @@ private:
   vector<pcl::PointCloud<PointType>::Ptr> surfCloudKeyFrames;
   vector<pcl::PointCloud<PointType>::Ptr> outlierCloudKeyFrames;
 
-  deque<pcl::PointCloud<PointType>::Ptr> recentCornerCloudKeyFrames;
-  deque<pcl::PointCloud<PointType>::Ptr> recentSurfCloudKeyFrames;
-  deque<pcl::PointCloud<PointType>::Ptr> recentOutlierCloudKeyFrames;
-  int latestFrameID;
-
-  vector<int> surroundingExistingKeyPosesID;
-  deque<pcl::PointCloud<PointType>::Ptr> surroundingCornerCloudKeyFrames;
-  deque<pcl::PointCloud<PointType>::Ptr> surroundingSurfCloudKeyFrames;
-  deque<pcl::PointCloud<PointType>::Ptr> surroundingOutlierCloudKeyFrames;
+  int latestFrameID;         // 已插入局部地图的最新关键帧
+  bool localMapNeedRebuild;  // 建图开始或回环校正后需要重建局部地图
 
   PointType previousRobotPosPoint;
   PointType currentRobotPosPoint;
@@ -99,9 +95,6 @@ private:
   pcl::PointCloud<PointType>::Ptr cloudKeyPoses3D;
   pcl::PointCloud<PointTypePose>::Ptr cloudKeyPoses6D;
 
-  pcl::PointCloud<PointType>::Ptr surroundingKeyPoses;
-  pcl::PointCloud<PointType>::Ptr surroundingKeyPosesDS;
-
   pcl::PointCloud<PointType>::Ptr laserCloudCornerLast;    // corner feature set from odoOptimization
   pcl::PointCloud<PointType>::Ptr laserCloudSurfLast;      // surf feature set from odoOptimization
   pcl::PointCloud<PointType>::Ptr laserCloudCornerLastDS;  // downsampled corner featuer set from odoOptimization
@@ -121,10 +114,10 @@ private:
   pcl::PointCloud<PointType>::Ptr laserCloudCornerFromMapDS;
   pcl::PointCloud<PointType>::Ptr laserCloudSurfFromMapDS;
 
-  pcl::KdTreeFLANN<PointType>::Ptr kdtreeCornerFromMap;
-  pcl::KdTreeFLANN<PointType>::Ptr kdtreeSurfFromMap;
+  // 局部地图,新关键帧增量插入,离开局部窗口的点按包围盒删除
+  IncrementalKdTree<PointType> ikdtreeCornerFromMap;
+  IncrementalKdTree<PointType> ikdtreeSurfFromMap;
 
-  pcl::KdTreeFLANN<PointType>::Ptr kdtreeSurroundingKeyPoses;
   pcl::KdTreeFLANN<PointType>::Ptr kdtreeHistoryKeyPoses;
 
   pcl::PointCloud<PointType>::Ptr nearHistoryCornerKeyFrameCloud;
@@ -142,14 +135,18 @@ private:
   pcl::PointCloud<PointType>::Ptr globalMapKeyFrames;
   pcl::PointCloud<PointType>::Ptr globalMapKeyFramesDS;
 
-  std::vector<int> pointSearchInd;
-  std::vector<float> pointSearchSqDis;
+  // 并行匹配时每个特征点的结果槽位, 按点序合并到laserCloudOri/coeffSel
+  pcl::PointCloud<PointType>::VectorType laserCloudOriCornerVec;
+  pcl::PointCloud<PointType>::VectorType coeffSelCornerVec;
+  std::vector<uint8_t> laserCloudOriCornerFlag;
+  pcl::PointCloud<PointType>::VectorType laserCloudOriSurfVec;
+  pcl::PointCloud<PointType>::VectorType coeffSelSurfVec;
+  std::vector<uint8_t> laserCloudOriSurfFlag;
 
   pcl::VoxelGrid<PointType> downSizeFilterCorner;
   pcl::VoxelGrid<PointType> downSizeFilterSurf;
   pcl::VoxelGrid<PointType> downSizeFilterOutlier;
   pcl::VoxelGrid<PointType> downSizeFilterHistoryKeyFrames;     // for histor key frames of loop closure
-  pcl::VoxelGrid<PointType> downSizeFilterSurroundingKeyPoses;  // for surrounding key poses of scan-to-map optimization
   pcl::VoxelGrid<PointType> downSizeFilterGlobalMapKeyPoses;    // for global map visualization
   pcl::VoxelGrid<PointType> downSizeFilterGlobalMapKeyFrames;   // for global map visualization
 
@@ -180,17 +177,9 @@ private:
 
   std::mutex mtx;
 
-  double timeLastProcessing;
-
-  PointType pointOri, pointSel, pointProj, coeff;
-
-  cv::Mat matA0;
-  cv::Mat matB0;
-  cv::Mat matX0;
+  TileMapWriter tileMapWriter;
 
-  cv::Mat matA1;
-  cv::Mat matD1;
-  cv::Mat matV1;
+  double timeLastProcessing;
 
   bool isDegenerate;
   cv::Mat matP;
@@ -206,6 +195,16 @@ private:
   double timeSaveFirstCurrentScanForLoopClosure;
   int closestHistoryFrameID;
   int latestFrameIDLoopCloure;
+  Eigen::Matrix4f loopInitialGuess;  // ICP初值, 描述子检索到的回环带有相对航向
+
+  ScanContext scanContext;  // 关键帧描述子, 与cloudKeyPoses序号一一对应
+  pcl::PointCloud<PointType>::Ptr scanContextPendingCloud;  // 新关键帧点云, 在锁外计算描述子后再加入scanContext
+  double scanContextPendingTime;
+  int loopDetectCount;      // 回环检索统计, 退出时输出
+  int loopIcpCount;
+  int loopAcceptCount;
+  double loopDetectTime;
+  double loopIcpTime;
 
   bool aLoopIsClosed;
 
@@ -244,8 +243,6 @@ public:
     downSizeFilterOutlier.setLeafSize(0.4, 0.4, 0.4);
 
     downSizeFilterHistoryKeyFrames.setLeafSize(0.4, 0.4, 0.4);  // for histor key frames of loop closure
-    downSizeFilterSurroundingKeyPoses.setLeafSize(1.0, 1.0,
-                                                  1.0);  // for surrounding key poses of scan-to-map optimization
 
     downSizeFilterGlobalMapKeyPoses.setLeafSize(1.0, 1.0, 1.0);   // for global map visualization
     downSizeFilterGlobalMapKeyFrames.setLeafSize(0.4, 0.4, 0.4);  // for global map visualization
@@ -264,12 +261,8 @@ public:
     cloudKeyPoses3D.reset(new pcl::PointCloud<PointType>());
     cloudKeyPoses6D.reset(new pcl::PointCloud<PointTypePose>());
 
-    kdtreeSurroundingKeyPoses.reset(new pcl::KdTreeFLANN<PointType>());
     kdtreeHistoryKeyPoses.reset(new pcl::KdTreeFLANN<PointType>());
 
-    surroundingKeyPoses.reset(new pcl::PointCloud<PointType>());
-    surroundingKeyPosesDS.reset(new pcl::PointCloud<PointType>());
-
     laserCloudCornerLast.reset(new pcl::PointCloud<PointType>());  // corner feature set from odoOptimization
     laserCloudSurfLast.reset(new pcl::PointCloud<PointType>());    // surf feature set from odoOptimization
     laserCloudCornerLastDS.reset(
@@ -290,9 +283,6 @@ public:
     laserCloudCornerFromMapDS.reset(new pcl::PointCloud<PointType>());
     laserCloudSurfFromMapDS.reset(new pcl::PointCloud<PointType>());
 
-    kdtreeCornerFromMap.reset(new pcl::KdTreeFLANN<PointType>());
-    kdtreeSurfFromMap.reset(new pcl::KdTreeFLANN<PointType>());
-
     nearHistoryCornerKeyFrameCloud.reset(new pcl::PointCloud<PointType>());
     nearHistoryCornerKeyFrameCloudDS.reset(new pcl::PointCloud<PointType>());
     nearHistorySurfKeyFrameCloud.reset(new pcl::PointCloud<PointType>());
@@ -347,14 +337,6 @@ public:
     priorNoise = noiseModel::Diagonal::Variances(Vector6);
     odometryNoise = noiseModel::Diagonal::Variances(Vector6);
 
-    matA0 = cv::Mat(5, 3, CV_32F, cv::Scalar::all(0));
-    matB0 = cv::Mat(5, 1, CV_32F, cv::Scalar::all(-1));
-    matX0 = cv::Mat(3, 1, CV_32F, cv::Scalar::all(0));
-
-    matA1 = cv::Mat(3, 3, CV_32F, cv::Scalar::all(0));
-    matD1 = cv::Mat(1, 3, CV_32F, cv::Scalar::all(0));
-    matV1 = cv::Mat(3, 3, CV_32F, cv::Scalar::all(0));
-
     isDegenerate = false;
     matP = cv::Mat(6, 6, CV_32F, cv::Scalar::all(0));
 
@@ -367,8 +349,16 @@ public:
 
     potentialLoopFlag = false;
     aLoopIsClosed = false;
+    loopInitialGuess = Eigen::Matrix4f::Identity();
+    scanContextPendingTime = 0;
+    loopDetectCount = 0;
+    loopIcpCount = 0;
+    loopAcceptCount = 0;
+    loopDetectTime = 0;
+    loopIcpTime = 0;
 
     latestFrameID = 0;
+    localMapNeedRebuild = true;
   }
 
   void transformAssociateToMap()
@@ -708,6 +698,9 @@ public:
 
     if (pubRecentKeyFrames.getNumSubscribers() != 0)
     {
+      ikdtreeSurfFromMap.getPoints(laserCloudSurfFromMapDS->points);
+      laserCloudSurfFromMapDS->width = laserCloudSurfFromMapDS->points.size();
+      laserCloudSurfFromMapDS->height = 1;
       sensor_msgs::PointCloud2 cloudMsgTemp;
       pcl::toROSMsg(*laserCloudSurfFromMapDS, cloudMsgTemp);
       cloudMsgTemp.header.stamp = ros::Time().fromSec(timeLaserOdometry);
@@ -719,39 +712,73 @@ public:
   void visualizeGlobalMapThread()
   {
     ros::Rate rate(0.2);
+    double timeLastMapSave = ros::Time::now().toSec();
     while (ros::ok())
     {
       rate.sleep();
       publishGlobalMap();
+      // 建图过程中定期在后台写入分块地图, 异常退出时不会丢失全部地图
+      if (ros::Time::now().toSec() - timeLastMapSave > tileMapSaveInterval)
+      {
+        timeLastMapSave = ros::Time::now().toSec();
+        pcl::PointCloud<PointType>::Ptr cornerMapCloudDS(new pcl::PointCloud<PointType>());
+        pcl::PointCloud<PointType>::Ptr surfaceMapCloudDS(new pcl::PointCloud<PointType>());
+        buildMapClouds(cornerMapCloudDS, surfaceMapCloudDS);
+        tileMapWriter.save(tileMapFile, cornerMapCloudDS->points, surfaceMapCloudDS->points, tileMapSize);
+      }
     }
     // save final point cloud
-    pcl::io::savePCDFileASCII(fileDirectory + "finalCloud.pcd", *globalMapKeyFramesDS);
+    pcl::io::savePCDFileBinary(fileDirectory + "finalCloud.pcd", *globalMapKeyFramesDS);
 
-    string cornerMapString = "/home/ads/data/TW/cornerMap.pcd";
-    string surfaceMapString = "/home/ads/data/TW/surfaceMap.pcd";
-    string trajectoryString = "/home/ads/data/TW/trajectory.pcd";
+    pcl::PointCloud<PointType>::Ptr cornerMapCloudDS(new pcl::PointCloud<PointType>());
+    pcl::PointCloud<PointType>::Ptr surfaceMapCloudDS(new pcl::PointCloud<PointType>());
+    buildMapClouds(cornerMapCloudDS, surfaceMapCloudDS);
+
+    // 重定位使用的二进制分块地图, 与PCD写入并行
+    tileMapWriter.save(tileMapFile, cornerMapCloudDS->points, surfaceMapCloudDS->points, tileMapSize);
 
+    pcl::io::savePCDFileBinary(fileDirectory + "cornerMap.pcd", *cornerMapCloudDS);  // 保存累计点云下采样后结果
+    pcl::io::savePCDFileBinary(fileDirectory + "surfaceMap.pcd", *surfaceMapCloudDS);
+    mtx.lock();
+    pcl::PointCloud<PointType> trajectory(*cloudKeyPoses3D);
+    mtx.unlock();
+    pcl::io::savePCDFileBinary(fileDirectory + "trajectory.pcd", trajectory);
+
+    if (!tileMapWriter.wait())
+      ROS_ERROR("Failed to save tile map %s", tileMapFile.c_str());
+  }
+
+  // 将全部关键帧拼接为角点/面点地图并下采样
+  void buildMapClouds(pcl::PointCloud<PointType>::Ptr cornerMapCloudDS, pcl::PointCloud<PointType>::Ptr surfaceMapCloudDS)
+  {
     pcl::PointCloud<PointType>::Ptr cornerMapCloud(new pcl::PointCloud<PointType>());
-    pcl::PointCloud<PointType>::Ptr cornerMapCloudDS(new pcl::PointCloud<PointType>());
     pcl::PointCloud<PointType>::Ptr surfaceMapCloud(new pcl::PointCloud<PointType>());
-    pcl::PointCloud<PointType>::Ptr surfaceMapCloudDS(new pcl::PointCloud<PointType>());
 
-    for (int i = 0; i < cornerCloudKeyFrames.size(); i++)
+    // 只在锁内复制关键帧指针和位姿, 拼接在锁外进行
+    mtx.lock();
+    std::vector<pcl::PointCloud<PointType>::Ptr> cornerKeyFrames(cornerCloudKeyFrames);
+    std::vector<pcl::PointCloud<PointType>::Ptr> surfKeyFrames(surfCloudKeyFrames);
+    std::vector<pcl::PointCloud<PointType>::Ptr> outlierKeyFrames(outlierCloudKeyFrames);
+    std::vector<PointTypePose, Eigen::aligned_allocator<PointTypePose> > keyPoses(
+        cloudKeyPoses6D->points.begin(), cloudKeyPoses6D->points.begin() + cornerKeyFrames.size());
+    mtx.unlock();
+
+    for (int i = 0; i < cornerKeyFrames.size(); i++)
     {
-      *cornerMapCloud +=
-          *transformPointCloud(cornerCloudKeyFrames[i], &cloudKeyPoses6D->points[i]);  // 把关键帧进行累加,保存
-      *surfaceMapCloud += *transformPointCloud(surfCloudKeyFrames[i], &cloudKeyPoses6D->points[i]);
-      *surfaceMapCloud += *transformPointCloud(outlierCloudKeyFrames[i], &cloudKeyPoses6D->points[i]);
+      *cornerMapCloud += *transformPointCloud(cornerKeyFrames[i], &keyPoses[i]);  // 把关键帧进行累加,保存
+      *surfaceMapCloud += *transformPointCloud(surfKeyFrames[i], &keyPoses[i]);
+      *surfaceMapCloud += *transformPointCloud(outlierKeyFrames[i], &keyPoses[i]);
     }
 
-    downSizeFilterCorner.setInputCloud(cornerMapCloud);
-    downSizeFilterCorner.filter(*cornerMapCloudDS);
-    downSizeFilterSurf.setInputCloud(surfaceMapCloud);
-    downSizeFilterSurf.filter(*surfaceMapCloudDS);
-
-    pcl::io::savePCDFileASCII(fileDirectory + "cornerMap.pcd", *cornerMapCloudDS);  // 保存累计点云下采样后结果
-    pcl::io::savePCDFileASCII(fileDirectory + "surfaceMap.pcd", *surfaceMapCloudDS);
-    pcl::io::savePCDFileASCII(fileDirectory + "trajectory.pcd", *cloudKeyPoses3D);
+    // 与scan-to-map使用的滤波器分开, 避免跨线程共用
+    pcl::VoxelGrid<PointType> downSizeFilterMapCorner;
+    pcl::VoxelGrid<PointType> downSizeFilterMapSurf;
+    downSizeFilterMapCorner.setLeafSize(0.2, 0.2, 0.2);
+    downSizeFilterMapSurf.setLeafSize(0.4, 0.4, 0.4);
+    downSizeFilterMapCorner.setInputCloud(cornerMapCloud);
+    downSizeFilterMapCorner.filter(*cornerMapCloudDS);
+    downSizeFilterMapSurf.setInputCloud(surfaceMapCloud);
+    downSizeFilterMapSurf.filter(*surfaceMapCloudDS);
   }
 
   void publishGlobalMap()
@@ -759,32 +786,44 @@ public:
     if (pubLaserCloudSurround.getNumSubscribers() == 0)
       return;
 
-    if (cloudKeyPoses3D->points.empty() == true)
-      return;
     // kd-tree to find near key frames to visualize
     std::vector<int> pointSearchIndGlobalMap;
     std::vector<float> pointSearchSqDisGlobalMap;
-    // search near key frames to visualize
+    // search near key frames to visualize, 关键帧位姿在锁内复制, 建图线程会同时追加
     mtx.lock();
+    if (cloudKeyPoses3D->points.empty() == true)
+    {
+      mtx.unlock();
+      return;
+    }
     kdtreeGlobalMap->setInputCloud(cloudKeyPoses3D);
     kdtreeGlobalMap->radiusSearch(currentRobotPosPoint, globalMapVisualizationSearchRadius, pointSearchIndGlobalMap,
                                   pointSearchSqDisGlobalMap, 0);
-    mtx.unlock();
-
     for (int i = 0; i < pointSearchIndGlobalMap.size(); ++i)
       globalMapKeyPoses->points.push_back(cloudKeyPoses3D->points[pointSearchIndGlobalMap[i]]);
+    mtx.unlock();
+
     // downsample near selected key frames
     downSizeFilterGlobalMapKeyPoses.setInputCloud(globalMapKeyPoses);
     downSizeFilterGlobalMapKeyPoses.filter(*globalMapKeyPosesDS);
-    // extract visualized and downsampled key frames
+    // extract visualized and downsampled key frames, 只在锁内复制点云指针和位姿
+    std::vector<pcl::PointCloud<PointType>::Ptr> cornerKeyFrames, surfKeyFrames, outlierKeyFrames;
+    std::vector<PointTypePose, Eigen::aligned_allocator<PointTypePose> > keyPoses;
+    mtx.lock();
     for (int i = 0; i < globalMapKeyPosesDS->points.size(); ++i)
     {
       int thisKeyInd = (int)globalMapKeyPosesDS->points[i].intensity;
-      *globalMapKeyFrames +=
-          *transformPointCloud(cornerCloudKeyFrames[thisKeyInd], &cloudKeyPoses6D->points[thisKeyInd]);
-      *globalMapKeyFrames += *transformPointCloud(surfCloudKeyFrames[thisKeyInd], &cloudKeyPoses6D->points[thisKeyInd]);
-      *globalMapKeyFrames +=
-          *transformPointCloud(outlierCloudKeyFrames[thisKeyInd], &cloudKeyPoses6D->points[thisKeyInd]);
+      cornerKeyFrames.push_back(cornerCloudKeyFrames[thisKeyInd]);
+      surfKeyFrames.push_back(surfCloudKeyFrames[thisKeyInd]);
+      outlierKeyFrames.push_back(outlierCloudKeyFrames[thisKeyInd]);
+      keyPoses.push_back(cloudKeyPoses6D->points[thisKeyInd]);
+    }
+    mtx.unlock();
+    for (int i = 0; i < keyPoses.size(); ++i)
+    {
+      *globalMapKeyFrames += *transformPointCloud(cornerKeyFrames[i], &keyPoses[i]);
+      *globalMapKeyFrames += *transformPointCloud(surfKeyFrames[i], &keyPoses[i]);
+      *globalMapKeyFrames += *transformPointCloud(outlierKeyFrames[i], &keyPoses[i]);
     }
     // downsample visualized points
     downSizeFilterGlobalMapKeyFrames.setInputCloud(globalMapKeyFrames);
@@ -813,6 +852,18 @@ public:
       rate.sleep();
       performLoopClosure();
     }
+    ROS_INFO("Loop closure: %d queries %.2f ms avg, %d icp %.2f ms avg, %d accepted", loopDetectCount,
+             loopDetectCount > 0 ? loopDetectTime / loopDetectCount : 0.0, loopIcpCount,
+             loopIcpCount > 0 ? loopIcpTime / loopIcpCount : 0.0, loopAcceptCount);
+  }
+
+  // 关键帧位姿(camera系)对应的变换, 与transformPointCloud的旋转顺序一致
+  Eigen::Affine3f pclPointToAffine3fCamera(const PointTypePose& thisPoint)
+  {
+    return Eigen::Translation3f(thisPoint.x, thisPoint.y, thisPoint.z) *
+           Eigen::AngleAxisf(thisPoint.pitch, Eigen::Vector3f::UnitY()) *
+           Eigen::AngleAxisf(thisPoint.roll, Eigen::Vector3f::UnitX()) *
+           Eigen::AngleAxisf(thisPoint.yaw, Eigen::Vector3f::UnitZ());
   }
 
   bool detectLoopClosure()
@@ -822,6 +873,11 @@ public:
     nearHistorySurfKeyFrameCloudDS->clear();
 
     std::lock_guard<std::mutex> lock(mtx);
+    ros::WallTime timeStart = ros::WallTime::now();
+    // 以已有描述子的关键帧为准, 描述子在关键帧位姿和点云入队后才加入
+    latestFrameIDLoopCloure = scanContext.size() - 1;
+    if (latestFrameIDLoopCloure < 0)
+      return false;
     // find the closest history key frame
     std::vector<int> pointSearchIndLoop;
     std::vector<float> pointSearchSqDisLoop;
@@ -830,21 +886,42 @@ public:
                                         pointSearchSqDisLoop, 0);
 
     closestHistoryFrameID = -1;
+    float scanContextYaw = 0;
     for (int i = 0; i < pointSearchIndLoop.size(); ++i)
     {
       int id = pointSearchIndLoop[i];
-      if (abs(cloudKeyPoses6D->points[id].time - timeLaserOdometry) > 30.0)
+      if (id < latestFrameIDLoopCloure && abs(cloudKeyPoses6D->points[id].time - timeLaserOdometry) > 30.0)
       {
-        closestHistoryFrameID = id;
+        // 描述子差异过大的近邻不做ICP
+        if (scanContext.distance(latestFrameIDLoopCloure, id, scanContextYaw) < scanContextGateThreshold)
+          closestHistoryFrameID = id;
         break;
       }
     }
+    loopInitialGuess = Eigen::Matrix4f::Identity();
+    // 位置附近没有候选时(如里程计漂移), 用描述子检索全部历史关键帧
+    if (closestHistoryFrameID == -1)
+    {
+      int matchId;
+      float matchDist;
+      if (scanContext.detectLoop(latestFrameIDLoopCloure, 30.0, matchId, matchDist, scanContextYaw) &&
+          matchDist < scanContextDistThreshold)
+      {
+        closestHistoryFrameID = matchId;
+        // 把当前帧放到候选帧处并转过描述子给出的相对航向, 作为ICP初值
+        Eigen::Affine3f guess = pclPointToAffine3fCamera(cloudKeyPoses6D->points[matchId]) *
+                                Eigen::AngleAxisf(scanContextYaw, Eigen::Vector3f::UnitY()) *
+                                pclPointToAffine3fCamera(cloudKeyPoses6D->points[latestFrameIDLoopCloure]).inverse();
+        loopInitialGuess = guess.matrix();
+      }
+    }
+    ++loopDetectCount;
+    loopDetectTime += (ros::WallTime::now() - timeStart).toSec() * 1000;
     if (closestHistoryFrameID == -1)
     {
       return false;
     }
     // save latest key frames
-    latestFrameIDLoopCloure = cloudKeyPoses3D->points.size() - 1;
     *latestSurfKeyFrameCloud += *transformPointCloud(cornerCloudKeyFrames[latestFrameIDLoopCloure],
                                                      &cloudKeyPoses6D->points[latestFrameIDLoopCloure]);
     *latestSurfKeyFrameCloud += *transformPointCloud(surfCloudKeyFrames[latestFrameIDLoopCloure],
@@ -915,10 +992,14 @@ public:
     icp.setInputSource(latestSurfKeyFrameCloud);
     icp.setInputTarget(nearHistorySurfKeyFrameCloudDS);
     pcl::PointCloud<PointType>::Ptr unused_result(new pcl::PointCloud<PointType>());
-    icp.align(*unused_result);
+    ros::WallTime timeStart = ros::WallTime::now();
+    icp.align(*unused_result, loopInitialGuess);
+    ++loopIcpCount;
+    loopIcpTime += (ros::WallTime::now() - timeStart).toSec() * 1000;
 
     if (icp.hasConverged() == false || icp.getFitnessScore() > historyKeyframeFitnessScore)
       return;
+    ++loopAcceptCount;
     // publish corrected cloud
     if (pubIcpKeyFrames.getNumSubscribers() != 0)
     {
@@ -981,131 +1062,52 @@ public:
     if (cloudKeyPoses3D->points.empty() == true)
       return;
 
-    if (loopClosureEnableFlag == true)
+    int numPoses = cloudKeyPoses3D->points.size();
+    if (localMapNeedRebuild == true)
     {
-      // only use recent key poses for graph building
-      if (recentCornerCloudKeyFrames.size() < surroundingKeyframeSearchNum)
-      {  // queue is not full (the beginning of mapping or a loop is just closed)
-        // clear recent key frames queue
-        recentCornerCloudKeyFrames.clear();
-        recentSurfCloudKeyFrames.clear();
-        recentOutlierCloudKeyFrames.clear();
-        int numPoses = cloudKeyPoses3D->points.size();
-        for (int i = numPoses - 1; i >= 0; --i)
-        {
-          int thisKeyInd = (int)cloudKeyPoses3D->points[i].intensity;
-          PointTypePose thisTransformation = cloudKeyPoses6D->points[thisKeyInd];
-          updateTransformPointCloudSinCos(&thisTransformation);
-          // extract surrounding map
-          recentCornerCloudKeyFrames.push_front(transformPointCloud(cornerCloudKeyFrames[thisKeyInd]));
-          recentSurfCloudKeyFrames.push_front(transformPointCloud(surfCloudKeyFrames[thisKeyInd]));
-          recentOutlierCloudKeyFrames.push_front(transformPointCloud(outlierCloudKeyFrames[thisKeyInd]));
-          if (recentCornerCloudKeyFrames.size() >= surroundingKeyframeSearchNum)
-            break;
-        }
-      }
-      else
-      {  // queue is full, pop the oldest key frame and push the latest key frame
-        if (latestFrameID != cloudKeyPoses3D->points.size() - 1)
-        {  // if the robot is not moving, no need to update recent frames
-
-          recentCornerCloudKeyFrames.pop_front();
-          recentSurfCloudKeyFrames.pop_front();
-          recentOutlierCloudKeyFrames.pop_front();
-          // push latest scan to the end of queue
-          latestFrameID = cloudKeyPoses3D->points.size() - 1;
-          PointTypePose thisTransformation = cloudKeyPoses6D->points[latestFrameID];
-          updateTransformPointCloudSinCos(&thisTransformation);
-          recentCornerCloudKeyFrames.push_back(transformPointCloud(cornerCloudKeyFrames[latestFrameID]));
-          recentSurfCloudKeyFrames.push_back(transformPointCloud(surfCloudKeyFrames[latestFrameID]));
-          recentOutlierCloudKeyFrames.push_back(transformPointCloud(outlierCloudKeyFrames[latestFrameID]));
-        }
-      }
-
-      for (int i = 0; i < recentCornerCloudKeyFrames.size(); ++i)
+      // 关键帧位姿整体变化,用最近的关键帧重建局部地图
+      for (int i = std::max(0, numPoses - surroundingKeyframeSearchNum); i < numPoses; ++i)
       {
-        *laserCloudCornerFromMap += *recentCornerCloudKeyFrames[i];
-        *laserCloudSurfFromMap += *recentSurfCloudKeyFrames[i];
-        *laserCloudSurfFromMap += *recentOutlierCloudKeyFrames[i];
+        PointTypePose thisTransformation = cloudKeyPoses6D->points[i];
+        updateTransformPointCloudSinCos(&thisTransformation);
+        *laserCloudCornerFromMap += *transformPointCloud(cornerCloudKeyFrames[i]);
+        *laserCloudSurfFromMap += *transformPointCloud(surfCloudKeyFrames[i]);
+        *laserCloudSurfFromMap += *transformPointCloud(outlierCloudKeyFrames[i]);
       }
+      downSizeFilterCorner.setInputCloud(laserCloudCornerFromMap);
+      downSizeFilterCorner.filter(*laserCloudCornerFromMapDS);
+      downSizeFilterSurf.setInputCloud(laserCloudSurfFromMap);
+      downSizeFilterSurf.filter(*laserCloudSurfFromMapDS);
+      ikdtreeCornerFromMap.build(laserCloudCornerFromMapDS->points);
+      ikdtreeSurfFromMap.build(laserCloudSurfFromMapDS->points);
+      localMapNeedRebuild = false;
     }
-    else
+    else if (latestFrameID != numPoses - 1)
     {
-      surroundingKeyPoses->clear();
-      surroundingKeyPosesDS->clear();
-      // extract all the nearby key poses and downsample them
-      kdtreeSurroundingKeyPoses->setInputCloud(cloudKeyPoses3D);
-      kdtreeSurroundingKeyPoses->radiusSearch(currentRobotPosPoint, (double)surroundingKeyframeSearchRadius,
-                                              pointSearchInd, pointSearchSqDis, 0);
-      for (int i = 0; i < pointSearchInd.size(); ++i)
-        surroundingKeyPoses->points.push_back(cloudKeyPoses3D->points[pointSearchInd[i]]);
-      downSizeFilterSurroundingKeyPoses.setInputCloud(surroundingKeyPoses);
-      downSizeFilterSurroundingKeyPoses.filter(*surroundingKeyPosesDS);
-      // delete key frames that are not in surrounding region
-      int numSurroundingPosesDS = surroundingKeyPosesDS->points.size();
-      for (int i = 0; i < surroundingExistingKeyPosesID.size(); ++i)
-      {
-        bool existingFlag = false;
-        for (int j = 0; j < numSurroundingPosesDS; ++j)
-        {
-          if (surroundingExistingKeyPosesID[i] == (int)surroundingKeyPosesDS->points[j].intensity)
-          {
-            existingFlag = true;
-            break;
-          }
-        }
-        if (existingFlag == false)
-        {
-          surroundingExistingKeyPosesID.erase(surroundingExistingKeyPosesID.begin() + i);
-          surroundingCornerCloudKeyFrames.erase(surroundingCornerCloudKeyFrames.begin() + i);
-          surroundingSurfCloudKeyFrames.erase(surroundingSurfCloudKeyFrames.begin() + i);
-          surroundingOutlierCloudKeyFrames.erase(surroundingOutlierCloudKeyFrames.begin() + i);
-          --i;
-        }
-      }
-      // add new key frames that are not in calculated existing key frames
-      for (int i = 0; i < numSurroundingPosesDS; ++i)
-      {
-        bool existingFlag = false;
-        for (auto iter = surroundingExistingKeyPosesID.begin(); iter != surroundingExistingKeyPosesID.end(); ++iter)
-        {
-          if ((*iter) == (int)surroundingKeyPosesDS->points[i].intensity)
-          {
-            existingFlag = true;
-            break;
-          }
-        }
-        if (existingFlag == true)
-        {
-          continue;
-        }
-        else
-        {
-          int thisKeyInd = (int)surroundingKeyPosesDS->points[i].intensity;
-          PointTypePose thisTransformation = cloudKeyPoses6D->points[thisKeyInd];
-          updateTransformPointCloudSinCos(&thisTransformation);
-          surroundingExistingKeyPosesID.push_back(thisKeyInd);
-          surroundingCornerCloudKeyFrames.push_back(transformPointCloud(cornerCloudKeyFrames[thisKeyInd]));
-          surroundingSurfCloudKeyFrames.push_back(transformPointCloud(surfCloudKeyFrames[thisKeyInd]));
-          surroundingOutlierCloudKeyFrames.push_back(transformPointCloud(outlierCloudKeyFrames[thisKeyInd]));
-        }
-      }
-
-      for (int i = 0; i < surroundingExistingKeyPosesID.size(); ++i)
+      // 只变换并插入新关键帧,插入时按体素大小去重,代替对整个局部地图重新滤波
+      for (int i = latestFrameID + 1; i < numPoses; ++i)
       {
-        *laserCloudCornerFromMap += *surroundingCornerCloudKeyFrames[i];
-        *laserCloudSurfFromMap += *surroundingSurfCloudKeyFrames[i];
-        *laserCloudSurfFromMap += *surroundingOutlierCloudKeyFrames[i];
+        PointTypePose thisTransformation = cloudKeyPoses6D->points[i];
+        updateTransformPointCloudSinCos(&thisTransformation);
+        ikdtreeCornerFromMap.addPoints(transformPointCloud(cornerCloudKeyFrames[i])->points, 0.2);
+        ikdtreeSurfFromMap.addPoints(transformPointCloud(surfCloudKeyFrames[i])->points, 0.4);
+        ikdtreeSurfFromMap.addPoints(transformPointCloud(outlierCloudKeyFrames[i])->points, 0.4);
       }
+      // 删除离开局部窗口的点
+      const PointType& thisPose = cloudKeyPoses3D->points[numPoses - 1];
+      IncrementalKdTree<PointType>::Box localBox;
+      localBox.min[0] = thisPose.x - surroundingKeyframeSearchRadius;
+      localBox.min[1] = thisPose.y - surroundingKeyframeSearchRadius;
+      localBox.min[2] = thisPose.z - surroundingKeyframeSearchRadius;
+      localBox.max[0] = thisPose.x + surroundingKeyframeSearchRadius;
+      localBox.max[1] = thisPose.y + surroundingKeyframeSearchRadius;
+      localBox.max[2] = thisPose.z + surroundingKeyframeSearchRadius;
+      ikdtreeCornerFromMap.deleteOutsideBox(localBox);
+      ikdtreeSurfFromMap.deleteOutsideBox(localBox);
     }
-    // Downsample the surrounding corner key frames (or map)
-    downSizeFilterCorner.setInputCloud(laserCloudCornerFromMap);
-    downSizeFilterCorner.filter(*laserCloudCornerFromMapDS);
-    laserCloudCornerFromMapDSNum = laserCloudCornerFromMapDS->points.size();
-    // Downsample the surrounding surf key frames (or map)
-    downSizeFilterSurf.setInputCloud(laserCloudSurfFromMap);
-    downSizeFilterSurf.filter(*laserCloudSurfFromMapDS);
-    laserCloudSurfFromMapDSNum = laserCloudSurfFromMapDS->points.size();
+    latestFrameID = numPoses - 1;
+    laserCloudCornerFromMapDSNum = ikdtreeCornerFromMap.size();
+    laserCloudSurfFromMapDSNum = ikdtreeSurfFromMap.size();
   }
 
   void downsampleCurrentScan()
@@ -1137,102 +1139,116 @@ public:
   void cornerOptimization(int iterCount)
   {
     updatePointAssociateToMapSinCos();
-    for (int i = 0; i < laserCloudCornerLastDSNum; i++)
+    // 每个点的结果写入各自的槽位,合并时按点序取出,与线程数无关
+#pragma omp parallel num_threads(numberOfCores)
     {
-      pointOri = laserCloudCornerLastDS->points[i];
-      pointAssociateToMap(&pointOri, &pointSel);
-      kdtreeCornerFromMap->nearestKSearch(pointSel, 5, pointSearchInd, pointSearchSqDis);
-
-      if (pointSearchSqDis[4] < 1.0)
+      // 近邻缓冲区每个线程只分配一次,逐点查询时复用
+      pcl::PointCloud<PointType>::VectorType pointSearchNeighbors;
+      std::vector<float> pointSearchSqDis;
+#pragma omp for schedule(dynamic, 64)
+      for (int i = 0; i < laserCloudCornerLastDSNum; i++)
       {
-        float cx = 0, cy = 0, cz = 0;
-        for (int j = 0; j < 5; j++)
+        PointType pointOri, pointSel, coeff;
+        cv::Matx33f matA1;
+        cv::Matx31f matD1;
+        cv::Matx33f matV1;
+        laserCloudOriCornerFlag[i] = 0;
+        pointOri = laserCloudCornerLastDS->points[i];
+        pointAssociateToMap(&pointOri, &pointSel);
+        ikdtreeCornerFromMap.nearestKSearch(pointSel, 5, pointSearchNeighbors, pointSearchSqDis);
+
+        if (pointSearchSqDis[4] < 1.0)
         {
-          cx += laserCloudCornerFromMapDS->points[pointSearchInd[j]].x;
-          cy += laserCloudCornerFromMapDS->points[pointSearchInd[j]].y;
-          cz += laserCloudCornerFromMapDS->points[pointSearchInd[j]].z;
-        }
-        cx /= 5;
-        cy /= 5;
-        cz /= 5;
-
-        float a11 = 0, a12 = 0, a13 = 0, a22 = 0, a23 = 0, a33 = 0;
-        for (int j = 0; j < 5; j++)
-        {
-          float ax = laserCloudCornerFromMapDS->points[pointSearchInd[j]].x - cx;
-          float ay = laserCloudCornerFromMapDS->points[pointSearchInd[j]].y - cy;
-          float az = laserCloudCornerFromMapDS->points[pointSearchInd[j]].z - cz;
-
-          a11 += ax * ax;
-          a12 += ax * ay;
-          a13 += ax * az;
-          a22 += ay * ay;
-          a23 += ay * az;
-          a33 += az * az;
-        }
-        a11 /= 5;
-        a12 /= 5;
-        a13 /= 5;
-        a22 /= 5;
-        a23 /= 5;
-        a33 /= 5;
-
-        matA1.at<float>(0, 0) = a11;
-        matA1.at<float>(0, 1) = a12;
-        matA1.at<float>(0, 2) = a13;
-        matA1.at<float>(1, 0) = a12;
-        matA1.at<float>(1, 1) = a22;
-        matA1.at<float>(1, 2) = a23;
-        matA1.at<float>(2, 0) = a13;
-        matA1.at<float>(2, 1) = a23;
-        matA1.at<float>(2, 2) = a33;
-
-        cv::eigen(matA1, matD1, matV1);
-
-        if (matD1.at<float>(0, 0) > 3 * matD1.at<float>(0, 1))
-        {
-          float x0 = pointSel.x;
-          float y0 = pointSel.y;
-          float z0 = pointSel.z;
-          float x1 = cx + 0.1 * matV1.at<float>(0, 0);
-          float y1 = cy + 0.1 * matV1.at<float>(0, 1);
-          float z1 = cz + 0.1 * matV1.at<float>(0, 2);
-          float x2 = cx - 0.1 * matV1.at<float>(0, 0);
-          float y2 = cy - 0.1 * matV1.at<float>(0, 1);
-          float z2 = cz - 0.1 * matV1.at<float>(0, 2);
-
-          float a012 =
-              sqrt(((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) +
-                   ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) +
-                   ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1)) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1)));
-
-          float l12 = sqrt((x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2) + (z1 - z2) * (z1 - z2));
-
-          float la = ((y1 - y2) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) +
-                      (z1 - z2) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1))) /
-                     a012 / l12;
-
-          float lb = -((x1 - x2) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) -
-                       (z1 - z2) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1))) /
-                     a012 / l12;
-
-          float lc = -((x1 - x2) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) +
-                       (y1 - y2) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1))) /
-                     a012 / l12;
-
-          float ld2 = a012 / l12;
-
-          float s = 1 - 0.9 * fabs(ld2);
-
-          coeff.x = s * la;
-          coeff.y = s * lb;
-          coeff.z = s * lc;
-          coeff.intensity = s * ld2;
+          float cx = 0, cy = 0, cz = 0;
+          for (int j = 0; j < 5; j++)
+          {
+            cx += pointSearchNeighbors[j].x;
+            cy += pointSearchNeighbors[j].y;
+            cz += pointSearchNeighbors[j].z;
+          }
+          cx /= 5;
+          cy /= 5;
+          cz /= 5;
 
-          if (s > 0.1)
+          float a11 = 0, a12 = 0, a13 = 0, a22 = 0, a23 = 0, a33 = 0;
+          for (int j = 0; j < 5; j++)
           {
-            laserCloudOri->push_back(pointOri);
-            coeffSel->push_back(coeff);
+            float ax = pointSearchNeighbors[j].x - cx;
+            float ay = pointSearchNeighbors[j].y - cy;
+            float az = pointSearchNeighbors[j].z - cz;
+
+            a11 += ax * ax;
+            a12 += ax * ay;
+            a13 += ax * az;
+            a22 += ay * ay;
+            a23 += ay * az;
+            a33 += az * az;
+          }
+          a11 /= 5;
+          a12 /= 5;
+          a13 /= 5;
+          a22 /= 5;
+          a23 /= 5;
+          a33 /= 5;
+
+          matA1(0, 0) = a11;
+          matA1(0, 1) = a12;
+          matA1(0, 2) = a13;
+          matA1(1, 0) = a12;
+          matA1(1, 1) = a22;
+          matA1(1, 2) = a23;
+          matA1(2, 0) = a13;
+          matA1(2, 1) = a23;
+          matA1(2, 2) = a33;
+
+          cv::eigen(matA1, matD1, matV1);
+
+          if (matD1(0, 0) > 3 * matD1(1, 0))
+          {
+            float x0 = pointSel.x;
+            float y0 = pointSel.y;
+            float z0 = pointSel.z;
+            float x1 = cx + 0.1 * matV1(0, 0);
+            float y1 = cy + 0.1 * matV1(0, 1);
+            float z1 = cz + 0.1 * matV1(0, 2);
+            float x2 = cx - 0.1 * matV1(0, 0);
+            float y2 = cy - 0.1 * matV1(0, 1);
+            float z2 = cz - 0.1 * matV1(0, 2);
+
+            float a012 =
+                sqrt(((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) +
+                     ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) +
+                     ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1)) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1)));
+
+            float l12 = sqrt((x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2) + (z1 - z2) * (z1 - z2));
+
+            float la = ((y1 - y2) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) +
+                        (z1 - z2) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1))) /
+                       a012 / l12;
+
+            float lb = -((x1 - x2) * ((x0 - x1) * (y0 - y2) - (x0 - x2) * (y0 - y1)) -
+                         (z1 - z2) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1))) /
+                       a012 / l12;
+
+            float lc = -((x1 - x2) * ((x0 - x1) * (z0 - z2) - (x0 - x2) * (z0 - z1)) +
+                         (y1 - y2) * ((y0 - y1) * (z0 - z2) - (y0 - y2) * (z0 - z1))) /
+                       a012 / l12;
+
+            float ld2 = a012 / l12;
+
+            float s = 1 - 0.9 * fabs(ld2);
+
+            coeff.x = s * la;
+            coeff.y = s * lb;
+            coeff.z = s * lc;
+            coeff.intensity = s * ld2;
+
+            if (s > 0.1)
+            {
+              laserCloudOriCornerVec[i] = pointOri;
+              coeffSelCornerVec[i] = coeff;
+              laserCloudOriCornerFlag[i] = 1;
+            }
           }
         }
       }
@@ -1242,68 +1258,101 @@ public:
   void surfOptimization(int iterCount)
   {
     updatePointAssociateToMapSinCos();
-    for (int i = 0; i < laserCloudSurfTotalLastDSNum; i++)
+    // 每个点的结果写入各自的槽位,合并时按点序取出,与线程数无关
+#pragma omp parallel num_threads(numberOfCores)
     {
-      pointOri = laserCloudSurfTotalLastDS->points[i];
-      pointAssociateToMap(&pointOri, &pointSel);
-      kdtreeSurfFromMap->nearestKSearch(pointSel, 5, pointSearchInd, pointSearchSqDis);
-
-      if (pointSearchSqDis[4] < 1.0)
+      // 近邻缓冲区每个线程只分配一次,逐点查询时复用
+      pcl::PointCloud<PointType>::VectorType pointSearchNeighbors;
+      std::vector<float> pointSearchSqDis;
+#pragma omp for schedule(dynamic, 64)
+      for (int i = 0; i < laserCloudSurfTotalLastDSNum; i++)
       {
-        for (int j = 0; j < 5; j++)
+        PointType pointOri, pointSel, coeff;
+        cv::Matx<float, 5, 3> matA0;
+        cv::Matx<float, 5, 1> matB0(-1, -1, -1, -1, -1);
+        cv::Matx31f matX0;
+        laserCloudOriSurfFlag[i] = 0;
+        pointOri = laserCloudSurfTotalLastDS->points[i];
+        pointAssociateToMap(&pointOri, &pointSel);
+        ikdtreeSurfFromMap.nearestKSearch(pointSel, 5, pointSearchNeighbors, pointSearchSqDis);
+
+        if (pointSearchSqDis[4] < 1.0)
         {
-          matA0.at<float>(j, 0) = laserCloudSurfFromMapDS->points[pointSearchInd[j]].x;
-          matA0.at<float>(j, 1) = laserCloudSurfFromMapDS->points[pointSearchInd[j]].y;
-          matA0.at<float>(j, 2) = laserCloudSurfFromMapDS->points[pointSearchInd[j]].z;
-        }
-        cv::solve(matA0, matB0, matX0, cv::DECOMP_QR);
-
-        float pa = matX0.at<float>(0, 0);
-        float pb = matX0.at<float>(1, 0);
-        float pc = matX0.at<float>(2, 0);
-        float pd = 1;
-
-        float ps = sqrt(pa * pa + pb * pb + pc * pc);
-        pa /= ps;
-        pb /= ps;
-        pc /= ps;
-        pd /= ps;
-
-        bool planeValid = true;
-        for (int j = 0; j < 5; j++)
-        {
-          if (fabs(pa * laserCloudSurfFromMapDS->points[pointSearchInd[j]].x +
-                   pb * laserCloudSurfFromMapDS->points[pointSearchInd[j]].y +
-                   pc * laserCloudSurfFromMapDS->points[pointSearchInd[j]].z + pd) > 0.2)
+          for (int j = 0; j < 5; j++)
           {
-            planeValid = false;
-            break;
+            matA0(j, 0) = pointSearchNeighbors[j].x;
+            matA0(j, 1) = pointSearchNeighbors[j].y;
+            matA0(j, 2) = pointSearchNeighbors[j].z;
           }
-        }
+          cv::solve(matA0, matB0, matX0, cv::DECOMP_QR);
 
-        if (planeValid)
-        {
-          float pd2 = pa * pointSel.x + pb * pointSel.y + pc * pointSel.z + pd;
+          float pa = matX0(0, 0);
+          float pb = matX0(1, 0);
+          float pc = matX0(2, 0);
+          float pd = 1;
 
-          float s =
-              1 -
-              0.9 * fabs(pd2) / sqrt(sqrt(pointSel.x * pointSel.x + pointSel.y * pointSel.y + pointSel.z * pointSel.z));
+          float ps = sqrt(pa * pa + pb * pb + pc * pc);
+          pa /= ps;
+          pb /= ps;
+          pc /= ps;
+          pd /= ps;
 
-          coeff.x = s * pa;
-          coeff.y = s * pb;
-          coeff.z = s * pc;
-          coeff.intensity = s * pd2;
+          bool planeValid = true;
+          for (int j = 0; j < 5; j++)
+          {
+            if (fabs(pa * pointSearchNeighbors[j].x +
+                     pb * pointSearchNeighbors[j].y +
+                     pc * pointSearchNeighbors[j].z + pd) > 0.2)
+            {
+              planeValid = false;
+              break;
+            }
+          }
 
-          if (s > 0.1)
+          if (planeValid)
           {
-            laserCloudOri->push_back(pointOri);
-            coeffSel->push_back(coeff);
+            float pd2 = pa * pointSel.x + pb * pointSel.y + pc * pointSel.z + pd;
+
+            float s = 1 - 0.9 * fabs(pd2) /
+                              sqrt(sqrt(pointSel.x * pointSel.x + pointSel.y * pointSel.y + pointSel.z * pointSel.z));
+
+            coeff.x = s * pa;
+            coeff.y = s * pb;
+            coeff.z = s * pc;
+            coeff.intensity = s * pd2;
+
+            if (s > 0.1)
+            {
+              laserCloudOriSurfVec[i] = pointOri;
+              coeffSelSurfVec[i] = coeff;
+              laserCloudOriSurfFlag[i] = 1;
+            }
           }
         }
       }
     }
   }
 
+  void combineOptimizationCoeffs()
+  {
+    for (int i = 0; i < laserCloudCornerLastDSNum; i++)
+    {
+      if (laserCloudOriCornerFlag[i])
+      {
+        laserCloudOri->push_back(laserCloudOriCornerVec[i]);
+        coeffSel->push_back(coeffSelCornerVec[i]);
+      }
+    }
+    for (int i = 0; i < laserCloudSurfTotalLastDSNum; i++)
+    {
+      if (laserCloudOriSurfFlag[i])
+      {
+        laserCloudOri->push_back(laserCloudOriSurfVec[i]);
+        coeffSel->push_back(coeffSelSurfVec[i]);
+      }
+    }
+  }
+
   bool LMOptimization(int iterCount)
   {
     float srx = sin(transformTobeMapped[0]);
@@ -1319,16 +1368,14 @@ public:
       return false;
     }
 
-    cv::Mat matA(laserCloudSelNum, 6, CV_32F, cv::Scalar::all(0));
-    cv::Mat matAt(6, laserCloudSelNum, CV_32F, cv::Scalar::all(0));
-    cv::Mat matAtA(6, 6, CV_32F, cv::Scalar::all(0));
-    cv::Mat matB(laserCloudSelNum, 1, CV_32F, cv::Scalar::all(0));
-    cv::Mat matAtB(6, 1, CV_32F, cv::Scalar::all(0));
-    cv::Mat matX(6, 1, CV_32F, cv::Scalar::all(0));
+    // 直接累加法方程A'A与A'b, 不再构造N*6的雅可比矩阵
+    // 按点序用double累加, 求解前才转成float, 结果与特征点计算的线程数无关, 单线程与多线程逐位相同
+    double ata[6][6] = { { 0 } };
+    double atb[6] = { 0 };
     for (int i = 0; i < laserCloudSelNum; i++)
     {
-      pointOri = laserCloudOri->points[i];
-      coeff = coeffSel->points[i];
+      const PointType &pointOri = laserCloudOri->points[i];
+      const PointType &coeff = coeffSel->points[i];
 
       float arx = (crx * sry * srz * pointOri.x + crx * crz * sry * pointOri.y - srx * sry * pointOri.z) * coeff.x +
                   (-srx * srz * pointOri.x - crz * srx * pointOri.y - crx * pointOri.z) * coeff.y +
@@ -1345,17 +1392,27 @@ public:
                   (crx * crz * pointOri.x - crx * srz * pointOri.y) * coeff.y +
                   ((sry * srz + cry * crz * srx) * pointOri.x + (crz * sry - cry * srx * srz) * pointOri.y) * coeff.z;
 
-      matA.at<float>(i, 0) = arx;
-      matA.at<float>(i, 1) = ary;
-      matA.at<float>(i, 2) = arz;
-      matA.at<float>(i, 3) = coeff.x;
-      matA.at<float>(i, 4) = coeff.y;
-      matA.at<float>(i, 5) = coeff.z;
-      matB.at<float>(i, 0) = -coeff.intensity;
+      const float jac[6] = { arx, ary, arz, coeff.x, coeff.y, coeff.z };
+      for (int r = 0; r < 6; r++)
+      {
+        for (int c = r; c < 6; c++)
+          ata[r][c] += (double)jac[r] * jac[c];
+        atb[r] -= (double)jac[r] * coeff.intensity;
+      }
+    }
+
+    cv::Mat matAtA(6, 6, CV_32F, cv::Scalar::all(0));
+    cv::Mat matAtB(6, 1, CV_32F, cv::Scalar::all(0));
+    cv::Mat matX(6, 1, CV_32F, cv::Scalar::all(0));
+    for (int r = 0; r < 6; r++)
+    {
+      for (int c = r; c < 6; c++)
+      {
+        matAtA.at<float>(r, c) = (float)ata[r][c];
+        matAtA.at<float>(c, r) = (float)ata[r][c];
+      }
+      matAtB.at<float>(r, 0) = (float)atb[r];
     }
-    cv::transpose(matA, matAt);
-    matAtA = matAt * matA;
-    matAtB = matAt * matB;
     cv::solve(matAtA, matAtB, matX, cv::DECOMP_QR);
 
     if (iterCount == 0)
@@ -1417,8 +1474,12 @@ public:
   {
     if (laserCloudCornerFromMapDSNum > 10 && laserCloudSurfFromMapDSNum > 100)
     {
-      kdtreeCornerFromMap->setInputCloud(laserCloudCornerFromMapDS);
-      kdtreeSurfFromMap->setInputCloud(laserCloudSurfFromMapDS);
+      laserCloudOriCornerVec.resize(laserCloudCornerLastDSNum);
+      coeffSelCornerVec.resize(laserCloudCornerLastDSNum);
+      laserCloudOriCornerFlag.resize(laserCloudCornerLastDSNum);
+      laserCloudOriSurfVec.resize(laserCloudSurfTotalLastDSNum);
+      coeffSelSurfVec.resize(laserCloudSurfTotalLastDSNum);
+      laserCloudOriSurfFlag.resize(laserCloudSurfTotalLastDSNum);
 
       for (int iterCount = 0; iterCount < 10; iterCount++)
       {
@@ -1427,6 +1488,7 @@ public:
 
         cornerOptimization(iterCount);
         surfOptimization(iterCount);
+        combineOptimizationCoeffs();
 
         if (LMOptimization(iterCount) == true)
           break;
@@ -1493,6 +1555,8 @@ public:
 
     /**
      * save key poses
+     * 调用者run()在整个建图步骤中持有mtx, 关键帧位姿与点云在同一把锁内入队,
+     * 后台地图快照和回环检测不会看到只有位姿没有点云的关键帧
      */
     PointType thisPose3D;
     PointTypePose thisPose6D;
@@ -1547,15 +1611,15 @@ public:
         thisCornerKeyFrame);  // 这个地方保存了关键帧,看如何把保存的地图载入到这个地方 thisCornerKeyFrame
     surfCloudKeyFrames.push_back(thisSurfKeyFrame);
     outlierCloudKeyFrames.push_back(thisOutlierKeyFrame);
+    scanContextPendingCloud.reset(new pcl::PointCloud<PointType>(*thisCornerKeyFrame + *thisSurfKeyFrame));
+    scanContextPendingTime = timeLaserOdometry;
   }
 
   void correctPoses()
   {
     if (aLoopIsClosed == true)
     {
-      recentCornerCloudKeyFrames.clear();
-      recentSurfCloudKeyFrames.clear();
-      recentOutlierCloudKeyFrames.clear();
+      localMapNeedRebuild = true;
       // update key poses
       int numPoses = isamCurrentEstimate.size();
       for (int i = 0; i < numPoses; ++i)
@@ -1595,7 +1659,7 @@ public:
       newLaserCloudOutlierLast = false;
       newLaserOdometry = false;
 
-      std::lock_guard<std::mutex> lock(mtx);
+      std::unique_lock<std::mutex> lock(mtx);
 
       if (timeLaserOdometry - timeLastProcessing >= mappingProcessInterval)
       {
@@ -1619,6 +1683,17 @@ public:
 
         clearCloud();
       }
+      lock.unlock();
+
+      // 新关键帧的描述子在锁外计算, 只在加入索引时持锁, 不阻塞回环检测和地图快照
+      if (scanContextPendingCloud)
+      {
+        ScanContext::KeyFrame keyFrame;
+        scanContext.makeKeyFrame(scanContextPendingCloud->points, scanContextPendingTime, keyFrame);
+        scanContextPendingCloud.reset();
+        lock.lock();
+        scanContext.addKeyFrame(keyFrame);
+      }
     }
   }
 };
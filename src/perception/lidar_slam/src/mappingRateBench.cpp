@@ -0,0 +1,230 @@
+// 局部地图维护与scan-to-map近邻查询的耗时对比,换算为可达建图频率
+// 重建: 每步拼接最近surroundingKeyframeSearchNum帧,体素滤波后重建KdTreeFLANN
+// 增量: 每步只插入新关键帧并删除离开局部窗口的点
+// 用法: rosrun lego_loam mappingRateBench [关键帧数] [每帧优化迭代次数]
+#include <pcl/filters/voxel_grid.h>
+#include <pcl/kdtree/kdtree_flann.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "incremental_kdtree.h"
+
+typedef pcl::PointXYZI PointType;
+
+namespace
+{
+// 与mapOptmization保持一致
+const int surroundingKeyframeSearchNum = 50;
+const float surroundingKeyframeSearchRadius = 50.0;
+const float cornerLeafSize = 0.2;
+const float surfLeafSize = 0.4;
+const float keyframeStep = 0.3;  // 关键帧间距,单位米
+const int cornerPerFrame = 400;
+const int surfPerFrame = 2500;
+const int cornerQueries = 300;  // 当前帧降采样后的特征点数
+const int surfQueries = 1500;
+
+double nowMs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+float uniform(float lo, float hi)
+{
+  return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+// 沿y轴行驶的巷道场景: 两侧墙面与地面为面点,墙角竖线为角点
+void makeKeyFrame(float y0, pcl::PointCloud<PointType>& corner, pcl::PointCloud<PointType>& surf)
+{
+  corner.clear();
+  surf.clear();
+  PointType p;
+  p.intensity = 0;
+  for (int i = 0; i < cornerPerFrame; ++i)
+  {
+    float pole = floorf(uniform(y0 - 40, y0 + 40) / 5.0) * 5.0;
+    p.x = (i & 1) ? 8.0 : -8.0;
+    p.y = pole + uniform(-0.02, 0.02);
+    p.z = uniform(-1.5, 4.0);
+    corner.push_back(p);
+  }
+  for (int i = 0; i < surfPerFrame; ++i)
+  {
+    int plane = i % 3;
+    p.y = uniform(y0 - 40, y0 + 40);
+    if (plane == 2)
+    {
+      p.x = uniform(-8, 8);
+      p.z = -1.5 + uniform(-0.02, 0.02);
+    }
+    else
+    {
+      p.x = (plane ? 8.0 : -8.0) + uniform(-0.02, 0.02);
+      p.z = uniform(-1.5, 4.0);
+    }
+    surf.push_back(p);
+  }
+}
+
+// 当前帧特征点: 从当前关键帧中抽取并加入位姿误差量级的扰动
+void makeQueries(const pcl::PointCloud<PointType>& frame, int num, std::vector<PointType>& queries)
+{
+  queries.resize(num);
+  for (int i = 0; i < num; ++i)
+  {
+    queries[i] = frame.points[rand() % frame.size()];
+    queries[i].x += uniform(-0.05, 0.05);
+    queries[i].y += uniform(-0.05, 0.05);
+    queries[i].z += uniform(-0.05, 0.05);
+  }
+}
+
+struct Stats
+{
+  Stats() : mapMs(0), searchMs(0), maxStepMs(0), mapPoints(0), steps(0)
+  {
+  }
+  void add(double map, double search, int points)
+  {
+    mapMs += map;
+    searchMs += search;
+    maxStepMs = std::max(maxStepMs, map + search);
+    mapPoints += points;
+    ++steps;
+  }
+  void print(const char* name) const
+  {
+    double step = (mapMs + searchMs) / steps;
+    printf("%-12s map %7.2f ms  search %7.2f ms  step %7.2f ms (max %7.2f)  map points %7.0f  rate %6.1f Hz\n", name,
+           mapMs / steps, searchMs / steps, step, maxStepMs, (double)mapPoints / steps, 1000.0 / step);
+  }
+  double mapMs;
+  double searchMs;
+  double maxStepMs;
+  long mapPoints;
+  int steps;
+};
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  int frames = argc > 1 ? atoi(argv[1]) : 300;
+  int iterations = argc > 2 ? atoi(argv[2]) : 10;  // scan-to-map每帧LM迭代次数
+
+  srand(1);
+  std::vector<pcl::PointCloud<PointType>::Ptr> cornerFrames, surfFrames;
+  for (int i = 0; i < frames; ++i)
+  {
+    cornerFrames.push_back(pcl::PointCloud<PointType>::Ptr(new pcl::PointCloud<PointType>()));
+    surfFrames.push_back(pcl::PointCloud<PointType>::Ptr(new pcl::PointCloud<PointType>()));
+    makeKeyFrame(i * keyframeStep, *cornerFrames[i], *surfFrames[i]);
+  }
+
+  pcl::PointCloud<PointType>::Ptr cornerMap(new pcl::PointCloud<PointType>());
+  pcl::PointCloud<PointType>::Ptr surfMap(new pcl::PointCloud<PointType>());
+  pcl::PointCloud<PointType>::Ptr cornerMapDS(new pcl::PointCloud<PointType>());
+  pcl::PointCloud<PointType>::Ptr surfMapDS(new pcl::PointCloud<PointType>());
+  pcl::VoxelGrid<PointType> downSizeFilterCorner, downSizeFilterSurf;
+  downSizeFilterCorner.setLeafSize(cornerLeafSize, cornerLeafSize, cornerLeafSize);
+  downSizeFilterSurf.setLeafSize(surfLeafSize, surfLeafSize, surfLeafSize);
+  pcl::KdTreeFLANN<PointType> kdtreeCorner, kdtreeSurf;
+
+  IncrementalKdTree<PointType> ikdtreeCorner, ikdtreeSurf;
+
+  std::vector<PointType> cornerQuery, surfQuery;
+  std::vector<int> searchInd;
+  std::vector<float> searchSqDis;
+  std::vector<PointType> searchPoints;
+  double checksumRebuild = 0, checksumIncremental = 0;
+  Stats rebuildStats, incrementalStats;
+
+  for (int f = 0; f < frames; ++f)
+  {
+    makeQueries(*cornerFrames[f], cornerQueries, cornerQuery);
+    makeQueries(*surfFrames[f], surfQueries, surfQuery);
+
+    // 重建局部地图
+    double t0 = nowMs();
+    cornerMap->clear();
+    surfMap->clear();
+    for (int i = std::max(0, f + 1 - surroundingKeyframeSearchNum); i <= f; ++i)
+    {
+      *cornerMap += *cornerFrames[i];
+      *surfMap += *surfFrames[i];
+    }
+    downSizeFilterCorner.setInputCloud(cornerMap);
+    downSizeFilterCorner.filter(*cornerMapDS);
+    downSizeFilterSurf.setInputCloud(surfMap);
+    downSizeFilterSurf.filter(*surfMapDS);
+    kdtreeCorner.setInputCloud(cornerMapDS);
+    kdtreeSurf.setInputCloud(surfMapDS);
+    double t1 = nowMs();
+    for (int it = 0; it < iterations; ++it)
+    {
+      for (size_t i = 0; i < cornerQuery.size(); ++i)
+      {
+        kdtreeCorner.nearestKSearch(cornerQuery[i], 5, searchInd, searchSqDis);
+        checksumRebuild += searchSqDis[0];
+      }
+      for (size_t i = 0; i < surfQuery.size(); ++i)
+      {
+        kdtreeSurf.nearestKSearch(surfQuery[i], 5, searchInd, searchSqDis);
+        checksumRebuild += searchSqDis[0];
+      }
+    }
+    double t2 = nowMs();
+    rebuildStats.add(t1 - t0, t2 - t1, cornerMapDS->size() + surfMapDS->size());
+
+    // 增量维护局部地图
+    t0 = nowMs();
+    ikdtreeCorner.addPoints(cornerFrames[f]->points, cornerLeafSize);
+    ikdtreeSurf.addPoints(surfFrames[f]->points, surfLeafSize);
+    IncrementalKdTree<PointType>::Box localBox;
+    localBox.min[0] = -surroundingKeyframeSearchRadius;
+    localBox.min[1] = f * keyframeStep - surroundingKeyframeSearchRadius;
+    localBox.min[2] = -surroundingKeyframeSearchRadius;
+    localBox.max[0] = surroundingKeyframeSearchRadius;
+    localBox.max[1] = f * keyframeStep + surroundingKeyframeSearchRadius;
+    localBox.max[2] = surroundingKeyframeSearchRadius;
+    ikdtreeCorner.deleteOutsideBox(localBox);
+    ikdtreeSurf.deleteOutsideBox(localBox);
+    t1 = nowMs();
+    for (int it = 0; it < iterations; ++it)
+    {
+      for (size_t i = 0; i < cornerQuery.size(); ++i)
+      {
+        ikdtreeCorner.nearestKSearch(cornerQuery[i], 5, searchPoints, searchSqDis);
+        checksumIncremental += searchSqDis[0];
+      }
+      for (size_t i = 0; i < surfQuery.size(); ++i)
+      {
+        ikdtreeSurf.nearestKSearch(surfQuery[i], 5, searchPoints, searchSqDis);
+        checksumIncremental += searchSqDis[0];
+      }
+    }
+    t2 = nowMs();
+    incrementalStats.add(t1 - t0, t2 - t1, ikdtreeCorner.size() + ikdtreeSurf.size());
+  }
+
+  printf("%d keyframes, %d iterations x (%d corner + %d surf) queries per step\n", frames, iterations, cornerQueries,
+         surfQueries);
+  rebuildStats.print("rebuild");
+  incrementalStats.print("incremental");
+  // 两种地图的降采样方式不同,近邻距离只要求量级一致
+  printf("mean nearest sq dist: rebuild %.4f incremental %.4f, subtree rebuilds %d\n",
+         checksumRebuild / (rebuildStats.steps * iterations * (cornerQueries + surfQueries)),
+         checksumIncremental / (incrementalStats.steps * iterations * (cornerQueries + surfQueries)),
+         ikdtreeCorner.rebuilds() + ikdtreeSurf.rebuilds());
+  return 0;
+}
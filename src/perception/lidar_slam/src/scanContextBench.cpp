@@ -0,0 +1,225 @@
+// Scan Context回环检索的准确率/召回率与耗时测试
+// 合成场景: 随机建筑与杆状物组成的高度场, 沿矩形环路正向跑一圈后横向偏移反向再跑一圈,
+// 第二圈每个关键帧用detectLoop检索第一圈, 与真值(第一圈中距离最近且小于loopRadius的关键帧)比较
+// 用法: rosrun lego_loam scanContextBench [关键帧间距m] [回环判定半径m]
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <vector>
+
+#include "scan_context.h"
+
+namespace
+{
+struct Point
+{
+  float x, y, z;
+};
+
+const float worldSize = 400;    // 场景边长, 单位米
+const float cellSize = 1.0;     // 高度场分辨率
+const float sensorHeight = 2.0;  // 与ScanContext的heightOffset一致
+const float scanRange = 80.0;
+
+double nowMs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+float uniform(float lo, float hi)
+{
+  return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+class HeightField
+{
+public:
+  HeightField() : cells((int)(worldSize / cellSize)), heights(cells * cells, 0.0f)
+  {
+    // 建筑
+    for (int i = 0; i < 250; ++i)
+      fillBox(uniform(0, worldSize), uniform(0, worldSize), uniform(5, 25), uniform(5, 25), uniform(3, 20));
+    // 杆状物与树
+    for (int i = 0; i < 1500; ++i)
+      fillBox(uniform(0, worldSize), uniform(0, worldSize), 1, 1, uniform(2, 8));
+  }
+
+  // 道路上清空, 保证车辆行驶区域可见
+  void clearRoad(float x0, float y0, float x1, float y1, float halfWidth)
+  {
+    float len = hypot(x1 - x0, y1 - y0);
+    for (float s = 0; s <= len; s += cellSize * 0.5)
+    {
+      float x = x0 + (x1 - x0) * s / len;
+      float y = y0 + (y1 - y0) * s / len;
+      for (float d = -halfWidth; d <= halfWidth; d += cellSize * 0.5)
+      {
+        float cx = x - (y1 - y0) / len * d;
+        float cy = y + (x1 - x0) / len * d;
+        int ix = (int)(cx / cellSize), iy = (int)(cy / cellSize);
+        if (ix >= 0 && iy >= 0 && ix < cells && iy < cells)
+          heights[iy * cells + ix] = 0;
+      }
+    }
+  }
+
+  // 以(x, y, yaw)为原点的局部扫描, camera系: z向前, x向左, y向上
+  void scan(float x, float y, float yaw, float noise, std::vector<Point>& points) const
+  {
+    points.clear();
+    float c = cos(yaw), s = sin(yaw);
+    int r = (int)(scanRange / cellSize);
+    int cx = (int)(x / cellSize), cy = (int)(y / cellSize);
+    for (int iy = std::max(0, cy - r); iy <= std::min(cells - 1, cy + r); ++iy)
+    {
+      for (int ix = std::max(0, cx - r); ix <= std::min(cells - 1, cx + r); ++ix)
+      {
+        float h = heights[iy * cells + ix];
+        if (h <= 0)
+          continue;
+        float dx = (ix + 0.5f) * cellSize - x + uniform(-noise, noise);
+        float dy = (iy + 0.5f) * cellSize - y + uniform(-noise, noise);
+        Point p;
+        p.z = c * dx + s * dy;
+        p.x = -s * dx + c * dy;
+        p.y = h - sensorHeight + uniform(-noise, noise);
+        points.push_back(p);
+      }
+    }
+  }
+
+private:
+  void fillBox(float x, float y, float w, float l, float h)
+  {
+    for (int iy = (int)(y / cellSize); iy < (int)((y + l) / cellSize) && iy < cells; ++iy)
+      for (int ix = (int)(x / cellSize); ix < (int)((x + w) / cellSize) && ix < cells; ++ix)
+        heights[iy * cells + ix] = std::max(heights[iy * cells + ix], h);
+  }
+
+  int cells;
+  std::vector<float> heights;
+};
+
+struct Pose
+{
+  float x, y, yaw;
+  double time;
+};
+
+// 沿折线按等间距采样位姿, offset为向左的横向偏移
+void samplePath(const std::vector<Point>& corners, float step, float offset, double& time, std::vector<Pose>& poses)
+{
+  for (size_t i = 0; i + 1 < corners.size(); ++i)
+  {
+    float dx = corners[i + 1].x - corners[i].x;
+    float dy = corners[i + 1].y - corners[i].y;
+    float len = hypot(dx, dy);
+    float yaw = atan2(dy, dx);
+    for (float s = 0; s < len; s += step)
+    {
+      Pose p;
+      p.x = corners[i].x + dx * s / len - sin(yaw) * offset;
+      p.y = corners[i].y + dy * s / len + cos(yaw) * offset;
+      p.yaw = yaw + uniform(-0.05, 0.05);
+      p.time = time;
+      time += 1.0;
+      poses.push_back(p);
+    }
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  float step = argc > 1 ? atof(argv[1]) : 3.0;
+  float loopRadius = argc > 2 ? atof(argv[2]) : 5.0;
+
+  srand(1);
+  HeightField world;
+  std::vector<Point> corners;
+  const float loop[5][2] = { { 50, 50 }, { 350, 50 }, { 350, 350 }, { 50, 350 }, { 50, 50 } };
+  for (int i = 0; i < 5; ++i)
+  {
+    Point p = { loop[i][0], loop[i][1], 0 };
+    corners.push_back(p);
+    if (i > 0)
+      world.clearRoad(loop[i - 1][0], loop[i - 1][1], loop[i][0], loop[i][1], 6);
+  }
+
+  // 第一圈正向, 第二圈反向并向左偏移1.5m
+  double time = 0;
+  std::vector<Pose> poses;
+  samplePath(corners, step, 0, time, poses);
+  int firstLap = poses.size();
+  std::vector<Point> reversed(corners.rbegin(), corners.rend());
+  samplePath(reversed, step, 1.5, time, poses);
+
+  ScanContext scanContext;
+  std::vector<Point> points;
+  double makeMs = 0, addMs = 0, detectMs = 0;
+  std::vector<int> matches(poses.size(), -1);
+  std::vector<float> dists(poses.size(), 1.0f);
+  for (size_t i = 0; i < poses.size(); ++i)
+  {
+    world.scan(poses[i].x, poses[i].y, poses[i].yaw, 0.1, points);
+    ScanContext::KeyFrame keyFrame;
+    double t0 = nowMs();
+    scanContext.makeKeyFrame(points, poses[i].time, keyFrame);
+    double t1 = nowMs();
+    scanContext.addKeyFrame(keyFrame);
+    double t2 = nowMs();
+    makeMs += t1 - t0;
+    addMs += t2 - t1;
+    if ((int)i >= firstLap)
+    {
+      float yaw;
+      scanContext.detectLoop(i, 30.0, matches[i], dists[i], yaw);
+      detectMs += nowMs() - t2;
+    }
+  }
+
+  // 真值: 第一圈中离查询帧最近且在loopRadius内的关键帧
+  int queries = poses.size() - firstLap;
+  int positives = 0;
+  std::vector<bool> hasLoop(poses.size(), false);
+  for (size_t i = firstLap; i < poses.size(); ++i)
+  {
+    for (int j = 0; j < firstLap; ++j)
+    {
+      if (hypot(poses[i].x - poses[j].x, poses[i].y - poses[j].y) < loopRadius)
+      {
+        hasLoop[i] = true;
+        break;
+      }
+    }
+    positives += hasLoop[i];
+  }
+
+  printf("%d keyframes (%d queries, %d with a true loop), step %.1f m, loop radius %.1f m\n", (int)poses.size(), queries,
+         positives, step, loopRadius);
+  printf("descriptor %.3f ms, insert %.3f ms, detect %.3f ms per keyframe\n", makeMs / poses.size(),
+         addMs / poses.size(), detectMs / std::max(queries, 1));
+  printf("threshold  precision  recall\n");
+  for (float threshold = 0.05; threshold < 0.51; threshold += 0.05)
+  {
+    int tp = 0, fp = 0;
+    for (size_t i = firstLap; i < poses.size(); ++i)
+    {
+      if (matches[i] < 0 || dists[i] >= threshold)
+        continue;
+      const Pose& q = poses[i];
+      const Pose& m = poses[matches[i]];
+      if (hasLoop[i] && hypot(q.x - m.x, q.y - m.y) < loopRadius)
+        ++tp;
+      else
+        ++fp;
+    }
+    printf("%9.2f  %9.3f  %6.3f\n", threshold, tp + fp > 0 ? (double)tp / (tp + fp) : 1.0,
+           positives > 0 ? (double)tp / positives : 0.0);
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# 激光定位回放检查: 以RTK固定解时的融合位姿为真值, 统计激光定位的水平误差与可用率
+import math
+import sys
+import unittest
+
+import rospy
+import rostest
+from location_msgs.msg import FusionDataInfo
+from location_sensor_msgs.msg import LidarInfo
+
+RTK_FIXED = 4
+EARTH_RADIUS = 6378137.0
+
+
+class LocalizationReplayTest(unittest.TestCase):
+    def setUp(self):
+        self.reference = []  # (time, lat, lon)
+        self.lidar = []  # (time, lat, lon, confidence)
+        rospy.Subscriber('/localization/fusion_msg', FusionDataInfo, self.fusion_callback, queue_size=200)
+        rospy.Subscriber('/localization/lidar_msg', LidarInfo, self.lidar_callback, queue_size=20)
+
+    def fusion_callback(self, msg):
+        if msg.satellite_status == RTK_FIXED:
+            self.reference.append((msg.header.stamp.to_sec(), msg.pose_llh.x, msg.pose_llh.y))
+
+    def lidar_callback(self, msg):
+        self.lidar.append((msg.header.stamp.to_sec(), msg.pose_cov.pose.position.x, msg.pose_cov.pose.position.y,
+                           msg.pose_confidence))
+
+    def reference_at(self, time):
+        # 按时间插值, 两侧真值间隔超过0.1s时不比较
+        ref = self.reference
+        lo, hi = 0, len(ref)
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if ref[mid][0] < time:
+                lo = mid + 1
+            else:
+                hi = mid
+        if lo == 0 or lo == len(ref) or ref[lo][0] - ref[lo - 1][0] > 0.1:
+            return None
+        a, b = ref[lo - 1], ref[lo]
+        ratio = (time - a[0]) / max(b[0] - a[0], 1e-6)
+        return a[1] + ratio * (b[1] - a[1]), a[2] + ratio * (b[2] - a[2])
+
+    def test_replay(self):
+        duration = rospy.get_param('~duration', 120.0)
+        max_error_p95 = rospy.get_param('~max_error_p95', 0.5)
+        min_availability = rospy.get_param('~min_availability', 0.9)
+
+        while not rospy.is_shutdown() and rospy.Time.now().to_sec() == 0:
+            rospy.sleep(0.1)
+        end = rospy.Time.now() + rospy.Duration(duration)
+        while not rospy.is_shutdown() and rospy.Time.now() < end:
+            rospy.sleep(0.5)
+
+        self.assertTrue(len(self.reference) > 0, 'no RTK fixed fusion poses in the bag')
+        self.reference.sort()
+
+        errors = []
+        for time, lat, lon, _ in self.lidar:
+            ref = self.reference_at(time)
+            if ref is None:
+                continue
+            dn = math.radians(lat - ref[0]) * EARTH_RADIUS
+            de = math.radians(lon - ref[1]) * EARTH_RADIUS * math.cos(math.radians(ref[0]))
+            errors.append(math.hypot(de, dn))
+
+        # 可用率: 有RTK真值的每一秒内是否至少有一帧激光定位输出
+        reference_seconds = set(int(r[0]) for r in self.reference)
+        lidar_seconds = set(int(l[0]) for l in self.lidar)
+        availability = float(len(reference_seconds & lidar_seconds)) / len(reference_seconds)
+
+        errors.sort()
+        p95 = errors[int(0.95 * (len(errors) - 1))] if errors else float('inf')
+        mean = sum(errors) / len(errors) if errors else float('inf')
+        rospy.loginfo('lidar poses %d, compared %d, mean error %.3f m, p95 %.3f m, max %.3f m, availability %.2f',
+                      len(self.lidar), len(errors), mean, p95, errors[-1] if errors else float('inf'), availability)
+
+        self.assertTrue(len(errors) > 0, 'no lidar poses overlap the RTK reference')
+        self.assertLessEqual(p95, max_error_p95)
+        self.assertGreaterEqual(availability, min_availability)
+
+
+if __name__ == '__main__':
+    rospy.init_node('check_localization_replay')
+    rostest.rosrun('lego_loam', 'localization_replay', LocalizationReplayTest, sys.argv)
@@ -0,0 +1,295 @@
+#ifndef ROI_LAYER_MAP_H_
+#define ROI_LAYER_MAP_H_
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+namespace superg_agv
+{
+namespace roi_agv
+{
+
+//ROI图层序号,每个栅格一个字节,每位对应一个图层,查一次得到全部图层
+enum RoiLayerIndex
+{
+  ROI_LAYER_AGV      = 0, // agv车身范围
+  ROI_LAYER_LOCATION = 1, //定位周边范围
+  ROI_LAYER_SPEED    = 2, //随车速变化的前方范围
+  ROI_LAYER_LANE     = 3, //参考线车道范围, 随定位更新
+  ROI_LAYER_MAX      = 8
+};
+
+//一行内的列范围[begin, end), begin >= end为空
+struct RoiSpan
+{
+  int begin;
+  int end;
+
+  bool operator==(const RoiSpan &b) const
+  {
+    return begin == b.begin && end == b.end;
+  }
+  bool operator<(const RoiSpan &b) const
+  {
+    return begin < b.begin || (begin == b.begin && end < b.end);
+  }
+};
+
+// agv坐标系下的多边形顶点(米)
+struct RoiVertex
+{
+  double x;
+  double y;
+};
+
+// agv坐标系下的ROI图层栅格, x向右为正, y向前为正, 与RoiPoint一致
+//图层按行保存列范围(每行可有多段), 更新时只改动列范围变化的行
+class RoiLayerMap
+{
+public:
+  RoiLayerMap() : scale(1.0), front(0), back(0), left(0), right(0), rows(0), cols(0)
+  {
+  }
+
+  void init(double front_, double back_, double left_, double right_, double scale_)
+  {
+    front = front_;
+    back  = back_;
+    left  = left_;
+    right = right_;
+    scale = scale_;
+    rows  = static_cast< int >(ceil((front + back) * scale));
+    cols  = static_cast< int >(ceil((left + right) * scale));
+    cells.assign(rows * cols, 0);
+    for (int i = 0; i < ROI_LAYER_MAX; i++)
+    {
+      layer_spans[i].assign(rows, std::vector< RoiSpan >());
+    }
+    row_spans.assign(rows, std::vector< RoiSpan >());
+    row_xs.assign(rows, std::vector< double >());
+  }
+
+  int getRows() const
+  {
+    return rows;
+  }
+
+  int getCols() const
+  {
+    return cols;
+  }
+
+  //超出范围返回-1
+  int getCellIndex(double x_, double y_) const
+  {
+    int col = static_cast< int >(floor((x_ + left) * scale));
+    int row = static_cast< int >(floor((y_ + back) * scale));
+    if (col < 0 || col >= cols || row < 0 || row >= rows)
+    {
+      return -1;
+    }
+    return row * cols + col;
+  }
+
+  uint8_t getPointLayers(double x_, double y_) const
+  {
+    int index_ = getCellIndex(x_, y_);
+    return index_ < 0 ? 0 : cells[index_];
+  }
+
+  //矩形框覆盖栅格的图层并集
+  uint8_t getBoxLayers(double min_x_, double max_x_, double min_y_, double max_y_) const
+  {
+    int min_col = std::max(static_cast< int >(floor((min_x_ + left) * scale)), 0);
+    int max_col = std::min(static_cast< int >(floor((max_x_ + left) * scale)), cols - 1);
+    int min_row = std::max(static_cast< int >(floor((min_y_ + back) * scale)), 0);
+    int max_row = std::min(static_cast< int >(floor((max_y_ + back) * scale)), rows - 1);
+
+    uint8_t layers_ = 0;
+    for (int row = min_row; row <= max_row; row++)
+    {
+      const uint8_t *cell_row = &cells[row * cols];
+      for (int col = min_col; col <= max_col; col++)
+      {
+        layers_ |= cell_row[col];
+      }
+    }
+    return layers_;
+  }
+
+  //按行设置图层列范围, 每行一段, 返回改动的行数
+  int setLayerSpans(int layer_, const std::vector< RoiSpan > &spans_)
+  {
+    for (int row = 0; row < rows; row++)
+    {
+      row_spans[row].clear();
+      if (spans_[row].begin < spans_[row].end)
+      {
+        row_spans[row].push_back(spans_[row]);
+      }
+    }
+    return setLayerRows(layer_);
+  }
+
+  //矩形图层, 栅格中心在矩形内即属于该图层
+  int setLayerRect(int layer_, double min_x_, double max_x_, double min_y_, double max_y_)
+  {
+    int begin_  = std::max(static_cast< int >(ceil((min_x_ + left) * scale - 0.5)), 0);
+    int end_    = std::min(static_cast< int >(floor((max_x_ + left) * scale - 0.5)) + 1, cols);
+    int min_row = std::max(static_cast< int >(ceil((min_y_ + back) * scale - 0.5)), 0);
+    int max_row = std::min(static_cast< int >(floor((max_y_ + back) * scale - 0.5)), rows - 1);
+
+    for (int row = 0; row < rows; row++)
+    {
+      row_spans[row].clear();
+      if (row >= min_row && row <= max_row && begin_ < end_)
+      {
+        RoiSpan span_ = {begin_, end_};
+        row_spans[row].push_back(span_);
+      }
+    }
+    return setLayerRows(layer_);
+  }
+
+  //多边形图层(奇偶规则, 多个多边形取并集), 栅格中心在多边形内即属于该图层
+  //按边扫描线求交, 每条边只处理它跨过的行
+  int setLayerPolygons(int layer_, const std::vector< std::vector< RoiVertex > > &polygons_)
+  {
+    for (int row = 0; row < rows; row++)
+    {
+      row_spans[row].clear();
+    }
+    for (size_t k = 0; k < polygons_.size(); k++)
+    {
+      const std::vector< RoiVertex > &polygon_ = polygons_[k];
+      int count_ = static_cast< int >(polygon_.size());
+      if (count_ < 3)
+      {
+        continue;
+      }
+      int touched_min = rows, touched_max = -1;
+      for (int i = 0, j = count_ - 1; i < count_; j = i++)
+      {
+        const RoiVertex &a_ = polygon_[j];
+        const RoiVertex &b_ = polygon_[i];
+        if (a_.y == b_.y)
+        {
+          continue;
+        }
+        double y_lo = std::min(a_.y, b_.y), y_hi = std::max(a_.y, b_.y);
+        //候选行多取一行, 下面按行中心精确判断
+        int row_lo = std::max(static_cast< int >(ceil((y_lo + back) * scale - 0.5)) - 1, 0);
+        int row_hi = std::min(static_cast< int >(ceil((y_hi + back) * scale - 0.5)), rows - 1);
+        for (int row = row_lo; row <= row_hi; row++)
+        {
+          double y_c = (row + 0.5) / scale - back;
+          if (y_c < y_lo || y_c >= y_hi)
+          {
+            continue;
+          }
+          row_xs[row].push_back(a_.x + (y_c - a_.y) * (b_.x - a_.x) / (b_.y - a_.y));
+          touched_min = std::min(touched_min, row);
+          touched_max = std::max(touched_max, row);
+        }
+      }
+      for (int row = touched_min; row <= touched_max; row++)
+      {
+        std::vector< double > &xs_ = row_xs[row];
+        std::sort(xs_.begin(), xs_.end());
+        for (size_t i = 0; i + 1 < xs_.size(); i += 2)
+        {
+          RoiSpan span_;
+          span_.begin = std::max(static_cast< int >(ceil((xs_[i] + left) * scale - 0.5)), 0);
+          span_.end   = std::min(static_cast< int >(floor((xs_[i + 1] + left) * scale - 0.5)) + 1, cols);
+          if (span_.begin < span_.end)
+          {
+            row_spans[row].push_back(span_);
+          }
+        }
+        xs_.clear();
+      }
+    }
+    //多个多边形相邻或重叠时合并成不相交的列范围
+    for (int row = 0; row < rows; row++)
+    {
+      std::vector< RoiSpan > &spans_ = row_spans[row];
+      if (spans_.size() < 2)
+      {
+        continue;
+      }
+      std::sort(spans_.begin(), spans_.end());
+      size_t n_ = 0;
+      for (size_t i = 1; i < spans_.size(); i++)
+      {
+        if (spans_[i].begin <= spans_[n_].end)
+        {
+          spans_[n_].end = std::max(spans_[n_].end, spans_[i].end);
+        }
+        else
+        {
+          spans_[++n_] = spans_[i];
+        }
+      }
+      spans_.resize(n_ + 1);
+    }
+    return setLayerRows(layer_);
+  }
+
+private:
+  // row_spans中的新列范围写入图层, 返回改动的行数
+  int setLayerRows(int layer_)
+  {
+    uint8_t bit_ = 1 << layer_;
+    int changed_ = 0;
+    for (int row = 0; row < rows; row++)
+    {
+      std::vector< RoiSpan > &old_ = layer_spans[layer_][row];
+      const std::vector< RoiSpan > &new_ = row_spans[row];
+      if (old_ == new_)
+      {
+        continue;
+      }
+      uint8_t *cell_row = &cells[row * cols];
+      for (size_t i = 0; i < old_.size(); i++)
+      {
+        for (int col = old_[i].begin; col < old_[i].end; col++)
+        {
+          cell_row[col] &= ~bit_;
+        }
+      }
+      for (size_t i = 0; i < new_.size(); i++)
+      {
+        for (int col = new_[i].begin; col < new_[i].end; col++)
+        {
+          cell_row[col] |= bit_;
+        }
+      }
+      old_ = new_;
+      changed_++;
+    }
+    return changed_;
+  }
+
+public:
+  double scale;
+  double front;
+  double back;
+  double left;
+  double right;
+  int rows;
+  int cols;
+  std::vector< uint8_t > cells;
+  std::vector< std::vector< RoiSpan > > layer_spans[ROI_LAYER_MAX];
+
+private:
+  //更新时的临时缓冲, 重复使用不再分配
+  std::vector< std::vector< RoiSpan > > row_spans;
+  std::vector< std::vector< double > > row_xs;
+};
+
+} // namespace roi_agv
+} // namespace superg_agv
+
+#endif
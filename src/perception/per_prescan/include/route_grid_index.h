@@ -0,0 +1,323 @@
+#ifndef ROUTE_GRID_INDEX_H_
+#define ROUTE_GRID_INDEX_H_
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace superg_agv
+{
+namespace roi_math
+{
+//网格范围,闭区间
+struct RouteCellBox
+{
+  int min_cx;
+  int max_cx;
+  int min_cy;
+  int max_cy;
+};
+
+//参考线均匀网格索引,只在收到新参考线时重建
+//参考点按网格号排序后连续存放,网格号二分查找,内存只与参考点数有关
+class RouteGridIndex
+{
+public:
+  RouteGridIndex() : cell_size_(2.0), s_monotonic_(true)
+  {
+    route_box_.min_cx = 0;
+    route_box_.max_cx = -1;
+    route_box_.min_cy = 0;
+    route_box_.max_cy = -1;
+  }
+
+  // RefPointT需有rx, ry, rs
+  template < typename RefPointT, typename Alloc >
+  void build(const std::vector< RefPointT, Alloc > &ref_line, double cell_size)
+  {
+    int count = static_cast< int >(ref_line.size());
+    ref_x_.resize(count);
+    ref_y_.resize(count);
+    ref_s_.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+      ref_x_[i] = ref_line[i].rx;
+      ref_y_[i] = ref_line[i].ry;
+      ref_s_[i] = ref_line[i].rs;
+    }
+    buildCells(cell_size);
+  }
+
+  // PathPointT需有x, y, 没有里程时按累计弧长计算
+  template < typename PathPointT, typename Alloc >
+  void buildXY(const std::vector< PathPointT, Alloc > &path, double cell_size)
+  {
+    int count = static_cast< int >(path.size());
+    ref_x_.resize(count);
+    ref_y_.resize(count);
+    ref_s_.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+      ref_x_[i] = path[i].x;
+      ref_y_[i] = path[i].y;
+      ref_s_[i] = i > 0 ? ref_s_[i - 1] + hypot(ref_x_[i] - ref_x_[i - 1], ref_y_[i] - ref_y_[i - 1]) : 0.0;
+    }
+    buildCells(cell_size);
+  }
+
+  int size() const
+  {
+    return static_cast< int >(ref_x_.size());
+  }
+
+  const RouteCellBox &getRouteBox() const
+  {
+    return route_box_;
+  }
+
+  //序号[begin_index, end_index)内参考点所占的网格范围,查表O(1)
+  RouteCellBox getCellBox(int begin_index, int end_index) const
+  {
+    RouteCellBox box;
+    box.min_cx = 0;
+    box.max_cx = -1;
+    box.min_cy = 0;
+    box.max_cy = -1;
+    begin_index = max(begin_index, 0);
+    end_index = min(end_index, size());
+    if (begin_index >= end_index)
+    {
+      return box;
+    }
+    //两段长度为2^k的区间覆盖[begin_index, end_index)
+    int k = 0;
+    while ((2 << k) <= end_index - begin_index)
+    {
+      k++;
+    }
+    int j = end_index - (1 << k);
+    box.min_cx = min(min_cx_[k][begin_index], min_cx_[k][j]);
+    box.max_cx = max(max_cx_[k][begin_index], max_cx_[k][j]);
+    box.min_cy = min(min_cy_[k][begin_index], min_cy_[k][j]);
+    box.max_cy = max(max_cy_[k][begin_index], max_cy_[k][j]);
+    return box;
+  }
+
+  //从begin_index起第一个rs大于max_s的序号,没有则返回end_index
+  int getEndIndexByS(int begin_index, int end_index, double max_s) const
+  {
+    if (s_monotonic_)
+    {
+      return static_cast< int >(std::upper_bound(ref_s_.begin() + begin_index, ref_s_.begin() + end_index, max_s) -
+                                ref_s_.begin());
+    }
+    for (int i = begin_index; i < end_index; i++)
+    {
+      if (ref_s_[i] > max_s)
+      {
+        return i;
+      }
+    }
+    return end_index;
+  }
+
+  //在序号[begin_index, end_index)内查找距(x, y)最近的参考点,距离平方须小于max_distance_sq
+  //距离相同时取序号小的,与顺序遍历的结果一致; box为这段参考点所占的网格范围; 找不到返回-1
+  int findNearest(double x, double y, int begin_index, int end_index, double max_distance_sq, const RouteCellBox &box,
+                  double &min_distance_sq) const
+  {
+    int min_index = -1;
+    min_distance_sq = max_distance_sq;
+    if (begin_index >= end_index || box.max_cx < box.min_cx)
+    {
+      return min_index;
+    }
+
+    int cx = cellCoord(x);
+    int cy = cellCoord(y);
+    //按环由近到远查找,第r环内的点距离不小于(r-1)*cell_size_
+    for (int r = 0;; r++)
+    {
+      double ring_distance = max(r - 1, 0) * cell_size_;
+      if (ring_distance * ring_distance > min_distance_sq)
+      {
+        break;
+      }
+      //前r-1环已覆盖全部网格
+      if (r > 0 && cx - r + 1 <= box.min_cx && cx + r - 1 >= box.max_cx && cy - r + 1 <= box.min_cy &&
+          cy + r - 1 >= box.max_cy)
+      {
+        break;
+      }
+
+      int min_ix = max(cx - r, box.min_cx);
+      int max_ix = min(cx + r, box.max_cx);
+      int min_iy = max(cy - r, box.min_cy);
+      int max_iy = min(cy + r, box.max_cy);
+      for (int ix = min_ix; ix <= max_ix; ix++)
+      {
+        for (int iy = min_iy; iy <= max_iy; iy++)
+        {
+          if (abs(ix - cx) != r && abs(iy - cy) != r)
+          {
+            continue;
+          }
+          searchCell(ix, iy, x, y, begin_index, end_index, min_index, min_distance_sq);
+        }
+      }
+    }
+    return min_index;
+  }
+
+  //先顺序查找[begin_index, warm_end)得到初始距离,再以此为半径在[begin_index, end_index)内用网格查找
+  //结果与顺序遍历[begin_index, end_index)一致; warm_end不大于begin_index时不做顺序查找
+  int findNearestWarm(double x, double y, int begin_index, int end_index, int warm_end, double max_distance_sq,
+                      double &min_distance_sq) const
+  {
+    int min_index = -1;
+    min_distance_sq = max_distance_sq;
+    for (int i = begin_index; i < min(warm_end, end_index); i++)
+    {
+      double dx = x - ref_x_[i];
+      double dy = y - ref_y_[i];
+      double d = dx * dx + dy * dy;
+      if (d < min_distance_sq)
+      {
+        min_distance_sq = d;
+        min_index = i;
+      }
+    }
+    double grid_distance_sq = 0;
+    int grid_index = findNearest(x, y, begin_index, end_index, min_distance_sq, route_box_, grid_distance_sq);
+    if (grid_index >= 0)
+    {
+      min_index = grid_index;
+      min_distance_sq = grid_distance_sq;
+    }
+    return min_index;
+  }
+
+private:
+  int cellCoord(double v) const
+  {
+    return static_cast< int >(floor(v / cell_size_));
+  }
+
+  void buildCells(double cell_size)
+  {
+    cell_size_ = cell_size;
+    int count = size();
+    s_monotonic_ = true;
+    std::vector< std::pair< int64_t, int > > cell_point(count);
+    std::vector< int > cx(count), cy(count);
+    for (int i = 0; i < count; i++)
+    {
+      if (i > 0 && ref_s_[i] < ref_s_[i - 1])
+      {
+        s_monotonic_ = false;
+      }
+      cx[i] = cellCoord(ref_x_[i]);
+      cy[i] = cellCoord(ref_y_[i]);
+      cell_point[i] = std::make_pair(cellKey(cx[i], cy[i]), i);
+    }
+    //同一网格内序号升序
+    std::sort(cell_point.begin(), cell_point.end());
+
+    cell_key_.clear();
+    cell_begin_.clear();
+    point_index_.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+      if (i == 0 || cell_point[i].first != cell_point[i - 1].first)
+      {
+        cell_key_.push_back(cell_point[i].first);
+        cell_begin_.push_back(i);
+      }
+      point_index_[i] = cell_point[i].second;
+    }
+    cell_begin_.push_back(count);
+
+    //区间网格范围的倍增表,第k层为[i, i + 2^k)的极值
+    min_cx_.assign(1, cx);
+    max_cx_.assign(1, cx);
+    min_cy_.assign(1, cy);
+    max_cy_.assign(1, cy);
+    for (int k = 1; (1 << k) <= count; k++)
+    {
+      int n = count - (1 << k) + 1;
+      int half = 1 << (k - 1);
+      min_cx_.push_back(std::vector< int >(n));
+      max_cx_.push_back(std::vector< int >(n));
+      min_cy_.push_back(std::vector< int >(n));
+      max_cy_.push_back(std::vector< int >(n));
+      for (int i = 0; i < n; i++)
+      {
+        min_cx_[k][i] = min(min_cx_[k - 1][i], min_cx_[k - 1][i + half]);
+        max_cx_[k][i] = max(max_cx_[k - 1][i], max_cx_[k - 1][i + half]);
+        min_cy_[k][i] = min(min_cy_[k - 1][i], min_cy_[k - 1][i + half]);
+        max_cy_[k][i] = max(max_cy_[k - 1][i], max_cy_[k - 1][i + half]);
+      }
+    }
+
+    route_box_ = getCellBox(0, count);
+  }
+
+  static int64_t cellKey(int cx, int cy)
+  {
+    return (static_cast< int64_t >(cx) << 32) | static_cast< uint32_t >(cy);
+  }
+
+  void searchCell(int cx, int cy, double x, double y, int begin_index, int end_index, int &min_index,
+                  double &min_distance_sq) const
+  {
+    int64_t key = cellKey(cx, cy);
+    std::vector< int64_t >::const_iterator it = std::lower_bound(cell_key_.begin(), cell_key_.end(), key);
+    if (it == cell_key_.end() || *it != key)
+    {
+      return;
+    }
+    int k = static_cast< int >(it - cell_key_.begin());
+    for (int j = cell_begin_[k]; j < cell_begin_[k + 1]; j++)
+    {
+      int i = point_index_[j];
+      if (i < begin_index || i >= end_index)
+      {
+        continue;
+      }
+      double dx = x - ref_x_[i];
+      double dy = y - ref_y_[i];
+      double d = dx * dx + dy * dy;
+      if (d < min_distance_sq || (d == min_distance_sq && min_index >= 0 && i < min_index))
+      {
+        min_distance_sq = d;
+        min_index = i;
+      }
+    }
+  }
+
+  double cell_size_;
+  bool s_monotonic_;
+  RouteCellBox route_box_;
+
+  std::vector< double > ref_x_;
+  std::vector< double > ref_y_;
+  std::vector< double > ref_s_;
+
+  std::vector< int64_t > cell_key_;
+  std::vector< int > cell_begin_;
+  std::vector< int > point_index_;
+
+  std::vector< std::vector< int > > min_cx_;
+  std::vector< std::vector< int > > max_cx_;
+  std::vector< std::vector< int > > min_cy_;
+  std::vector< std::vector< int > > max_cy_;
+};
+
+}  // namespace roi_math
+}  // namespace superg_agv
+
+#endif
@@ -18,6 +18,7 @@
 #include "std_msgs/String.h"
 
 #include "glog_helper.h"
+#include "route_grid_index.h"
 
 using namespace std;
 
@@ -200,6 +201,9 @@ LocationTemp cur_location;
 TaskPoint task_click;
 map_msgs::REFPointArray rount_ref_line;
 map_msgs::REFPointArray rount_ref_line_find_temp;
+superg_agv::roi_math::RouteGridIndex route_grid_index;  //参考线网格索引,收到新参考线时重建
+superg_agv::roi_math::RouteGridIndex decision_grid_index;  //决策路径网格索引,生成新路径时重建
+double route_grid_cell_size = 2.0;
 int route_ref_line_updata_tip = 0;  //初始化为0,收到新的为1,发送到车后为0
 int obu_reciver_tip = 0;
 geometry_msgs::Point obu_agv_distance;
@@ -341,6 +345,23 @@ void agvStatusCallback(const control_msgs::AGVStatus::ConstPtr &agv_status_msg)
   recv_agv_status_tip = 1;
 }
 
+//findAgvLocation/findAgvLocationFroDecision默认模式的网格查找,查找范围[begin_index - 1, count - 1)
+//暖启动:先在上一位置附近顺序查找,用其距离缩小网格查找半径; 找不到时返回0
+int findNearestByGrid(const superg_agv::roi_math::RouteGridIndex &grid_index, double x_, double y_, int begin_index,
+                      int count, int last_pos_index, double min_distance)
+{
+  int range_begin = begin_index - 1;
+  int range_end = count - 1;
+  int warm_end = range_begin;
+  if (last_pos_index >= range_begin && last_pos_index < range_end)
+  {
+    warm_end = min(range_end, last_pos_index + 30);
+  }
+  double grid_distance = 0;
+  int min_index = grid_index.findNearestWarm(x_, y_, range_begin, range_end, warm_end, min_distance, grid_distance);
+  return min_index >= 0 ? min_index : 0;
+}
+
 int findAgvLocation(double x_, double y_, double heading_, int last_pos_index, int isFastJudge, int isHeadingJudge)
 {
   double last_distance = -1.0;
@@ -361,6 +382,12 @@ int findAgvLocation(double x_, double y_, double heading_, int last_pos_index, i
       begin_index = last_pos_index - 30;
     }
 
+    //全局最近点用网格索引查找,结果与顺序遍历[begin_index - 1, count - 1)一致
+    if (isFastJudge == 0 && isHeadingJudge == 0 && route_grid_index.size() == count)
+    {
+      return findNearestByGrid(route_grid_index, x_, y_, begin_index, count, last_pos_index, min_distance);
+    }
+
     for (int i = begin_index; i < count; i++)
     {
       if (i > 2)
@@ -456,6 +483,11 @@ int findAgvLocationFroDecision(double x_, double y_, double heading_, int last_p
       begin_index = last_pos_index - 30;
     }
 
+    if (isFastJudge == 0 && isHeadingJudge == 0 && decision_grid_index.size() == count)
+    {
+      return findNearestByGrid(decision_grid_index, x_, y_, begin_index, count, last_pos_index, min_distance);
+    }
+
     for (int i = begin_index; i < count; i++)
     {
       if (i > 2)
@@ -1198,6 +1230,7 @@ void recvRefCallback(const map_msgs::REFPointArray::ConstPtr &msg)
     }
     rount_ref_line.REF_line_INFO.push_back(ref_pinfo_temp);
   }
+  route_grid_index.build(rount_ref_line.REF_line_INFO, route_grid_cell_size);
   route_ref_line_updata_tip = 1;
 
   ROS_ERROR("REF first point (%lf,%lf)", msg->REF_line_INFO.at(0).rx, msg->REF_line_INFO.at(0).ry);
@@ -1659,6 +1692,7 @@ int generateNewRefLine(int change_right)
                                       last_ref_point_temp, decision_info);
     generateSurpluslLine(last_ref_index, old_ref_count, old_ref_count, last_ref_point_temp, decision_info);
 
+    decision_grid_index.buildXY(decision_info.path_data_REF, route_grid_cell_size);
     route_decision_pub.publish(decision_info);
 
     ros::Time e_time = ros::Time::now();
@@ -1805,6 +1839,7 @@ int generateRefLine(int cur_index_, int end_point_index_)
 
   decision_info.path_plan_valid = 1;
   decision_info.path_mode = 1;
+  decision_grid_index.buildXY(decision_info.path_data_REF, route_grid_cell_size);
   route_decision_pub.publish(decision_info);
 
   ros::Time e_time = ros::Time::now();
@@ -1869,6 +1904,7 @@ int generateBackRefLine(int is_right_, int cur_index_, int end_point_index_, dou
 
   decision_info.path_plan_valid = 1;
   decision_info.path_mode = 1;
+  decision_grid_index.buildXY(decision_info.path_data_REF, route_grid_cell_size);
   route_decision_pub.publish(decision_info);
 
   ros::Time e_time = ros::Time::now();
@@ -1937,6 +1973,7 @@ int generateFirstNewRefLine(int is_right_, int cur_index_, double max_ds, int en
 
   decision_info.path_plan_valid = 1;
   decision_info.path_mode = 1;
+  decision_grid_index.buildXY(decision_info.path_data_REF, route_grid_cell_size);
   route_decision_pub.publish(decision_info);
 
   ros::Time e_time = ros::Time::now();
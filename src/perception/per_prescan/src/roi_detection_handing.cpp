@@ -1,6 +1,7 @@
 #include <visualization_msgs/Marker.h>
 #include <visualization_msgs/MarkerArray.h>
 #include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <string>
 #include "common_msgs/DetectionInfo.h"
@@ -18,9 +19,8 @@
 
 #include "glog_helper.h"
 
-#include "get_ref_map.h"
 #include "math_interpolation.h"
-#include "roi_around_agv.h"
+#include "roi_layer_map.h"
 
 using namespace std;
 using namespace superg_agv::roi_agv;
@@ -100,10 +100,11 @@ struct ObstacleDetectionTemp
 // ros::NodeHandle n;
 // //计算线性插值 B
 MathInterData *math_inter_data;
-//获取地图大小 B
-GetRefMapAreaRange *get_map_range;
-//制作ROI区域
-BuildRoiSpace *new_roi;
+// agv坐标系ROI图层
+RoiLayerMap roi_layer_map;
+double roi_speed_time = 3.0;          //前方ROI按车速延伸的时间(s)
+double roi_speed_min_front = 10.0;    //前方ROI最小长度(m)
+double roi_speed_half_width = 1.9;    //前方ROI半宽(m)
 
 //
 ros::Subscriber fusion_location_sub;  //融合定位
@@ -123,9 +124,11 @@ std::vector<LocationTemp> location_vec;
 map_msgs::REFPointArray rount_ref_line;
 control_msgs::AGVStatus agv_status_info;
 std::vector<common_msgs::DetectionInfo> lidar_detection_obs_vec;
-std::vector<Point> lane_boundry_points;
-std::vector<Point> lane_left_boundry_points;
-std::vector<Point> lane_right_boundry_points;
+//车道边界, 全局坐标(米), 每段车道一个多边形
+std::vector<RoiVertex> lane_left_boundry_points;
+std::vector<RoiVertex> lane_right_boundry_points;
+std::vector<std::vector<RoiVertex> > lane_polygons;
+std::vector<std::vector<RoiVertex> > lane_local_polygons;  //转到agv坐标系, 复用内存
 
 int route_ref_line_updata_tip = 0;  //初始化为0,收到新的为1,发送到车后为0
 int fusion_location_updata_tip = 0;
@@ -134,9 +137,6 @@ int location_index = 0;
 int location_vec_tip = 0;
 int lidar_detection_recieve_tip = 0;
 double map_scale = 1;  //地图放大缩小等级
-//
-Point base_point;
-Point max_point;
 
 double mathPointDistanceSquare(double x1, double y1, double x2, double y2)
 {
@@ -239,43 +239,6 @@ int findAgvLocation(double x_, double y_, double heading_, int last_pos_index, i
   }
 }
 
-Point checkMaskRange(Point &p_)
-{
-  Point p_temp;
-  if (p_.x < 0)
-  {
-    p_temp.x = 0;
-  }
-  else
-  {
-    if (p_.x >= max_point.x)
-    {
-      p_temp.x = max_point.x - 1;
-    }
-    else
-    {
-      p_temp.x = p_.x;
-    }
-  }
-
-  if (p_.y < 0)
-  {
-    p_temp.y = 0;
-  }
-  else
-  {
-    if (p_.y >= max_point.y)
-    {
-      p_temp.y = max_point.y - 1;
-    }
-    else
-    {
-      p_temp.y = p_.y;
-    }
-  }
-  return p_temp;
-}
-
 void recvFusionLocationCallback(const location_msgs::FusionDataInfo::ConstPtr &location_msg)
 {
   location_index++;
@@ -323,28 +286,22 @@ void recvCamObsCallback(const perception_sensor_msgs::ObjectList::ConstPtr &msg)
 
 void setLaneContours()
 {
-  lane_boundry_points.clear();
-  lane_boundry_points = lane_left_boundry_points;
+  if (lane_left_boundry_points.empty())
+  {
+    return;
+  }
+  std::vector<RoiVertex> lane_boundry_points = lane_left_boundry_points;
   lane_boundry_points.insert(lane_boundry_points.end(), lane_right_boundry_points.rbegin(),
                              lane_right_boundry_points.rend());
 
-  lane_left_boundry_points.clear();
-  lane_right_boundry_points.clear();
-
-  // std::cout << "lane_boundry_points is: " << std::endl;
-  // std::cout << lane_boundry_points << std::endl;
-
-  ROS_WARN("Left  B:(%d,%d) Left  E:(%d,%d)", lane_left_boundry_points.begin()->x, lane_left_boundry_points.begin()->y,
-           lane_left_boundry_points.rbegin()->x, lane_left_boundry_points.rbegin()->y);
-
-  ROS_WARN("Right B:(%d,%d) Right E:(%d,%d)", lane_right_boundry_points.begin()->x,
-           lane_right_boundry_points.begin()->y, lane_right_boundry_points.rbegin()->x,
-           lane_right_boundry_points.rbegin()->y);
+  ROS_WARN("Lane %d B:(%lf,%lf) Lane  E:(%lf,%lf)", static_cast<int>(lane_polygons.size()),
+           lane_boundry_points.begin()->x, lane_boundry_points.begin()->y, lane_boundry_points.rbegin()->x,
+           lane_boundry_points.rbegin()->y);
 
-  ROS_WARN("Lane  B:(%d,%d) Lane  E:(%d,%d)", lane_boundry_points.begin()->x, lane_boundry_points.begin()->y,
-           lane_boundry_points.rbegin()->x, lane_boundry_points.rbegin()->y);
+  lane_polygons.push_back(lane_boundry_points);
 
-  new_roi->setContours(lane_boundry_points, 0);
+  lane_left_boundry_points.clear();
+  lane_right_boundry_points.clear();
 }
 
 void recvLidarObsCallback(const perception_sensor_msgs::ObjectList::ConstPtr &msg)
@@ -377,10 +334,7 @@ void recvRefCallback(const map_msgs::REFPointArray::ConstPtr &msg)
   double last_radian_ = 0;
   int last_lane_id = -1;
 
-  Point last_p_temp_left;
-  Point last_p_temp_right;
-
-  new_roi->clearLaneContour();
+  lane_polygons.clear();
 
   for (int i = 0; i < count_line; i++)
   {
@@ -433,51 +387,25 @@ void recvRefCallback(const map_msgs::REFPointArray::ConstPtr &msg)
       radian_ = last_radian_;
     }
 
-    double left_x = map_scale * (ref_point_temp.rx + temp_left * cos(radian_));
-    double left_y = map_scale * (ref_point_temp.ry - temp_left * sin(radian_));
-    double right_x = map_scale * (ref_point_temp.rx + temp_right * cos(radian_));
-    double right_y = map_scale * (ref_point_temp.ry - temp_right * sin(radian_));
-
-    Point p_temp_left;
-    p_temp_left.x = new_roi->getIntFromDouble(left_x) - base_point.x;
-    p_temp_left.y = new_roi->getIntFromDouble(left_y) - base_point.y;
-    p_temp_left = checkMaskRange(p_temp_left);
+    RoiVertex p_temp_left;
+    p_temp_left.x = ref_point_temp.rx + temp_left * cos(radian_);
+    p_temp_left.y = ref_point_temp.ry - temp_left * sin(radian_);
     lane_left_boundry_points.push_back(p_temp_left);
-    // ROS_INFO("left (%d,%d)", p_temp.x, p_temp.y);
-    Point p_temp_right;
-    p_temp_right.x = new_roi->getIntFromDouble(right_x) - base_point.x;
-    p_temp_right.y = new_roi->getIntFromDouble(right_y) - base_point.y;
-    p_temp_right = checkMaskRange(p_temp_right);
+    RoiVertex p_temp_right;
+    p_temp_right.x = ref_point_temp.rx + temp_right * cos(radian_);
+    p_temp_right.y = ref_point_temp.ry - temp_right * sin(radian_);
     lane_right_boundry_points.push_back(p_temp_right);
-    // ROS_INFO("right (%d,%d)", p_temp.x, p_temp.y);
-    //分路段填值
-
-    // if (i == 0)
-    // {
-    //   last_p_temp_left  = p_temp_left;
-    //   last_p_temp_right = p_temp_right;
-    // }
-
+    //分路段填值, 换车道时当前点同时作为下一段的起点
     if (last_lane_id != ref_point_temp.lane_id)
     {
       setLaneContours();
-
-      p_temp_left.x = new_roi->getIntFromDouble(left_x) - base_point.x;
-      p_temp_left.y = new_roi->getIntFromDouble(left_y) - base_point.y;
-      p_temp_left = checkMaskRange(p_temp_left);
       lane_left_boundry_points.push_back(p_temp_left);
-      p_temp_right.x = new_roi->getIntFromDouble(right_x) - base_point.x;
-      p_temp_right.y = new_roi->getIntFromDouble(right_y) - base_point.y;
-      p_temp_right = checkMaskRange(p_temp_right);
       lane_right_boundry_points.push_back(p_temp_right);
     }
 
     last_radian_ = radian_;
     last_lane_id = ref_point_temp.lane_id;
 
-    // last_p_temp_left  = p_temp_left;
-    // last_p_temp_right = p_temp_right;
-
     rount_ref_line.REF_line_INFO.push_back(ref_point_temp);
 
     ROS_WARN("REF id:%d (%lf,%lf) theta:%lf ,left (%lf,%lf) ,right (%lf,%lf) ", ref_point_temp.lane_id,
@@ -509,134 +437,58 @@ void agvStatusCallback(const control_msgs::AGVStatus::ConstPtr &agv_status_msg)
   recv_agv_status_tip = 1;
 }
 
-void doAgvTransformationToLocal(double temp_x_, double temp_y_, double x_, double y_, double radian_, Point &p)
+//全局坐标转到agv坐标系, x与激光障碍物框一致取反
+void doGlobalTransformationToAgv(double global_x_, double global_y_, double x_, double y_, double radian_,
+                                 RoiVertex &p)
 {
-  p.x = x_ + temp_y_ * sin(radian_) - temp_x_ * cos(radian_);
-  p.y = y_ + temp_y_ * cos(radian_) + temp_x_ * sin(radian_);
-  p.x = new_roi->getIntFromDouble(p.x) - base_point.x;
-  p.y = new_roi->getIntFromDouble(p.y) - base_point.y;
-  p = checkMaskRange(p);
+  double dx = global_x_ - x_;
+  double dy = global_y_ - y_;
+  p.x = dy * sin(radian_) - dx * cos(radian_);
+  p.y = dx * sin(radian_) + dy * cos(radian_);
 }
 
-void doAgvTransformationToLocal(double temp_x_, double temp_y_, double x_, double y_, double radian_, double map_size,
-                                Point &p)
+//按当前定位把车道多边形转到agv坐标系, 更新车道ROI图层
+void updateLaneRoiLayer()
 {
-  p.x = (x_ + temp_y_ * sin(radian_) - temp_x_ * cos(radian_)) * map_size;
-  p.y = (y_ + temp_y_ * cos(radian_) + temp_x_ * sin(radian_)) * map_size;
-  p.x = new_roi->getIntFromDouble(p.x) - base_point.x;
-  p.y = new_roi->getIntFromDouble(p.y) - base_point.y;
-  p = checkMaskRange(p);
-}
-
-void obsRange(double min_x_, double max_x_, double min_y_, double max_y_, double map_size,
-              std::vector<Point> &point_vec_)
-{
-  double base_location_x = cur_location.pos_x * map_size;
-  double base_location_y = cur_location.pos_y * map_size;
   double radian_ = cur_location.heading * M_PI / 180;
-
-  point_vec_.clear();
-
-  Point p_temp;
-  double temp_x_ = min_x_ * map_size;
-  double temp_y_ = min_y_ * map_size;
-  doAgvTransformationToLocal(temp_x_, temp_y_, base_location_x, base_location_y, radian_, p_temp);
-  point_vec_.push_back(p_temp);
-
-  temp_x_ = min_x_ * map_size;
-  temp_y_ = max_y_ * map_size;
-  doAgvTransformationToLocal(temp_x_, temp_y_, base_location_x, base_location_y, radian_, p_temp);
-  point_vec_.push_back(p_temp);
-
-  temp_x_ = max_x_ * map_size;
-  temp_y_ = max_y_ * map_size;
-  doAgvTransformationToLocal(temp_x_, temp_y_, base_location_x, base_location_y, radian_, p_temp);
-  point_vec_.push_back(p_temp);
-
-  temp_x_ = max_x_ * map_size;
-  temp_y_ = min_y_ * map_size;
-  doAgvTransformationToLocal(temp_x_, temp_y_, base_location_x, base_location_y, radian_, p_temp);
-  point_vec_.push_back(p_temp);
+  lane_local_polygons.resize(lane_polygons.size());
+  for (size_t i = 0; i < lane_polygons.size(); i++)
+  {
+    lane_local_polygons[i].resize(lane_polygons[i].size());
+    for (size_t j = 0; j < lane_polygons[i].size(); j++)
+    {
+      doGlobalTransformationToAgv(lane_polygons[i][j].x, lane_polygons[i][j].y, cur_location.pos_x,
+                                  cur_location.pos_y, radian_, lane_local_polygons[i][j]);
+    }
+  }
+  roi_layer_map.setLayerPolygons(ROI_LAYER_LANE, lane_local_polygons);
 }
 
-void locationRange(double front_, double back_, double left_, double right_, double map_size,
-                   std::vector<Point> &point_vec_)
+//按车速更新前方ROI图层,只改动前方范围变化的行
+void updateSpeedRoiLayer(double speed_)
 {
-  double base_location_x = cur_location.pos_x * map_size;
-  double base_location_y = cur_location.pos_y * map_size;
-  double radian_ = cur_location.heading * M_PI / 180;
-
-  front_ = front_ * map_size;
-  back_ = back_ * map_size;
-  left_ = left_ * map_size;
-  right_ = right_ * map_size;
-
-  point_vec_.clear();
-
-  geometry_msgs::Point p;
-  Point p_temp;
-  p.z = 0;
-
-  p.x = base_location_x + front_ * sin(radian_) - left_ * cos(radian_);
-  p.y = base_location_y + front_ * cos(radian_) + left_ * sin(radian_);
-  p_temp.x = new_roi->getIntFromDouble(p.x) - base_point.x;
-  p_temp.y = new_roi->getIntFromDouble(p.y) - base_point.y;
-  p_temp = checkMaskRange(p_temp);
-  point_vec_.push_back(p_temp);
-
-  p.x = base_location_x + front_ * sin(radian_) + right_ * cos(radian_);
-  p.y = base_location_y + front_ * cos(radian_) - right_ * sin(radian_);
-  p_temp.x = new_roi->getIntFromDouble(p.x) - base_point.x;
-  p_temp.y = new_roi->getIntFromDouble(p.y) - base_point.y;
-  p_temp = checkMaskRange(p_temp);
-  point_vec_.push_back(p_temp);
-
-  p.x = base_location_x - back_ * sin(radian_) + right_ / 2 * cos(radian_);
-  p.y = base_location_y - back_ * cos(radian_) - right_ / 2 * sin(radian_);
-  p_temp.x = new_roi->getIntFromDouble(p.x) - base_point.x;
-  p_temp.y = new_roi->getIntFromDouble(p.y) - base_point.y;
-  p_temp = checkMaskRange(p_temp);
-  point_vec_.push_back(p_temp);
-
-  p.x = base_location_x - back_ * sin(radian_) - left_ * cos(radian_);
-  p.y = base_location_y - back_ * cos(radian_) + left_ * sin(radian_);
-  p_temp.x = new_roi->getIntFromDouble(p.x) - base_point.x;
-  p_temp.y = new_roi->getIntFromDouble(p.y) - base_point.y;
-  p_temp = checkMaskRange(p_temp);
-  point_vec_.push_back(p_temp);
+  double front_ = roi_speed_min_front + abs(speed_) * roi_speed_time;
+  roi_layer_map.setLayerRect(ROI_LAYER_SPEED, -roi_speed_half_width, roi_speed_half_width, 0, front_);
 }
 
-void detectionLidarObsJudge(double map_size)
+void detectionLidarObsJudge()
 {
   // int ans = getLocationFromVectorTemp(lidar_location_obs_time);
   int ans = 1;
   if (ans == 1)
   {
-    //障碍物判断初值
-    int id_index = 0;
-    // double radian_ = lidar_location_obs_time.heading * M_PI / 180;
-    // double x_      = lidar_location_obs_time.pos_x* map_size;
-    // double y_      = lidar_location_obs_time.pos_y* map_size;
-    //临时使用实时定位数据0925
-    double radian_ = cur_location.heading * M_PI / 180;
-    double x_ = cur_location.pos_x;
-    double y_ = cur_location.pos_y;
-    double temp_x_ = 0;
-    double temp_y_ = 0;
     //更新查询参考线位置
     int ref_index = cur_location.ref_index;
     if (ref_index > 0 && ref_index < (static_cast<int>(rount_ref_line.REF_line_INFO.size()) - 2))
     {
-      int obs_num = static_cast<int>(lidar_detection_obs_vec.size());
       std::vector<common_msgs::DetectionInfo>::iterator lidar_it;
-      new_roi->initObsMap();
-      new_roi->clearContour();
+      int lane_obs_num = 0;
+      int speed_obs_num = 0;
       for (lidar_it = lidar_detection_obs_vec.begin(); lidar_it != lidar_detection_obs_vec.end(); lidar_it++)
       {
         ObstacleDetectionTemp obstacle_temp;
 
         obstacle_temp.ref_index = ref_index;
-        lidar_it->state[0];
         obstacle_temp.obs_id = lidar_it->id;
         obstacle_temp.max_x = (0 - lidar_it->state[0]);
         obstacle_temp.min_y = lidar_it->state[1];
@@ -644,55 +496,25 @@ void detectionLidarObsJudge(double map_size)
         obstacle_temp.max_y = lidar_it->state[3];
 
         double judge_y_temp = min(abs(obstacle_temp.min_y), abs(obstacle_temp.max_y));
-        double judge_x_temp = min(abs(obstacle_temp.min_y), abs(obstacle_temp.max_y));
 
-        int obs_math_tip = 0;
+        //一次查询得到障碍物框覆盖的全部ROI图层, x与上面一致取反
+        uint8_t obs_layers = roi_layer_map.getBoxLayers(
+            min(obstacle_temp.min_x, obstacle_temp.max_x), max(obstacle_temp.min_x, obstacle_temp.max_x),
+            min(obstacle_temp.min_y, obstacle_temp.max_y), max(obstacle_temp.min_y, obstacle_temp.max_y));
 
-        if (judge_y_temp < 40.0)
+        if (judge_y_temp < 40.0 && (obs_layers & (1 << ROI_LAYER_LANE)))
         {
-          obs_math_tip = 1;
-
-          std::vector<Point> point_vec_;
-          Point p_temp;
-
-          // ROS_INFO("obstacle_temp min(%lf,%lf), max(%lf,%lf), loca(%lf,%lf)", obstacle_temp.min_x,
-          // obstacle_temp.min_y,
-          //          obstacle_temp.max_x, obstacle_temp.max_y, x_, y_);
-
-          id_index++;
-          visualization_msgs::Marker points;
-          //转换全局
-          temp_x_ = obstacle_temp.min_x;
-          temp_y_ = obstacle_temp.min_y;
-          doAgvTransformationToLocal(temp_x_, temp_y_, x_, y_, radian_, map_size, p_temp);
-          point_vec_.push_back(p_temp);
-          // std::cout << "p_temp is: \n" << p_temp << std::endl;
-
-          temp_x_ = obstacle_temp.min_x;
-          temp_y_ = obstacle_temp.max_y;
-          doAgvTransformationToLocal(temp_x_, temp_y_, x_, y_, radian_, map_size, p_temp);
-          point_vec_.push_back(p_temp);
-          // std::cout << "p_temp is: \n" << p_temp << std::endl;
-
-          temp_x_ = obstacle_temp.max_x;
-          temp_y_ = obstacle_temp.max_y;
-          doAgvTransformationToLocal(temp_x_, temp_y_, x_, y_, radian_, map_size, p_temp);
-          point_vec_.push_back(p_temp);
-          // std::cout << "p_temp is: \n" << p_temp << std::endl;
-
-          temp_x_ = obstacle_temp.max_x;
-          temp_y_ = obstacle_temp.min_y;
-          doAgvTransformationToLocal(temp_x_, temp_y_, x_, y_, radian_, map_size, p_temp);
-          point_vec_.push_back(p_temp);
-          // std::cout << "p_temp is: \n" << p_temp << std::endl;
-          new_roi->setContours(point_vec_, 3);
+          lane_obs_num++;
         }
-        if (obs_math_tip == 1)
+        if (obs_layers & (1 << ROI_LAYER_SPEED))
         {
-          new_roi->useObsMask(3);
+          speed_obs_num++;
         }
       }
-      // ROS_INFO("mathObsAndROI");
+      if (lane_obs_num > 0 || speed_obs_num > 0)
+      {
+        ROS_WARN_THROTTLE(1.0, "obs in lane roi: %d, in speed roi: %d", lane_obs_num, speed_obs_num);
+      }
     }
   }
   else
@@ -756,32 +578,13 @@ int main(int argc, char *argv[])
   // ROS_WARN("Inter time: %lf", e_time.toSec() - b_time.toSec());
   //计算线性插值 B
 
-  //获取地图大小 B
-  get_map_range = new GetRefMapAreaRange();
-
-  std::string workplace_path = "/work/superg_agv/src/routing/map_new/data";
-  std::string file_name = "/area.json";
-  AreaRange map_range;
-  get_map_range->setAreaFilePath(workplace_path, file_name);
-  get_map_range->getAreaRangeFromFile(map_range);
-  ROS_INFO("double min x %lf max x %lf min y %lf max y %lf", map_range.min_x, map_range.max_x, map_range.min_y,
-           map_range.max_y);
-  //获取地图大小 E
-
-  //制作ROI区域
-  new_roi = new BuildRoiSpace(n);
-  // new_roi = new BuildRoiSpace();
-
-  map_scale = 4;                    //地图放大缩小等级
-  new_roi->setMapScale(map_scale);  //原始单位为m
-  new_roi->setMaxAndMinWidthHeight(map_range.max_x, map_range.min_x, map_range.max_y, map_range.min_y);
-  new_roi->setMapSize();
-  new_roi->initMap();
-  new_roi->showMaxMinWidthHeight();
-
-  base_point = new_roi->getBaseXY();
-  max_point = new_roi->getMaxXY();
-  ROS_WARN("base point (%d,%d) max (%d,%d)", base_point.x, base_point.y, max_point.x, max_point.y);
+  map_scale = 4;  //地图放大缩小等级
+
+  // agv坐标系ROI图层: 前50后30左15右10米
+  roi_layer_map.init(50, 30, 15, 10, map_scale);
+  roi_layer_map.setLayerRect(ROI_LAYER_AGV, -1.5, 1.5, -8, 8);
+  roi_layer_map.setLayerRect(ROI_LAYER_LOCATION, -15, 10, -30, 50);
+  updateSpeedRoiLayer(0);
 
   fusion_location_sub = n.subscribe("/localization/fusion_msg", 5, recvFusionLocationCallback);
   fusion_obstacle_sub = n.subscribe("/perception/obstacle_info", 5, recvFusionObuCallback);
@@ -823,6 +626,12 @@ int main(int argc, char *argv[])
   {
     ros::spinOnce();
 
+    if (recv_agv_status_tip == 1)
+    {
+      recv_agv_status_tip = 0;
+      updateSpeedRoiLayer(agv_status_info.ActualSpd);
+    }
+
     if (fusion_location_updata_tip == 1)
     {
       fusion_location_updata_tip = 0;
@@ -836,7 +645,9 @@ int main(int argc, char *argv[])
         if (count_lidar_vec > 0)
         {
           b_time = ros::Time::now();
-          detectionLidarObsJudge(map_scale);
+          //车道图层按本帧定位更新, 只改动变化的行
+          updateLaneRoiLayer();
+          detectionLidarObsJudge();
           e_time = ros::Time::now();
           double d_time = e_time.toSec() - b_time.toSec();
           max_d_time = max(max_d_time, d_time);
@@ -846,59 +657,6 @@ int main(int argc, char *argv[])
         }
         // control_tip = 0;
       }
-
-      double distance_temp =
-          mathPointDistanceSquare(cur_location.pos_x, cur_location.pos_y, last_location.pos_x, last_location.pos_y);
-      double angle_temp = abs(cur_location.heading - last_location.heading);
-      if (distance_temp > 3 || angle_temp > 5)
-      {
-        // new_roi->initMaskMap();
-        new_roi->clearAgvContour();
-
-        // std::vector< Point > agv_boundry_points;
-        // locationRange(8.0, 8.0, 1.5, 1.5, map_scale, agv_boundry_points);
-        // new_roi->setContours(agv_boundry_points, 1);
-
-        std::vector<Point> location_boundry_points;
-        locationRange(50, 30, 15, 10, map_scale, location_boundry_points);
-        // new_roi->setContours(location_boundry_points, 2);
-        new_roi->refreshROIMap();
-
-        // std::cout << "location_boundry_points is: " << std::endl;
-        // std::cout << location_boundry_points << std::endl;
-        // new_roi->initObsMap();
-        // new_roi->clearContour();
-        std::vector<Point> obs_points;
-        locationRange(8, 8, 1.5, 1.5, map_scale, obs_points);
-        // // new_roi->clearContour();
-        // new_roi->setContours(obs_points, 3);
-        // obsRange(-9, -8, 20, 22, map_scale, obs_points);
-        // // new_roi->clearContour();
-        // new_roi->setContours(obs_points, 3);
-        // obsRange(8, 9, -22, 100, map_scale, obs_points);
-        // // new_roi->clearContour();
-        new_roi->setContours(obs_points, 3);
-        new_roi->useObsMask(3);
-        // new_roi->mathObsAndROI();
-
-        new_roi->mathObsAndROI();
-        new_roi->showAllMap(0);
-        last_location = cur_location;
-      }
-
-      if (route_ref_line_updata_tip == 1)
-      {
-        route_ref_line_updata_tip = 0;
-
-        // std::vector< Point > lane_right_boundry_points_rever;
-        // lane_right_boundry_points_rever.reserve(lane_right_boundry_points.size());
-
-        new_roi->refreshROIMap();
-
-        // new_roi->showAllMap(0);
-      }
-
-      // new_roi->coutROIMap();
     }
 
     loop_rate.sleep();
@@ -0,0 +1,381 @@
+#include "roi_layer_map.h"
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+using namespace superg_agv::roi_agv;
+
+namespace
+{
+//与roi_detection_handing一致: 前50后30左15右10米, 每米4格
+const double roi_front = 50;
+const double roi_back  = 30;
+const double roi_left  = 15;
+const double roi_right = 10;
+const double roi_scale = 4;
+
+struct RoiRect
+{
+  double min_x;
+  double max_x;
+  double min_y;
+  double max_y;
+};
+
+double uniform(double lo, double hi)
+{
+  return lo + (hi - lo) * (rand() / (double)RAND_MAX);
+}
+
+double nowUs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+RoiRect speedRect(double speed)
+{
+  RoiRect rect = { -1.9, 1.9, 0, 10.0 + fabs(speed) * 3.0 };
+  return rect;
+}
+
+//原cv::Mat方式: 每个图层一张掩膜, 栅格中心在矩形内为255
+void drawRectMask(const RoiLayerMap &map, const RoiRect &rect, cv::Mat &mask)
+{
+  mask = cv::Mat::zeros(map.getRows(), map.getCols(), CV_8UC1);
+  for (int row = 0; row < map.getRows(); row++)
+  {
+    double y = (row + 0.5) / roi_scale - roi_back;
+    for (int col = 0; col < map.getCols(); col++)
+    {
+      double x = (col + 0.5) / roi_scale - roi_left;
+      if (x >= rect.min_x && x <= rect.max_x && y >= rect.min_y && y <= rect.max_y)
+      {
+        mask.at< uint8_t >(row, col) = 255;
+      }
+    }
+  }
+}
+
+//障碍物框覆盖的栅格范围, 超出地图返回false
+bool boxCells(const RoiLayerMap &map, const RoiRect &box, cv::Rect &cells)
+{
+  int min_col = std::max(static_cast< int >(floor((box.min_x + roi_left) * roi_scale)), 0);
+  int max_col = std::min(static_cast< int >(floor((box.max_x + roi_left) * roi_scale)), map.getCols() - 1);
+  int min_row = std::max(static_cast< int >(floor((box.min_y + roi_back) * roi_scale)), 0);
+  int max_row = std::min(static_cast< int >(floor((box.max_y + roi_back) * roi_scale)), map.getRows() - 1);
+  if (min_col > max_col || min_row > max_row)
+  {
+    return false;
+  }
+  cells = cv::Rect(min_col, min_row, max_col - min_col + 1, max_row - min_row + 1);
+  return true;
+}
+
+//原cv::Mat方式的分类: 障碍物框逐个图层掩膜判断
+uint8_t classifyWithMasks(const RoiLayerMap &map, const std::vector< cv::Mat > &masks, const RoiRect &box)
+{
+  cv::Rect cells;
+  if (!boxCells(map, box, cells))
+  {
+    return 0;
+  }
+  uint8_t layers = 0;
+  for (size_t i = 0; i < masks.size(); i++)
+  {
+    if (cv::countNonZero(masks[i](cells)) > 0)
+    {
+      layers |= 1 << i;
+    }
+  }
+  return layers;
+}
+
+//激光障碍物框, agv坐标系, 部分超出地图范围
+RoiRect randomBox()
+{
+  double x = uniform(-20, 15);
+  double y = uniform(-35, 60);
+  RoiRect box = { x, x + uniform(0.2, 5), y, y + uniform(0.2, 8) };
+  return box;
+}
+
+void initLayers(RoiLayerMap &map, std::vector< cv::Mat > &masks, std::vector< RoiRect > &rects)
+{
+  map.init(roi_front, roi_back, roi_left, roi_right, roi_scale);
+  RoiRect agv      = { -1.5, 1.5, -8, 8 };
+  RoiRect location = { -15, 10, -30, 50 };
+  rects.clear();
+  rects.push_back(agv);
+  rects.push_back(location);
+  rects.push_back(speedRect(0));
+  masks.resize(rects.size());
+  for (size_t i = 0; i < rects.size(); i++)
+  {
+    map.setLayerRect(i, rects[i].min_x, rects[i].max_x, rects[i].min_y, rects[i].max_y);
+    drawRectMask(map, rects[i], masks[i]);
+  }
+}
+
+//参考线车道: 沿圆弧左右各偏半个车宽, 左边界加反向的右边界为一个多边形, 再整体旋转平移
+std::vector< RoiVertex > lanePolygon(double x0, double y0, double heading, double curvature, double length,
+                                     double half_width)
+{
+  std::vector< RoiVertex > left, right;
+  for (double s = 0; s <= length; s += 0.7)
+  {
+    double theta = heading + curvature * s;
+    double x = x0, y = y0;
+    if (fabs(curvature) < 1e-6)
+    {
+      x += s * cos(heading);
+      y += s * sin(heading);
+    }
+    else
+    {
+      x += (sin(theta) - sin(heading)) / curvature;
+      y += (cos(heading) - cos(theta)) / curvature;
+    }
+    RoiVertex l = { x - half_width * sin(theta), y + half_width * cos(theta) };
+    RoiVertex r = { x + half_width * sin(theta), y - half_width * cos(theta) };
+    left.push_back(l);
+    right.push_back(r);
+  }
+  left.insert(left.end(), right.rbegin(), right.rend());
+  return left;
+}
+
+std::vector< std::vector< RoiVertex > > randomLanes()
+{
+  std::vector< std::vector< RoiVertex > > lanes;
+  int count = 1 + rand() % 4;
+  for (int i = 0; i < count; i++)
+  {
+    lanes.push_back(lanePolygon(uniform(-20, 15), uniform(-40, 40), uniform(-M_PI, M_PI), uniform(-0.05, 0.05),
+                                uniform(10, 80), uniform(1.5, 3)));
+  }
+  return lanes;
+}
+
+//奇偶规则逐个栅格中心判断, 多个多边形取并集
+bool insidePolygons(const std::vector< std::vector< RoiVertex > > &polygons, double x, double y)
+{
+  for (size_t k = 0; k < polygons.size(); k++)
+  {
+    const std::vector< RoiVertex > &p = polygons[k];
+    bool inside = false;
+    for (size_t i = 0, j = p.size() - 1; i < p.size(); j = i++)
+    {
+      if ((p[i].y <= y) != (p[j].y <= y) && x <= p[j].x + (y - p[j].y) * (p[i].x - p[j].x) / (p[i].y - p[j].y))
+      {
+        inside = !inside;
+      }
+    }
+    if (inside)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void expectLaneLayer(const RoiLayerMap &map, const std::vector< std::vector< RoiVertex > > &lanes)
+{
+  for (int row = 0; row < map.getRows(); row++)
+  {
+    double y = (row + 0.5) / roi_scale - roi_back;
+    for (int col = 0; col < map.getCols(); col++)
+    {
+      double x = (col + 0.5) / roi_scale - roi_left;
+      ASSERT_EQ(insidePolygons(lanes, x, y), (map.cells[row * map.getCols() + col] >> ROI_LAYER_LANE) & 1)
+          << "row " << row << " col " << col;
+    }
+  }
+}
+} // namespace
+
+TEST(RoiLayerMap, CellsMatchLayerMasks)
+{
+  RoiLayerMap map;
+  std::vector< cv::Mat > masks;
+  std::vector< RoiRect > rects;
+  initLayers(map, masks, rects);
+  ASSERT_EQ(320, map.getRows());
+  ASSERT_EQ(100, map.getCols());
+  for (int row = 0; row < map.getRows(); row++)
+  {
+    for (int col = 0; col < map.getCols(); col++)
+    {
+      for (size_t i = 0; i < masks.size(); i++)
+      {
+        ASSERT_EQ(masks[i].at< uint8_t >(row, col) != 0, (map.cells[row * map.getCols() + col] >> i) & 1)
+            << "layer " << i << " row " << row << " col " << col;
+      }
+    }
+  }
+}
+
+//车速变化时增量更新前方图层, 每次更新后与重画的掩膜分类一致
+TEST(RoiLayerMap, SpeedLayerClassificationMatchesMasks)
+{
+  srand(9);
+  RoiLayerMap map;
+  std::vector< cv::Mat > masks;
+  std::vector< RoiRect > rects;
+  initLayers(map, masks, rects);
+
+  double speed = 0;
+  for (int step = 0; step < 300; step++)
+  {
+    speed = std::max(0.0, std::min(5.0, speed + uniform(-0.3, 0.35)));
+    RoiRect rect = speedRect(speed);
+    map.setLayerRect(ROI_LAYER_SPEED, rect.min_x, rect.max_x, rect.min_y, rect.max_y);
+    drawRectMask(map, rect, masks[ROI_LAYER_SPEED]);
+
+    for (int k = 0; k < 50; k++)
+    {
+      RoiRect box = randomBox();
+      ASSERT_EQ(classifyWithMasks(map, masks, box), map.getBoxLayers(box.min_x, box.max_x, box.min_y, box.max_y))
+          << "step " << step << " box (" << box.min_x << "," << box.min_y << ")-(" << box.max_x << "," << box.max_y
+          << ")";
+    }
+  }
+}
+
+TEST(RoiLayerMap, SpeedLayerUpdateOnlyTouchesChangedRows)
+{
+  RoiLayerMap map;
+  map.init(roi_front, roi_back, roi_left, roi_right, roi_scale);
+  RoiRect rect = speedRect(1.0);
+  map.setLayerRect(ROI_LAYER_SPEED, rect.min_x, rect.max_x, rect.min_y, rect.max_y);
+  EXPECT_EQ(0, map.setLayerRect(ROI_LAYER_SPEED, rect.min_x, rect.max_x, rect.min_y, rect.max_y));
+  // 13m -> 13.5m, 每米4格
+  rect = speedRect(1.0 + 0.5 / 3.0);
+  EXPECT_EQ(2, map.setLayerRect(ROI_LAYER_SPEED, rect.min_x, rect.max_x, rect.min_y, rect.max_y));
+}
+
+//车道图层按多边形逐行填充, 与逐个栅格中心判断一致, 不影响其他图层
+TEST(RoiLayerMap, LanePolygonLayerMatchesPointInPolygon)
+{
+  srand(11);
+  RoiLayerMap map;
+  std::vector< cv::Mat > masks;
+  std::vector< RoiRect > rects;
+  initLayers(map, masks, rects);
+  std::vector< uint8_t > other(map.cells);
+  for (int step = 0; step < 50; step++)
+  {
+    std::vector< std::vector< RoiVertex > > lanes = randomLanes();
+    map.setLayerPolygons(ROI_LAYER_LANE, lanes);
+    expectLaneLayer(map, lanes);
+    for (size_t i = 0; i < other.size(); i++)
+    {
+      ASSERT_EQ(other[i], map.cells[i] & ~(1 << ROI_LAYER_LANE)) << "cell " << i;
+    }
+  }
+}
+
+//定位移动时增量更新车道图层, 结果与新建的图层一致, 定位不变时不改动
+TEST(RoiLayerMap, LanePolygonIncrementalUpdateMatchesFresh)
+{
+  srand(12);
+  std::vector< std::vector< RoiVertex > > lanes = randomLanes();
+  lanes.push_back(lanePolygon(0, -30, M_PI / 2, 0.01, 90, 2));
+  RoiLayerMap map;
+  map.init(roi_front, roi_back, roi_left, roi_right, roi_scale);
+  std::vector< std::vector< RoiVertex > > moved(lanes);
+  for (int step = 0; step < 100; step++)
+  {
+    double dx = step * 0.02, dy = step * 0.1, angle = step * 0.002;
+    for (size_t k = 0; k < lanes.size(); k++)
+    {
+      for (size_t i = 0; i < lanes[k].size(); i++)
+      {
+        moved[k][i].x = lanes[k][i].x * cos(angle) - lanes[k][i].y * sin(angle) - dx;
+        moved[k][i].y = lanes[k][i].x * sin(angle) + lanes[k][i].y * cos(angle) - dy;
+      }
+    }
+    map.setLayerPolygons(ROI_LAYER_LANE, moved);
+    EXPECT_EQ(0, map.setLayerPolygons(ROI_LAYER_LANE, moved));
+
+    RoiLayerMap fresh;
+    fresh.init(roi_front, roi_back, roi_left, roi_right, roi_scale);
+    fresh.setLayerPolygons(ROI_LAYER_LANE, moved);
+    ASSERT_TRUE(fresh.cells == map.cells) << "step " << step;
+  }
+  map.setLayerPolygons(ROI_LAYER_LANE, std::vector< std::vector< RoiVertex > >());
+  EXPECT_EQ(std::vector< uint8_t >(map.cells.size(), 0), map.cells);
+}
+
+//每帧分类耗时: 原方式逐图层掩膜判断并按车速重画前方掩膜, 新方式一次查询并增量更新
+TEST(RoiLayerMap, ClassificationTiming)
+{
+  srand(10);
+  RoiLayerMap map;
+  std::vector< cv::Mat > masks;
+  std::vector< RoiRect > rects;
+  initLayers(map, masks, rects);
+
+  const int frames = 200;
+  const int boxes  = 100;
+  double mask_us = 0, layer_us = 0;
+  int mismatch = 0;
+  double speed = 0;
+  std::vector< uint8_t > mask_result(boxes), layer_result(boxes);
+  std::vector< RoiRect > frame_boxes(boxes);
+  for (int f = 0; f < frames; f++)
+  {
+    speed = std::max(0.0, std::min(5.0, speed + uniform(-0.3, 0.35)));
+    RoiRect rect = speedRect(speed);
+    for (int k = 0; k < boxes; k++)
+    {
+      frame_boxes[k] = randomBox();
+    }
+
+    double t0 = nowUs();
+    cv::Mat &speed_mask = masks[ROI_LAYER_SPEED];
+    speed_mask.setTo(cv::Scalar::all(0));
+    //栅格中心规则与setLayerRect一致
+    int begin   = std::max(static_cast< int >(ceil((rect.min_x + roi_left) * roi_scale - 0.5)), 0);
+    int end     = std::min(static_cast< int >(floor((rect.max_x + roi_left) * roi_scale - 0.5)), map.getCols() - 1);
+    int min_row = std::max(static_cast< int >(ceil((rect.min_y + roi_back) * roi_scale - 0.5)), 0);
+    int max_row = std::min(static_cast< int >(floor((rect.max_y + roi_back) * roi_scale - 0.5)), map.getRows() - 1);
+    if (begin <= end && min_row <= max_row)
+    {
+      cv::rectangle(speed_mask, cv::Point(begin, min_row), cv::Point(end, max_row), cv::Scalar::all(255), -1);
+    }
+    for (int k = 0; k < boxes; k++)
+    {
+      mask_result[k] = classifyWithMasks(map, masks, frame_boxes[k]);
+    }
+    double t1 = nowUs();
+    map.setLayerRect(ROI_LAYER_SPEED, rect.min_x, rect.max_x, rect.min_y, rect.max_y);
+    for (int k = 0; k < boxes; k++)
+    {
+      const RoiRect &box = frame_boxes[k];
+      layer_result[k]    = map.getBoxLayers(box.min_x, box.max_x, box.min_y, box.max_y);
+    }
+    double t2 = nowUs();
+    mask_us += t1 - t0;
+    layer_us += t2 - t1;
+    for (int k = 0; k < boxes; k++)
+    {
+      mismatch += mask_result[k] != layer_result[k];
+    }
+  }
+  printf("%d boxes per frame: cv::Mat masks %.1f us, bitset layers %.1f us per frame\n", boxes, mask_us / frames,
+         layer_us / frames);
+  EXPECT_EQ(0, mismatch);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,219 @@
+#include "route_grid_index.h"
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+using namespace superg_agv::roi_math;
+
+namespace
+{
+struct RefPoint
+{
+  double rx;
+  double ry;
+  double rs;
+};
+
+struct PathPoint
+{
+  double x;
+  double y;
+};
+
+double uniform(double lo, double hi)
+{
+  return lo + (hi - lo) * (rand() / (double)RAND_MAX);
+}
+
+double nowUs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+//直线与圆弧交替的参考线,点间距0.1m,坐标取整到厘米以制造等距点
+std::vector< RefPoint > makeRoute(int count)
+{
+  std::vector< RefPoint > route(count);
+  double x = 0, y = 0, heading = 0, s = 0, curvature = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (i % 500 == 0)
+    {
+      curvature = (i / 500) % 2 ? uniform(-0.05, 0.05) : 0.0;
+    }
+    route[i].rx = floor(x * 100) / 100;
+    route[i].ry = floor(y * 100) / 100;
+    route[i].rs = s;
+    heading += curvature * 0.1;
+    x += 0.1 * cos(heading);
+    y += 0.1 * sin(heading);
+    s += 0.1;
+  }
+  return route;
+}
+
+//与obstacle_handing中原顺序遍历相同: 距离平方严格更小才更新
+int linearNearest(const std::vector< RefPoint > &route, double x, double y, int begin_index, int end_index,
+                  double max_distance_sq)
+{
+  int min_index = -1;
+  double min_distance = max_distance_sq;
+  for (int i = begin_index; i < end_index; i++)
+  {
+    double d = (x - route[i].rx) * (x - route[i].rx) + (y - route[i].ry) * (y - route[i].ry);
+    if (min_distance > d)
+    {
+      min_distance = d;
+      min_index = i;
+    }
+  }
+  return min_index;
+}
+
+RouteCellBox linearCellBox(const std::vector< RefPoint > &route, int begin_index, int end_index, double cell_size)
+{
+  RouteCellBox box;
+  box.min_cx = box.min_cy = 1 << 30;
+  box.max_cx = box.max_cy = -(1 << 30);
+  for (int i = begin_index; i < end_index; i++)
+  {
+    int cx = static_cast< int >(floor(route[i].rx / cell_size));
+    int cy = static_cast< int >(floor(route[i].ry / cell_size));
+    box.min_cx = min(box.min_cx, cx);
+    box.max_cx = max(box.max_cx, cx);
+    box.min_cy = min(box.min_cy, cy);
+    box.max_cy = max(box.max_cy, cy);
+  }
+  return box;
+}
+}  // namespace
+
+TEST(RouteGridIndex, NearestMatchesLinearScan)
+{
+  srand(5);
+  std::vector< RefPoint > route = makeRoute(5000);
+  RouteGridIndex index;
+  index.build(route, 2.0);
+  for (int t = 0; t < 5000; t++)
+  {
+    const RefPoint &p = route[rand() % route.size()];
+    //一半查询取在参考点上,检验等距时取小序号
+    double x = t % 2 ? p.rx : p.rx + uniform(-12, 12);
+    double y = t % 2 ? p.ry : p.ry + uniform(-12, 12);
+    int begin_index = rand() % 5000;
+    int end_index = begin_index + rand() % (5000 - begin_index + 1);
+    double max_distance_sq = t % 3 ? 100.0 : 80.0 * 80.0;
+
+    double d = 0;
+    int expect = linearNearest(route, x, y, begin_index, end_index, max_distance_sq);
+    ASSERT_EQ(expect, index.findNearest(x, y, begin_index, end_index, max_distance_sq,
+                                        index.getCellBox(begin_index, end_index), d));
+    ASSERT_EQ(expect, index.findNearest(x, y, begin_index, end_index, max_distance_sq, index.getRouteBox(), d));
+    int warm_end = begin_index + rand() % 60;
+    ASSERT_EQ(expect, index.findNearestWarm(x, y, begin_index, end_index, warm_end, max_distance_sq, d));
+  }
+}
+
+TEST(RouteGridIndex, CellBoxMatchesLinearScan)
+{
+  srand(6);
+  std::vector< RefPoint > route = makeRoute(3000);
+  RouteGridIndex index;
+  index.build(route, 2.0);
+  for (int t = 0; t < 2000; t++)
+  {
+    int begin_index = rand() % 3000;
+    int end_index = begin_index + 1 + rand() % (3000 - begin_index);
+    RouteCellBox expect = linearCellBox(route, begin_index, end_index, 2.0);
+    RouteCellBox box = index.getCellBox(begin_index, end_index);
+    ASSERT_EQ(expect.min_cx, box.min_cx);
+    ASSERT_EQ(expect.max_cx, box.max_cx);
+    ASSERT_EQ(expect.min_cy, box.min_cy);
+    ASSERT_EQ(expect.max_cy, box.max_cy);
+  }
+  RouteCellBox empty = index.getCellBox(10, 10);
+  EXPECT_LT(empty.max_cx, empty.min_cx);
+}
+
+TEST(RouteGridIndex, EndIndexByS)
+{
+  std::vector< RefPoint > route = makeRoute(1000);
+  RouteGridIndex index;
+  index.build(route, 2.0);
+  for (int begin_index = 0; begin_index < 1000; begin_index += 37)
+  {
+    double max_s = route[begin_index].rs + 40.0;
+    int expect = begin_index;
+    while (expect < 1000 && route[expect].rs <= max_s)
+    {
+      expect++;
+    }
+    EXPECT_EQ(expect, index.getEndIndexByS(begin_index, 1000, max_s));
+  }
+}
+
+TEST(RouteGridIndex, BuildFromPathPoints)
+{
+  std::vector< RefPoint > route = makeRoute(800);
+  std::vector< PathPoint > path(route.size());
+  for (size_t i = 0; i < route.size(); i++)
+  {
+    path[i].x = route[i].rx;
+    path[i].y = route[i].ry;
+  }
+  RouteGridIndex index;
+  index.buildXY(path, 2.0);
+  ASSERT_EQ(800, index.size());
+  //弧长单调,可按里程截取
+  EXPECT_GT(index.getEndIndexByS(0, 800, 10.0), 90);
+  EXPECT_LT(index.getEndIndexByS(0, 800, 10.0), 110);
+  double d = 0;
+  EXPECT_EQ(linearNearest(route, 13.0, 4.0, 0, 800, 100.0), index.findNearestWarm(13.0, 4.0, 0, 800, 0, 100.0, d));
+}
+
+//定位查询的耗时对比: 原顺序遍历[last - 31, count - 1) 与暖启动网格查找
+TEST(RouteGridIndex, LocationQueryTiming)
+{
+  srand(7);
+  const int counts[] = { 2000, 10000, 50000 };
+  for (int c = 0; c < 3; c++)
+  {
+    std::vector< RefPoint > route = makeRoute(counts[c]);
+    RouteGridIndex index;
+    index.build(route, 2.0);
+    int last_index = 0;
+    int mismatch = 0;
+    double linear_us = 0, grid_us = 0;
+    for (int i = 41; i < counts[c] - 1; i += 5)
+    {
+      double x = route[i].rx + uniform(-0.5, 0.5);
+      double y = route[i].ry + uniform(-0.5, 0.5);
+      int begin_index = last_index > 40 ? last_index - 30 : 3;
+      double t0 = nowUs();
+      int expect = linearNearest(route, x, y, begin_index - 1, counts[c] - 1, 100);
+      double t1 = nowUs();
+      double d = 0;
+      int got = index.findNearestWarm(x, y, begin_index - 1, counts[c] - 1, last_index + 30, 100, d);
+      double t2 = nowUs();
+      linear_us += t1 - t0;
+      grid_us += t2 - t1;
+      mismatch += expect != got;
+      last_index = got;
+    }
+    int queries = (counts[c] - 42) / 5 + 1;
+    printf("%6d ref points: linear %8.2f us  grid %6.2f us per query\n", counts[c], linear_us / queries,
+           grid_us / queries);
+    EXPECT_EQ(0, mismatch);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
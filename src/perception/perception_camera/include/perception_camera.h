@@ -36,6 +36,7 @@
 #include "utils/tools.h"
 #include "sensor_object/base_object.h"
 #include "associate/base_association.h"
+#include "tracker/sort_tracker.h"
 
 using namespace std;
 
@@ -48,6 +49,7 @@ namespace sensor_camera
     public:
         explicit PerceptionCamera(
             BaseAssociation* base_associatio, 
+            SortTracker* sort_tracker,
             string calibration_file,
             string image_obstacle_topic,
             string lidar_topic,
@@ -69,6 +71,8 @@ namespace sensor_camera
         void updateUnassociatedObject(vector<sensor_camera::BaseObject*>& new_obj, Eigen::MatrixXd& matrix);
         void publishFusionObject(ros::Time pub_time, bool is_draw);
 
+        void initProjection();
+        void trackImageObstacle(const perception_camera::CameraObstacle& camera_obstacle_msg, perception_camera::CameraObstacle& tracked_obstacle_msg);
         void projectLidarPoints(const sensor_msgs::PointCloud2& msg_lidar);
         void splitPointCloudWithImageObstacleInfo(vector<BaseObject*>& base_object_list);
 
@@ -89,6 +93,9 @@ namespace sensor_camera
         message_filters::Subscriber<sensor_msgs::PointCloud2> sub_pointcloud_;
 
         BaseAssociation* base_association_;
+        SortTracker* sort_tracker_;     // 图像检测框跟踪, 为空时直接使用检测结果
+        vector<SortDetection> sort_detections_;
+        vector<SortTrackResult> sort_results_;
         map<uint32_t, sensor_camera::BaseObject*> global_object_;
 
         uint32_t global_id_ = 0;
@@ -109,7 +116,18 @@ namespace sensor_camera
         const int resize_width_ = 640.0;
         const int resize_height_ = 360.0;
 
-        float* dist_image_ = new float[resize_height_*resize_width_*3];
+        // 投影参数, 构造时由标定文件预计算
+        // 前3行: 激光点 -> 补偿alpha_和安装高度后的激光点, 后3行: 激光点 -> 相机坐标
+        Eigen::Matrix<float, 6, 3> transform_rotation_;
+        Eigen::Matrix<float, 6, 1> transform_offset_;
+        Eigen::Matrix<float, 6, Eigen::Dynamic> transformed_points_;
+        float fov_tan_ = 0.0;
+        float fx_ = 0.0, fy_ = 0.0, cx_ = 0.0, cy_ = 0.0;
+        float k1_ = 0.0, k2_ = 0.0, p1_ = 0.0, p2_ = 0.0, k3_ = 0.0;
+
+        pcl::PointCloud<pcl::PointXYZ> laser_;          // 输入点云, 复用内存
+        pcl::PointCloud<pcl::PointXYZ> image_points_;   // 投影落在图像内的点(补偿后的激光坐标)
+        vector<int> index_image_;                       // 缩放图像每个像素上最近点在image_points_中的序号, -1为无点
     };
 }
 
@@ -0,0 +1,114 @@
+#ifndef _SORT_TRACKER_H_
+#define _SORT_TRACKER_H_
+
+#include <iostream>
+#include <vector>
+#include <Eigen/Dense>
+
+using namespace std;
+
+// #define DEBUG_SORT_TRACKER
+
+namespace sensor_camera
+{
+    // 图像检测框, 像素坐标
+    struct SortDetection
+    {
+        float xmin;
+        float ymin;
+        float xmax;
+        float ymax;
+        float score;
+        uint32_t object_class;
+    };
+
+    // 跟踪输出, detection_index为本帧匹配的检测序号
+    struct SortTrackResult
+    {
+        uint32_t id;
+        float xmin;
+        float ymin;
+        float xmax;
+        float ymax;
+        float score;
+        uint32_t object_class;
+        int detection_index;
+    };
+
+    // 匀速模型的检测框卡尔曼滤波, 状态[cx, cy, s, r, vcx, vcy, vs], s为面积, r为宽高比
+    class SortKalmanBox
+    {
+    public:
+        explicit SortKalmanBox(const SortDetection& detection);
+
+        void predict();
+        void update(const SortDetection& detection);
+        void getBox(float& xmin, float& ymin, float& xmax, float& ymax) const;
+        bool isValid() const;
+
+    private:
+        static Eigen::Vector4f boxToMeasurement(const SortDetection& detection);
+
+        Eigen::Matrix<float, 7, 1> x_;
+        Eigen::Matrix<float, 7, 7> P_;
+    };
+
+    struct SortTrack
+    {
+        uint32_t id;
+        SortKalmanBox filter;
+        float score;
+        uint32_t object_class;
+        int hits;
+        int hit_streak;
+        int age;
+        int time_since_update;
+        int detection_index;
+
+        SortTrack(uint32_t track_id, const SortDetection& detection);
+    };
+
+    // SORT/ByteTrack式的多目标跟踪
+    // 1. 高分检测与全部轨迹按IoU做匈牙利匹配, IoU低于阈值或类别不同的配对不接受
+    // 2. 低分检测与剩余轨迹再匹配一次, 只用于延续轨迹, 不新建轨迹
+    // 3. 未匹配的高分检测新建轨迹, 连续命中min_hits次后输出, 超过max_age帧未更新删除
+    class SortTracker
+    {
+    public:
+        explicit SortTracker(
+            int max_age = 3,
+            int min_hits = 2,
+            float iou_threshold = 0.3,
+            float high_score_threshold = 0.5,
+            float low_score_threshold = 0.1,
+            float low_iou_threshold = 0.5
+        );
+        ~SortTracker();
+
+        // 每帧调用一次, 没有检测也要调用
+        void update(const vector<SortDetection>& detections, vector<SortTrackResult>& results);
+
+        const vector<SortTrack>& getTracks() const;
+
+    private:
+        void associate(const vector<SortDetection>& detections, const vector<int>& detection_indices, vector<int>& track_indices, float iou_threshold, vector<int>& unmatched_detections);
+
+        vector<SortTrack> tracks_;
+        uint32_t next_id_ = 0;
+        int frame_count_ = 0;
+
+        int max_age_;
+        int min_hits_;
+        float iou_threshold_;
+        float high_score_threshold_;
+        float low_score_threshold_;
+        float low_iou_threshold_;
+    };
+
+    float calculateBoxIou(float axmin, float aymin, float axmax, float aymax, float bxmin, float bymin, float bxmax, float bymax);
+
+    // 矩形代价矩阵的最小代价匹配, assignment[row]为匹配的列, -1为未匹配
+    void solveAssignment(const Eigen::MatrixXf& cost, vector<int>& assignment);
+}
+
+#endif // _SORT_TRACKER_H_
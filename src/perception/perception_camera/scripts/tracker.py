@@ -3,7 +3,6 @@ import time
 import math
 import numpy as np
 import tensorflow as tf
-from sort import Sort 
 from viz import Draw
 
 class Tracker:
@@ -26,8 +25,6 @@ class Tracker:
 
         gpu_options = tf.GPUOptions(per_process_gpu_memory_fraction=per_process_gpu_memory_fraction)
         self.sess = tf.Session(graph=self.detection_graph, config=tf.ConfigProto(gpu_options=gpu_options))
-        
-        self.tracker = Sort()
 
     def _getCameraInfo(self, camera_cfg_path):
         fs = cv2.FileStorage(camera_cfg_path, cv2.FileStorage_READ)
@@ -108,7 +105,6 @@ class Tracker:
         
         if boxes is None:
             return tracking_results, undistort_frame
-            # tracking_results = self.tracker.update(dets)
         else:
             for idx, i in enumerate(classes):
                 class_label = i 
@@ -125,7 +121,6 @@ class Tracker:
             # if dets is None:
             #     dets = np.array([[]])
             tracking_results = dets
-            # tracking_results = self.tracker.update(dets)
 
         if tracking_results is not None and tracking_results.shape[0] > 0:
             tracking_results = self._getDistance(tracking_results)
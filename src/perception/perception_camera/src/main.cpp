@@ -42,10 +42,20 @@ int main(int argc, char **argv)
     // // BaseAssociation* base_association = new MaxAssociation(0.5);
     sensor_camera::BaseAssociation* base_association = new sensor_camera::HungarianAssociation(0.2);
 
+    // 图像检测框的SORT跟踪, 代替原Python脚本中的跟踪
+    bool use_sort_tracker = false;
+    ros::param::get("use_sort_tracker", use_sort_tracker);
+    sensor_camera::SortTracker* sort_tracker = NULL;
+    if(use_sort_tracker)
+    {
+        sort_tracker = new sensor_camera::SortTracker();
+    }
+
     bool is_draw = true;
 
     sensor_camera::PerceptionCamera perception_camera(
         base_association, 
+        sort_tracker,
         config_path,
         image_obstacle_topic,
         lidar_topic,
@@ -2,6 +2,7 @@
 
 sensor_camera::PerceptionCamera::PerceptionCamera(
     BaseAssociation* base_association, 
+    SortTracker* sort_tracker,
     string calibration_file,
     string image_obstacle_topic,
     string lidar_topic,
@@ -12,6 +13,7 @@ sensor_camera::PerceptionCamera::PerceptionCamera(
     string pub_rviz_split_pointcloud_with_image_obstacle_info_topic,
     bool is_draw):
 base_association_(base_association),
+sort_tracker_(sort_tracker),
 is_draw_(is_draw)
 {
 #ifdef DEBUG_PERCEPTION_FUSION
@@ -46,7 +48,7 @@ is_draw_(is_draw)
     file_read["fdy"] >> fdy_;
     file_read.release();
 
-    memset(dist_image_, -500, resize_width_*resize_height_*3);
+    initProjection();
 
 #ifdef DEBUG_PERCEPTION_FUSION
     cout << "PerceptionCamera ctor endl" << endl;
@@ -56,7 +58,7 @@ is_draw_(is_draw)
 sensor_camera::PerceptionCamera::~PerceptionCamera()
 {
     delete base_association_;
-    delete dist_image_;
+    delete sort_tracker_;
     delete intrinsic_;
     delete distCoeffs_;
     delete rvec_;
@@ -76,7 +78,16 @@ void sensor_camera::PerceptionCamera::callbackcamera(const perception_camera::Ca
 
     // 将目标信息转为BaseObject类型
     vector<BaseObject*> base_object_list;
-    sensor_camera::inputTypeTransform(*camera_obstacle_msg, base_object_list, camera_obstacle_msg->header.stamp);
+    if(sort_tracker_ != NULL)
+    {
+        perception_camera::CameraObstacle tracked_obstacle_msg;
+        trackImageObstacle(*camera_obstacle_msg, tracked_obstacle_msg);
+        sensor_camera::inputTypeTransform(tracked_obstacle_msg, base_object_list, camera_obstacle_msg->header.stamp);
+    }
+    else
+    {
+        sensor_camera::inputTypeTransform(*camera_obstacle_msg, base_object_list, camera_obstacle_msg->header.stamp);
+    }
 
     if(base_object_list.size() != 0)
     {
@@ -277,67 +288,155 @@ void sensor_camera::PerceptionCamera::publishFusionObject(ros::Time pub_time, bo
     cout << "********************** publish : end **********************" << endl;
 }
 
+// 检测框经SORT跟踪后, 只保留已确认轨迹本帧匹配到的检测, 像素框替换为滤波后的框
+void sensor_camera::PerceptionCamera::trackImageObstacle(const perception_camera::CameraObstacle& camera_obstacle_msg, perception_camera::CameraObstacle& tracked_obstacle_msg)
+{
+#ifdef DEBUG_PERCEPTION_FUSION
+    cout << "trackImageObstacle start" << endl;
+#endif
+
+    sort_detections_.resize(camera_obstacle_msg.confidence.size());
+    for(int i = 0; i < camera_obstacle_msg.confidence.size(); i++)
+    {
+        sort_detections_[i].xmin = camera_obstacle_msg.xmin[i];
+        sort_detections_[i].ymin = camera_obstacle_msg.ymin[i];
+        sort_detections_[i].xmax = camera_obstacle_msg.xmax[i];
+        sort_detections_[i].ymax = camera_obstacle_msg.ymax[i];
+        sort_detections_[i].score = camera_obstacle_msg.confidence[i];
+        sort_detections_[i].object_class = camera_obstacle_msg.object_class[i];
+    }
+
+    sort_tracker_->update(sort_detections_, sort_results_);
+
+    tracked_obstacle_msg.header = camera_obstacle_msg.header;
+    for(int i = 0; i < sort_results_.size(); i++)
+    {
+        int d = sort_results_[i].detection_index;
+        tracked_obstacle_msg.xmin.push_back(sort_results_[i].xmin);
+        tracked_obstacle_msg.ymin.push_back(sort_results_[i].ymin);
+        tracked_obstacle_msg.xmax.push_back(sort_results_[i].xmax);
+        tracked_obstacle_msg.ymax.push_back(sort_results_[i].ymax);
+        tracked_obstacle_msg.confidence.push_back(camera_obstacle_msg.confidence[d]);
+        tracked_obstacle_msg.object_class.push_back(camera_obstacle_msg.object_class[d]);
+        tracked_obstacle_msg.x.push_back(camera_obstacle_msg.x[d]);
+        tracked_obstacle_msg.y.push_back(camera_obstacle_msg.y[d]);
+        tracked_obstacle_msg.w.push_back(camera_obstacle_msg.w[d]);
+        tracked_obstacle_msg.h.push_back(camera_obstacle_msg.h[d]);
+    }
+
+#ifdef DEBUG_PERCEPTION_FUSION
+    cout << "trackImageObstacle end, detections: " << sort_detections_.size() << ", tracked: " << sort_results_.size() << endl;
+#endif
+}
+
+void sensor_camera::PerceptionCamera::initProjection()
+{
+    // 激光点先绕z轴旋转alpha_并补偿安装高度, 再由rvec_/tvec_变换到相机坐标系
+    Eigen::Matrix3f lidar_rotation;
+    lidar_rotation << cos(alpha_), -sin(alpha_), 0,
+                      sin(alpha_), cos(alpha_), 0,
+                      0, 0, 1;
+    Eigen::Vector3f lidar_offset(0, 0, -0.35);
+
+    cv::Mat rotation, translation, intrinsic, dist_coeffs;
+    cv::Rodrigues(*rvec_, rotation);
+    rotation.convertTo(rotation, CV_32F);
+    tvec_->convertTo(translation, CV_32F);
+    intrinsic_->convertTo(intrinsic, CV_32F);
+    distCoeffs_->convertTo(dist_coeffs, CV_32F);
+
+    Eigen::Matrix3f camera_rotation;
+    Eigen::Vector3f camera_translation;
+    for(int r = 0; r < 3; r++)
+    {
+        for(int c = 0; c < 3; c++)
+        {
+            camera_rotation(r, c) = rotation.at<float>(r, c);
+        }
+        camera_translation(r) = translation.at<float>(r);
+    }
+
+    transform_rotation_.topRows<3>() = lidar_rotation;
+    transform_rotation_.bottomRows<3>() = camera_rotation * lidar_rotation;
+    transform_offset_.head<3>() = lidar_offset;
+    transform_offset_.tail<3>() = camera_rotation * lidar_offset + camera_translation;
+
+    fx_ = intrinsic.at<float>(0, 0);
+    fy_ = intrinsic.at<float>(1, 1);
+    cx_ = intrinsic.at<float>(0, 2);
+    cy_ = intrinsic.at<float>(1, 2);
+
+    // 与cv::projectPoints相同的5参数畸变模型
+    dist_coeffs = dist_coeffs.reshape(1, dist_coeffs.total());
+    k1_ = dist_coeffs.total() > 0 ? dist_coeffs.at<float>(0) : 0.0;
+    k2_ = dist_coeffs.total() > 1 ? dist_coeffs.at<float>(1) : 0.0;
+    p1_ = dist_coeffs.total() > 2 ? dist_coeffs.at<float>(2) : 0.0;
+    p2_ = dist_coeffs.total() > 3 ? dist_coeffs.at<float>(3) : 0.0;
+    k3_ = dist_coeffs.total() > 4 ? dist_coeffs.at<float>(4) : 0.0;
+
+    fov_tan_ = tan(fov_ * M_PI / 180.0);
+
+    index_image_.assign(resize_width_ * resize_height_, -1);
+}
+
 void sensor_camera::PerceptionCamera::projectLidarPoints(const sensor_msgs::PointCloud2& msg_lidar)
 {
     // 激光点云投影到图像上
-	pcl::PointCloud<pcl::PointXYZ> laser;
-    pcl::fromROSMsg(msg_lidar, laser);
-
-    pcl::PointCloud<pcl::PointXYZ>::Ptr laser_ptr{new pcl::PointCloud< pcl::PointXYZ >};
-	pcl::fromROSMsg(msg_lidar, *laser_ptr);
-
-    memset(dist_image_, -500, resize_width_*resize_height_*3);
-
-	vector<cv::Point3f> laserPoints;
-	vector<float> laser_dist;
-	for(int i = 0; i < laser.points.size(); i ++)
-	{
-		pcl::PointXYZ point = laser.points[i];
-		pcl::PointXYZ point2;
-		point2.x = point.x * cos(alpha_) - point.y * sin(alpha_);
-		point2.y = point.x * sin(alpha_) + point.y * cos(alpha_);
-		point2.z = point.z - 0.35;
-
-		float angle = atan2(point2.y, point2.x) * 180.0 / M_PI;
-		if(fabs(angle) > fov_)
-		{
-			continue;
-		}
-
-		// laserPoints.push_back(cv::Point3f(point2.x * 1000, point2.y * 1000, point2.z * 1000));
-        laserPoints.push_back(cv::Point3f(point2.x, point2.y, point2.z));
-	}
-
-	vector<cv::Point2f> projectedPoints;
-	cv::projectPoints(laserPoints, *rvec_, *tvec_, *intrinsic_, *distCoeffs_, projectedPoints);
-
-    if(projectedPoints.size() != laserPoints.size())
+    pcl::fromROSMsg(msg_lidar, laser_);
+
+    std::fill(index_image_.begin(), index_image_.end(), -1);
+    image_points_.clear();
+
+    // 一次矩阵乘同时得到补偿后的激光坐标和相机坐标, Eigen按列向量化
+    int point_num = laser_.points.size();
+    transformed_points_.resize(6, point_num);
+    transformed_points_.noalias() = transform_rotation_ * laser_.getMatrixXfMap(3, 4, 0);
+    transformed_points_.colwise() += transform_offset_;
+
+    for(int i = 0; i < point_num; i++)
     {
-        cout << "Error projectedPoints.size() != laserPoints.size() !!!" << endl;
-        exit(-1);
-    }
+        const float* point = transformed_points_.col(i).data();
 
-    pcl::PointCloud<pcl::PointXYZ>  split_pointcloud;
-    for(int i = 0; i < projectedPoints.size(); i++)
-	{
-        if(projectedPoints[i].x >= 0 && projectedPoints[i].x < camera_width_ && projectedPoints[i].y >= 0 && projectedPoints[i].y < camera_height_)
+        // |atan2(y, x)| <= fov_, fov_小于90度
+        // 写成取反的正向比较, NaN点任何比较都为假, 会被跳过
+        if(!(point[0] > 0 && fabs(point[1]) <= point[0] * fov_tan_ && point[5] > 0))
         {
-            int x = projectedPoints[i].x / camera_width_ * resize_width_;
-            int y = projectedPoints[i].y / camera_height_ * resize_height_;
-            dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] = laserPoints[i].x;
-            dist_image_[y*resize_width_ + x + resize_width_*resize_height_*1] = laserPoints[i].y;
-            dist_image_[y*resize_width_ + x + resize_width_*resize_height_*2] = laserPoints[i].z;
-            
-            pcl::PointXYZ point;
-            point.x = laserPoints[i].x;
-            point.y = laserPoints[i].y;
-            point.z = laserPoints[i].z;
-            split_pointcloud.points.push_back(point);
+            continue;
+        }
+
+        float xn = point[3] / point[5];
+        float yn = point[4] / point[5];
+        float r2 = xn * xn + yn * yn;
+        float radial = 1 + r2 * (k1_ + r2 * (k2_ + r2 * k3_));
+        float xd = xn * radial + 2 * p1_ * xn * yn + p2_ * (r2 + 2 * xn * xn);
+        float yd = yn * radial + p1_ * (r2 + 2 * yn * yn) + 2 * p2_ * xn * yn;
+        float u = fx_ * xd + cx_;
+        float v = fy_ * yd + cy_;
+
+        // 畸变模型在视场边缘可能溢出为inf/NaN, 同样用正向比较剔除
+        if(!(u >= 0 && u < camera_width_ && v >= 0 && v < camera_height_))
+        {
+            continue;
+        }
+
+        pcl::PointXYZ image_point;
+        image_point.x = point[0];
+        image_point.y = point[1];
+        image_point.z = point[2];
+        image_points_.points.push_back(image_point);
+
+        // z-buffer: 同一像素只保留最近的点
+        int x = std::min(int(u / camera_width_ * resize_width_), resize_width_ - 1);
+        int y = std::min(int(v / camera_height_ * resize_height_), resize_height_ - 1);
+        int& index = index_image_[y * resize_width_ + x];
+        if(index < 0 || image_point.x < image_points_.points[index].x)
+        {
+            index = image_points_.points.size() - 1;
         }
     }
 
     sensor_msgs::PointCloud2 split_pointcloud_msg;
-    pcl::toROSMsg(split_pointcloud, split_pointcloud_msg);
+    pcl::toROSMsg(image_points_, split_pointcloud_msg);
     split_pointcloud_msg.header.frame_id = "/velodyne";
     split_pointcloud_msg.header.stamp = ros::Time::now();
 
@@ -380,6 +479,14 @@ void sensor_camera::PerceptionCamera::splitPointCloudWithImageObstacleInfo(vecto
         dist_pix_xmin = resize_pix_xmin + width / 2;
         dist_pix_xmax = resize_pix_xmax - width / 2;
 
+        // 检测框可能超出图像, 按索引图边界裁剪
+        resize_pix_xmin = std::max(resize_pix_xmin, 0);
+        resize_pix_ymin = std::max(resize_pix_ymin, 0);
+        resize_pix_xmax = std::min(resize_pix_xmax, resize_width_);
+        resize_pix_ymax = std::min(resize_pix_ymax, resize_height_);
+        dist_pix_xmin = std::max(dist_pix_xmin, 0);
+        dist_pix_xmax = std::min(dist_pix_xmax, resize_width_);
+
         float xmin = 99999.0;
         float ymin = 0.0;
         float zmin = 0.0;
@@ -408,35 +515,34 @@ void sensor_camera::PerceptionCamera::splitPointCloudWithImageObstacleInfo(vecto
             min_search_dist = 0.1;
         }
         
-        for(int x = dist_pix_xmin; x < dist_pix_xmax; x++)
+        for(int y = resize_pix_ymin; y < resize_pix_ymax; y++)
         {
-            for(int y = resize_pix_ymin; y < resize_pix_ymax; y++)
+            const int* index_row = &index_image_[y * resize_width_];
+            for(int x = dist_pix_xmin; x < dist_pix_xmax; x++)
             {
-                if(dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] < 0 || 
-                    dist_image_[y*resize_width_ + x + resize_width_*resize_height_*2] < -1.3 ||
-                    dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] < 0.1)
+                if(index_row[x] < 0)
                 {
                     continue;
                 }
 
-                if(dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] > max_search_dist || 
-                    dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] < min_search_dist)
+                const pcl::PointXYZ& point = image_points_.points[index_row[x]];
+                if(point.z < -1.3 || point.x < 0.1)
                 {
                     continue;
                 }
 
-                pcl::PointXYZ point;
-                point.x = dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0];
-                point.y = dist_image_[y*resize_width_ + x + resize_width_*resize_height_*1];
-                point.z = dist_image_[y*resize_width_ + x + resize_width_*resize_height_*2];
+                if(point.x > max_search_dist || point.x < min_search_dist)
+                {
+                    continue;
+                }
 
                 split_pointcloud.points.push_back(point);
 
-                if(dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] < xmin)
+                if(point.x < xmin)
                 {
-                    xmin = dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0];
-                    ymin = dist_image_[y*resize_width_ + x + resize_width_*resize_height_*1];
-                    zmin = dist_image_[y*resize_width_ + x + resize_width_*resize_height_*2];
+                    xmin = point.x;
+                    ymin = point.y;
+                    zmin = point.z;
                 }
             }
         }
@@ -468,28 +574,30 @@ void sensor_camera::PerceptionCamera::splitPointCloudWithImageObstacleInfo(vecto
             float prior_depth = state_3d[2] - state_3d[0];
 
             float xmax = -10;
-            for(int x = resize_pix_xmin; x < resize_pix_xmax; x++)
+            for(int y = resize_pix_ymin; y < resize_pix_ymax; y++)
             {
-                for(int y = resize_pix_ymin; y < resize_pix_ymax; y++)
+                const int* index_row = &index_image_[y * resize_width_];
+                for(int x = resize_pix_xmin; x < resize_pix_xmax; x++)
                 {
-                    if(dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] < 0 || 
-                        dist_image_[y*resize_width_ + x + resize_width_*resize_height_*2] < -1.0 ||
-                        dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] < 0.1)
+                    if(index_row[x] < 0)
+                    {
+                        continue;
+                    }
+
+                    const pcl::PointXYZ& point = image_points_.points[index_row[x]];
+                    if(point.z < -1.0 || point.x < 0.1)
                     {
                         continue;
                     }
 
-                    if(dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] > max_search_dist || 
-                        dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] < min_search_dist)
+                    if(point.x > max_search_dist || point.x < min_search_dist)
                     {
                         continue;
                     }
 
-                    if(dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] > xmin && 
-                        dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] < xmin+prior_depth &&
-                        dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0] > xmax)
+                    if(point.x > xmin && point.x < xmin+prior_depth && point.x > xmax)
                     {
-                        xmax = dist_image_[y*resize_width_ + x + resize_width_*resize_height_*0];
+                        xmax = point.x;
                     }
                 }
             }
@@ -0,0 +1,375 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "tracker/sort_tracker.h"
+
+sensor_camera::SortKalmanBox::SortKalmanBox(const SortDetection& detection)
+{
+    x_.setZero();
+    x_.head<4>() = boxToMeasurement(detection);
+
+    // 与原Python SORT相同的初始协方差, 未观测的速度给较大不确定度
+    P_ = Eigen::Matrix<float, 7, 7>::Identity() * 10.0;
+    P_.bottomRightCorner<3, 3>() *= 1000.0;
+}
+
+Eigen::Vector4f sensor_camera::SortKalmanBox::boxToMeasurement(const SortDetection& detection)
+{
+    float w = detection.xmax - detection.xmin;
+    float h = detection.ymax - detection.ymin;
+    Eigen::Vector4f z;
+    z << detection.xmin + w / 2.0, detection.ymin + h / 2.0, w * h, w / std::max(h, 1e-3f);
+    return z;
+}
+
+void sensor_camera::SortKalmanBox::predict()
+{
+    // 面积不能预测为负
+    if(x_(6) + x_(2) <= 0)
+    {
+        x_(6) = 0.0;
+    }
+
+    // F为单位阵加上位置/面积对速度的耦合, 直接展开计算
+    x_.head<3>() += x_.tail<3>();
+
+    Eigen::Matrix<float, 7, 7> F = Eigen::Matrix<float, 7, 7>::Identity();
+    F(0, 4) = 1.0;
+    F(1, 5) = 1.0;
+    F(2, 6) = 1.0;
+    P_ = F * P_ * F.transpose();
+
+    P_.diagonal().head<4>().array() += 1.0;
+    P_(4, 4) += 0.01;
+    P_(5, 5) += 0.01;
+    P_(6, 6) += 0.0001;
+}
+
+void sensor_camera::SortKalmanBox::update(const SortDetection& detection)
+{
+    // H取状态前4维, 直接用分块代替矩阵乘
+    Eigen::Vector4f y = boxToMeasurement(detection) - x_.head<4>();
+
+    Eigen::Matrix4f S = P_.topLeftCorner<4, 4>();
+    S(0, 0) += 1.0;
+    S(1, 1) += 1.0;
+    S(2, 2) += 10.0;
+    S(3, 3) += 10.0;
+
+    Eigen::Matrix<float, 7, 4> K = P_.leftCols<4>() * S.inverse();
+    x_ += K * y;
+    P_ -= K * P_.topRows<4>();
+}
+
+void sensor_camera::SortKalmanBox::getBox(float& xmin, float& ymin, float& xmax, float& ymax) const
+{
+    float w = sqrt(std::max(x_(2) * x_(3), 0.0f));
+    float h = w > 0 ? x_(2) / w : 0.0;
+    xmin = x_(0) - w / 2.0;
+    ymin = x_(1) - h / 2.0;
+    xmax = x_(0) + w / 2.0;
+    ymax = x_(1) + h / 2.0;
+}
+
+bool sensor_camera::SortKalmanBox::isValid() const
+{
+    return x_.allFinite() && x_(2) > 0 && x_(3) > 0;
+}
+
+sensor_camera::SortTrack::SortTrack(uint32_t track_id, const SortDetection& detection):
+id(track_id),
+filter(detection),
+score(detection.score),
+object_class(detection.object_class),
+hits(1),
+hit_streak(1),
+age(0),
+time_since_update(0),
+detection_index(-1)
+{
+}
+
+sensor_camera::SortTracker::SortTracker(
+    int max_age,
+    int min_hits,
+    float iou_threshold,
+    float high_score_threshold,
+    float low_score_threshold,
+    float low_iou_threshold):
+max_age_(max_age),
+min_hits_(min_hits),
+iou_threshold_(iou_threshold),
+high_score_threshold_(high_score_threshold),
+low_score_threshold_(low_score_threshold),
+low_iou_threshold_(low_iou_threshold)
+{
+}
+
+sensor_camera::SortTracker::~SortTracker()
+{
+}
+
+const vector<sensor_camera::SortTrack>& sensor_camera::SortTracker::getTracks() const
+{
+    return tracks_;
+}
+
+void sensor_camera::SortTracker::update(const vector<SortDetection>& detections, vector<SortTrackResult>& results)
+{
+#ifdef DEBUG_SORT_TRACKER
+    cout << "SortTracker update start" << endl;
+#endif
+
+    frame_count_++;
+    results.clear();
+
+    // 预测全部轨迹, 删除发散的轨迹
+    for(int i = 0; i < tracks_.size();)
+    {
+        tracks_[i].filter.predict();
+        tracks_[i].age++;
+        tracks_[i].time_since_update++;
+        tracks_[i].detection_index = -1;
+        if(tracks_[i].time_since_update > 1)
+        {
+            tracks_[i].hit_streak = 0;
+        }
+
+        if(!tracks_[i].filter.isValid())
+        {
+            tracks_.erase(tracks_.begin() + i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    vector<int> high_detections;
+    vector<int> low_detections;
+    for(int i = 0; i < detections.size(); i++)
+    {
+        if(detections[i].score >= high_score_threshold_)
+        {
+            high_detections.push_back(i);
+        }
+        else if(detections[i].score >= low_score_threshold_)
+        {
+            low_detections.push_back(i);
+        }
+    }
+
+    vector<int> track_indices(tracks_.size());
+    for(int i = 0; i < tracks_.size(); i++)
+    {
+        track_indices[i] = i;
+    }
+
+    vector<int> unmatched_high;
+    vector<int> unmatched_low;
+    associate(detections, high_detections, track_indices, iou_threshold_, unmatched_high);
+    associate(detections, low_detections, track_indices, low_iou_threshold_, unmatched_low);
+
+    for(int i = 0; i < unmatched_high.size(); i++)
+    {
+        tracks_.push_back(SortTrack(next_id_++, detections[unmatched_high[i]]));
+        tracks_.back().detection_index = unmatched_high[i];
+    }
+
+    for(int i = 0; i < tracks_.size();)
+    {
+        SortTrack& track = tracks_[i];
+        if(track.time_since_update == 0 && (track.hit_streak >= min_hits_ || frame_count_ <= min_hits_))
+        {
+            SortTrackResult result;
+            result.id = track.id;
+            track.filter.getBox(result.xmin, result.ymin, result.xmax, result.ymax);
+            result.score = track.score;
+            result.object_class = track.object_class;
+            result.detection_index = track.detection_index;
+            results.push_back(result);
+        }
+
+        if(track.time_since_update > max_age_)
+        {
+            tracks_.erase(tracks_.begin() + i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+#ifdef DEBUG_SORT_TRACKER
+    cout << "SortTracker tracks: " << tracks_.size() << ", output: " << results.size() << endl;
+#endif
+}
+
+void sensor_camera::SortTracker::associate(const vector<SortDetection>& detections, const vector<int>& detection_indices, vector<int>& track_indices, float iou_threshold, vector<int>& unmatched_detections)
+{
+    unmatched_detections.clear();
+    if(track_indices.empty() || detection_indices.empty())
+    {
+        unmatched_detections = detection_indices;
+        return;
+    }
+
+    // 代价为1-IoU, 门限外的配对给大代价, 求解后剔除
+    const float gated_cost = 1e6;
+    Eigen::MatrixXf iou = Eigen::MatrixXf::Zero(detection_indices.size(), track_indices.size());
+    Eigen::MatrixXf cost = Eigen::MatrixXf::Constant(detection_indices.size(), track_indices.size(), gated_cost);
+    for(int j = 0; j < track_indices.size(); j++)
+    {
+        const SortTrack& track = tracks_[track_indices[j]];
+        float txmin, tymin, txmax, tymax;
+        track.filter.getBox(txmin, tymin, txmax, tymax);
+        for(int i = 0; i < detection_indices.size(); i++)
+        {
+            const SortDetection& detection = detections[detection_indices[i]];
+            if(detection.object_class != track.object_class)
+            {
+                continue;
+            }
+            iou(i, j) = calculateBoxIou(detection.xmin, detection.ymin, detection.xmax, detection.ymax, txmin, tymin, txmax, tymax);
+            if(iou(i, j) >= iou_threshold)
+            {
+                cost(i, j) = 1.0 - iou(i, j);
+            }
+        }
+    }
+
+    vector<int> assignment;
+    solveAssignment(cost, assignment);
+
+    vector<bool> track_matched(track_indices.size(), false);
+    for(int i = 0; i < detection_indices.size(); i++)
+    {
+        int j = assignment[i];
+        if(j < 0 || iou(i, j) < iou_threshold || cost(i, j) >= gated_cost)
+        {
+            unmatched_detections.push_back(detection_indices[i]);
+            continue;
+        }
+
+        SortTrack& track = tracks_[track_indices[j]];
+        const SortDetection& detection = detections[detection_indices[i]];
+        track.filter.update(detection);
+        track.score = detection.score;
+        track.hits++;
+        track.hit_streak++;
+        track.time_since_update = 0;
+        track.detection_index = detection_indices[i];
+        track_matched[j] = true;
+    }
+
+    // 只保留未匹配的轨迹供下一轮使用
+    vector<int> remaining;
+    for(int j = 0; j < track_indices.size(); j++)
+    {
+        if(!track_matched[j])
+        {
+            remaining.push_back(track_indices[j]);
+        }
+    }
+    track_indices.swap(remaining);
+}
+
+float sensor_camera::calculateBoxIou(float axmin, float aymin, float axmax, float aymax, float bxmin, float bymin, float bxmax, float bymax)
+{
+    float w = std::max(0.0f, std::min(axmax, bxmax) - std::max(axmin, bxmin));
+    float h = std::max(0.0f, std::min(aymax, bymax) - std::max(aymin, bymin));
+    float inter = w * h;
+    float area = (axmax - axmin) * (aymax - aymin) + (bxmax - bxmin) * (bymax - bymin) - inter;
+    return area > 0 ? inter / area : 0.0;
+}
+
+// 带势函数的匈牙利算法, O(n^2 m), 行数不超过列数时直接求解, 否则转置
+// 势函数用double累加: 门限代价1e6与1-IoU相差6个量级, float下势函数的舍入会吞掉IoU差异, 得到非最优匹配
+void sensor_camera::solveAssignment(const Eigen::MatrixXf& cost, vector<int>& assignment)
+{
+    int rows = cost.rows();
+    int cols = cost.cols();
+    assignment.assign(rows, -1);
+    if(rows == 0 || cols == 0)
+    {
+        return;
+    }
+
+    bool transposed = rows > cols;
+    Eigen::MatrixXd a = transposed ? Eigen::MatrixXd(cost.transpose().cast<double>()) : Eigen::MatrixXd(cost.cast<double>());
+    int n = a.rows();
+    int m = a.cols();
+
+    const double inf = std::numeric_limits<double>::max();
+    vector<double> u(n + 1, 0.0), v(m + 1, 0.0), minv(m + 1);
+    vector<int> p(m + 1, 0), way(m + 1, 0);
+    vector<bool> used(m + 1);
+    for(int i = 1; i <= n; i++)
+    {
+        p[0] = i;
+        int j0 = 0;
+        std::fill(minv.begin(), minv.end(), inf);
+        std::fill(used.begin(), used.end(), false);
+        do
+        {
+            used[j0] = true;
+            int i0 = p[j0];
+            int j1 = 0;
+            double delta = inf;
+            for(int j = 1; j <= m; j++)
+            {
+                if(used[j])
+                {
+                    continue;
+                }
+                double cur = a(i0 - 1, j - 1) - u[i0] - v[j];
+                if(cur < minv[j])
+                {
+                    minv[j] = cur;
+                    way[j] = j0;
+                }
+                if(minv[j] < delta)
+                {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+            for(int j = 0; j <= m; j++)
+            {
+                if(used[j])
+                {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                }
+                else
+                {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while(p[j0] != 0);
+
+        do
+        {
+            int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while(j0 != 0);
+    }
+
+    for(int j = 1; j <= m; j++)
+    {
+        if(p[j] == 0)
+        {
+            continue;
+        }
+        if(transposed)
+        {
+            assignment[j - 1] = p[j] - 1;
+        }
+        else
+        {
+            assignment[p[j] - 1] = j - 1;
+        }
+    }
+}
@@ -0,0 +1,178 @@
+#ifndef GRID_PLANNER_H
+#define GRID_PLANNER_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace pnc
+{
+
+#define GRID_COST_FREE 0
+#define GRID_COST_LETHAL 255 // 障碍物, 不可通行; 1~254 为可通行但有代价的栅格
+
+struct GridCell
+{
+  int x, y;
+  GridCell()
+  {
+  }
+  GridCell(int Cx, int Cy)
+  {
+    x = Cx;
+    y = Cy;
+  }
+};
+
+// 栅格代价地图，按行存放: index = y * width + x
+class GridMap
+{
+public:
+  GridMap() = default;
+  GridMap(int width, int height, double resolution = 0.1, double origin_x = 0.0, double origin_y = 0.0);
+  ~GridMap() = default;
+
+  void resize(int width, int height);
+  void clear(uint8_t cost = GRID_COST_FREE);
+
+  int width() const
+  {
+    return width_;
+  }
+  int height() const
+  {
+    return height_;
+  }
+  double resolution() const
+  {
+    return resolution_;
+  }
+
+  bool isInside(int x, int y) const
+  {
+    return x >= 0 && y >= 0 && x < width_ && y < height_;
+  }
+  // 地图外视为障碍物
+  bool isFree(int x, int y) const
+  {
+    return isInside(x, y) && costs_[y * width_ + x] != GRID_COST_LETHAL;
+  }
+  uint8_t getCost(int x, int y) const
+  {
+    return costs_[y * width_ + x];
+  }
+  void setCost(int x, int y, uint8_t cost)
+  {
+    costs_[y * width_ + x] = cost;
+  }
+  // [x_min, x_max] x [y_min, y_max] 区域设为同一代价，超出地图的部分忽略
+  void fillRect(int x_min, int y_min, int x_max, int y_max, uint8_t cost);
+
+  const uint8_t *data() const
+  {
+    return costs_.data();
+  }
+  uint8_t *data()
+  {
+    return costs_.data();
+  }
+
+  // 世界坐标与栅格坐标转换，origin 为栅格(0, 0)左下角的世界坐标
+  bool worldToGrid(double wx, double wy, GridCell &cell) const;
+  void gridToWorld(const GridCell &cell, double &wx, double &wy) const;
+
+private:
+  int width_         = 0;
+  int height_        = 0;
+  double resolution_ = 0.1;
+  double origin_x_   = 0.0;
+  double origin_y_   = 0.0;
+  std::vector< uint8_t > costs_;
+};
+
+// 栅格路径搜索：8邻域 A*，启发函数为 octile 距离
+// 对角移动要求两侧相邻栅格均可通行，避免从障碍物的角上穿过
+// 搜索状态按栅格平铺存放并带代数标记，多次搜索之间不需要清空；开放列表为二叉堆
+class GridPlanner
+{
+public:
+  GridPlanner()  = default;
+  ~GridPlanner() = default;
+
+  // 进入代价为 c 的栅格时，移动距离乘以 (1 + c * cost_weight)
+  void setCostWeight(double cost_weight)
+  {
+    cost_weight_ = cost_weight;
+  }
+  // 最多扩展的栅格数，0 为不限制；用于局部绕障时限制单次规划耗时
+  void setMaxExpand(int max_expand)
+  {
+    max_expand_ = max_expand;
+  }
+  // 跳点搜索(JPS)：只区分可通行/障碍物，忽略 1~254 的代价，适合大面积空旷场地
+  void setUseJps(bool use_jps)
+  {
+    use_jps_ = use_jps;
+  }
+
+  // 规划成功返回 true，path 为起点到终点的逐个栅格
+  bool plan(const GridMap &map, const GridCell &start, const GridCell &goal, std::vector< GridCell > &path);
+
+  int getExpandCount() const
+  {
+    return expand_count_;
+  }
+  double getPathCost() const
+  {
+    return path_cost_;
+  }
+
+private:
+  struct HeapNode
+  {
+    float f;
+    float h;
+    int index;
+  };
+
+  static bool heapGreater(const HeapNode &a, const HeapNode &b);
+
+  void prepare(int cell_num);
+  void pushOpen(int index, float g, float h);
+  bool popOpen(int &index);
+
+  bool searchAstar(const GridMap &map, int goal);
+  bool searchJps(const GridMap &map, int goal);
+
+  void relax(int index, int parent, float g, int goal_x, int goal_y);
+  int jumpStraight(const GridMap &map, int x, int y, int dx, int dy, int goal_x, int goal_y) const;
+  int jumpDiagonal(const GridMap &map, int x, int y, int dx, int dy, int goal_x, int goal_y) const;
+
+  void buildPath(int goal, std::vector< GridCell > &path) const;
+
+  bool isOpen(int index) const
+  {
+    return state_[index] == generation_;
+  }
+  bool isClosed(int index) const
+  {
+    return state_[index] == generation_ + 1;
+  }
+
+  double cost_weight_ = 0.0;
+  int max_expand_     = 0;
+  bool use_jps_       = false;
+
+  int width_        = 0;
+  int expand_count_ = 0;
+  double path_cost_ = 0.0;
+
+  // state_[i] == generation_ 表示在开放列表中(g_ 有效)，generation_ + 1 表示已关闭，其余为本次未访问
+  std::vector< uint32_t > state_;
+  std::vector< float > g_;
+  std::vector< int > parent_;
+  std::vector< HeapNode > open_;
+  uint32_t generation_ = 0;
+};
+
+} // end namespace
+#endif
@@ -51,6 +51,7 @@
 #include "common/perception_Info.h"
 #include "common/speed_interval.h"
 #include "common/box2d.h"
+#include "grid/grid_planner.h"
 #include "curve/curve.h"
 #include "curve/quartic_polynomial.h"
 #include "curve/quintic_polynomial.h"
@@ -0,0 +1,381 @@
+#include "grid/grid_planner.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+
+namespace pnc
+{
+
+static const float kSqrt2 = 1.41421356f;
+
+// 8邻域方向，前4个为直行，后4个为对角
+static const int kDirX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+static const int kDirY[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+static inline float octileDistance(int x1, int y1, int x2, int y2)
+{
+  int dx = abs(x1 - x2);
+  int dy = abs(y1 - y2);
+  return (dx + dy) + (kSqrt2 - 2.0f) * std::min(dx, dy);
+}
+
+static inline int signOf(int value)
+{
+  return (value > 0) - (value < 0);
+}
+
+GridMap::GridMap(int width, int height, double resolution, double origin_x, double origin_y)
+{
+  resolution_ = resolution;
+  origin_x_   = origin_x;
+  origin_y_   = origin_y;
+  resize(width, height);
+}
+
+void GridMap::resize(int width, int height)
+{
+  width_  = width;
+  height_ = height;
+  costs_.assign(width * height, GRID_COST_FREE);
+}
+
+void GridMap::clear(uint8_t cost)
+{
+  std::fill(costs_.begin(), costs_.end(), cost);
+}
+
+void GridMap::fillRect(int x_min, int y_min, int x_max, int y_max, uint8_t cost)
+{
+  x_min = std::max(x_min, 0);
+  y_min = std::max(y_min, 0);
+  x_max = std::min(x_max, width_ - 1);
+  y_max = std::min(y_max, height_ - 1);
+  for (int y = y_min; y <= y_max; ++y)
+  {
+    for (int x = x_min; x <= x_max; ++x)
+    {
+      costs_[y * width_ + x] = cost;
+    }
+  }
+}
+
+bool GridMap::worldToGrid(double wx, double wy, GridCell &cell) const
+{
+  cell.x = (int)floor((wx - origin_x_) / resolution_);
+  cell.y = (int)floor((wy - origin_y_) / resolution_);
+  return isInside(cell.x, cell.y);
+}
+
+void GridMap::gridToWorld(const GridCell &cell, double &wx, double &wy) const
+{
+  wx = origin_x_ + (cell.x + 0.5) * resolution_;
+  wy = origin_y_ + (cell.y + 0.5) * resolution_;
+}
+
+bool GridPlanner::plan(const GridMap &map, const GridCell &start, const GridCell &goal, std::vector< GridCell > &path)
+{
+  path.clear();
+  expand_count_ = 0;
+  path_cost_    = 0.0;
+  if (!map.isFree(start.x, start.y) || !map.isFree(goal.x, goal.y))
+  {
+    return false;
+  }
+
+  width_ = map.width();
+  prepare(map.width() * map.height());
+
+  int start_index = start.y * width_ + start.x;
+  int goal_index  = goal.y * width_ + goal.x;
+  parent_[start_index] = -1;
+  pushOpen(start_index, 0.0f, octileDistance(start.x, start.y, goal.x, goal.y));
+
+  bool found = use_jps_ ? searchJps(map, goal_index) : searchAstar(map, goal_index);
+  if (found)
+  {
+    path_cost_ = g_[goal_index];
+    buildPath(goal_index, path);
+  }
+  return found;
+}
+
+void GridPlanner::prepare(int cell_num)
+{
+  // 地图大小变化或代数标记即将溢出时才清空状态
+  if ((int)state_.size() != cell_num || generation_ >= 0xFFFFFFF0u)
+  {
+    state_.assign(cell_num, 0);
+    g_.resize(cell_num);
+    parent_.resize(cell_num);
+    generation_ = 0;
+  }
+  generation_ += 2;
+  open_.clear();
+}
+
+// 小顶堆，f 相同时 h 小的优先(更靠近终点)
+bool GridPlanner::heapGreater(const HeapNode &a, const HeapNode &b)
+{
+  return a.f > b.f || (a.f == b.f && a.h > b.h);
+}
+
+void GridPlanner::pushOpen(int index, float g, float h)
+{
+  state_[index] = generation_;
+  g_[index]     = g;
+  HeapNode node = {g + h, h, index};
+  open_.push_back(node);
+  std::push_heap(open_.begin(), open_.end(), heapGreater);
+}
+
+bool GridPlanner::popOpen(int &index)
+{
+  // 更新 g 值时不删除旧节点，出堆时跳过已关闭的栅格
+  while (!open_.empty())
+  {
+    std::pop_heap(open_.begin(), open_.end(), heapGreater);
+    index = open_.back().index;
+    open_.pop_back();
+    if (!isClosed(index))
+    {
+      state_[index] = generation_ + 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+void GridPlanner::relax(int index, int parent, float g, int goal_x, int goal_y)
+{
+  if (isClosed(index) || (isOpen(index) && g >= g_[index]))
+  {
+    return;
+  }
+  parent_[index] = parent;
+  pushOpen(index, g, octileDistance(index % width_, index / width_, goal_x, goal_y));
+}
+
+bool GridPlanner::searchAstar(const GridMap &map, int goal)
+{
+  int goal_x = goal % width_;
+  int goal_y = goal / width_;
+  int cur;
+  while (popOpen(cur))
+  {
+    if (cur == goal)
+    {
+      return true;
+    }
+    if (max_expand_ > 0 && expand_count_ >= max_expand_)
+    {
+      return false;
+    }
+    ++expand_count_;
+
+    int cx = cur % width_;
+    int cy = cur / width_;
+    for (int k = 0; k < 8; ++k)
+    {
+      int nx = cx + kDirX[k];
+      int ny = cy + kDirY[k];
+      if (!map.isFree(nx, ny))
+      {
+        continue;
+      }
+      float step = 1.0f;
+      if (k >= 4)
+      {
+        if (!map.isFree(nx, cy) || !map.isFree(cx, ny))
+        {
+          continue;
+        }
+        step = kSqrt2;
+      }
+      if (cost_weight_ > 0.0)
+      {
+        step *= 1.0f + map.getCost(nx, ny) * cost_weight_;
+      }
+      relax(ny * width_ + nx, cur, g_[cur] + step, goal_x, goal_y);
+    }
+  }
+  return false;
+}
+
+// 沿直线跳跃，遇到终点或强迫邻居时返回该栅格，遇到障碍物返回 -1
+int GridPlanner::jumpStraight(const GridMap &map, int x, int y, int dx, int dy, int goal_x, int goal_y) const
+{
+  while (true)
+  {
+    if (!map.isFree(x, y))
+    {
+      return -1;
+    }
+    if (x == goal_x && y == goal_y)
+    {
+      return y * width_ + x;
+    }
+    if (dx != 0)
+    {
+      if ((map.isFree(x, y - 1) && !map.isFree(x - dx, y - 1)) || (map.isFree(x, y + 1) && !map.isFree(x - dx, y + 1)))
+      {
+        return y * width_ + x;
+      }
+    }
+    else
+    {
+      if ((map.isFree(x - 1, y) && !map.isFree(x - 1, y - dy)) || (map.isFree(x + 1, y) && !map.isFree(x + 1, y - dy)))
+      {
+        return y * width_ + x;
+      }
+    }
+    x += dx;
+    y += dy;
+  }
+}
+
+// 沿对角跳跃，每一步先沿两个分量方向直线跳跃，找到跳点则当前栅格为跳点
+int GridPlanner::jumpDiagonal(const GridMap &map, int x, int y, int dx, int dy, int goal_x, int goal_y) const
+{
+  while (true)
+  {
+    if (!map.isFree(x, y))
+    {
+      return -1;
+    }
+    if (x == goal_x && y == goal_y)
+    {
+      return y * width_ + x;
+    }
+    if (jumpStraight(map, x + dx, y, dx, 0, goal_x, goal_y) >= 0 ||
+        jumpStraight(map, x, y + dy, 0, dy, goal_x, goal_y) >= 0)
+    {
+      return y * width_ + x;
+    }
+    if (!map.isFree(x + dx, y) || !map.isFree(x, y + dy))
+    {
+      return -1;
+    }
+    x += dx;
+    y += dy;
+  }
+}
+
+bool GridPlanner::searchJps(const GridMap &map, int goal)
+{
+  int goal_x = goal % width_;
+  int goal_y = goal / width_;
+  int cur;
+  while (popOpen(cur))
+  {
+    if (cur == goal)
+    {
+      return true;
+    }
+    if (max_expand_ > 0 && expand_count_ >= max_expand_)
+    {
+      return false;
+    }
+    ++expand_count_;
+
+    int cx = cur % width_;
+    int cy = cur / width_;
+
+    // 按父节点方向裁剪邻居，起点搜索全部8个方向
+    int dir_x[8], dir_y[8];
+    int dir_num = 0;
+    if (parent_[cur] < 0)
+    {
+      for (int k = 0; k < 8; ++k)
+      {
+        dir_x[dir_num]   = kDirX[k];
+        dir_y[dir_num++] = kDirY[k];
+      }
+    }
+    else
+    {
+      int dx = signOf(cx - parent_[cur] % width_);
+      int dy = signOf(cy - parent_[cur] / width_);
+      if (dx != 0 && dy != 0)
+      {
+        dir_x[dir_num] = 0, dir_y[dir_num++] = dy;
+        dir_x[dir_num] = dx, dir_y[dir_num++] = 0;
+        dir_x[dir_num] = dx, dir_y[dir_num++] = dy;
+      }
+      else if (dx != 0)
+      {
+        dir_x[dir_num] = dx, dir_y[dir_num++] = 0;
+        dir_x[dir_num] = dx, dir_y[dir_num++] = 1;
+        dir_x[dir_num] = dx, dir_y[dir_num++] = -1;
+        dir_x[dir_num] = 0, dir_y[dir_num++] = 1;
+        dir_x[dir_num] = 0, dir_y[dir_num++] = -1;
+      }
+      else
+      {
+        dir_x[dir_num] = 0, dir_y[dir_num++] = dy;
+        dir_x[dir_num] = 1, dir_y[dir_num++] = dy;
+        dir_x[dir_num] = -1, dir_y[dir_num++] = dy;
+        dir_x[dir_num] = 1, dir_y[dir_num++] = 0;
+        dir_x[dir_num] = -1, dir_y[dir_num++] = 0;
+      }
+    }
+
+    for (int k = 0; k < dir_num; ++k)
+    {
+      int dx = dir_x[k];
+      int dy = dir_y[k];
+      int jump_point;
+      if (dx != 0 && dy != 0)
+      {
+        if (!map.isFree(cx + dx, cy) || !map.isFree(cx, cy + dy))
+        {
+          continue;
+        }
+        jump_point = jumpDiagonal(map, cx + dx, cy + dy, dx, dy, goal_x, goal_y);
+      }
+      else
+      {
+        jump_point = jumpStraight(map, cx + dx, cy + dy, dx, dy, goal_x, goal_y);
+      }
+      if (jump_point < 0)
+      {
+        continue;
+      }
+      int jx = jump_point % width_;
+      int jy = jump_point / width_;
+      relax(jump_point, cur, g_[cur] + octileDistance(cx, cy, jx, jy), goal_x, goal_y);
+    }
+  }
+  return false;
+}
+
+// 从终点回溯，跳点之间按直线或对角补齐中间栅格
+void GridPlanner::buildPath(int goal, std::vector< GridCell > &path) const
+{
+  for (int cur = goal; cur >= 0; cur = parent_[cur])
+  {
+    int x = cur % width_;
+    int y = cur / width_;
+    path.push_back(GridCell(x, y));
+    int parent = parent_[cur];
+    if (parent < 0)
+    {
+      break;
+    }
+    int px = parent % width_;
+    int py = parent / width_;
+    int dx = signOf(px - x);
+    int dy = signOf(py - y);
+    x += dx;
+    y += dy;
+    while (x != px || y != py)
+    {
+      path.push_back(GridCell(x, y));
+      x += dx;
+      y += dy;
+    }
+  }
+  std::reverse(path.begin(), path.end());
+}
+
+} // end namespace
@@ -0,0 +1,75 @@
+// GridPlanner 的 A* 与 JPS 单次规划耗时
+// 场景: 堆场式地图, 随机摆放集装箱大小的矩形障碍物, 从左下角规划到右上角
+// 用法: rosrun decision grid_planner_bench [最大边长, 默认2000] [每平方栅格的障碍物数, 默认1/1500]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <vector>
+
+#include "grid/grid_planner.h"
+
+using namespace pnc;
+
+namespace
+{
+double nowMs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+void makeYard(GridMap &map, int size, double density)
+{
+  map.resize(size, size);
+  int rect_num = (int)(size * size * density);
+  for (int k = 0; k < rect_num; ++k)
+  {
+    int x = rand() % size;
+    int y = rand() % size;
+    map.fillRect(x, y, x + rand() % 30, y + rand() % 12, GRID_COST_LETHAL);
+  }
+  //起点与终点周围留空
+  map.fillRect(0, 0, 2, 2, GRID_COST_FREE);
+  map.fillRect(size - 3, size - 3, size - 1, size - 1, GRID_COST_FREE);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+  int max_size   = argc > 1 ? atoi(argv[1]) : 2000;
+  double density = argc > 2 ? atof(argv[2]) : 1.0 / 1500;
+
+  printf("size        mode  found  cost       expand     ms/plan\n");
+  const int sizes[] = {100, 500, 1000, 2000};
+  for (int i = 0; i < 4 && sizes[i] <= max_size; ++i)
+  {
+    int size = sizes[i];
+    srand(size);
+    GridMap map;
+    makeYard(map, size, density);
+    GridCell start(1, 1), goal(size - 2, size - 2);
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+      GridPlanner planner;
+      planner.setUseJps(mode == 1);
+      std::vector< GridCell > path;
+      //第一次规划分配搜索状态, 不计时
+      planner.plan(map, start, goal, path);
+
+      int repeat = size <= 500 ? 20 : 3;
+      bool found = true;
+      double t0  = nowMs();
+      for (int k = 0; k < repeat; ++k)
+      {
+        found = planner.plan(map, start, goal, path);
+      }
+      double ms = (nowMs() - t0) / repeat;
+      printf("%4dx%-4d  %-4s  %-5d  %-9.1f  %-9d  %.2f\n", size, size, mode ? "JPS" : "A*", found,
+             planner.getPathCost(), planner.getExpandCount(), ms);
+    }
+  }
+  return 0;
+}
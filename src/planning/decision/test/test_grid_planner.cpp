@@ -0,0 +1,183 @@
+#include "grid/grid_planner.h"
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using namespace pnc;
+
+namespace
+{
+//参考解: 与 GridPlanner 相同的移动规则和代价的 Dijkstra, 无路径时返回 -1
+double dijkstraCost(const GridMap &map, const GridCell &start, const GridCell &goal, double cost_weight)
+{
+  const int dir_x[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+  const int dir_y[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+  int width          = map.width();
+  std::vector< double > dist(width * map.height(), 1e18);
+  typedef std::pair< double, int > Item;
+  std::priority_queue< Item, std::vector< Item >, std::greater< Item > > open;
+  dist[start.y * width + start.x] = 0;
+  open.push(Item(0, start.y * width + start.x));
+  while (!open.empty())
+  {
+    Item item = open.top();
+    open.pop();
+    if (item.first > dist[item.second])
+    {
+      continue;
+    }
+    int cx = item.second % width;
+    int cy = item.second / width;
+    for (int k = 0; k < 8; ++k)
+    {
+      int nx = cx + dir_x[k];
+      int ny = cy + dir_y[k];
+      if (!map.isFree(nx, ny))
+      {
+        continue;
+      }
+      double step = 1.0;
+      if (k >= 4)
+      {
+        if (!map.isFree(nx, cy) || !map.isFree(cx, ny))
+        {
+          continue;
+        }
+        step = (double)1.41421356f;
+      }
+      step *= 1 + map.getCost(nx, ny) * cost_weight;
+      int next = ny * width + nx;
+      if (item.first + step < dist[next] - 1e-9)
+      {
+        dist[next] = item.first + step;
+        open.push(Item(dist[next], next));
+      }
+    }
+  }
+  double cost = dist[goal.y * width + goal.x];
+  return cost > 1e17 ? -1 : cost;
+}
+
+//逐格相连、不穿障碍物角, 返回几何长度; 无效路径返回 -1
+double pathLength(const GridMap &map, const std::vector< GridCell > &path, const GridCell &start,
+                  const GridCell &goal)
+{
+  if (path.empty() || path.front().x != start.x || path.front().y != start.y || path.back().x != goal.x ||
+      path.back().y != goal.y)
+  {
+    return -1;
+  }
+  double length = 0;
+  for (size_t i = 1; i < path.size(); ++i)
+  {
+    int dx = path[i].x - path[i - 1].x;
+    int dy = path[i].y - path[i - 1].y;
+    if (abs(dx) > 1 || abs(dy) > 1 || (dx == 0 && dy == 0) || !map.isFree(path[i].x, path[i].y))
+    {
+      return -1;
+    }
+    if (dx != 0 && dy != 0)
+    {
+      if (!map.isFree(path[i - 1].x + dx, path[i - 1].y) || !map.isFree(path[i - 1].x, path[i - 1].y + dy))
+      {
+        return -1;
+      }
+      length += 1.41421356;
+    }
+    else
+    {
+      length += 1;
+    }
+  }
+  return length;
+}
+} // namespace
+
+//随机地图, 一半带软代价; A* 代价与 Dijkstra 一致, 无软代价时 JPS 路径长度一致
+TEST(GridPlanner, MatchesDijkstraOnRandomMaps)
+{
+  srand(1);
+  GridPlanner astar, jps;
+  jps.setUseJps(true);
+  for (int t = 0; t < 600; ++t)
+  {
+    int width      = 5 + rand() % 60;
+    int height     = 5 + rand() % 60;
+    double density = (rand() % 40) / 100.0;
+    GridMap map(width, height);
+    for (int y = 0; y < height; ++y)
+    {
+      for (int x = 0; x < width; ++x)
+      {
+        if ((rand() % 1000) / 1000.0 < density)
+        {
+          map.setCost(x, y, GRID_COST_LETHAL);
+        }
+        else if (t % 2)
+        {
+          map.setCost(x, y, rand() % 200);
+        }
+      }
+    }
+    GridCell start(rand() % width, rand() % height), goal(rand() % width, rand() % height);
+    map.setCost(start.x, start.y, GRID_COST_FREE);
+    map.setCost(goal.x, goal.y, GRID_COST_FREE);
+    double cost_weight = t % 2 ? 0.02 : 0.0;
+    astar.setCostWeight(cost_weight);
+
+    double expect = dijkstraCost(map, start, goal, cost_weight);
+    std::vector< GridCell > path;
+    bool found = astar.plan(map, start, goal, path);
+    ASSERT_EQ(expect >= 0, found) << "case " << t;
+    if (!found)
+    {
+      continue;
+    }
+    ASSERT_GE(pathLength(map, path, start, goal), 0) << "case " << t;
+    ASSERT_NEAR(expect, astar.getPathCost(), 1e-3 * expect + 1e-3) << "case " << t;
+
+    if (cost_weight == 0.0)
+    {
+      ASSERT_TRUE(jps.plan(map, start, goal, path)) << "case " << t;
+      ASSERT_NEAR(expect, pathLength(map, path, start, goal), 1e-3 * expect + 1e-3) << "case " << t;
+    }
+  }
+}
+
+TEST(GridPlanner, NoCornerCutting)
+{
+  // . #
+  // # .
+  GridMap map(2, 2);
+  map.setCost(1, 0, GRID_COST_LETHAL);
+  map.setCost(0, 1, GRID_COST_LETHAL);
+  GridPlanner planner;
+  std::vector< GridCell > path;
+  EXPECT_FALSE(planner.plan(map, GridCell(0, 0), GridCell(1, 1), path));
+  planner.setUseJps(true);
+  EXPECT_FALSE(planner.plan(map, GridCell(0, 0), GridCell(1, 1), path));
+}
+
+TEST(GridPlanner, MaxExpandStopsSearch)
+{
+  GridMap map(200, 200);
+  map.fillRect(100, 0, 100, 198, GRID_COST_LETHAL);
+  GridPlanner planner;
+  std::vector< GridCell > path;
+  ASSERT_TRUE(planner.plan(map, GridCell(0, 0), GridCell(199, 0), path));
+  planner.setMaxExpand(100);
+  EXPECT_FALSE(planner.plan(map, GridCell(0, 0), GridCell(199, 0), path));
+  EXPECT_LE(planner.getExpandCount(), 100);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}